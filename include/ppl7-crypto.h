@@ -41,6 +41,8 @@
 namespace ppl7
 {
 
+class TaskExecutor;
+
 PPL7EXCEPTION(UnsupportedAlgorithmException, Exception);
 PPL7EXCEPTION(InvalidAlgorithmException, Exception);
 PPL7EXCEPTION(NoAlgorithmSpecifiedException, Exception);
@@ -178,6 +180,62 @@ public:
     static uint32_t adler32(const ByteArrayPtr& data);
 };
 
+class DigestBatch
+{
+public:
+    class Result
+    {
+    public:
+        String Filename;
+        uint64_t Size;
+        ByteArray Hash;
+        String Error;
+
+        Result();
+        bool ok() const;
+    };
+
+private:
+    Digest::Algorithm algorithm;
+    size_t numthreads;
+    size_t buffersize;
+    size_t chunksize;
+    bool usemmap;
+    TaskExecutor* executor;
+    uint64_t lastbytes;
+    double lastelapsed;
+
+    DigestBatch(const DigestBatch&);
+    DigestBatch& operator=(const DigestBatch&);
+
+    TaskExecutor& workers();
+    void hashOne(Digest& digest, Result& r, char*& buffer);
+    ByteArray treeRoot(std::vector<ByteArray>& nodes);
+
+public:
+    explicit DigestBatch(Digest::Algorithm algorithm = Digest::Algo_SHA256, size_t threads = 0);
+    ~DigestBatch();
+
+    void setAlgorithm(Digest::Algorithm algorithm);
+    Digest::Algorithm getAlgorithm() const;
+    void setThreads(size_t threads);
+    void setBufferSize(size_t bytes);
+    size_t getBufferSize() const;
+    void setChunkSize(size_t bytes);
+    size_t getChunkSize() const;
+    void setUseMmap(bool enable);
+
+    void hashFiles(const std::vector<String>& files, std::vector<Result>& results);
+    void hashDirectory(const String& path, std::vector<Result>& results, bool recursive = true);
+    ByteArray treeHash(const String& filename);
+    ByteArray treeHash(const ByteArrayPtr& data);
+    ByteArray treeHash(const void* data, size_t size);
+
+    uint64_t bytesHashed() const;
+    double elapsed() const;
+    double throughput() const;
+};
+
 } // namespace ppl7
 
 #endif /* PPL7CRYPTO_H_ */
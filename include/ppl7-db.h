@@ -38,7 +38,13 @@
 #endif
 #endif
 
+#include <atomic>
 #include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace ppl7
 {
@@ -48,9 +54,14 @@ namespace db
 class SinglePool;
 class MultiPool;
 class Database;
+class DBPool;
+class ResultColumn;
 
 class ResultSet
 {
+private:
+    String ViewBuffer;
+
 public:
     enum FieldType
     {
@@ -80,6 +91,60 @@ public:
     virtual void fetchFields(Array& array) = 0;
     virtual void nextRow() = 0;
     virtual bool eof() = 0;
+    virtual bool isNull(int field);
+    virtual int64_t getInt64(int field);
+    virtual double getDouble(int field);
+    virtual StringView getView(int field);
+    size_t fetchColumns(std::vector<ResultColumn>& columns, size_t maxrows);
+};
+
+class ResultColumn
+{
+public:
+    ResultSet::FieldType type;
+    std::vector<int64_t> integers;
+    std::vector<double> doubles;
+    std::vector<size_t> offsets;
+    std::string data;
+    std::vector<bool> nulls;
+
+    ResultColumn(ResultSet::FieldType type = ResultSet::TYPE_STRING);
+    void clear();
+    size_t rows() const;
+    bool isNull(size_t row) const;
+    StringView getView(size_t row) const;
+};
+
+class Statement
+{
+    friend class Database;
+
+private:
+    Database* db;
+    String querystring;
+
+protected:
+    Statement(Database& db, const String& query);
+    void finished(float duration);
+    virtual void close();
+
+public:
+    virtual ~Statement();
+    const String& getQuery() const;
+    Database& database() const;
+    virtual int params() const = 0;
+    virtual void bindNull(int index) = 0;
+    virtual void bind(int index, int64_t value) = 0;
+    virtual void bind(int index, double value) = 0;
+    virtual void bind(int index, const String& value) = 0;
+    virtual void bind(int index, const ByteArrayPtr& value) = 0;
+    void bind(int index, int value);
+    void bind(int index, const char* value);
+    void bind(const Array& values);
+    virtual void clearBindings() = 0;
+    virtual void exec() = 0;
+    virtual ResultSet* query() = 0;
+    virtual uint64_t affected() const = 0;
 };
 
 Database* Connect(const AssocArray& params);
@@ -89,18 +154,29 @@ class Database
 {
     friend class DBPool;
     friend class DBPoolOfPools;
+    friend class Statement;
 
 private:
     AssocArray ConnectParam;
     Logger* Log;
     uint64_t lastuse;
     uint64_t lastping;
+    DBPool* pool;
+    int poolversion;
+    std::atomic<double> poolcheckout;
+    std::list<std::shared_ptr<Statement> > StatementLRU;
+    std::map<String, std::list<std::shared_ptr<Statement> >::iterator> StatementCache;
+    std::set<Statement*> Statements;
+    size_t StatementCacheSize;
 
 protected:
     void logQuery(const String& query, float duration);
     void updateLastPing();
     void updateLastUse();
     void clearLastUse();
+    void clearStatementCache();
+    virtual Statement* createStatement(const String& query);
+    static void checkBulkRows(const Array& columns, const std::list<Array>& rows);
 
 public:
     Database();
@@ -139,6 +215,7 @@ public:
     virtual void selectDB(const String& databasename);
     virtual void exec(const String& query);
     virtual ResultSet* query(const String& query);
+    virtual ResultSet* streamQuery(const String& query);
     virtual bool ping();
     virtual String escape(const String& str) const;
     virtual uint64_t getAffectedRows();
@@ -149,11 +226,13 @@ public:
     virtual void createDatabase(const String& name);
     virtual String databaseType() const;
     virtual String getQuoted(const String& value, const String& type = String()) const;
-    /*
-    virtual void        prepare(const String &preparedStatementName, const String &query);
-    virtual ResultSet	*execute(const String &preparedStatementName, const Array &params);
-    virtual void		deallocate(const String &preparedStatementName);
-    */
+
+    virtual void bulkInsert(const String& table, const Array& columns, const std::list<Array>& rows, size_t batchsize = 1000);
+
+    std::shared_ptr<Statement> prepare(const String& query);
+    void setStatementCacheSize(size_t size);
+    size_t statementCacheSize() const;
+    size_t cachedStatements() const;
 };
 
 class PostgreSQL : public Database
@@ -188,6 +267,7 @@ public:
     virtual void createDatabase(const String& name);
     virtual String databaseType() const;
     virtual String getQuoted(const String& value, const String& type = String()) const;
+    virtual void bulkInsert(const String& table, const Array& columns, const std::list<Array>& rows, size_t batchsize = 1000);
     /*
     virtual void        prepare(const String &preparedStatementName, const String &query);
     virtual ResultSet	*execute(const String &preparedStatementName, const Array &params);
@@ -216,6 +296,7 @@ public:
     virtual void selectDB(const String& databasename);
     virtual void exec(const String& query);
     virtual ResultSet* query(const String& query);
+    virtual ResultSet* streamQuery(const String& query);
     virtual bool ping();
     virtual String escape(const String& str) const;
     virtual uint64_t getAffectedRows();
@@ -240,6 +321,9 @@ private:
 
     void* sqliteQuery(const String& query);
 
+protected:
+    virtual Statement* createStatement(const String& query);
+
 public:
     SQLite();
     virtual ~SQLite();
@@ -262,6 +346,30 @@ public:
     virtual void createDatabase(const String& name);
     virtual String databaseType() const;
     virtual String getQuoted(const String& value, const String& type = String()) const;
+    virtual void bulkInsert(const String& table, const Array& columns, const std::list<Array>& rows, size_t batchsize = 1000);
+};
+
+class BulkWriter
+{
+private:
+    Database* db;
+    String table;
+    Array columns;
+    std::list<Array> rows;
+    size_t batchsize;
+    uint64_t numwritten;
+
+public:
+    BulkWriter(Database& db, const String& table, const Array& columns, size_t batchsize = 1000);
+    ~BulkWriter();
+    void add(const Array& row);
+    void add(const AssocArray& row);
+    void flush();
+    void clear();
+    void setBatchSize(size_t rows);
+    size_t batchSize() const;
+    size_t pending() const;
+    uint64_t written() const;
 };
 
 class DBPool
@@ -269,12 +377,21 @@ class DBPool
     friend class DBPoolOfPools;
 
 private:
+    class CheckThread;
+    enum
+    {
+        IDLESLOTS = 32
+    };
     Mutex PoolMutex;
-    std::list<Database*> Used, Free;
+    std::list<Database*> Connections, Free;
+    std::atomic<Database*> IdleSlots[IDLESLOTS];
+    std::atomic<int> NumConnections;
+    std::atomic<int> NumIdle;
+    std::atomic<int> Waiting;
+    std::atomic<int> ConnectParamVersion;
     AssocArray ConnectParam;
     String Name;
     Logger* Log;
-    int ConnectParamVersion;
     int Id;
     int Min, Max;
     int MinSpare, MaxSpare;
@@ -284,14 +401,31 @@ private:
     int KeepAlive;
     bool IsInit;
     double LastCheck;
+    CheckThread* Checker;
+
+    std::atomic<uint64_t> StatGet, StatFastPath, StatWait, StatTimeout, StatCreated, StatDestroyed;
+    std::atomic<uint64_t> StatPingFailed, StatReconnect, StatUsedTimeout;
+
     Database* newDB();
+    Database* takeIdle();
+    bool putIdle(Database* db);
+    bool checkOut(Database* db);
+    bool healthCheck(Database* db);
+    void deleteDB(Database* db);
 
+    void checkIdle();
     void checkUsedPool();
     void createMinimum();
     void createSpare();
-    void releaseSpare();
+    void signalWaiting();
+
+    static String calcHash(const AssocArray& param);
 
 public:
+    PPL7EXCEPTION(PoolNotInitializedException, Exception);
+    PPL7EXCEPTION(PoolExhaustedException, Exception);
+    PPL7EXCEPTION(ForeignConnectionException, Exception);
+
     DBPool();
     ~DBPool();
 
@@ -316,14 +450,51 @@ public:
     void clearFreePool();
     void getStatus(AssocArray& status);
     void setLogger(Logger& logger);
+    void startCheckThread(int intervall_ms = 1000);
+    void stopCheckThread();
+    int size() const;
+    int used() const;
+    int idle() const;
 };
 
 class DBPoolOfPools
 {
 private:
+    Mutex PoolsMutex;
+    std::map<String, std::shared_ptr<DBPool> > PoolsByHash;
+    std::map<String, std::shared_ptr<DBPool> > PoolsByName;
+    std::map<int, std::shared_ptr<DBPool> > PoolsById;
+    AssocArray DefaultOptions;
+    Logger* Log;
+    int NextId;
+
+    std::shared_ptr<DBPool> findPool(const AssocArray& connect);
+    std::shared_ptr<DBPool> createPoolLocked(int id, const String& name, const AssocArray& connect);
+
 public:
+    PPL7EXCEPTION(PoolNotFoundException, Exception);
+    PPL7EXCEPTION(PoolAlreadyExistsException, Exception);
+
     DBPoolOfPools();
     ~DBPoolOfPools();
+    std::shared_ptr<DBPool> createPool(int id, const String& name, const AssocArray& connect);
+    std::shared_ptr<DBPool> createPool(const String& name, const AssocArray& connect);
+    void deletePool(int id);
+    void deletePool(const String& name);
+    void clear();
+    std::shared_ptr<DBPool> getPool(int id);
+    std::shared_ptr<DBPool> getPool(const String& name);
+    std::shared_ptr<DBPool> getPool(const AssocArray& connect);
+    Database* get(int id, bool wait = false, int ms = 0);
+    Database* get(const String& name, bool wait = false, int ms = 0);
+    Database* get(const AssocArray& connect, bool wait = false, int ms = 0);
+    void release(Database* db);
+    void destroy(Database* db);
+    void checkPools();
+    void getStatus(AssocArray& status);
+    void setDefaultOptions(const AssocArray& options);
+    void setLogger(Logger& logger);
+    size_t count();
 };
 
 } // namespace db
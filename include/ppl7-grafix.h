@@ -42,6 +42,9 @@
 
 namespace ppl7
 {
+
+class TaskExecutor;
+
 namespace grafix
 {
 
@@ -603,6 +606,45 @@ public:
 bool operator!=(const Font& f1, const Font& f2);
 bool operator==(const Font& f1, const Font& f2);
 
+class Drawable;
+
+class Resampler
+{
+public:
+    enum Filter
+    {
+        Box = 0,
+        Bilinear,
+        Bicubic,
+        Lanczos3
+    };
+
+private:
+    Filter myfilter;
+    size_t numthreads;
+    TaskExecutor* executor;
+
+    Resampler(const Resampler&);
+    Resampler& operator=(const Resampler&);
+    TaskExecutor* workers();
+
+public:
+    explicit Resampler(Filter filter = Lanczos3, size_t threads = 0);
+    ~Resampler();
+
+    void setFilter(Filter filter);
+    Filter filter() const;
+    void setThreads(size_t threads);
+    size_t threads() const;
+
+    void resample(const Drawable& src, Drawable& tgt);
+    Image resampled(const Drawable& src, int width, int height);
+
+    static bool isSupported(const RGBFormat& format);
+    static uint32_t setCaps(uint32_t caps);
+    static uint32_t caps();
+};
+
 class Drawable
 {
     friend class Image;
@@ -658,6 +700,8 @@ public:
     Drawable getDrawable(int x1, int y1, int x2, int y2) const;
     Image scaled(int width, int height, bool keepAspectRation = true, bool smoothTransform = false) const;
     void scale(Image& tgt, int width, int height, bool keepAspectRation = true, bool smoothTransform = false) const;
+    Image scaled(int width, int height, Resampler::Filter filter, bool keepAspectRation = true) const;
+    void scale(Image& tgt, int width, int height, Resampler::Filter filter, bool keepAspectRation = true) const;
     //@}
 
     /** @name Farben
@@ -778,6 +822,9 @@ public:
     void load(const String& Filename, const RGBFormat& format = RGBFormat::unknown);
     void load(FileObject& file, const RGBFormat& format = RGBFormat::unknown);
     void load(const ByteArrayPtr& Mem, const RGBFormat& format = RGBFormat::unknown);
+    void load(const String& Filename, const Size& minsize, const RGBFormat& format = RGBFormat::unknown);
+    void load(FileObject& file, const Size& minsize, const RGBFormat& format = RGBFormat::unknown);
+    void load(const ByteArrayPtr& Mem, const Size& minsize, const RGBFormat& format = RGBFormat::unknown);
     void copy(const Drawable& other);
     void copy(const Drawable& other, const Rect& rect);
     void copy(const Image& other);
@@ -843,6 +890,42 @@ public:
     ImageList& operator=(const ImageList& other);
 };
 
+class PixelConverter
+{
+private:
+    RGBFormat sformat, tformat;
+    int method;
+    int decodemethod, encodemethod;
+    int sbpp, tbpp;
+    uint8_t shuffle[4];
+    uint8_t decodeshuffle[4];
+    uint8_t encodeshuffle[4];
+    uint8_t greyweights[4];
+    uint32_t palette[256];
+    uint32_t tpalette[256];
+
+    void decodeRow(const uint8_t* src, uint32_t* tgt, int pixels) const;
+    void encodeRow(const uint32_t* src, uint8_t* tgt, int pixels) const;
+
+public:
+    PixelConverter();
+    PixelConverter(const RGBFormat& source, const RGBFormat& target);
+
+    void setFormat(const RGBFormat& source, const RGBFormat& target);
+    RGBFormat sourceFormat() const;
+    RGBFormat targetFormat() const;
+    bool isSupported() const;
+    void setPaletteColor(int index, const Color& color);
+
+    void convertRow(const void* src, void* tgt, int pixels) const;
+    void writeRow(Drawable& surface, int y, const void* src, int pixels) const;
+    void readRow(const Drawable& surface, int y, void* tgt, int pixels) const;
+
+    static bool isSupported(const RGBFormat& source, const RGBFormat& target);
+    static uint32_t setCaps(uint32_t caps);
+    static uint32_t caps();
+};
+
 class ImageFilter;
 class FontEngine;
 class FontFile;
@@ -883,6 +966,8 @@ public:
     ImageList Icons32;
 
     GRAFIX_FUNCTIONS* getGrafixFunctions(const RGBFormat& format);
+    uint32_t setBlitCaps(uint32_t caps);
+    uint32_t blitCaps() const;
 
     // Image-Filter und Loader
     void addImageFilter(ImageFilter* filter);
@@ -978,6 +1063,7 @@ class FontEngineFreeType : public FontEngine
 {
 private:
     void* ft;
+    size_t maxCacheSize;
 
 public:
     FontEngineFreeType();
@@ -990,11 +1076,18 @@ public:
     virtual Size measure(const FontFile& file, const Font& font, const WideString& text);
     virtual String name() const;
     virtual String description() const;
+
+    void setCacheSize(size_t bytes);
+    size_t cacheSize() const;
+    size_t cacheUsage() const;
+    void clearCache();
 };
 
 class ImageFilter
 {
-private:
+protected:
+    static int powerOfTwoDenominator(const IMAGE& img, const Size& minsize, int maxdenominator);
+
 public:
     PPL7EXCEPTION(IllegalImageFormatException, Exception);
     PPL7EXCEPTION(EmptyImageException, Exception);
@@ -1003,6 +1096,8 @@ public:
     virtual ~ImageFilter();
     virtual int ident(FileObject& file, IMAGE& img);
     virtual void load(FileObject& file, Drawable& surface, IMAGE& img);
+    virtual int scaleDenominator(const IMAGE& img, const Size& minsize);
+    virtual void loadScaled(FileObject& file, Drawable& surface, IMAGE& img, int denominator);
     virtual void save(const Drawable& surface, FileObject& file, const Rect& area, const AssocArray& param = AssocArray());
     virtual void save(const Drawable& surface, FileObject& file, const AssocArray& param = AssocArray());
     virtual String name();
@@ -1019,6 +1114,8 @@ public:
     virtual ~ImageFilter_PNG();
     virtual int ident(FileObject& file, IMAGE& img);
     virtual void load(FileObject& file, Drawable& surface, IMAGE& img);
+    virtual int scaleDenominator(const IMAGE& img, const Size& minsize);
+    virtual void loadScaled(FileObject& file, Drawable& surface, IMAGE& img, int denominator);
     virtual void save(const Drawable& surface, FileObject& file, const AssocArray& param = AssocArray());
     virtual String name();
     virtual String description();
@@ -1031,6 +1128,8 @@ public:
     virtual ~ImageFilter_JPEG();
     virtual int ident(FileObject& file, IMAGE& img);
     virtual void load(FileObject& file, Drawable& surface, IMAGE& img);
+    virtual int scaleDenominator(const IMAGE& img, const Size& minsize);
+    virtual void loadScaled(FileObject& file, Drawable& surface, IMAGE& img, int denominator);
     virtual void save(const Drawable& surface, FileObject& file, const AssocArray& param = AssocArray());
     virtual String name();
     virtual String description();
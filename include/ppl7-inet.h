@@ -38,6 +38,7 @@
 #endif
 #endif
 
+#include <atomic>
 #include <list>
 #include <map>
 
@@ -172,6 +173,431 @@ public:
 
 std::ostream& operator<<(std::ostream& s, const IPNetwork& net);
 
+//! \brief Tabelle mit IPv4- und IPv6-Netzen und Longest-Prefix-Match
+//!
+//! Die Netze werden in einem pfadkomprimierten Binärbaum (Patricia-Trie) pro
+//! Adressfamilie abgelegt, dessen Knoten in einem zusammenhängenden Array liegen.
+//! Ein Lookup benötigt höchstens so viele Schritte, wie es unterschiedliche
+//! Präfixlängen auf dem Weg zur Adresse gibt, unabhängig von der Anzahl Netze.
+//! Der Typ \p T muss default-konstruierbar und kopierbar sein.
+template<class T> class IPNetworkTable
+{
+private:
+    static const uint32_t NIL = 0xffffffff;
+
+    class Node
+    {
+    public:
+        uint64_t key[2];
+        uint32_t child[2];
+        uint8_t prefixlen;
+        bool used;
+        T value;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freelist;
+    uint32_t root[2];
+    size_t entries;
+
+    static int familyIndex(IPAddress::IP_FAMILY family)
+    {
+        if (family == IPAddress::IPv4) return 0;
+        if (family == IPAddress::IPv6) return 1;
+        throw InvalidIpAddressException();
+    }
+
+    static int makeKey(const IPAddress& addr, uint64_t key[2])
+    {
+        int f = familyIndex(addr.family());
+        const unsigned char* a = (const unsigned char*)addr.addr();
+        key[0] = key[1] = 0;
+        if (f == 0) {
+            key[0] = ((uint64_t)a[0] << 56) | ((uint64_t)a[1] << 48) | ((uint64_t)a[2] << 40) | ((uint64_t)a[3] << 32);
+        } else {
+            for (int i = 0; i < 8; i++) {
+                key[0] = (key[0] << 8) | a[i];
+                key[1] = (key[1] << 8) | a[i + 8];
+            }
+        }
+        return f;
+    }
+
+    static void maskKey(uint64_t key[2], int prefixlen)
+    {
+        if (prefixlen < 64) {
+            key[0] = prefixlen ? key[0] & (~(uint64_t)0 << (64 - prefixlen)) : 0;
+            key[1] = 0;
+        } else if (prefixlen < 128) {
+            key[1] = prefixlen > 64 ? key[1] & (~(uint64_t)0 << (128 - prefixlen)) : 0;
+        }
+    }
+
+    static int bit(const uint64_t key[2], int pos)
+    {
+        if (pos < 64) return (int)((key[0] >> (63 - pos)) & 1);
+        return (int)((key[1] >> (127 - pos)) & 1);
+    }
+
+    static int leadingZeros(uint64_t x)
+    {
+#ifdef __GNUC__
+        return __builtin_clzll(x);
+#else
+        int n = 0;
+        while (!(x & ((uint64_t)1 << 63))) {
+            x <<= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    static int commonBits(const uint64_t a[2], const uint64_t b[2])
+    {
+        uint64_t x = a[0] ^ b[0];
+        if (x) return leadingZeros(x);
+        x = a[1] ^ b[1];
+        if (x) return 64 + leadingZeros(x);
+        return 128;
+    }
+
+    static bool matches(const uint64_t key[2], const Node& node)
+    {
+        uint64_t k[2] = { key[0], key[1] };
+        maskKey(k, node.prefixlen);
+        return k[0] == node.key[0] && k[1] == node.key[1];
+    }
+
+    static int maxBits(int f)
+    {
+        return f == 0 ? 32 : 128;
+    }
+
+    uint32_t allocNode(const uint64_t key[2], int prefixlen)
+    {
+        uint32_t n;
+        if (freelist.size()) {
+            n = freelist.back();
+            freelist.pop_back();
+        } else {
+            if (nodes.size() >= NIL) throw OutOfMemoryException();
+            n = (uint32_t)nodes.size();
+            nodes.push_back(Node());
+        }
+        Node& node = nodes[n];
+        node.key[0] = key[0];
+        node.key[1] = key[1];
+        maskKey(node.key, prefixlen);
+        node.child[0] = node.child[1] = NIL;
+        node.prefixlen = (uint8_t)prefixlen;
+        node.used = false;
+        node.value = T();
+        return n;
+    }
+
+    void freeNode(uint32_t n)
+    {
+        nodes[n].value = T();
+        nodes[n].used = false;
+        freelist.push_back(n);
+    }
+
+    void setSlot(int f, uint32_t parent, int dir, uint32_t n)
+    {
+        if (parent == NIL) root[f] = n;
+        else nodes[parent].child[dir] = n;
+    }
+
+    static void toNetwork(int f, const Node& node, IPNetwork& net)
+    {
+        unsigned char a[16];
+        for (int i = 0; i < 8; i++) {
+            a[i] = (unsigned char)(node.key[0] >> (56 - i * 8));
+            a[i + 8] = (unsigned char)(node.key[1] >> (56 - i * 8));
+        }
+        IPAddress ip(f == 0 ? IPAddress::IPv4 : IPAddress::IPv6, a, f == 0 ? 4 : 16);
+        net.set(ip, node.prefixlen);
+    }
+
+    uint32_t lookupNode(const IPAddress& addr, int& f) const
+    {
+        uint64_t key[2];
+        f = makeKey(addr, key);
+        int maxbits = maxBits(f);
+        uint32_t best = NIL;
+        uint32_t n = root[f];
+        while (n != NIL) {
+            const Node& node = nodes[n];
+            if (!matches(key, node)) break;
+            if (node.used) best = n;
+            if (node.prefixlen >= maxbits) break;
+            n = node.child[bit(key, node.prefixlen)];
+        }
+        return best;
+    }
+
+    uint32_t findNode(const IPNetwork& net, int& f, uint32_t* path, int* dirs, int& depth) const
+    {
+        uint64_t key[2];
+        f = makeKey(net.addr(), key);
+        int prefixlen = net.prefixlen();
+        depth = 0;
+        uint32_t n = root[f];
+        while (n != NIL) {
+            const Node& node = nodes[n];
+            if (node.prefixlen > prefixlen || !matches(key, node)) return NIL;
+            if (node.prefixlen == prefixlen) return node.used ? n : NIL;
+            path[depth] = n;
+            dirs[depth] = bit(key, node.prefixlen);
+            depth++;
+            n = node.child[bit(key, node.prefixlen)];
+        }
+        return NIL;
+    }
+
+public:
+    IPNetworkTable()
+    {
+        root[0] = root[1] = NIL;
+        entries = 0;
+    }
+
+    //! \brief Alle Netze entfernen
+    void clear()
+    {
+        nodes.clear();
+        freelist.clear();
+        root[0] = root[1] = NIL;
+        entries = 0;
+    }
+
+    //! \brief Platz für \p num Netze vorreservieren
+    void reserve(size_t num)
+    {
+        nodes.reserve(num * 2);
+    }
+
+    //! \brief Netz \p net mit \p value einfügen, ein vorhandener Wert wird ersetzt
+    void insert(const IPNetwork& net, const T& value)
+    {
+        uint64_t key[2];
+        int f = makeKey(net.addr(), key);
+        int prefixlen = net.prefixlen();
+        maskKey(key, prefixlen);
+        uint32_t parent = NIL;
+        int dir = 0;
+        uint32_t n = root[f];
+        while (n != NIL) {
+            int common = commonBits(key, nodes[n].key);
+            int nodelen = nodes[n].prefixlen;
+            if (common > nodelen) common = nodelen;
+            if (common > prefixlen) common = prefixlen;
+            if (common < nodelen) {
+                uint32_t m = allocNode(key, prefixlen);
+                nodes[m].used = true;
+                nodes[m].value = value;
+                entries++;
+                if (common == prefixlen) {
+                    // Das neue Netz umfasst den Knoten
+                    nodes[m].child[bit(nodes[n].key, prefixlen)] = n;
+                    setSlot(f, parent, dir, m);
+                } else {
+                    // Verzweigung ohne eigenen Wert einfügen
+                    uint32_t glue = allocNode(key, common);
+                    nodes[glue].child[bit(key, common)] = m;
+                    nodes[glue].child[bit(nodes[n].key, common)] = n;
+                    setSlot(f, parent, dir, glue);
+                }
+                return;
+            }
+            if (nodelen == prefixlen) {
+                if (!nodes[n].used) entries++;
+                nodes[n].used = true;
+                nodes[n].value = value;
+                return;
+            }
+            parent = n;
+            dir = bit(key, nodelen);
+            n = nodes[n].child[dir];
+        }
+        n = allocNode(key, prefixlen);
+        nodes[n].used = true;
+        nodes[n].value = value;
+        entries++;
+        setSlot(f, parent, dir, n);
+    }
+
+    //! \brief Netz \p net entfernen, liefert false, wenn es nicht vorhanden war
+    bool remove(const IPNetwork& net)
+    {
+        uint32_t path[130];
+        int dirs[130];
+        int depth, f;
+        uint32_t n = findNode(net, f, path, dirs, depth);
+        if (n == NIL) return false;
+        entries--;
+        nodes[n].used = false;
+        nodes[n].value = T();
+        // Knoten ohne Wert mit weniger als zwei Kindern werden nicht benötigt
+        while (n != NIL && !nodes[n].used) {
+            uint32_t c0 = nodes[n].child[0], c1 = nodes[n].child[1];
+            if (c0 != NIL && c1 != NIL) break;
+            uint32_t parent = depth ? path[depth - 1] : NIL;
+            int dir = depth ? dirs[depth - 1] : 0;
+            setSlot(f, parent, dir, c0 != NIL ? c0 : c1);
+            freeNode(n);
+            n = parent;
+            if (depth) depth--;
+        }
+        return true;
+    }
+
+    //! \brief Liefert true, wenn genau das Netz \p net enthalten ist
+    bool exists(const IPNetwork& net) const
+    {
+        uint32_t path[130];
+        int dirs[130];
+        int depth, f;
+        return findNode(net, f, path, dirs, depth) != NIL;
+    }
+
+    //! \brief Wert von genau dem Netz \p net, oder NULL
+    const T* find(const IPNetwork& net) const
+    {
+        uint32_t path[130];
+        int dirs[130];
+        int depth, f;
+        uint32_t n = findNode(net, f, path, dirs, depth);
+        return n != NIL ? &nodes[n].value : NULL;
+    }
+
+    //! \brief Wert des längsten Netzes, das \p addr enthält, oder NULL
+    const T* lookup(const IPAddress& addr) const
+    {
+        int f;
+        uint32_t n = lookupNode(addr, f);
+        return n != NIL ? &nodes[n].value : NULL;
+    }
+
+    //! \brief Wie lookup(addr), liefert zusätzlich das gefundene Netz in \p match
+    const T* lookup(const IPAddress& addr, IPNetwork& match) const
+    {
+        int f;
+        uint32_t n = lookupNode(addr, f);
+        if (n == NIL) return NULL;
+        toNetwork(f, nodes[n], match);
+        return &nodes[n].value;
+    }
+
+    //! \brief Wert des längsten passenden Netzes, wirft ItemNotFoundException
+    const T& get(const IPAddress& addr) const
+    {
+        const T* value = lookup(addr);
+        if (!value) throw ItemNotFoundException("%s", (const char*)addr.toString());
+        return *value;
+    }
+
+    //! \brief Liefert true, wenn \p addr in einem der Netze liegt
+    bool contains(const IPAddress& addr) const
+    {
+        return lookup(addr) != NULL;
+    }
+
+    //! \brief Longest-Prefix-Match für \p num Adressen
+    //!
+    //! Die Adressen werden in Gruppen gleichzeitig durch den Baum geführt, so dass
+    //! sich die Speicherzugriffe der einzelnen Lookups überlappen. \p results erhält
+    //! für jede Adresse den Wert oder NULL. Liefert die Anzahl Treffer.
+    size_t lookup(const IPAddress* addr, size_t num, const T** results) const
+    {
+        const size_t group = 8;
+        uint64_t key[group][2];
+        uint32_t cur[group], best[group];
+        int maxbits[group];
+        size_t hits = 0;
+        for (size_t start = 0; start < num; start += group) {
+            size_t count = num - start < group ? num - start : group;
+            for (size_t j = 0; j < count; j++) {
+                int f = makeKey(addr[start + j], key[j]);
+                maxbits[j] = maxBits(f);
+                cur[j] = root[f];
+                best[j] = NIL;
+            }
+            size_t active = count;
+            while (active) {
+                active = 0;
+                for (size_t j = 0; j < count; j++) {
+                    uint32_t n = cur[j];
+                    if (n == NIL) continue;
+                    const Node& node = nodes[n];
+                    if (!matches(key[j], node)) {
+                        cur[j] = NIL;
+                        continue;
+                    }
+                    if (node.used) best[j] = n;
+                    n = node.prefixlen >= maxbits[j] ? NIL : node.child[bit(key[j], node.prefixlen)];
+                    cur[j] = n;
+                    if (n != NIL) {
+#ifdef __GNUC__
+                        __builtin_prefetch(&nodes[n]);
+#endif
+                        active++;
+                    }
+                }
+            }
+            for (size_t j = 0; j < count; j++) {
+                if (best[j] != NIL) {
+                    results[start + j] = &nodes[best[j]].value;
+                    hits++;
+                } else {
+                    results[start + j] = NULL;
+                }
+            }
+        }
+        return hits;
+    }
+
+    //! \brief Longest-Prefix-Match für alle Adressen aus \p addr
+    size_t lookup(const std::vector<IPAddress>& addr, std::vector<const T*>& results) const
+    {
+        results.resize(addr.size());
+        if (addr.empty()) return 0;
+        return lookup(addr.data(), addr.size(), results.data());
+    }
+
+    //! \brief Anzahl Netze in der Tabelle
+    size_t count() const
+    {
+        return entries;
+    }
+
+    size_t size() const
+    {
+        return entries;
+    }
+
+    bool empty() const
+    {
+        return entries == 0;
+    }
+
+    //! \brief Anzahl belegter Knoten inklusive Verzweigungen ohne Wert
+    size_t nodeCount() const
+    {
+        return nodes.size() - freelist.size();
+    }
+
+    //! \brief Speicherverbrauch der Tabelle in Bytes
+    //!
+    //! Berücksichtigt den reservierten Speicher der Knoten, nicht aber Speicher,
+    //! den \p T selbst dynamisch anfordert.
+    size_t memoryUsage() const
+    {
+        return sizeof(*this) + nodes.capacity() * sizeof(Node) + freelist.capacity() * sizeof(uint32_t);
+    }
+};
+
 class SockAddr
 {
 private:
@@ -366,6 +792,7 @@ public:
     void setPayload(const ByteArrayPtr& msg);
     void getPayload(String& msg) const;
     void getPayload(AssocArray& msg) const;
+    void getPayload(AssocArrayView& msg) const;
     void getPayload(ByteArray& msg) const;
     int getPayloadType();
     void enableCompression(bool flag = true);
@@ -377,6 +804,8 @@ public:
 //! \brief TCP-Socket-Klasse
 class TCPSocket
 {
+    friend class TCPServer;
+
 private:
     Mutex mutex;
     SSLContext* sslcontext;
@@ -460,6 +889,7 @@ public:
     void sslCheckCertificate(const ppl7::String& name, bool AcceptSelfSignedCert = false);
     void sslAccept(SSLContext& context);
     void sslWaitForAccept(SSLContext& context, int timeout_ms = 0);
+    bool sslTryAccept(SSLContext& context);
     bool sslIsEncrypted() const;
     String sslGetCipherName() const;
     String sslGetCipherVersion() const;
@@ -473,6 +903,120 @@ public:
     //@}
 };
 
+//! \brief Ereignisschleife zum Überwachen vieler Sockets
+class EventLoop
+{
+public:
+    enum Events
+    {
+        EVENT_READ = 1,
+        EVENT_WRITE = 2,
+        EVENT_HANGUP = 4,
+        EVENT_ERROR = 8
+    };
+
+    //! \brief Empfänger der Ereignisse einer EventLoop
+    class Handler
+    {
+    public:
+        virtual ~Handler();
+        virtual int eventReady(int fd, int events) = 0;
+        virtual void eventRemoved(int fd);
+    };
+
+private:
+    class Worker;
+    class Registration;
+
+    mutable Mutex mutex;
+    Mutex queuemutex;
+    std::map<int, Registration*> registrations;
+    std::list<Registration*> queue;
+    ThreadPool workers;
+    size_t numWorkers;
+    int epollfd;
+    std::atomic<bool> stopflag;
+    bool running;
+
+    void dispatch(Registration* r);
+    bool processQueue(Worker* worker);
+    void rearm(Registration* r);
+
+public:
+    EventLoop();
+    ~EventLoop();
+
+    void setWorkerThreads(size_t num);
+    size_t workerThreads() const;
+    void add(int fd, int events, Handler* handler);
+    void remove(int fd);
+    bool contains(int fd) const;
+    size_t size() const;
+
+    void run(int timeout_ms = 100);
+    void stop();
+    bool isRunning() const;
+};
+
+//! \brief Ereignisgesteuerter TCP-Server für viele gleichzeitige Verbindungen
+class TCPServer : private EventLoop::Handler
+{
+public:
+    //! \brief Verbindung eines Clients mit dem TCPServer
+    class Connection : public TCPSocket
+    {
+        friend class TCPServer;
+
+    private:
+        String peerhost;
+        int peerport;
+        bool handshake;
+        bool wantwrite;
+        bool closerequest;
+        void* userdata;
+
+    public:
+        Connection();
+        const String& peerHost() const;
+        int peerPort() const;
+        void watchWritable(bool enable = true);
+        void close();
+        void setUserData(void* data);
+        void* userData() const;
+    };
+
+private:
+    mutable Mutex mutex;
+    TCPSocket listener;
+    EventLoop loop;
+    SSLContext* sslcontext;
+    std::map<int, Connection*> connections;
+    int listenfd;
+
+    int eventReady(int fd, int events);
+    void eventRemoved(int fd);
+    void acceptConnections();
+    int handleConnection(Connection* conn, int events);
+
+public:
+    TCPServer();
+    virtual ~TCPServer();
+
+    void bind(const String& host, int port);
+    void setWorkerThreads(size_t num);
+    void enableSSL(SSLContext& context);
+    void disableSSL();
+    void run(int backlog = 1024, int timeout_ms = 100);
+    void stop();
+    bool isRunning() const;
+    size_t connectionCount() const;
+
+    virtual bool onConnect(Connection& conn);
+    virtual void onReadable(Connection& conn) = 0;
+    virtual void onWritable(Connection& conn);
+    virtual void onDisconnect(Connection& conn);
+};
+
 class UDPSocket
 {
 private:
@@ -115,14 +115,24 @@ class MemoryHeap
 {
 private:
     void* blocks;
+    void* partial;
+    void* threadcache;
     size_t myElementSize, increaseSize;
+    size_t elementStride;
     size_t myGrowPercent;
     size_t blocksAllocated, blocksUsed;
     size_t mem_allocated;
     size_t mem_used;
     size_t freeCount;
+    uint64_t heapkey;
+    uint64_t cacheid;
 
     void increase(size_t num);
+    void* allocElement();
+    void releaseElement(void* element);
+    void* checkElement(void* element) const;
+    void* threadMagazine();
+    void releaseMagazine(void* magazine, size_t keep);
 
 public:
     PPL7EXCEPTION(NotInitializedException, Exception);
@@ -146,6 +156,9 @@ public:
     size_t elementSize() const;
     void reserve(size_t num);
     void cleanup();
+    void enableThreadCache(size_t magazinesize = 32);
+    void disableThreadCache();
+    bool isThreadSafe() const;
 };
 
 class MemoryGroup
@@ -172,6 +185,27 @@ public:
     size_t size() const;
 };
 
+class MemoryArena
+{
+private:
+    MemoryGroup blocks;
+    char* ptr;
+    size_t remaining;
+    size_t blocksize;
+    size_t used;
+
+public:
+    explicit MemoryArena(size_t blocksize = 65536);
+    ~MemoryArena();
+    void clear();
+    void* malloc(size_t size);
+    void* calloc(size_t size);
+    char* strndup(const char* string, size_t size);
+    size_t memoryUsed() const;
+    size_t memoryAllocated() const;
+    size_t blockSize() const;
+};
+
 } // namespace ppl7
 // Inlcude PPL7 Algorithms
 #ifdef PPL7LIB
@@ -1078,9 +1112,20 @@ public:
         SYSLOG_LOCAL7
     };
 
+    enum OVERFLOW_POLICY
+    {
+        OVERFLOW_BLOCK = 0,
+        OVERFLOW_DROP,
+        OVERFLOW_COUNT
+    };
+
 private:
+    class AsyncQueue;
+    class State;
     Mutex mutex;
+    Mutex filtermutex;
     AssocArray *FilterModule, *FilterFile;
+    State* state;
     String ProgIdentity;
     int debuglevel[NUMFACILITIES];
     bool console_enabled;
@@ -1101,6 +1146,10 @@ private:
 
     bool shouldPrint(const char* module, const char* function, const char* file, int line, PRIORITY prio, int level);
     int isFiltered(const char* module, const char* function, const char* file, int line, int level);
+    int filterThreshold(const char* module, const char* function, const char* file, int line);
+    void filtersChanged();
+    AsyncQueue* acquireQueue() const;
+    void releaseQueue() const;
     void output(PRIORITY prio,
                 int level,
                 const char* module,
@@ -1109,6 +1158,33 @@ private:
                 int line,
                 const String& buffer,
                 bool printdate = true);
+    void writeMessage(PRIORITY prio,
+                      int level,
+                      const char* module,
+                      const char* function,
+                      const char* file,
+                      int line,
+                      const String& buffer,
+                      bool printdate,
+                      const String& date,
+                      uint64_t threadid,
+                      bool flush);
+    bool emitAsync(PRIORITY prio,
+                   int level,
+                   const char* module,
+                   const char* function,
+                   const char* file,
+                   int line,
+                   const String& buffer,
+                   bool printdate);
+    void emit(PRIORITY prio,
+              int level,
+              const char* module,
+              const char* function,
+              const char* file,
+              int line,
+              const String& buffer,
+              bool printdate = true);
     void outputArray(PRIORITY prio,
                      int level,
                      const char* module,
@@ -1135,6 +1211,11 @@ public:
     void enableConsole(bool flag = true, PRIORITY prio = Logger::DEBUG, int level = 1);
     void openSyslog(const String& ident, SYSLOG_FACILITY facility = SYSLOG_USER);
     void closeSyslog();
+    void enableAsync(size_t capacity = 8192, OVERFLOW_POLICY policy = OVERFLOW_BLOCK);
+    void disableAsync();
+    bool isAsync() const;
+    void flush();
+    uint64_t droppedMessages() const;
     void printException(const Exception& e);
     void printException(const char* file, int line, const Exception& e);
     void printException(const char* file, int line, const char* module, const char* function, const Exception& e);
@@ -1222,6 +1303,7 @@ public:
     void add(const String& key, const char* value);
     void add(const String& key, int value);
     void add(const String& key, bool value);
+    void add(const StringView& key, const StringView& value);
     void add(const String& section, const String& key, int value);
     void add(const String& section, const String& key, bool value);
     void deleteKey(const String& key);
@@ -1240,14 +1322,58 @@ public:
     void print() const;
 };
 
+class JsonEventHandler
+{
+public:
+    enum ValueType
+    {
+        TYPE_STRING = 1,
+        TYPE_NUMBER,
+        TYPE_BOOLEAN,
+        TYPE_NULL
+    };
+    virtual ~JsonEventHandler();
+    virtual void startObject();
+    virtual void endObject();
+    virtual void startArray();
+    virtual void endArray();
+    virtual void key(const String& name);
+    virtual void value(const String& value, ValueType type);
+};
+
+class JsonReader;
+
+class JsonLineReader
+{
+private:
+    JsonReader* reader;
+    uint64_t records;
+
+    JsonLineReader(const JsonLineReader&) = delete;
+    JsonLineReader& operator=(const JsonLineReader&) = delete;
+
+public:
+    JsonLineReader(FileObject& file);
+    ~JsonLineReader();
+    bool next(AssocArray& data);
+    bool next(JsonEventHandler& handler);
+    uint64_t count() const;
+};
+
 class Json
 {
 public:
     static void loads(ppl7::AssocArray& data, const ppl7::String& json);
+    static void loads(ppl7::AssocArray& data, const ppl7::ByteArrayPtr& json);
     static void load(ppl7::AssocArray& data, ppl7::FileObject& file);
     static ppl7::AssocArray loads(const ppl7::String& json);
+    static ppl7::AssocArray loads(const ppl7::ByteArrayPtr& json);
     static ppl7::AssocArray load(ppl7::FileObject& file);
 
+    static void parse(JsonEventHandler& handler, const ppl7::String& json);
+    static void parse(JsonEventHandler& handler, const ppl7::ByteArrayPtr& json);
+    static void parse(JsonEventHandler& handler, ppl7::FileObject& file);
+
     static void dumps(ppl7::String& json, const ppl7::AssocArray& data);
     static void dump(ppl7::FileObject& file, const ppl7::AssocArray& data);
     static ppl7::String dumps(const ppl7::AssocArray& data);
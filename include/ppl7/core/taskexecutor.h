@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#ifndef PPL7_CORE_TASKEXECUTOR_H_
+#define PPL7_CORE_TASKEXECUTOR_H_
+
+#ifndef _PPL7_INCLUDE
+#ifdef PPL7LIB
+#include "ppl7.h"
+#else
+#include <ppl7.h>
+#endif
+#endif
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace ppl7
+{
+
+//! \brief Task-basierte Ausführung mit Work-Stealing
+class TaskExecutor
+{
+public:
+    typedef std::function<void()> Task;
+
+private:
+    class Worker;
+    static thread_local Worker* currentWorker;
+    std::vector<Worker*> workers;
+    ThreadPool pool;
+    Mutex sleepmutex;
+    Mutex errormutex;
+    std::exception_ptr error;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> active;
+    std::atomic<size_t> sleeping;
+    std::atomic<size_t> next;
+    std::atomic<bool> stopflag;
+    String name;
+    Thread::Priority priority;
+
+    TaskExecutor(const TaskExecutor&);
+    TaskExecutor& operator=(const TaskExecutor&);
+
+    void push(Task&& task);
+    bool popTask(Worker* self, Task& task);
+    void execute(Task& task);
+    void workerLoop(Worker* self);
+    void runChunks(size_t num, const std::function<void(size_t)>& fn);
+
+public:
+    explicit TaskExecutor(size_t threads = 0, const String& name = "TaskExecutor", Thread::Priority priority = Thread::NORMAL);
+    ~TaskExecutor();
+
+    size_t threads() const;
+    size_t pendingTasks() const;
+    void post(const Task& task);
+    bool runPendingTask();
+    void wait();
+
+    template<class F> auto submit(F func) -> std::future<decltype(func())>
+    {
+        typedef decltype(func()) R;
+        std::shared_ptr<std::packaged_task<R()> > task = std::make_shared<std::packaged_task<R()> >(std::move(func));
+        std::future<R> result = task->get_future();
+        post([task]() { (*task)(); });
+        return result;
+    }
+
+    template<class Index, class Body> void parallelFor(Index begin, Index end, Body body, Index grain = 0)
+    {
+        if (end <= begin) return;
+        size_t count = (size_t)(end - begin);
+        size_t chunk = (size_t)grain;
+        if (!chunk) chunk = count / (workers.size() * 4 + 1) + 1;
+        size_t num = (count + chunk - 1) / chunk;
+        runChunks(num, [&](size_t c) {
+            Index from = begin + (Index)(c * chunk);
+            Index to = (c == num - 1) ? end : from + (Index)chunk;
+            for (Index i = from; i < to; ++i) body(i);
+        });
+    }
+
+    template<class T, class Index, class Map, class Reduce>
+    T parallelReduce(Index begin, Index end, const T& identity, Map map, Reduce reduce, Index grain = 0)
+    {
+        if (end <= begin) return identity;
+        size_t count = (size_t)(end - begin);
+        size_t chunk = (size_t)grain;
+        if (!chunk) chunk = count / (workers.size() * 4 + 1) + 1;
+        size_t num = (count + chunk - 1) / chunk;
+        std::vector<T> partial(num, identity);
+        runChunks(num, [&](size_t c) {
+            Index from = begin + (Index)(c * chunk);
+            Index to = (c == num - 1) ? end : from + (Index)chunk;
+            T value = identity;
+            for (Index i = from; i < to; ++i) value = reduce(value, map(i));
+            partial[c] = value;
+        });
+        T result = identity;
+        for (size_t c = 0; c < num; c++) result = reduce(result, partial[c]);
+        return result;
+    }
+};
+
+}; // namespace ppl7
+
+#endif /* PPL7_CORE_TASKEXECUTOR_H_ */
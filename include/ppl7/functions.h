@@ -48,6 +48,11 @@ void HexDump(const void* address, size_t bytes);
 String ToBase64(const ByteArrayPtr& bin);
 ByteArray FromBase64(const String& str);
 uint32_t Crc32(const void* buffer, size_t size);
+uint32_t Crc32(uint32_t crc, const void* buffer, size_t size);
+uint32_t Crc32Combine(uint32_t crc1, uint32_t crc2, uint64_t size2);
+uint32_t Adler32(const void* buffer, size_t size);
+uint32_t Adler32(uint32_t adler, const void* buffer, size_t size);
+uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, uint64_t size2);
 String Md5(const void* buffer, size_t size);
 String Md5(const ByteArrayPtr& buffer);
 double Calc(const String& expression);
@@ -145,6 +150,7 @@ enum
     CPU_HAVE_AVX2 = 0x00008000,
     CPU_HAVE_AVX512 = 0x00010000,
     CPU_HAVE_SHA = 0x00020000,
+    CPU_HAVE_PCLMUL = 0x00040000,
 };
 } // namespace CPUCAPS
 
@@ -158,6 +164,20 @@ typedef struct
 uint32_t GetCPUCaps(CPUCaps& cpu);
 uint32_t GetCPUCaps();
 
+// StringKernels.cpp
+uint32_t SetStringKernelCaps(uint32_t caps);
+uint32_t GetStringKernelCaps();
+const char* MemFind(const char* haystack, size_t haystacklen, const char* needle, size_t needlelen);
+const wchar_t* MemFind(const wchar_t* haystack, size_t haystacklen, const wchar_t* needle, size_t needlelen);
+size_t SpanWhitespace(const char* str, size_t len);
+size_t SpanWhitespace(const wchar_t* str, size_t len);
+size_t SpanWhitespaceReverse(const char* str, size_t len);
+size_t SpanWhitespaceReverse(const wchar_t* str, size_t len);
+size_t AsciiLowerCase(char* str, size_t len);
+size_t AsciiLowerCase(wchar_t* str, size_t len);
+size_t AsciiUpperCase(char* str, size_t len);
+size_t AsciiUpperCase(wchar_t* str, size_t len);
+
 // Time
 ppl_time_t GetTime(PPLTIME* t);
 ppl_time_t GetTime(PPLTIME* t, ppl_time_t tt);
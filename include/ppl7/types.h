@@ -34,10 +34,13 @@
 #include <ppl7/types/pointer.h>
 #include <ppl7/types/bytearrayptr.h>
 #include <ppl7/types/bytearray.h>
+#include <ppl7/types/stringview.h>
 #include <ppl7/types/string.h>
 #include <ppl7/types/widestring.h>
 #include <ppl7/types/array.h>
 #include <ppl7/types/assocarray.h>
+#include <ppl7/types/hashassocarray.h>
+#include <ppl7/types/assocarrayview.h>
 #include <ppl7/types/datetime.h>
 
 #endif /* PPL7_TYPES_H_ */
@@ -88,6 +88,8 @@ public:
     Array& fromArgs(int argc, const char** argv);
     Array& fromArgs(const String& args);
     Array& explode(const String& text, const String& delimiter = "\n", size_t limit = 0, bool skipemptylines = false);
+    Array& explode(const StringView& text, const StringView& delimiter = "\n", size_t limit = 0, bool skipemptylines = false);
+    Array& explode(const char* text, const String& delimiter = "\n", size_t limit = 0, bool skipemptylines = false);
     //@}
 
     //! @name Elemente löschen
@@ -40,6 +40,48 @@ namespace ppl7
 {
 
 class Variant;
+class MemoryArena;
+
+void* MemoryArenaMalloc(MemoryArena* arena, size_t size);
+
+/*!\brief STL-Allocator für Container, die ihren Speicher aus einer MemoryArena beziehen
+ *
+ * \desc
+ * Ist keine Arena angegeben, wird der normale Heap verwendet. Speicher aus der Arena wird
+ * von deallocate nicht freigegeben, sondern erst mit MemoryArena::clear.
+ */
+template<class T> class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    MemoryArena* arena;
+
+    ArenaAllocator(MemoryArena* arena = NULL) noexcept
+    {
+        this->arena = arena;
+    }
+    template<class U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+    {
+        arena = other.arena;
+    }
+    T* allocate(size_t n)
+    {
+        if (arena) return static_cast<T*>(MemoryArenaMalloc(arena, n * sizeof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t) noexcept
+    {
+        if (!arena) ::operator delete(p);
+    }
+    template<class U> bool operator==(const ArenaAllocator<U>& other) const noexcept
+    {
+        return arena == other.arena;
+    }
+    template<class U> bool operator!=(const ArenaAllocator<U>& other) const noexcept
+    {
+        return arena != other.arena;
+    }
+};
 
 class AssocArray
 {
@@ -61,21 +103,45 @@ private:
         bool operator>(const ArrayKey& str) const;
     };
 
-    std::map<ArrayKey, Variant*> Tree;
+    /*!\brief Vergleichsfunktion für den Baum
+     *
+     * \desc
+     * Der Vergleich ist transparent, Elemente können daher auch mit einem StringView
+     * gesucht werden, ohne dass dafür ein temporärer ArrayKey angelegt werden muss.
+     */
+    class KeyCompare
+    {
+    public:
+        typedef void is_transparent;
+        bool operator()(const StringView& a, const StringView& b) const
+        {
+            return compareKeys(a, b) < 0;
+        }
+    };
+
+    typedef std::map<ArrayKey, Variant*, KeyCompare, ArenaAllocator<std::pair<const ArrayKey, Variant*> > > TreeType;
+
+    TreeType Tree;
     uint64_t maxint;
+    MemoryArena* arena;
 
-    Variant* findInternal(const ArrayKey& key) const;
+    static int compareKeys(const StringView& a, const StringView& b);
+    Variant* findInternal(const StringView& key) const;
     void createTree(const ArrayKey& key, Variant* var);
+    template<class T> Variant* newVariant(const T& value, Variant::DataType type);
+    Variant* newVariant(const Variant& value);
+    Variant* newAssocArray(const AssocArray* value = NULL);
+    void deleteVariant(Variant* var) const;
 
 public:
     PPL7EXCEPTION(InvalidKeyException, Exception);
     PPL7EXCEPTION(ExportBufferToSmallException, Exception);
     PPL7EXCEPTION(ImportFailedException, Exception);
 
-    typedef std::map<ArrayKey, Variant*>::iterator iterator;
-    typedef std::map<ArrayKey, Variant*>::const_iterator const_iterator;
-    typedef std::map<ArrayKey, Variant*>::reverse_iterator reverse_iterator;
-    typedef std::map<ArrayKey, Variant*>::const_reverse_iterator const_reverse_iterator;
+    typedef TreeType::iterator iterator;
+    typedef TreeType::const_iterator const_iterator;
+    typedef TreeType::reverse_iterator reverse_iterator;
+    typedef TreeType::const_reverse_iterator const_reverse_iterator;
 
     class Iterator
     {
@@ -128,6 +194,7 @@ public:
     //@{
     AssocArray();
     AssocArray(const AssocArray& other);
+    explicit AssocArray(MemoryArena& arena);
     ~AssocArray();
     //@}
 
@@ -137,6 +204,7 @@ public:
     size_t count(const String& key, bool recursive = false) const;
     size_t size() const;
     void list(const String& prefix = "") const;
+    MemoryArena* memoryArena() const;
 
     //@}
 
@@ -192,20 +260,50 @@ public:
     //!\name Werte direkt auslesen
     //@{
     Variant& get(const String& key) const;
+    Variant& get(const StringView& key) const;
+    Variant& get(const char* key) const;
     String& getString(const String& key) const;
+    String& getString(const StringView& key) const;
+    String& getString(const char* key) const;
     String& getString(const String& key, String& default_value) const;
+    String& getString(const StringView& key, String& default_value) const;
+    String& getString(const char* key, String& default_value) const;
     const String& getString(const String& key, const String& default_value) const;
+    const String& getString(const StringView& key, const String& default_value) const;
+    const String& getString(const char* key, const String& default_value) const;
     int getInt(const String& key) const;
+    int getInt(const StringView& key) const;
+    int getInt(const char* key) const;
     int getInt(const String& key, int default_value) const;
+    int getInt(const StringView& key, int default_value) const;
+    int getInt(const char* key, int default_value) const;
     long long getLongLong(const String& key) const;
+    long long getLongLong(const StringView& key) const;
+    long long getLongLong(const char* key) const;
     long long getLongLong(const String& key, long long default_value) const;
+    long long getLongLong(const StringView& key, long long default_value) const;
+    long long getLongLong(const char* key, long long default_value) const;
     AssocArray& getAssocArray(const String& key) const;
+    AssocArray& getAssocArray(const StringView& key) const;
+    AssocArray& getAssocArray(const char* key) const;
     AssocArray& getAssocArray(const String& key, AssocArray& default_value) const;
+    AssocArray& getAssocArray(const StringView& key, AssocArray& default_value) const;
+    AssocArray& getAssocArray(const char* key, AssocArray& default_value) const;
     Array& getArray(const String& key) const;
+    Array& getArray(const StringView& key) const;
+    Array& getArray(const char* key) const;
     Array& getArray(const String& key, Array& default_value) const;
+    Array& getArray(const StringView& key, Array& default_value) const;
+    Array& getArray(const char* key, Array& default_value) const;
     bool getBoolean(const String& key, bool default_value) const;
+    bool getBoolean(const StringView& key, bool default_value) const;
+    bool getBoolean(const char* key, bool default_value) const;
     bool exists(const String& key) const;
+    bool exists(const StringView& key) const;
+    bool exists(const char* key) const;
     bool isTrue(const String& key) const;
+    bool isTrue(const StringView& key) const;
+    bool isTrue(const char* key) const;
 
     //@}
 
@@ -236,7 +334,11 @@ public:
     //!\name Operatoren
     //@{
     Variant& operator[](const String& key);
+    Variant& operator[](const StringView& key);
+    Variant& operator[](const char* key);
     const Variant& operator[](const String& key) const;
+    const Variant& operator[](const StringView& key) const;
+    const Variant& operator[](const char* key) const;
     AssocArray& operator=(const AssocArray& other);
     AssocArray& operator+=(const AssocArray& other);
 
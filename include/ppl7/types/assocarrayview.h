@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#ifndef PPL7_TYPES_ASSOCARRAYVIEW_H_
+#define PPL7_TYPES_ASSOCARRAYVIEW_H_
+
+#include <stdint.h>
+
+#include "ppl7/types/variant.h"
+#include "ppl7/types/string.h"
+#include "ppl7/types/bytearrayptr.h"
+#include "ppl7/exceptions.h"
+
+namespace ppl7
+{
+
+class AssocArray;
+class Array;
+class DateTime;
+
+class AssocArrayView
+{
+public:
+    PPL7EXCEPTION(InvalidKeyException, Exception);
+    PPL7EXCEPTION(ImportFailedException, Exception);
+
+    class Element
+    {
+    private:
+        friend class AssocArrayView;
+        const char* keyptr;
+        size_t keylen;
+        const char* valueptr;
+        size_t valuesize;
+        const char* limit;
+        int datatype;
+
+    public:
+        Element();
+        int type() const;
+        bool isString() const;
+        bool isWideString() const;
+        bool isArray() const;
+        bool isAssocArray() const;
+        bool isByteArray() const;
+        bool isDateTime() const;
+        String key() const;
+        ByteArrayPtr keyPtr() const;
+        ByteArrayPtr value() const;
+        String toString() const;
+        int toInt() const;
+        long long toLongLong() const;
+        Array toArray() const;
+        DateTime toDateTime() const;
+        AssocArrayView toAssocArrayView() const;
+    };
+
+    class const_iterator
+    {
+    private:
+        friend class AssocArrayView;
+        const char* next;
+        const char* limit;
+        Element e;
+        const_iterator(const char* ptr, const char* limit);
+
+    public:
+        const_iterator();
+        const Element& operator*() const
+        {
+            return e;
+        }
+        const Element* operator->() const
+        {
+            return &e;
+        }
+        const_iterator& operator++();
+        bool operator==(const const_iterator& other) const
+        {
+            return e.keyptr == other.e.keyptr;
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return e.keyptr != other.e.keyptr;
+        }
+    };
+
+private:
+    const char* buffer;
+    const char* limit;
+
+    bool findInternal(const StringView& key, Element& e) const;
+    static const char* parseElement(const char* ptr, const char* limit, Element& e);
+    static const char* skipAssocArray(const char* ptr, const char* limit);
+
+public:
+    //!\name Konstruktoren
+    //@{
+    AssocArrayView();
+    AssocArrayView(const void* buffer, size_t buffersize);
+    explicit AssocArrayView(const ByteArrayPtr& bin);
+    //@}
+
+    void set(const void* buffer, size_t buffersize);
+    void set(const ByteArrayPtr& bin);
+    void clear();
+
+    //!\name Informationen ausgeben/auslesen
+    //@{
+    bool empty() const;
+    size_t count() const;
+    size_t binarySize() const;
+    ByteArrayPtr binary() const;
+    //@}
+
+    //!\name Werte direkt auslesen
+    //@{
+    Element get(const StringView& key) const;
+    bool get(const StringView& key, Element& e) const;
+    bool exists(const StringView& key) const;
+    String getString(const StringView& key) const;
+    String getString(const StringView& key, const String& default_value) const;
+    int getInt(const StringView& key) const;
+    int getInt(const StringView& key, int default_value) const;
+    long long getLongLong(const StringView& key) const;
+    long long getLongLong(const StringView& key, long long default_value) const;
+    bool getBoolean(const StringView& key, bool default_value) const;
+    ByteArrayPtr getByteArrayPtr(const StringView& key) const;
+    Array getArray(const StringView& key) const;
+    DateTime getDateTime(const StringView& key) const;
+    AssocArrayView getAssocArray(const StringView& key) const;
+    //@}
+
+    //!\name Import und Export von Daten
+    //@{
+    void toAssocArray(AssocArray& target) const;
+    //@}
+
+    //!\name Array durchwandern
+    //@{
+    const_iterator begin() const;
+    const_iterator end() const;
+    //@}
+};
+
+} // namespace ppl7
+
+#endif /* PPL7_TYPES_ASSOCARRAYVIEW_H_ */
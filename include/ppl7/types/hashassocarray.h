@@ -0,0 +1,319 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#ifndef PPL7_TYPES_HASHASSOCARRAY_H_
+#define PPL7_TYPES_HASHASSOCARRAY_H_
+
+#include <stdint.h>
+#include <utility>
+
+#include "ppl7/types/variant.h"
+#include "ppl7/types/string.h"
+#include "ppl7/exceptions.h"
+
+namespace ppl7
+{
+
+class Variant;
+class AssocArray;
+
+class HashAssocArray
+{
+public:
+    typedef std::pair<const String, Variant*> value_type;
+
+private:
+    class Element
+    {
+    public:
+        value_type data;
+        uint64_t hash;
+        int64_t intkey;
+        bool numeric;
+        Element* bucketnext;
+        Element* prev;
+        Element* next;
+        Element(const char* key, size_t keylen, uint64_t hash, Variant* value);
+    };
+
+    class Key
+    {
+    public:
+        const char* ptr;
+        size_t len;
+        uint64_t hash;
+        int64_t intkey;
+        bool numeric;
+        Key(const char* key, size_t keylen);
+    };
+
+    Element** buckets;
+    size_t numbuckets;
+    size_t elements;
+    Element* first;
+    Element* last;
+    uint64_t maxint;
+
+    Element* findElement(const Key& key) const;
+    Element* insertElement(const Key& key, Variant* value);
+    void removeElement(Element* e);
+    void rehash(size_t newsize);
+    Variant* findInternal(const StringView& key) const;
+    void createTree(const String& key, Variant* var);
+
+public:
+    PPL7EXCEPTION(InvalidKeyException, Exception);
+    PPL7EXCEPTION(ExportBufferToSmallException, Exception);
+    PPL7EXCEPTION(ImportFailedException, Exception);
+
+    class const_iterator;
+    class iterator
+    {
+    private:
+        friend class HashAssocArray;
+        friend class const_iterator;
+        Element* e;
+        iterator(Element* e)
+        {
+            this->e = e;
+        }
+
+    public:
+        iterator()
+        {
+            e = NULL;
+        }
+        value_type& operator*() const
+        {
+            return e->data;
+        }
+        value_type* operator->() const
+        {
+            return &e->data;
+        }
+        iterator& operator++()
+        {
+            e = e->next;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator old(e);
+            e = e->next;
+            return old;
+        }
+        bool operator==(const iterator& other) const
+        {
+            return e == other.e;
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return e != other.e;
+        }
+    };
+
+    class const_iterator
+    {
+    private:
+        friend class HashAssocArray;
+        const Element* e;
+        const_iterator(const Element* e)
+        {
+            this->e = e;
+        }
+
+    public:
+        const_iterator()
+        {
+            e = NULL;
+        }
+        const_iterator(const iterator& other)
+        {
+            e = other.e;
+        }
+        const value_type& operator*() const
+        {
+            return e->data;
+        }
+        const value_type* operator->() const
+        {
+            return &e->data;
+        }
+        const_iterator& operator++()
+        {
+            e = e->next;
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator old(e);
+            e = e->next;
+            return old;
+        }
+        bool operator==(const const_iterator& other) const
+        {
+            return e == other.e;
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return e != other.e;
+        }
+    };
+
+    class Iterator
+    {
+    private:
+        friend class HashAssocArray;
+        const Element* e;
+        Variant empty;
+        bool reset;
+
+    public:
+        Iterator()
+        {
+            e = NULL;
+            reset = true;
+        }
+        const String& key()
+        {
+            return e->data.first;
+        }
+        const Variant& value()
+        {
+            if (e->data.second == NULL) return empty;
+            return *e->data.second;
+        };
+    };
+
+    //!\name Konstruktoren und Destruktoren
+    //@{
+    HashAssocArray();
+    HashAssocArray(const HashAssocArray& other);
+    HashAssocArray(HashAssocArray&& other);
+    explicit HashAssocArray(const AssocArray& other);
+    ~HashAssocArray();
+    //@}
+
+    //!\name Informationen ausgeben/auslesen
+    //@{
+    size_t count(bool recursive = false) const;
+    size_t count(const String& key, bool recursive = false) const;
+    size_t size() const;
+    void list(const String& prefix = "") const;
+    void reserve(size_t size);
+    //@}
+
+    //!\name Werte setzen
+    //@{
+    void add(const HashAssocArray& other);
+    void add(const AssocArray& other);
+    void set(const String& key, const String& value);
+    void set(const String& key, const String& value, size_t size);
+    void set(const String& key, const WideString& value);
+    void set(const String& key, const Array& value);
+    void set(const String& key, const DateTime& value);
+    void set(const String& key, const ByteArray& value);
+    void set(const String& key, const ByteArrayPtr& value);
+    void set(const String& key, const AssocArray& value);
+    void set(const String& key, const HashAssocArray& value);
+    void set(const String& key, const Variant& value);
+    void setf(const String& key, const char* fmt, ...);
+    //@}
+
+    //!\name Werte erweitern (nur Strings)
+    //@{
+    void append(const String& key, const String& value, const String& concat = "");
+    void appendf(const String& key, const String& concat, const char* fmt, ...);
+    //@}
+
+    //!\name Werte löschen
+    //@{
+    void clear();
+    void erase(const String& key);
+    void remove(const String& key);
+    //@}
+
+    //!\name Import und Export von Daten
+    //@{
+    void toAssocArray(AssocArray& target) const;
+    size_t binarySize() const;
+    void exportBinary(void* buffer, size_t buffersize, size_t* realsize) const;
+    void exportBinary(ByteArray& buffer) const;
+    size_t importBinary(const void* buffer, size_t buffersize);
+    void importBinary(const ByteArrayPtr& buffer);
+    //@}
+
+    //!\name Werte direkt auslesen
+    //@{
+    Variant& get(const StringView& key) const;
+    String& getString(const StringView& key) const;
+    String& getString(const StringView& key, String& default_value) const;
+    const String& getString(const StringView& key, const String& default_value) const;
+    int getInt(const StringView& key) const;
+    int getInt(const StringView& key, int default_value) const;
+    long long getLongLong(const StringView& key) const;
+    long long getLongLong(const StringView& key, long long default_value) const;
+    HashAssocArray& getAssocArray(const StringView& key) const;
+    HashAssocArray& getAssocArray(const StringView& key, HashAssocArray& default_value) const;
+    Array& getArray(const StringView& key) const;
+    Array& getArray(const StringView& key, Array& default_value) const;
+    bool getBoolean(const StringView& key, bool default_value) const;
+    bool exists(const StringView& key) const;
+    bool isTrue(const StringView& key) const;
+    //@}
+
+    //!\name Array durchwandern
+    //@{
+    iterator begin();
+    const_iterator begin() const;
+    iterator end();
+    const_iterator end() const;
+
+    void reset(Iterator& it) const;
+    bool getFirst(Iterator& it, Variant::DataType type = Variant::TYPE_UNKNOWN) const;
+    bool getNext(Iterator& it, Variant::DataType type = Variant::TYPE_UNKNOWN) const;
+    bool getFirst(Iterator& it, String& key, String& value) const;
+    bool getNext(Iterator& it, String& key, String& value) const;
+    //@}
+
+    //!\name Operatoren
+    //@{
+    Variant& operator[](const StringView& key);
+    const Variant& operator[](const StringView& key) const;
+    HashAssocArray& operator=(const HashAssocArray& other);
+    HashAssocArray& operator=(HashAssocArray&& other);
+    HashAssocArray& operator+=(const HashAssocArray& other);
+
+    bool operator==(const HashAssocArray& other) const;
+    bool operator!=(const HashAssocArray& other) const;
+    //@}
+};
+
+} // namespace ppl7
+
+#endif /* PPL7_TYPES_HASHASSOCARRAY_H_ */
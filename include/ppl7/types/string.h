@@ -32,6 +32,8 @@
 #include <string>
 #include <stdint.h>
 
+#include "ppl7/types/stringview.h"
+
 namespace ppl7
 {
 
@@ -50,12 +52,30 @@ class Array;
  * Die einzelnen Zeichen des Strings werden intern im Unicode-Format gespeichert. Bei Übernahme eines
  * C-Strings wird erwartet, dass dieser im UTF-8 Format vorliegt, mit der statischen Funktion
  * String::setGlobalEncoding kann jedoch auch eine andere Kodierung vorgegeben werden.
+ *
+ * Kurze Strings mit bis zu 7 Byte (auf 32-Bit-Systemen 3 Byte) werden in einem Puffer innerhalb
+ * des Objekts gespeichert, so dass dafür kein Speicher auf dem Heap angefordert werden muss.
+ * Der Puffer belegt den Platz der Speichergröße, die Größe des Objekts ändert sich dadurch nicht.
  */
 class String
 {
 private:
+    static const size_t InlineBufferSize = sizeof(size_t);
     char* ptr;
-    size_t s, stringlen;
+    union {
+        size_t s;
+        char inlinebuffer[InlineBufferSize];
+    };
+    size_t stringlen;
+
+    size_t bufsize() const noexcept
+    {
+        return ptr == inlinebuffer ? InlineBufferSize : s;
+    }
+    void releaseBuffer() noexcept;
+    void allocate(size_t bytes);
+    void grow(size_t bytes);
+    void moveFrom(String& other) noexcept;
 
 public:
     //! @name Konstruktoren und Destruktor
@@ -158,6 +178,17 @@ public:
      */
     String(const std::wstring& str);
 
+    /**@brief Konstruktor aus StringView
+     *
+     * \desc
+     * Der von \p str referenzierte Speicherbereich wird in den neuen String kopiert. Der Konstruktor
+     * ist explizit, damit Kopien eines StringView im Code sichtbar bleiben.
+     *
+     * @param str Referenz auf einen StringView
+     * @exception OutOfMemoryException
+     */
+    explicit String(const StringView& str);
+
     /**@brief Move-Konstruktor
      *
      * Ein String wird aus einem anderen String erstellt. Dabei wird der Speicher des anderen Strings übernommen.
@@ -258,6 +289,14 @@ public:
      */
     void reserve(size_t size);
 
+    /**\brief Nicht benötigten Speicher freigeben
+     *
+     * Mit dieser Funktion wird der Speicherbereich des Strings auf die tatsächlich benötigte Größe
+     * verkleinert. Passt der String in den internen Puffer, wird der Speicher auf dem Heap
+     * vollständig freigegeben.
+     */
+    void shrink_to_fit();
+
     /**\brief Länge des Strings abfragen
      *
      * Mit dieser Funktion kann die Länge des Strings abgefragt werden. Die Länge ist die Anzahl Zeichen, die der String aktuell enthält.
@@ -418,6 +457,16 @@ public:
      */
     String& set(const String& str, size_t size = (size_t)-1);
 
+    /**@brief String anhand eines StringView setzen
+     *
+     * Mit dieser Funktion wird der von \p str referenzierte Speicherbereich in den String kopiert.
+     *
+     * @param str Referenz auf einen StringView
+     * @return Referenz auf den String
+     * @exception OutOfMemoryException
+     */
+    String& set(const StringView& str);
+
     /**@brief String anhand eines ByteArrayPtr setzen
      *
      * Mit dieser Funktion wird der String anhand eines ByteArrayPtr gesetzt. Dabei wird er
@@ -582,6 +631,14 @@ public:
      */
     String& append(const String& str, size_t size = (size_t)-1);
 
+    /**@brief StringView an das Ende des bestehenden Strings anhängen
+     *
+     * @param str Referenz auf einen StringView
+     * @return Referenz auf den String
+     * @exception OutOfMemoryException
+     */
+    String& append(const StringView& str);
+
     /**@brief String an das Ende des bestehenden anhängen
      *
      * Mit dieser Funktion wird der String \p str an das Ende des bestehenden Strings angehangen.
@@ -837,6 +894,10 @@ public:
     operator double() const;
     operator std::string() const;
     operator std::wstring() const;
+    operator StringView() const noexcept
+    {
+        return StringView(ptr, stringlen);
+    }
 
     char operator[](ssize_t pos) const;
     char& operator[](ssize_t pos);
@@ -849,11 +910,13 @@ public:
     String& operator=(const std::wstring& str);
     String& operator=(char c);
     String& operator=(String&& other) noexcept;
+    String& operator=(const StringView& str);
     String& operator+=(const char* str);
     String& operator+=(const wchar_t* str);
     String& operator+=(const String& str);
     String& operator+=(const std::string& str);
     String& operator+=(const std::wstring& str);
+    String& operator+=(const StringView& str);
     String& operator+=(char c);
     bool operator<(const String& str) const;
     bool operator<=(const String& str) const;
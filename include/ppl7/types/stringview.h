@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#ifndef PPL7_TYPES_STRINGVIEW_H_
+#define PPL7_TYPES_STRINGVIEW_H_
+
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ppl7/types/bytearrayptr.h"
+
+namespace ppl7
+{
+
+class String;
+
+class StringView
+{
+private:
+    const char* ptr;
+    size_t stringlen;
+
+public:
+    static const size_t npos = (size_t)-1;
+
+    //!\name Konstruktoren
+    //@{
+    StringView() noexcept
+        : ptr(""), stringlen(0)
+    {
+    }
+    StringView(const char* str) noexcept
+        : ptr(str ? str : ""), stringlen(str ? ::strlen(str) : 0)
+    {
+    }
+    StringView(const char* str, size_t size) noexcept
+        : ptr(str ? str : ""), stringlen(str ? size : 0)
+    {
+    }
+    StringView(const std::string& str) noexcept
+        : ptr(str.data()), stringlen(str.size())
+    {
+    }
+    explicit StringView(const ByteArrayPtr& bin)
+        : ptr((const char*)bin.ptr()), stringlen(bin.size())
+    {
+        if (!ptr) ptr = "";
+    }
+    //@}
+
+    //!\name Informationen
+    //@{
+    const char* data() const noexcept
+    {
+        return ptr;
+    }
+    size_t size() const noexcept
+    {
+        return stringlen;
+    }
+    size_t len() const noexcept
+    {
+        return stringlen;
+    }
+    size_t length() const noexcept
+    {
+        return stringlen;
+    }
+    bool isEmpty() const noexcept
+    {
+        return stringlen == 0;
+    }
+    bool notEmpty() const noexcept
+    {
+        return stringlen != 0;
+    }
+    bool isNumeric() const;
+    bool isInteger() const;
+    //@}
+
+    //!\name Zugriff
+    //@{
+    char operator[](size_t pos) const noexcept
+    {
+        return ptr[pos];
+    }
+    const char* begin() const noexcept
+    {
+        return ptr;
+    }
+    const char* end() const noexcept
+    {
+        return ptr + stringlen;
+    }
+    //@}
+
+    //!\name Teilbereiche
+    //@{
+    StringView left(size_t num) const noexcept
+    {
+        return StringView(ptr, num < stringlen ? num : stringlen);
+    }
+    StringView right(size_t num) const noexcept
+    {
+        if (num > stringlen) num = stringlen;
+        return StringView(ptr + stringlen - num, num);
+    }
+    StringView mid(size_t start, size_t num = npos) const noexcept
+    {
+        if (start >= stringlen) return StringView(ptr + stringlen, 0);
+        if (num > stringlen - start) num = stringlen - start;
+        return StringView(ptr + start, num);
+    }
+    StringView substr(size_t start, size_t num = npos) const noexcept
+    {
+        return mid(start, num);
+    }
+    void chopLeft(size_t num) noexcept;
+    void chopRight(size_t num) noexcept;
+    StringView trimmed() const;
+    StringView trimmedLeft() const;
+    StringView trimmedRight() const;
+    //@}
+
+    //!\name Suchen und Vergleichen
+    //@{
+    ssize_t instr(const StringView& needle, size_t start = 0) const;
+    ssize_t instr(char c, size_t start = 0) const;
+    bool has(const StringView& needle) const;
+    bool startsWith(const StringView& prefix) const noexcept;
+    bool endsWith(const StringView& suffix) const noexcept;
+    int strcmp(const StringView& other) const noexcept;
+    int strCaseCmp(const StringView& other) const noexcept;
+    bool operator==(const StringView& other) const noexcept
+    {
+        return stringlen == other.stringlen && memcmp(ptr, other.ptr, stringlen) == 0;
+    }
+    bool operator!=(const StringView& other) const noexcept
+    {
+        return !operator==(other);
+    }
+    bool operator<(const StringView& other) const noexcept
+    {
+        return strcmp(other) < 0;
+    }
+    //@}
+
+    //!\name Zerlegen
+    //@{
+    bool getToken(const StringView& delimiter, StringView& token);
+    size_t explode(std::vector<StringView>& result, const StringView& delimiter, size_t limit = 0, bool skipemptylines = false) const;
+    //@}
+
+    //!\name Umwandlung
+    //@{
+    String toString() const;
+    std::string toStdString() const;
+    ByteArrayPtr toByteArrayPtr() const
+    {
+        return ByteArrayPtr(ptr, stringlen);
+    }
+    int toInt() const;
+    int64_t toInt64() const;
+    long long toLongLong() const;
+    double toDouble() const;
+    bool toBool() const;
+    //@}
+};
+
+} // namespace ppl7
+
+#endif /* PPL7_TYPES_STRINGVIEW_H_ */
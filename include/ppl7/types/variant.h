@@ -36,6 +36,7 @@ class String;
 class WideString;
 class Array;
 class AssocArray;
+class HashAssocArray;
 class ByteArray;
 class ByteArrayPtr;
 class DateTime;
@@ -51,6 +52,7 @@ class Pointer;
  * - WideString
  * - Array
  * - AssocArray
+ * - HashAssocArray
  * - ByteArray
  * - ByteArrayPtr
  * - DateTime
@@ -62,20 +64,25 @@ public:
     /// @brief Mögliche Datentypen, die in einem Variant gespeichert werden können
     enum DataType // TODO: Das sollte eine enum class werden, aber das würde die Kompatibilität zu älteren Versionen brechen
     {
-        TYPE_UNKNOWN = 0,      /// @brief Unbekannter Datentyp
-        TYPE_STRING = 4,       /// @brief Datentyp ist String
-        TYPE_ASSOCARRAY = 5,   /// @brief Datentyp ist AssocArray
-        TYPE_BYTEARRAY = 6,    /// @brief Datentyp ist ByteArray
-        TYPE_POINTER = 7,      /// @brief Datentyp ist Pointer
-        TYPE_WIDESTRING = 8,   /// @brief Datentyp ist WideString
-        TYPE_ARRAY = 9,        /// @brief Datentyp ist Array
-        TYPE_DATETIME = 10,    /// @brief Datentyp ist DateTime
-        TYPE_BYTEARRAYPTR = 12 /// @brief Datentyp ist ByteArrayPtr
+        TYPE_UNKNOWN = 0,        /// @brief Unbekannter Datentyp
+        TYPE_STRING = 4,         /// @brief Datentyp ist String
+        TYPE_ASSOCARRAY = 5,     /// @brief Datentyp ist AssocArray
+        TYPE_BYTEARRAY = 6,      /// @brief Datentyp ist ByteArray
+        TYPE_POINTER = 7,        /// @brief Datentyp ist Pointer
+        TYPE_WIDESTRING = 8,     /// @brief Datentyp ist WideString
+        TYPE_ARRAY = 9,          /// @brief Datentyp ist Array
+        TYPE_DATETIME = 10,      /// @brief Datentyp ist DateTime
+        TYPE_BYTEARRAYPTR = 12,  /// @brief Datentyp ist ByteArrayPtr
+        TYPE_HASHASSOCARRAY = 13 /// @brief Datentyp ist HashAssocArray
     };
 
 private:
     void* value; /// @brief Pointer auf den Inhalt des Datentyps
     DataType t;  /// @brief Variable, zum Speichern des Datentyps
+    bool arena;  /// @brief Der Inhalt liegt in einer MemoryArena und wird nicht mit delete freigegeben
+
+    friend class AssocArray;
+    void adopt(DataType type, void* value, bool arena);
 
 public:
     /**@brief Konstruktor der Klasse
@@ -135,6 +142,14 @@ public:
      */
     Variant(const AssocArray& value);
 
+    /**@brief Konstruktor mit Datentyp HashAssocArray
+     *
+     * Der Inhalt des HashAssocArrays \p value wird kopiert.
+     *
+     * @param value
+     */
+    Variant(const HashAssocArray& value);
+
     /**@brief Konstruktor mit Datentyp ByteArray
      *
      * Der Inhalt des ByteArrays \p value wird kopiert.
@@ -215,6 +230,14 @@ public:
      */
     void set(const AssocArray& value);
 
+    /**@brief Wert eines HashAssocArrays kopieren
+     *
+     * Der Wert des HashAssocArrays \p value wird kopiert.
+     *
+     * \param value
+     */
+    void set(const HashAssocArray& value);
+
     /**@brief Wert eines ByteArrays kopieren
      *
      * Der Wert des ByteArrays \p value wird kopiert.
@@ -302,6 +325,14 @@ public:
      */
     bool isAssocArray() const;
 
+    /**@brief Prüft, ob es sich um den Datentyp HashAssocArray handelt
+     *
+     * Prüft, ob es sich um den Datentyp HashAssocArray handelt
+     *
+     * @return Liefert \c true zurück, wenn es sich um den Datentyp HashAssocArray handelt, sonst \c false.
+     */
+    bool isHashAssocArray() const;
+
     /**@brief Prüft, ob es sich um den Datentyp ByteArray handelt
      *
      * Prüft, ob es sich um den Datentyp ByteArray handelt
@@ -432,6 +463,30 @@ public:
      */
     AssocArray& toAssocArray();
 
+    /**@brief Typkonvertierung zu: const HashAssocArray
+     *
+     * Der Aufruf dieser Funktion liefert eine unveränderliche Referenz auf den gespeicherten
+     * HashAssocArray zurück, sofern der Variant diesen Datentyp enthält. Ist dies nicht der Fall,
+     * wird eine Exception geworfen.
+     *
+     * @return const Referenz auf HashAssocArray
+     * @exception TypeConversionException: Wird geworfen, wenn es sich nicht um einen HashAssocArray handelt.
+     * @exception EmptyDataException: Wird geworfen, wenn keine Daten in diesem Variant hinterlegt sind.
+     */
+    const HashAssocArray& toHashAssocArray() const;
+
+    /**@brief Typkonvertierung zu: HashAssocArray
+     *
+     * Der Aufruf dieser Funktion liefert eine Referenz auf den gespeicherten
+     * HashAssocArray zurück, sofern der Variant diesen Datentyp enthält. Ist dies nicht der Fall,
+     * wird eine Exception geworfen.
+     *
+     * @return Referenz auf HashAssocArray
+     * @exception TypeConversionException: Wird geworfen, wenn es sich nicht um einen HashAssocArray handelt.
+     * @exception EmptyDataException: Wird geworfen, wenn keine Daten in diesem Variant hinterlegt sind.
+     */
+    HashAssocArray& toHashAssocArray();
+
     /**@brief Typkonvertierung zu: const ByteArray
      *
      * Der Aufruf dieser Funktion liefert eine unveränderliche Referenz auf den gespeicherten
@@ -627,6 +682,7 @@ public:
     Variant& operator=(const WideString& other);
     Variant& operator=(const Array& other);
     Variant& operator=(const AssocArray& other);
+    Variant& operator=(const HashAssocArray& other);
     Variant& operator=(const ByteArray& other);
     Variant& operator=(const ByteArrayPtr& other);
     Variant& operator=(const DateTime& other);
@@ -639,4 +695,4 @@ public:
 
 } // namespace ppl7
 
-#endif // PPL7_TYPES_VARIANT_H_
\ No newline at end of file
+#endif // PPL7_TYPES_VARIANT_H_
\ No newline at end of file
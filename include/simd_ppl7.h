@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+/*
+ * Gemeinsame Hilfsmittel für die SSE4.1- und AVX2-Kernel der Grafikroutinen. Der Header
+ * wird nur intern verwendet und nicht installiert.
+ */
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PPL7_SIMD_X86
+#include <immintrin.h>
+#define PPL7_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define PPL7_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace ppl7
+{
+
+/*
+ * Auswahl der Vektor-Kernel eines Moduls. Berücksichtigt werden nur CPU_HAVE_SSE41 und
+ * CPU_HAVE_AVX2, und nur soweit die CPU sie unterstützt. Jedes Modul hält seine eigene
+ * Instanz in einer funktionslokalen statischen Variable, damit GetCPUCaps erst beim ersten
+ * Zugriff aufgerufen wird.
+ */
+class SimdCaps
+{
+private:
+    uint32_t current;
+
+public:
+    static const uint32_t Mask = CPUCAPS::CPU_HAVE_SSE41 | CPUCAPS::CPU_HAVE_AVX2;
+
+    SimdCaps()
+    {
+        current = GetCPUCaps() & Mask;
+    }
+    uint32_t get() const
+    {
+        return current;
+    }
+    uint32_t set(uint32_t caps)
+    {
+        uint32_t old = current;
+        current = caps & GetCPUCaps() & Mask;
+        return old;
+    }
+};
+
+} // namespace ppl7
@@ -237,6 +237,11 @@ _PPL7_GetCpuCaps:
 	jz .NO_AES		; if set, AES is supported
 		or edi,0x2000
 	.NO_AES:
+	; PCLMULQDQ
+	test ecx, BIT1		; bit 1 in ECX: PCLMULQDQ
+	jz .NO_PCLMUL
+		or edi,0x40000
+	.NO_PCLMUL:
 	; AVX
 	test ecx, BIT28		; bit 28 in ECX: AVX
 	jz .NO_AVX
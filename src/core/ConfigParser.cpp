@@ -321,6 +321,12 @@ void ConfigParser::add(const String& key, bool value)
     add(((SECTION*)section)->name, key, value);
 }
 
+void ConfigParser::add(const StringView& key, const StringView& value)
+{
+    if (!section) throw NoSectionSelectedException();
+    ((SECTION*)section)->values.append(String(key), String(value), "\n");
+}
+
 void ConfigParser::deleteKey(const String& key)
 {
     if (!section) throw NoSectionSelectedException();
@@ -535,8 +541,7 @@ void ConfigParser::loadFromString(const String& string)
 void ConfigParser::load(FileObject& file)
 {
     unload();
-    String key, value;
-    String buffer, trimmedBuffer;
+    String buffer;
     String sectionname;
 
     size_t separatorLength = separator.length();
@@ -547,30 +552,29 @@ void ConfigParser::load(FileObject& file)
     try {
         while (!file.eof()) { // Zeilen lesen, bis keine mehr kommt
             if (!file.gets(buffer, 65535)) break;
-            trimmedBuffer = buffer.trimmed();
-            size_t l = trimmedBuffer.size();
+            // Die Zeile wird nur als StringView zerlegt, Kopien entstehen erst beim Speichern
+            StringView line = StringView(buffer).trimmed();
+            size_t l = line.size();
             if (sectionname.notEmpty()) {
-                if (l == 0 || (l > 0 && trimmedBuffer[0] != '[' && trimmedBuffer[l - 1] != ']')) {
+                if (l == 0 || (l > 0 && line[0] != '[' && line[l - 1] != ']')) {
                     sections.append(sectionname, buffer);
                 }
             }
 
             if (l > 0) {
-                if (trimmedBuffer[0] == '[' && trimmedBuffer[l - 1] == ']') { // Neue [Sektion] erkannt
+                if (line[0] == '[' && line[l - 1] == ']') { // Neue [Sektion] erkannt
                     sectionname.clear();
                     if (l < 1024) { // nur gültig, wenn < 1024 Zeichen
-                        sectionname = trimmedBuffer.mid(1, l - 2);
+                        sectionname.set(line.mid(1, l - 2));
                         sections.append(sectionname, "", "");
                         createSection(sectionname);
                     }
-                } else if ((sectionname.notEmpty()) && trimmedBuffer[0] != '#' && trimmedBuffer[0] != ';') { // Kommentare ignorieren
-                    size_t trenn = trimmedBuffer.instr(separator);                                           // Trennzeichen suchen
-                    if (trenn > 0) {                     // Wenn eins gefunden wurde, dann
-                        key = trimmedBuffer.left(trenn); // Key ist alles vor dem Trennzeichen
-                        key.trim();
-                        value = trimmedBuffer.mid(trenn + separatorLength); // Value der rest danach
-                        value.trim();
-                        add(sectionname, key, value); // Und das ganze dann hinzufügen ins Array
+                } else if ((sectionname.notEmpty()) && line[0] != '#' && line[0] != ';') { // Kommentare ignorieren
+                    size_t trenn = line.instr(StringView(separator));                  // Trennzeichen suchen
+                    if (trenn > 0) {                                                 // Wenn eins gefunden wurde, dann
+                        // createSection hat die Sektion bereits ausgewählt, die Suche nach dem Namen entfällt
+                        add(line.left(trenn).trimmed(),                    // Key ist alles vor dem Trennzeichen
+                            line.mid(trenn + separatorLength).trimmed()); // Value der rest danach
                     }
                 }
             }
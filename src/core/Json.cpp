@@ -40,6 +40,8 @@
 #include <stdarg.h>
 #endif
 
+#include <list>
+
 #include "ppl7.h"
 
 namespace ppl7
@@ -56,106 +58,273 @@ struct ParserState
     };
 };
 
-static void readDict(ppl7::AssocArray& data, ppl7::FileObject& file);
-static void readArray(ppl7::AssocArray& data, ppl7::FileObject& file);
+#define JSON_READ_BLOCKSIZE 65536
 
-static ppl7::String getString(ppl7::FileObject& file)
+/*
+ * JsonReader gives the parser access to a contiguous window of the input.
+ * If the input is already in memory, the window covers the whole document and
+ * nothing is copied. If the input is a FileObject, the data is pulled in blocks
+ * of JSON_READ_BLOCKSIZE bytes instead of single characters.
+ */
+class JsonReader
 {
-    ppl7::String str;
-    int c;
-    while (!file.eof()) {
-        c = file.fgetc();
-        if (c == '\\') {
-            c = file.fgetc();
-            if (c == 'n')
-                str.append("\n");
-            else if (c == 'r')
-                str.append("\r");
-            else if (c == 't')
-                str.append("\t");
-            else if (c == 'b')
-                str.append("\b");
-            else if (c == 'f')
-                str.append("\f");
-            else if (c == '"')
-                str.append("\"");
-            else if (c == '\\')
-                str.append("\\");
-            else if (c == '/')
-                str.append("/");
-            else if (c == 'u') {
-                char hex[5];
-                for (int i = 0; i < 4; i++) {
-                    int h = file.fgetc();
-                    if (h == EOF) throw ppl7::UnexpectedEndOfDataException();
-                    hex[i] = (char)h;
-                }
-                hex[4] = 0;
-                unsigned int codePoint = strtoul(hex, NULL, 16);
-
-                // Handle surrogate pairs
-                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
-                    int nextC = file.fgetc();
-                    if (nextC == '\\') {
-                        int nextNextC = file.fgetc();
-                        if (nextNextC == 'u') {
-                            for (int i = 0; i < 4; i++) {
-                                int h = file.fgetc();
-                                if (h == EOF) throw ppl7::UnexpectedEndOfDataException();
-                                hex[i] = (char)h;
-                            }
-                            hex[4] = 0;
-                            unsigned int lowSurrogate = strtoul(hex, NULL, 16);
-                            if (lowSurrogate >= 0xDC00 && lowSurrogate <= 0xDFFF) {
-                                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
-                            } else {
-                                // Not a valid low surrogate? Backup and treat high surrogate as is
-                                file.seek(-6, ppl7::File::SEEKCUR);
-                            }
-                        } else {
-                            file.seek(-2, ppl7::File::SEEKCUR);
-                        }
-                    } else {
-                        file.seek(-1, ppl7::File::SEEKCUR);
-                    }
-                }
-
-                ppl7::WideString ws;
-                ws.append((wchar_t)codePoint);
-                str.append(ws.toUtf8().toString());
-            } else
-                throw InvalidEscapeSequenceException("\\%c", c);
-        } else if (c == '"') {
-            return str;
-        } else {
-            str.append(c);
+private:
+    ppl7::FileObject* file;
+    char* blockbuffer;
+    const char* buffer;
+    size_t buffersize;
+    size_t pos;
+    uint64_t offset;
+
+    size_t readBlock(char* target, size_t bytes);
+    bool fill(size_t bytes);
+
+public:
+    JsonReader(const char* data, size_t size);
+    JsonReader(ppl7::FileObject& file);
+    ~JsonReader();
+
+    inline size_t available(size_t bytes = 1)
+    {
+        if (buffersize - pos < bytes) fill(bytes);
+        return buffersize - pos;
+    }
+
+    inline bool eof()
+    {
+        return available() == 0;
+    }
+
+    inline int getc()
+    {
+        if (pos < buffersize || fill(1)) return (unsigned char)buffer[pos++];
+        return EOF;
+    }
+
+    inline void unget()
+    {
+        pos--;
+    }
+
+    inline const char* current() const
+    {
+        return buffer + pos;
+    }
+
+    inline void skip(size_t bytes)
+    {
+        pos += bytes;
+    }
+
+    inline uint64_t tell() const
+    {
+        return offset + pos;
+    }
+};
+
+JsonReader::JsonReader(const char* data, size_t size)
+{
+    file = NULL;
+    blockbuffer = NULL;
+    buffer = data;
+    buffersize = (data != NULL) ? size : 0;
+    pos = 0;
+    offset = 0;
+}
+
+JsonReader::JsonReader(ppl7::FileObject& file)
+{
+    this->file = &file;
+    blockbuffer = (char*)malloc(JSON_READ_BLOCKSIZE);
+    if (!blockbuffer) throw OutOfMemoryException();
+    buffer = blockbuffer;
+    buffersize = 0;
+    pos = 0;
+    offset = file.tell();
+}
+
+JsonReader::~JsonReader()
+{
+    free(blockbuffer);
+}
+
+size_t JsonReader::readBlock(char* target, size_t bytes)
+{
+    if (file->eof()) return 0;
+    // MemFile throws on short reads, so we never ask for more than is left,
+    // as far as the size is known
+    uint64_t position = file->tell();
+    uint64_t size = file->size();
+    if (size > position && size - position < bytes) bytes = (size_t)(size - position);
+    try {
+        return file->fread(target, 1, bytes);
+    } catch (const ppl7::EndOfFileException&) {
+        return 0;
+    }
+}
+
+bool JsonReader::fill(size_t bytes)
+{
+    if (!file) return false;
+    size_t remaining = buffersize - pos;
+    if (remaining > 0 && pos > 0) memmove(blockbuffer, blockbuffer + pos, remaining);
+    offset += pos;
+    pos = 0;
+    buffersize = remaining;
+    while (buffersize < bytes) {
+        size_t got = readBlock(blockbuffer + buffersize, JSON_READ_BLOCKSIZE - buffersize);
+        if (!got) break;
+        buffersize += got;
+    }
+    return buffersize >= bytes;
+}
+
+/*
+ * Returns the offset of the first quotation mark or backslash in p, or size,
+ * if there is none. Eight bytes are checked at once, a loop the compiler can
+ * easily vectorize.
+ */
+static inline size_t findStringDelimiter(const char* p, size_t size)
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highbits = 0x8080808080808080ULL;
+    const uint64_t quotes = ones * '"';
+    const uint64_t backslashes = ones * '\\';
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        uint64_t q = v ^ quotes;
+        uint64_t b = v ^ backslashes;
+        if ((((q - ones) & ~q) | ((b - ones) & ~b)) & highbits) break;
+    }
+    for (; i < size; i++) {
+        if (p[i] == '"' || p[i] == '\\') return i;
+    }
+    return size;
+}
+
+static void appendUtf8(ppl7::String& str, unsigned int codePoint)
+{
+    char buffer[4];
+    size_t size;
+    if (codePoint < 0x80) {
+        buffer[0] = (char)codePoint;
+        size = 1;
+    } else if (codePoint < 0x800) {
+        buffer[0] = (char)(0xc0 | (codePoint >> 6));
+        buffer[1] = (char)(0x80 | (codePoint & 0x3f));
+        size = 2;
+    } else if (codePoint < 0x10000) {
+        buffer[0] = (char)(0xe0 | (codePoint >> 12));
+        buffer[1] = (char)(0x80 | ((codePoint >> 6) & 0x3f));
+        buffer[2] = (char)(0x80 | (codePoint & 0x3f));
+        size = 3;
+    } else {
+        buffer[0] = (char)(0xf0 | (codePoint >> 18));
+        buffer[1] = (char)(0x80 | ((codePoint >> 12) & 0x3f));
+        buffer[2] = (char)(0x80 | ((codePoint >> 6) & 0x3f));
+        buffer[3] = (char)(0x80 | (codePoint & 0x3f));
+        size = 4;
+    }
+    str.append(buffer, size);
+}
+
+static unsigned int parseHex4(const char* p)
+{
+    char hex[5];
+    memcpy(hex, p, 4);
+    hex[4] = 0;
+    return strtoul(hex, NULL, 16);
+}
+
+static void readUnicodeEscape(ppl7::String& str, JsonReader& in)
+{
+    if (in.available(4) < 4) throw ppl7::UnexpectedEndOfDataException();
+    unsigned int codePoint = parseHex4(in.current());
+    in.skip(4);
+    // Handle surrogate pairs. If the high surrogate is not followed by a valid
+    // low surrogate, it is taken as is and the following data is parsed normally.
+    if (codePoint >= 0xD800 && codePoint <= 0xDBFF && in.available(6) >= 6) {
+        const char* p = in.current();
+        if (p[0] == '\\' && p[1] == 'u') {
+            unsigned int lowSurrogate = parseHex4(p + 2);
+            if (lowSurrogate >= 0xDC00 && lowSurrogate <= 0xDFFF) {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                in.skip(6);
+            }
         }
     }
-    throw ppl7::UnexpectedEndOfDataException();
+    appendUtf8(str, codePoint);
 }
 
-static ppl7::String getNumber(ppl7::FileObject& file)
+static void readEscapeSequence(ppl7::String& str, JsonReader& in)
 {
-    ppl7::String str;
-    int c;
-    while (!file.eof()) {
-        c = file.fgetc();
-        if (c == EOF) break;
-        if (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9')) {
-            str.append(c);
-        } else {
-            file.seek(-1, ppl7::File::SEEKCUR);
-            return str;
+    int c = in.getc();
+    switch (c) {
+        case 'n': str.append('\n'); break;
+        case 'r': str.append('\r'); break;
+        case 't': str.append('\t'); break;
+        case 'b': str.append('\b'); break;
+        case 'f': str.append('\f'); break;
+        case '"': str.append('"'); break;
+        case '\\': str.append('\\'); break;
+        case '/': str.append('/'); break;
+        case 'u': readUnicodeEscape(str, in); break;
+        case EOF: throw ppl7::UnexpectedEndOfDataException();
+        default: throw InvalidEscapeSequenceException("\\%c", c);
+    }
+}
+
+/*
+ * Reads a string up to the closing quotation mark, which must follow the
+ * opening one already consumed by the caller. Unescaped runs of characters are
+ * appended at once.
+ */
+static void getString(ppl7::String& str, JsonReader& in)
+{
+    str.clear();
+    size_t avail;
+    while ((avail = in.available()) > 0) {
+        const char* p = in.current();
+        size_t run = findStringDelimiter(p, avail);
+        if (run) {
+            str.append(p, run);
+            in.skip(run);
         }
+        if (run == avail) continue;
+        char c = p[run];
+        in.skip(1);
+        if (c == '"') return;
+        readEscapeSequence(str, in);
+    }
+    throw ppl7::UnexpectedEndOfDataException();
+}
+
+static inline bool isNumberChar(int c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+static void getNumber(ppl7::String& str, JsonReader& in)
+{
+    str.clear();
+    size_t avail;
+    while ((avail = in.available()) > 0) {
+        const char* p = in.current();
+        size_t len = 0;
+        while (len < avail && isNumberChar(p[len])) len++;
+        str.append(p, len);
+        in.skip(len);
+        if (len < avail) return;
     }
-    return str;
 }
 
-static void readChars(ppl7::FileObject& file, const char* chars)
+static void readChars(JsonReader& in, const char* chars)
 {
     int c, p = 0;
     while (chars[p] != 0) {
-        c = file.fgetc();
+        c = in.getc();
         if (c == EOF) throw ppl7::UnexpectedEndOfDataException();
         if (c != chars[p])
             throw ppl7::UnexpectedCharacterException("#1: Expected: >>%s<<, character: >>%c<<, got: >>%c<<", chars, chars[p], c);
@@ -163,152 +332,494 @@ static void readChars(ppl7::FileObject& file, const char* chars)
     }
 }
 
-static void skipToEOL(ppl7::FileObject& file)
+static void skipToEOL(JsonReader& in)
 {
-    while (!file.eof()) {
-        int c = file.fgetc();
-        if (c == '\n') return;
+    size_t avail;
+    while ((avail = in.available()) > 0) {
+        const char* p = in.current();
+        const char* eol = (const char*)memchr(p, '\n', avail);
+        if (eol) {
+            in.skip(eol - p + 1);
+            return;
+        }
+        in.skip(avail);
     }
 }
 
-static bool readValue(ppl7::AssocArray& data, const ppl7::String& key, ppl7::FileObject& file, int c)
+static void readDict(JsonReader& in, JsonEventHandler& handler, ppl7::String& buffer);
+static void readArray(JsonReader& in, JsonEventHandler& handler, ppl7::String& buffer);
+
+/*
+ * Reads the value starting with the already consumed character c and passes it
+ * to the handler. The buffer is only used as scratch space for strings and
+ * numbers, so one buffer serves the whole document.
+ */
+static bool readValue(JsonReader& in, JsonEventHandler& handler, int c, ppl7::String& buffer)
 {
     if (c == '"') {
-        ppl7::String value = getString(file);
-        data.set(key, value);
+        getString(buffer, in);
+        handler.value(buffer, JsonEventHandler::TYPE_STRING);
         return true;
     } else if (c == '[') { // Array
-        ppl7::AssocArray value;
-        readArray(value, file);
-        data.set(key, value);
+        handler.startArray();
+        readArray(in, handler, buffer);
+        handler.endArray();
         return true;
     } else if (c == '{') { // dict
-        ppl7::AssocArray value;
-        readDict(value, file);
-        data.set(key, value);
+        handler.startObject();
+        readDict(in, handler, buffer);
+        handler.endObject();
         return true;
     } else if (c == '-' || (c >= '0' && c <= '9')) {
-        file.seek(-1, ppl7::File::SEEKCUR);
-        ppl7::String value = getNumber(file);
-        data.set(key, value);
+        in.unget();
+        getNumber(buffer, in);
+        handler.value(buffer, JsonEventHandler::TYPE_NUMBER);
         return true;
     } else if (c == 't') { // true
-        file.seek(-1, ppl7::File::SEEKCUR);
-        readChars(file, "true");
-        data.set(key, ppl7::String("true"));
+        in.unget();
+        readChars(in, "true");
+        buffer.set("true", 4);
+        handler.value(buffer, JsonEventHandler::TYPE_BOOLEAN);
         return true;
     } else if (c == 'f') { // false
-        file.seek(-1, ppl7::File::SEEKCUR);
-        readChars(file, "false");
-        data.set(key, ppl7::String("false"));
+        in.unget();
+        readChars(in, "false");
+        buffer.set("false", 5);
+        handler.value(buffer, JsonEventHandler::TYPE_BOOLEAN);
         return true;
     } else if (c == 'n') { // null
-        file.seek(-1, ppl7::File::SEEKCUR);
-        readChars(file, "null");
-        data.set(key, ppl7::String("null"));
+        in.unget();
+        readChars(in, "null");
+        buffer.set("null", 4);
+        handler.value(buffer, JsonEventHandler::TYPE_NULL);
         return true;
     }
     return false;
 }
 
-static void readArray(ppl7::AssocArray& data, ppl7::FileObject& file)
+static void readArray(JsonReader& in, JsonEventHandler& handler, ppl7::String& buffer)
 {
     int c;
     ParserState::state state = ParserState::ExpectingValue;
-    while (!file.eof()) {
-        c = file.fgetc();
+    while ((c = in.getc()) != EOF) {
         if (c == ' ' || c == '\n' || c == '\r' || c == '\t') continue;
-        if (state == ParserState::ExpectingValue && readValue(data, "[]", file, c) == true) {
+        if (state == ParserState::ExpectingValue && readValue(in, handler, c, buffer) == true) {
             state = ParserState::ExpectingNextOrEnd;
         } else if (c == ',' && state == ParserState::ExpectingNextOrEnd) {
             state = ParserState::ExpectingValue;
         } else if (c == ']' && (state == ParserState::ExpectingValue || state == ParserState::ExpectingNextOrEnd)) {
             return;
         } else {
-            throw ppl7::UnexpectedCharacterException("#2: >>%c<< at position %lld while parsing array", c, file.tell());
+            throw ppl7::UnexpectedCharacterException("#2: >>%c<< at position %lld while parsing array", c, in.tell());
         }
     }
     throw ppl7::UnexpectedEndOfDataException();
 }
 
-static void readDict(ppl7::AssocArray& data, ppl7::FileObject& file)
+static void readDict(JsonReader& in, JsonEventHandler& handler, ppl7::String& buffer)
 {
     int c;
-    ppl7::String key;
     ParserState::state state = ParserState::ExpectingKey;
-    while (!file.eof()) {
-        c = file.fgetc();
-        if (c == EOF) break;
+    while ((c = in.getc()) != EOF) {
         if (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == 0) continue;
         if (c == '"' && state == ParserState::ExpectingKey) {
-            key = getString(file);
-            if (key.isEmpty()) key = "_empty_";
+            getString(buffer, in);
+            handler.key(buffer);
             state = ParserState::ExpectingColon;
         } else if (c == ':' && state == ParserState::ExpectingColon) {
             state = ParserState::ExpectingValue;
         } else if (c == ',' && state == ParserState::ExpectingNextOrEnd) {
             state = ParserState::ExpectingKey;
         } else if (state == ParserState::ExpectingValue) {
-            if (readValue(data, key, file, c) == true) {
+            if (readValue(in, handler, c, buffer) == true) {
                 state = ParserState::ExpectingNextOrEnd;
             } else {
                 throw ppl7::UnexpectedCharacterException(
-                    "#3: >>%c<< at position %lld while parsing dict (expecting value), state ExpectingValue", c, file.tell());
+                    "#3: >>%c<< at position %lld while parsing dict (expecting value), state ExpectingValue", c, in.tell());
             }
         } else if (c == '}' && (state == ParserState::ExpectingNextOrEnd || state == ParserState::ExpectingKey)) {
             return;
         } else if (c == '/' && (state == ParserState::ExpectingKey || state == ParserState::ExpectingNextOrEnd)) {
-            int c2 = file.fgetc();
+            int c2 = in.getc();
             if (c2 == '/') {
-                skipToEOL(file);
+                skipToEOL(in);
             } else {
-                file.seek(-1, ppl7::File::SEEKCUR);
-                throw ppl7::UnexpectedCharacterException(">>%c<< at position %lld while parsing dict (slash), state %d", c, file.tell(),
+                if (c2 != EOF) in.unget();
+                throw ppl7::UnexpectedCharacterException(">>%c<< at position %lld while parsing dict (slash), state %d", c, in.tell(),
                                                          state);
             }
         } else {
             throw ppl7::UnexpectedCharacterException("#4: >>%c<< (ASCII %d) at position %lld while parsing dict (general), state %d", c, c,
-                                                     file.tell(), state);
+                                                     in.tell(), state);
         }
     }
     throw ppl7::UnexpectedEndOfDataException();
 }
 
-static void expectEof(ppl7::FileObject& file)
+/*
+ * Reads the dict or array at the top level of a document. Returns false, if
+ * there is nothing but whitespace until the end of data.
+ */
+static bool readDocument(JsonReader& in, JsonEventHandler& handler)
 {
     int c;
-    while (!file.eof()) {
-        c = file.fgetc();
-        if (c == EOF) return;
-        if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && c != 0) {
-            throw ppl7::UnexpectedCharacterException("#5: >>%c<< at position %lld while parsing dict 2", c, file.tell());
+    ppl7::String buffer;
+    while ((c = in.getc()) != EOF) {
+        if (c == '{' || c == '[') {
+            readValue(in, handler, c, buffer);
+            return true;
+        } else if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            throw ppl7::UnexpectedCharacterException("#6: >>%c<< at position %lld while parsing dict 1", c, in.tell());
         }
     }
+    return false;
 }
 
-void Json::loads(ppl7::AssocArray& data, const ppl7::String& json)
+static void expectEof(JsonReader& in)
 {
-    ppl7::MemFile file((void*)json.getPtr(), json.size());
-    Json::load(data, file);
+    int c;
+    while ((c = in.getc()) != EOF) {
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && c != 0) {
+            throw ppl7::UnexpectedCharacterException("#5: >>%c<< at position %lld while parsing dict 2", c, in.tell());
+        }
+    }
 }
 
-void Json::load(ppl7::AssocArray& data, ppl7::FileObject& file)
+static void expectEol(JsonReader& in)
 {
     int c;
-    while (!file.eof()) {
-        c = file.fgetc();
-        if (c == '{') {
-            readDict(data, file);
-            expectEof(file);
-            return;
-        } else if (c == '[') {
-            readArray(data, file);
-            expectEof(file);
-            return;
-        } else if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
-            throw ppl7::UnexpectedCharacterException("#6: >>%c<< at position %lld while parsing dict 1", c, file.tell());
+    while ((c = in.getc()) != EOF) {
+        if (c == '\n') return;
+        if (c != ' ' && c != '\r' && c != '\t' && c != 0) {
+            throw ppl7::UnexpectedCharacterException("#7: >>%c<< at position %lld after end of record", c, in.tell());
+        }
+    }
+}
+
+static void parseDocument(JsonReader& in, JsonEventHandler& handler)
+{
+    if (readDocument(in, handler)) expectEof(in);
+}
+
+/*
+ * Builds an AssocArray from the parser events. Nested dicts and arrays are
+ * created directly inside of their parent, so the subtree doesn't need to be
+ * copied afterwards. Keys containing "[]" can not be looked up again, those
+ * containers are built in a temporary AssocArray, which is copied at the end.
+ */
+class AssocArrayBuilder : public JsonEventHandler
+{
+private:
+    struct Node
+    {
+        ppl7::AssocArray* data;
+        ppl7::AssocArray* temp;
+        ppl7::String key;
+        uint64_t index;
+        bool isArray;
+    };
+    ppl7::AssocArray& root;
+    std::list<Node> stack;
+    ppl7::String currentKey;
+
+    void setKey();
+    void push(bool isArray);
+    void pop();
+
+public:
+    AssocArrayBuilder(ppl7::AssocArray& root);
+    ~AssocArrayBuilder();
+    virtual void startObject();
+    virtual void endObject();
+    virtual void startArray();
+    virtual void endArray();
+    virtual void key(const ppl7::String& name);
+    virtual void value(const ppl7::String& value, ValueType type);
+};
+
+AssocArrayBuilder::AssocArrayBuilder(ppl7::AssocArray& root)
+    : root(root)
+{
+}
+
+AssocArrayBuilder::~AssocArrayBuilder()
+{
+    std::list<Node>::iterator it;
+    for (it = stack.begin(); it != stack.end(); ++it) delete (*it).temp;
+}
+
+void AssocArrayBuilder::setKey()
+{
+    Node& parent = stack.back();
+    if (parent.isArray) {
+        currentKey.setf("%llu", (unsigned long long)parent.index);
+        parent.index++;
+    }
+}
+
+void AssocArrayBuilder::push(bool isArray)
+{
+    Node node;
+    node.temp = NULL;
+    node.index = 0;
+    node.isArray = isArray;
+    if (stack.empty()) {
+        // A list at the top level is appended to existing elements
+        if (isArray && root.size() > 0) {
+            node.temp = new ppl7::AssocArray();
+            node.data = node.temp;
+        } else {
+            node.data = &root;
+        }
+    } else {
+        setKey();
+        node.key = currentKey;
+        ppl7::AssocArray& parent = *stack.back().data;
+        if (currentKey.has("[]")) {
+            node.temp = new ppl7::AssocArray();
+            node.data = node.temp;
+        } else {
+            parent.set(currentKey, ppl7::AssocArray());
+            node.data = &parent.getAssocArray(currentKey);
+        }
+    }
+    stack.push_back(node);
+}
+
+void AssocArrayBuilder::pop()
+{
+    Node& node = stack.back();
+    if (node.temp) {
+        if (stack.size() == 1) {
+            ppl7::AssocArray::const_iterator it;
+            for (it = node.temp->begin(); it != node.temp->end(); ++it) root.set("[]", *(*it).second);
+        } else {
+            std::list<Node>::iterator parent = stack.end();
+            --parent;
+            --parent;
+            (*parent).data->set(node.key, *node.temp);
         }
+        delete node.temp;
     }
+    stack.pop_back();
+}
+
+void AssocArrayBuilder::startObject()
+{
+    push(false);
+}
+
+void AssocArrayBuilder::endObject()
+{
+    pop();
+}
+
+void AssocArrayBuilder::startArray()
+{
+    push(true);
+}
+
+void AssocArrayBuilder::endArray()
+{
+    pop();
+}
+
+void AssocArrayBuilder::key(const ppl7::String& name)
+{
+    if (name.isEmpty()) currentKey.set("_empty_", 7);
+    else currentKey = name;
+}
+
+void AssocArrayBuilder::value(const ppl7::String& value, ValueType)
+{
+    setKey();
+    stack.back().data->set(currentKey, value);
+}
+
+/*!\class JsonEventHandler
+ * \brief Empfänger für die Ereignisse des JSON-Parsers
+ *
+ * \desc
+ * Mit Json::parse kann ein JSON-Dokument gelesen werden, ohne dass es komplett in einem
+ * AssocArray abgelegt wird. Stattdessen ruft der Parser für jedes Element die
+ * entsprechende Funktion dieser Klasse auf. Dadurch lassen sich auch sehr große Dokumente
+ * mit konstantem Speicherverbrauch filtern oder auswerten.
+ *
+ * Die Standardimplementierungen der Funktionen tun nichts, so dass eine abgeleitete Klasse
+ * nur die Funktionen überschreiben muss, die sie benötigt. Die an \a key und \a value
+ * übergebenen Strings sind nur während des Aufrufs gültig und müssen bei Bedarf kopiert
+ * werden.
+ */
+
+JsonEventHandler::~JsonEventHandler()
+{
+}
+
+void JsonEventHandler::startObject()
+{
+}
+
+void JsonEventHandler::endObject()
+{
+}
+
+void JsonEventHandler::startArray()
+{
+}
+
+void JsonEventHandler::endArray()
+{
+}
+
+void JsonEventHandler::key(const ppl7::String&)
+{
+}
+
+void JsonEventHandler::value(const ppl7::String&, ValueType)
+{
+}
+
+/*!\brief JSON-String parsen
+ *
+ * \desc
+ * Parst den JSON-String \p json und speichert das Ergebnis in \p data. Der String
+ * wird direkt im Speicher gelesen, ohne ihn zu kopieren.
+ */
+void Json::loads(ppl7::AssocArray& data, const ppl7::String& json)
+{
+    JsonReader in(json.getPtr(), json.size());
+    AssocArrayBuilder builder(data);
+    parseDocument(in, builder);
+}
+
+/*!\brief JSON aus einem Speicherbereich parsen
+ *
+ * \desc
+ * Parst das JSON-Dokument im Speicherbereich \p json und speichert das Ergebnis in
+ * \p data. Der Speicher wird direkt gelesen und nicht kopiert, so dass sich auch
+ * große Dateien effizient laden lassen, indem sie mit FileObject::map in den
+ * Speicher gemapped werden.
+ */
+void Json::loads(ppl7::AssocArray& data, const ppl7::ByteArrayPtr& json)
+{
+    JsonReader in((const char*)json.ptr(), json.size());
+    AssocArrayBuilder builder(data);
+    parseDocument(in, builder);
+}
+
+/*!\brief JSON aus einer Datei parsen
+ *
+ * \desc
+ * Liest ab der aktuellen Position ein JSON-Dokument aus \p file und speichert das
+ * Ergebnis in \p data. Die Datei wird blockweise gelesen, nach dem Aufruf steht der
+ * Dateizeiger daher am Ende der Datei.
+ */
+void Json::load(ppl7::AssocArray& data, ppl7::FileObject& file)
+{
+    JsonReader in(file);
+    AssocArrayBuilder builder(data);
+    parseDocument(in, builder);
+}
+
+/*!\brief JSON-String ereignisbasiert parsen
+ *
+ * \desc
+ * Parst den JSON-String \p json und ruft für jedes gefundene Element die entsprechende
+ * Funktion von \p handler auf.
+ */
+void Json::parse(JsonEventHandler& handler, const ppl7::String& json)
+{
+    JsonReader in(json.getPtr(), json.size());
+    parseDocument(in, handler);
+}
+
+void Json::parse(JsonEventHandler& handler, const ppl7::ByteArrayPtr& json)
+{
+    JsonReader in((const char*)json.ptr(), json.size());
+    parseDocument(in, handler);
+}
+
+/*!\brief JSON-Datei ereignisbasiert parsen
+ *
+ * \desc
+ * Liest ab der aktuellen Position ein JSON-Dokument blockweise aus \p file und ruft für
+ * jedes gefundene Element die entsprechende Funktion von \p handler auf. Das Dokument
+ * wird dabei nicht im Speicher gehalten.
+ */
+void Json::parse(JsonEventHandler& handler, ppl7::FileObject& file)
+{
+    JsonReader in(file);
+    parseDocument(in, handler);
+}
+
+/*!\class JsonLineReader
+ * \brief Datensätze aus einer Datei im NDJSON-Format lesen
+ *
+ * \desc
+ * Liest Dateien, in denen jede Zeile ein eigenständiges JSON-Dokument enthält
+ * ("newline delimited JSON"). Die Datei wird blockweise gelesen, wobei immer nur der
+ * aktuelle Datensatz im Speicher gehalten wird. Leere Zeilen werden übersprungen.
+ *
+ * \example
+ * \code
+ppl7::File file("export.ndjson");
+ppl7::JsonLineReader reader(file);
+ppl7::AssocArray record;
+while (reader.next(record)) {
+    printf("%s\n", (const char*)record.getString("id"));
+}
+ * \endcode
+ */
+
+JsonLineReader::JsonLineReader(ppl7::FileObject& file)
+{
+    reader = new JsonReader(file);
+    records = 0;
+}
+
+JsonLineReader::~JsonLineReader()
+{
+    delete reader;
+}
+
+/*!\brief Nächsten Datensatz lesen
+ *
+ * \desc
+ * Liest den nächsten Datensatz und speichert ihn in \p data. Der vorherige Inhalt von
+ * \p data wird vorher gelöscht.
+ *
+ * @return Gibt \c true zurück, wenn ein Datensatz gelesen wurde, \c false am Ende der Datei
+ * @exception UnexpectedCharacterException Der Datensatz ist kein gültiges JSON oder
+ * es folgen weitere Daten in der gleichen Zeile
+ */
+bool JsonLineReader::next(ppl7::AssocArray& data)
+{
+    data.clear();
+    AssocArrayBuilder builder(data);
+    return next(builder);
+}
+
+/*!\brief Nächsten Datensatz ereignisbasiert lesen
+ *
+ * \desc
+ * Liest den nächsten Datensatz und ruft für jedes darin gefundene Element die
+ * entsprechende Funktion von \p handler auf.
+ *
+ * @return Gibt \c true zurück, wenn ein Datensatz gelesen wurde, \c false am Ende der Datei
+ */
+bool JsonLineReader::next(JsonEventHandler& handler)
+{
+    if (!readDocument(*reader, handler)) return false;
+    expectEol(*reader);
+    records++;
+    return true;
+}
+
+/*!\brief Anzahl bisher gelesener Datensätze
+ */
+uint64_t JsonLineReader::count() const
+{
+    return records;
 }
 
 ppl7::AssocArray Json::loads(const ppl7::String& json)
@@ -318,6 +829,13 @@ ppl7::AssocArray Json::loads(const ppl7::String& json)
     return result;
 }
 
+ppl7::AssocArray Json::loads(const ppl7::ByteArrayPtr& json)
+{
+    ppl7::AssocArray result;
+    Json::loads(result, json);
+    return result;
+}
+
 ppl7::AssocArray Json::load(ppl7::FileObject& file)
 {
     ppl7::AssocArray result;
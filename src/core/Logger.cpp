@@ -54,6 +54,13 @@
 #include <stdarg.h>
 #endif
 
+#ifdef HAVE_LIMITS_H
+#include <limits.h>
+#endif
+
+#include <atomic>
+#include <thread>
+
 #include "ppl7.h"
 
 
@@ -66,6 +73,30 @@ typedef struct tagLOGHANDLER
 	struct tagLOGHANDLER* previous;
 } LOGHANDLER;
 
+/*
+ * Filter
+ *
+ * Damit eine unterdrückte Meldung nur wenige Nanosekunden kostet, wird die Entscheidung pro
+ * Aufrufstelle in einem thread-lokalen Cache abgelegt. Schlüssel sind die Adressen von module,
+ * function und file sowie die Zeilennummer; es wird also davon ausgegangen, dass es sich dabei
+ * wie bei __FILE__ und __FUNCTION__ um konstante Strings handelt. Jede Änderung an den Filtern
+ * vergibt eine neue, programmweit eindeutige Generationsnummer, wodurch alle Cache-Einträge
+ * ungültig werden.
+ */
+#define FILTERCACHE_SIZE 256
+
+typedef struct tagFILTERCACHE {
+	uint64_t generation;
+	const char* module;
+	const char* function;
+	const char* file;
+	int line;
+	int threshold;
+} FILTERCACHE;
+
+static std::atomic<uint64_t> filter_generation_counter(0);
+static thread_local FILTERCACHE filtercache[FILTERCACHE_SIZE];
+
 
 static const char* prioritylist[] ={
 	"NONE   ",						// 0
@@ -135,10 +166,232 @@ static const int syslog_priority_lookup[] ={
 
 #endif
 
+/*
+ * Ringpuffer und Schreib-Thread für den asynchronen Modus (siehe Logger::enableAsync).
+ * Die Nachrichten werden in einem Ringpuffer mit fester Anzahl Einträge abgelegt, in den
+ * beliebig viele Threads ohne Lock schreiben können. Jeder Eintrag hat eine Sequenznummer,
+ * über die Schreiber und Leser feststellen, ob er frei bzw. fertig beschrieben ist. Die
+ * Strings in den Einträgen behalten ihren Speicher, so dass nach dem Aufwärmen beim
+ * Einreihen in der Regel kein malloc mehr anfällt.
+ *
+ * Der Schreib-Thread holt alle fertigen Einträge auf einmal ab, schreibt sie unter dem Mutex
+ * des Loggers und führt das flush der Logdateien nur einmal pro Durchgang aus.
+ */
+/*
+ * Zustand, der ohne Mutex von mehreren Threads gelesen wird. Er liegt nicht direkt in der
+ * Klasse, damit ppl7.h nicht von <atomic> abhängt.
+ */
+class Logger::State
+{
+public:
+	std::atomic<uint64_t> filtergeneration;
+	std::atomic<bool> filteractive;
+	std::atomic<AsyncQueue*> asyncqueue;
+	std::atomic<int> asyncusers;
+};
+
+class Logger::AsyncQueue : public Thread
+{
+public:
+	class Record
+	{
+	public:
+		std::atomic<size_t> sequence;
+		PRIORITY prio;
+		int level;
+		int line;
+		bool printdate;
+		bool hasModule, hasFunction, hasFile;
+		uint64_t threadid;
+		double time;
+		String module, function, file, text;
+	};
+
+	Logger* logger;
+	Record* records;
+	size_t capacity;
+	size_t mask;
+	OVERFLOW_POLICY policy;
+	std::atomic<size_t> tail;
+	std::atomic<size_t> processed;
+	std::atomic<uint64_t> dropped;
+	std::atomic<bool> sleeping;
+	std::atomic<bool> stopflag;
+	std::atomic<uint64_t> writerid;
+	uint64_t reported;
+	size_t head;
+	Mutex wakemutex;
+	time_t lastsecond;
+	String lastdate;
+
+	AsyncQueue(Logger* logger, size_t capacity, OVERFLOW_POLICY policy);
+	~AsyncQueue();
+	bool push(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& text, bool printdate);
+	void wakeup();
+	void waitEmpty();
+	size_t drain();
+	void run();
+};
+
+Logger::AsyncQueue::AsyncQueue(Logger* logger, size_t capacity, OVERFLOW_POLICY policy)
+	: tail(0), processed(0), dropped(0), sleeping(false), stopflag(false), writerid(0)
+{
+	size_t c=16;
+	while (c < capacity) c<<=1;
+	this->logger=logger;
+	this->capacity=c;
+	this->mask=c - 1;
+	this->policy=policy;
+	reported=0;
+	head=0;
+	lastsecond=0;
+	records=new Record[c];
+	for (size_t i=0;i < c;i++) {
+		records[i].sequence.store(i, std::memory_order_relaxed);
+		records[i].text.reserve(255);
+	}
+}
+
+Logger::AsyncQueue::~AsyncQueue()
+{
+	delete[] records;
+}
+
+bool Logger::AsyncQueue::push(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& text, bool printdate)
+{
+	double now=printdate ? GetMicrotime() : 0.0;
+	size_t pos=tail.load(std::memory_order_relaxed);
+	Record* r;
+	while (1) {
+		r=&records[pos & mask];
+		size_t seq=r->sequence.load(std::memory_order_acquire);
+		intptr_t diff=(intptr_t)seq - (intptr_t)pos;
+		if (diff == 0) {
+			if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		} else if (diff < 0) {
+			// Puffer ist voll
+			if (policy != OVERFLOW_BLOCK) {
+				dropped++;
+				return false;
+			}
+			wakeup();
+			std::this_thread::yield();
+			pos=tail.load(std::memory_order_relaxed);
+		} else {
+			pos=tail.load(std::memory_order_relaxed);
+		}
+	}
+	r->prio=prio;
+	r->level=level;
+	r->line=line;
+	r->printdate=printdate;
+	r->threadid=ThreadID();
+	r->time=now;
+	r->hasModule=(module != NULL);
+	r->hasFunction=(function != NULL);
+	r->hasFile=(file != NULL);
+	if (module) r->module.set(module);
+	if (function) r->function.set(function);
+	if (file) r->file.set(file);
+	r->text.set(text);
+	r->sequence.store(pos + 1);
+	if (sleeping) wakeup();
+	return true;
+}
+
+void Logger::AsyncQueue::wakeup()
+{
+	wakemutex.lock();
+	wakemutex.signal();
+	wakemutex.unlock();
+}
+
+void Logger::AsyncQueue::waitEmpty()
+{
+	size_t target=tail.load();
+	while (processed.load() < target) {
+		wakeup();
+		std::this_thread::yield();
+	}
+}
+
+size_t Logger::AsyncQueue::drain()
+{
+	Record* r=&records[head & mask];
+	if (r->sequence.load(std::memory_order_acquire) != head + 1) return 0;
+	size_t count=0;
+	String date;
+	logger->mutex.lock();
+	while (count < capacity) {
+		r=&records[head & mask];
+		if (r->sequence.load(std::memory_order_acquire) != head + 1) break;
+		if (r->printdate) {
+			time_t second=(time_t)r->time;
+			if (second != lastsecond) {
+				DateTime d;
+				d.setEpoch((uint64_t)second);
+				lastdate=d.get("%Y-%m-%d %H:%M:%S");
+				lastsecond=second;
+			}
+			date.setf("%s.%03i", (const char*)lastdate, (int)((r->time - (double)second) * 1000.0));
+		}
+		try {
+			logger->writeMessage(r->prio, r->level,
+				r->hasModule ? (const char*)r->module : NULL,
+				r->hasFunction ? (const char*)r->function : NULL,
+				r->hasFile ? (const char*)r->file : NULL,
+				r->line, r->text, r->printdate, date, r->threadid, false);
+		} catch (...) {
+		}
+		r->sequence.store(head + capacity, std::memory_order_release);
+		head++;
+		count++;
+	}
+	uint64_t d=dropped.load();
+	if (policy == OVERFLOW_COUNT && d != reported) {
+		String msg;
+		msg.setf("=== %llu messages dropped, log buffer full", (unsigned long long)(d - reported));
+		reported=d;
+		try {
+			logger->output(Logger::WARNING, 0, "ppl7::Logger", "AsyncQueue", __FILE__, __LINE__, msg);
+		} catch (...) {
+		}
+	}
+	for (int i=1;i < NUMFACILITIES;i++) {
+		try {
+			if (logger->logff[i].isOpen()) {
+				logger->logff[i].flush();
+				logger->checkRotate((PRIORITY)i);
+			}
+		} catch (...) {
+		}
+	}
+	logger->mutex.unlock();
+	processed.store(head);
+	return count;
+}
+
+void Logger::AsyncQueue::run()
+{
+	writerid=ThreadID();
+	while (1) {
+		if (drain()) continue;
+		if (stopflag) break;
+		wakemutex.lock();
+		sleeping=true;
+		Record* r=&records[head & mask];
+		if (r->sequence.load() != head + 1 && !stopflag) wakemutex.wait(100);
+		sleeping=false;
+		wakemutex.unlock();
+	}
+	drain();
+}
+
 
 
 Logger::Logger()
 {
+	state=new State;
 	firsthandler=lasthandler=NULL;
 	logconsole=false;
 	logThreadId=true;
@@ -150,12 +403,16 @@ Logger::Logger()
 	}
 	FilterModule=NULL;
 	FilterFile=NULL;
+	state->filtergeneration=++filter_generation_counter;
+	state->filteractive=false;
 	rotate_mechanism=0;
 	maxsize=1024 * 1024 * 1024;
 	generations=1;
 	inrotate=false;
 	useSyslog=false;
 	syslogFacility=SYSLOG_USER;
+	state->asyncqueue=NULL;
+	state->asyncusers=0;
 }
 
 Logger::~Logger()
@@ -163,11 +420,13 @@ Logger::~Logger()
 	terminate();
 	if (FilterModule) delete FilterModule;
 	if (FilterFile) delete FilterFile;
+	delete state;
 }
 
 void Logger::terminate()
 {
 	print(Logger::INFO, 0, "ppl7::Logger", "terminate", __FILE__, __LINE__, "=== Logfile-Class terminated ===============================");
+	disableAsync();
 	for (int i=0;i < NUMFACILITIES;i++) {
 		logff[i].close();
 	}
@@ -235,6 +494,91 @@ void Logger::closeSyslog()
 }
 
 
+/*!\brief Asynchrones Logging aktivieren
+ *
+ * \desc
+ * Die Nachrichten werden nicht mehr im aufrufenden Thread geschrieben, sondern ohne Lock in
+ * einen Ringpuffer mit \p capacity Einträgen gestellt. Ein eigener Thread schreibt sie
+ * gesammelt in die Logdateien, an Syslog und an die LogHandler; diese werden daher aus
+ * diesem Thread aufgerufen. Ist der Puffer voll, wartet der Aufrufer bei OVERFLOW_BLOCK, bis
+ * wieder Platz ist. Bei OVERFLOW_DROP wird die Nachricht verworfen, bei OVERFLOW_COUNT
+ * ebenfalls, es wird aber anschließend eine Warnung mit der Anzahl verworfener Nachrichten
+ * geloggt. Mit Logger::flush kann gewartet werden, bis alle Nachrichten geschrieben sind.
+ *
+ * \note Der Modus kann auch umgeschaltet werden, während andere Threads loggen. Mehrzeilige
+ * Ausgaben wie Logger::printArray oder Logger::hexDump werden als eine Nachricht eingereiht.
+ */
+void Logger::enableAsync(size_t capacity, OVERFLOW_POLICY policy)
+{
+	disableAsync();
+	AsyncQueue* q=new AsyncQueue(this, capacity, policy);
+	try {
+		q->threadStart();
+	} catch (...) {
+		delete q;
+		throw;
+	}
+	while (q->writerid == 0) std::this_thread::yield();
+	mutex.lock();
+	state->asyncqueue=q;
+	mutex.unlock();
+}
+
+void Logger::disableAsync()
+{
+	mutex.lock();
+	AsyncQueue* q=state->asyncqueue.exchange(NULL);
+	mutex.unlock();
+	if (!q) return;
+	// Threads, die die Queue noch vor dem Umschalten geholt haben, dürfen ihre Nachricht
+	// noch einstellen, erst danach wird die Queue geleert und gelöscht.
+	while (state->asyncusers.load() != 0) std::this_thread::yield();
+	q->waitEmpty();
+	q->stopflag=true;
+	q->wakeup();
+	q->threadStop();
+	delete q;
+}
+
+/*
+ * Liefert die Queue, falls asynchrones Logging aktiv ist, und verhindert, dass sie bis zum
+ * Aufruf von releaseQueue gelöscht wird. Bei NULL darf releaseQueue nicht aufgerufen werden.
+ */
+Logger::AsyncQueue* Logger::acquireQueue() const
+{
+	state->asyncusers++;
+	AsyncQueue* q=state->asyncqueue.load();
+	if (!q) state->asyncusers--;
+	return q;
+}
+
+void Logger::releaseQueue() const
+{
+	state->asyncusers--;
+}
+
+bool Logger::isAsync() const
+{
+	return state->asyncqueue.load() != NULL;
+}
+
+void Logger::flush()
+{
+	AsyncQueue* q=acquireQueue();
+	if (!q) return;
+	q->waitEmpty();
+	releaseQueue();
+}
+
+uint64_t Logger::droppedMessages() const
+{
+	AsyncQueue* q=acquireQueue();
+	if (!q) return 0;
+	uint64_t dropped=q->dropped;
+	releaseQueue();
+	return dropped;
+}
+
 void Logger::setLogfile(PRIORITY prio, const String& filename)
 {
 	if (prio < 1 || prio >= NUMFACILITIES) return;
@@ -319,41 +663,31 @@ String Logger::getLogfile(PRIORITY prio)
 void Logger::print(const String& text)
 {
 	if (!shouldPrint(NULL, NULL, NULL, 0, Logger::DEBUG, 0)) return;
-	mutex.lock();
-	output(Logger::DEBUG, 0, NULL, NULL, NULL, 0, text, true);
-	mutex.unlock();
+	emit(Logger::DEBUG, 0, NULL, NULL, NULL, 0, text, true);
 }
 
 void Logger::print(int level, const String& text)
 {
 	if (!shouldPrint(NULL, NULL, NULL, 0, Logger::DEBUG, level)) return;
-	mutex.lock();
-	output(Logger::DEBUG, level, NULL, NULL, NULL, 0, text, true);
-	mutex.unlock();
+	emit(Logger::DEBUG, level, NULL, NULL, NULL, 0, text, true);
 }
 
 void Logger::print(PRIORITY prio, int level, const String& text)
 {
 	if (!shouldPrint(NULL, NULL, NULL, 0, prio, level)) return;
-	mutex.lock();
-	output(prio, level, NULL, NULL, NULL, 0, text, true);
-	mutex.unlock();
+	emit(prio, level, NULL, NULL, NULL, 0, text, true);
 }
 
 void Logger::print(PRIORITY prio, int level, const char* file, int line, const String& text)
 {
 	if (!shouldPrint(NULL, NULL, file, line, prio, level)) return;
-	mutex.lock();
-	output(prio, level, NULL, NULL, file, line, text, true);
-	mutex.unlock();
+	emit(prio, level, NULL, NULL, file, line, text, true);
 }
 
 void Logger::print(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& text)
 {
 	if (!shouldPrint(module, function, file, line, prio, level)) return;
-	mutex.lock();
-	output(prio, level, module, function, file, line, text, true);
-	mutex.unlock();
+	emit(prio, level, module, function, file, line, text, true);
 }
 
 void Logger::printf(const String& text, ...)
@@ -365,9 +699,7 @@ void Logger::printf(const String& text, ...)
 	out.vasprintf(text, args);
 	va_end(args);
 
-	mutex.lock();
-	output(Logger::DEBUG, 0, NULL, NULL, NULL, 0, out, true);
-	mutex.unlock();
+	emit(Logger::DEBUG, 0, NULL, NULL, NULL, 0, out, true);
 }
 
 void Logger::printf(int level, const String& text, ...)
@@ -379,9 +711,7 @@ void Logger::printf(int level, const String& text, ...)
 	out.vasprintf(text, args);
 	va_end(args);
 
-	mutex.lock();
-	output(Logger::DEBUG, level, NULL, NULL, NULL, 0, out, true);
-	mutex.unlock();
+	emit(Logger::DEBUG, level, NULL, NULL, NULL, 0, out, true);
 }
 
 void Logger::printf(PRIORITY prio, int level, const String& text, ...)
@@ -393,9 +723,7 @@ void Logger::printf(PRIORITY prio, int level, const String& text, ...)
 	out.vasprintf(text, args);
 	va_end(args);
 
-	mutex.lock();
-	output(prio, level, NULL, NULL, NULL, 0, out, true);
-	mutex.unlock();
+	emit(prio, level, NULL, NULL, NULL, 0, out, true);
 }
 
 void Logger::printf(PRIORITY prio, int level, const char* file, int line, const String& text, ...)
@@ -407,9 +735,7 @@ void Logger::printf(PRIORITY prio, int level, const char* file, int line, const
 	out.vasprintf(text, args);
 	va_end(args);
 
-	mutex.lock();
-	output(prio, level, NULL, NULL, file, line, out, true);
-	mutex.unlock();
+	emit(prio, level, NULL, NULL, file, line, out, true);
 }
 
 void Logger::printf(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& text, ...)
@@ -421,42 +747,48 @@ void Logger::printf(PRIORITY prio, int level, const char* module, const char* fu
 	out.vasprintf(text, args);
 	va_end(args);
 
-	mutex.lock();
-	output(prio, level, module, function, file, line, out, true);
-	mutex.unlock();
+	emit(prio, level, module, function, file, line, out, true);
 }
 
 
 
 void Logger::printArray(PRIORITY prio, int level, const AssocArray& a, const String& text)
 {
-	if (!shouldPrint(NULL, NULL, NULL, 0, prio, level)) return;
-	mutex.lock();
-	output(prio, level, NULL, NULL, NULL, 0, text, true);
-	outputArray(prio, level, NULL, NULL, NULL, 0, a, NULL);
-	mutex.unlock();
+	printArray(prio, level, NULL, NULL, NULL, 0, a, text);
 }
 
 void Logger::printArray(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const AssocArray& a, const String& text)
 {
 	if (!shouldPrint(module, function, file, line, prio, level)) return;
+	if (isAsync()) {
+		// Im asynchronen Modus als eine Nachricht, damit die Zeilen nicht mit denen anderer
+		// Threads vermischt werden
+		String s;
+		s=text;
+		s.append("\n");
+		outputArray(prio, level, module, function, file, line, a, NULL, &s);
+		if (emitAsync(prio, level, module, function, file, line, s, true)) return;
+	}
 	mutex.lock();
-	output(prio, level, module, function, file, line, text, true);
-	outputArray(prio, level, module, function, file, line, a, NULL);
+	try {
+		output(prio, level, module, function, file, line, text, true);
+		outputArray(prio, level, module, function, file, line, a, NULL);
+	} catch (...) {
+		mutex.unlock();
+		throw;
+	}
 	mutex.unlock();
 }
 
 void Logger::printArraySingleLine(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const AssocArray& a, const String& text)
 {
 	if (!shouldPrint(module, function, file, line, prio, level)) return;
-	mutex.lock();
 	String s;
 	s=text;
 	outputArray(prio, level, module, function, file, line, a, NULL, &s);
 	s.replace("\n", "; ");
 	s.replace("    ", "");
-	output(prio, level, module, function, file, line, s, true);
-	mutex.unlock();
+	emit(prio, level, module, function, file, line, s, true);
 }
 
 void Logger::outputArray(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const AssocArray& a, const char* prefix, String* Out)
@@ -499,8 +831,8 @@ void Logger::hexDump(PRIORITY prio, int level, const void* address, int bytes)
 {
 	if (!shouldPrint(NULL, NULL, NULL, 0, prio, level)) return;
 	if (address == NULL) return;
-	mutex.lock();
 
+	std::list<String> lines;
 	String line;
 	String cleartext;
 
@@ -509,7 +841,7 @@ void Logger::hexDump(PRIORITY prio, int level, const void* address, int bytes)
 	//char buff[1024], tmp[10], cleartext[20];
 	line.setf("HEXDUMP: %u Bytes starting at Address 0x%08tX (%tu):",
 		bytes, (uintptr_t)address, (uintptr_t)address);
-	output(prio, level, NULL, NULL, NULL, 0, (const char*)line, true);
+	lines.push_back(line);
 
 	char* _adresse=(char*)address;
 	uint32_t spalte=0;
@@ -521,7 +853,7 @@ void Logger::hexDump(PRIORITY prio, int level, const void* address, int bytes)
 			line.chopRight(60);
 			line.append(": ");
 			line.append(cleartext);
-			output(prio, level, NULL, NULL, NULL, 0, (const char*)line, false);
+			lines.push_back(line);
 			line.setf("0x%08tX: ", (uintptr_t)(_adresse + i));
 			cleartext.clear();
 			spalte=0;
@@ -538,8 +870,28 @@ void Logger::hexDump(PRIORITY prio, int level, const void* address, int bytes)
 		line.chopRight(60);
 		line.append(": ");
 		line.append(cleartext);
-		output(prio, level, NULL, NULL, NULL, 0, (const char*)line, false);
-		output(prio, level, NULL, NULL, NULL, 0, "", false);
+		lines.push_back(line);
+		lines.push_back(String());
+	}
+	std::list<String>::const_iterator it;
+	if (isAsync()) {
+		// Im asynchronen Modus als eine Nachricht, damit die Zeilen nicht mit denen anderer
+		// Threads vermischt werden
+		String out;
+		for (it=lines.begin();it != lines.end();++it) {
+			if (it != lines.begin()) out.append("\n");
+			out.append(*it);
+		}
+		if (emitAsync(prio, level, NULL, NULL, NULL, 0, out, true)) return;
+	}
+	mutex.lock();
+	try {
+		for (it=lines.begin();it != lines.end();++it) {
+			output(prio, level, NULL, NULL, NULL, 0, *it, it == lines.begin());
+		}
+	} catch (...) {
+		mutex.unlock();
+		throw;
 	}
 	mutex.unlock();
 }
@@ -559,13 +911,55 @@ void Logger::printException(const char* file, int line, const char* module, cons
 	print(ERR, 1, module, function, file, line, e.toString());
 }
 
+/*
+ * Stellt die Nachricht in die Queue, falls asynchrones Logging aktiv ist. Liefert false
+ * zurück, wenn die Nachricht synchron geschrieben werden muss.
+ */
+bool Logger::emitAsync(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& buffer, bool printdate)
+{
+	AsyncQueue* q=acquireQueue();
+	if (!q) return false;
+	try {
+		q->push(prio, level, module, function, file, line, buffer, printdate);
+	} catch (...) {
+		releaseQueue();
+		throw;
+	}
+	releaseQueue();
+	return true;
+}
+
+void Logger::emit(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& buffer, bool printdate)
+{
+	if (emitAsync(prio, level, module, function, file, line, buffer, printdate)) return;
+	mutex.lock();
+	try {
+		output(prio, level, module, function, file, line, buffer, printdate);
+	} catch (...) {
+		mutex.unlock();
+		throw;
+	}
+	mutex.unlock();
+}
+
+/*
+ * Schreibt die Nachricht direkt, der Aufrufer muss den Mutex halten. Das gilt auch im
+ * asynchronen Modus, in dem output nur noch vom Schreib-Thread und aus Funktionen heraus
+ * aufgerufen wird, die den Mutex bereits halten.
+ */
 void Logger::output(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& buffer, bool printdate)
+{
+	String d;
+	if (printdate) d=DateTime::currentTime().get("%Y-%m-%d %H:%M:%S.%*");
+	writeMessage(prio, level, module, function, file, line, buffer, printdate, d, ThreadID(), true);
+}
+
+void Logger::writeMessage(PRIORITY prio, int level, const char* module, const char* function, const char* file, int line, const String& buffer, bool printdate, const String& date, uint64_t threadid, bool flush)
 {
 	String bf;
 	if (printdate) {
-		String d=DateTime::currentTime().get("%Y-%m-%d %H:%M:%S.%*");
-		if (logThreadId) bf.setf("%s [%7s %2i] [%6llu] ", (const char*)d, prioritylist[prio], level, ThreadID());
-		else bf.setf("%s [%7s %2i] ", (const char*)d, prioritylist[prio], level);
+		if (logThreadId) bf.setf("%s [%7s %2i] [%6llu] ", (const char*)date, prioritylist[prio], level, (unsigned long long)threadid);
+		else bf.setf("%s [%7s %2i] ", (const char*)date, prioritylist[prio], level);
 		bf.append("[");
 		if (file) bf.appendf("%s:%i", file, line);
 		bf.append("] {");
@@ -584,7 +978,7 @@ void Logger::output(PRIORITY prio, int level, const char* module, const char* fu
 #ifdef HAVE_SYSLOG_H
 	if (useSyslog) {
 		String log;
-		if (logThreadId) log.setf("[%2i] [%6llu]", level, ThreadID());
+		if (logThreadId) log.setf("[%2i] [%6llu]", level, (unsigned long long)threadid);
 		else log.setf("[%2i]", level);
 		syslog(syslog_priority_lookup[prio], "%s %s", (const char*)log, (const char*)bu);
 	}
@@ -592,16 +986,20 @@ void Logger::output(PRIORITY prio, int level, const char* module, const char* fu
 	bf+=bu;
 	if (level <= debuglevel[prio] && logff[prio].isOpen() == true) {
 		logff[prio].puts(bf);
-		logff[prio].flush();
-		checkRotate(prio);
+		if (flush) {
+			logff[prio].flush();
+			checkRotate(prio);
+		}
 	}
 	if (prio != Logger::DEBUG
 		&& level <= debuglevel[Logger::DEBUG]
 		&& logff[prio].isOpen() == true
 		&& (strcmp(logff[prio].filename(), logff[Logger::DEBUG].filename()) != 0)) {
 		logff[Logger::DEBUG].puts(bf);
-		logff[Logger::DEBUG].flush();
-		checkRotate(Logger::DEBUG);
+		if (flush) {
+			logff[Logger::DEBUG].flush();
+			checkRotate(Logger::DEBUG);
+		}
 	}
 	LOGHANDLER* h=(LOGHANDLER*)firsthandler;
 	while (h) {
@@ -610,6 +1008,11 @@ void Logger::output(PRIORITY prio, int level, const char* module, const char* fu
 	}
 }
 
+LogHandler::~LogHandler()
+{
+
+}
+
 void Logger::addLogHandler(LogHandler* handler)
 {
 	if (!handler) throw IllegalArgumentException("Logger::addLogHandler(LogHandler *handler)");
@@ -657,18 +1060,32 @@ void Logger::deleteLogHandler(LogHandler* handler)
 
 
 
+void Logger::filtersChanged()
+{
+	bool active=false;
+	if (FilterModule != NULL && FilterModule->count() > 0) active=true;
+	if (FilterFile != NULL && FilterFile->count() > 0) active=true;
+	state->filtergeneration=++filter_generation_counter;
+	state->filteractive=active;
+}
+
 void Logger::setFilter(const char* module, const char* function, int level)
 {
 	if (!module) {
 		throw IllegalArgumentException("Logger::setFilter(const char *module)");
 	}
-	if (!FilterModule) FilterModule=new AssocArray;
-	if (!FilterModule) {
-		throw OutOfMemoryException();
+	filtermutex.lock();
+	try {
+		if (!FilterModule) FilterModule=new AssocArray;
+		String Name=module;
+		if (function) Name.appendf("::%s", function);
+		FilterModule->setf(Name, "%i", level);
+	} catch (...) {
+		filtermutex.unlock();
+		throw;
 	}
-	String Name=module;
-	if (function) Name.appendf("::%s", function);
-	FilterModule->setf(Name, "%i", level);
+	filtersChanged();
+	filtermutex.unlock();
 }
 
 
@@ -678,39 +1095,63 @@ void Logger::setFilter(const char* file, int line, int level)
 	if (!file) {
 		throw IllegalArgumentException("Logger::setFilter(const char *file)");
 	}
-	if (!FilterFile) FilterFile=new AssocArray;
-	if (!FilterFile) {
-		throw OutOfMemoryException();
+	filtermutex.lock();
+	try {
+		if (!FilterFile) FilterFile=new AssocArray;
+		String Name=file;
+		Name.appendf(":%i", line);
+		FilterFile->setf(Name, "%i", level);
+	} catch (...) {
+		filtermutex.unlock();
+		throw;
 	}
-	String Name=file;
-	Name.appendf(":%i", line);
-	FilterFile->setf(Name, "%i", level);
+	filtersChanged();
+	filtermutex.unlock();
 }
 
 
 
 void Logger::deleteFilter(const char* module, const char* function)
 {
-	if (!FilterModule) return;
 	if (!module) return;
-	String Name=module;
-	if (function) Name.appendf("::%s", function);
-	FilterModule->remove(Name);
+	filtermutex.lock();
+	if (FilterModule) {
+		String Name=module;
+		if (function) Name.appendf("::%s", function);
+		try {
+			FilterModule->remove(Name);
+		} catch (...) {
+			filtermutex.unlock();
+			throw;
+		}
+	}
+	filtersChanged();
+	filtermutex.unlock();
 }
 
 void Logger::deleteFilter(const char* file, int line)
 {
-	if (!FilterFile) return;
 	if (!file) return;
-	String Name=file;
-	Name.appendf(":%i", line);
-	FilterFile->remove(Name);
+	filtermutex.lock();
+	if (FilterFile) {
+		String Name=file;
+		Name.appendf(":%i", line);
+		try {
+			FilterFile->remove(Name);
+		} catch (...) {
+			filtermutex.unlock();
+			throw;
+		}
+	}
+	filtersChanged();
+	filtermutex.unlock();
 }
 
 bool Logger::shouldPrint(const char* module, const char* function, const char* file, int line, PRIORITY prio, int level)
 {
 	if (prio < 1 || prio >= NUMFACILITIES) return false;
 	if (debuglevel[prio] < level) return false;				// Wenn der Debuglevel kleiner ist, brauchen wir nicht weiter machen
+	if (!state->filteractive) return true;
 	bool ret=true;
 	if (isFiltered(module, function, file, line, level)) ret=false;
 	return ret;
@@ -719,43 +1160,58 @@ bool Logger::shouldPrint(const char* module, const char* function, const char* f
 
 int Logger::isFiltered(const char* module, const char* function, const char* file, int line, int level)
 {
+	uint64_t generation=state->filtergeneration;
+	uintptr_t h=(uintptr_t)module ^ ((uintptr_t)function >> 3) ^ ((uintptr_t)file >> 5) ^ ((uintptr_t)line * 2654435761u);
+	h^=h >> 11;
+	FILTERCACHE& c=filtercache[h & (FILTERCACHE_SIZE - 1)];
+	if (c.generation != generation || c.line != line || c.file != file || c.module != module || c.function != function) {
+		c.threshold=filterThreshold(module, function, file, line);
+		c.generation=generation;
+		c.module=module;
+		c.function=function;
+		c.file=file;
+		c.line=line;
+	}
+	if (level >= c.threshold) return 1;
+	return 0;
+}
+
+static void lowerThreshold(int& threshold, const AssocArray& filter, const String& key)
+{
+	static const String empty;
+	const String& tmp=filter.getString(key, empty);
+	if (tmp.notEmpty() && tmp.toInt() < threshold) threshold=tmp.toInt();
+}
+
+/*
+ * Liefert den kleinsten Level, ab dem Meldungen der Aufrufstelle unterdrückt werden, oder
+ * INT_MAX, wenn kein Filter greift.
+ */
+int Logger::filterThreshold(const char* module, const char* function, const char* file, int line)
+{
+	int threshold=INT_MAX;
 	String Name;
-	int l;
+	filtermutex.lock();
 	if (FilterModule) {
 		if (module) {
 			Name=module;
-			const String& tmp=FilterModule->getString(Name);
-			if (tmp.notEmpty()) {
-				l=tmp.toInt();
-				if (level >= l) return 1;
-			}
+			lowerThreshold(threshold, *FilterModule, Name);
 			if (function) {
 				Name.appendf("::%s", function);
-				const String& tmp=FilterModule->getString(Name);
-				if (tmp.notEmpty()) {
-					l=tmp.toInt();
-					if (level >= l) return 1;
-				}
+				lowerThreshold(threshold, *FilterModule, Name);
 			}
 		}
 	}
 	if (FilterFile) {
 		if (file) {
 			Name.setf("%s:0", file);
-			const String& tmp=FilterFile->getString(Name);
-			if (tmp.notEmpty()) {
-				l=tmp.toInt();
-				if (level >= l) return 1;
-			}
+			lowerThreshold(threshold, *FilterFile, Name);
 			Name.setf("%s:%i", file, line);
-			const String& tmp2=FilterFile->getString(Name);
-			if (tmp2.notEmpty()) {
-				l=tmp2.toInt();
-				if (level >= l) return 1;
-			}
+			lowerThreshold(threshold, *FilterFile, Name);
 		}
 	}
-	return 0;
+	filtermutex.unlock();
+	return threshold;
 }
 
 
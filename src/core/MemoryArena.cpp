@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "ppl7.h"
+
+
+namespace ppl7 {
+
+/*!\class MemoryArena
+ * \ingroup PPLGroupMemory
+ * \brief Speicherverwaltung mit Bump-Allokation
+ *
+ * \desc
+ * Die Klasse MemoryArena holt sich den Speicher in großen Blöcken über eine MemoryGroup und
+ * vergibt ihn anschließend durch einfaches Weiterschieben eines Zeigers. Einzelne Speicherbereiche
+ * können nicht freigegeben werden, stattdessen wird der gesamte Speicher mit MemoryArena::clear
+ * oder dem Destruktor auf einmal freigegeben.
+ * \par
+ * Die Klasse eignet sich für viele kleine Objekte mit gleicher Lebensdauer, beispielsweise
+ * für ein AssocArray mit allen seinen Unterelementen (siehe AssocArray::AssocArray(MemoryArena &)).
+ * Anforderungen, die größer als ein Viertel der Blockgröße sind, erhalten einen eigenen Block.
+ * \par
+ * Alle zurückgegebenen Adressen sind auf 16 Byte ausgerichtet. Die Klasse ist nicht threadsicher.
+ */
+
+static const size_t ARENA_ALIGNMENT=16;
+
+/*!\brief Konstruktor
+ *
+ * \param[in] blocksize Größe der Blöcke, die bei Bedarf vom Betriebssystem angefordert werden
+ * \exception IllegalArgumentException: Die Blockgröße ist kleiner als 1024 Byte
+ */
+MemoryArena::MemoryArena(size_t blocksize)
+{
+	if (blocksize<1024) throw IllegalArgumentException("MemoryArena blocksize must be at least 1024 bytes");
+	ptr=NULL;
+	remaining=0;
+	used=0;
+	this->blocksize=(blocksize+ARENA_ALIGNMENT-1)&(~(ARENA_ALIGNMENT-1));
+}
+
+MemoryArena::~MemoryArena()
+{
+	clear();
+}
+
+/*!\brief Gesamten Speicher freigeben
+ *
+ * \desc
+ * Gibt alle Blöcke auf einmal frei. Sämtliche zuvor mit MemoryArena::malloc angeforderten
+ * Speicherbereiche werden dadurch ungültig.
+ */
+void MemoryArena::clear()
+{
+	blocks.clear();
+	ptr=NULL;
+	remaining=0;
+	used=0;
+}
+
+/*!\brief Speicher anfordern
+ *
+ * \param[in] size Anzahl Bytes
+ * \return Pointer auf den Speicherbereich, ausgerichtet auf 16 Byte
+ * \exception IllegalArgumentException: \p size ist 0
+ * \exception OutOfMemoryException: Kein Speicher mehr frei
+ */
+void *MemoryArena::malloc(size_t size)
+{
+	if (!size) throw IllegalArgumentException();
+	size=(size+ARENA_ALIGNMENT-1)&(~(ARENA_ALIGNMENT-1));
+	if (size>remaining) {
+		if (size>(blocksize>>2)) {
+			// Große Anforderungen bekommen einen eigenen Block, damit der Rest des
+			// aktuellen Blocks nicht verloren geht
+			used+=size;
+			return blocks.malloc(size);
+		}
+		ptr=(char*)blocks.malloc(blocksize);
+		remaining=blocksize;
+	}
+	void *adr=ptr;
+	ptr+=size;
+	remaining-=size;
+	used+=size;
+	return adr;
+}
+
+/*!\brief Speicher anfordern und mit 0 initialisieren
+ *
+ * \param[in] size Anzahl Bytes
+ * \return Pointer auf den Speicherbereich
+ */
+void *MemoryArena::calloc(size_t size)
+{
+	void *adr=malloc(size);
+	memset(adr,0,size);
+	return adr;
+}
+
+/*!\brief String kopieren
+ *
+ * \desc
+ * Kopiert \p size Bytes von \p string in die Arena und hängt ein 0-Byte an.
+ */
+char *MemoryArena::strndup(const char *string, size_t size)
+{
+	if (!string) throw NullPointerException();
+	char *adr=(char*)malloc(size+1);
+	memcpy(adr,string,size);
+	adr[size]=0;
+	return adr;
+}
+
+/*!\brief Anzahl vergebener Bytes
+ */
+size_t MemoryArena::memoryUsed() const
+{
+	return used;
+}
+
+/*!\brief Anzahl Bytes, die insgesamt vom Betriebssystem angefordert wurden
+ */
+size_t MemoryArena::memoryAllocated() const
+{
+	return blocks.size();
+}
+
+size_t MemoryArena::blockSize() const
+{
+	return blocksize;
+}
+
+/*!\brief Speicher aus einer MemoryArena anfordern
+ *
+ * \desc
+ * Wird von ArenaAllocator verwendet, damit die Header der Datentypen die Klasse
+ * MemoryArena nicht vollständig kennen müssen.
+ */
+void *MemoryArenaMalloc(MemoryArena *arena, size_t size)
+{
+	return arena->malloc(size);
+}
+
+
+}	// EOF namespace ppl7
@@ -121,7 +121,7 @@ void MemoryGroup::clear()
 	while (first) {
 		m=(MEMGROUP *)first;
 		first=m->next;
-		free(m);
+		::free(m);
 	}
 	first=last=NULL;
 	totalSize=sizeof(MemoryGroup);
@@ -47,27 +47,84 @@
 #include <stdarg.h>
 #endif
 
+#include <atomic>
+
 #include "ppl7.h"
 
 
 namespace ppl7 {
 
+/*
+ * Jedes Element beginnt mit einem HEAPELEMENT-Header, aus dessen Position im Block sich
+ * die Adresse des Blocks ohne Suche berechnen lässt. Das Tag ist eine Prüfsumme aus der
+ * Adresse des Blocks und einem für jeden Heap zufälligen Schlüssel, so dass fremde Pointer
+ * erkannt werden, bevor der Block dereferenziert wird. Bit 0 des Tags ist bei freien
+ * Elementen gesetzt. Freie Elemente werden direkt im Element selbst verkettet (HEAPFREE).
+ */
 typedef struct tagHeapElement {
-	struct tagHeapElement	*next, *previous;
-	void					*ptr;
+	uint32_t		index;
+	uint32_t		tag;
 } HEAPELEMENT;
 
+typedef struct tagHeapFree {
+	struct tagHeapFree	*next;
+} HEAPFREE;
+
 typedef struct tagHeapBlock {
 	struct tagHeapBlock	*previous, *next;
-	void				*buffer;
-	void				*bufferend;
-	size_t				elements;
-	size_t				num_free;
-	HEAPELEMENT			*free;
-	HEAPELEMENT			*elbuffer;
-
+	struct tagHeapBlock	*previous_partial, *next_partial;
+	uint8_t			*buffer;
+	uint8_t			*bufferend;
+	uint8_t			*unused;
+	uint32_t		unused_index;
+	size_t			elements;
+	size_t			num_free;
+	HEAPFREE		*free;
 } HEAPBLOCK;
 
+#define HEAPBLOCK_HEADERSIZE ((sizeof(HEAPBLOCK)+7)&~(size_t)7)
+
+/*
+ * Im threadsicheren Modus besitzt jeder Thread ein eigenes Magazin mit freien Elementen,
+ * aus dem malloc und free ohne Lock bedient werden. Nur wenn das Magazin leer oder voll ist,
+ * werden Elemente unter dem Mutex mit dem Heap ausgetauscht. Die Magazine gehören dem Heap,
+ * die Threads merken sich in einem kleinen Cache nur, welches Magazin zu welchem Heap gehört.
+ */
+typedef struct tagHeapMagazine {
+	struct tagHeapMagazine	*next;
+	uint64_t				thread;
+	HEAPFREE				*free;
+	std::atomic<size_t>		count;
+} HEAPMAGAZINE;
+
+typedef struct tagHeapThreadCache {
+	Mutex					mutex;
+	HEAPMAGAZINE			*magazines;
+	size_t					capacity;
+} HEAPTHREADCACHE;
+
+#define MAGAZINECACHE_SIZE 8
+
+typedef struct tagMagazineCache {
+	uint64_t		cacheid;
+	HEAPMAGAZINE	*magazine;
+} MAGAZINECACHE;
+
+static std::atomic<uint64_t> heap_id_counter(0);
+static thread_local MAGAZINECACHE magazinecache[MAGAZINECACHE_SIZE];
+
+static uint64_t mixHeapKey(uint64_t x)
+{
+	x+=0x9e3779b97f4a7c15ULL;
+	x=(x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x=(x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return (x ^ (x >> 31)) & ~(uint64_t)1;
+}
+
+static inline uint32_t elementTag(const HEAPBLOCK* bl, uint64_t key)
+{
+	return (uint32_t)((((uint64_t)(uintptr_t)bl ^ key) * 0x9e3779b97f4a7c15ULL) >> 32) & ~(uint32_t)1;
+}
 
 /*!\class MemoryHeap
  * \ingroup PPLGroupMemory
@@ -88,6 +145,13 @@ typedef struct tagHeapBlock {
  *
  * Die Wachstumsgröße selbst wächst bei jeder Vergrößerung um 30%.
  *
+ * MemoryHeap::malloc und MemoryHeap::free benötigen unabhängig von der Anzahl Speicherblöcke
+ * konstante Zeit. Jedes Element trägt dazu einen 8 Byte großen Header, über den der
+ * zugehörige Speicherblock gefunden wird. Die Elemente selbst sind auf 8 Byte ausgerichtet.
+ *
+ * Standardmäßig ist die Klasse nicht threadsicher. Soll ein Heap von mehreren Threads
+ * gleichzeitig verwendet werden, muss vorher MemoryHeap::enableThreadCache aufgerufen werden.
+ *
  */
 
 
@@ -101,7 +165,10 @@ typedef struct tagHeapBlock {
 MemoryHeap::MemoryHeap()
 {
 	blocks=NULL;
+	partial=NULL;
+	threadcache=NULL;
 	myElementSize=0;
+	elementStride=0;
 	increaseSize=0;
 	blocksAllocated=0;
 	blocksUsed=0;
@@ -109,6 +176,8 @@ MemoryHeap::MemoryHeap()
 	myGrowPercent=30;
 	mem_allocated=sizeof(MemoryHeap);
 	mem_used=sizeof(MemoryHeap);
+	cacheid=++heap_id_counter;
+	heapkey=mixHeapKey(cacheid ^ (uint64_t)(uintptr_t)this);
 }
 
 /*!\brief Konstruktor mit Initialisierung
@@ -127,7 +196,10 @@ MemoryHeap::MemoryHeap()
 MemoryHeap::MemoryHeap(size_t elementsize, size_t startnum, size_t increase, size_t growpercent)
 {
 	blocks=NULL;
+	partial=NULL;
+	threadcache=NULL;
 	myElementSize=0;
+	elementStride=0;
 	increaseSize=0;
 	blocksAllocated=0;
 	blocksUsed=0;
@@ -135,6 +207,8 @@ MemoryHeap::MemoryHeap(size_t elementsize, size_t startnum, size_t increase, siz
 	myGrowPercent=growpercent;
 	mem_allocated=sizeof(MemoryHeap);
 	mem_used=sizeof(MemoryHeap);
+	cacheid=++heap_id_counter;
+	heapkey=mixHeapKey(cacheid ^ (uint64_t)(uintptr_t)this);
 	init(elementsize, startnum, increase);
 }
 
@@ -147,6 +221,7 @@ MemoryHeap::MemoryHeap(size_t elementsize, size_t startnum, size_t increase, siz
 MemoryHeap::~MemoryHeap()
 {
 	clear();
+	delete (HEAPTHREADCACHE*)threadcache;
 }
 
 /*!\brief Gesamten Speicher freigeben
@@ -156,14 +231,25 @@ MemoryHeap::~MemoryHeap()
  * MemoryHeap::malloc oder Heap:calloc allokierten Speicherblöcke verlieren ihre Gültigkeit und
  * dürfen nicht mehr verwendet werden.
  *
+ * \note Im threadsicheren Modus darf die Funktion nur aufgerufen werden, wenn kein anderer
+ * Thread gleichzeitig auf den Heap zugreift.
  */
 void MemoryHeap::clear()
 {
+	HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+	if (tc) {
+		HEAPMAGAZINE *next, *m=tc->magazines;
+		while (m) {
+			next=m->next;
+			delete m;
+			m=next;
+		}
+		tc->magazines=NULL;
+		cacheid=++heap_id_counter;
+	}
 	HEAPBLOCK *next, *bl=(HEAPBLOCK*)blocks;
 	while (bl) {
 		next=bl->next;
-		::free(bl->elbuffer);
-		::free(bl->buffer);
 		::free(bl);
 		bl=next;
 	}
@@ -171,6 +257,7 @@ void MemoryHeap::clear()
 	blocksAllocated=0;
 	blocksUsed=0;
 	blocks=NULL;
+	partial=NULL;
 	mem_allocated=sizeof(MemoryHeap);
 	mem_used=sizeof(MemoryHeap);
 }
@@ -193,13 +280,22 @@ size_t MemoryHeap::capacity() const
 /*!\brief Anzahl belegter Elemente
  *
  * \desc
- * Liefert die Anzahl Elemente zurück, die derzeit in Verwendung sind.
+ * Liefert die Anzahl Elemente zurück, die derzeit in Verwendung sind. Elemente, die im
+ * threadsicheren Modus in den Magazinen der Threads vorgehalten werden, zählen nicht dazu.
  *
  * @return Anzahl Elemente
  */
 size_t MemoryHeap::count() const
 {
-	return blocksUsed;
+	HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+	if (!tc) return blocksUsed;
+	tc->mutex.lock();
+	size_t cached=0;
+	for (HEAPMAGAZINE *m=tc->magazines;m!=NULL;m=m->next) cached+=m->count.load(std::memory_order_relaxed);
+	size_t used=blocksUsed;
+	tc->mutex.unlock();
+	if (cached > used) return 0;
+	return used - cached;
 }
 
 /*!\brief Größe der Elemente
@@ -229,10 +325,18 @@ size_t MemoryHeap::elementSize() const
  */
 void MemoryHeap::reserve(size_t num)
 {
-	if (num>blocksAllocated) {
-		size_t grow=num-blocksAllocated;
-		increase(grow);
+	HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+	if (tc) tc->mutex.lock();
+	try {
+		if (num>blocksAllocated) {
+			size_t grow=num-blocksAllocated;
+			increase(grow);
+		}
+	} catch (...) {
+		if (tc) tc->mutex.unlock();
+		throw;
 	}
+	if (tc) tc->mutex.unlock();
 }
 
 /*!\brief Initialisierung der Klasse
@@ -259,6 +363,10 @@ void MemoryHeap::init(size_t elementsize, size_t startnum, size_t increase, size
 	elementsize=(elementsize+3)&0xfffffffc;
 
 	this->myElementSize=elementsize;
+	// Platz für den Header und die Verkettung freier Elemente, auf 8 Byte ausgerichtet
+	if (elementsize<sizeof(HEAPFREE)) elementsize=sizeof(HEAPFREE);
+	elementStride=sizeof(HEAPELEMENT)+((elementsize+7)&~(size_t)7);
+	if (!increase) increase=1;
 	this->increaseSize=increase;
 	myGrowPercent=growpercent;
 	if (startnum) this->increase(startnum);
@@ -268,7 +376,8 @@ void MemoryHeap::init(size_t elementsize, size_t startnum, size_t increase, size
  *
  * \desc
  * Interne Funktion, die aufgerufen wird, um den Heap um eine bestimmte Anzahl Elemente zu
- * vergrößern.
+ * vergrößern. Die Elemente werden dabei noch nicht angefasst, sondern erst bei der ersten
+ * Verwendung initialisiert.
  *
  * @param num Anzahl Elemente, für die neuer Speicher allokiert werden soll
  * \exception OutOfMemoryException: Wird geworfen, wenn nicht genug Speicher verfügbar ist, um den
@@ -277,42 +386,124 @@ void MemoryHeap::init(size_t elementsize, size_t startnum, size_t increase, size
  */
 void MemoryHeap::increase(size_t num)
 {
-	HEAPBLOCK *bl=(HEAPBLOCK*)::malloc(sizeof(HEAPBLOCK));
+	if (num>0xffffffff) throw IllegalArgumentException("MemoryHeap: too many elements");
+	HEAPBLOCK *bl=(HEAPBLOCK*)::malloc(HEAPBLOCK_HEADERSIZE+elementStride*num);
 	if (!bl) throw OutOfMemoryException();
 	bl->elements=num;
-	bl->next=NULL;
 	bl->num_free=num;
+	bl->free=NULL;
+	bl->buffer=(uint8_t*)bl+HEAPBLOCK_HEADERSIZE;
+	bl->bufferend=bl->buffer+elementStride*num;
+	bl->unused=bl->buffer;
+	bl->unused_index=0;
 	bl->previous=NULL;
-	bl->buffer=::malloc(myElementSize*num);
-	if (!bl->buffer) {
-		::free(bl);
-		throw OutOfMemoryException();
-	}
-	bl->bufferend=(uint8_t*)bl->buffer+myElementSize*num;
-	bl->free=(HEAPELEMENT *)::malloc(sizeof(HEAPELEMENT)*num);
-	if (!bl->free) {
-		::free(bl->buffer);
-		::free(bl);
-		throw OutOfMemoryException();
-	}
-	bl->elbuffer=bl->free;
-	HEAPELEMENT *t,*prev=NULL;
-	uint8_t *buffer=(uint8_t*)bl->buffer;
-	for(size_t i=0;i<num;i++) {
-		t=&bl->free[i];
-		t->previous=prev;
-		t->next=&bl->free[i+1];
-		t->ptr=buffer;
-		buffer+=myElementSize;
-		prev=t;
-	}
-	bl->free[num-1].next=NULL;
 	bl->next=(HEAPBLOCK*)blocks;
 	if (bl->next) bl->next->previous=bl;
 	blocks=bl;
+	bl->previous_partial=NULL;
+	bl->next_partial=(HEAPBLOCK*)partial;
+	if (bl->next_partial) bl->next_partial->previous_partial=bl;
+	partial=bl;
 	blocksAllocated+=num;
-	mem_allocated+=sizeof(HEAPBLOCK)+myElementSize*num+sizeof(HEAPELEMENT)*num;
-	mem_used+=sizeof(HEAPBLOCK);
+	mem_allocated+=HEAPBLOCK_HEADERSIZE+elementStride*num;
+	mem_used+=HEAPBLOCK_HEADERSIZE;
+}
+
+/*!\brief Element aus den Speicherblöcken entnehmen
+ *
+ * \desc
+ * Interne Funktion, die ein freies Element aus dem ersten Speicherblock mit freien Elementen
+ * entnimmt und den Heap bei Bedarf vergrößert. Im threadsicheren Modus muss der Mutex
+ * gesperrt sein.
+ *
+ * @return Pointer auf den Header des Elements
+ */
+inline void *MemoryHeap::allocElement()
+{
+	HEAPBLOCK *bl=(HEAPBLOCK*)partial;
+	if (!bl) {
+		// Speicher muss vergroessert werden
+		increase(increaseSize);
+		increaseSize+=(increaseSize*myGrowPercent/100);
+		bl=(HEAPBLOCK*)partial;
+	}
+	HEAPELEMENT *el;
+	if (bl->free) {
+		el=(HEAPELEMENT*)((uint8_t*)bl->free-sizeof(HEAPELEMENT));
+		bl->free=bl->free->next;
+	} else {
+		el=(HEAPELEMENT*)bl->unused;
+		el->index=bl->unused_index++;
+		bl->unused+=elementStride;
+	}
+	el->tag=elementTag(bl, heapkey);
+	bl->num_free--;
+	if (!bl->num_free) {
+		// Block ist voll und wird aus der Liste der Blöcke mit freien Elementen genommen
+		partial=bl->next_partial;
+		if (bl->next_partial) bl->next_partial->previous_partial=NULL;
+		bl->next_partial=NULL;
+	}
+	mem_used+=elementStride;
+	blocksUsed++;
+	return el;
+}
+
+/*!\brief Element in seinen Speicherblock zurückgeben
+ *
+ * \desc
+ * Interne Funktion, die ein bereits geprüftes Element wieder in die Free-Kette seines
+ * Speicherblocks hängt. Im threadsicheren Modus muss der Mutex gesperrt sein.
+ *
+ * @param element Pointer auf den Header des Elements
+ */
+inline void MemoryHeap::releaseElement(void *element)
+{
+	HEAPELEMENT *el=(HEAPELEMENT*)element;
+	HEAPBLOCK *bl=(HEAPBLOCK*)((uint8_t*)el-(size_t)el->index*elementStride-HEAPBLOCK_HEADERSIZE);
+	el->tag|=1;
+	HEAPFREE *f=(HEAPFREE*)(el+1);
+	f->next=bl->free;
+	bl->free=f;
+	if (!bl->num_free) {
+		bl->previous_partial=NULL;
+		bl->next_partial=(HEAPBLOCK*)partial;
+		if (bl->next_partial) bl->next_partial->previous_partial=bl;
+		partial=bl;
+	}
+	bl->num_free++;
+	if (bl->num_free==bl->elements) {
+		// Block ist leer, die nächsten Elemente werden wieder der Reihe nach vergeben
+		bl->free=NULL;
+		bl->unused=bl->buffer;
+		bl->unused_index=0;
+	}
+	mem_used-=elementStride;
+	blocksUsed--;
+	freeCount++;
+	if (freeCount>1000) cleanup();
+}
+
+/*!\brief Element prüfen
+ *
+ * \desc
+ * Interne Funktion, die prüft, ob \p mem ein belegtes Element dieses Heaps ist.
+ *
+ * @param mem Pointer auf den freizugebenden Speicherbereich
+ * @return Pointer auf den Header des Elements
+ * \exception MemoryHeap::HeapCorruptedException: Das Element wurde bereits freigegeben
+ * \exception MemoryHeap::ElementNotInHeapException: Das Element gehört nicht zu diesem Heap
+ */
+inline void *MemoryHeap::checkElement(void *mem) const
+{
+	if (!mem) throw ElementNotInHeapException();
+	HEAPELEMENT *el=(HEAPELEMENT*)mem-1;
+	HEAPBLOCK *bl=(HEAPBLOCK*)((uint8_t*)el-(size_t)el->index*elementStride-HEAPBLOCK_HEADERSIZE);
+	uint32_t tag=elementTag(bl, heapkey);
+	if (el->tag==(tag|1)) throw HeapCorruptedException();
+	if (el->tag!=tag) throw ElementNotInHeapException();
+	if (el->index>=bl->elements) throw HeapCorruptedException();
+	return el;
 }
 
 /*!\brief Mit 0 initialisierten Speicher anfordern
@@ -351,72 +542,198 @@ void *MemoryHeap::calloc()
 void *MemoryHeap::malloc()
 {
 	if (!myElementSize) throw NotInitializedException();
-	while (1) {
-		// Den nächsten freien Block suchen
-		HEAPBLOCK *bl=(HEAPBLOCK*)blocks;
-		while (bl) {
-			if (bl->num_free) {
-				HEAPELEMENT *el=bl->free;
-				// Element aus der Free-Kette nehmen
-				bl->free=bl->free->next;
-				if(bl->free) bl->free->previous=NULL;
-				bl->num_free--;
-				mem_used+=myElementSize+sizeof(HEAPELEMENT);
-				blocksUsed++;
-				return el->ptr;
+	if (!threadcache) return (HEAPELEMENT*)allocElement()+1;
+	HEAPMAGAZINE *m=(HEAPMAGAZINE*)threadMagazine();
+	if (!m->free) {
+		// Magazin ist leer und wird zur Hälfte aus dem Heap aufgefüllt
+		HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+		size_t num=tc->capacity/2;
+		if (!num) num=1;
+		tc->mutex.lock();
+		try {
+			for (size_t i=0;i<num;i++) {
+				HEAPELEMENT *el=(HEAPELEMENT*)allocElement();
+				el->tag|=1;
+				HEAPFREE *f=(HEAPFREE*)(el+1);
+				f->next=m->free;
+				m->free=f;
+				m->count.store(m->count.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+			}
+		} catch (...) {
+			// Falls wenigstens ein Element entnommen werden konnte, wird dieses verwendet
+			if (!m->free) {
+				tc->mutex.unlock();
+				throw;
 			}
-			bl=bl->next;
 		}
-		// Speicher muss vergroessert werden
-		increase(increaseSize);
-		increaseSize+=(increaseSize*myGrowPercent/100);
+		tc->mutex.unlock();
 	}
-	return NULL;
+	HEAPFREE *f=m->free;
+	m->free=f->next;
+	m->count.store(m->count.load(std::memory_order_relaxed)-1, std::memory_order_relaxed);
+	HEAPELEMENT *el=(HEAPELEMENT*)f-1;
+	el->tag&=~(uint32_t)1;
+	return f;
 }
 
 /*!\brief Speicher freigeben
  *
  * \desc
  * Speicher, der zuvor mit MemoryHeap::malloc oder MemoryHeap::calloc allokiert wurde, wird wieder
- * freigegeben.
+ * freigegeben. Der zugehörige Speicherblock wird über den Header des Elements ermittelt, die
+ * Funktion benötigt daher unabhängig von der Größe des Heaps konstante Zeit.
  *
  * @param mem Pointer auf den freizugebenden Speicherbereich
  *
- * \exception MemoryHeap::HeapCorruptedException: könnte auftreten, wenn der interne Speicher des
- * Heaps, in dem die Elemente verwaltet werden, überschrieben wurde.
+ * \exception MemoryHeap::HeapCorruptedException: Das Element wurde bereits freigegeben oder
+ * der Header des Elements wurde überschrieben.
  * \exception MemoryHeap::ElementNotInHeapException: Der mit \p mem referenzierte Speicherblock
  * wurde nicht über diesen Heap allokiert.
  */
 void MemoryHeap::free(void *mem)
 {
 	if (!myElementSize) throw NotInitializedException();
-	HEAPBLOCK *bl=(HEAPBLOCK*)blocks;
-	while (bl) {
-		if (mem>=bl->buffer && mem<=bl->bufferend) {
-			// Nummer des Blocks errechnen
-			HEAPELEMENT *el=bl->elbuffer;
-			int element=(uint32_t)((uint8_t*)mem-(uint8_t*)bl->buffer)/(int)myElementSize;
-			if(el[element].ptr!=mem) {
-				// Hier stimmt was nicht!!!!
-				throw HeapCorruptedException();
-			}
-			// Element in die Free-Kette hängen
-			el[element].next=bl->free;
-			el[element].previous=NULL;
-			if (bl->free) bl->free->previous=&el[element];
-			bl->free=&el[element];
-			bl->num_free++;
-			mem_used-=(myElementSize+sizeof(HEAPELEMENT));
-			//if (bl->num_free==bl->elements) cleanup();
-			blocksUsed--;
-			freeCount++;
-			if (freeCount>1000) cleanup();
-
-			return;
+	HEAPELEMENT *el=(HEAPELEMENT*)checkElement(mem);
+	if (!threadcache) {
+		releaseElement(el);
+		return;
+	}
+	HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+	HEAPMAGAZINE *m=(HEAPMAGAZINE*)threadMagazine();
+	el->tag|=1;
+	HEAPFREE *f=(HEAPFREE*)mem;
+	f->next=m->free;
+	m->free=f;
+	size_t count=m->count.load(std::memory_order_relaxed)+1;
+	m->count.store(count, std::memory_order_relaxed);
+	if (count>tc->capacity) {
+		// Magazin ist voll, die Hälfte geht an den Heap zurück
+		tc->mutex.lock();
+		releaseMagazine(m, tc->capacity/2);
+		tc->mutex.unlock();
+	}
+}
+
+/*!\brief Magazin des aktuellen Threads
+ *
+ * \desc
+ * Interne Funktion, die das Magazin des aufrufenden Threads liefert und es bei Bedarf
+ * anlegt. Das Ergebnis wird in einem thread-lokalen Cache vorgehalten.
+ *
+ * @return Pointer auf das Magazin
+ */
+void *MemoryHeap::threadMagazine()
+{
+	MAGAZINECACHE &c=magazinecache[cacheid & (MAGAZINECACHE_SIZE - 1)];
+	if (c.cacheid==cacheid) return c.magazine;
+	HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+	uint64_t thread=ThreadID();
+	tc->mutex.lock();
+	HEAPMAGAZINE *m=tc->magazines;
+	while (m && m->thread!=thread) m=m->next;
+	if (!m) {
+		m=new(std::nothrow) HEAPMAGAZINE;
+		if (!m) {
+			tc->mutex.unlock();
+			throw OutOfMemoryException();
 		}
-		bl=bl->next;
+		m->thread=thread;
+		m->free=NULL;
+		m->count=0;
+		m->next=tc->magazines;
+		tc->magazines=m;
+	}
+	tc->mutex.unlock();
+	c.cacheid=cacheid;
+	c.magazine=m;
+	return m;
+}
+
+/*!\brief Elemente eines Magazins an den Heap zurückgeben
+ *
+ * \desc
+ * Interne Funktion, die so lange Elemente aus dem Magazin in ihre Speicherblöcke zurückgibt,
+ * bis nur noch \p keep Elemente übrig sind. Der Mutex muss gesperrt sein.
+ *
+ * @param magazine Pointer auf das Magazin
+ * @param keep Anzahl Elemente, die im Magazin verbleiben sollen
+ */
+void MemoryHeap::releaseMagazine(void *magazine, size_t keep)
+{
+	HEAPMAGAZINE *m=(HEAPMAGAZINE*)magazine;
+	size_t count=m->count.load(std::memory_order_relaxed);
+	while (count>keep && m->free) {
+		HEAPFREE *f=m->free;
+		m->free=f->next;
+		count--;
+		m->count.store(count, std::memory_order_relaxed);
+		releaseElement((HEAPELEMENT*)f-1);
+	}
+}
+
+/*!\brief Threadsicheren Modus aktivieren
+ *
+ * \desc
+ * Nach Aufruf dieser Funktion dürfen MemoryHeap::malloc, MemoryHeap::calloc und MemoryHeap::free
+ * von mehreren Threads gleichzeitig aufgerufen werden. Jeder Thread erhält dabei ein eigenes
+ * Magazin mit bis zu \p magazinesize freien Elementen, aus dem er ohne Lock bedient wird.
+ * Elemente dürfen auch von einem anderen Thread freigegeben werden als dem, der sie
+ * allokiert hat.
+ *
+ * @param magazinesize Maximale Anzahl freier Elemente pro Thread. Bei 0 wird jeder Aufruf
+ * unter einem Mutex direkt aus den Speicherblöcken bedient.
+ *
+ * \note Die Funktion selbst ist nicht threadsicher und sollte aufgerufen werden, bevor
+ * der Heap an andere Threads weitergegeben wird. Elemente, die noch im Magazin eines
+ * beendeten Threads liegen, werden erst mit MemoryHeap::disableThreadCache oder
+ * MemoryHeap::clear wieder verfügbar.
+ */
+void MemoryHeap::enableThreadCache(size_t magazinesize)
+{
+	HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+	if (!tc) {
+		tc=new HEAPTHREADCACHE;
+		tc->magazines=NULL;
+		cacheid=++heap_id_counter;
+	}
+	tc->capacity=magazinesize;
+	threadcache=tc;
+}
+
+/*!\brief Threadsicheren Modus beenden
+ *
+ * \desc
+ * Sämtliche Elemente aus den Magazinen der Threads werden an den Heap zurückgegeben und der
+ * Heap ist anschließend wieder nicht threadsicher.
+ *
+ * \note Die Funktion darf nur aufgerufen werden, wenn kein anderer Thread gleichzeitig auf
+ * den Heap zugreift.
+ */
+void MemoryHeap::disableThreadCache()
+{
+	HEAPTHREADCACHE *tc=(HEAPTHREADCACHE*)threadcache;
+	if (!tc) return;
+	HEAPMAGAZINE *next, *m=tc->magazines;
+	while (m) {
+		next=m->next;
+		releaseMagazine(m, 0);
+		delete m;
+		m=next;
 	}
-	throw ElementNotInHeapException();
+	threadcache=NULL;
+	cacheid=++heap_id_counter;
+	delete tc;
+}
+
+/*!\brief Ist der Heap threadsicher?
+ *
+ * \desc
+ * Liefert \c true zurück, wenn der threadsichere Modus mit MemoryHeap::enableThreadCache
+ * aktiviert wurde.
+ */
+bool MemoryHeap::isThreadSafe() const
+{
+	return threadcache != NULL;
 }
 
 /*!\brief Aufräumen
@@ -440,12 +757,13 @@ void MemoryHeap::cleanup()
 				blocksAllocated-=bl->elements;
 				if (bl->previous) bl->previous->next=bl->next;
 				if (bl->next) bl->next->previous=bl->previous;
-				mem_allocated-=sizeof(HEAPBLOCK)+myElementSize*bl->elements+sizeof(HEAPELEMENT)*bl->elements;
-				mem_used-=sizeof(HEAPBLOCK);
-				::free(bl->buffer);
-				::free(bl->elbuffer);
-				::free(bl);
 				if (bl==(HEAPBLOCK*)blocks) blocks=next;
+				if (bl->previous_partial) bl->previous_partial->next_partial=bl->next_partial;
+				if (bl->next_partial) bl->next_partial->previous_partial=bl->previous_partial;
+				if (bl==(HEAPBLOCK*)partial) partial=bl->next_partial;
+				mem_allocated-=HEAPBLOCK_HEADERSIZE+elementStride*bl->elements;
+				mem_used-=HEAPBLOCK_HEADERSIZE;
+				::free(bl);
 			}
 			flag=true;
 		}
@@ -490,13 +808,13 @@ void MemoryHeap::dump() const
 {
 	HEAPBLOCK *bl=(HEAPBLOCK*)blocks;
 	PrintDebug ("Dump Heap (0x%tx, ",(std::ptrdiff_t)this);
-	PrintDebug ("Elementsize: %zu):\n", myElementSize);
+	PrintDebug ("Elementsize: %zu, Stride: %zu):\n", myElementSize, elementStride);
 	PrintDebug ("Memory allocated: %zu Bytes, Memory used: %zu Bytes, Memory free: %zu Bytes\n",
 			mem_allocated, mem_used, (mem_allocated-mem_used));
 	PrintDebug ("Blocks allocated: %zu, Blocks used: %zu, freeCount: %zu\n",
 			blocksAllocated, blocksUsed, freeCount);
 	while (bl) {
-		PrintDebug ("HEAPBLOCK: elements: %zu, free: %zu, Bytes allocated: %zu\n",bl->elements, bl->num_free, bl->elements*myElementSize);
+		PrintDebug ("HEAPBLOCK: elements: %zu, free: %zu, Bytes allocated: %zu\n",bl->elements, bl->num_free, bl->elements*elementStride);
 		bl=bl->next;
 	}
 }
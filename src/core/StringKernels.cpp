@@ -0,0 +1,698 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <wchar.h>
+
+#include "ppl7.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PPL7_STRINGKERNELS_X86
+#include <immintrin.h>
+#define PPL7_TARGET_SSE2 __attribute__((target("sse2")))
+#define PPL7_TARGET_AVX2 __attribute__((target("avx2")))
+#if WCHAR_MAX > 0xffff
+#define PPL7_STRINGKERNELS_WCHAR32
+#endif
+#endif
+
+
+namespace ppl7 {
+
+/*!\defgroup PPLGroupStringKernels Beschleunigte Stringfunktionen
+ * \ingroup PPLGroupStrings
+ *
+ * \desc
+ * Die Funktionen in dieser Gruppe sind die Grundbausteine für String::find, String::instr,
+ * String::replace, die trim-Funktionen, die Gross-/Kleinschreibung und Array::explode, sowie
+ * deren Gegenstücke in der Klasse WideString. Im Gegensatz zu den Funktionen der C-Library
+ * arbeiten sie nicht mit nullterminierten Strings, sondern mit einer Längenangabe.
+ * \par
+ * Jede Funktion liegt in einer skalaren, einer SSE2- und einer AVX2-Variante vor. Welche davon
+ * verwendet wird, wird beim ersten Aufruf anhand von GetCPUCaps festgelegt. Mit SetStringKernelCaps
+ * kann die Auswahl nachträglich eingeschränkt werden, beispielsweise um in Tests oder Benchmarks
+ * die Varianten miteinander zu vergleichen.
+ */
+
+namespace {
+
+inline bool isWhitespace(wchar_t c)
+{
+	return (c == 32 || c == '\t' || c == 10 || c == 13);
+}
+
+/*************************************************************************************
+ * Skalare Implementierungen
+ *************************************************************************************/
+
+const char* MemFind_Scalar(const char* haystack, size_t haystacklen, const char* needle, size_t needlelen)
+{
+	if (needlelen == 0) return haystack;
+	if (needlelen > haystacklen) return NULL;
+	const char* p=haystack;
+	const char* last=haystack + haystacklen - needlelen;
+	while (p <= last) {
+		p=(const char*)memchr(p, needle[0], (size_t)(last - p) + 1);
+		if (!p) return NULL;
+		if (memcmp(p + 1, needle + 1, needlelen - 1) == 0) return p;
+		p++;
+	}
+	return NULL;
+}
+
+const wchar_t* WMemFind_Scalar(const wchar_t* haystack, size_t haystacklen, const wchar_t* needle, size_t needlelen)
+{
+	if (needlelen == 0) return haystack;
+	if (needlelen > haystacklen) return NULL;
+	size_t end=haystacklen - needlelen;
+	for (size_t i=0;i <= end;i++) {
+		if (haystack[i] == needle[0] && wmemcmp(haystack + i + 1, needle + 1, needlelen - 1) == 0) return haystack + i;
+	}
+	return NULL;
+}
+
+template<typename T> size_t SpanWhitespace_Scalar(const T* str, size_t len)
+{
+	size_t i=0;
+	while (i < len && isWhitespace(str[i])) i++;
+	return i;
+}
+
+template<typename T> size_t SpanWhitespaceReverse_Scalar(const T* str, size_t len)
+{
+	size_t i=len;
+	while (i > 0 && isWhitespace(str[i - 1])) i--;
+	return len - i;
+}
+
+template<typename T> size_t AsciiLowerCase_Scalar(T* str, size_t len)
+{
+	for (size_t i=0;i < len;i++) {
+		T c=str[i];
+		if ((unsigned long)c > 127) return i;
+		if (c >= 'A' && c <= 'Z') str[i]=c + 32;
+	}
+	return len;
+}
+
+template<typename T> size_t AsciiUpperCase_Scalar(T* str, size_t len)
+{
+	for (size_t i=0;i < len;i++) {
+		T c=str[i];
+		if ((unsigned long)c > 127) return i;
+		if (c >= 'a' && c <= 'z') str[i]=c - 32;
+	}
+	return len;
+}
+
+#ifdef PPL7_STRINGKERNELS_X86
+
+/*************************************************************************************
+ * SSE2
+ *************************************************************************************/
+
+/*
+ * Substringsuche nach dem Verfahren "erstes und letztes Zeichen": pro Durchlauf werden
+ * 16 mögliche Startpositionen gleichzeitig darauf geprüft, ob das erste und das letzte
+ * Zeichen des Suchstrings übereinstimmen. Nur für diese Kandidaten wird der Rest
+ * mit memcmp verglichen.
+ */
+PPL7_TARGET_SSE2 const char* MemFind_SSE2(const char* haystack, size_t haystacklen, const char* needle, size_t needlelen)
+{
+	if (needlelen == 0) return haystack;
+	if (needlelen > haystacklen) return NULL;
+	if (needlelen == 1) return (const char*)memchr(haystack, needle[0], haystacklen);
+	const __m128i first=_mm_set1_epi8(needle[0]);
+	const __m128i last=_mm_set1_epi8(needle[needlelen - 1]);
+	size_t candidates=haystacklen - needlelen + 1;
+	size_t i=0;
+	for (;i + 16 <= candidates;i+=16) {
+		__m128i bf=_mm_loadu_si128((const __m128i*)(haystack + i));
+		__m128i bl=_mm_loadu_si128((const __m128i*)(haystack + i + needlelen - 1));
+		unsigned int mask=_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bf, first), _mm_cmpeq_epi8(bl, last)));
+		while (mask) {
+			unsigned int bit=__builtin_ctz(mask);
+			if (memcmp(haystack + i + bit + 1, needle + 1, needlelen - 2) == 0) return haystack + i + bit;
+			mask&=mask - 1;
+		}
+	}
+	return MemFind_Scalar(haystack + i, haystacklen - i, needle, needlelen);
+}
+
+PPL7_TARGET_SSE2 inline unsigned int WhitespaceMask_SSE2(__m128i v)
+{
+	__m128i m=_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(32)), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+	m=_mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(10)));
+	m=_mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(13)));
+	return (unsigned int)_mm_movemask_epi8(m);
+}
+
+PPL7_TARGET_SSE2 size_t SpanWhitespace_SSE2(const char* str, size_t len)
+{
+	size_t i=0;
+	for (;i + 16 <= len;i+=16) {
+		unsigned int mask=(~WhitespaceMask_SSE2(_mm_loadu_si128((const __m128i*)(str + i)))) & 0xffff;
+		if (mask) return i + __builtin_ctz(mask);
+	}
+	return i + SpanWhitespace_Scalar(str + i, len - i);
+}
+
+PPL7_TARGET_SSE2 size_t SpanWhitespaceReverse_SSE2(const char* str, size_t len)
+{
+	size_t i=len;
+	for (;i >= 16;i-=16) {
+		unsigned int mask=(~WhitespaceMask_SSE2(_mm_loadu_si128((const __m128i*)(str + i - 16)))) & 0xffff;
+		if (mask) return len - (i - 16 + 32 - __builtin_clz(mask));
+	}
+	return len - i + SpanWhitespaceReverse_Scalar(str, i);
+}
+
+/*
+ * Die Gross-/Kleinschreibung wird blockweise umgewandelt, solange ein Block nur ASCII-Zeichen
+ * enthält. Der erste Block mit einem Nicht-ASCII-Zeichen wird an die skalare Variante
+ * übergeben, die an diesem Zeichen stoppt.
+ */
+PPL7_TARGET_SSE2 size_t AsciiCaseConvert_SSE2(char* str, size_t len, char from, char to)
+{
+	const __m128i lower=_mm_set1_epi8(from - 1);
+	const __m128i upper=_mm_set1_epi8(to + 1);
+	const __m128i flip=_mm_set1_epi8(0x20);
+	size_t i=0;
+	for (;i + 16 <= len;i+=16) {
+		__m128i v=_mm_loadu_si128((const __m128i*)(str + i));
+		if (_mm_movemask_epi8(v)) break;
+		__m128i range=_mm_and_si128(_mm_cmpgt_epi8(v, lower), _mm_cmplt_epi8(v, upper));
+		_mm_storeu_si128((__m128i*)(str + i), _mm_xor_si128(v, _mm_and_si128(range, flip)));
+	}
+	if (from == 'A') return i + AsciiLowerCase_Scalar(str + i, len - i);
+	return i + AsciiUpperCase_Scalar(str + i, len - i);
+}
+
+PPL7_TARGET_SSE2 size_t AsciiLowerCase_SSE2(char* str, size_t len)
+{
+	return AsciiCaseConvert_SSE2(str, len, 'A', 'Z');
+}
+
+PPL7_TARGET_SSE2 size_t AsciiUpperCase_SSE2(char* str, size_t len)
+{
+	return AsciiCaseConvert_SSE2(str, len, 'a', 'z');
+}
+
+#ifdef PPL7_STRINGKERNELS_WCHAR32
+PPL7_TARGET_SSE2 const wchar_t* WMemFind_SSE2(const wchar_t* haystack, size_t haystacklen, const wchar_t* needle, size_t needlelen)
+{
+	if (needlelen == 0) return haystack;
+	if (needlelen > haystacklen) return NULL;
+	const __m128i first=_mm_set1_epi32(needle[0]);
+	const __m128i last=_mm_set1_epi32(needle[needlelen - 1]);
+	size_t candidates=haystacklen - needlelen + 1;
+	size_t i=0;
+	for (;i + 4 <= candidates;i+=4) {
+		__m128i bf=_mm_loadu_si128((const __m128i*)(haystack + i));
+		__m128i bl=_mm_loadu_si128((const __m128i*)(haystack + i + needlelen - 1));
+		unsigned int mask=_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(_mm_cmpeq_epi32(bf, first), _mm_cmpeq_epi32(bl, last))));
+		while (mask) {
+			unsigned int bit=__builtin_ctz(mask);
+			if (needlelen < 3 || wmemcmp(haystack + i + bit + 1, needle + 1, needlelen - 2) == 0) return haystack + i + bit;
+			mask&=mask - 1;
+		}
+	}
+	return WMemFind_Scalar(haystack + i, haystacklen - i, needle, needlelen);
+}
+
+PPL7_TARGET_SSE2 inline unsigned int WhitespaceMask_SSE2(const wchar_t* str)
+{
+	__m128i v=_mm_loadu_si128((const __m128i*)str);
+	__m128i m=_mm_or_si128(_mm_cmpeq_epi32(v, _mm_set1_epi32(32)), _mm_cmpeq_epi32(v, _mm_set1_epi32('\t')));
+	m=_mm_or_si128(m, _mm_cmpeq_epi32(v, _mm_set1_epi32(10)));
+	m=_mm_or_si128(m, _mm_cmpeq_epi32(v, _mm_set1_epi32(13)));
+	return (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(m));
+}
+
+PPL7_TARGET_SSE2 size_t WSpanWhitespace_SSE2(const wchar_t* str, size_t len)
+{
+	size_t i=0;
+	for (;i + 4 <= len;i+=4) {
+		unsigned int mask=(~WhitespaceMask_SSE2(str + i)) & 0xf;
+		if (mask) return i + __builtin_ctz(mask);
+	}
+	return i + SpanWhitespace_Scalar(str + i, len - i);
+}
+
+PPL7_TARGET_SSE2 size_t WSpanWhitespaceReverse_SSE2(const wchar_t* str, size_t len)
+{
+	size_t i=len;
+	for (;i >= 4;i-=4) {
+		unsigned int mask=(~WhitespaceMask_SSE2(str + i - 4)) & 0xf;
+		if (mask) return len - (i - 4 + 32 - __builtin_clz(mask));
+	}
+	return len - i + SpanWhitespaceReverse_Scalar(str, i);
+}
+
+PPL7_TARGET_SSE2 size_t WAsciiCaseConvert_SSE2(wchar_t* str, size_t len, wchar_t from, wchar_t to)
+{
+	const __m128i lower=_mm_set1_epi32(from - 1);
+	const __m128i upper=_mm_set1_epi32(to + 1);
+	const __m128i ascii=_mm_set1_epi32(127);
+	const __m128i flip=_mm_set1_epi32(0x20);
+	const __m128i zero=_mm_setzero_si128();
+	size_t i=0;
+	for (;i + 4 <= len;i+=4) {
+		__m128i v=_mm_loadu_si128((const __m128i*)(str + i));
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpgt_epi32(v, ascii), _mm_cmplt_epi32(v, zero)))) break;
+		__m128i range=_mm_and_si128(_mm_cmpgt_epi32(v, lower), _mm_cmplt_epi32(v, upper));
+		_mm_storeu_si128((__m128i*)(str + i), _mm_xor_si128(v, _mm_and_si128(range, flip)));
+	}
+	if (from == 'A') return i + AsciiLowerCase_Scalar(str + i, len - i);
+	return i + AsciiUpperCase_Scalar(str + i, len - i);
+}
+
+PPL7_TARGET_SSE2 size_t WAsciiLowerCase_SSE2(wchar_t* str, size_t len)
+{
+	return WAsciiCaseConvert_SSE2(str, len, 'A', 'Z');
+}
+
+PPL7_TARGET_SSE2 size_t WAsciiUpperCase_SSE2(wchar_t* str, size_t len)
+{
+	return WAsciiCaseConvert_SSE2(str, len, 'a', 'z');
+}
+#endif // PPL7_STRINGKERNELS_WCHAR32
+
+/*************************************************************************************
+ * AVX2
+ *************************************************************************************/
+
+PPL7_TARGET_AVX2 const char* MemFind_AVX2(const char* haystack, size_t haystacklen, const char* needle, size_t needlelen)
+{
+	if (needlelen == 0) return haystack;
+	if (needlelen > haystacklen) return NULL;
+	if (needlelen == 1) return (const char*)memchr(haystack, needle[0], haystacklen);
+	const __m256i first=_mm256_set1_epi8(needle[0]);
+	const __m256i last=_mm256_set1_epi8(needle[needlelen - 1]);
+	size_t candidates=haystacklen - needlelen + 1;
+	size_t i=0;
+	for (;i + 32 <= candidates;i+=32) {
+		__m256i bf=_mm256_loadu_si256((const __m256i*)(haystack + i));
+		__m256i bl=_mm256_loadu_si256((const __m256i*)(haystack + i + needlelen - 1));
+		unsigned int mask=(unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, first), _mm256_cmpeq_epi8(bl, last)));
+		while (mask) {
+			unsigned int bit=__builtin_ctz(mask);
+			if (memcmp(haystack + i + bit + 1, needle + 1, needlelen - 2) == 0) return haystack + i + bit;
+			mask&=mask - 1;
+		}
+	}
+	return MemFind_SSE2(haystack + i, haystacklen - i, needle, needlelen);
+}
+
+PPL7_TARGET_AVX2 inline unsigned int WhitespaceMask_AVX2(__m256i v)
+{
+	__m256i m=_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(32)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+	m=_mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(10)));
+	m=_mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(13)));
+	return (unsigned int)_mm256_movemask_epi8(m);
+}
+
+PPL7_TARGET_AVX2 size_t SpanWhitespace_AVX2(const char* str, size_t len)
+{
+	size_t i=0;
+	for (;i + 32 <= len;i+=32) {
+		unsigned int mask=~WhitespaceMask_AVX2(_mm256_loadu_si256((const __m256i*)(str + i)));
+		if (mask) return i + __builtin_ctz(mask);
+	}
+	return i + SpanWhitespace_SSE2(str + i, len - i);
+}
+
+PPL7_TARGET_AVX2 size_t SpanWhitespaceReverse_AVX2(const char* str, size_t len)
+{
+	size_t i=len;
+	for (;i >= 32;i-=32) {
+		unsigned int mask=~WhitespaceMask_AVX2(_mm256_loadu_si256((const __m256i*)(str + i - 32)));
+		if (mask) return len - (i - 32 + 32 - __builtin_clz(mask));
+	}
+	return len - i + SpanWhitespaceReverse_SSE2(str, i);
+}
+
+PPL7_TARGET_AVX2 size_t AsciiCaseConvert_AVX2(char* str, size_t len, char from, char to)
+{
+	const __m256i lower=_mm256_set1_epi8(from - 1);
+	const __m256i upper=_mm256_set1_epi8(to + 1);
+	const __m256i flip=_mm256_set1_epi8(0x20);
+	size_t i=0;
+	for (;i + 32 <= len;i+=32) {
+		__m256i v=_mm256_loadu_si256((const __m256i*)(str + i));
+		if (_mm256_movemask_epi8(v)) break;
+		__m256i range=_mm256_and_si256(_mm256_cmpgt_epi8(v, lower), _mm256_cmpgt_epi8(upper, v));
+		_mm256_storeu_si256((__m256i*)(str + i), _mm256_xor_si256(v, _mm256_and_si256(range, flip)));
+	}
+	return i + AsciiCaseConvert_SSE2(str + i, len - i, from, to);
+}
+
+PPL7_TARGET_AVX2 size_t AsciiLowerCase_AVX2(char* str, size_t len)
+{
+	return AsciiCaseConvert_AVX2(str, len, 'A', 'Z');
+}
+
+PPL7_TARGET_AVX2 size_t AsciiUpperCase_AVX2(char* str, size_t len)
+{
+	return AsciiCaseConvert_AVX2(str, len, 'a', 'z');
+}
+
+#ifdef PPL7_STRINGKERNELS_WCHAR32
+PPL7_TARGET_AVX2 const wchar_t* WMemFind_AVX2(const wchar_t* haystack, size_t haystacklen, const wchar_t* needle, size_t needlelen)
+{
+	if (needlelen == 0) return haystack;
+	if (needlelen > haystacklen) return NULL;
+	const __m256i first=_mm256_set1_epi32(needle[0]);
+	const __m256i last=_mm256_set1_epi32(needle[needlelen - 1]);
+	size_t candidates=haystacklen - needlelen + 1;
+	size_t i=0;
+	for (;i + 8 <= candidates;i+=8) {
+		__m256i bf=_mm256_loadu_si256((const __m256i*)(haystack + i));
+		__m256i bl=_mm256_loadu_si256((const __m256i*)(haystack + i + needlelen - 1));
+		unsigned int mask=_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(_mm256_cmpeq_epi32(bf, first), _mm256_cmpeq_epi32(bl, last))));
+		while (mask) {
+			unsigned int bit=__builtin_ctz(mask);
+			if (needlelen < 3 || wmemcmp(haystack + i + bit + 1, needle + 1, needlelen - 2) == 0) return haystack + i + bit;
+			mask&=mask - 1;
+		}
+	}
+	return WMemFind_SSE2(haystack + i, haystacklen - i, needle, needlelen);
+}
+
+PPL7_TARGET_AVX2 inline unsigned int WhitespaceMask_AVX2(const wchar_t* str)
+{
+	__m256i v=_mm256_loadu_si256((const __m256i*)str);
+	__m256i m=_mm256_or_si256(_mm256_cmpeq_epi32(v, _mm256_set1_epi32(32)), _mm256_cmpeq_epi32(v, _mm256_set1_epi32('\t')));
+	m=_mm256_or_si256(m, _mm256_cmpeq_epi32(v, _mm256_set1_epi32(10)));
+	m=_mm256_or_si256(m, _mm256_cmpeq_epi32(v, _mm256_set1_epi32(13)));
+	return (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(m));
+}
+
+PPL7_TARGET_AVX2 size_t WSpanWhitespace_AVX2(const wchar_t* str, size_t len)
+{
+	size_t i=0;
+	for (;i + 8 <= len;i+=8) {
+		unsigned int mask=(~WhitespaceMask_AVX2(str + i)) & 0xff;
+		if (mask) return i + __builtin_ctz(mask);
+	}
+	return i + WSpanWhitespace_SSE2(str + i, len - i);
+}
+
+PPL7_TARGET_AVX2 size_t WSpanWhitespaceReverse_AVX2(const wchar_t* str, size_t len)
+{
+	size_t i=len;
+	for (;i >= 8;i-=8) {
+		unsigned int mask=(~WhitespaceMask_AVX2(str + i - 8)) & 0xff;
+		if (mask) return len - (i - 8 + 32 - __builtin_clz(mask));
+	}
+	return len - i + WSpanWhitespaceReverse_SSE2(str, i);
+}
+
+PPL7_TARGET_AVX2 size_t WAsciiCaseConvert_AVX2(wchar_t* str, size_t len, wchar_t from, wchar_t to)
+{
+	const __m256i lower=_mm256_set1_epi32(from - 1);
+	const __m256i upper=_mm256_set1_epi32(to + 1);
+	const __m256i ascii=_mm256_set1_epi32(127);
+	const __m256i flip=_mm256_set1_epi32(0x20);
+	const __m256i zero=_mm256_setzero_si256();
+	size_t i=0;
+	for (;i + 8 <= len;i+=8) {
+		__m256i v=_mm256_loadu_si256((const __m256i*)(str + i));
+		if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpgt_epi32(v, ascii), _mm256_cmpgt_epi32(zero, v)))) break;
+		__m256i range=_mm256_and_si256(_mm256_cmpgt_epi32(v, lower), _mm256_cmpgt_epi32(upper, v));
+		_mm256_storeu_si256((__m256i*)(str + i), _mm256_xor_si256(v, _mm256_and_si256(range, flip)));
+	}
+	return i + WAsciiCaseConvert_SSE2(str + i, len - i, from, to);
+}
+
+PPL7_TARGET_AVX2 size_t WAsciiLowerCase_AVX2(wchar_t* str, size_t len)
+{
+	return WAsciiCaseConvert_AVX2(str, len, 'A', 'Z');
+}
+
+PPL7_TARGET_AVX2 size_t WAsciiUpperCase_AVX2(wchar_t* str, size_t len)
+{
+	return WAsciiCaseConvert_AVX2(str, len, 'a', 'z');
+}
+#endif // PPL7_STRINGKERNELS_WCHAR32
+
+#endif // PPL7_STRINGKERNELS_X86
+
+/*************************************************************************************
+ * Auswahl der Implementierung
+ *************************************************************************************/
+
+struct StringKernelTable
+{
+	uint32_t caps;
+	const char* (*memFind)(const char*, size_t, const char*, size_t);
+	const wchar_t* (*wmemFind)(const wchar_t*, size_t, const wchar_t*, size_t);
+	size_t(*spanWhitespace)(const char*, size_t);
+	size_t(*spanWhitespaceReverse)(const char*, size_t);
+	size_t(*wspanWhitespace)(const wchar_t*, size_t);
+	size_t(*wspanWhitespaceReverse)(const wchar_t*, size_t);
+	size_t(*asciiLowerCase)(char*, size_t);
+	size_t(*asciiUpperCase)(char*, size_t);
+	size_t(*wasciiLowerCase)(wchar_t*, size_t);
+	size_t(*wasciiUpperCase)(wchar_t*, size_t);
+};
+
+void selectKernels(StringKernelTable& t, uint32_t caps)
+{
+	t.caps=0;
+	t.memFind=MemFind_Scalar;
+	t.wmemFind=WMemFind_Scalar;
+	t.spanWhitespace=SpanWhitespace_Scalar<char>;
+	t.spanWhitespaceReverse=SpanWhitespaceReverse_Scalar<char>;
+	t.wspanWhitespace=SpanWhitespace_Scalar<wchar_t>;
+	t.wspanWhitespaceReverse=SpanWhitespaceReverse_Scalar<wchar_t>;
+	t.asciiLowerCase=AsciiLowerCase_Scalar<char>;
+	t.asciiUpperCase=AsciiUpperCase_Scalar<char>;
+	t.wasciiLowerCase=AsciiLowerCase_Scalar<wchar_t>;
+	t.wasciiUpperCase=AsciiUpperCase_Scalar<wchar_t>;
+#ifdef PPL7_STRINGKERNELS_X86
+	if (caps & CPUCAPS::CPU_HAVE_SSE2) {
+		t.caps=CPUCAPS::CPU_HAVE_SSE2;
+		t.memFind=MemFind_SSE2;
+		t.spanWhitespace=SpanWhitespace_SSE2;
+		t.spanWhitespaceReverse=SpanWhitespaceReverse_SSE2;
+		t.asciiLowerCase=AsciiLowerCase_SSE2;
+		t.asciiUpperCase=AsciiUpperCase_SSE2;
+#ifdef PPL7_STRINGKERNELS_WCHAR32
+		t.wmemFind=WMemFind_SSE2;
+		t.wspanWhitespace=WSpanWhitespace_SSE2;
+		t.wspanWhitespaceReverse=WSpanWhitespaceReverse_SSE2;
+		t.wasciiLowerCase=WAsciiLowerCase_SSE2;
+		t.wasciiUpperCase=WAsciiUpperCase_SSE2;
+#endif
+		if (caps & CPUCAPS::CPU_HAVE_AVX2) {
+			t.caps|=CPUCAPS::CPU_HAVE_AVX2;
+			t.memFind=MemFind_AVX2;
+			t.spanWhitespace=SpanWhitespace_AVX2;
+			t.spanWhitespaceReverse=SpanWhitespaceReverse_AVX2;
+			t.asciiLowerCase=AsciiLowerCase_AVX2;
+			t.asciiUpperCase=AsciiUpperCase_AVX2;
+#ifdef PPL7_STRINGKERNELS_WCHAR32
+			t.wmemFind=WMemFind_AVX2;
+			t.wspanWhitespace=WSpanWhitespace_AVX2;
+			t.wspanWhitespaceReverse=WSpanWhitespaceReverse_AVX2;
+			t.wasciiLowerCase=WAsciiLowerCase_AVX2;
+			t.wasciiUpperCase=WAsciiUpperCase_AVX2;
+#endif
+		}
+	}
+#endif
+}
+
+StringKernelTable& kernels()
+{
+	static StringKernelTable table=[]() {
+		StringKernelTable t;
+		selectKernels(t, GetCPUCaps());
+		return t;
+	}();
+	return table;
+}
+
+} // end of anonymous namespace
+
+
+/*!\brief Auswahl der String-Kernel einschränken
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Legt fest, welche Varianten der String-Kernel verwendet werden. Es werden nur die Bits
+ * CPUCAPS::CPU_HAVE_SSE2 und CPUCAPS::CPU_HAVE_AVX2 berücksichtigt, und zwar nur dann, wenn
+ * die CPU das jeweilige Feature auch tatsächlich unterstützt. Mit dem Wert 0 werden
+ * ausschließlich die skalaren Implementierungen verwendet.
+ *
+ * \param caps Gewünschte Features
+ * \return Liefert die vorher aktiven Features zurück
+ * \note Die Funktion ist für Tests und Benchmarks gedacht und nicht threadsicher. Sie
+ * darf nicht aufgerufen werden, während andere Threads Stringfunktionen verwenden.
+ */
+uint32_t SetStringKernelCaps(uint32_t caps)
+{
+	StringKernelTable& t=kernels();
+	uint32_t old=t.caps;
+	selectKernels(t, caps & GetCPUCaps());
+	return old;
+}
+
+/*!\brief Aktive String-Kernel abfragen
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Liefert zurück, welche Varianten der String-Kernel aktuell verwendet werden. Ist kein Bit
+ * gesetzt, werden die skalaren Implementierungen verwendet.
+ *
+ * \return Kombination aus CPUCAPS::CPU_HAVE_SSE2 und CPUCAPS::CPU_HAVE_AVX2
+ */
+uint32_t GetStringKernelCaps()
+{
+	return kernels().caps;
+}
+
+/*!\brief Teilstring in einem Speicherbereich suchen
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Sucht das erste Vorkommen von \p needle innerhalb von \p haystack. Im Gegensatz zu
+ * strstr werden beide Bereiche über ihre Länge begrenzt, 0-Bytes haben keine besondere
+ * Bedeutung.
+ *
+ * \param haystack Zu durchsuchender Speicherbereich
+ * \param haystacklen Länge von \p haystack in Bytes
+ * \param needle Gesuchte Zeichenfolge
+ * \param needlelen Länge von \p needle in Bytes
+ * \return Pointer auf die Fundstelle innerhalb von \p haystack oder NULL, wenn
+ * \p needle nicht enthalten ist. Ist \p needlelen 0, wird \p haystack zurückgegeben.
+ */
+const char* MemFind(const char* haystack, size_t haystacklen, const char* needle, size_t needlelen)
+{
+	return kernels().memFind(haystack, haystacklen, needle, needlelen);
+}
+
+/*!\brief Teilstring in einem Wide-Character-String suchen
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Wie MemFind(const char*, size_t, const char*, size_t), die Längen werden jedoch in
+ * Zeichen angegeben.
+ */
+const wchar_t* MemFind(const wchar_t* haystack, size_t haystacklen, const wchar_t* needle, size_t needlelen)
+{
+	return kernels().wmemFind(haystack, haystacklen, needle, needlelen);
+}
+
+/*!\brief Anzahl Leerzeichen am Anfang
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Liefert die Anzahl Leerzeichen, Tabs, Returns und Linefeeds am Anfang von \p str zurück.
+ */
+size_t SpanWhitespace(const char* str, size_t len)
+{
+	return kernels().spanWhitespace(str, len);
+}
+
+size_t SpanWhitespace(const wchar_t* str, size_t len)
+{
+	return kernels().wspanWhitespace(str, len);
+}
+
+/*!\brief Anzahl Leerzeichen am Ende
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Liefert die Anzahl Leerzeichen, Tabs, Returns und Linefeeds am Ende von \p str zurück.
+ */
+size_t SpanWhitespaceReverse(const char* str, size_t len)
+{
+	return kernels().spanWhitespaceReverse(str, len);
+}
+
+size_t SpanWhitespaceReverse(const wchar_t* str, size_t len)
+{
+	return kernels().wspanWhitespaceReverse(str, len);
+}
+
+/*!\brief ASCII-Zeichen in Kleinbuchstaben umwandeln
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Wandelt die Buchstaben A bis Z am Anfang von \p str in Kleinbuchstaben um. Die Funktion
+ * stoppt am ersten Zeichen ausserhalb des ASCII-Bereichs, da dessen Umwandlung von der
+ * Lokalisierung abhängt.
+ *
+ * \return Anzahl Zeichen, die bearbeitet wurden. Ist der Wert kleiner als \p len, steht an
+ * dieser Position ein Zeichen ausserhalb des ASCII-Bereichs.
+ */
+size_t AsciiLowerCase(char* str, size_t len)
+{
+	return kernels().asciiLowerCase(str, len);
+}
+
+size_t AsciiLowerCase(wchar_t* str, size_t len)
+{
+	return kernels().wasciiLowerCase(str, len);
+}
+
+/*!\brief ASCII-Zeichen in Grossbuchstaben umwandeln
+ * \ingroup PPLGroupStringKernels
+ *
+ * \desc
+ * Wandelt die Buchstaben a bis z am Anfang von \p str in Grossbuchstaben um. Die Funktion
+ * stoppt am ersten Zeichen ausserhalb des ASCII-Bereichs, da dessen Umwandlung von der
+ * Lokalisierung abhängt.
+ *
+ * \return Anzahl Zeichen, die bearbeitet wurden. Ist der Wert kleiner als \p len, steht an
+ * dieser Position ein Zeichen ausserhalb des ASCII-Bereichs.
+ */
+size_t AsciiUpperCase(char* str, size_t len)
+{
+	return kernels().asciiUpperCase(str, len);
+}
+
+size_t AsciiUpperCase(wchar_t* str, size_t len)
+{
+	return kernels().wasciiUpperCase(str, len);
+}
+
+
+}	// EOF namespace ppl7
@@ -0,0 +1,387 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#include <deque>
+#include <thread>
+
+#include "ppl7.h"
+#include "ppl7/core/taskexecutor.h"
+
+
+namespace ppl7 {
+
+/*!\class TaskExecutor
+ * \ingroup PPLGroupThreads
+ * \brief Task-basierte Ausführung mit Work-Stealing
+ *
+ * \desc
+ * Der TaskExecutor startet eine feste Anzahl Worker-Threads und führt darauf beliebig viele
+ * kleine Aufgaben aus, ohne dass für jede Aufgabe eine eigene Klasse von ppl7::Thread
+ * abgeleitet werden muss. Aufgaben sind beliebige Funktionen oder Lambdas ohne Parameter.
+ * \par
+ * Jeder Worker hat seine eigene Warteschlange. Aufgaben, die innerhalb einer Aufgabe erzeugt
+ * werden, landen in der Schlange des eigenen Workers und werden von diesem in umgekehrter
+ * Reihenfolge abgearbeitet (LIFO), was den Cache schont. Hat ein Worker nichts mehr zu tun,
+ * stiehlt er die ältesten Aufgaben aus den Schlangen der anderen Worker. Aufgaben von außen
+ * werden reihum auf die Worker verteilt.
+ * \par
+ * Mit TaskExecutor::submit erhält man ein std::future, über das das Ergebnis oder eine in der
+ * Aufgabe geworfene Exception abgeholt werden kann. TaskExecutor::parallelFor und
+ * TaskExecutor::parallelReduce verteilen eine Schleife auf alle Worker und kehren erst zurück,
+ * wenn alle Teile abgearbeitet sind; der aufrufende Thread arbeitet dabei selbst mit.
+ * \par
+ * Die Klasse ist nicht in ppl7.h enthalten, sondern muss mit \c <ppl7/core/taskexecutor.h>
+ * eingebunden werden.
+ *
+ * \example
+ * \code
+ppl7::TaskExecutor executor;
+std::future<int> answer=executor.submit([]() { return 42; });
+std::vector<double> values(1000000);
+executor.parallelFor((size_t)0, values.size(), [&](size_t i) {
+	values[i]=sqrt((double)i);
+});
+double sum=executor.parallelReduce((size_t)0, values.size(), 0.0,
+	[&](size_t i) { return values[i]; },
+	[](double a, double b) { return a+b; });
+printf ("%d, %f\n", answer.get(), sum);
+\endcode
+ */
+
+class TaskExecutor::Worker : public Thread
+{
+public:
+    TaskExecutor* executor;
+    size_t index;
+    Mutex mutex;
+    std::deque<Task> tasks;
+
+    Worker(TaskExecutor* executor, size_t index)
+    {
+        this->executor = executor;
+        this->index = index;
+    }
+    void run()
+    {
+        executor->workerLoop(this);
+    }
+};
+
+thread_local TaskExecutor::Worker* TaskExecutor::currentWorker = NULL;
+
+/*!\brief Konstruktor
+ *
+ * \desc
+ * Startet die Worker-Threads.
+ *
+ * @param threads Anzahl Worker-Threads. Bei 0 wird ein Thread pro CPU-Kern gestartet.
+ * @param name Name der Threads, wie er beispielsweise in \c top oder im Debugger angezeigt
+ * wird (siehe Thread::threadSetName). An den Namen wird die Nummer des Workers angehängt.
+ * @param priority Priorität der Threads (siehe Thread::threadSetPriority)
+ */
+TaskExecutor::TaskExecutor(size_t threads, const String& name, Thread::Priority priority)
+    : pending(0), active(0), sleeping(0), next(0), stopflag(false), name(name), priority(priority)
+{
+    if (!threads) threads = std::thread::hardware_concurrency();
+    if (!threads) threads = 1;
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        Worker* w = new Worker(this, i);
+        workers.push_back(w);
+        pool.addThread(w);
+    }
+    pool.startThreads();
+    while (pool.count_running() < threads) std::this_thread::yield();
+}
+
+/*!\brief Destruktor
+ *
+ * \desc
+ * Wartet, bis alle noch anstehenden Aufgaben abgearbeitet sind, und beendet dann die
+ * Worker-Threads. Eine noch nicht abgeholte Exception einer Aufgabe wird verworfen.
+ */
+TaskExecutor::~TaskExecutor()
+{
+    try {
+        wait();
+    } catch (...) {
+    }
+    stopflag = true;
+    while (pool.running()) {
+        sleepmutex.lock();
+        sleepmutex.signal();
+        sleepmutex.unlock();
+        MSleep(1);
+    }
+    pool.stopThreads();
+    pool.destroyAllThreads();
+    workers.clear();
+}
+
+/*!\brief Anzahl Worker-Threads
+ */
+size_t TaskExecutor::threads() const
+{
+    return workers.size();
+}
+
+/*!\brief Anzahl Aufgaben, die noch auf ihre Ausführung warten
+ */
+size_t TaskExecutor::pendingTasks() const
+{
+    return pending;
+}
+
+/*!\brief Aufgabe einreihen
+ *
+ * \desc
+ * Die Aufgabe \p task wird von einem der Worker ausgeführt. Wirft sie eine Exception, wird
+ * die erste davon aufbewahrt und beim nächsten Aufruf von TaskExecutor::wait weitergeworfen.
+ * Wird das Ergebnis oder die Exception einer bestimmten Aufgabe benötigt, sollte
+ * TaskExecutor::submit verwendet werden.
+ */
+void TaskExecutor::post(const Task& task)
+{
+    push(Task(task));
+}
+/*!\fn std::future TaskExecutor::submit(F func)
+ * \brief Aufgabe mit Ergebnis einreihen
+ *
+ * \desc
+ * Führt \p func in einem Worker aus. Das Ergebnis oder eine von \p func geworfene Exception
+ * kann über das zurückgegebene std::future abgeholt werden.
+ *
+ * \note Innerhalb einer Aufgabe sollte nicht mit std::future::get auf eine andere Aufgabe
+ * gewartet werden, da dabei ein Worker blockiert wird. Hierfür sind
+ * TaskExecutor::parallelFor und TaskExecutor::parallelReduce gedacht.
+ */
+
+/*!\fn void TaskExecutor::parallelFor(Index begin, Index end, Body body, Index grain)
+ * \brief Schleife parallel ausführen
+ *
+ * \desc
+ * Ruft \p body für jeden Index von \p begin bis ausschließlich \p end auf. Der Bereich wird in
+ * Blöcke von \p grain Elementen aufgeteilt, die auf die Worker verteilt werden. Ist \p grain 0,
+ * wird der Bereich in etwa viermal so viele Blöcke aufgeteilt, wie es Worker gibt. Die Funktion
+ * kehrt zurück, wenn alle Blöcke abgearbeitet sind. Wirft \p body eine Exception, wird die
+ * erste davon nach Abschluss aller Blöcke weitergeworfen.
+ * \par
+ * Die Funktion darf auch innerhalb einer Aufgabe aufgerufen werden.
+ */
+
+/*!\fn T TaskExecutor::parallelReduce(Index begin, Index end, const T& identity, Map map, Reduce reduce, Index grain)
+ * \brief Werte parallel berechnen und zusammenfassen
+ *
+ * \desc
+ * Ruft \p map für jeden Index von \p begin bis ausschließlich \p end auf und fasst die
+ * Ergebnisse mit \p reduce zusammen. \p identity ist der Startwert jedes Blocks und muss
+ * neutral bezüglich \p reduce sein (z.B. 0 für eine Summe). Die Blöcke werden in aufsteigender
+ * Reihenfolge zusammengefasst, so dass auch nicht kommutative Operationen ein festes Ergebnis
+ * liefern. Ansonsten gilt das Gleiche wie für TaskExecutor::parallelFor.
+ */
+
+void TaskExecutor::push(Task&& task)
+{
+    Worker* w = currentWorker;
+    if (w == NULL || w->executor != this) w = workers[next++ % workers.size()];
+    active++;
+    pending++;
+    w->mutex.lock();
+    w->tasks.push_back(std::move(task));
+    w->mutex.unlock();
+    if (sleeping) {
+        sleepmutex.lock();
+        sleepmutex.signal();
+        sleepmutex.unlock();
+    }
+}
+
+bool TaskExecutor::popTask(Worker* self, Task& task)
+{
+    if (!pending) return false;
+    size_t num = workers.size();
+    size_t start = 0;
+    if (self) {
+        self->mutex.lock();
+        if (!self->tasks.empty()) {
+            task = std::move(self->tasks.back());
+            self->tasks.pop_back();
+            self->mutex.unlock();
+            pending--;
+            return true;
+        }
+        self->mutex.unlock();
+        start = self->index + 1;
+    }
+    for (size_t i = 0; i < num; i++) {
+        Worker* victim = workers[(start + i) % num];
+        if (victim == self) continue;
+        victim->mutex.lock();
+        if (!victim->tasks.empty()) {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            victim->mutex.unlock();
+            pending--;
+            return true;
+        }
+        victim->mutex.unlock();
+    }
+    return false;
+}
+
+void TaskExecutor::execute(Task& task)
+{
+    try {
+        task();
+    } catch (...) {
+        errormutex.lock();
+        if (!error) error = std::current_exception();
+        errormutex.unlock();
+    }
+    task = nullptr;
+    active--;
+}
+
+void TaskExecutor::workerLoop(Worker* self)
+{
+    String threadname;
+    threadname.setf("%s-%zu", (const char*)name, self->index);
+    self->threadSetName(threadname.left(15));
+    self->threadSetPriority(priority);
+    currentWorker = self;
+    Task task;
+    while (!stopflag) {
+        if (popTask(self, task)) {
+            execute(task);
+            continue;
+        }
+        sleepmutex.lock();
+        sleeping++;
+        if (!pending && !stopflag) sleepmutex.wait(100);
+        sleeping--;
+        sleepmutex.unlock();
+    }
+    currentWorker = NULL;
+}
+
+/*!\brief Eine anstehende Aufgabe im aufrufenden Thread ausführen
+ *
+ * \desc
+ * Holt eine wartende Aufgabe aus einer der Warteschlangen und führt sie aus. Damit kann ein
+ * Thread, der auf andere Aufgaben wartet, in der Zwischenzeit mitarbeiten.
+ *
+ * @return Liefert \c true zurück, wenn eine Aufgabe ausgeführt wurde, \c false, wenn keine
+ * Aufgabe anstand.
+ */
+bool TaskExecutor::runPendingTask()
+{
+    Worker* self = currentWorker;
+    if (self != NULL && self->executor != this) self = NULL;
+    Task task;
+    if (!popTask(self, task)) return false;
+    execute(task);
+    return true;
+}
+
+/*!\brief Auf alle Aufgaben warten
+ *
+ * \desc
+ * Kehrt zurück, wenn alle bisher eingereihten Aufgaben abgearbeitet sind. Der aufrufende
+ * Thread arbeitet dabei mit. Die Funktion darf nicht innerhalb einer Aufgabe aufgerufen
+ * werden, da sie sonst auf sich selbst warten würde.
+ *
+ * @exception std::exception Hat eine mit TaskExecutor::post eingereihte Aufgabe seit dem
+ * letzten Aufruf eine Exception geworfen, wird die erste davon weitergeworfen, nachdem alle
+ * Aufgaben abgearbeitet sind.
+ */
+void TaskExecutor::wait()
+{
+    while (active) {
+        if (!runPendingTask()) std::this_thread::yield();
+    }
+    errormutex.lock();
+    std::exception_ptr e = error;
+    error = nullptr;
+    errormutex.unlock();
+    if (e) std::rethrow_exception(e);
+}
+
+namespace {
+class ChunkGroup
+{
+public:
+    std::atomic<size_t> remaining;
+    Mutex mutex;
+    std::exception_ptr error;
+
+    ChunkGroup(size_t num) : remaining(num) {}
+
+    void run(const std::function<void(size_t)>& fn, size_t chunk)
+    {
+        try {
+            fn(chunk);
+        } catch (...) {
+            mutex.lock();
+            if (!error) error = std::current_exception();
+            mutex.unlock();
+        }
+        remaining--;
+    }
+};
+}	// EOF anonymous namespace
+
+void TaskExecutor::runChunks(size_t num, const std::function<void(size_t)>& fn)
+{
+    if (num == 0) return;
+    if (num == 1) {
+        fn(0);
+        return;
+    }
+    ChunkGroup group(num);
+    ChunkGroup* g = &group;
+    const std::function<void(size_t)>* f = &fn;
+    for (size_t c = num - 1; c > 0; c--) {
+        push([g, f, c]() { g->run(*f, c); });
+    }
+    group.run(fn, 0);
+    while (group.remaining) {
+        if (!runPendingTask()) std::this_thread::yield();
+    }
+    if (group.error) std::rethrow_exception(group.error);
+}
+
+
+}	// EOF namespace ppl7
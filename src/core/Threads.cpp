@@ -226,7 +226,6 @@ void SetTLSData(void *data)
 		CreateTLS(ts->td);
 		if (ts->threadClass) {
 			ts->threadClass->threadStartUp();
-			if (ts->threadClass->threadShouldDeleteOnExit()) delete ts->threadClass;
 		} else {
 			ts->threadFunction(ts->data);
 		}
@@ -245,11 +244,9 @@ void SetTLSData(void *data)
 		THREADSTARTUP *ts=(THREADSTARTUP *)param;
 		CreateTLS(ts->td);
 		if (ts->threadClass) {
+			// threadStartUp beendet den Zugriff auf die Klasse und ihre THREADDATA selbst,
+			// danach darf sie bereits gelöscht sein
 			ts->threadClass->threadStartUp();
-			if (ts->td->mysql_thread_end) ts->td->mysql_thread_end();
-			if (ts->threadClass->threadShouldDeleteOnExit()) {
-				delete ts->threadClass;
-			}
 		} else {
 			ts->threadFunction(ts->data);
 			if (ts->td->mysql_thread_end) ts->td->mysql_thread_end();
@@ -548,6 +545,8 @@ void Thread::threadSignalStop()
 /*! \brief Der Thread wird gestartet
  *
  * ThreadStart startet den Thread und kehrt sofort zur aufrufenden Funktion zurück.
+ * Der Thread gilt ab hier als laufend, so dass Thread::threadStop auch dann auf sein Ende
+ * wartet, wenn er noch gar nicht mit der Ausführung begonnen hat.
  *
  * \see Thread::ThreadMain
  * \see \ref PPLGroupThreads
@@ -557,8 +556,6 @@ void Thread::threadStart()
 	if (threadIsRunning()) {
 		throw ThreadAlreadyRunningException();
 	}
-	IsSuspended=0;
-	IsRunning=0;
 	THREADSTARTUP *ts=(THREADSTARTUP*)malloc(sizeof(THREADSTARTUP));
 	if (!ts) throw OutOfMemoryException();
 	ts->threadClass=this;
@@ -576,6 +573,10 @@ void Thread::threadStart()
 		global_thread_id++;
 		GlobalThreadMutex.unlock();
 	}
+	threadmutex.lock();
+	IsSuspended=0;
+	IsRunning=1;
+	threadmutex.unlock();
 #ifdef _WIN32
 	t->thread=CreateThread(NULL,0,(LPTHREAD_START_ROUTINE)ThreadProc,ts,0,&t->dwThreadID);
 	if (t->thread!=NULL) {
@@ -670,6 +671,10 @@ void Thread::threadResume()
  *
  * ThreadStartUp wird unmittelbar nach Starten des Threads aufgerufen. Hier werden einige
  * Variablen initialisiert und dann ThreadMain aufgerufen.
+ * \par
+ * Nach dem Zurücksetzen von IsRunning wird nicht mehr auf die Klasse zugegriffen, da der
+ * Besitzer sie ab diesem Zeitpunkt nach Thread::threadStop löschen darf. Ist
+ * Thread::threadDeleteOnExit gesetzt, löscht sich die Klasse hier selbst.
  *
  * \note Diese Funktion wird intern verwendet und sollte nicht vom Anwender aufgerufen
  * werden
@@ -686,15 +691,19 @@ void Thread::threadStartUp()
 	threadmutex.unlock();
 	threadSetPriority(myPriority);
 	run();
+	THREADDATA *t=(THREADDATA *)threaddata;
+	if (t->mysql_thread_end) t->mysql_thread_end();
+#ifdef HAVE_VALGRIND_HELGRIND_H
+	VALGRIND_HG_CLEAN_MEMORY(this,sizeof(Thread));
+#endif
+	//VALGRIND_HG_DISABLE_CHECKING(this,sizeof(Thread));
 	threadmutex.lock();
 	flags=0;
 	IsRunning=0;
 	IsSuspended=0;
+	int deleteOnExit=deleteMe;
 	threadmutex.unlock();
-#ifdef HAVE_VALGRIND_HELGRIND_H
-	VALGRIND_HG_CLEAN_MEMORY(this,sizeof(Thread));
-#endif
-	//VALGRIND_HG_DISABLE_CHECKING(this,sizeof(Thread));
+	if (deleteOnExit) delete this;
 }
 
 /*! \brief Flag setzen: Klasse beim Beenden löschen
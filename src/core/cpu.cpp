@@ -55,7 +55,28 @@ extern "C" {
 #else
 static uint32_t PPL7_GetCpuCaps()
 {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	// Ohne NASM ermitteln wir die wichtigsten Features über die Builtins des Compilers
+	uint32_t caps=ppl7::CPUCAPS::CPU_HAVE_CPUID;
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("mmx")) caps|=ppl7::CPUCAPS::CPU_HAVE_MMX;
+	if (__builtin_cpu_supports("sse")) caps|=ppl7::CPUCAPS::CPU_HAVE_SSE;
+	if (__builtin_cpu_supports("sse2")) caps|=ppl7::CPUCAPS::CPU_HAVE_SSE2;
+	if (__builtin_cpu_supports("sse3")) caps|=ppl7::CPUCAPS::CPU_HAVE_SSE3;
+	if (__builtin_cpu_supports("ssse3")) caps|=ppl7::CPUCAPS::CPU_HAVE_SSSE3;
+	if (__builtin_cpu_supports("sse4.1")) caps|=ppl7::CPUCAPS::CPU_HAVE_SSE41;
+	if (__builtin_cpu_supports("sse4.2")) caps|=ppl7::CPUCAPS::CPU_HAVE_SSE42;
+	if (__builtin_cpu_supports("avx")) caps|=ppl7::CPUCAPS::CPU_HAVE_AVX;
+	if (__builtin_cpu_supports("avx2")) caps|=ppl7::CPUCAPS::CPU_HAVE_AVX2;
+	if (__builtin_cpu_supports("avx512f")) caps|=ppl7::CPUCAPS::CPU_HAVE_AVX512;
+	if (__builtin_cpu_supports("pclmul")) caps|=ppl7::CPUCAPS::CPU_HAVE_PCLMUL;
+#ifdef __x86_64__
+	caps|=ppl7::CPUCAPS::CPU_HAVE_AMD64;
+#endif
+	return caps;
+#else
 	return 0;
+#endif
 }
 
 static uint32_t PPL7_GetASMBits()
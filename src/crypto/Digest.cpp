@@ -42,10 +42,6 @@
 #include <openssl/evp.h>
 #endif
 
-#ifdef HAVE_LIBZ
-#include <zlib.h>
-#endif
-
 #include "ppl7.h"
 #include "ppl7-crypto.h"
 
@@ -381,24 +377,11 @@ ByteArray Digest::sha512(const ByteArrayPtr &data)
 
 uint32_t Digest::crc32(const ByteArrayPtr &data)
 {
-#ifdef HAVE_LIBZ
-	uLong crc=::crc32(0L,Z_NULL,0);
-	return ::crc32(crc,(const Bytef*)data.ptr(),(uInt)data.size());
-#endif
 	return Crc32(data.ptr(),data.size());
 }
 
 uint32_t Digest::adler32(const ByteArrayPtr &data)
 {
-     const unsigned char *buffer = (const unsigned char *)data.ptr();
-     size_t buflength=data.size();
-     uint32_t s1 = 1;
-     uint32_t s2 = 0;
-
-     for (size_t n = 0; n < buflength; n++) {
-        s1 = (s1 + buffer[n]) % 65521;
-        s2 = (s2 + s1) % 65521;
-     }
-     return (s2 << 16) | s1;
-  }
+	return Adler32(data.ptr(),data.size());
+}
 }
@@ -0,0 +1,454 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <atomic>
+
+#include "ppl7.h"
+#include "ppl7-crypto.h"
+#include "ppl7/core/taskexecutor.h"
+
+namespace ppl7 {
+
+/*!\class DigestBatch
+ * \ingroup PPLGroupCrypto
+ * \brief Paralleles Hashen vieler Dateien und Baum-Hashes großer Dateien
+ *
+ * \desc
+ * Während Digest::addFile eine einzelne Datei sequentiell auf einem Kern hasht,
+ * verteilt diese Klasse die Arbeit über einen TaskExecutor auf mehrere Threads:
+ * - DigestBatch::hashFiles und DigestBatch::hashDirectory hashen beliebig viele Dateien
+ *   gleichzeitig. Jeder Worker holt sich die nächste Datei aus einer gemeinsamen Liste,
+ *   so dass auch sehr unterschiedlich große Dateien gleichmäßig verteilt werden.
+ *   Kleine Dateien werden mit einem einzigen Lesezugriff in einen Puffer pro Worker
+ *   gelesen, größere Dateien in Fenstern der Puffergröße per mmap eingeblendet.
+ *   Fehler werden nicht als Exception geworfen, sondern pro Datei in Result::Error
+ *   abgelegt, damit eine einzelne unlesbare Datei nicht den ganzen Lauf abbricht.
+ * - DigestBatch::treeHash berechnet einen Merkle-Baum über Blöcke fester Größe
+ *   (DigestBatch::setChunkSize), wodurch auch eine einzelne, sehr große Datei parallel
+ *   gehasht werden kann. Blätter werden als H(0x00 | Block), innere Knoten als
+ *   H(0x01 | links | rechts) berechnet; ein Knoten ohne Partner wird unverändert
+ *   in die nächste Ebene übernommen. Das Ergebnis hängt daher von Algorithmus
+ *   und Blockgröße ab und ist nicht mit dem einfachen Hash der Datei identisch.
+ *
+ * Nach jedem Aufruf liefern DigestBatch::bytesHashed, DigestBatch::elapsed und
+ * DigestBatch::throughput die verarbeitete Datenmenge, die Laufzeit und den Durchsatz.
+ *
+ * \example
+ * \code
+ppl7::DigestBatch batch(ppl7::Digest::Algo_SHA256);
+std::vector<ppl7::DigestBatch::Result> results;
+batch.hashDirectory("/data", results);
+for (size_t i=0;i<results.size();i++) {
+	if (results[i].ok()) printf ("%s  %s\n",(const char*)results[i].Hash.toHex(),
+		(const char*)results[i].Filename);
+}
+printf ("%0.1f MB/s\n",batch.throughput()/(1024.0*1024.0));
+\endcode
+ */
+
+/*!\class DigestBatch::Result
+ * \brief Ergebnis für eine einzelne Datei
+ *
+ * \desc
+ * Enthält den Dateinamen, die Größe, den Hash und im Fehlerfall eine Fehlerbeschreibung.
+ * Ist \c Error nicht leer, ist \c Hash leer.
+ */
+
+DigestBatch::Result::Result()
+{
+	Size=0;
+}
+
+/*!\brief Liefert true, wenn die Datei erfolgreich gehasht wurde
+ */
+bool DigestBatch::Result::ok() const
+{
+	return Error.isEmpty();
+}
+
+/*!\brief Konstruktor
+ *
+ * \param algorithm Zu verwendender Hash-Algorithmus
+ * \param threads Anzahl Worker-Threads. Bei 0 wird die Anzahl der CPU-Kerne verwendet.
+ */
+DigestBatch::DigestBatch(Digest::Algorithm algorithm, size_t threads)
+{
+	this->algorithm=algorithm;
+	numthreads=threads;
+	buffersize=4*1024*1024;
+	chunksize=1024*1024;
+	usemmap=true;
+	executor=NULL;
+	lastbytes=0;
+	lastelapsed=0.0;
+}
+
+DigestBatch::~DigestBatch()
+{
+	delete executor;
+}
+
+/*!\brief Hash-Algorithmus festlegen
+ */
+void DigestBatch::setAlgorithm(Digest::Algorithm algorithm)
+{
+	this->algorithm=algorithm;
+}
+
+Digest::Algorithm DigestBatch::getAlgorithm() const
+{
+	return algorithm;
+}
+
+/*!\brief Anzahl Worker-Threads festlegen
+ *
+ * \desc
+ * Bei 0 wird die Anzahl der CPU-Kerne verwendet. Ein bereits gestarteter
+ * Thread-Pool wird beendet und beim nächsten Aufruf neu angelegt.
+ */
+void DigestBatch::setThreads(size_t threads)
+{
+	if (threads == numthreads) return;
+	numthreads=threads;
+	delete executor;
+	executor=NULL;
+}
+
+/*!\brief Größe der Lesepuffer bzw. mmap-Fenster festlegen
+ *
+ * \desc
+ * Die Größe wird auf ein Vielfaches von 64 KB aufgerundet, damit mmap-Fenster
+ * immer an Seitengrenzen beginnen. Voreinstellung sind 4 MB pro Worker.
+ */
+void DigestBatch::setBufferSize(size_t bytes)
+{
+	const size_t align=64*1024;
+	if (bytes < align) bytes=align;
+	buffersize=(bytes + align - 1) & ~(align - 1);
+}
+
+size_t DigestBatch::getBufferSize() const
+{
+	return buffersize;
+}
+
+/*!\brief Blockgröße für DigestBatch::treeHash festlegen
+ *
+ * \desc
+ * Voreinstellung ist 1 MB. Die Blockgröße geht in das Ergebnis ein.
+ * \exception IllegalArgumentException Blockgröße ist 0
+ */
+void DigestBatch::setChunkSize(size_t bytes)
+{
+	if (!bytes) throw IllegalArgumentException("chunksize must not be 0");
+	chunksize=bytes;
+}
+
+size_t DigestBatch::getChunkSize() const
+{
+	return chunksize;
+}
+
+/*!\brief Verwendung von mmap für große Dateien ein- oder ausschalten
+ *
+ * \desc
+ * Ist mmap ausgeschaltet oder nicht verfügbar, werden alle Dateien mit read
+ * in den Puffer des Workers gelesen.
+ */
+void DigestBatch::setUseMmap(bool enable)
+{
+	usemmap=enable;
+}
+
+TaskExecutor& DigestBatch::workers()
+{
+	if (!executor) executor=new TaskExecutor(numthreads, "DigestBatch");
+	return *executor;
+}
+
+void DigestBatch::hashOne(Digest& digest, Result& r, char*& buffer)
+{
+	File ff;
+	ff.open(r.Filename, File::READ);
+	uint64_t fsize=ff.size();
+	uint64_t pos=0;
+	r.Size=fsize;
+#ifdef HAVE_MMAP
+	if (usemmap && fsize > buffersize) {
+		while (pos < fsize) {
+			size_t bytes=buffersize;
+			if (fsize - pos < bytes) bytes=(size_t)(fsize - pos);
+			digest.addData(ff.map(pos, bytes), bytes);
+			pos+=bytes;
+		}
+		ff.unmap();
+		r.Hash=digest.getDigest();
+		return;
+	}
+#endif
+	if (!buffer) {
+		buffer=(char*)malloc(buffersize);
+		if (!buffer) throw OutOfMemoryException();
+	}
+	while (pos < fsize) {
+		size_t bytes=buffersize;
+		if (fsize - pos < bytes) bytes=(size_t)(fsize - pos);
+		if (ff.read(buffer, bytes) != bytes) throw ReadException("%s", (const char*)r.Filename);
+		digest.addData(buffer, bytes);
+		pos+=bytes;
+	}
+	r.Hash=digest.getDigest();
+}
+
+/*!\brief Liste von Dateien parallel hashen
+ *
+ * \desc
+ * Hasht alle Dateien aus \p files mit dem eingestellten Algorithmus. \p results
+ * enthält anschließend für jede Datei einen Eintrag in der gleichen Reihenfolge.
+ * Fehler beim Öffnen oder Lesen einer Datei werden in Result::Error vermerkt.
+ *
+ * \param files Liste der Dateinamen
+ * \param results Ergebnisliste
+ */
+void DigestBatch::hashFiles(const std::vector<String>& files, std::vector<Result>& results)
+{
+	double start=GetMicrotime();
+	Digest::Algorithm algo=algorithm;
+	Digest probe(algo);		// wirft eine Exception, wenn der Algorithmus nicht verfügbar ist
+	results.clear();
+	results.resize(files.size());
+	for (size_t i=0;i < files.size();i++) results[i].Filename=files[i];
+	std::atomic<size_t> next(0);
+	std::atomic<uint64_t> total(0);
+	TaskExecutor& pool=workers();
+	size_t slots=pool.threads() + 1;
+	if (slots > files.size()) slots=files.size();
+	pool.parallelFor((size_t)0, slots, [&](size_t) {
+		Digest digest(algo);
+		char* buffer=NULL;
+		size_t i;
+		while ((i=next.fetch_add(1)) < results.size()) {
+			Result& r=results[i];
+			try {
+				hashOne(digest, r, buffer);
+				total+=r.Size;
+			} catch (const Exception& e) {
+				r.Error=e.toString();
+				r.Hash.clear();
+				digest.reset();
+			}
+		}
+		free(buffer);
+	}, (size_t)1);
+	lastbytes=total;
+	lastelapsed=GetMicrotime() - start;
+}
+
+static void collectFiles(const String& path, std::vector<String>& files, bool recursive)
+{
+	Dir dir(path);
+	Dir::Iterator it;
+	DirEntry e;
+	dir.reset(it);
+	while (dir.getNext(e, it)) {
+		if (e.Filename == "." || e.Filename == "..") continue;
+		if (e.isFile()) files.push_back(e.File);
+		else if (recursive && e.isDir()) collectFiles(e.File, files, true);
+	}
+}
+
+/*!\brief Alle Dateien eines Verzeichnisses parallel hashen
+ *
+ * \desc
+ * Durchläuft das Verzeichnis \p path mit Dir und hasht alle regulären Dateien
+ * wie DigestBatch::hashFiles. Ist \p recursive true, werden auch alle
+ * Unterverzeichnisse berücksichtigt.
+ *
+ * \param path Verzeichnis
+ * \param results Ergebnisliste
+ * \param recursive Unterverzeichnisse einbeziehen
+ * \exception Dir::open Exceptions, wenn \p path nicht geöffnet werden kann
+ */
+void DigestBatch::hashDirectory(const String& path, std::vector<Result>& results, bool recursive)
+{
+	std::vector<String> files;
+	collectFiles(path, files, recursive);
+	hashFiles(files, results);
+}
+
+ByteArray DigestBatch::treeRoot(std::vector<ByteArray>& nodes)
+{
+	Digest digest(algorithm);
+	static const unsigned char node_prefix=1;
+	while (nodes.size() > 1) {
+		size_t n=0;
+		for (size_t i=0;i < nodes.size();i+=2) {
+			if (i + 1 < nodes.size()) {
+				digest.addData(&node_prefix, 1);
+				digest.addData(nodes[i]);
+				digest.addData(nodes[i + 1]);
+				nodes[n]=digest.getDigest();
+			} else {
+				nodes[n]=std::move(nodes[i]);
+			}
+			n++;
+		}
+		nodes.resize(n);
+	}
+	return nodes[0];
+}
+
+/*!\brief Baum-Hash eines Speicherbereichs berechnen
+ *
+ * \desc
+ * Teilt den Speicherbereich in Blöcke der mit DigestBatch::setChunkSize eingestellten
+ * Größe, hasht die Blöcke parallel und fasst sie zu einem Merkle-Baum zusammen.
+ * Ein leerer Speicherbereich besteht aus einem einzigen, leeren Block.
+ *
+ * \param data Pointer auf den Speicherbereich
+ * \param size Größe in Bytes
+ * \return Wurzel des Baums
+ */
+ByteArray DigestBatch::treeHash(const void* data, size_t size)
+{
+	double start=GetMicrotime();
+	Digest::Algorithm algo=algorithm;
+	const char* p=(const char*)data;
+	size_t chunk=chunksize;
+	size_t num=size ? (size + chunk - 1) / chunk : 1;
+	std::vector<ByteArray> nodes(num);
+	workers().parallelFor((size_t)0, num, [&](size_t i) {
+		static const unsigned char leaf_prefix=0;
+		Digest digest(algo);
+		size_t bytes=chunk;
+		if (size - i * chunk < bytes) bytes=size - i * chunk;
+		digest.addData(&leaf_prefix, 1);
+		if (bytes) digest.addData(p + i * chunk, bytes);
+		nodes[i]=digest.getDigest();
+	}, (size_t)1);
+	ByteArray root=treeRoot(nodes);
+	lastbytes=size;
+	lastelapsed=GetMicrotime() - start;
+	return root;
+}
+
+/*!\brief Baum-Hash eines ByteArrays berechnen
+ *
+ * \copydetails DigestBatch::treeHash(const void*, size_t)
+ */
+ByteArray DigestBatch::treeHash(const ByteArrayPtr& data)
+{
+	return treeHash(data.ptr(), data.size());
+}
+
+/*!\brief Baum-Hash einer Datei berechnen
+ *
+ * \desc
+ * Berechnet den gleichen Baum-Hash wie DigestBatch::treeHash(const void*, size_t) für
+ * den Inhalt der Datei. Sofern mmap verfügbar ist, wird die Datei komplett eingeblendet
+ * und die Worker lesen direkt aus dem Mapping, andernfalls liest jeder Worker seinen
+ * Block selbst.
+ *
+ * \param filename Name der Datei
+ * \return Wurzel des Baums
+ * \exception File::open Exceptions, wenn die Datei nicht geöffnet werden kann
+ * \exception ReadException Die Datei konnte nicht vollständig gelesen werden
+ */
+ByteArray DigestBatch::treeHash(const String& filename)
+{
+	File ff;
+	ff.open(filename, File::READ);
+	uint64_t fsize=ff.size();
+#ifdef HAVE_MMAP
+	if (usemmap && fsize > 0 && fsize == (uint64_t)(size_t)fsize) {
+		ByteArray root=treeHash(ff.map(0, (size_t)fsize), (size_t)fsize);
+		ff.unmap();
+		return root;
+	}
+#endif
+	double start=GetMicrotime();
+	Digest::Algorithm algo=algorithm;
+	uint64_t chunk=chunksize;
+	size_t num=fsize ? (size_t)((fsize + chunk - 1) / chunk) : 1;
+	std::vector<ByteArray> nodes(num);
+	workers().parallelFor((size_t)0, num, [&](size_t i) {
+		static const unsigned char leaf_prefix=0;
+		Digest digest(algo);
+		File in;
+		in.open(filename, File::READ);
+		uint64_t pos=(uint64_t)i * chunk;
+		size_t bytes=(size_t)chunk;
+		if (fsize - pos < bytes) bytes=(size_t)(fsize - pos);
+		digest.addData(&leaf_prefix, 1);
+		if (bytes) {
+			ByteArray buffer;
+			if (in.read(buffer.malloc(bytes), bytes, pos) != bytes) throw ReadException("%s", (const char*)filename);
+			digest.addData(buffer);
+		}
+		nodes[i]=digest.getDigest();
+	}, (size_t)1);
+	ByteArray root=treeRoot(nodes);
+	lastbytes=fsize;
+	lastelapsed=GetMicrotime() - start;
+	return root;
+}
+
+/*!\brief Anzahl Bytes, die beim letzten Aufruf gehasht wurden
+ */
+uint64_t DigestBatch::bytesHashed() const
+{
+	return lastbytes;
+}
+
+/*!\brief Laufzeit des letzten Aufrufs in Sekunden
+ */
+double DigestBatch::elapsed() const
+{
+	return lastelapsed;
+}
+
+/*!\brief Durchsatz des letzten Aufrufs in Bytes pro Sekunde
+ */
+double DigestBatch::throughput() const
+{
+	if (lastelapsed <= 0.0) return 0.0;
+	return (double)lastbytes / lastelapsed;
+}
+
+}	// EOF namespace ppl7
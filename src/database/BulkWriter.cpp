@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STDARG_H
+#include <stdarg.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "ppl7.h"
+#include "ppl7-db.h"
+
+
+namespace ppl7 {
+namespace db {
+
+
+/*!\class BulkWriter
+ * \ingroup PPLGroupDatabases
+ * \brief Datensätze sammeln und blockweise in eine Tabelle schreiben
+ *
+ * \header \#include <ppl7-db.h>
+ *
+ * \descr
+ * Mit dieser Klasse können große Mengen an Datensätzen effizient in eine Tabelle geschrieben
+ * werden. Die Zeilen werden mit BulkWriter::add gesammelt und immer dann, wenn die eingestellte
+ * Blockgröße erreicht ist, mit Database::bulkInsert an die Datenbank übergeben. Je nach Datenbank
+ * wird dabei ein INSERT mit mehreren Zeilen, COPY (PostgreSQL) oder ein vorbereiteter Query
+ * innerhalb einer Transaktion (SQLite) verwendet.
+ * \par
+ * Nach der letzten Zeile muss BulkWriter::flush aufgerufen werden. Zeilen, die beim Löschen
+ * des Objekts noch nicht geschrieben wurden, werden verworfen.
+ *
+ * \example
+ * \code
+ppl7::Array columns;
+columns.add("id");
+columns.add("name");
+ppl7::db::BulkWriter writer(db,"user",columns,5000);
+for (int i=0;i<1000000;i++) {
+	ppl7::Array row;
+	row.add(ppl7::ToString("%d",i));
+	row.add(ppl7::ToString("User %d",i));
+	writer.add(row);
+}
+writer.flush();
+ * \endcode
+ */
+
+/*!\brief Konstruktor der Klasse
+ *
+ * @param[in] db Datenbank-Verbindung, in die geschrieben werden soll
+ * @param[in] table Name der Tabelle
+ * @param[in] columns Namen der Spalten
+ * @param[in] batchsize Anzahl Zeilen, die gesammelt und gemeinsam geschrieben werden
+ * \exception IllegalArgumentException Keine Spalten angegeben
+ */
+BulkWriter::BulkWriter(Database& db, const String& table, const Array& columns, size_t batchsize)
+{
+	if (columns.size() == 0) throw IllegalArgumentException("BulkWriter: no columns");
+	this->db=&db;
+	this->table=table;
+	this->columns=columns;
+	this->batchsize=(batchsize > 0 ? batchsize : 1);
+	numwritten=0;
+}
+
+/*!\brief Destruktor der Klasse
+ *
+ * \descr
+ * Noch nicht geschriebene Zeilen werden verworfen.
+ */
+BulkWriter::~BulkWriter()
+{
+}
+
+/*!\brief Zeile hinzufügen
+ *
+ * \descr
+ * Die Zeile muss die Werte in der Reihenfolge der im Konstruktor angegebenen Spalten enthalten.
+ * Ist die Blockgröße erreicht, werden die gesammelten Zeilen geschrieben.
+ *
+ * @param[in] row Die Werte der Zeile
+ * \exception IllegalArgumentException Die Zeile enthält nicht die richtige Anzahl Werte
+ */
+void BulkWriter::add(const Array& row)
+{
+	if (row.size() != columns.size()) throw IllegalArgumentException("BulkWriter: row has %zu values, expected %zu", row.size(), columns.size());
+	rows.push_back(row);
+	if (rows.size() >= batchsize) flush();
+}
+
+/*!\brief Zeile aus einem Assoziativen Array hinzufügen
+ *
+ * \descr
+ * Die Werte werden anhand der Spaltennamen aus dem Array \p row übernommen, weitere Elemente
+ * werden ignoriert.
+ *
+ * @param[in] row Die Werte der Zeile, der Schlüssel entspricht dem Spaltennamen
+ * \exception KeyNotFoundException Eine Spalte ist in \p row nicht enthalten
+ */
+void BulkWriter::add(const AssocArray& row)
+{
+	Array a;
+	for (size_t i=0;i < columns.size();i++) a.add(row.getString(columns[i]));
+	rows.push_back(a);
+	if (rows.size() >= batchsize) flush();
+}
+
+/*!\brief Gesammelte Zeilen schreiben
+ *
+ * \descr
+ * Schlägt das Schreiben fehl, bleiben die Zeilen erhalten und es wird eine Exception geworfen.
+ */
+void BulkWriter::flush()
+{
+	if (rows.empty()) return;
+	db->bulkInsert(table, columns, rows, batchsize);
+	numwritten+=rows.size();
+	rows.clear();
+}
+
+/*!\brief Gesammelte Zeilen verwerfen
+ */
+void BulkWriter::clear()
+{
+	rows.clear();
+}
+
+/*!\brief Blockgröße festlegen
+ *
+ * @param[in] rows Anzahl Zeilen, die gesammelt und gemeinsam geschrieben werden
+ */
+void BulkWriter::setBatchSize(size_t rows)
+{
+	batchsize=(rows > 0 ? rows : 1);
+}
+
+/*!\brief Blockgröße
+ */
+size_t BulkWriter::batchSize() const
+{
+	return batchsize;
+}
+
+/*!\brief Anzahl gesammelter, noch nicht geschriebener Zeilen
+ */
+size_t BulkWriter::pending() const
+{
+	return rows.size();
+}
+
+/*!\brief Anzahl bisher geschriebener Zeilen
+ */
+uint64_t BulkWriter::written() const
+{
+	return numwritten;
+}
+
+
+}	// EOF namespace db
+}	// EOF namespace ppl7
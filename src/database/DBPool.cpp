@@ -74,7 +74,13 @@ namespace db
  * \par
  * In regelmäßigen Abständen muß die Funktion SinglePool::checkPool aufgerufen werden.
  * Die Funktion prüft die vorhandenen Verbindungen, löscht überflüssige Verbindungen oder
- * baut neue auf, wenn nicht mehr genug freie im Pool vorhanden sind.
+ * baut neue auf, wenn nicht mehr genug freie im Pool vorhanden sind. Alternativ kann mit
+ * DBPool::startCheckThread ein Hintergrund-Thread gestartet werden, der das übernimmt.
+ * \par
+ * Die Klasse ist threadsicher. Freie Verbindungen werden in einem kleinen Array von
+ * atomaren Slots vorgehalten, so dass DBPool::get und DBPool::release im Normalfall ohne
+ * Mutex auskommen. Erst wenn keine freie Verbindung vorhanden ist, eine neue aufgebaut
+ * oder auf eine freiwerdende Verbindung gewartet werden muss, wird der Mutex verwendet.
  *
  * \example
  * \dontinclude db_examples.cpp
@@ -147,12 +153,18 @@ namespace db
  * \brief Wird von der Klasse PoolEx verwendet und enthält den Timestamp der letzten Überprüfung des Pools.
  */
 
-/*!\var DBPool::Used
- * \brief Eine Liste, die alle gerade in Verwendung befindlichen Datenbank-Connects enthält.
+/*!\var DBPool::Connections
+ * \brief Eine Liste, die alle Datenbank-Connects des Pools enthält, egal ob sie frei oder in
+ * Verwendung sind.
  */
 
 /*!\var DBPool::Free
- * \brief Eine Liste, die alle derzeit freien Datenbank-Connects enthält.
+ * \brief Eine Liste mit freien Datenbank-Connects, die nicht mehr in DBPool::IdleSlots gepasst
+ * haben.
+ */
+
+/*!\var DBPool::IdleSlots
+ * \brief Freie Datenbank-Connects, auf die ohne Mutex zugegriffen wird.
  */
 
 /*!\var DBPool::Log
@@ -164,6 +176,47 @@ namespace db
  * \brief Enthält eine Kopie der Connect-Parameter, die über die Funktion Pool::SetConnectParams gesetzt werden.
  */
 
+class DBPool::CheckThread : public Thread
+{
+public:
+    DBPool* pool;
+    int intervall;
+    std::atomic<bool> started;
+
+    CheckThread(DBPool* pool, int intervall)
+    {
+        this->pool=pool;
+        this->intervall=intervall;
+        started=false;
+    }
+
+    void run()
+    {
+        started=true;
+        double next=GetMicrotime() + (double)intervall / 1000.0;
+        while (!threadShouldStop()) {
+            if (GetMicrotime() >= next) {
+                try {
+                    pool->checkPool();
+                } catch (const Exception& e) {
+                    if (pool->Log) pool->Log->printException(__FILE__, __LINE__, "ppl7::db::DBPool", "checkPool", e);
+                }
+                next=GetMicrotime() + (double)intervall / 1000.0;
+            }
+            MSleep(10);
+        }
+    }
+};
+
+static thread_local unsigned int slothint=0;
+static std::atomic<unsigned int> slothint_counter(0);
+
+static inline unsigned int slotHint()
+{
+    if (!slothint) slothint=++slothint_counter;
+    return slothint;
+}
+
 DBPool::DBPool()
 {
     Id = -1;
@@ -179,15 +232,23 @@ DBPool::DBPool()
     Log = NULL;
     LastCheck = 0;
     ConnectParamVersion = 0;
+    Checker = NULL;
+    NumConnections = 0;
+    NumIdle = 0;
+    Waiting = 0;
+    for (int i = 0; i < IDLESLOTS; i++) IdleSlots[i] = NULL;
+    StatGet = StatFastPath = StatWait = StatTimeout = StatCreated = StatDestroyed = 0;
+    StatPingFailed = StatReconnect = StatUsedTimeout = 0;
 }
 
 DBPool::~DBPool()
 {
+    stopCheckThread();
     clearFreePool();
     clearUsedPool();
 }
 
-static String calcHash(const AssocArray& param)
+String DBPool::calcHash(const AssocArray& param)
 {
     ByteArray buffer;
     param.exportBinary(buffer);
@@ -200,10 +261,12 @@ static String calcHash(const AssocArray& param)
  * Mit dieser Funktion werden die Connect-Parameter für die Datenbank festgelegt und der Pool somit
  * initialisiert. Mit der Funktionen Pool::SetOption oder Pool::SetOptions können weitere Pool-spezifische
  * Optionen gesetzt werden. Mit der Funktion Pool::SetName kann dem Pool ein Name zugewiesen werden.
+ * \par
+ * Ändern sich die Parameter, werden alle freien Verbindungen gelöscht. Verbindungen, die noch in
+ * Verwendung sind, werden bei der Rückgabe gelöscht.
  *
  * \param[in] connect Die Connect-Parameter in einem Assoziativen Array, wie sie von der Funktion
  * ppl7::db::Connect, bzw. der jeweiligen Datenbank-Klasse unterstützt werden.
- * \returns Die Funktion liefert bei Erfolg true (1) zurück, sonst false (0).
  */
 void DBPool::setConnectParams(const AssocArray& connect)
 {
@@ -211,18 +274,575 @@ void DBPool::setConnectParams(const AssocArray& connect)
         Log->print(ppl7::Logger::INFO, 4, "ppl7::db::DBPool", "setConnectParams", __FILE__, __LINE__,
                    ppl7::ToString("Setze Connect Parameter für Pool id=%i, name=\"%s\"", Id, (const char*)Name));
     PoolMutex.lock();
-    if (calcHash(connect) != calcHash(this->ConnectParam)) {
-        // increment version and remove remaining connections from free pool
-        ConnectParamVersion++;
-        std::list<Database*>::iterator it;
-        for (it = Free.begin(); it != Free.end(); ++it) {
+    bool changed = (calcHash(connect) != calcHash(this->ConnectParam));
+    if (changed) ConnectParamVersion++;
+    this->ConnectParam = connect;
+    IsInit = true;
+    PoolMutex.unlock();
+    // remove remaining connections from free pool
+    if (changed) clearFreePool();
+}
+
+/*!\brief Neue Verbindung aufbauen
+ *
+ * \desc
+ * Interne Funktion, die eine neue Verbindung zur Datenbank aufbaut und in die Liste
+ * DBPool::Connections aufnimmt. Der Aufrufer muss den Platz dafür vorher in
+ * DBPool::NumConnections reserviert haben.
+ *
+ * \return Pointer auf die neue Verbindung
+ * \exception Exception Es wird die Exception von ppl7::db::Connect weitergereicht
+ */
+Database* DBPool::newDB()
+{
+    PoolMutex.lock();
+    AssocArray param = ConnectParam;
+    int version = ConnectParamVersion;
+    PoolMutex.unlock();
+    Database* db = Connect(param);
+    db->pool = this;
+    db->poolversion = version;
+    db->poolcheckout = 0.0;
+    db->updateLastUse();
+    PoolMutex.lock();
+    Connections.push_back(db);
+    PoolMutex.unlock();
+    StatCreated++;
+    if (Log)
+        Log->print(ppl7::Logger::DEBUG, 5, "ppl7::db::DBPool", "newDB", __FILE__, __LINE__,
+                   ppl7::ToString("Neue Verbindung für Pool id=%i, name=\"%s\"", Id, (const char*)Name));
+    return db;
+}
+
+/*!\brief Verbindung löschen
+ *
+ * \desc
+ * Interne Funktion, die eine Verbindung aus dem Pool entfernt, schließt und löscht.
+ */
+void DBPool::deleteDB(Database* db)
+{
+    PoolMutex.lock();
+    Connections.remove(db);
+    PoolMutex.unlock();
+    NumConnections--;
+    StatDestroyed++;
+    try {
+        delete db;
+    } catch (...) {
+    }
+    // Es ist wieder Platz für eine neue Verbindung
+    signalWaiting();
+}
+
+/*!\brief Wartende Threads wecken
+ */
+void DBPool::signalWaiting()
+{
+    if (Waiting.load() > 0) {
+        PoolMutex.lock();
+        PoolMutex.signal();
+        PoolMutex.unlock();
+    }
+}
+
+/*!\brief Freie Verbindung ohne Mutex entnehmen
+ *
+ * \return Pointer auf eine freie Verbindung oder NULL, wenn kein Slot belegt ist
+ */
+Database* DBPool::takeIdle()
+{
+    if (NumIdle.load(std::memory_order_relaxed) <= 0) return NULL;
+    unsigned int start = slotHint();
+    for (int i = 0; i < IDLESLOTS; i++) {
+        std::atomic<Database*>& slot = IdleSlots[(start + i) % IDLESLOTS];
+        if (slot.load(std::memory_order_relaxed) == NULL) continue;
+        Database* db = slot.exchange(NULL);
+        if (db) {
+            NumIdle--;
+            return db;
+        }
+    }
+    return NULL;
+}
+
+/*!\brief Freie Verbindung ohne Mutex ablegen
+ *
+ * \return Liefert \c false zurück, wenn alle Slots belegt sind
+ */
+bool DBPool::putIdle(Database* db)
+{
+    unsigned int start = slotHint();
+    for (int i = 0; i < IDLESLOTS; i++) {
+        std::atomic<Database*>& slot = IdleSlots[(start + i) % IDLESLOTS];
+        if (slot.load(std::memory_order_relaxed) != NULL) continue;
+        Database* expected = NULL;
+        if (slot.compare_exchange_strong(expected, db)) {
+            NumIdle++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!\brief Verbindung prüfen
+ *
+ * \desc
+ * Interne Funktion, die eine freie Verbindung per Database::ping prüft, sofern seit der
+ * letzten Verwendung mehr als DBPool::KeepAlive Sekunden vergangen sind. Antwortet die
+ * Datenbank nicht, wird ein Reconnect versucht. Schlägt auch dieser fehl, wird die Verbindung
+ * gelöscht.
+ *
+ * \return Liefert \c true zurück, wenn die Verbindung verwendet werden kann
+ */
+bool DBPool::healthCheck(Database* db)
+{
+    if (KeepAlive <= 0) return true;
+    if (GetTime() - db->lastping < (uint64_t)KeepAlive) return true;
+    if (db->ping()) {
+        db->updateLastPing();
+        return true;
+    }
+    StatPingFailed++;
+    try {
+        StatReconnect++;
+        db->reconnect();
+        db->updateLastPing();
+        return true;
+    } catch (const Exception& e) {
+        if (Log) Log->printException(__FILE__, __LINE__, "ppl7::db::DBPool", "healthCheck", e);
+    }
+    deleteDB(db);
+    return false;
+}
+
+/*!\brief Verbindung an den Aufrufer übergeben
+ *
+ * \return Liefert \c false zurück, wenn die Verbindung veraltet oder defekt war und
+ * gelöscht wurde
+ */
+bool DBPool::checkOut(Database* db)
+{
+    if (db->poolversion != ConnectParamVersion.load()) {
+        deleteDB(db);
+        return false;
+    }
+    if (!healthCheck(db)) return false;
+    db->poolcheckout = GetMicrotime();
+    return true;
+}
+
+/*!\brief Verbindung aus dem Pool holen
+ *
+ * \desc
+ * Liefert eine freie Verbindung aus dem Pool. Ist keine frei, wird eine neue aufgebaut,
+ * sofern die maximale Anzahl Verbindungen (DBPool::setMaximumSize) noch nicht erreicht ist.
+ * Andernfalls wartet die Funktion, falls \p wait \c true ist, bis eine Verbindung
+ * zurückgegeben wird.
+ *
+ * \param[in] wait Gibt an, ob gewartet werden soll, wenn keine Verbindung verfügbar ist
+ * \param[in] ms Maximale Wartezeit in Millisekunden. Bei 0 wird unbegrenzt gewartet.
+ * \return Pointer auf die Datenbank-Verbindung. Diese muss mit DBPool::release zurückgegeben
+ * oder mit DBPool::destroy gelöscht werden.
+ * \exception DBPool::PoolNotInitializedException Es wurden keine Connect-Parameter gesetzt
+ * \exception DBPool::PoolExhaustedException Keine Verbindung verfügbar und \p wait ist \c false
+ * \exception TimeoutException Innerhalb von \p ms Millisekunden wurde keine Verbindung frei
+ * \exception Exception Fehler beim Verbindungsaufbau werden weitergereicht
+ */
+Database* DBPool::get(bool wait, int ms)
+{
+    if (!IsInit) throw PoolNotInitializedException();
+    StatGet++;
+    double deadline = 0.0;
+    if (wait && ms > 0) deadline = GetMicrotime() + (double)ms / 1000.0;
+    while (1) {
+        Database* db = takeIdle();
+        if (db) {
+            if (checkOut(db)) {
+                StatFastPath++;
+                return db;
+            }
+            continue;
+        }
+        PoolMutex.lock();
+        if (!Free.empty()) {
+            db = Free.front();
+            Free.pop_front();
+            NumIdle--;
+            PoolMutex.unlock();
+            if (checkOut(db)) return db;
+            continue;
+        }
+        int num = NumConnections.load();
+        while (Max <= 0 || num < Max) {
+            if (NumConnections.compare_exchange_weak(num, num + 1)) break;
+        }
+        if (Max <= 0 || num < Max) {
+            PoolMutex.unlock();
+            try {
+                db = newDB();
+            } catch (...) {
+                NumConnections--;
+                signalWaiting();
+                throw;
+            }
+            db->poolcheckout = GetMicrotime();
+            return db;
+        }
+        if (!wait) {
+            PoolMutex.unlock();
+            throw PoolExhaustedException("Pool id=%i, name=\"%s\"", Id, (const char*)Name);
+        }
+        Waiting++;
+        // Könnte inzwischen ohne Mutex zurückgegeben worden sein
+        db = takeIdle();
+        if (db) {
+            Waiting--;
+            PoolMutex.unlock();
+            if (checkOut(db)) return db;
+            continue;
+        }
+        StatWait++;
+        int timeout = 0;
+        if (deadline > 0.0) {
+            double remaining = deadline - GetMicrotime();
+            if (remaining <= 0.0) {
+                Waiting--;
+                StatTimeout++;
+                PoolMutex.unlock();
+                throw TimeoutException("Pool id=%i, name=\"%s\"", Id, (const char*)Name);
+            }
+            timeout = (int)(remaining * 1000.0) + 1;
+        }
+        PoolMutex.wait(timeout);
+        Waiting--;
+        PoolMutex.unlock();
+    }
+    return NULL;
+}
+
+/*!\brief Verbindung in den Pool zurückgeben
+ *
+ * \desc
+ * Gibt eine mit DBPool::get geholte Verbindung wieder an den Pool zurück.
+ *
+ * \param[in] db Pointer auf die Datenbank-Verbindung
+ * \exception NullPointerException \p db ist NULL
+ * \exception DBPool::ForeignConnectionException Die Verbindung gehört nicht zu diesem Pool
+ */
+void DBPool::release(Database* db)
+{
+    if (!db) throw NullPointerException();
+    if (db->pool != this) throw ForeignConnectionException();
+    db->poolcheckout = 0.0;
+    if (db->poolversion != ConnectParamVersion.load()) {
+        deleteDB(db);
+        return;
+    }
+    if (!putIdle(db)) {
+        PoolMutex.lock();
+        Free.push_back(db);
+        NumIdle++;
+        PoolMutex.unlock();
+    }
+    signalWaiting();
+}
+
+/*!\brief Verbindung löschen
+ *
+ * \desc
+ * Eine mit DBPool::get geholte Verbindung wird nicht an den Pool zurückgegeben, sondern
+ * geschlossen und gelöscht. Das ist sinnvoll, wenn die Anwendung festgestellt hat, dass mit
+ * der Verbindung etwas nicht in Ordnung ist.
+ *
+ * \param[in] db Pointer auf die Datenbank-Verbindung
+ * \exception NullPointerException \p db ist NULL
+ * \exception DBPool::ForeignConnectionException Die Verbindung gehört nicht zu diesem Pool
+ */
+void DBPool::destroy(Database* db)
+{
+    if (!db) throw NullPointerException();
+    if (db->pool != this) throw ForeignConnectionException();
+    deleteDB(db);
+}
+
+/*!\brief Pool überprüfen
+ *
+ * \desc
+ * Diese Funktion sollte in regelmäßigen Abständen aufgerufen werden (siehe auch
+ * DBPool::startCheckThread). Sie schickt an freie Verbindungen, die länger als
+ * DBPool::KeepAlive Sekunden nicht verwendet wurden, einen Ping und baut sie bei Bedarf neu auf,
+ * löscht Verbindungen, die länger als DBPool::IdleTimeout Sekunden unbenutzt sind,
+ * protokolliert Verbindungen, die länger als DBPool::UsedTimeout Sekunden in Verwendung sind,
+ * und baut neue Verbindungen auf, bis die Mindestgröße und die Anzahl freier Verbindungen
+ * (DBPool::MinSpare) erreicht ist.
+ */
+void DBPool::checkPool()
+{
+    if (!IsInit) return;
+    checkIdle();
+    checkUsedPool();
+    createMinimum();
+    createSpare();
+    LastCheck = GetMicrotime();
+}
+
+void DBPool::checkIdle()
+{
+    std::list<Database*> idle;
+    for (int i = 0; i < IDLESLOTS; i++) {
+        Database* db = IdleSlots[i].exchange(NULL);
+        if (db) {
+            NumIdle--;
+            idle.push_back(db);
+        }
+    }
+    PoolMutex.lock();
+    while (!Free.empty()) {
+        idle.push_back(Free.front());
+        Free.pop_front();
+        NumIdle--;
+    }
+    PoolMutex.unlock();
+    // Zuletzt benutzte Verbindungen zuerst, die ältesten werden abgebaut
+    idle.sort([](const Database* a, const Database* b) {
+        return a->lastuse > b->lastuse;
+    });
+    uint64_t now = GetTime();
+    int version = ConnectParamVersion.load();
+    int keep = 0;
+    std::list<Database*>::iterator it;
+    for (it = idle.begin(); it != idle.end(); ++it) {
+        Database* db = (*it);
+        if (db->poolversion != version) {
+            deleteDB(db);
+            continue;
+        }
+        if (IdleTimeout > 0 && now - db->lastuse >= (uint64_t)IdleTimeout
+            && NumConnections.load() > Min && keep >= MinSpare) {
+            if (Log)
+                Log->print(ppl7::Logger::DEBUG, 5, "ppl7::db::DBPool", "checkIdle", __FILE__, __LINE__,
+                           ppl7::ToString("Idle-Timeout, Verbindung wird abgebaut, Pool id=%i, name=\"%s\"", Id, (const char*)Name));
+            deleteDB(db);
+            continue;
+        }
+        if (!healthCheck(db)) continue;
+        keep++;
+        if (!putIdle(db)) {
+            PoolMutex.lock();
+            Free.push_back(db);
+            NumIdle++;
+            PoolMutex.unlock();
+        }
+        signalWaiting();
+    }
+}
+
+void DBPool::checkUsedPool()
+{
+    if (UsedTimeout <= 0) return;
+    double now = GetMicrotime();
+    PoolMutex.lock();
+    std::list<Database*>::iterator it;
+    for (it = Connections.begin(); it != Connections.end(); ++it) {
+        double checkout = (*it)->poolcheckout;
+        if (checkout > 0.0 && now - checkout > (double)UsedTimeout) {
+            StatUsedTimeout++;
+            if (Log)
+                Log->print(ppl7::Logger::WARNING, 1, "ppl7::db::DBPool", "checkUsedPool", __FILE__, __LINE__,
+                           ppl7::ToString("Verbindung ist seit %0.0f Sekunden in Verwendung, Pool id=%i, name=\"%s\"",
+                                          now - checkout, Id, (const char*)Name));
+        }
+    }
+    PoolMutex.unlock();
+}
+
+void DBPool::createMinimum()
+{
+    while (1) {
+        int num = NumConnections.load();
+        if (num >= Min || (Max > 0 && num >= Max)) return;
+        if (!NumConnections.compare_exchange_weak(num, num + 1)) continue;
+        Database* db;
+        try {
+            db = newDB();
+        } catch (...) {
+            NumConnections--;
+            throw;
+        }
+        release(db);
+    }
+}
+
+void DBPool::createSpare()
+{
+    if (MinSpare <= 0 || NumIdle.load() >= MinSpare) return;
+    int grow = Grow;
+    if (grow < MinSpare - NumIdle.load()) grow = MinSpare - NumIdle.load();
+    if (MaxSpare > 0 && grow > MaxSpare) grow = MaxSpare;
+    if (grow < 1) grow = 1;
+    for (int i = 0; i < grow; i++) {
+        int num = NumConnections.load();
+        if (Max > 0 && num >= Max) return;
+        if (!NumConnections.compare_exchange_strong(num, num + 1)) {
+            i--;
+            continue;
+        }
+        Database* db;
+        try {
+            db = newDB();
+        } catch (...) {
+            NumConnections--;
+            throw;
+        }
+        release(db);
+    }
+}
+
+/*!\brief Alle Verbindungen löschen, die in Verwendung sind
+ *
+ * \desc
+ * Sämtliche Verbindungen, die mit DBPool::get geholt und noch nicht zurückgegeben wurden, werden
+ * gelöscht. Die Pointer dürfen anschließend nicht mehr verwendet werden.
+ */
+void DBPool::clearUsedPool()
+{
+    std::list<Database*> used;
+    PoolMutex.lock();
+    std::list<Database*>::iterator it = Connections.begin();
+    while (it != Connections.end()) {
+        if ((*it)->poolcheckout > 0.0) {
+            used.push_back(*it);
+            it = Connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    PoolMutex.unlock();
+    for (it = used.begin(); it != used.end(); ++it) {
+        NumConnections--;
+        StatDestroyed++;
+        try {
             delete (*it);
+        } catch (...) {
         }
-        Free.clear();
     }
-    this->ConnectParam = connect;
-    IsInit = true;
+    signalWaiting();
+}
+
+/*!\brief Alle freien Verbindungen löschen
+ */
+void DBPool::clearFreePool()
+{
+    for (int i = 0; i < IDLESLOTS; i++) {
+        Database* db = IdleSlots[i].exchange(NULL);
+        if (db) {
+            NumIdle--;
+            deleteDB(db);
+        }
+    }
+    PoolMutex.lock();
+    std::list<Database*> free;
+    free.swap(Free);
+    NumIdle -= (int)free.size();
     PoolMutex.unlock();
+    std::list<Database*>::iterator it;
+    for (it = free.begin(); it != free.end(); ++it) deleteDB(*it);
+}
+
+/*!\brief Status des Pools
+ *
+ * \desc
+ * Liefert Informationen über den Zustand des Pools und Statistiken in dem Array \p status
+ * zurück:
+ * - \b id, \b name: Id und Name des Pools
+ * - \b connections, \b used, \b free, \b waiting: Anzahl Verbindungen insgesamt, in Verwendung,
+ *   frei und Anzahl wartender Threads
+ * - \b min, \b max, \b minspare, \b maxspare, \b grow, \b idletimeout, \b usedtimeout,
+ *   \b keepalive: Die Einstellungen des Pools
+ * - \b lastcheck: Zeitpunkt des letzten Aufrufs von DBPool::checkPool
+ * - \b stats/get: Anzahl Aufrufe von DBPool::get, \b stats/fastpath: davon ohne Mutex bedient,
+ *   \b stats/wait: davon mit Wartezeit, \b stats/timeout: davon mit Timeout,
+ *   \b stats/created und \b stats/destroyed: Anzahl auf- und abgebauter Verbindungen,
+ *   \b stats/pingfailed, \b stats/reconnect: fehlgeschlagene Pings und Reconnects,
+ *   \b stats/usedtimeout: Anzahl festgestellter Überschreitungen von DBPool::UsedTimeout
+ */
+void DBPool::getStatus(AssocArray& status)
+{
+    status.clear();
+    status.setf("id", "%i", Id);
+    status.set("name", Name);
+    int connections = NumConnections.load();
+    int idle = NumIdle.load();
+    status.setf("connections", "%i", connections);
+    status.setf("used", "%i", connections - idle);
+    status.setf("free", "%i", idle);
+    status.setf("waiting", "%i", Waiting.load());
+    status.setf("min", "%i", Min);
+    status.setf("max", "%i", Max);
+    status.setf("minspare", "%i", MinSpare);
+    status.setf("maxspare", "%i", MaxSpare);
+    status.setf("grow", "%i", Grow);
+    status.setf("idletimeout", "%i", IdleTimeout);
+    status.setf("usedtimeout", "%i", UsedTimeout);
+    status.setf("keepalive", "%i", KeepAlive);
+    status.setf("lastcheck", "%0.3f", LastCheck);
+    status.setf("stats/get", "%llu", (unsigned long long)StatGet.load());
+    status.setf("stats/fastpath", "%llu", (unsigned long long)StatFastPath.load());
+    status.setf("stats/wait", "%llu", (unsigned long long)StatWait.load());
+    status.setf("stats/timeout", "%llu", (unsigned long long)StatTimeout.load());
+    status.setf("stats/created", "%llu", (unsigned long long)StatCreated.load());
+    status.setf("stats/destroyed", "%llu", (unsigned long long)StatDestroyed.load());
+    status.setf("stats/pingfailed", "%llu", (unsigned long long)StatPingFailed.load());
+    status.setf("stats/reconnect", "%llu", (unsigned long long)StatReconnect.load());
+    status.setf("stats/usedtimeout", "%llu", (unsigned long long)StatUsedTimeout.load());
+}
+
+/*!\brief Anzahl Verbindungen im Pool
+ */
+int DBPool::size() const
+{
+    return NumConnections.load();
+}
+
+/*!\brief Anzahl Verbindungen, die in Verwendung sind
+ */
+int DBPool::used() const
+{
+    return NumConnections.load() - NumIdle.load();
+}
+
+/*!\brief Anzahl freier Verbindungen
+ */
+int DBPool::idle() const
+{
+    return NumIdle.load();
+}
+
+/*!\brief Hintergrund-Thread für DBPool::checkPool starten
+ *
+ * \desc
+ * Startet einen Thread, der alle \p intervall_ms Millisekunden DBPool::checkPool aufruft.
+ * Ein bereits laufender Thread wird vorher beendet.
+ *
+ * \param[in] intervall_ms Intervall in Millisekunden
+ */
+void DBPool::startCheckThread(int intervall_ms)
+{
+    stopCheckThread();
+    if (intervall_ms < 1) intervall_ms = 1;
+    Checker = new CheckThread(this, intervall_ms);
+    Checker->threadStart();
+    while (!Checker->started) MSleep(1);
+}
+
+/*!\brief Hintergrund-Thread beenden
+ */
+void DBPool::stopCheckThread()
+{
+    if (!Checker) return;
+    Checker->threadStop();
+    delete Checker;
+    Checker = NULL;
 }
 
 void DBPool::setOptions(const AssocArray& options)
@@ -235,24 +855,28 @@ void DBPool::setOptions(const AssocArray& options)
     }
 }
 
+/*!\brief Option setzen
+ *
+ * \desc
+ * Setzt eine der Optionen des Pools anhand ihres Namens. Unterstützt werden "min", "max",
+ * "minspare", "maxspare", "grow", "idletimeout" (oder "timeout"), "usedtimeout" und "keepalive".
+ *
+ * \exception IllegalArgumentException Unbekannte Option
+ */
 void DBPool::setOption(const String& Name, const String& Value)
 {
-    /*
-    CString Opt=Name;
-        Opt.LCase();
-        if (Opt=="min") Min=Value.ToInt();
-        else if (Opt=="max") Max=Value.ToInt();
-        else if (Opt=="minspare") MinSpare=Value.ToInt();
-        else if (Opt=="maxspare") MaxSpare=Value.ToInt();
-        else if (Opt=="grow") Grow=Value.ToInt();
-        else if (Opt=="timeout") Timeout=Value.ToInt();
-        else if (Opt=="keepalive") KeepAlive=Value.ToInt();
-        else {
-            Mutex.Unlock();
-            SetError(541,"Pool::SetOption Key=>>%s<<",(const char *)Name);
-            return 0;
-        }
-        */
+    String Opt = Name;
+    Opt.lowerCase();
+    Opt.trim();
+    if (Opt == "min") Min = Value.toInt();
+    else if (Opt == "max") Max = Value.toInt();
+    else if (Opt == "minspare") MinSpare = Value.toInt();
+    else if (Opt == "maxspare") MaxSpare = Value.toInt();
+    else if (Opt == "grow") Grow = Value.toInt();
+    else if (Opt == "idletimeout" || Opt == "timeout") IdleTimeout = Value.toInt();
+    else if (Opt == "usedtimeout") UsedTimeout = Value.toInt();
+    else if (Opt == "keepalive") KeepAlive = Value.toInt();
+    else throw IllegalArgumentException("DBPool::setOption: %s", (const char*)Name);
 }
 
 void DBPool::setName(const String& Name)
@@ -51,6 +51,341 @@
 namespace ppl7 {
 namespace db {
 
+/*!\class DBPoolOfPools
+ * \ingroup PPLGroupDatabases
+ * \brief Verwaltung mehrerer Datenbank-Pools
+ *
+ * \desc
+ * Mit dieser Klasse können mehrere Datenbank-Pools (DBPool) verwaltet werden. Jeder Pool kann
+ * über seine Id, seinen Namen oder seine Connect-Parameter angesprochen werden. Wird eine
+ * Verbindung über die Connect-Parameter angefordert und existiert noch kein Pool dafür, wird er
+ * automatisch angelegt und mit den Optionen aus DBPoolOfPools::setDefaultOptions versehen.
+ * Zur Zuordnung wird ein Hash über die Connect-Parameter verwendet.
+ * \par
+ * Die Klasse ist threadsicher. Die Pools werden über std::shared_ptr verwaltet, ein mit
+ * DBPoolOfPools::deletePool gelöschter Pool wird erst freigegeben, wenn er von keinem
+ * Thread mehr verwendet wird.
+ */
+
+DBPoolOfPools::DBPoolOfPools()
+{
+	Log=NULL;
+	NextId=1;
+}
+
+DBPoolOfPools::~DBPoolOfPools()
+{
+	clear();
+}
+
+std::shared_ptr<DBPool> DBPoolOfPools::findPool(const AssocArray &connect)
+{
+	std::map<String,std::shared_ptr<DBPool> >::const_iterator it=PoolsByHash.find(DBPool::calcHash(connect));
+	if (it==PoolsByHash.end()) return std::shared_ptr<DBPool>();
+	return it->second;
+}
+
+/*
+ * Legt einen neuen Pool an, PoolsMutex muss vom Aufrufer gesperrt sein.
+ */
+std::shared_ptr<DBPool> DBPoolOfPools::createPoolLocked(int id, const String &name, const AssocArray &connect)
+{
+	if (PoolsById.find(id)!=PoolsById.end() || (name.notEmpty() && PoolsByName.find(name)!=PoolsByName.end())) {
+		throw PoolAlreadyExistsException("id=%i, name=%s",id,(const char*)name);
+	}
+	std::shared_ptr<DBPool> pool=std::make_shared<DBPool>();
+	pool->setId(id);
+	pool->setName(name);
+	if (Log) pool->setLogger(*Log);
+	pool->setOptions(DefaultOptions);
+	pool->setConnectParams(connect);
+	PoolsById[id]=pool;
+	if (name.notEmpty()) PoolsByName[name]=pool;
+	String hash=DBPool::calcHash(connect);
+	if (PoolsByHash.find(hash)==PoolsByHash.end()) PoolsByHash[hash]=pool;
+	if (id>=NextId) NextId=id+1;
+	return pool;
+}
+
+/*!\brief Neuen Pool anlegen
+ *
+ * \desc
+ * Legt einen neuen Pool mit der Id \p id, dem Namen \p name und den Connect-Parametern
+ * \p connect an. Die Optionen aus DBPoolOfPools::setDefaultOptions werden übernommen.
+ *
+ * \param[in] id Id des Pools
+ * \param[in] name Name des Pools
+ * \param[in] connect Connect-Parameter, siehe ppl7::db::Connect
+ * \return Pointer auf den neuen Pool
+ * \exception DBPoolOfPools::PoolAlreadyExistsException Es gibt bereits einen Pool mit dieser Id
+ * oder diesem Namen
+ */
+std::shared_ptr<DBPool> DBPoolOfPools::createPool(int id, const String &name, const AssocArray &connect)
+{
+	PoolsMutex.lock();
+	try {
+		std::shared_ptr<DBPool> pool=createPoolLocked(id,name,connect);
+		PoolsMutex.unlock();
+		return pool;
+	} catch (...) {
+		PoolsMutex.unlock();
+		throw;
+	}
+}
+
+/*!\brief Neuen Pool mit automatisch vergebener Id anlegen
+ *
+ * \copydetails DBPoolOfPools::createPool(int, const String &, const AssocArray &)
+ */
+std::shared_ptr<DBPool> DBPoolOfPools::createPool(const String &name, const AssocArray &connect)
+{
+	PoolsMutex.lock();
+	try {
+		std::shared_ptr<DBPool> pool=createPoolLocked(NextId,name,connect);
+		PoolsMutex.unlock();
+		return pool;
+	} catch (...) {
+		PoolsMutex.unlock();
+		throw;
+	}
+}
+
+/*!\brief Pool löschen
+ *
+ * \desc
+ * Der Pool mit der Id \p id wird aus der Verwaltung entfernt. Sobald er nicht mehr
+ * verwendet wird, werden alle seine Verbindungen gelöscht, auch die, die gerade in
+ * Verwendung sind.
+ *
+ * \exception DBPoolOfPools::PoolNotFoundException Pool existiert nicht
+ */
+void DBPoolOfPools::deletePool(int id)
+{
+	PoolsMutex.lock();
+	std::map<int,std::shared_ptr<DBPool> >::iterator it=PoolsById.find(id);
+	if (it==PoolsById.end()) {
+		PoolsMutex.unlock();
+		throw PoolNotFoundException("id=%i",id);
+	}
+	std::shared_ptr<DBPool> pool=it->second;
+	PoolsById.erase(it);
+	if (pool->Name.notEmpty()) PoolsByName.erase(pool->Name);
+	std::map<String,std::shared_ptr<DBPool> >::iterator hit=PoolsByHash.begin();
+	while (hit!=PoolsByHash.end()) {
+		if (hit->second==pool) hit=PoolsByHash.erase(hit);
+		else ++hit;
+	}
+	PoolsMutex.unlock();
+}
+
+/*!\brief Pool löschen
+ *
+ * \desc
+ * Der Pool mit dem Namen \p name wird gelöscht, siehe DBPoolOfPools::deletePool(int).
+ *
+ * \exception DBPoolOfPools::PoolNotFoundException Pool existiert nicht
+ */
+void DBPoolOfPools::deletePool(const String &name)
+{
+	deletePool(getPool(name)->Id);
+}
+
+/*!\brief Alle Pools löschen
+ */
+void DBPoolOfPools::clear()
+{
+	PoolsMutex.lock();
+	std::map<int,std::shared_ptr<DBPool> > pools;
+	pools.swap(PoolsById);
+	PoolsByName.clear();
+	PoolsByHash.clear();
+	PoolsMutex.unlock();
+}
+
+/*!\brief Pool anhand seiner Id
+ *
+ * \desc
+ * Der zurückgegebene Pointer hält den Pool am Leben, auch wenn er währenddessen mit
+ * DBPoolOfPools::deletePool gelöscht wird.
+ *
+ * \exception DBPoolOfPools::PoolNotFoundException Pool existiert nicht
+ */
+std::shared_ptr<DBPool> DBPoolOfPools::getPool(int id)
+{
+	PoolsMutex.lock();
+	std::map<int,std::shared_ptr<DBPool> >::const_iterator it=PoolsById.find(id);
+	if (it==PoolsById.end()) {
+		PoolsMutex.unlock();
+		throw PoolNotFoundException("id=%i",id);
+	}
+	std::shared_ptr<DBPool> pool=it->second;
+	PoolsMutex.unlock();
+	return pool;
+}
+
+/*!\brief Pool anhand seines Namens
+ *
+ * \copydetails DBPoolOfPools::getPool(int)
+ */
+std::shared_ptr<DBPool> DBPoolOfPools::getPool(const String &name)
+{
+	PoolsMutex.lock();
+	std::map<String,std::shared_ptr<DBPool> >::const_iterator it=PoolsByName.find(name);
+	if (it==PoolsByName.end()) {
+		PoolsMutex.unlock();
+		throw PoolNotFoundException("name=%s",(const char*)name);
+	}
+	std::shared_ptr<DBPool> pool=it->second;
+	PoolsMutex.unlock();
+	return pool;
+}
+
+/*!\brief Pool anhand der Connect-Parameter
+ *
+ * \desc
+ * Liefert den Pool mit den Connect-Parametern \p connect zurück. Existiert noch keiner, wird
+ * ein neuer mit automatisch vergebener Id angelegt. Suchen und Anlegen erfolgen unter
+ * derselben Sperre, so dass pro Connect-Parametern immer nur ein Pool entsteht.
+ */
+std::shared_ptr<DBPool> DBPoolOfPools::getPool(const AssocArray &connect)
+{
+	PoolsMutex.lock();
+	try {
+		std::shared_ptr<DBPool> pool=findPool(connect);
+		if (!pool) pool=createPoolLocked(NextId,"",connect);
+		PoolsMutex.unlock();
+		return pool;
+	} catch (...) {
+		PoolsMutex.unlock();
+		throw;
+	}
+}
+
+/*!\brief Verbindung aus dem Pool mit der Id \p id holen
+ *
+ * \desc
+ * Siehe DBPool::get.
+ */
+Database *DBPoolOfPools::get(int id, bool wait, int ms)
+{
+	return getPool(id)->get(wait,ms);
+}
+
+/*!\brief Verbindung aus dem Pool mit dem Namen \p name holen
+ *
+ * \desc
+ * Siehe DBPool::get.
+ */
+Database *DBPoolOfPools::get(const String &name, bool wait, int ms)
+{
+	return getPool(name)->get(wait,ms);
+}
+
+/*!\brief Verbindung aus dem Pool mit den Connect-Parametern \p connect holen
+ *
+ * \desc
+ * Siehe DBPool::get. Existiert noch kein Pool mit diesen Connect-Parametern, wird er angelegt.
+ */
+Database *DBPoolOfPools::get(const AssocArray &connect, bool wait, int ms)
+{
+	return getPool(connect)->get(wait,ms);
+}
+
+/*!\brief Verbindung an ihren Pool zurückgeben
+ *
+ * \exception NullPointerException \p db ist NULL
+ * \exception DBPool::ForeignConnectionException Die Verbindung stammt nicht aus einem Pool
+ */
+void DBPoolOfPools::release(Database *db)
+{
+	if (!db) throw NullPointerException();
+	if (!db->pool) throw DBPool::ForeignConnectionException();
+	db->pool->release(db);
+}
+
+/*!\brief Verbindung löschen statt sie an ihren Pool zurückzugeben
+ *
+ * \exception NullPointerException \p db ist NULL
+ * \exception DBPool::ForeignConnectionException Die Verbindung stammt nicht aus einem Pool
+ */
+void DBPoolOfPools::destroy(Database *db)
+{
+	if (!db) throw NullPointerException();
+	if (!db->pool) throw DBPool::ForeignConnectionException();
+	db->pool->destroy(db);
+}
+
+/*!\brief DBPool::checkPool für alle Pools aufrufen
+ */
+void DBPoolOfPools::checkPools()
+{
+	std::list<std::shared_ptr<DBPool> > pools;
+	PoolsMutex.lock();
+	std::map<int,std::shared_ptr<DBPool> >::const_iterator it;
+	for (it=PoolsById.begin();it!=PoolsById.end();++it) pools.push_back(it->second);
+	PoolsMutex.unlock();
+	std::list<std::shared_ptr<DBPool> >::iterator pit;
+	for (pit=pools.begin();pit!=pools.end();++pit) {
+		try {
+			(*pit)->checkPool();
+		} catch (const Exception &e) {
+			if (Log) Log->printException(__FILE__,__LINE__,"ppl7::db::DBPoolOfPools","checkPools",e);
+		}
+	}
+}
+
+/*!\brief Status aller Pools
+ *
+ * \desc
+ * Liefert für jeden Pool ein Unter-Array mit der Id als Schlüssel zurück, das von
+ * DBPool::getStatus gefüllt wird.
+ */
+void DBPoolOfPools::getStatus(AssocArray &status)
+{
+	status.clear();
+	PoolsMutex.lock();
+	std::map<int,std::shared_ptr<DBPool> >::const_iterator it;
+	for (it=PoolsById.begin();it!=PoolsById.end();++it) {
+		AssocArray s;
+		it->second->getStatus(s);
+		status.set(ToString("%i",it->first),s);
+	}
+	PoolsMutex.unlock();
+}
+
+/*!\brief Optionen für neue Pools
+ *
+ * \desc
+ * Die Optionen werden an DBPool::setOptions jedes neu angelegten Pools übergeben.
+ */
+void DBPoolOfPools::setDefaultOptions(const AssocArray &options)
+{
+	PoolsMutex.lock();
+	DefaultOptions=options;
+	PoolsMutex.unlock();
+}
+
+/*!\brief Logger für alle Pools setzen
+ */
+void DBPoolOfPools::setLogger(Logger &logger)
+{
+	PoolsMutex.lock();
+	Log=&logger;
+	std::map<int,std::shared_ptr<DBPool> >::iterator it;
+	for (it=PoolsById.begin();it!=PoolsById.end();++it) it->second->setLogger(logger);
+	PoolsMutex.unlock();
+}
+
+/*!\brief Anzahl Pools
+ */
+size_t DBPoolOfPools::count()
+{
+	PoolsMutex.lock();
+	size_t num=PoolsById.size();
+	PoolsMutex.unlock();
+	return num;
+}
+
 
 }	// EOF namespace db
 }	// EOF namespace ppl7
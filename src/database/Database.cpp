@@ -119,13 +119,10 @@ Database* Connect(const AssocArray& params)
 		db=new PostgreSQL;
 	}
 #endif
-#ifdef HAVE_SQLITE
-	throw UnsupportedFeatureException("sqlite");
-	/*
-	if (type=="sqlite") {
+#ifdef HAVE_SQLITE3
+	if (type == "sqlite" || type == "sqlite3") {
 		db=new SQLite;
 	}
-	*/
 #endif
 	if (!db) {
 		throw UnsupportedFeatureException("Database-Type: %s", (const char*)type);
@@ -198,6 +195,10 @@ Database::Database()
 {
 	lastuse=0;
 	lastping=0;
+	pool=NULL;
+	poolversion=0;
+	poolcheckout=0.0;
+	StatementCacheSize=32;
 	Log=NULL;
 }
 
@@ -209,6 +210,7 @@ Database::Database()
 Database::~Database()
 {
 	//close();
+	clearStatementCache();
 	if (Log) Log->print(Logger::DEBUG, 1, "ppl7::db::Database", "SetLogfile", __FILE__, __LINE__, "Stop logging of Database-Queries");
 }
 
@@ -1082,6 +1084,30 @@ ResultSet* Database::query(const String& query)
 	throw UnimplementedVirtualFunctionException("Database::query");
 }
 
+ResultSet* Database::streamQuery(const String& query)
+/*!\brief SQL-Query mit zeilenweise gestreamtem Ergebnis ausführen
+ *
+ * \descr
+ * Wie Database::query, das Ergebnis wird jedoch nicht vollständig in den Speicher geladen, sondern
+ * beim Durchwandern des ResultSets Zeile für Zeile vom Server geholt. Dadurch bleibt der
+ * Speicherverbrauch auch bei sehr großen Ergebnissen konstant. Zusammen mit den typisierten
+ * Funktionen ResultSet::getInt64, ResultSet::getDouble, ResultSet::getView und
+ * ResultSet::fetchColumns können große Ergebnisse ohne Erzeugung von AssocArrays pro Zeile
+ * verarbeitet werden.
+ * \par
+ * Die Standardimplementierung ruft Database::query auf. Das ist für SQLite und PostgreSQL
+ * richtig, da deren ResultSets ohnehin zeilenweise arbeiten. MySQL überschreibt die Funktion
+ * und holt die Zeilen mit \c mysql_use_result einzeln vom Server (siehe MySQL::streamQuery).
+ *
+ * @param[in] query Die gewünschte SQL-Abfrage
+ * @return Pointer auf ein ResultSet, das von der Anwendung mit \c delete gelöscht werden muss.
+ * \attention Solange das ResultSet existiert, dürfen je nach Datenbank keine weiteren Queries
+ * über diese Verbindung ausgeführt werden.
+ */
+{
+	return this->query(query);
+}
+
 bool Database::ping()
 /*!\brief Erreichbarkeit der Datenbank prüfen
  *
@@ -1235,22 +1261,176 @@ String Database::databaseType() const
 	throw UnimplementedVirtualFunctionException("Database::databaseType");
 }
 
-/*
-void Database::prepare(const String &preparedStatementName, const String &query)
+/*!\brief Mehrere Datensätze auf einmal einfügen
+ *
+ * \descr
+ * Fügt alle Zeilen aus \p rows in die Tabelle \p table ein. Jede Zeile muss genau so viele Werte
+ * enthalten wie \p columns Spalten. Die Standard-Implementierung fasst jeweils \p batchsize
+ * Zeilen zu einem INSERT mit mehreren VALUES-Tupeln zusammen und maskiert die Werte mit
+ * Database::getQuoted. Datenbank-spezifische Klassen können schnellere Verfahren verwenden,
+ * z.B. COPY bei PostgreSQL oder vorbereitete Queries innerhalb einer Transaktion bei SQLite.
+ * \par
+ * Für das zeilenweise Sammeln von Datensätzen kann die Klasse BulkWriter verwendet werden.
+ *
+ * @param[in] table Name der Tabelle
+ * @param[in] columns Namen der Spalten
+ * @param[in] rows Liste mit den Zeilen, jede Zeile enthält die Werte in der Reihenfolge von
+ * \p columns
+ * @param[in] batchsize Maximale Anzahl Zeilen pro Query
+ * \exception IllegalArgumentException Keine Spalten angegeben oder eine Zeile hat nicht die
+ * richtige Anzahl Werte. Die Zeilen werden vor dem ersten Query geprüft, es wird dann keine
+ * Zeile eingefügt.
+ * \exception QueryFailedException Der Query ist fehlgeschlagen. Bereits eingefügte Blöcke bleiben
+ * erhalten, sofern der Aufruf nicht innerhalb einer Transaktion erfolgt.
+ */
+void Database::bulkInsert(const String& table, const Array& columns, const std::list<Array>& rows, size_t batchsize)
 {
-	throw UnimplementedVirtualFunctionException("Database::prepare");
+	checkBulkRows(columns, rows);
+	if (batchsize < 1) batchsize=1;
+	String head;
+	head.setf("insert into %s (%s) values ", (const char*)table, (const char*)columns.implode(","));
+	String q;
+	size_t num=0;
+	std::list<Array>::const_iterator it;
+	for (it=rows.begin();it != rows.end();++it) {
+		const Array& row=(*it);
+		if (num == 0) q=head;
+		else q+=",";
+		q+="(";
+		for (size_t i=0;i < row.size();i++) {
+			if (i > 0) q+=",";
+			q+=getQuoted(row[i]);
+		}
+		q+=")";
+		num++;
+		if (num >= batchsize) {
+			exec(q);
+			num=0;
+		}
+	}
+	if (num > 0) exec(q);
 }
 
-ResultSet *Database::execute(const String &preparedStatementName, const Array &params)
+/*!\brief Zeilen für Database::bulkInsert prüfen
+ *
+ * \descr
+ * Prüft vor dem Einfügen, ob Spalten angegeben sind und jede Zeile in \p rows genau so viele
+ * Werte enthält wie \p columns Spalten, damit bei einer fehlerhaften Zeile nicht bereits ein
+ * Teil der Daten eingefügt ist.
+ *
+ * \exception IllegalArgumentException Keine Spalten angegeben oder eine Zeile hat nicht die
+ * richtige Anzahl Werte
+ */
+void Database::checkBulkRows(const Array& columns, const std::list<Array>& rows)
 {
-	throw UnimplementedVirtualFunctionException("Database::execute");
+	if (columns.size() == 0) throw IllegalArgumentException("bulkInsert: no columns");
+	std::list<Array>::const_iterator it;
+	for (it=rows.begin();it != rows.end();++it) {
+		if ((*it).size() != columns.size()) throw IllegalArgumentException("bulkInsert: row has %zu values, expected %zu", (*it).size(), columns.size());
+	}
 }
 
-void Database::deallocate(const String &preparedStatementName)
+/*!\brief Interne Funktion zum Erzeugen eines vorbereiteten Queries
+ *
+ * \descr
+ * Diese Funktion wird von Database::prepare aufgerufen, wenn sich der Query noch nicht im
+ * Statement-Cache befindet. Sie muss von der Datenbank-spezifischen Klasse implementiert werden.
+ *
+ * @param[in] query Der vorzubereitende Query
+ * @return Pointer auf ein neues Statement
+ */
+Statement* Database::createStatement(const String& query)
 {
-	throw UnimplementedVirtualFunctionException("Database::deallocate");
+	throw UnimplementedVirtualFunctionException("Database::createStatement");
+}
+
+/*!\brief Query vorbereiten
+ *
+ * \descr
+ * Der Query \p query wird vom Datenbank-Server geparst und als Statement zurückgegeben, das
+ * anschließend beliebig oft mit unterschiedlichen Werten für die Platzhalter ausgeführt werden
+ * kann (siehe Statement). Die Statements werden in einem Cache vorgehalten, der nach dem
+ * Query-Text sortiert ist. Wurde der gleiche Query bereits vorbereitet, wird das vorhandene
+ * Statement zurückgegeben. Ist der Cache voll, wird das am längsten nicht mehr verwendete
+ * Statement aus dem Cache entfernt. Es wird erst gelöscht, wenn die Anwendung ihren Pointer
+ * darauf ebenfalls freigegeben hat.
+ * \note Vorbereitete Queries werden derzeit nur von Sqlite3 unterstützt.
+ *
+ * @param[in] query Der Query mit Platzhaltern (\c ?)
+ * @return Shared-Pointer auf das Statement. Es bleibt gültig, solange die Anwendung den Pointer
+ * hält und die Verbindung nicht geschlossen wird.
+ * \exception QueryFailedException Der Query konnte nicht vorbereitet werden
+ * \exception UnimplementedVirtualFunctionException Die Datenbank unterstützt keine vorbereiteten
+ * Queries
+ */
+std::shared_ptr<Statement> Database::prepare(const String& query)
+{
+	std::map<String, std::list<std::shared_ptr<Statement> >::iterator>::iterator it=StatementCache.find(query);
+	if (it != StatementCache.end()) {
+		if (it->second != StatementLRU.begin()) {
+			StatementLRU.splice(StatementLRU.begin(), StatementLRU, it->second);
+		}
+		return StatementLRU.front();
+	}
+	std::shared_ptr<Statement> stmt(createStatement(query));
+	StatementLRU.push_front(stmt);
+	StatementCache[query]=StatementLRU.begin();
+	while (StatementCacheSize > 0 && StatementLRU.size() > StatementCacheSize) {
+		StatementCache.erase(StatementLRU.back()->querystring);
+		StatementLRU.pop_back();
+	}
+	return stmt;
+}
+
+/*!\brief Größe des Statement-Caches festlegen
+ *
+ * \descr
+ * Legt fest, wie viele vorbereitete Queries die Verbindung maximal vorhält (Default: 32).
+ * Bei 0 ist der Cache unbegrenzt. Überzählige Statements werden sofort aus dem Cache entfernt.
+ *
+ * @param[in] size Maximale Anzahl Statements
+ */
+void Database::setStatementCacheSize(size_t size)
+{
+	StatementCacheSize=size;
+	while (StatementCacheSize > 0 && StatementLRU.size() > StatementCacheSize) {
+		StatementCache.erase(StatementLRU.back()->querystring);
+		StatementLRU.pop_back();
+	}
+}
+
+/*!\brief Größe des Statement-Caches
+ */
+size_t Database::statementCacheSize() const
+{
+	return StatementCacheSize;
+}
+
+/*!\brief Anzahl vorbereiteter Queries im Statement-Cache
+ */
+size_t Database::cachedStatements() const
+{
+	return StatementLRU.size();
+}
+
+/*!\brief Statement-Cache leeren
+ *
+ * \descr
+ * Alle vorbereiteten Queries werden aus dem Cache entfernt. Statements, die von der Anwendung
+ * noch gehalten werden, werden von der Verbindung getrennt und werfen bei weiterer Verwendung
+ * eine NoConnectionException. Die Funktion muss von der Datenbank-spezifischen Klasse
+ * aufgerufen werden, bevor die Verbindung geschlossen wird.
+ */
+void Database::clearStatementCache()
+{
+	StatementCache.clear();
+	StatementLRU.clear();
+	std::set<Statement*>::iterator it;
+	for (it=Statements.begin();it != Statements.end();++it) {
+		(*it)->close();
+	}
+	Statements.clear();
 }
-*/
 
 }	// EOF namespace db
 }	// EOF namespace ppl7
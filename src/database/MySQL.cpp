@@ -87,6 +87,9 @@ private:
 	MySQL* mysql_class;	//!\brief Die ppl7::db::MySQL-Klasse, die das Result erzeugt hat
 	uint64_t	affectedrows;	//!\brief Falls es sich um ein Update/Insert/Replace handelte, steht hier die Anzahl betroffender Datensätze
 	int			num_fields;		//!\brief Anzahl Spalten im Ergebnis
+	bool		streaming;		//!\brief Das Ergebnis wurde mit mysql_use_result angefordert und wird zeilenweise vom Server geholt
+
+	void fetchRow();
 
 public:
 	MySQLResult();
@@ -117,6 +120,7 @@ MySQLResult::MySQLResult()
 	conn=NULL;
 	affectedrows=0;
 	num_fields=0;
+	streaming=false;
 }
 
 MySQLResult::~MySQLResult()
@@ -133,6 +137,24 @@ void MySQLResult::clear()
 	conn=NULL;
 	affectedrows=0;
 	num_fields=0;
+	streaming=false;
+}
+
+/*!\brief Nächste Zeile holen
+ *
+ * \descr
+ * Bei einem gestreamten Ergebnis wird die Zeile erst jetzt vom Server geholt. Liefert
+ * \c mysql_fetch_row dabei NULL, muss zwischen dem Ende des Ergebnisses und einem Fehler, z.B.
+ * einem Verbindungsabbruch, unterschieden werden.
+ *
+ * \exception QueryFailedException Beim Holen der Zeile ist ein Fehler aufgetreten
+ */
+void MySQLResult::fetchRow()
+{
+	row=mysql_fetch_row(res);
+	if (row == NULL && streaming && mysql_errno(conn) != 0) {
+		throw QueryFailedException("MySQL-Error: %u, %s", mysql_errno(conn), mysql_error(conn));
+	}
 }
 
 uint64_t MySQLResult::affected() const
@@ -292,7 +314,7 @@ void MySQLResult::fetchArray(AssocArray& array)
 		else array.set(String(fields[i].name), String(""));
 	}
 	// Nächste Zeile holen
-	row=mysql_fetch_row(res);
+	fetchRow();
 }
 
 String MySQLResult::getString(const String& fieldname)
@@ -334,7 +356,7 @@ void MySQLResult::fetchFields(Array& array)
 		else array.add(String(""));
 	}
 	// Nächste Zeile holen
-	row=mysql_fetch_row(res);
+	fetchRow();
 }
 
 void MySQLResult::nextRow()
@@ -342,7 +364,7 @@ void MySQLResult::nextRow()
 	if (!res) throw NoResultException();
 	if (!row) throw NoResultException();
 	pplMySQLThreadStart();
-	row=mysql_fetch_row(res);
+	fetchRow();
 }
 
 bool MySQLResult::eof()
@@ -674,6 +696,54 @@ ResultSet* MySQL::query(const String& query)
 #endif
 }
 
+/*!\brief SQL-Query mit zeilenweise gestreamtem Ergebnis ausführen
+ *
+ * \descr
+ * Im Gegensatz zu MySQL::query wird das Ergebnis mit \c mysql_use_result angefordert. Die
+ * Zeilen werden daher nicht vollständig in den Speicher des Clients geladen, sondern erst beim
+ * Durchwandern des ResultSets einzeln vom Server geholt.
+ * \attention Solange das ResultSet existiert, dürfen über diese Verbindung keine weiteren
+ * Queries ausgeführt werden. Beim Löschen des ResultSets werden noch nicht gelesene Zeilen
+ * vom Server abgeholt und verworfen.
+ *
+ * \copydetails Database::streamQuery
+ */
+ResultSet* MySQL::streamQuery(const String& query)
+{
+#ifndef HAVE_MYSQL
+	throw UnsupportedFeatureException("MySQL");
+#else
+	if (!conn) throw NoConnectionException();
+	pplMySQLThreadStart();
+	double t_start;
+	affectedrows=0;
+	t_start=GetMicrotime();
+	mysqlQuery(query);
+	updateLastUse();
+	MYSQL_RES* res = mysql_use_result((MYSQL*)conn);
+	logQuery(query, (float)(GetMicrotime() - t_start));
+	if (!res) {
+		if (mysql_errno((MYSQL*)conn) != 0) {
+			throw QueryFailedException("MySQL-Error: %u, %s", mysql_errno((MYSQL*)conn), mysql_error((MYSQL*)conn));
+		}
+		throw NoResultException(query);
+	}
+	MySQLResult* pr=new MySQLResult;
+	pr->res=res;
+	pr->mysql_class=this;
+	pr->conn=(MYSQL*)conn;
+	pr->streaming=true;
+	pr->num_fields=mysql_num_fields(res);
+	try {
+		pr->fetchRow();
+	} catch (...) {
+		delete pr;
+		throw;
+	}
+	return pr;
+#endif
+}
+
 bool MySQL::ping()
 {
 #ifndef HAVE_MYSQL
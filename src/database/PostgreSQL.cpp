@@ -65,6 +65,13 @@ private:
 	PostgreSQL* postgres_class;	//!\brief Die ppl7::db::MySQL-Klasse, die das Result erzeugt hat
 	uint64_t	affectedrows;	//!\brief Falls es sich um ein Update/Insert/Replace handelte, steht hier die Anzahl betroffender Datensätze
 	int			num_fields;		//!\brief Anzahl Spalten im Ergebnis
+	int			row;			//!\brief Aktuelle Zeile innerhalb von \c res
+	int			tuples;			//!\brief Anzahl Zeilen in \c res
+
+	void setResult(PGresult* res);
+	void fetchRow();
+	void checkRow();
+	void checkField(int field);
 
 public:
 	Postgres92Result();
@@ -84,6 +91,8 @@ public:
 	virtual void		fetchFields(Array& array);
 	virtual void		nextRow();
 	virtual bool		eof();
+	virtual bool		isNull(int field);
+	virtual StringView	getView(int field);
 };
 
 
@@ -94,6 +103,8 @@ Postgres92Result::Postgres92Result()
 	conn=NULL;
 	affectedrows=0;
 	num_fields=0;
+	row=0;
+	tuples=0;
 }
 
 Postgres92Result::~Postgres92Result()
@@ -114,6 +125,58 @@ void Postgres92Result::clear()
 	conn=NULL;
 	affectedrows=0;
 	num_fields=0;
+	row=0;
+	tuples=0;
+}
+
+/*!\brief Neues Result-Handle übernehmen
+ *
+ * \descr
+ * Im Single-Row-Modus enthält jedes Handle genau eine Zeile, im Chunked-Modus mehrere. Das
+ * letzte Handle eines Queries hat keine Zeilen mehr.
+ */
+void Postgres92Result::setResult(PGresult* res)
+{
+	this->res=res;
+	row=0;
+	tuples=res ? PQntuples(res) : 0;
+}
+
+/*!\brief Nächste Zeile laden
+ *
+ * \descr
+ * Rückt innerhalb des aktuellen Handles vor und holt erst dann das nächste Handle vom Server,
+ * wenn alle darin enthaltenen Zeilen gelesen wurden. Ein Fehler mitten im Ergebnis wird als
+ * QueryFailedException weitergereicht.
+ */
+void Postgres92Result::fetchRow()
+{
+	row++;
+	if (row < tuples) return;
+	PQclear(res);
+	setResult(PQgetResult(conn));
+	if (res && PQresultStatus(res) == PGRES_FATAL_ERROR) {
+		String err;
+		err.setf("%s", PQresultErrorMessage(res));
+		clear();
+		throw QueryFailedException(err);
+	}
+}
+
+void Postgres92Result::checkRow()
+{
+	if (!res) throw NoResultException();
+	if (row >= tuples) {
+		PQclear(res);
+		setResult(NULL);
+		throw NoResultException();
+	}
+}
+
+void Postgres92Result::checkField(int field)
+{
+	checkRow();
+	if (field < 0 || field >= num_fields) throw FieldNotInResultSetException("%d", field);
 }
 
 
@@ -149,9 +212,25 @@ String Postgres92Result::fieldName(int field)
 
 ResultSet::FieldType Postgres92Result::fieldType(int field)
 {
-	if (field > num_fields) throw FieldNotInResultSetException("%d", field);
+	if (!res) throw NoResultException();
+	if (field < 0 || field >= num_fields) throw FieldNotInResultSetException("%d", field);
+	// Die OIDs der eingebauten Typen sind fest, siehe pg_type.dat
 	Oid o=PQftype(res, field);
 	switch (o) {
+	case 16: return ResultSet::TYPE_BOOLEAN;	// bool
+	case 17: return ResultSet::TYPE_BINARY;		// bytea
+	case 20: return ResultSet::TYPE_LONGINTEGER;	// int8
+	case 21:									// int2
+	case 23: return ResultSet::TYPE_INTEGER;	// int4
+	case 700: return ResultSet::TYPE_FLOAT;		// float4
+	case 701: return ResultSet::TYPE_DOUBLE;	// float8
+	case 18:									// char
+	case 25:									// text
+	case 1042:									// bpchar
+	case 1043: return ResultSet::TYPE_STRING;	// varchar
+	case 1082:									// date
+	case 1114:									// timestamp
+	case 1184: return ResultSet::TYPE_DATETIME;	// timestamptz
 	default:
 		return ResultSet::TYPE_UNKNOWN;
 	}
@@ -173,18 +252,12 @@ AssocArray Postgres92Result::fetchArray()
 
 void Postgres92Result::fetchArray(AssocArray& array)
 {
-	if (!res) throw NoResultException();
-	if (PQntuples(res) == 0) {
-		PQclear(res);
-		res=NULL;
-		throw NoResultException();
-	}
+	checkRow();
 	array.clear();
 	for (int i=0; i < num_fields; i++) {
-		array.set(String(PQfname(res, i)), String(PQgetvalue(res, 0, i)));
+		array.set(String(PQfname(res, i)), String(PQgetvalue(res, row, i)));
 	}
-	PQclear(res);
-	res=PQgetResult(conn);
+	fetchRow();
 }
 
 
@@ -196,14 +269,8 @@ String Postgres92Result::getString(const String& fieldname)
 
 String Postgres92Result::getString(int field)
 {
-	if (!res) throw NoResultException();
-	if (PQntuples(res) == 0) {
-		PQclear(res);
-		res=NULL;
-		throw NoResultException();
-	}
-	if (field > num_fields) throw FieldNotInResultSetException("%d", field);
-	return String(PQgetvalue(res, 0, field));
+	checkField(field);
+	return String(PQgetvalue(res, row, field));
 }
 
 
@@ -218,43 +285,43 @@ Array Postgres92Result::fetchFields()
 
 void Postgres92Result::fetchFields(Array& array)
 {
-	if (!res) throw NoResultException();
-	if (PQntuples(res) == 0) {
-		PQclear(res);
-		res=NULL;
-		throw NoResultException();
-	}
+	checkRow();
 	array.clear();
 	const char* tmp;
 	for (int i=0; i < num_fields; i++) {
-		tmp=PQgetvalue(res, 0, i);
+		tmp=PQgetvalue(res, row, i);
 		if (tmp) array.add(tmp);
 		else array.add("");
 	}
-	PQclear(res);
-	res=PQgetResult(conn);
+	fetchRow();
 }
 
 void Postgres92Result::nextRow()
 {
-	if (!res) throw NoResultException();
-	if (PQntuples(res) == 0) {
-		PQclear(res);
-		res=NULL;
-		throw NoResultException();
-	}
-	PQclear(res);
-	res=PQgetResult(conn);
+	checkRow();
+	fetchRow();
 }
 
 bool Postgres92Result::eof()
 {
 	if (res) {
-		if (PQntuples(res) > 0) return false;
+		if (row < tuples) return false;
 	}
 	return true;
 }
 
+bool Postgres92Result::isNull(int field)
+{
+	checkField(field);
+	return PQgetisnull(res, row, field) == 1;
+}
+
+StringView Postgres92Result::getView(int field)
+{
+	checkField(field);
+	return StringView(PQgetvalue(res, row, field), PQgetlength(res, row, field));
+}
+
 #endif	// HAVE_POSTGRESQL
 
 /*!\class PostgreSQL
@@ -479,16 +546,29 @@ void* PostgreSQL::pgsqlQuery(const String& query)
 		if (PQsendQuery((PGconn*)conn, (const char*)query) != 1) {
 			throw QueryFailedException("PQsendQuery failed: %s", PQerrorMessage((PGconn*)conn));
 		} else {
+#ifdef LIBPQ_HAS_CHUNK_MODE
+			// Ab libpq 17 werden die Zeilen in Blöcken geliefert, das spart pro Zeile ein PGresult
+			if (PQsetChunkedRowsMode((PGconn*)conn, 256) != 1) {
+				ppl7::String err;
+				err.setf("PQsetChunkedRowsMode failed: %s", PQerrorMessage((PGconn*)conn));
+				if (res) PQclear(res);
+				throw QueryFailedException(err);
+			}
+#else
 			if (PQsetSingleRowMode((PGconn*)conn) != 1) {
 				ppl7::String err;
 				err.setf("PQsetSingleRowMode failed: %s", PQerrorMessage((PGconn*)conn));
 				if (res) PQclear(res);
 				throw QueryFailedException(err);
 			}
+#endif
 			res=PQgetResult((PGconn*)conn);
 			status=PQresultStatus(res);
 			if (status == PGRES_COMMAND_OK
 				|| status == PGRES_SINGLE_TUPLE
+#ifdef LIBPQ_HAS_CHUNK_MODE
+				|| status == PGRES_TUPLES_CHUNK
+#endif
 				|| status == PGRES_TUPLES_OK) {
 				affectedrows=atoll(PQcmdTuples(res));
 				return res;
@@ -563,7 +643,7 @@ ResultSet* PostgreSQL::query(const String& query)
 		PQclear(res);
 		throw OutOfMemoryException();
 	}
-	pr->res=res;
+	pr->setResult(res);
 	pr->postgres_class=this;
 	pr->conn=(PGconn*)conn;
 	//pr->result_rows=PQntuples(res);
@@ -574,6 +654,105 @@ ResultSet* PostgreSQL::query(const String& query)
 }
 
 
+/*!\brief Wert für das Text-Format von COPY maskieren
+ */
+static void appendCopyValue(String& buffer, const String& value)
+{
+	const char* p=value.c_str();
+	size_t len=value.size();
+	size_t start=0;
+	for (size_t i=0;i < len;i++) {
+		const char* esc;
+		switch (p[i]) {
+		case '\\': esc="\\\\"; break;
+		case '\t': esc="\\t"; break;
+		case '\n': esc="\\n"; break;
+		case '\r': esc="\\r"; break;
+		default: continue;
+		}
+		if (i > start) buffer.append(p + start, i - start);
+		buffer.append(esc, 2);
+		start=i + 1;
+	}
+	if (len > start) buffer.append(p + start, len - start);
+}
+
+/*!\brief Mehrere Datensätze auf einmal einfügen
+ *
+ * \descr
+ * Die PostgreSQL-Implementierung von Database::bulkInsert verwendet
+ * <tt>COPY table (columns) FROM STDIN</tt> und überträgt jeweils \p batchsize Zeilen im
+ * Text-Format mit einem einzigen COPY-Befehl. Das ist deutlich schneller als einzelne INSERTs,
+ * da der Server keine Queries parsen muss.
+ *
+ * \copydetails Database::bulkInsert
+ */
+void PostgreSQL::bulkInsert(const String& table, const Array& columns, const std::list<Array>& rows, size_t batchsize)
+{
+#ifndef HAVE_POSTGRESQL
+	throw UnsupportedFeatureException("PostgreSQL");
+#else
+	if (!conn) throw NoConnectionException();
+	checkBulkRows(columns, rows);
+	if (batchsize < 1) batchsize=1;
+	String q;
+	q.setf("COPY %s (%s) FROM STDIN", (const char*)table, (const char*)columns.implode(","));
+	std::list<Array>::const_iterator it=rows.begin();
+	affectedrows=0;
+	uint64_t total=0;
+	while (it != rows.end()) {
+		double t_start=GetMicrotime();
+		PGresult* res=PQexec((PGconn*)conn, (const char*)q);
+		if (PQresultStatus(res) != PGRES_COPY_IN) {
+			String err;
+			err.setf("%s, Query: %s", PQresultErrorMessage(res), (const char*)q);
+			PQclear(res);
+			throw QueryFailedException(err);
+		}
+		PQclear(res);
+		String buffer;
+		String error;
+		size_t num=0;
+		for (;it != rows.end() && num < batchsize;++it, num++) {
+			const Array& row=(*it);
+			for (size_t i=0;i < row.size();i++) {
+				if (i > 0) buffer.append("\t", 1);
+				appendCopyValue(buffer, row[i]);
+			}
+			buffer.append("\n", 1);
+			if (buffer.size() >= 65536) {
+				if (PQputCopyData((PGconn*)conn, buffer.c_str(), (int)buffer.size()) != 1) {
+					error.setf("PQputCopyData failed: %s", PQerrorMessage((PGconn*)conn));
+					break;
+				}
+				buffer.clear();
+			}
+		}
+		if (error.isEmpty() && buffer.notEmpty()) {
+			if (PQputCopyData((PGconn*)conn, buffer.c_str(), (int)buffer.size()) != 1) {
+				error.setf("PQputCopyData failed: %s", PQerrorMessage((PGconn*)conn));
+			}
+		}
+		// Bei einem Fehler wird COPY abgebrochen, der Server verwirft dann alle Zeilen des Blocks
+		if (PQputCopyEnd((PGconn*)conn, error.notEmpty() ? (const char*)error : NULL) != 1 && error.isEmpty()) {
+			error.setf("PQputCopyEnd failed: %s", PQerrorMessage((PGconn*)conn));
+		}
+		while ((res=PQgetResult((PGconn*)conn)) != NULL) {
+			if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+				total+=atoll(PQcmdTuples(res));
+			} else if (error.isEmpty()) {
+				error.setf("%s", PQresultErrorMessage(res));
+			}
+			PQclear(res);
+		}
+		if (error.notEmpty()) throw QueryFailedException(error);
+		updateLastUse();
+		logQuery(q, (float)(GetMicrotime() - t_start));
+	}
+	affectedrows=total;
+#endif
+}
+
 bool PostgreSQL::ping()
 {
 #ifndef HAVE_POSTGRESQL
@@ -353,6 +353,216 @@ namespace db {
  * \return \p true = weitere Ergebniszeile steht bereit, \p false = keine weitere Zeilen vorhanden.
  */
 
+/*!\brief Wert eines Feldes ohne Kopie auslesen
+ *
+ * \descr
+ * Liefert den Wert des Feldes in Spalte \p field der aktuellen Ergebniszeile als StringView
+ * zurück. Im Gegensatz zu ResultSet::getString wird dabei kein Speicher allokiert, der View
+ * zeigt direkt in den Puffer des Datenbank-Treibers. Die Basisimplementierung holt den Wert
+ * mit ResultSet::getString und hält ihn in einem Puffer des ResultSets vor, Datenbank-Treiber
+ * ohne eigene Implementierung funktionieren daher ebenfalls, allerdings mit Kopie.
+ *
+ * @param[in] field Die Nummer der auszulesenden Spalte
+ * @return StringView auf den Wert des Feldes. Bei einem NULL-Wert ist der View leer.
+ * @exception NoResultException Wird geworfen, wenn keine Zeile mehr vorhanden ist
+ * @exception FieldNotInResultSetException Wird geworfen, wenn die Spalte nicht vorhanden ist.
+ * \attention Der View ist nur so lange gültig, bis mit ResultSet::nextRow, ResultSet::fetchArray
+ * oder ResultSet::fetchFields die nächste Zeile geladen, ein anderes Feld mit getView gelesen
+ * oder das ResultSet gelöscht wird.
+ */
+StringView ResultSet::getView(int field)
+{
+	ViewBuffer=getString(field);
+	return StringView(ViewBuffer.c_str(), ViewBuffer.size());
+}
+
+/*!\brief Prüfen, ob ein Feld NULL ist
+ *
+ * \descr
+ * Liefert \c true zurück, wenn das Feld in Spalte \p field der aktuellen Ergebniszeile
+ * den Wert NULL hat. Die Basisimplementierung kennt keine NULL-Werte und liefert immer
+ * \c false, die Datenbank-Treiber überschreiben die Funktion.
+ *
+ * @param[in] field Die Nummer der Spalte
+ * @return \c true, wenn der Wert NULL ist, sonst \c false
+ */
+bool ResultSet::isNull(int field)
+{
+	getView(field);
+	return false;
+}
+
+/*!\brief Feld als 64-Bit Integer auslesen
+ *
+ * \descr
+ * Liefert den Wert des Feldes in Spalte \p field der aktuellen Ergebniszeile als 64-Bit
+ * Integer zurück, ohne dafür einen String zu erzeugen. NULL-Werte und nicht-numerische
+ * Werte ergeben 0.
+ *
+ * @param[in] field Die Nummer der Spalte
+ * @return Wert des Feldes
+ * @exception NoResultException Wird geworfen, wenn keine Zeile mehr vorhanden ist
+ * @exception FieldNotInResultSetException Wird geworfen, wenn die Spalte nicht vorhanden ist.
+ */
+int64_t ResultSet::getInt64(int field)
+{
+	return getView(field).toInt64();
+}
+
+/*!\brief Feld als Fließkommazahl auslesen
+ *
+ * \descr
+ * Liefert den Wert des Feldes in Spalte \p field der aktuellen Ergebniszeile als \c double
+ * zurück, ohne dafür einen String zu erzeugen. NULL-Werte und nicht-numerische Werte
+ * ergeben 0.
+ *
+ * @param[in] field Die Nummer der Spalte
+ * @return Wert des Feldes
+ * @exception NoResultException Wird geworfen, wenn keine Zeile mehr vorhanden ist
+ * @exception FieldNotInResultSetException Wird geworfen, wenn die Spalte nicht vorhanden ist.
+ */
+double ResultSet::getDouble(int field)
+{
+	return getView(field).toDouble();
+}
+
+/*!\brief Mehrere Zeilen spaltenweise auslesen
+ *
+ * \descr
+ * Liest bis zu \p maxrows Zeilen ab der aktuellen Position und legt sie spaltenweise in
+ * \p columns ab. Zahlen werden dabei direkt in die typisierten Vektoren von ResultColumn
+ * geschrieben, alle anderen Werte hintereinander in einen gemeinsamen Puffer, so dass pro
+ * Zeile keine Objekte erzeugt werden müssen. Die Funktion kann wiederholt aufgerufen
+ * werden, bis sie 0 zurückliefert; der Speicher der Spalten wird dabei wiederverwendet.
+ * \par
+ * Stimmt die Anzahl Spalten in \p columns nicht mit dem Ergebnis überein, werden sie neu
+ * angelegt und ihr Typ anhand von ResultSet::fieldType bestimmt. Andernfalls bleiben die
+ * vorhandenen Typen erhalten, so dass die Anwendung sie auch selbst vorgeben kann.
+ *
+ * @param[in,out] columns Vektor, der die Spalten aufnimmt. Vorhandene Werte werden gelöscht.
+ * @param[in] maxrows Maximale Anzahl Zeilen
+ * @return Anzahl gelesener Zeilen, 0 wenn keine weiteren Zeilen vorhanden sind.
+ */
+size_t ResultSet::fetchColumns(std::vector<ResultColumn>& columns, size_t maxrows)
+{
+	int num=fields();
+	if (columns.size() != (size_t)num) {
+		columns.clear();
+		for (int i=0;i < num;i++) {
+			FieldType type=eof() ? TYPE_STRING : fieldType(i);
+			columns.push_back(ResultColumn(type));
+		}
+	}
+	for (int i=0;i < num;i++) columns[i].clear();
+	size_t count=0;
+	while (count < maxrows && !eof()) {
+		for (int i=0;i < num;i++) {
+			ResultColumn& c=columns[i];
+			bool null=isNull(i);
+			c.nulls.push_back(null);
+			switch (c.type) {
+			case TYPE_INTEGER:
+			case TYPE_LONGINTEGER:
+				c.integers.push_back(null ? 0 : getInt64(i));
+				break;
+			case TYPE_BOOLEAN:
+				c.integers.push_back(null ? 0 : getView(i).toBool());
+				break;
+			case TYPE_FLOAT:
+			case TYPE_DOUBLE:
+				c.doubles.push_back(null ? 0.0 : getDouble(i));
+				break;
+			default:
+				if (!null) {
+					StringView value=getView(i);
+					c.data.append(value.data(), value.size());
+				}
+				c.offsets.push_back(c.data.size());
+				break;
+			}
+		}
+		nextRow();
+		count++;
+	}
+	return count;
+}
+
+
+/*!\class ResultColumn
+ * \ingroup PPLGroupDatabases
+ * \brief Spalte eines ResultSets
+ *
+ * \header \#include <ppl7-db.h>
+ *
+ * \descr
+ * Nimmt die Werte einer Spalte aus mehreren Ergebniszeilen auf und wird von
+ * ResultSet::fetchColumns befüllt. Abhängig von \c type landen die Werte in \c integers
+ * (Integer und Boolean), in \c doubles (Fließkommazahlen) oder hintereinander in \c data,
+ * wobei \c offsets für jede Zeile das Ende des Wertes enthält. In \c nulls steht für jede
+ * Zeile, ob der Wert NULL war.
+ */
+
+/*!\brief Konstruktor
+ *
+ * @param[in] type Datentyp der Spalte
+ */
+ResultColumn::ResultColumn(ResultSet::FieldType type)
+{
+	this->type=type;
+	offsets.push_back(0);
+}
+
+/*!\brief Werte löschen
+ *
+ * \descr
+ * Löscht alle Werte, der allokierte Speicher bleibt für die Wiederverwendung erhalten.
+ */
+void ResultColumn::clear()
+{
+	integers.clear();
+	doubles.clear();
+	offsets.resize(1);
+	offsets[0]=0;
+	data.clear();
+	nulls.clear();
+}
+
+/*!\brief Anzahl Zeilen
+ */
+size_t ResultColumn::rows() const
+{
+	return nulls.size();
+}
+
+/*!\brief Prüfen, ob der Wert einer Zeile NULL ist
+ *
+ * @param[in] row Nummer der Zeile
+ * @exception OutOfBoundsException Wird geworfen, wenn die Zeile nicht vorhanden ist
+ */
+bool ResultColumn::isNull(size_t row) const
+{
+	if (row >= nulls.size()) throw OutOfBoundsException();
+	return nulls[row];
+}
+
+/*!\brief Wert einer Zeile als StringView
+ *
+ * \descr
+ * Liefert den Wert der Zeile \p row zurück. Bei Spalten vom Typ String oder Binär zeigt der View
+ * in den Puffer \c data und bleibt bis zum nächsten Aufruf von ResultSet::fetchColumns gültig.
+ * Für numerische Spalten ist der View leer, die Werte stehen in \c integers bzw. \c doubles.
+ *
+ * @param[in] row Nummer der Zeile
+ * @exception OutOfBoundsException Wird geworfen, wenn die Zeile nicht vorhanden ist
+ */
+StringView ResultColumn::getView(size_t row) const
+{
+	if (row >= nulls.size()) throw OutOfBoundsException();
+	if (row + 1 >= offsets.size()) return StringView();
+	return StringView(data.data() + offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+
 /*!\brief Result als Liste mit assoziativen Arrays exportieren
  *
  * \descr
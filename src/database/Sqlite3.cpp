@@ -56,9 +56,12 @@ namespace db {
 
 #ifdef HAVE_SQLITE3
 
+class SQLiteStatement;
+
 class SQLiteResult : public ResultSet
 {
 	friend class SQLite;
+	friend class SQLiteStatement;
 private:
 	sqlite3* conn;		//!\brief SQLite-spezifisches Handle des Datenbank-Connects
 	sqlite3_stmt* stmt;		//!\brief SQLite-spezifisches Result-Handle
@@ -66,6 +69,7 @@ private:
 	uint64_t	affectedrows;	//!\brief Falls es sich um ein Update/Insert/Replace handelte, steht hier die Anzahl betroffender Datensätze
 	int			num_fields;		//!\brief Anzahl Spalten im Ergebnis
 	int			last_res;		//!\brief letzter Returncode von sqlite3_step()
+	SQLiteStatement* statement;	//!\brief Vorbereiteter Query, zu dem \c stmt gehört, oder NULL
 
 public:
 	SQLiteResult();
@@ -85,6 +89,10 @@ public:
 	virtual void		fetchFields(Array& array);
 	virtual void		nextRow();
 	virtual bool		eof();
+	virtual bool		isNull(int field);
+	virtual int64_t		getInt64(int field);
+	virtual double		getDouble(int field);
+	virtual StringView	getView(int field);
 };
 
 /*!\class SQLiteResult
@@ -109,6 +117,7 @@ SQLiteResult::SQLiteResult()
 	affectedrows=0;
 	num_fields=0;
 	last_res=0;
+	statement=NULL;
 }
 
 SQLiteResult::~SQLiteResult()
@@ -116,10 +125,51 @@ SQLiteResult::~SQLiteResult()
 	clear();
 }
 
+class SQLiteStatement : public Statement
+{
+	friend class SQLiteResult;
+private:
+	sqlite3* conn;			//!\brief SQLite-spezifisches Handle des Datenbank-Connects
+	sqlite3_stmt* stmt;		//!\brief Der vorbereitete Query
+	SQLiteResult* result;	//!\brief Noch offenes Ergebnis des letzten Aufrufs von query()
+	uint64_t affectedrows;	//!\brief Anzahl betroffener Datensätze der letzten Ausführung
+
+	void reset();
+	void checkBind(int ret, int index);
+	int step();
+
+protected:
+	virtual void close();
+
+public:
+	SQLiteStatement(SQLite& db, sqlite3* conn, const String& query);
+	virtual ~SQLiteStatement();
+	using Statement::bind;
+	virtual int params() const;
+	virtual void bindNull(int index);
+	virtual void bind(int index, int64_t value);
+	virtual void bind(int index, double value);
+	virtual void bind(int index, const String& value);
+	virtual void bind(int index, const ByteArrayPtr& value);
+	virtual void clearBindings();
+	virtual void exec();
+	virtual ResultSet* query();
+	virtual uint64_t affected() const;
+};
+
 void SQLiteResult::clear()
 {
-	if (stmt) sqlite3_finalize(stmt);
+	if (stmt) {
+		// Ein vorbereiteter Query gehört dem Statement und wird nur zurückgesetzt
+		if (statement) {
+			sqlite3_reset(stmt);
+			statement->result=NULL;
+		} else {
+			sqlite3_finalize(stmt);
+		}
+	}
 	stmt=NULL;
+	statement=NULL;
 	sqlite_class=NULL;
 	conn=NULL;
 	affectedrows=0;
@@ -254,6 +304,197 @@ bool SQLiteResult::eof()
 	return true;
 }
 
+bool SQLiteResult::isNull(int field)
+{
+	if (!stmt) throw NoResultException();
+	if (last_res != SQLITE_ROW) throw NoResultException();
+	if (field < 0 || field >= num_fields) throw FieldNotInResultSetException("%d", field);
+	return sqlite3_column_type(stmt, field) == SQLITE_NULL;
+}
+
+int64_t SQLiteResult::getInt64(int field)
+{
+	if (!stmt) throw NoResultException();
+	if (last_res != SQLITE_ROW) throw NoResultException();
+	if (field < 0 || field >= num_fields) throw FieldNotInResultSetException("%d", field);
+	return (int64_t)sqlite3_column_int64(stmt, field);
+}
+
+double SQLiteResult::getDouble(int field)
+{
+	if (!stmt) throw NoResultException();
+	if (last_res != SQLITE_ROW) throw NoResultException();
+	if (field < 0 || field >= num_fields) throw FieldNotInResultSetException("%d", field);
+	return sqlite3_column_double(stmt, field);
+}
+
+StringView SQLiteResult::getView(int field)
+{
+	if (!stmt) throw NoResultException();
+	if (last_res != SQLITE_ROW) throw NoResultException();
+	if (field < 0 || field >= num_fields) throw FieldNotInResultSetException("%d", field);
+	// sqlite3_column_text muss vor sqlite3_column_bytes aufgerufen werden
+	const char* value=(const char*)sqlite3_column_text(stmt, field);
+	return StringView(value, sqlite3_column_bytes(stmt, field));
+}
+
+
+/*!\class SQLiteStatement
+ * \ingroup PPLGroupDatabases
+ * \brief Vorbereiteter Query einer SQLite-Datenbank
+ *
+ * \descr
+ * Dies ist eine interne Klasse des SQLite-Datenbankmoduls. Sie wird von SQLite::createStatement
+ * erzeugt und enthält den mit \c sqlite3_prepare_v2 vorbereiteten Query. Nach jeder Ausführung
+ * wird der Query mit \c sqlite3_reset zurückgesetzt, die gebundenen Werte bleiben dabei erhalten.
+ */
+
+SQLiteStatement::SQLiteStatement(SQLite& db, sqlite3* conn, const String& query)
+	: Statement(db, query)
+{
+	this->conn=conn;
+	stmt=NULL;
+	result=NULL;
+	affectedrows=0;
+	int ret=sqlite3_prepare_v2(conn, (const char*)query, query.size(), &stmt, NULL);
+	if (ret != SQLITE_OK) {
+		throw QueryFailedException("sqlite3_prepare_v2 failed: %s, Query: %s", sqlite3_errmsg(conn), (const char*)query);
+	}
+	if (stmt == NULL) {
+		throw QueryFailedException("sqlite3_prepare_v2: empty query");
+	}
+}
+
+SQLiteStatement::~SQLiteStatement()
+{
+	if (stmt) {
+		reset();
+		sqlite3_finalize(stmt);
+	}
+}
+
+/*!\brief Vorbereiteten Query freigeben und das Statement von der Verbindung trennen
+ */
+void SQLiteStatement::close()
+{
+	if (stmt) {
+		reset();
+		sqlite3_finalize(stmt);
+		stmt=NULL;
+	}
+	conn=NULL;
+	Statement::close();
+}
+
+/*!\brief Ein noch offenes Ergebnis vom Statement trennen und den Query zurücksetzen
+ *
+ * \exception NoConnectionException Die Verbindung wurde inzwischen geschlossen
+ */
+void SQLiteStatement::reset()
+{
+	if (!stmt) throw NoConnectionException();
+	if (result) {
+		result->stmt=NULL;
+		result->statement=NULL;
+		result->last_res=SQLITE_DONE;
+		result=NULL;
+	}
+	sqlite3_reset(stmt);
+}
+
+void SQLiteStatement::checkBind(int ret, int index)
+{
+	if (ret == SQLITE_OK) return;
+	if (ret == SQLITE_RANGE) throw IllegalArgumentException("Statement::bind: index %d out of range", index);
+	if (ret == SQLITE_NOMEM) throw OutOfMemoryException();
+	throw QueryFailedException("sqlite3_bind: %s", sqlite3_errmsg(conn));
+}
+
+int SQLiteStatement::params() const
+{
+	if (!stmt) throw NoConnectionException();
+	return sqlite3_bind_parameter_count(stmt);
+}
+
+void SQLiteStatement::bindNull(int index)
+{
+	reset();
+	checkBind(sqlite3_bind_null(stmt, index), index);
+}
+
+void SQLiteStatement::bind(int index, int64_t value)
+{
+	reset();
+	checkBind(sqlite3_bind_int64(stmt, index, (sqlite3_int64)value), index);
+}
+
+void SQLiteStatement::bind(int index, double value)
+{
+	reset();
+	checkBind(sqlite3_bind_double(stmt, index, value), index);
+}
+
+void SQLiteStatement::bind(int index, const String& value)
+{
+	reset();
+	checkBind(sqlite3_bind_text(stmt, index, value.c_str(), (int)value.size(), SQLITE_TRANSIENT), index);
+}
+
+void SQLiteStatement::bind(int index, const ByteArrayPtr& value)
+{
+	reset();
+	checkBind(sqlite3_bind_blob(stmt, index, value.ptr(), (int)value.size(), SQLITE_TRANSIENT), index);
+}
+
+void SQLiteStatement::clearBindings()
+{
+	reset();
+	sqlite3_clear_bindings(stmt);
+}
+
+int SQLiteStatement::step()
+{
+	reset();
+	affectedrows=0;
+	int ret=sqlite3_step(stmt);
+	if (ret != SQLITE_DONE && ret != SQLITE_ROW) {
+		String err;
+		err.setf("sqlite3_step: %s, Query: %s", sqlite3_errmsg(conn), (const char*)getQuery());
+		sqlite3_reset(stmt);
+		throw QueryFailedException(err);
+	}
+	affectedrows=sqlite3_changes(conn);
+	return ret;
+}
+
+void SQLiteStatement::exec()
+{
+	double t_start=GetMicrotime();
+	step();
+	sqlite3_reset(stmt);
+	finished((float)(GetMicrotime() - t_start));
+}
+
+ResultSet* SQLiteStatement::query()
+{
+	double t_start=GetMicrotime();
+	int ret=step();
+	finished((float)(GetMicrotime() - t_start));
+	SQLiteResult* pr=new SQLiteResult;
+	pr->stmt=stmt;
+	pr->statement=this;
+	pr->last_res=ret;
+	pr->conn=conn;
+	pr->affectedrows=affectedrows;
+	pr->num_fields=sqlite3_column_count(stmt);
+	result=pr;
+	return pr;
+}
+
+uint64_t SQLiteStatement::affected() const
+{
+	return affectedrows;
+}
 
 #endif	// HAVE_SQLITE3
 
@@ -343,6 +584,7 @@ void SQLite::close()
 	if (!conn) {
 		return;
 	}
+	clearStatementCache();
 	sqlite3_close((sqlite3*)conn);
 	conn=NULL;
 	clearLastUse();
@@ -448,6 +690,100 @@ ResultSet* SQLite::query(const String& query)
 #endif
 }
 
+/*!\brief Vorbereiteten Query erzeugen
+ *
+ * \descr
+ * Wird von Database::prepare aufgerufen, wenn sich der Query noch nicht im Statement-Cache
+ * befindet.
+ *
+ * \exception NoConnectionException Es besteht keine Verbindung zur Datenbank
+ * \exception QueryFailedException Der Query konnte nicht vorbereitet werden
+ */
+Statement* SQLite::createStatement(const String& query)
+{
+#ifndef HAVE_SQLITE3
+	throw UnsupportedFeatureException("SQLite");
+#else
+	if (!conn) throw NoConnectionException();
+	return new SQLiteStatement(*this, (sqlite3*)conn, query);
+#endif
+}
+
+/*!\brief Mehrere Datensätze auf einmal einfügen
+ *
+ * \descr
+ * Die SQLite-Implementierung von Database::bulkInsert verwendet einen vorbereiteten Query, der
+ * für jede Zeile erneut ausgeführt wird. Jeweils \p batchsize Zeilen werden in einer
+ * Transaktion zusammengefasst, so dass die Datenbank-Datei nicht nach jeder Zeile
+ * synchronisiert werden muss. Schlägt eine Zeile fehl, wird die Transaktion des aktuellen
+ * Blocks zurückgerollt.
+ * \par
+ * Ist beim Aufruf bereits eine Transaktion offen, wird kein eigenes BEGIN/COMMIT ausgeführt.
+ * Stattdessen wird jeder Block in einem Savepoint innerhalb der Transaktion des Aufrufers
+ * ausgeführt, die anschließend weiterhin offen ist.
+ *
+ * \copydetails Database::bulkInsert
+ */
+void SQLite::bulkInsert(const String& table, const Array& columns, const std::list<Array>& rows, size_t batchsize)
+{
+#ifndef HAVE_SQLITE3
+	throw UnsupportedFeatureException("SQLite");
+#else
+	if (!conn) throw NoConnectionException();
+	checkBulkRows(columns, rows);
+	if (batchsize < 1) batchsize=1;
+	String q;
+	q.setf("insert into %s (%s) values (?", (const char*)table, (const char*)columns.implode(","));
+	for (size_t i=1;i < columns.size();i++) q+=",?";
+	q+=")";
+	std::shared_ptr<Statement> stmt=prepare(q);
+	// Läuft bereits eine Transaktion des Aufrufers, werden die Blöcke als Savepoint
+	// innerhalb dieser Transaktion ausgeführt, statt sie mit COMMIT zu beenden.
+	bool nested=(sqlite3_get_autocommit((sqlite3*)conn) == 0);
+	bool inTransaction=false;
+	size_t num=0;
+	std::list<Array>::const_iterator it;
+	try {
+		for (it=rows.begin();it != rows.end();++it) {
+			const Array& row=(*it);
+			if (!inTransaction) {
+				if (nested) exec("SAVEPOINT bulkinsert");
+				else exec("BEGIN");
+				inTransaction=true;
+			}
+			stmt->bind(row);
+			stmt->exec();
+			num++;
+			if (num >= batchsize) {
+				if (nested) exec("RELEASE SAVEPOINT bulkinsert");
+				else exec("COMMIT");
+				inTransaction=false;
+				num=0;
+			}
+		}
+		if (inTransaction) {
+			if (nested) exec("RELEASE SAVEPOINT bulkinsert");
+			else exec("COMMIT");
+			inTransaction=false;
+		}
+	} catch (...) {
+		if (inTransaction) {
+			try {
+				if (nested) {
+					exec("ROLLBACK TO SAVEPOINT bulkinsert");
+					exec("RELEASE SAVEPOINT bulkinsert");
+				} else {
+					exec("ROLLBACK");
+				}
+			} catch (...) {
+			}
+		}
+		throw;
+	}
+	affectedrows=rows.size();
+#endif
+}
+
 bool SQLite::ping()
 {
 #ifndef HAVE_SQLITE3
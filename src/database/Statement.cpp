@@ -0,0 +1,232 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STDARG_H
+#include <stdarg.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "ppl7.h"
+#include "ppl7-db.h"
+
+
+namespace ppl7 {
+namespace db {
+
+
+/*!\class Statement
+ * \ingroup PPLGroupDatabases
+ * \brief Vorbereiteter Query mit Platzhaltern
+ *
+ * \header \#include <ppl7-db.h>
+ *
+ * \descr
+ * Dies ist eine virtuelle Basisklasse für vorbereitete Queries ("prepared statements"). Der Query
+ * wird nur einmal vom Datenbank-Server geparst und kann anschließend beliebig oft mit
+ * unterschiedlichen Werten ausgeführt werden. Die Werte werden über die bind-Funktionen an die
+ * Platzhalter (\c ?) im Query gebunden und müssen daher nicht mit Database::escape maskiert
+ * werden. Die Platzhalter werden beginnend mit 1 durchnummeriert.
+ * \par
+ * Ein Statement wird mit Database::prepare erzeugt und als \c std::shared_ptr zurückgegeben.
+ * Die Verbindung hält die zuletzt verwendeten Statements in einem Cache vor (siehe
+ * Database::setStatementCacheSize), ein erneuter Aufruf von Database::prepare mit dem gleichen
+ * Query liefert daher das bereits vorbereitete Statement zurück. Wird ein Statement aus dem Cache
+ * verdrängt, bleibt es gültig, solange die Anwendung den Pointer hält. Wird die Verbindung
+ * geschlossen, wirft jede weitere Verwendung eine NoConnectionException.
+ * \par
+ * Die gebundenen Werte bleiben auch nach der Ausführung erhalten, bis sie überschrieben oder mit
+ * Statement::clearBindings gelöscht werden. Ein ResultSet, das mit Statement::query erzeugt
+ * wurde, muss von der Anwendung mit \c delete freigegeben werden. Es wird ungültig, sobald das
+ * Statement erneut verwendet wird.
+ *
+ * \example
+ * \code
+std::shared_ptr<ppl7::db::Statement> stmt=db->prepare("insert into user (id, name) values (?, ?)");
+for (int i=0;i<100;i++) {
+	stmt->bind(1,i);
+	stmt->bind(2,ppl7::ToString("User %d",i));
+	stmt->exec();
+}
+ * \endcode
+ */
+
+/*!\brief Konstruktor der Klasse
+ *
+ * \param[in] db Die Datenbank-Verbindung, zu der das Statement gehört
+ * \param[in] query Der vorbereitete Query
+ */
+Statement::Statement(Database& db, const String& query)
+{
+	this->db=&db;
+	querystring=query;
+	db.Statements.insert(this);
+}
+
+/*!\brief Destruktor der Klasse
+ */
+Statement::~Statement()
+{
+	if (db) db->Statements.erase(this);
+}
+
+/*!\brief Statement von der Datenbank-Verbindung trennen
+ *
+ * \descr
+ * Wird von Database::clearStatementCache aufgerufen, wenn die Verbindung geschlossen wird, die
+ * Anwendung das Statement aber noch hält. Abgeleitete Klassen geben hier ihr Handle frei und
+ * rufen anschließend Statement::close auf. Jede weitere Verwendung des Statements wirft eine
+ * NoConnectionException.
+ */
+void Statement::close()
+{
+	db=NULL;
+}
+
+/*!\brief Interne Funktion, die nach der Ausführung des Queries aufgerufen wird
+ *
+ * \descr
+ * Aktualisiert den Zeitstempel der letzten Verwendung der Datenbank-Verbindung und schreibt
+ * den Query in das Querylog, sofern dieses aktiviert ist.
+ *
+ * @param[in] duration Laufzeit des Queries in Sekunden
+ */
+void Statement::finished(float duration)
+{
+	if (!db) return;
+	db->updateLastUse();
+	db->logQuery(querystring, duration);
+}
+
+/*!\brief Der vorbereitete Query
+ */
+const String& Statement::getQuery() const
+{
+	return querystring;
+}
+
+/*!\brief Datenbank-Verbindung, zu der das Statement gehört
+ */
+Database& Statement::database() const
+{
+	if (!db) throw NoConnectionException();
+	return *db;
+}
+
+/*!\fn Statement::params
+ * \brief Anzahl Platzhalter im Query
+ */
+
+/*!\fn Statement::bindNull
+ * \brief Den Wert NULL an den Platzhalter \p index binden
+ */
+
+/*!\fn Statement::bind(int index, int64_t value)
+ * \brief Ganzzahl \p value an den Platzhalter \p index binden
+ */
+
+/*!\fn Statement::bind(int index, double value)
+ * \brief Fließkommazahl \p value an den Platzhalter \p index binden
+ */
+
+/*!\fn Statement::bind(int index, const String& value)
+ * \brief String \p value an den Platzhalter \p index binden
+ */
+
+/*!\fn Statement::bind(int index, const ByteArrayPtr& value)
+ * \brief Binäre Daten \p value an den Platzhalter \p index binden
+ */
+
+/*!\fn Statement::clearBindings
+ * \brief Alle Platzhalter auf NULL zurücksetzen
+ */
+
+/*!\fn Statement::exec
+ * \brief Query mit den gebundenen Werten ausführen, ohne ein Ergebnis zurückzuliefern
+ * \exception QueryFailedException Der Query ist fehlgeschlagen
+ */
+
+/*!\fn Statement::query
+ * \brief Query mit den gebundenen Werten ausführen und das Ergebnis zurückliefern
+ *
+ * \return Pointer auf ein ResultSet, das von der Anwendung mit \c delete freigegeben werden muss
+ * \exception QueryFailedException Der Query ist fehlgeschlagen
+ */
+
+/*!\fn Statement::affected
+ * \brief Anzahl der durch die letzte Ausführung betroffenen Datensätze
+ */
+
+/*!\brief Ganzzahl \p value an den Platzhalter \p index binden
+ */
+void Statement::bind(int index, int value)
+{
+	bind(index, (int64_t)value);
+}
+
+/*!\brief String \p value an den Platzhalter \p index binden
+ *
+ * \descr
+ * Ist \p value NULL, wird der Wert NULL gebunden.
+ */
+void Statement::bind(int index, const char* value)
+{
+	if (!value) bindNull(index);
+	else bind(index, String(value));
+}
+
+/*!\brief Alle Platzhalter mit den Werten aus einem Array belegen
+ *
+ * \descr
+ * Der erste Wert des Arrays wird an den ersten Platzhalter gebunden, der zweite an den
+ * zweiten, usw.
+ *
+ * @param[in] values Array mit den Werten als Strings
+ */
+void Statement::bind(const Array& values)
+{
+	for (size_t i=0;i < values.size();i++) {
+		bind((int)i + 1, values[i]);
+	}
+}
+
+
+}	// EOF namespace db
+}	// EOF namespace ppl7
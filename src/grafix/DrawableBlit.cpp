@@ -58,7 +58,7 @@
 
 #include "ppl7.h"
 #include "ppl7-grafix.h"
-
+#include "simd_ppl7.h"
 
 
 #ifdef HAVE_X86_ASSEMBLER
@@ -567,6 +567,555 @@ static void BltBackgroundOnChromaKey_32(DRAWABLE_DATA& target, const DRAWABLE_DA
 }
 
 
+static inline uint32_t ChromaKeyPixel(uint32_t src, uint32_t background, int cb_key, int cr_key, int tol1, int tol2)
+{
+	PIXEL c, bg, t;
+	c.c=src;
+	bg.c=background;
+	int cb=getYCb(c.r, c.g, c.b);
+	int cr=getYCr(c.r, c.g, c.b);
+	double mask = 1 - colorclose(cb, cr, cb_key, cr_key, tol1, tol2);
+	if (mask == 0.0) return c.c;
+	if (mask == 1.0) return bg.c;
+	t.r=(uint8_t)(max(c.r - mask * c.r, 0) + mask * bg.r);
+	t.g=(uint8_t)(max(c.g - mask * c.g, 0) + mask * bg.g);
+	t.b=(uint8_t)(max(c.b - mask * c.b, 0) + mask * bg.b);
+	t.a=(uint8_t)(max(c.a - mask * c.a, 0) + mask * bg.a);
+	return t.c;
+}
+
+#ifdef PPL7_SIMD_X86
+/*
+ * SSE4.1 und AVX2
+ *
+ * Die Kernel berechnen exakt die gleichen Werte wie die skalaren Funktionen oben. Divisionen
+ * durch 255 werden mit (x+1+(x>>8))>>8 ersetzt, was für alle Werte bis 255*255 das gleiche
+ * Ergebnis liefert. Die Sonderfälle der skalaren Versionen (Alpha 0 bzw. 255, Intensität 0
+ * bzw. 255) ergeben sich dabei aus der Formel von selbst und werden nur als Abkürzung für
+ * ganze Pixelgruppen verwendet. Restpixel am Zeilenende werden skalar berechnet.
+ */
+
+/*
+ * Liegen Quelle und Ziel in der gleichen Grafik und das Ziel nur wenige Pixel rechts von der
+ * Quelle, lesen die skalaren Funktionen Pixel, die sie in der gleichen Zeile gerade erst
+ * geschrieben haben. Die Vektor-Kernel lesen eine ganze Pixelgruppe vor dem Schreiben, daher
+ * wird in diesem Fall die skalare Funktion verwendet.
+ */
+static inline bool overlapsGroup(const void* read, const void* write, int pixels)
+{
+	ptrdiff_t d=(const char*)write - (const char*)read;
+	return d > 0 && d < pixels * 4;
+}
+
+PPL7_TARGET_SSE41 static inline __m128i Div255_SSE41(__m128i x)
+{
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+PPL7_TARGET_SSE41 static inline __m128i AlphaBlend16_SSE41(__m128i ground, __m128i top)
+{
+	const __m128i c255=_mm_set1_epi16(255);
+	__m128i alpha=_mm_shufflehi_epi16(_mm_shufflelo_epi16(top, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	__m128i areverse=_mm_sub_epi16(c255, alpha);
+	__m128i color=Div255_SSE41(_mm_add_epi16(_mm_mullo_epi16(ground, areverse), _mm_mullo_epi16(top, alpha)));
+	__m128i a=_mm_sub_epi16(c255, Div255_SSE41(_mm_mullo_epi16(_mm_sub_epi16(c255, ground), areverse)));
+	return _mm_blend_epi16(color, a, 0x88);
+}
+
+PPL7_TARGET_SSE41 static int BltAlpha_32_SSE41(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y)
+{
+	Pixel32_t* src=(Pixel32_t*)adr(source, srect.left(), srect.top());
+	Pixel32_t* tgt=(Pixel32_t*)adr(target, x, y);
+	if (overlapsGroup(src, tgt, 4)) return BltAlpha_32(target, source, srect, x, y);
+	int width=srect.width();
+	const __m128i amask=_mm_set1_epi32((int)0xff000000);
+	const __m128i zero=_mm_setzero_si128();
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 4 <= width;xx+=4) {
+			__m128i s=_mm_loadu_si128((const __m128i*)(src + xx));
+			if (_mm_testz_si128(s, amask)) continue;
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, amask), amask)) == 0xffff) {
+				_mm_storeu_si128((__m128i*)(tgt + xx), s);
+				continue;
+			}
+			__m128i d=_mm_loadu_si128((const __m128i*)(tgt + xx));
+			__m128i lo=AlphaBlend16_SSE41(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero));
+			__m128i hi=AlphaBlend16_SSE41(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero));
+			_mm_storeu_si128((__m128i*)(tgt + xx), _mm_packus_epi16(lo, hi));
+		}
+		for (;xx < width;xx++) {
+			if (src[xx].c) {
+				if (src[xx].alpha == 0xff) tgt[xx]=src[xx];
+				else tgt[xx]=GetColorBltAlphablend_32(tgt[xx], src[xx]);
+			}
+		}
+		src+=(source.pitch >> 2);
+		tgt+=(target.pitch >> 2);
+	}
+	return 1;
+}
+
+PPL7_TARGET_SSE41 static int BltColorKey_32_SSE41(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y, SurfaceColor c)
+{
+	uint32_t* q=(uint32_t*)adr(source, srect.left(), srect.top());
+	uint32_t* z=(uint32_t*)adr(target, x, y);
+	if (overlapsGroup(q, z, 4)) return BltColorKey_32(target, source, srect, x, y, c);
+	int width=srect.width();
+	const __m128i key=_mm_set1_epi32((int)c);
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 4 <= width;xx+=4) {
+			__m128i s=_mm_loadu_si128((const __m128i*)(q + xx));
+			__m128i m=_mm_cmpeq_epi32(s, key);
+			int bits=_mm_movemask_epi8(m);
+			if (bits == 0xffff) continue;
+			if (bits) s=_mm_blendv_epi8(s, _mm_loadu_si128((const __m128i*)(z + xx)), m);
+			_mm_storeu_si128((__m128i*)(z + xx), s);
+		}
+		for (;xx < width;xx++) {
+			if (q[xx] != c) z[xx]=q[xx];
+		}
+		q+=source.pitch >> 2;
+		z+=target.pitch >> 2;
+	}
+	return 1;
+}
+
+PPL7_TARGET_SSE41 static int BltDiffuse_32_SSE41(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y, SurfaceColor c)
+{
+	uint8_t* q=(uint8_t*)adr(source, srect.left(), srect.top());
+	uint32_t* z=(uint32_t*)adr(target, x, y);
+	int width=srect.width();
+	const __m128i zero=_mm_setzero_si128();
+	const __m128i c255=_mm_set1_epi16(255);
+	const __m128i color=_mm_set1_epi32((int)c);
+	const __m128i color16=_mm_unpacklo_epi8(color, zero);
+	const __m128i expand=_mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 4 <= width;xx+=4) {
+			uint32_t i4;
+			memcpy(&i4, q + xx, 4);
+			if (i4 == 0) continue;
+			if (i4 == 0xffffffff) {
+				_mm_storeu_si128((__m128i*)(z + xx), color);
+				continue;
+			}
+			__m128i i=_mm_shuffle_epi8(_mm_cvtsi32_si128((int)i4), expand);
+			__m128i d=_mm_loadu_si128((const __m128i*)(z + xx));
+			__m128i ilo=_mm_unpacklo_epi8(i, zero);
+			__m128i ihi=_mm_unpackhi_epi8(i, zero);
+			__m128i lo=Div255_SSE41(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(c255, ilo)), _mm_mullo_epi16(color16, ilo)));
+			__m128i hi=Div255_SSE41(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(c255, ihi)), _mm_mullo_epi16(color16, ihi)));
+			_mm_storeu_si128((__m128i*)(z + xx), _mm_packus_epi16(lo, hi));
+		}
+		for (;xx < width;xx++) {
+			uint8_t qc=q[xx];
+			if (qc) {
+				if (qc == 0xff) z[xx]=c;
+				else z[xx]=target.fn->RGBBlend255(z[xx], c, qc);
+			}
+		}
+		q+=source.pitch;
+		z+=target.pitch >> 2;
+	}
+	return 1;
+}
+
+PPL7_TARGET_SSE41 static inline __m128i BlendPixel_SSE41(__m128i ground, __m128i top, __m128 i1, __m128 i2)
+{
+	__m128 g=_mm_cvtepi32_ps(_mm_cvtepu8_epi32(ground));
+	__m128 t=_mm_cvtepi32_ps(_mm_cvtepu8_epi32(top));
+	return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, i1), _mm_mul_ps(t, i2)));
+}
+
+PPL7_TARGET_SSE41 static int BltBlend_32_SSE41(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y, float factor)
+{
+	// Außerhalb von 0.0 bis 1.0 laufen die Farbwerte in der skalaren Version über
+	if (!(factor >= 0.0f && factor <= 1.0f)) return BltBlend_32(target, source, srect, x, y, factor);
+	uint32_t* src=(uint32_t*)adr(source, srect.left(), srect.top());
+	uint32_t* tgt=(uint32_t*)adr(target, x, y);
+	if (overlapsGroup(src, tgt, 4)) return BltBlend_32(target, source, srect, x, y, factor);
+	int width=srect.width();
+	float f2=factor;
+	float f1=1.0f - f2;
+	const __m128 i1=_mm_set1_ps(f1);
+	const __m128 i2=_mm_set1_ps(f2);
+	const __m128i amask=_mm_set1_epi32((int)0xff000000);
+	Color psrc, ptgt, c;
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 4 <= width;xx+=4) {
+			__m128i d=_mm_loadu_si128((const __m128i*)(tgt + xx));
+			__m128i s=_mm_loadu_si128((const __m128i*)(src + xx));
+			__m128i p0=BlendPixel_SSE41(d, s, i1, i2);
+			__m128i p1=BlendPixel_SSE41(_mm_srli_si128(d, 4), _mm_srli_si128(s, 4), i1, i2);
+			__m128i p2=BlendPixel_SSE41(_mm_srli_si128(d, 8), _mm_srli_si128(s, 8), i1, i2);
+			__m128i p3=BlendPixel_SSE41(_mm_srli_si128(d, 12), _mm_srli_si128(s, 12), i1, i2);
+			__m128i r=_mm_packus_epi16(_mm_packus_epi32(p0, p1), _mm_packus_epi32(p2, p3));
+			_mm_storeu_si128((__m128i*)(tgt + xx), _mm_or_si128(r, amask));
+		}
+		for (;xx < width;xx++) {
+			ptgt.setColor(tgt[xx]);
+			psrc.setColor(src[xx]);
+			c.blendf(ptgt, psrc, factor);
+			tgt[xx]=c.color();
+		}
+		src+=(source.pitch >> 2);
+		tgt+=(target.pitch >> 2);
+	}
+	return 1;
+}
+
+PPL7_TARGET_SSE41 static void ChromaKeyRows_SSE41(const uint32_t* sadr, uint32_t spitch, const uint32_t* bgadr, uint32_t bgpitch,
+	uint32_t* tgadr, uint32_t tgpitch, int width, int height, int cb_key, int cr_key, int tol1, int tol2)
+{
+	const __m128i byte=_mm_set1_epi32(255);
+	const __m128i zero=_mm_setzero_si128();
+	const __m128i cbk=_mm_set1_epi32(cb_key);
+	const __m128i crk=_mm_set1_epi32(cr_key);
+	const __m128d one=_mm_set1_pd(1.0);
+	const __m128d c128=_mm_set1_pd(128.0);
+	const __m128d tola=_mm_set1_pd((double)tol1);
+	const __m128d tolb=_mm_set1_pd((double)tol2);
+	const __m128d tolrange=_mm_set1_pd((double)(tol2 - tol1));
+	for (int yy=0;yy < height;yy++) {
+		int xx=0;
+		for (;xx + 2 <= width;xx+=2) {
+			__m128i s=_mm_loadl_epi64((const __m128i*)(sadr + xx));
+			__m128i bg=_mm_loadl_epi64((const __m128i*)(bgadr + xx));
+			__m128i ch[4], bgch[4];
+			for (int k=0;k < 4;k++) {
+				ch[k]=_mm_and_si128(_mm_srli_epi32(s, k * 8), byte);
+				bgch[k]=_mm_and_si128(_mm_srli_epi32(bg, k * 8), byte);
+			}
+			// Reihenfolge im Speicher: b, g, r, a
+			__m128d b=_mm_cvtepi32_pd(ch[0]), g=_mm_cvtepi32_pd(ch[1]), r=_mm_cvtepi32_pd(ch[2]);
+			__m128i cb=_mm_cvttpd_epi32(_mm_add_pd(_mm_sub_pd(_mm_add_pd(c128, _mm_mul_pd(_mm_set1_pd(-0.168736), r)),
+				_mm_mul_pd(_mm_set1_pd(0.331264), g)), _mm_mul_pd(_mm_set1_pd(0.5), b)));
+			__m128i cr=_mm_cvttpd_epi32(_mm_sub_pd(_mm_sub_pd(_mm_add_pd(c128, _mm_mul_pd(_mm_set1_pd(0.5), r)),
+				_mm_mul_pd(_mm_set1_pd(0.418688), g)), _mm_mul_pd(_mm_set1_pd(0.081312), b)));
+			__m128i dcb=_mm_sub_epi32(cbk, cb);
+			__m128i dcr=_mm_sub_epi32(crk, cr);
+			__m128d temp=_mm_sqrt_pd(_mm_cvtepi32_pd(_mm_add_epi32(_mm_mullo_epi32(dcb, dcb), _mm_mullo_epi32(dcr, dcr))));
+			// Alle Pixel weit genug vom Schlüssel entfernt oder alle innerhalb der inneren Toleranz
+			if (_mm_movemask_pd(_mm_cmpge_pd(temp, tolb)) == 3) {
+				_mm_storel_epi64((__m128i*)(tgadr + xx), s);
+				continue;
+			}
+			if (_mm_movemask_pd(_mm_cmplt_pd(temp, tola)) == 3) {
+				_mm_storel_epi64((__m128i*)(tgadr + xx), bg);
+				continue;
+			}
+			__m128d close=_mm_blendv_pd(one, _mm_div_pd(_mm_sub_pd(temp, tola), tolrange), _mm_cmplt_pd(temp, tolb));
+			close=_mm_blendv_pd(close, _mm_setzero_pd(), _mm_cmplt_pd(temp, tola));
+			__m128d mask=_mm_sub_pd(one, close);
+			__m128i result=zero;
+			for (int k=0;k < 4;k++) {
+				__m128d cd=_mm_cvtepi32_pd(ch[k]);
+				__m128i part=_mm_max_epi32(_mm_cvttpd_epi32(_mm_sub_pd(cd, _mm_mul_pd(mask, cd))), zero);
+				part=_mm_cvttpd_epi32(_mm_add_pd(_mm_cvtepi32_pd(part), _mm_mul_pd(mask, _mm_cvtepi32_pd(bgch[k]))));
+				result=_mm_or_si128(result, _mm_slli_epi32(_mm_and_si128(part, byte), k * 8));
+			}
+			_mm_storel_epi64((__m128i*)(tgadr + xx), result);
+		}
+		for (;xx < width;xx++) {
+			tgadr[xx]=ChromaKeyPixel(sadr[xx], bgadr[xx], cb_key, cr_key, tol1, tol2);
+		}
+		sadr+=spitch;
+		bgadr+=bgpitch;
+		tgadr+=tgpitch;
+	}
+}
+
+static void BltChromaKey_32_SSE41(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, const Color& key, int tol1, int tol2, int x, int y)
+{
+	if (overlapsGroup(adr(source, srect.left(), srect.top()), adr(target, x, y), 2)) {
+		BltChromaKey_32(target, source, srect, key, tol1, tol2, x, y);
+		return;
+	}
+	if (tol2 < tol1) tol2=tol1;
+	ChromaKeyRows_SSE41((const uint32_t*)adr(source, srect.left(), srect.top()), source.pitch / 4,
+		(const uint32_t*)adr(target, x, y), target.pitch / 4,
+		(uint32_t*)adr(target, x, y), target.pitch / 4,
+		srect.width(), srect.height(), key.getYCb(), key.getYCr(), tol1, tol2);
+}
+
+static void BltBackgroundOnChromaKey_32_SSE41(DRAWABLE_DATA& target, const DRAWABLE_DATA& background, const Rect& srect, const Color& key, int tol1, int tol2, int x, int y)
+{
+	if (overlapsGroup(adr(target, srect.left(), srect.top()), adr(target, x, y), 2)
+		|| overlapsGroup(adr(background, x, y), adr(target, x, y), 2)) {
+		BltBackgroundOnChromaKey_32(target, background, srect, key, tol1, tol2, x, y);
+		return;
+	}
+	if (tol2 < tol1) tol2=tol1;
+	ChromaKeyRows_SSE41((const uint32_t*)adr(target, srect.left(), srect.top()), target.pitch / 4,
+		(const uint32_t*)adr(background, x, y), background.pitch / 4,
+		(uint32_t*)adr(target, x, y), target.pitch / 4,
+		srect.width(), srect.height(), key.getYCb(), key.getYCr(), tol1, tol2);
+}
+
+
+PPL7_TARGET_AVX2 static inline __m256i Div255_AVX2(__m256i x)
+{
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+}
+
+PPL7_TARGET_AVX2 static inline __m256i AlphaBlend16_AVX2(__m256i ground, __m256i top)
+{
+	const __m256i c255=_mm256_set1_epi16(255);
+	__m256i alpha=_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(top, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	__m256i areverse=_mm256_sub_epi16(c255, alpha);
+	__m256i color=Div255_AVX2(_mm256_add_epi16(_mm256_mullo_epi16(ground, areverse), _mm256_mullo_epi16(top, alpha)));
+	__m256i a=_mm256_sub_epi16(c255, Div255_AVX2(_mm256_mullo_epi16(_mm256_sub_epi16(c255, ground), areverse)));
+	return _mm256_blend_epi16(color, a, 0x88);
+}
+
+PPL7_TARGET_AVX2 static int BltAlpha_32_AVX2(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y)
+{
+	Pixel32_t* src=(Pixel32_t*)adr(source, srect.left(), srect.top());
+	Pixel32_t* tgt=(Pixel32_t*)adr(target, x, y);
+	if (overlapsGroup(src, tgt, 8)) return BltAlpha_32(target, source, srect, x, y);
+	int width=srect.width();
+	const __m256i amask=_mm256_set1_epi32((int)0xff000000);
+	const __m256i zero=_mm256_setzero_si256();
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 8 <= width;xx+=8) {
+			__m256i s=_mm256_loadu_si256((const __m256i*)(src + xx));
+			if (_mm256_testz_si256(s, amask)) continue;
+			if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(s, amask), amask)) == -1) {
+				_mm256_storeu_si256((__m256i*)(tgt + xx), s);
+				continue;
+			}
+			__m256i d=_mm256_loadu_si256((const __m256i*)(tgt + xx));
+			__m256i lo=AlphaBlend16_AVX2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero));
+			__m256i hi=AlphaBlend16_AVX2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero));
+			_mm256_storeu_si256((__m256i*)(tgt + xx), _mm256_packus_epi16(lo, hi));
+		}
+		for (;xx < width;xx++) {
+			if (src[xx].c) {
+				if (src[xx].alpha == 0xff) tgt[xx]=src[xx];
+				else tgt[xx]=GetColorBltAlphablend_32(tgt[xx], src[xx]);
+			}
+		}
+		src+=(source.pitch >> 2);
+		tgt+=(target.pitch >> 2);
+	}
+	return 1;
+}
+
+PPL7_TARGET_AVX2 static int BltColorKey_32_AVX2(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y, SurfaceColor c)
+{
+	uint32_t* q=(uint32_t*)adr(source, srect.left(), srect.top());
+	uint32_t* z=(uint32_t*)adr(target, x, y);
+	if (overlapsGroup(q, z, 8)) return BltColorKey_32(target, source, srect, x, y, c);
+	int width=srect.width();
+	const __m256i key=_mm256_set1_epi32((int)c);
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 8 <= width;xx+=8) {
+			__m256i s=_mm256_loadu_si256((const __m256i*)(q + xx));
+			__m256i m=_mm256_cmpeq_epi32(s, key);
+			int bits=_mm256_movemask_epi8(m);
+			if (bits == -1) continue;
+			if (bits) s=_mm256_blendv_epi8(s, _mm256_loadu_si256((const __m256i*)(z + xx)), m);
+			_mm256_storeu_si256((__m256i*)(z + xx), s);
+		}
+		for (;xx < width;xx++) {
+			if (q[xx] != c) z[xx]=q[xx];
+		}
+		q+=source.pitch >> 2;
+		z+=target.pitch >> 2;
+	}
+	return 1;
+}
+
+PPL7_TARGET_AVX2 static int BltDiffuse_32_AVX2(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y, SurfaceColor c)
+{
+	uint8_t* q=(uint8_t*)adr(source, srect.left(), srect.top());
+	uint32_t* z=(uint32_t*)adr(target, x, y);
+	int width=srect.width();
+	const __m256i zero=_mm256_setzero_si256();
+	const __m256i c255=_mm256_set1_epi16(255);
+	const __m256i color=_mm256_set1_epi32((int)c);
+	const __m256i color16=_mm256_unpacklo_epi8(color, zero);
+	const __m256i expand=_mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+		4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 8 <= width;xx+=8) {
+			uint64_t i8;
+			memcpy(&i8, q + xx, 8);
+			if (i8 == 0) continue;
+			if (i8 == 0xffffffffffffffffULL) {
+				_mm256_storeu_si256((__m256i*)(z + xx), color);
+				continue;
+			}
+			__m256i i=_mm256_shuffle_epi8(_mm256_set1_epi64x((long long)i8), expand);
+			__m256i d=_mm256_loadu_si256((const __m256i*)(z + xx));
+			__m256i ilo=_mm256_unpacklo_epi8(i, zero);
+			__m256i ihi=_mm256_unpackhi_epi8(i, zero);
+			__m256i lo=Div255_AVX2(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(c255, ilo)), _mm256_mullo_epi16(color16, ilo)));
+			__m256i hi=Div255_AVX2(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(c255, ihi)), _mm256_mullo_epi16(color16, ihi)));
+			_mm256_storeu_si256((__m256i*)(z + xx), _mm256_packus_epi16(lo, hi));
+		}
+		for (;xx < width;xx++) {
+			uint8_t qc=q[xx];
+			if (qc) {
+				if (qc == 0xff) z[xx]=c;
+				else z[xx]=target.fn->RGBBlend255(z[xx], c, qc);
+			}
+		}
+		q+=source.pitch;
+		z+=target.pitch >> 2;
+	}
+	return 1;
+}
+
+PPL7_TARGET_AVX2 static inline __m256i BlendPixels_AVX2(const uint32_t* ground, const uint32_t* top, __m256 i1, __m256 i2)
+{
+	__m256 g=_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)ground)));
+	__m256 t=_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)top)));
+	return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(g, i1), _mm256_mul_ps(t, i2)));
+}
+
+PPL7_TARGET_AVX2 static int BltBlend_32_AVX2(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, int x, int y, float factor)
+{
+	// Außerhalb von 0.0 bis 1.0 laufen die Farbwerte in der skalaren Version über
+	if (!(factor >= 0.0f && factor <= 1.0f)) return BltBlend_32(target, source, srect, x, y, factor);
+	uint32_t* src=(uint32_t*)adr(source, srect.left(), srect.top());
+	uint32_t* tgt=(uint32_t*)adr(target, x, y);
+	if (overlapsGroup(src, tgt, 8)) return BltBlend_32(target, source, srect, x, y, factor);
+	int width=srect.width();
+	float f2=factor;
+	float f1=1.0f - f2;
+	const __m256 i1=_mm256_set1_ps(f1);
+	const __m256 i2=_mm256_set1_ps(f2);
+	const __m256i amask=_mm256_set1_epi32((int)0xff000000);
+	const __m256i order=_mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	Color psrc, ptgt, c;
+	for (int yy=0;yy < srect.height();yy++) {
+		int xx=0;
+		for (;xx + 8 <= width;xx+=8) {
+			// Jeder Vektor enthält zwei Pixel, nach dem Packen liegen die Pixel
+			// in der Reihenfolge 0,2,4,6,1,3,5,7 vor
+			__m256i p01=BlendPixels_AVX2(tgt + xx, src + xx, i1, i2);
+			__m256i p23=BlendPixels_AVX2(tgt + xx + 2, src + xx + 2, i1, i2);
+			__m256i p45=BlendPixels_AVX2(tgt + xx + 4, src + xx + 4, i1, i2);
+			__m256i p67=BlendPixels_AVX2(tgt + xx + 6, src + xx + 6, i1, i2);
+			__m256i r=_mm256_packus_epi16(_mm256_packus_epi32(p01, p23), _mm256_packus_epi32(p45, p67));
+			r=_mm256_permutevar8x32_epi32(r, order);
+			_mm256_storeu_si256((__m256i*)(tgt + xx), _mm256_or_si256(r, amask));
+		}
+		for (;xx < width;xx++) {
+			ptgt.setColor(tgt[xx]);
+			psrc.setColor(src[xx]);
+			c.blendf(ptgt, psrc, factor);
+			tgt[xx]=c.color();
+		}
+		src+=(source.pitch >> 2);
+		tgt+=(target.pitch >> 2);
+	}
+	return 1;
+}
+
+PPL7_TARGET_AVX2 static void ChromaKeyRows_AVX2(const uint32_t* sadr, uint32_t spitch, const uint32_t* bgadr, uint32_t bgpitch,
+	uint32_t* tgadr, uint32_t tgpitch, int width, int height, int cb_key, int cr_key, int tol1, int tol2)
+{
+	const __m128i byte=_mm_set1_epi32(255);
+	const __m128i zero=_mm_setzero_si128();
+	const __m128i cbk=_mm_set1_epi32(cb_key);
+	const __m128i crk=_mm_set1_epi32(cr_key);
+	const __m256d one=_mm256_set1_pd(1.0);
+	const __m256d c128=_mm256_set1_pd(128.0);
+	const __m256d tola=_mm256_set1_pd((double)tol1);
+	const __m256d tolb=_mm256_set1_pd((double)tol2);
+	const __m256d tolrange=_mm256_set1_pd((double)(tol2 - tol1));
+	for (int yy=0;yy < height;yy++) {
+		int xx=0;
+		for (;xx + 4 <= width;xx+=4) {
+			__m128i s=_mm_loadu_si128((const __m128i*)(sadr + xx));
+			__m128i bg=_mm_loadu_si128((const __m128i*)(bgadr + xx));
+			__m128i ch[4], bgch[4];
+			for (int k=0;k < 4;k++) {
+				ch[k]=_mm_and_si128(_mm_srli_epi32(s, k * 8), byte);
+				bgch[k]=_mm_and_si128(_mm_srli_epi32(bg, k * 8), byte);
+			}
+			// Reihenfolge im Speicher: b, g, r, a
+			__m256d b=_mm256_cvtepi32_pd(ch[0]), g=_mm256_cvtepi32_pd(ch[1]), r=_mm256_cvtepi32_pd(ch[2]);
+			__m128i cb=_mm256_cvttpd_epi32(_mm256_add_pd(_mm256_sub_pd(_mm256_add_pd(c128, _mm256_mul_pd(_mm256_set1_pd(-0.168736), r)),
+				_mm256_mul_pd(_mm256_set1_pd(0.331264), g)), _mm256_mul_pd(_mm256_set1_pd(0.5), b)));
+			__m128i cr=_mm256_cvttpd_epi32(_mm256_sub_pd(_mm256_sub_pd(_mm256_add_pd(c128, _mm256_mul_pd(_mm256_set1_pd(0.5), r)),
+				_mm256_mul_pd(_mm256_set1_pd(0.418688), g)), _mm256_mul_pd(_mm256_set1_pd(0.081312), b)));
+			__m128i dcb=_mm_sub_epi32(cbk, cb);
+			__m128i dcr=_mm_sub_epi32(crk, cr);
+			__m256d temp=_mm256_sqrt_pd(_mm256_cvtepi32_pd(_mm_add_epi32(_mm_mullo_epi32(dcb, dcb), _mm_mullo_epi32(dcr, dcr))));
+			// Alle Pixel weit genug vom Schlüssel entfernt oder alle innerhalb der inneren Toleranz
+			if (_mm256_movemask_pd(_mm256_cmp_pd(temp, tolb, _CMP_GE_OQ)) == 15) {
+				_mm_storeu_si128((__m128i*)(tgadr + xx), s);
+				continue;
+			}
+			if (_mm256_movemask_pd(_mm256_cmp_pd(temp, tola, _CMP_LT_OQ)) == 15) {
+				_mm_storeu_si128((__m128i*)(tgadr + xx), bg);
+				continue;
+			}
+			__m256d close=_mm256_blendv_pd(one, _mm256_div_pd(_mm256_sub_pd(temp, tola), tolrange), _mm256_cmp_pd(temp, tolb, _CMP_LT_OQ));
+			close=_mm256_blendv_pd(close, _mm256_setzero_pd(), _mm256_cmp_pd(temp, tola, _CMP_LT_OQ));
+			__m256d mask=_mm256_sub_pd(one, close);
+			__m128i result=zero;
+			for (int k=0;k < 4;k++) {
+				__m256d cd=_mm256_cvtepi32_pd(ch[k]);
+				__m128i part=_mm_max_epi32(_mm256_cvttpd_epi32(_mm256_sub_pd(cd, _mm256_mul_pd(mask, cd))), zero);
+				part=_mm256_cvttpd_epi32(_mm256_add_pd(_mm256_cvtepi32_pd(part), _mm256_mul_pd(mask, _mm256_cvtepi32_pd(bgch[k]))));
+				result=_mm_or_si128(result, _mm_slli_epi32(_mm_and_si128(part, byte), k * 8));
+			}
+			_mm_storeu_si128((__m128i*)(tgadr + xx), result);
+		}
+		for (;xx < width;xx++) {
+			tgadr[xx]=ChromaKeyPixel(sadr[xx], bgadr[xx], cb_key, cr_key, tol1, tol2);
+		}
+		sadr+=spitch;
+		bgadr+=bgpitch;
+		tgadr+=tgpitch;
+	}
+}
+
+static void BltChromaKey_32_AVX2(DRAWABLE_DATA& target, const DRAWABLE_DATA& source, const Rect& srect, const Color& key, int tol1, int tol2, int x, int y)
+{
+	if (overlapsGroup(adr(source, srect.left(), srect.top()), adr(target, x, y), 4)) {
+		BltChromaKey_32(target, source, srect, key, tol1, tol2, x, y);
+		return;
+	}
+	if (tol2 < tol1) tol2=tol1;
+	ChromaKeyRows_AVX2((const uint32_t*)adr(source, srect.left(), srect.top()), source.pitch / 4,
+		(const uint32_t*)adr(target, x, y), target.pitch / 4,
+		(uint32_t*)adr(target, x, y), target.pitch / 4,
+		srect.width(), srect.height(), key.getYCb(), key.getYCr(), tol1, tol2);
+}
+
+static void BltBackgroundOnChromaKey_32_AVX2(DRAWABLE_DATA& target, const DRAWABLE_DATA& background, const Rect& srect, const Color& key, int tol1, int tol2, int x, int y)
+{
+	if (overlapsGroup(adr(target, srect.left(), srect.top()), adr(target, x, y), 4)
+		|| overlapsGroup(adr(background, x, y), adr(target, x, y), 4)) {
+		BltBackgroundOnChromaKey_32(target, background, srect, key, tol1, tol2, x, y);
+		return;
+	}
+	if (tol2 < tol1) tol2=tol1;
+	ChromaKeyRows_AVX2((const uint32_t*)adr(target, srect.left(), srect.top()), target.pitch / 4,
+		(const uint32_t*)adr(background, x, y), background.pitch / 4,
+		(uint32_t*)adr(target, x, y), target.pitch / 4,
+		srect.width(), srect.height(), key.getYCb(), key.getYCr(), tol1, tol2);
+}
+#endif	// PPL7_SIMD_X86
+
+static SimdCaps& blitCapsSetting()
+{
+	static SimdCaps caps;
+	return caps;
+}
+
 /*!\brief Blitting-Funktionen initialisieren
  *
  * \desc
@@ -580,6 +1129,10 @@ static void BltBackgroundOnChromaKey_32(DRAWABLE_DATA& target, const DRAWABLE_DA
  * soll (CSurface::AlphaBlt oder CSurface::DrawSprite) oder die Intensität eines
  * Schwarz-Weiss-Bildes verwendet wird, um eine bestimmte Farbe zu zeichnen (CSurface::BltDiffuse).
  *
+ * Bei 32-Bit-Farbformaten werden auf x86-Prozessoren anstelle der skalaren Funktionen
+ * Varianten mit AVX2- oder SSE4.1-Befehlen verwendet, sofern die CPU diese unterstützt
+ * (siehe Grafix::setBlitCaps). Sie liefern bitgenau die gleichen Ergebnisse.
+ *
  * @param[in] s Pointer auf die SURFACE-Struktur der Oberfläche.
  * \exception UnsupportedColorFormatException Wird geworfen, wenn das Farbformat \p format
  * nicht unterstützt wird.
@@ -603,6 +1156,23 @@ void Grafix::initBlits(const RGBFormat& format, GRAFIX_FUNCTIONS* fn)
 			fn->BltBlend=BltBlend_32;
 			fn->BltChromaKey=BltChromaKey_32;
 			fn->BltBackgoundOnChromaKey=BltBackgroundOnChromaKey_32;
+#ifdef PPL7_SIMD_X86
+			if (blitCapsSetting().get() & CPUCAPS::CPU_HAVE_AVX2) {
+				fn->BltAlpha=BltAlpha_32_AVX2;
+				fn->BltColorKey=BltColorKey_32_AVX2;
+				fn->BltDiffuse=BltDiffuse_32_AVX2;
+				fn->BltBlend=BltBlend_32_AVX2;
+				fn->BltChromaKey=BltChromaKey_32_AVX2;
+				fn->BltBackgoundOnChromaKey=BltBackgroundOnChromaKey_32_AVX2;
+			} else if (blitCapsSetting().get() & CPUCAPS::CPU_HAVE_SSE41) {
+				fn->BltAlpha=BltAlpha_32_SSE41;
+				fn->BltColorKey=BltColorKey_32_SSE41;
+				fn->BltDiffuse=BltDiffuse_32_SSE41;
+				fn->BltBlend=BltBlend_32_SSE41;
+				fn->BltChromaKey=BltChromaKey_32_SSE41;
+				fn->BltBackgoundOnChromaKey=BltBackgroundOnChromaKey_32_SSE41;
+			}
+#endif
 			return;
 		case RGBFormat::GREY8:
 		case RGBFormat::A8:
@@ -612,6 +1182,43 @@ void Grafix::initBlits(const RGBFormat& format, GRAFIX_FUNCTIONS* fn)
 	throw UnsupportedColorFormatException("RGBFormat=%s (%i)", (const char*)format.name(), format.format());
 }
 
+/*!\brief Auswahl der Blitting-Funktionen einschränken
+ *
+ * \desc
+ * Legt fest, welche Varianten der Blitting-Funktionen für 32-Bit-Farbformate verwendet
+ * werden. Es werden nur die Bits CPUCAPS::CPU_HAVE_SSE41 und CPUCAPS::CPU_HAVE_AVX2
+ * berücksichtigt, und zwar nur dann, wenn die CPU das jeweilige Feature auch tatsächlich
+ * unterstützt. Mit dem Wert 0 werden ausschließlich die skalaren Implementierungen verwendet.
+ * Die Änderung wirkt sich sofort auf alle bestehenden Drawables aus.
+ *
+ * @param caps Gewünschte Features
+ * @return Liefert die vorher aktiven Features zurück
+ * \note Die Funktion ist für Tests und Benchmarks gedacht und nicht threadsicher. Sie
+ * darf nicht aufgerufen werden, während andere Threads Grafikfunktionen verwenden.
+ */
+uint32_t Grafix::setBlitCaps(uint32_t caps)
+{
+	uint32_t old=blitCapsSetting().set(caps);
+	initBlits(RGBFormat::A8R8G8B8, getGrafixFunctions(RGBFormat::A8R8G8B8));
+	initBlits(RGBFormat::A8B8G8R8, getGrafixFunctions(RGBFormat::A8B8G8R8));
+	initBlits(RGBFormat::X8B8G8R8, getGrafixFunctions(RGBFormat::X8B8G8R8));
+	initBlits(RGBFormat::X8R8G8B8, getGrafixFunctions(RGBFormat::X8R8G8B8));
+	return old;
+}
+
+/*!\brief Aktive Blitting-Funktionen abfragen
+ *
+ * \desc
+ * Liefert zurück, welche Varianten der Blitting-Funktionen aktuell verwendet werden.
+ * Ist kein Bit gesetzt, werden die skalaren Implementierungen verwendet.
+ *
+ * @return Kombination aus CPUCAPS::CPU_HAVE_SSE41 und CPUCAPS::CPU_HAVE_AVX2
+ */
+uint32_t Grafix::blitCaps() const
+{
+	return blitCapsSetting().get();
+}
+
 
 /*!\brief Überprüft, ob eine Blit-Aktion in den Zeichenbereich passt.
  *
@@ -45,6 +45,7 @@
 #ifdef HAVE_MATH_H
 #include <math.h>
 #endif
+#include <algorithm>
 
 #include "ppl7.h"
 #include "ppl7-grafix.h"
@@ -53,6 +54,10 @@
 #ifdef HAVE_FREETYPE2
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
 #endif
 
 
@@ -84,26 +89,239 @@ namespace grafix {
  * Diese Engine unterstützt TrueType, OpenType, Type1 und weitere von der Freetype-Library
  * unterstützte Formate.
  *
+ * Gerenderte Glyphen werden in einem Cache gehalten, so dass jede Glyphe pro Font, Größe,
+ * Antialiasing und Rotation nur einmal von FreeType gerendert werden muss. Auch die Abstände
+ * und Kerning-Paare werden gecached. Die Größe des Caches kann mit
+ * FontEngineFreeType::setCacheSize eingestellt werden.
+ *
  * \see
  * http://www.freetype.org/
  */
 
 
 #ifdef HAVE_FREETYPE2
-typedef struct tagFreeTypeEngineData {
-	FT_Library	ftlib;
-} FREETYPE_ENGINE_DATA;
+/*
+ * Eine gecachte Glyphe. Die Bitmap wird unabhängig vom Antialiasing immer als 8-Bit
+ * Deckungsmaske im Atlas des Strikes abgelegt, monochrome Glyphen enthalten nur 0 und 255.
+ */
+typedef struct tagFreeTypeGlyph {
+	FT_UInt index;		// 0 = Zeichen ist im Font nicht enthalten
+	bool valid;			// false = FT_Load_Glyph ist fehlgeschlagen
+	int left, top;
+	int width, height;
+	FT_Pos advanceX, advanceY;
+	size_t offset;		// Position der Deckungsmaske im Atlas
+} FREETYPE_GLYPH;
+
+typedef struct tagFreeTypeFaceData FREETYPE_FACE_DATA;
+
+/*
+ * Alle Glyphen eines Fonts in einer bestimmten Größe, mit oder ohne Antialiasing und
+ * mit einer bestimmten Rotation.
+ */
+class FreeTypeStrike
+{
+public:
+	FREETYPE_FACE_DATA* face;
+	int size;
+	bool antialias;
+	double rotation;
+	std::unordered_map<uint32_t, FREETYPE_GLYPH> glyphs;
+	std::unordered_map<uint64_t, FT_Vector> kerning;
+	std::vector<uint8_t> atlas;
+	size_t bytes;
+};
+
+typedef std::list<FreeTypeStrike> FreeTypeStrikeList;
 
 typedef struct tagFreeTypeFaceData {
 	FT_Byte* buffer;
 	FT_Face	face;
 	int		kerning;
+	const FreeTypeStrike* active;	// Strike, auf den Größe und Transformation von face eingestellt sind
 } FREETYPE_FACE_DATA;
+
+/*
+ * Glyph-Cache mit LRU-Liste der Strikes, vorne steht der zuletzt verwendete.
+ */
+class FreeTypeGlyphCache
+{
+private:
+	typedef std::map<std::pair<std::pair<const FREETYPE_FACE_DATA*, int>, std::pair<int, double> >, FreeTypeStrikeList::iterator> StrikeMap;
+	FreeTypeStrikeList lru;
+	StrikeMap strikes;
+
+	void activate(FreeTypeStrike& strike);
+	void erase(FreeTypeStrikeList::iterator it);
+
+public:
+	Mutex mutex;
+	size_t usage;
+
+	FreeTypeGlyphCache();
+	FreeTypeStrike& strike(FREETYPE_FACE_DATA* face, const Font& font, double rotation);
+	const FREETYPE_GLYPH& glyph(FreeTypeStrike& strike, uint32_t code);
+	FT_Vector kerning(FreeTypeStrike& strike, FT_UInt left, FT_UInt right);
+	void trim(size_t maxsize);
+	void purge(const FREETYPE_FACE_DATA* face);
+	void clear();
+};
+
+typedef struct tagFreeTypeEngineData {
+	FT_Library	ftlib;
+	FreeTypeGlyphCache cache;
+} FREETYPE_ENGINE_DATA;
+
+// Geschätzter Verwaltungsaufwand pro Glyphe und Kerning-Paar in den Hash-Tabellen
+static const size_t GlyphOverhead=sizeof(FREETYPE_GLYPH) + 32;
+static const size_t KerningOverhead=sizeof(FT_Vector) + 32;
+
+FreeTypeGlyphCache::FreeTypeGlyphCache()
+{
+	usage=0;
+}
+
+FreeTypeStrike& FreeTypeGlyphCache::strike(FREETYPE_FACE_DATA* face, const Font& font, double rotation)
+{
+	StrikeMap::key_type key(std::make_pair(face, font.size()), std::make_pair((int)font.antialias(), rotation));
+	StrikeMap::iterator it=strikes.find(key);
+	if (it != strikes.end()) {
+		if (it->second != lru.begin()) lru.splice(lru.begin(), lru, it->second);
+		return lru.front();
+	}
+	if (FT_Set_Pixel_Sizes(face->face, 0, font.size() + 2) != 0) throw InvalidFontException();
+	face->active=NULL;
+	lru.emplace_front();
+	FreeTypeStrike& s=lru.front();
+	s.face=face;
+	s.size=font.size();
+	s.antialias=font.antialias();
+	s.rotation=rotation;
+	s.bytes=sizeof(FreeTypeStrike);
+	usage+=s.bytes;
+	strikes[key]=lru.begin();
+	return s;
+}
+
+void FreeTypeGlyphCache::activate(FreeTypeStrike& strike)
+{
+	FREETYPE_FACE_DATA* face=strike.face;
+	if (face->active == &strike) return;
+	if (FT_Set_Pixel_Sizes(face->face, 0, strike.size + 2) != 0) throw InvalidFontException();
+	if (strike.rotation != 0.0) {
+		FT_Matrix matrix; /* transformation matrix */
+		double angle=strike.rotation * 3.14159265359 / 180.0;
+		/* set up matrix */
+		matrix.xx = (FT_Fixed)(cos(angle) * 0x10000L);
+		matrix.xy = (FT_Fixed)(sin(angle) * 0x10000L);
+		matrix.yx = (FT_Fixed)(-sin(angle) * 0x10000L);
+		matrix.yy = (FT_Fixed)(cos(angle) * 0x10000L);
+		FT_Set_Transform(face->face, &matrix, NULL);
+	} else {
+		FT_Set_Transform(face->face, NULL, NULL);
+	}
+	face->active=&strike;
+}
+
+const FREETYPE_GLYPH& FreeTypeGlyphCache::glyph(FreeTypeStrike& strike, uint32_t code)
+{
+	std::unordered_map<uint32_t, FREETYPE_GLYPH>::const_iterator it=strike.glyphs.find(code);
+	if (it != strike.glyphs.end()) return it->second;
+	FREETYPE_GLYPH& g=strike.glyphs[code];
+	memset(&g, 0, sizeof(g));
+	strike.bytes+=GlyphOverhead;
+	usage+=GlyphOverhead;
+	g.index=FT_Get_Char_Index(strike.face->face, code);
+	if (!g.index) return g;
+	activate(strike);
+	int error;
+	// Antialiasing
+	if (strike.antialias) {
+		error=FT_Load_Glyph(strike.face->face, g.index, FT_LOAD_DEFAULT | FT_LOAD_RENDER | FT_LOAD_TARGET_NORMAL);
+	} else {
+		error=FT_Load_Glyph(strike.face->face, g.index, FT_LOAD_DEFAULT | FT_LOAD_TARGET_MONO | FT_LOAD_RENDER);
+	}
+	if (error != 0) return g;
+	FT_GlyphSlot slot=strike.face->face->glyph;
+	FT_Bitmap* bitmap=&slot->bitmap;
+	g.valid=true;
+	g.left=slot->bitmap_left;
+	g.top=slot->bitmap_top;
+	g.width=(int)bitmap->width;
+	g.height=(int)bitmap->rows;
+	g.advanceX=slot->advance.x;
+	g.advanceY=slot->advance.y;
+	g.offset=strike.atlas.size();
+	size_t size=(size_t)g.width * g.height;
+	strike.atlas.resize(g.offset + size);
+	strike.bytes+=size;
+	usage+=size;
+	uint8_t* mask=strike.atlas.data() + g.offset;
+	const uint8_t* src=(const uint8_t*)bitmap->buffer;
+	for (int y=0;y < g.height;y++) {
+		if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
+			for (int x=0;x < g.width;x++) mask[x]=(src[x >> 3] & (128 >> (x & 7))) ? 255 : 0;
+		} else {
+			memcpy(mask, src, g.width);
+		}
+		mask+=g.width;
+		src+=bitmap->pitch;
+	}
+	return g;
+}
+
+FT_Vector FreeTypeGlyphCache::kerning(FreeTypeStrike& strike, FT_UInt left, FT_UInt right)
+{
+	uint64_t key=((uint64_t)left << 32) | right;
+	std::unordered_map<uint64_t, FT_Vector>::const_iterator it=strike.kerning.find(key);
+	if (it != strike.kerning.end()) return it->second;
+	activate(strike);
+	FT_Vector k;
+	if (FT_Get_Kerning(strike.face->face, left, right, FT_KERNING_DEFAULT, &k) != 0) {
+		k.x=0;
+		k.y=0;
+	}
+	strike.kerning[key]=k;
+	strike.bytes+=KerningOverhead;
+	usage+=KerningOverhead;
+	return k;
+}
+
+void FreeTypeGlyphCache::erase(FreeTypeStrikeList::iterator it)
+{
+	if (it->face->active == &(*it)) it->face->active=NULL;
+	strikes.erase(StrikeMap::key_type(std::make_pair((const FREETYPE_FACE_DATA*)it->face, it->size),
+		std::make_pair((int)it->antialias, it->rotation)));
+	usage-=it->bytes;
+	lru.erase(it);
+}
+
+void FreeTypeGlyphCache::trim(size_t maxsize)
+{
+	while (usage > maxsize && !lru.empty()) erase(--lru.end());
+}
+
+void FreeTypeGlyphCache::purge(const FREETYPE_FACE_DATA* face)
+{
+	FreeTypeStrikeList::iterator it=lru.begin();
+	while (it != lru.end()) {
+		FreeTypeStrikeList::iterator next=it;
+		++next;
+		if (it->face == face) erase(it);
+		it=next;
+	}
+}
+
+void FreeTypeGlyphCache::clear()
+{
+	while (!lru.empty()) erase(lru.begin());
+}
 #endif
 
 FontEngineFreeType::FontEngineFreeType()
 {
 	ft=NULL;
+	maxCacheSize=4 * 1024 * 1024;
 #ifdef HAVE_FREETYPE2
 #endif
 }
@@ -113,8 +331,9 @@ FontEngineFreeType::~FontEngineFreeType()
 #ifdef HAVE_FREETYPE2
 	FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)ft;
 	if (f) {
+		f->cache.clear();
 		FT_Done_FreeType(f->ftlib);
-		free(f);
+		delete f;
 	}
 #endif
 }
@@ -136,11 +355,10 @@ void FontEngineFreeType::init()
 	throw UnsupportedFeatureException("Freetype2");
 #else
 	if (ft) return;
-	FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)malloc(sizeof(FREETYPE_ENGINE_DATA));
-	if (!f) throw OutOfMemoryException();
+	FREETYPE_ENGINE_DATA* f=new FREETYPE_ENGINE_DATA;
 	int error=FT_Init_FreeType(&f->ftlib);
 	if (error) {
-		free(f);
+		delete f;
 		throw FontEngineInitializationException();
 	}
 	ft=f;
@@ -184,6 +402,7 @@ FontFile* FontEngineFreeType::loadFont(FileObject& file, const String& fontname)
 	String name=fontname;
 	if (name.isEmpty()) name.set(face->face->family_name);
 	face->kerning=(int)FT_HAS_KERNING(face->face);		// Kerning unterstützt?
+	face->active=NULL;
 	FontFile* ff=new FontFile;
 	ff->Name=fontname;
 	ff->engine=this;
@@ -201,6 +420,12 @@ void FontEngineFreeType::deleteFont(FontFile* file)
 	if (file->engine != this) throw InvalidFontEngineException();
 	FREETYPE_FACE_DATA* face=(FREETYPE_FACE_DATA*)file->priv;
 	if (face) {
+		FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)ft;
+		if (f) {
+			f->cache.mutex.lock();
+			f->cache.purge(face);
+			f->cache.mutex.unlock();
+		}
 		FT_Done_Face(face->face);
 		free(face->buffer);
 		free(face);
@@ -210,6 +435,72 @@ void FontEngineFreeType::deleteFont(FontFile* file)
 #endif
 }
 
+/*!\brief Maximale Größe des Glyph-Caches setzen
+ *
+ * \desc
+ * Legt fest, wie viel Speicher die gecachten Glyphen aller Fonts dieser Engine maximal
+ * belegen dürfen. Wird die Größe überschritten, werden die am längsten nicht mehr
+ * verwendeten Kombinationen aus Font, Größe, Antialiasing und Rotation verworfen.
+ * Mit 0 wird der Cache abgeschaltet, Glyphen werden dann nur innerhalb eines Aufrufs
+ * von FontEngineFreeType::render oder FontEngineFreeType::measure wiederverwendet.
+ * Der Default ist 4 MB.
+ *
+ * @param bytes Maximale Größe in Bytes
+ */
+void FontEngineFreeType::setCacheSize(size_t bytes)
+{
+	maxCacheSize=bytes;
+#ifdef HAVE_FREETYPE2
+	FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)ft;
+	if (f) {
+		f->cache.mutex.lock();
+		f->cache.trim(maxCacheSize);
+		f->cache.mutex.unlock();
+	}
+#endif
+}
+
+/*!\brief Maximale Größe des Glyph-Caches
+ *
+ * @return Maximale Größe in Bytes
+ */
+size_t FontEngineFreeType::cacheSize() const
+{
+	return maxCacheSize;
+}
+
+/*!\brief Aktuell vom Glyph-Cache belegter Speicher
+ *
+ * @return Geschätzte Größe in Bytes
+ */
+size_t FontEngineFreeType::cacheUsage() const
+{
+#ifdef HAVE_FREETYPE2
+	FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)ft;
+	if (f) {
+		f->cache.mutex.lock();
+		size_t usage=f->cache.usage;
+		f->cache.mutex.unlock();
+		return usage;
+	}
+#endif
+	return 0;
+}
+
+/*!\brief Glyph-Cache leeren
+ */
+void FontEngineFreeType::clearCache()
+{
+#ifdef HAVE_FREETYPE2
+	FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)ft;
+	if (f) {
+		f->cache.mutex.lock();
+		f->cache.clear();
+		f->cache.mutex.unlock();
+	}
+#endif
+}
+
 #ifdef HAVE_FREETYPE2
 static void putPixel(Drawable& draw, int x, int y, const Color& color, int intensity)
 {
@@ -232,45 +523,73 @@ static void putPixel(Drawable& draw, int x, int y, const Color& color, int inten
 	draw.putPixel(x, y, Color(red, green, blue, alpha));
 }
 
-
-static void renderGlyphAA(Drawable& draw, FT_Bitmap* bitmap, int x, int y, const Color& color)
+// Font-Blitter für gecachte Glyphen
+typedef struct tagGLYPHMASK {
+	const uint8_t* data;		// 8-Bit Deckungsmaske
+	uint32_t datapitch;
+	char* target;
+	uint32_t pitch;
+	int width;
+	int height;
+	uint32_t color;				// Schriftfarbe im Format der Zeichenfläche
+	const uint8_t* alpha;		// Tabelle Deckung => Alpha
+} GLYPHMASK;
+
+/*
+ * Mischt eine Deckungsmaske auf eine Zeichenfläche mit 32 Bit pro Pixel. Das Ergebnis
+ * ist identisch mit putPixel, die drei Farbkanäle werden unabhängig von ihrer
+ * Reihenfolge gleich behandelt, der Alphakanal liegt immer in den oberen 8 Bit.
+ */
+static void BltGlyphMask_AA8_32(const GLYPHMASK& g)
 {
-	uint8_t v=0;
-	uint8_t* glyph=(uint8_t*)bitmap->buffer;
-	for (unsigned int gy=0;gy < (unsigned int)bitmap->rows;gy++) {
-		for (unsigned int gx=0;gx < (unsigned int)bitmap->width;gx++) {
-			v=glyph[gx];
-			if (v > 0) {
-				putPixel(draw, x + gx, y + gy, color, v);
-				//draw.blendPixel(x+gx,y+gy,color,v);
+	uint32_t opaque=g.color | 0xff000000;
+	uint32_t c0=g.color & 255, c1=(g.color >> 8) & 255, c2=(g.color >> 16) & 255;
+	const uint8_t* src=g.data;
+	char* tgt=g.target;
+	for (int y=0;y < g.height;y++) {
+		uint32_t* t=(uint32_t*)tgt;
+		for (int x=0;x < g.width;x++) {
+			uint32_t a=g.alpha[src[x]];
+			if (a == 0) continue;
+			if (a == 255) {
+				t[x]=opaque;
+				continue;
 			}
+			uint32_t bg=t[x];
+			uint32_t reva=255 - a;
+			uint32_t ba=bg >> 24;
+			t[x]=((bg & 255) * reva + c0 * a) / 255
+				| ((((bg >> 8) & 255) * reva + c1 * a) / 255) << 8
+				| ((((bg >> 16) & 255) * reva + c2 * a) / 255) << 16
+				| (ba + (255 - ba) * a / 255) << 24;
 		}
-		glyph+=bitmap->pitch;
+		src+=g.datapitch;
+		tgt+=g.pitch;
 	}
 }
 
-static void renderGlyphMono(Drawable& draw, FT_Bitmap* bitmap, int x, int y, const Color& color)
+static void renderGlyph(Drawable& draw, const FREETYPE_GLYPH& glyph, const uint8_t* mask, int x, int y, const Color& color, GLYPHMASK* blt)
 {
-	uint8_t v=0;
-	uint8_t* glyph=(uint8_t*)bitmap->buffer;
-	for (unsigned int gy=0;gy < (unsigned int)bitmap->rows;gy++) {
-		uint8_t bitcount=0;
-		uint8_t bytecount=0;
-		for (unsigned int gx=0;gx < (unsigned int)bitmap->width;gx++) {
-			if (!bitcount) {
-				v=glyph[bytecount];
-				bitcount=8;
-				bytecount++;
+	if (!blt) {
+		for (int gy=0;gy < glyph.height;gy++) {
+			for (int gx=0;gx < glyph.width;gx++) {
+				if (mask[gx] > 0) putPixel(draw, x + gx, y + gy, color, mask[gx]);
 			}
-			if (v & 128) {
-				putPixel(draw, x + gx, y + gy, color, 255);
-				//draw.alphaPixel(x+gx,y+gy,color);
-			}
-			v=v << 1;
-			bitcount--;
+			mask+=glyph.width;
 		}
-		glyph+=bitmap->pitch;
+		return;
 	}
+	int x1=std::max(x, 0);
+	int y1=std::max(y, 0);
+	int x2=std::min(x + glyph.width, draw.width());
+	int y2=std::min(y + glyph.height, draw.height());
+	if (x1 >= x2 || y1 >= y2) return;
+	blt->data=mask + (y1 - y) * glyph.width + (x1 - x);
+	blt->datapitch=glyph.width;
+	blt->target=(char*)draw.adr(x1, y1);
+	blt->width=x2 - x1;
+	blt->height=y2 - y1;
+	BltGlyphMask_AA8_32(*blt);
 }
 
 #endif
@@ -281,79 +600,71 @@ void FontEngineFreeType::render(const FontFile& file, const Font& font, Drawable
 	throw UnsupportedFeatureException("Freetype2");
 #else
 	if (file.priv == NULL) throw InvalidFontException();
+	FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)ft;
+	if (!f) throw FontEngineUninitializedException();
 	FREETYPE_FACE_DATA* face=(FREETYPE_FACE_DATA*)file.priv;
-	int error=FT_Set_Pixel_Sizes(face->face, 0, font.size() + 2);
-	if (error != 0) throw InvalidFontException();
+
+	// Auf Zeichenflächen mit 32 Bit pro Pixel werden die Glyphen direkt geblittet
+	GLYPHMASK g;
+	GLYPHMASK* blt=NULL;
+	uint8_t alpha[256];
+	RGBFormat format=draw.rgbformat();
+	if (format == RGBFormat::A8R8G8B8 || format == RGBFormat::X8R8G8B8
+		|| format == RGBFormat::A8B8G8R8 || format == RGBFormat::X8B8G8R8) {
+		for (int i=0;i < 256;i++) alpha[i]=(uint8_t)(color.alpha() * i / 255);
+		g.pitch=draw.pitch();
+		g.color=(uint32_t)draw.rgb(color);
+		g.alpha=alpha;
+		blt=&g;
+	}
 
 	int orgx=x << 6;
 	int orgy=y << 6;
 	int lastx=orgx;
-	bool rotate=false;
-	FT_Matrix matrix; /* transformation matrix */
-	if (font.rotation() != 0.0) {
-		rotate=true;
-		double angle=font.rotation() * 3.14159265359 / 180.0;
-		/* set up matrix */
-		matrix.xx = (FT_Fixed)(cos(angle) * 0x10000L);
-		matrix.xy = (FT_Fixed)(sin(angle) * 0x10000L);
-		matrix.yx = (FT_Fixed)(-sin(angle) * 0x10000L);
-		matrix.yy = (FT_Fixed)(cos(angle) * 0x10000L);
-		FT_Set_Transform(face->face, &matrix, NULL);
-	} else {
-		FT_Set_Transform(face->face, NULL, NULL);
-	}
+	bool rotate=(font.rotation() != 0.0);
 
-	FT_GlyphSlot slot=face->face->glyph;
-	FT_UInt			glyph_index, last_glyph=0;
+	FT_UInt			last_glyph=0;
 	FT_Vector		kerning;
-	kerning.x=0;
-	kerning.y=0;
-
 	size_t p=0;
 	size_t textlen=text.len();
 
-	while (p < textlen) {
-		int code=text[p];
-		p++;
-		if (code == 10) {											// Newline
-			lastx=orgx;
-			orgy+=(font.size() + 2) << 6;
-			last_glyph=0;
-		} else {
-			y=orgy;
-			x=lastx;
-			glyph_index=FT_Get_Char_Index(face->face, code);
-			if (!glyph_index) continue;
-			// Antialiasing
-			if (font.antialias()) {
-				error=FT_Load_Glyph(face->face, glyph_index, FT_LOAD_DEFAULT | FT_LOAD_RENDER | FT_LOAD_TARGET_NORMAL);
-			} else {
-				error=FT_Load_Glyph(face->face, glyph_index, FT_LOAD_DEFAULT | FT_LOAD_TARGET_MONO | FT_LOAD_RENDER);
-			}
-			if (error != 0) continue;
-			//x=x+(slot->bitmap_left<<6);
-			//y=y-(slot->bitmap_top<<6);
-			if (face->kerning > 0 && last_glyph > 0 && rotate == false) {
-				FT_Get_Kerning(face->face, last_glyph, glyph_index, FT_KERNING_DEFAULT, &kerning);
-				x+=kerning.x;
-				y+=kerning.y;
-			}
-
-			if (font.antialias()) {
-				renderGlyphAA(draw, &slot->bitmap, (x >> 6) + slot->bitmap_left,
-					(y >> 6) - slot->bitmap_top, color);
+	f->cache.mutex.lock();
+	try {
+		FreeTypeStrike& strike=f->cache.strike(face, font, font.rotation());
+		while (p < textlen) {
+			int code=text[p];
+			p++;
+			if (code == 10) {											// Newline
+				lastx=orgx;
+				orgy+=(font.size() + 2) << 6;
+				last_glyph=0;
 			} else {
-				renderGlyphMono(draw, &slot->bitmap, (x >> 6) + slot->bitmap_left,
-					(y >> 6) - slot->bitmap_top, color);
-			}
-			if (font.drawUnderline()) {
-
+				y=orgy;
+				x=lastx;
+				const FREETYPE_GLYPH& glyph=f->cache.glyph(strike, code);
+				if (!glyph.index || !glyph.valid) continue;
+				if (face->kerning > 0 && last_glyph > 0 && rotate == false) {
+					kerning=f->cache.kerning(strike, last_glyph, glyph.index);
+					x+=kerning.x;
+					y+=kerning.y;
+				}
+				renderGlyph(draw, glyph, strike.atlas.data() + glyph.offset, (x >> 6) + glyph.left,
+					(y >> 6) - glyph.top, color, blt);
+				if (font.drawUnderline()) {
+
+				}
+				lastx=x + glyph.advanceX;
+				orgy-=glyph.advanceY;
+				last_glyph=glyph.index;
 			}
-			lastx=x + slot->advance.x;
-			orgy-=slot->advance.y;
-			last_glyph=glyph_index;
 		}
+		f->cache.trim(maxCacheSize);
+	} catch (...) {
+		f->cache.trim(maxCacheSize);
+		f->cache.mutex.unlock();
+		throw;
 	}
+	f->cache.mutex.unlock();
 #endif
 }
 
@@ -364,49 +675,45 @@ Size FontEngineFreeType::measure(const FontFile& file, const Font& font, const W
 	throw UnsupportedFeatureException("Freetype2");
 #else
 	if (file.priv == NULL) throw InvalidFontException();
+	FREETYPE_ENGINE_DATA* f=(FREETYPE_ENGINE_DATA*)ft;
+	if (!f) throw FontEngineUninitializedException();
 	FREETYPE_FACE_DATA* face=(FREETYPE_FACE_DATA*)file.priv;
-	int error=FT_Set_Pixel_Sizes(face->face, 0, font.size() + 2);
-	if (error != 0) throw InvalidFontException();
-
-	FT_Set_Transform(face->face, NULL, NULL);
 
 	int width=0, height=0;
 
-	FT_GlyphSlot slot=face->face->glyph;
-	FT_UInt			glyph_index, last_glyph=0;
+	FT_UInt			last_glyph=0;
 	FT_Vector		kerning;
-	kerning.x=0;
-	kerning.y=0;
 	size_t p=0;
 	size_t textlen=text.len();
-	while (p < textlen) {
-		int code=text[p];
-		p++;
-		if (code == 10) {											// Newline
-			width=0;
-			height+=(font.size() + 2);
-			last_glyph=0;
-		} else {
-			glyph_index=FT_Get_Char_Index(face->face, code);
-			if (!glyph_index) continue;
-			// Antialiasing
-			if (font.antialias()) {
-				error=FT_Load_Glyph(face->face, glyph_index, FT_LOAD_DEFAULT | FT_LOAD_RENDER | FT_LOAD_TARGET_NORMAL);
+	f->cache.mutex.lock();
+	try {
+		FreeTypeStrike& strike=f->cache.strike(face, font, 0.0);
+		while (p < textlen) {
+			int code=text[p];
+			p++;
+			if (code == 10) {											// Newline
+				width=0;
+				height+=(font.size() + 2);
+				last_glyph=0;
 			} else {
-				error=FT_Load_Glyph(face->face, glyph_index, FT_LOAD_DEFAULT | FT_LOAD_TARGET_MONO | FT_LOAD_RENDER);
-			}
-			if (error != 0) continue;
-			//x=x+slot->bitmap_left;
-			//y=y-slot->bitmap_top;
-			if (face->kerning > 0 && last_glyph > 0) {
-				error=FT_Get_Kerning(face->face, last_glyph, glyph_index, FT_KERNING_DEFAULT, &kerning);
-				width+=kerning.x;
+				const FREETYPE_GLYPH& glyph=f->cache.glyph(strike, code);
+				if (!glyph.index || !glyph.valid) continue;
+				if (face->kerning > 0 && last_glyph > 0) {
+					kerning=f->cache.kerning(strike, last_glyph, glyph.index);
+					width+=kerning.x;
+				}
+				width+=glyph.advanceX;
+				if (width > s.width) s.width=width;
+				last_glyph=glyph.index;
 			}
-			width+=(slot->advance.x);
-			if (width > s.width) s.width=width;
-			last_glyph=glyph_index;
 		}
+		f->cache.trim(maxCacheSize);
+	} catch (...) {
+		f->cache.trim(maxCacheSize);
+		f->cache.mutex.unlock();
+		throw;
 	}
+	f->cache.mutex.unlock();
 	s.setHeight(height + font.size() + 2);
 	s.width=s.width >> 6;
 	return s;
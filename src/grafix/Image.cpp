@@ -389,6 +389,70 @@ void Image::load(FileObject &file, const RGBFormat &format)
 	filter->load(file,*this,img);
 }
 
+/*!\brief Grafik verkleinert aus einer Datei laden
+ *
+ * \desc
+ * Mit dieser Funktion wird eine Grafik aus einer Datei geladen, die anschließend nur in
+ * mindestens der Größe \p minsize benötigt wird, beispielsweise für Vorschaubilder.
+ * Unterstützt der Grafikfilter das Verkleinern beim Dekodieren (z.B. JPEG und PNG), wird
+ * die Grafik um einen ganzzahligen Faktor verkleinert geladen, ohne dabei kleiner als
+ * \p minsize zu werden. Das spart Rechenzeit und Speicher. Andernfalls wird die Grafik
+ * in Originalgröße geladen. Die exakte Zielgröße kann anschließend mit Drawable::scale
+ * erzeugt werden.
+ *
+ * @param Filename Der Dateiname
+ * @param minsize Mindestgröße der geladenen Grafik
+ * @param format Optionales Farbformat. Falls nicht angegeben, wird das Farbformat der Grafikdatei
+ * verwendet. Andernfalls werden die Originalfarben der Grafikdatei in das angegebene Format konvertiert.
+ */
+void Image::load(const String &Filename, const Size &minsize, const RGBFormat &format)
+{
+	File ff;
+	ff.open(Filename,File::READ);
+	load(ff,minsize,format);
+}
+
+/*!\brief Grafik verkleinert aus einem Speicherbereich laden
+ *
+ * \desc
+ * Wie Image::load(const String &Filename, const Size &minsize, const RGBFormat &format), die
+ * Grafik wird jedoch aus dem Speicherbereich \p Mem geladen.
+ *
+ * @param Mem Referenz auf einen Speicherbereich
+ * @param minsize Mindestgröße der geladenen Grafik
+ * @param format Optionales Farbformat
+ */
+void Image::load(const ByteArrayPtr &Mem, const Size &minsize, const RGBFormat &format)
+{
+	MemFile ff(Mem);
+	load(ff,minsize,format);
+}
+
+/*!\brief Grafik verkleinert aus einer geöffneten Datei laden
+ *
+ * \desc
+ * Wie Image::load(const String &Filename, const Size &minsize, const RGBFormat &format), die
+ * Grafik wird jedoch aus der bereits geöffneten Datei \p file geladen.
+ *
+ * @param file Referenz auf eine bereits geöffnete Datei.
+ * @param minsize Mindestgröße der geladenen Grafik
+ * @param format Optionales Farbformat
+ */
+void Image::load(FileObject &file, const Size &minsize, const RGBFormat &format)
+{
+	Grafix *gfx=GetGrafix();
+	IMAGE img;
+	ImageFilter *filter=gfx->findImageFilter(file,img);
+	if (format!=RGBFormat::unknown) img.format=format;
+	int denominator=filter->scaleDenominator(img,minsize);
+	if (denominator>1) {
+		img.width=(img.width+denominator-1)/denominator;
+		img.height=(img.height+denominator-1)/denominator;
+	}
+	create(img.width,img.height,img.format);
+	filter->loadScaled(file,*this,img,denominator);
+}
+
 /*!\brief Anzahl Bytes, die durch diese Grafik belegt sind
  *
  * \desc
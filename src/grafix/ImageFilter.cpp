@@ -224,6 +224,61 @@ void ImageFilter::load(FileObject& file, Drawable& surface, IMAGE& img)
 	throw UnimplementedVirtualFunctionException();
 }
 
+/*!\brief Verkleinerungsfaktor für das Laden bestimmen
+ *
+ * \desc
+ * Diese Funktion wird von Image::load aufgerufen, wenn eine Mindestgröße angegeben wurde.
+ * Filter, die eine Grafik bereits beim Dekodieren verkleinern können, liefern den größten
+ * Teiler zurück, bei dem die Grafik noch mindestens \p minsize groß ist. Breite und Höhe
+ * der geladenen Grafik sind dann jeweils auf \p denominator aufgerundet geteilt.
+ * Die Basisklasse liefert immer 1 zurück.
+ *
+ * @param[in] img Die von ImageFilter::ident gefüllte IMAGE-Struktur
+ * @param[in] minsize Gewünschte Mindestgröße
+ * @return Teiler, mit dem ImageFilter::loadScaled aufgerufen wird
+ */
+int ImageFilter::scaleDenominator(const IMAGE& img, const Size& minsize)
+{
+	return 1;
+}
+
+/*!\brief Grafik verkleinert laden
+ *
+ * \desc
+ * Lädt die Grafik um den Faktor \p denominator verkleinert in \p surface. Die Basisklasse
+ * unterstützt nur den Teiler 1 und ruft ImageFilter::load auf.
+ *
+ * @param[in] file Eine geöffnete Datei
+ * @param[in] surface Zeichenfläche in der verkleinerten Größe
+ * @param[in] img Die von ImageFilter::ident gefüllte IMAGE-Struktur
+ * @param[in] denominator Von ImageFilter::scaleDenominator gelieferter Teiler
+ * @exception IllegalArgumentException Der Teiler wird nicht unterstützt
+ */
+void ImageFilter::loadScaled(FileObject& file, Drawable& surface, IMAGE& img, int denominator)
+{
+	if (denominator != 1) throw IllegalArgumentException("ImageFilter::loadScaled: denominator %d", denominator);
+	load(file, surface, img);
+}
+
+/*!\brief Größten Zweierpotenz-Teiler für eine Mindestgröße ermitteln
+ *
+ * \desc
+ * Hilfsfunktion für ImageFilter::scaleDenominator: liefert den größten Teiler aus 1, 2, 4, ...
+ * \p maxdenominator, bei dem Breite und Höhe der Grafik aufgerundet geteilt noch mindestens
+ * so groß sind wie \p minsize.
+ */
+int ImageFilter::powerOfTwoDenominator(const IMAGE& img, const Size& minsize, int maxdenominator)
+{
+	if (minsize.width < 1 || minsize.height < 1) return 1;
+	int denominator=1;
+	while (denominator * 2 <= maxdenominator) {
+		int d=denominator * 2;
+		if ((img.width + d - 1) / d < minsize.width || (img.height + d - 1) / d < minsize.height) break;
+		denominator=d;
+	}
+	return denominator;
+}
+
 void ImageFilter::save(const Drawable& surface, FileObject& file, const Rect& area, const AssocArray& param)
 {
 	Drawable draw=surface.getDrawable(area);
@@ -174,7 +174,6 @@ void ImageFilter_BMP::load(FileObject& file, Drawable& surface, IMAGE& img)
 
 	b1= (address + Peek32((char*)(address + 10)));
 
-	int x, y;
 	switch (img.bitdepth) {
 	case 8:					// 8-Bit
 		if (Peek32((char*)(bmia + 16)) == 0) {	// nur unkomprimiert
@@ -200,43 +199,30 @@ void ImageFilter_BMP::load(FileObject& file, Drawable& surface, IMAGE& img)
 			}
 			// Surface hat eine hoehere Bittiefe, jeder Pixel muss
 			// umgerechnet werden
+			PixelConverter conv(RGBFormat::Palette, surface.rgbformat());
+			RGBQUAD* rgbq= (RGBQUAD*)(bmia + Peek32((char*)bmia));
+			for (int i=0;i < 256;i++) {
+				conv.setPaletteColor(i, Color(rgbq[i].rgbRed, rgbq[i].rgbGreen, rgbq[i].rgbBlue, 255));
+			}
 			b1=b1 + img.height * sourcebytesperline;
-			RGBQUAD* basergbq= (RGBQUAD*)(address + 18 + 36) - 1;
-			//Debug.Printf ("basergbq=%u\n",basergbq);
-
 			for (int y=0;y < img.height;y++) {
 				b1-=sourcebytesperline;
-				for (int x=0;x < img.width;x++) {
-					uint8_t pixel=b1[x];
-					RGBQUAD* rgbq= basergbq + pixel;
-					surface.putPixel(x, y, Color(rgbq->rgbRed, rgbq->rgbGreen, rgbq->rgbBlue, 255));
-				}
-
+				conv.writeRow(surface, y, b1, img.width);
 			}
 			return;
 		}
 		break;
 	case 24:			// 24-Bit
-		b1=b1 + img.height * img.pitch;
-		//DLOGLEVEL(8) ("PriSurf=%u",PriSurf);
-
-		for (y=0;y < img.height;y++) {
-			b1-=img.pitch;
-			for (x=0;x < img.width;x++) {
-				surface.putPixel(x, y, Color(b1[x * 3 + 2], b1[x * 3 + 1], b1[x * 3 + 0], 255));
-			}
-		}
-		return;
 	case 32:			// 32-Bit
+	{
+		PixelConverter conv(img.bitdepth == 24 ? RGBFormat::R8G8B8 : RGBFormat::A8R8G8B8, surface.rgbformat());
 		b1=b1 + img.height * img.pitch;
-		for (y=0;y < img.height;y++) {
+		for (int y=0;y < img.height;y++) {
 			b1-=img.pitch;
-			for (x=0;x < img.width;x++) {
-				surface.putPixel(x, y, Color(b1[x * 4 + 2], b1[x * 4 + 1], b1[x * 4 + 0], b1[x * 4 + 3]));
-			}
+			conv.writeRow(surface, y, b1, img.width);
 		}
 		return;
-
+	}
 
 	} // end switch
 	throw IllegalImageFormatException();
@@ -244,7 +230,6 @@ void ImageFilter_BMP::load(FileObject& file, Drawable& surface, IMAGE& img)
 
 void ImageFilter_BMP::save(const Drawable& surface, FileObject& file, const AssocArray& param)
 {
-	Color pixel;
 	uint32_t bpp, bfOffBits;
 	bpp=surface.bytesPerPixel();
 	if (bpp == 3) {
@@ -307,29 +292,10 @@ void ImageFilter_BMP::save(const Drawable& surface, FileObject& file, const Asso
 
 		char* img=bmh + bfOffBits;
 
-		if (bpp == 3) {
-			for (int y=(surface.height() - 1);y >= 0;y--) {
-				for (int x=0;x < (surface.width());x++) {
-					pixel=surface.getPixel(x, y);
-					img[x * bpp]=(uint8_t)pixel.blue();
-					img[x * bpp + 1]=(uint8_t)pixel.green();
-					img[x * bpp + 2]=(uint8_t)pixel.red();
-				}
-				img+=surface.width() * bpp;
-
-			}
-		} else if (bpp == 4) {
-			for (int y=(surface.height() - 1);y >= 0;y--) {
-				for (int x=0;x < (surface.width());x++) {
-					pixel=surface.getPixel(x, y);
-					img[x * bpp]=(uint8_t)pixel.blue();
-					img[x * bpp + 1]=(uint8_t)pixel.green();
-					img[x * bpp + 2]=(uint8_t)pixel.red();
-					img[x * bpp + 3]=(uint8_t)pixel.alpha();
-				}
-				img+=surface.width() * bpp;
-
-			}
+		PixelConverter conv(surface.rgbformat(), bpp == 3 ? RGBFormat::R8G8B8 : RGBFormat::A8R8G8B8);
+		for (int y=(surface.height() - 1);y >= 0;y--) {
+			conv.readRow(surface, y, img, surface.width());
+			img+=surface.width() * bpp;
 		}
 
 		file.write(buffer, size);
@@ -367,6 +367,13 @@ static void ReadImage (Drawable &surface, FileObject *fd, int len, int height, u
 			;
 		return;
 	}
+	PixelConverter conv(RGBFormat::Palette,surface.rgbformat());
+	for (int i=0;i<MAXCOLORMAPSIZE;i++) {
+		conv.setPaletteColor(i,Color(cmap[CM_RED][i],cmap[CM_GREEN][i],cmap[CM_BLUE][i]));
+	}
+	// Die Indizes werden zeilenweise gesammelt und dann in einem Rutsch umgewandelt
+	ByteArray rowbuffer(len>0 ? len : 1);
+	unsigned char *row=(unsigned char*)rowbuffer.ptr();
 	while ((v = LWZReadByte(fd,FALSE,c)) >= 0 ) {
 		/* This how we recognize which colors are actually used. */
 		/*
@@ -374,10 +381,11 @@ static void ReadImage (Drawable &surface, FileObject *fd, int len, int height, u
                        im->open[v] = 0;
                }
 		 */
-		surface.putPixel(xpos,ypos,Color(cmap[CM_RED][v],cmap[CM_GREEN][v],cmap[CM_BLUE][v]));
+		row[xpos]=(unsigned char)v;
 		//gdImageSetPixel(im, xpos, ypos, v);
 		++xpos;
 		if (xpos == len) {
+			conv.writeRow(surface,ypos,row,len);
 			xpos = 0;
 			if (interlace) {
 				switch (pass) {
@@ -410,6 +418,7 @@ static void ReadImage (Drawable &surface, FileObject *fd, int len, int height, u
 		if (ypos >= height)
 			break;
 	}
+	if (xpos > 0) conv.writeRow(surface,ypos,row,xpos);	// Unvollständige letzte Zeile
 	fini:
 	if (LWZReadByte(fd,FALSE,c)>=0) {
 		/* Ignore extra */
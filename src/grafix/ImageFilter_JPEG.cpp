@@ -436,8 +436,30 @@ int ImageFilter_JPEG::ident(FileObject &file, IMAGE &img)
 
 
 void ImageFilter_JPEG::load(FileObject &file, Drawable &surface, IMAGE &img)
+{
+	loadScaled(file,surface,img,1);
+}
+
+/*!\brief Verkleinerungsfaktor für das Laden bestimmen
+ *
+ * \desc
+ * JPEG-Grafiken können von libjpeg bereits bei der inversen DCT um den Faktor 2, 4 oder 8
+ * verkleinert werden. Dabei entfällt ein Großteil der Rechenzeit und des Speicherbedarfs.
+ */
+int ImageFilter_JPEG::scaleDenominator(const IMAGE &img, const Size &minsize)
 {
 #ifdef HAVE_JPEG
+	return powerOfTwoDenominator(img,minsize,8);
+#else
+	return 1;
+#endif
+}
+
+void ImageFilter_JPEG::loadScaled(FileObject &file, Drawable &surface, IMAGE &img, int denominator)
+{
+#ifdef HAVE_JPEG
+	if (denominator!=1 && denominator!=2 && denominator!=4 && denominator!=8)
+		throw IllegalArgumentException("ImageFilter_JPEG::loadScaled: denominator %d",denominator);
 	char *buffer;
 	const char *address=file.map(0,256);
 	if (address==NULL) throw NullPointerException();
@@ -478,29 +500,35 @@ void ImageFilter_JPEG::load(FileObject &file, Drawable &surface, IMAGE &img)
 			jpeg_load_dht( &cinfo, jpeg_odml_dht, cinfo.ac_huff_tbl_ptrs, cinfo.dc_huff_tbl_ptrs );
 		}
 		cinfo.out_color_components=JCS_RGB;
+		cinfo.scale_num=1;
+		cinfo.scale_denom=denominator;
 		jpeg_start_decompress(&cinfo);
+		if (denominator>1 && ((int)cinfo.output_width!=surface.width() || (int)cinfo.output_height!=surface.height())) {
+			jpeg_destroy_decompress(&cinfo);
+			throw IllegalImageFormatException("JPEG output size %ux%u does not match surface",cinfo.output_width,cinfo.output_height);
+		}
+		RGBFormat rowformat;
+		if (cinfo.output_components==1) rowformat=RGBFormat::GREY8;
+		else if (cinfo.output_components==3) rowformat=RGBFormat::B8G8R8;
+		else {
+			jpeg_destroy_decompress(&cinfo);
+			throw UnsupportedColorFormatException("JPEG with %d components",cinfo.output_components);
+		}
+		PixelConverter conv(rowformat,surface.rgbformat());
 		size_t buffersize=cinfo.output_width * cinfo.output_components;
 		buffer=(char *)malloc(buffersize);
 		if (!buffer) throw OutOfMemoryException();
-		uint32_t y=0;
-		while (cinfo.output_scanline < cinfo.output_height) {
-			jpeg_read_scanlines (&cinfo,(unsigned char **)&buffer,1);
-			uint32_t rot=0, gruen=0, blau=0;
-
-			if (img.bitdepth==8) {
-				for (uint32_t x=0;x<cinfo.output_width;x++) {
-					rot=Peek8(buffer+x);
-					surface.putPixel(x,y,Color(rot,rot,rot));
-				}
-			} else {
-				for (uint32_t x=0;x<cinfo.output_width;x++) {
-					rot=Peek8(buffer+x*3+0);
-					gruen=Peek8(buffer+x*3+1);
-					blau=Peek8(buffer+x*3+2);
-					surface.putPixel(x,y,Color(rot,gruen,blau));
-				}
+		int y=0;
+		try {
+			while (cinfo.output_scanline < cinfo.output_height) {
+				jpeg_read_scanlines (&cinfo,(unsigned char **)&buffer,1);
+				conv.writeRow(surface,y,buffer,cinfo.output_width);
+				y++;
 			}
-			y++;
+		} catch (...) {
+			free (buffer);
+			jpeg_destroy_decompress(&cinfo);
+			throw;
 		}
 		free (buffer);
 		//jpeg_finish_decompress(&cinfo);
@@ -514,7 +542,7 @@ void ImageFilter_JPEG::load(FileObject &file, Drawable &surface, IMAGE &img)
 void ImageFilter_JPEG::save (const Drawable &surface, FileObject &file, const AssocArray &param)
 {
 #ifdef HAVE_JPEG
-	int x,y;
+	int y;
 	char *buffer;
 
 	int	quality=85;		// 0-100									default=85
@@ -566,14 +594,9 @@ void ImageFilter_JPEG::save (const Drawable &surface, FileObject &file, const As
 	cinfo.smoothing_factor=smooth;
 
 	jpeg_start_compress(&cinfo,true);
-	Color farbe;
+	PixelConverter conv(surface.rgbformat(),RGBFormat::B8G8R8);
 	for (y=0;y<surface.height();y++) {
-		for (x=0;x<surface.width();x++) {
-			farbe=surface.getPixel(x,y);
-			buffer[x*3]=(uint8_t)farbe.red();
-			buffer[x*3+1]=(uint8_t)farbe.green();
-			buffer[x*3+2]=(uint8_t)farbe.blue();
-		}
+		conv.readRow(surface,y,buffer,surface.width());
 		jpeg_write_scanlines(&cinfo,row_pointer,1);
 	}
 	jpeg_finish_compress(&cinfo);
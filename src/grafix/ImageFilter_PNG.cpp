@@ -42,6 +42,8 @@
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
+#include <vector>
+#include <algorithm>
 #include "ppl7.h"
 #include "ppl7-grafix.h"
 
@@ -186,10 +188,6 @@ int ImageFilter_PNG::ident(FileObject &file, IMAGE &img)
 				break;
 		};
 
-		if (png_get_interlace_type(png_ptr,info_ptr)!=PNG_INTERLACE_NONE) {	// Interlaced wird nicht unterstützt
-			supported=false;
-		}
-
 		png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
 		if (!supported) {
 			return 0;
@@ -206,7 +204,114 @@ int ImageFilter_PNG::ident(FileObject &file, IMAGE &img)
 
 void ImageFilter_PNG::load(FileObject &file, Drawable &surface, IMAGE &img)
 {
+	loadScaled(file,surface,img,1);
+}
+
+/*!\brief Verkleinerungsfaktor für das Laden bestimmen
+ *
+ * \desc
+ * PNG-Grafiken können um den Faktor 2, 4 oder 8 verkleinert geladen werden. Bei Grafiken
+ * mit Adam7-Interlacing werden dabei nur die ersten Durchgänge dekodiert, bei allen anderen
+ * werden die Zeilen beim Dekodieren zu Blöcken gemittelt, so dass die Grafik nie vollständig
+ * im Speicher liegt.
+ */
+int ImageFilter_PNG::scaleDenominator(const IMAGE &img, const Size &minsize)
+{
+#ifdef HAVE_PNG
+	return powerOfTwoDenominator(img,minsize,8);
+#else
+	return 1;
+#endif
+}
+
 #ifdef HAVE_PNG
+/*
+ * Liest eine PNG-Grafik ohne Interlacing und mittelt dabei jeweils denominator x denominator
+ * Pixel mit Alpha gewichtet zu einem Pixel der Zielgrafik. conv muss die Zeilen von libpng
+ * nach A8R8G8B8 umwandeln.
+ */
+static void readRowsBoxReduced(png_structp png_ptr, png_bytep row, const PixelConverter &conv,
+	Drawable &surface, int width, int height, int denominator)
+{
+	int dw=surface.width();
+	std::vector<uint8_t> argb((size_t)width * 4), out((size_t)dw * 4);
+	std::vector<uint32_t> sum((size_t)dw * 4, 0);
+	PixelConverter toSurface(RGBFormat::A8R8G8B8,surface.rgbformat());
+	int ty=0, rows=0;
+	for (int y=0;y<height;y++) {
+		png_read_row(png_ptr, row, NULL);
+		conv.convertRow(row,argb.data(),width);
+		const uint8_t *p=argb.data();
+		uint32_t *acc=sum.data();
+		for (int x=0;x<width;acc+=4) {
+			int end=std::min(x+denominator,width);
+			for (;x<end;x++,p+=4) {
+				uint32_t a=p[3];
+				acc[0]+=p[0]*a;
+				acc[1]+=p[1]*a;
+				acc[2]+=p[2]*a;
+				acc[3]+=a;
+			}
+		}
+		rows++;
+		if (rows<denominator && y<height-1) continue;
+		acc=sum.data();
+		uint8_t *o=out.data();
+		for (int x=0;x<dw;x++,acc+=4,o+=4) {
+			uint32_t n=rows*std::min(denominator,width-x*denominator);
+			uint32_t a=acc[3];
+			if (a) {
+				o[0]=(uint8_t)((acc[0]+a/2)/a);
+				o[1]=(uint8_t)((acc[1]+a/2)/a);
+				o[2]=(uint8_t)((acc[2]+a/2)/a);
+			} else {
+				o[0]=o[1]=o[2]=0;
+			}
+			o[3]=(uint8_t)((a+n/2)/n);
+			acc[0]=acc[1]=acc[2]=acc[3]=0;
+		}
+		toSurface.writeRow(surface,ty,out.data(),dw);
+		ty++;
+		rows=0;
+	}
+}
+
+/*
+ * Liest eine PNG-Grafik mit Adam7-Interlacing. Bei einer Verkleinerung werden nur die
+ * Durchgänge gelesen, die alle Pixel mit x%denominator==0 und y%denominator==0 enthalten
+ * (1 Durchgang bei 8, 3 bei 4 und 5 bei 2), und nur diese Zeilen werden gespeichert.
+ */
+static void readRowsInterlaced(png_structp png_ptr, png_infop info_ptr, const PixelConverter &conv,
+	Drawable &surface, int width, int height, int denominator, int passes)
+{
+	size_t rowbytes=png_get_rowbytes(png_ptr, info_ptr);
+	int bpp=(int)(rowbytes/width);
+	int dh=surface.height();
+	std::vector<png_byte> buffer(rowbytes * dh);
+	if (denominator==8) passes=1;
+	else if (denominator==4) passes=3;
+	else if (denominator==2) passes=5;
+	for (int pass=0;pass<passes;pass++) {
+		for (int y=0;y<height;y++) {
+			png_bytep row=NULL;
+			if (y%denominator==0) row=&buffer[(y/denominator)*rowbytes];
+			png_read_row(png_ptr, row, NULL);
+		}
+	}
+	int dw=surface.width();
+	for (int y=0;y<dh;y++) {
+		png_bytep row=&buffer[y*rowbytes];
+		for (int x=1;x<dw;x++) memmove(row+x*bpp,row+x*denominator*bpp,bpp);
+		conv.writeRow(surface,y,row,dw);
+	}
+}
+#endif
+
+void ImageFilter_PNG::loadScaled(FileObject &file, Drawable &surface, IMAGE &img, int denominator)
+{
+#ifdef HAVE_PNG
+	if (denominator!=1 && denominator!=2 && denominator!=4 && denominator!=8)
+		throw IllegalArgumentException("ImageFilter_PNG::loadScaled: denominator %d",denominator);
 	file.seek(0);
 	png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL ,NULL, NULL);
     if (!png_ptr) throw IllegalImageFormatException();
@@ -232,115 +337,73 @@ void ImageFilter_PNG::load(FileObject &file, Drawable &surface, IMAGE &img)
 
 	//png_read_png(png_ptr, info_ptr,0,NULL);
 
-
-
-	png_bytep row_pointer=(png_bytep) png_malloc(png_ptr,img.pitch);
-
-	RGBFormat zformat=surface.rgbformat();		// Zielformat holen
-
-	if (row_pointer!=NULL) {
-		int bpp;
-		switch (png_get_color_type(png_ptr, info_ptr)) {
-
+	int width=(int)png_get_image_width(png_ptr, info_ptr);
+	int height=(int)png_get_image_height(png_ptr, info_ptr);
+	if (surface.width()!=(width+denominator-1)/denominator || surface.height()!=(height+denominator-1)/denominator) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+		throw IllegalImageFormatException("PNG size %dx%d does not match surface",width,height);
+	}
+	bool interlaced=(png_get_interlace_type(png_ptr,info_ptr)!=PNG_INTERLACE_NONE);
+	int passes=png_set_interlace_handling(png_ptr);
+	// Ohne Interlacing wird bei einer Verkleinerung über A8R8G8B8 gemittelt
+	RGBFormat target=surface.rgbformat();
+	if (denominator>1 && !interlaced) target=RGBFormat::A8R8G8B8;
+
+	PixelConverter conv;
+	switch (png_get_color_type(png_ptr, info_ptr)) {
 		case PNG_COLOR_TYPE_RGB_ALPHA:
-			//bpp=png_get_bit_depth(png_ptr, info_ptr);
-			bpp=4;	// TODO: Bittiefe kann auch 16 Bit pro Farbkanal sein
-			//printf ("PNG RGBA, bpp=%i\n",bpp);
-			for (int y=0;y<img.height;y++) {
-				png_read_row(png_ptr, row_pointer, NULL);
-				for (int x=0;x<img.width;x++) {
-					int r=row_pointer[x*bpp+0];
-					int g=row_pointer[x*bpp+1];
-					int b=row_pointer[x*bpp+2];
-					int a=row_pointer[x*bpp+3];
-					surface.putPixel(x,y,Color(r,g,b,a));
-				}
-			}
+			conv.setFormat(RGBFormat::A8B8G8R8, target);
 			break;
 		case PNG_COLOR_TYPE_RGB:
-			//bpp=png_get_bit_depth(png_ptr, info_ptr)/8;
-			bpp=3;
-			for (int y=0;y<img.height;y++) {
-				png_read_row(png_ptr, row_pointer, NULL);
-				for (int x=0;x<img.width;x++) {
-					int r=row_pointer[x*bpp+0];
-					int g=row_pointer[x*bpp+1];
-					int b=row_pointer[x*bpp+2];
-					surface.putPixel(x,y,Color(r,g,b,255));
-				}
-			}
+			conv.setFormat(RGBFormat::B8G8R8, target);
 			break;
 		case PNG_COLOR_TYPE_GRAY:
-			//bpp=png_get_bit_depth(png_ptr, info_ptr)/8;
-			bpp=1;
-			// Ist das Zielformat auch Greyscale?
-			if (zformat==RGBFormat::A8 || zformat==RGBFormat::GREY8) {
-				for (int y=0;y<img.height;y++) {
-					png_read_row(png_ptr, row_pointer, NULL);
-					for (int x=0;x<img.width;x++) {
-						int r=row_pointer[x*bpp+0];
-						surface.putPixel(x,y,Color(r,r,r));
-					}
-				}
-			} else {
-				for (int y=0;y<img.height;y++) {
-					png_read_row(png_ptr, row_pointer, NULL);
-					for (int x=0;x<img.width;x++) {
-						int r=row_pointer[x*bpp+0];
-						surface.putPixel(x,y,Color(r,r,r));
-					}
-				}
-			}
+			conv.setFormat(RGBFormat::GREY8, target);
 			break;
 		case PNG_COLOR_TYPE_GRAY_ALPHA:
-			bpp=2;
-			//bpp=png_get_bit_depth(png_ptr, info_ptr)/8;
-			for (int y=0;y<img.height;y++) {
-				png_read_row(png_ptr, row_pointer, NULL);
-				for (int x=0;x<img.width;x++) {
-					int r=row_pointer[x*bpp+0];
-					int a=row_pointer[x*bpp+1];
-					surface.putPixel(x,y,Color(r,r,r,a));
-				}
-			}
+			// Graustufen mit Alphakanal lassen wir von libpng nach RGBA erweitern
+			png_set_gray_to_rgb(png_ptr);
+			conv.setFormat(RGBFormat::A8B8G8R8, target);
 			break;
 		case PNG_COLOR_TYPE_PALETTE:
+		{
+			conv.setFormat(RGBFormat::Palette, target);
 			int num_trans=0;
-			bpp=png_get_bit_depth(png_ptr, info_ptr)/8;
 			png_colorp pal;
-			int num_palette;
+			int num_palette=0;
 			png_get_PLTE(png_ptr, info_ptr, &pal,&num_palette);
-
 			png_get_tRNS(png_ptr, info_ptr, NULL, &num_trans, NULL);
-
-			/*
-			if (num_trans>0) {
-				r=pal[num_trans-1].red;
-				g=pal[num_trans-1].green;
-				b=pal[num_trans-1].blue;
-				//surface->SetColorKey(surface->RGB(r,g,b,0));
+			for (int i=0;i<num_palette && i<256;i++) {
+				int a=255;
+				if (num_trans>0 && i==num_trans-1) a=0;
+				conv.setPaletteColor(i,Color(pal[i].red,pal[i].green,pal[i].blue,a));
 			}
-			*/
-			for (int y=0;y<img.height;y++) {
-				png_read_row(png_ptr, row_pointer, NULL);
-				for (int x=0;x<img.width;x++) {
-					int a=row_pointer[x*bpp+0];
-					int r=pal[a].red;
-					int g=pal[a].green;
-					int b=pal[a].blue;
-					if (num_trans>0) {
-						if (a==num_trans-1) a=0; else a=255;
-					} else a=255;
-					surface.putPixel(x,y,Color(r,g,b,a));
-				}
-			}
-
 			break;
-
 		}
-	} else {
+	}
+	png_read_update_info(png_ptr, info_ptr);
+
+	png_bytep row_pointer=(png_bytep) png_malloc(png_ptr,png_get_rowbytes(png_ptr, info_ptr));
+	if (row_pointer==NULL) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
 		throw IllegalImageFormatException();
 	}
+	try {
+		if (interlaced) {
+			readRowsInterlaced(png_ptr,info_ptr,conv,surface,width,height,denominator,passes);
+		} else if (denominator>1) {
+			readRowsBoxReduced(png_ptr,row_pointer,conv,surface,width,height,denominator);
+		} else {
+			for (int y=0;y<height;y++) {
+				png_read_row(png_ptr, row_pointer, NULL);
+				conv.writeRow(surface,y,row_pointer,width);
+			}
+		}
+	} catch (...) {
+		png_free(png_ptr,row_pointer);
+		png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+		throw;
+	}
 	png_free(png_ptr,row_pointer);
 	png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
 #else
@@ -369,11 +432,13 @@ void ImageFilter_PNG::save (const Drawable &surface, FileObject &file, const Ass
 	pitch=colortype=0;
 	int png_color_type=PNG_COLOR_TYPE_GRAY;
 	int compression_level=Z_BEST_COMPRESSION;
+	int interlace=PNG_INTERLACE_NONE;
 	RGBFormat srgb=surface.rgbformat();
 	if (srgb==RGBFormat::A8R8G8B8) png_color_type=PNG_COLOR_TYPE_RGB_ALPHA;
 
 	if (param.exists("colortype")) png_color_type=param.getString("colortype").toInt();
 	if (!png_color_type) png_color_type=PNG_COLOR_TYPE_RGB;
+	if (param.exists("interlace") && param.getString("interlace").toBool()) interlace=PNG_INTERLACE_ADAM7;
 
 	switch (png_color_type) {
 		case PNG_COLOR_TYPE_GRAY:
@@ -427,7 +492,10 @@ void ImageFilter_PNG::save (const Drawable &surface, FileObject &file, const Ass
 
 
 	png_set_IHDR(png_ptr, info_ptr, width,height,8,colortype,
-		PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+		interlace, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	// Bei Adam7 muss jede Zeile einmal pro Durchgang geschrieben werden,
+	// png_set_interlace_handling wirkt erst nach png_write_info
+	int passes=1;
 
 
 
@@ -439,10 +507,9 @@ void ImageFilter_PNG::save (const Drawable &surface, FileObject &file, const Ass
 	}
 	if (buffer!=NULL) {
 		// png_write_row(png_ptr, row_pointer);
-		int bpp;
+		RGBFormat srcformat=surface.rgbformat();
 		switch (colortype) {
 			case PNG_COLOR_TYPE_PALETTE:
-				bpp=1;
 				if (surface.rgbformat()==RGBFormat::Palette) {	// Surface verwendet Palette
 					for (int i=0;i<256;i++) {
 						// TODO:
@@ -453,14 +520,17 @@ void ImageFilter_PNG::save (const Drawable &surface, FileObject &file, const Ass
 					}
 					png_set_PLTE(png_ptr,info_ptr, &pc[0], 256);
 					png_write_info(png_ptr, info_ptr);
+					passes=png_set_interlace_handling(png_ptr);
 					//png_write_PLTE (png_ptr, &pc[0],256);
 
-					for (int y=0;y<height;y++) {
-						for (int x=0;x<width;x++) {
-							farbe=surface.getPixel(x,y);
-							buffer[x]=(uint8_t)(farbe.color()&0xff);
+					for (int pass=0;pass<passes;pass++) {
+						for (int y=0;y<height;y++) {
+							for (int x=0;x<width;x++) {
+								farbe=surface.getPixel(x,y);
+								buffer[x]=(uint8_t)(farbe.color()&0xff);
+							}
+							png_write_row(png_ptr, buffer);
 						}
-						png_write_row(png_ptr, buffer);
 					}
 				} else {								// Surface verwendet keine Palette -> Konvertierung
 					/* TODO:
@@ -491,57 +561,46 @@ void ImageFilter_PNG::save (const Drawable &surface, FileObject &file, const Ass
 				}
 				break;
 			case PNG_COLOR_TYPE_RGB:
-				bpp=3;
-				png_write_info(png_ptr, info_ptr);
-				for (int y=0;y<height;y++) {
-					for (int x=0;x<width;x++) {
-						//farbe=surface->GetPixel(area->left+x,y);
-						farbe=surface.getPixel(x,y);
-						buffer[x*bpp+0]=(uint8_t)farbe.red();
-						buffer[x*bpp+1]=(uint8_t)farbe.green();
-						buffer[x*bpp+2]=(uint8_t)farbe.blue();
-					}
-					png_write_row(png_ptr, buffer);
-				}
-				break;
 			case PNG_COLOR_TYPE_RGB_ALPHA:
-				bpp=4;
-				png_write_info(png_ptr, info_ptr);
-				for (int y=0;y<height;y++) {
-					for (int x=0;x<width;x++) {
-						farbe=surface.getPixel(x,y);
-						buffer[x*bpp+0]=(uint8_t)farbe.red();
-						buffer[x*bpp+1]=(uint8_t)farbe.green();
-						buffer[x*bpp+2]=(uint8_t)farbe.blue();
-						buffer[x*bpp+3]=(uint8_t)farbe.alpha();
-					}
-					png_write_row(png_ptr, buffer);
-				}
-				break;
 			case PNG_COLOR_TYPE_GRAY:
-				bpp=1;
+			{
+				RGBFormat rowformat=RGBFormat::GREY8;
+				if (colortype==PNG_COLOR_TYPE_RGB) rowformat=RGBFormat::B8G8R8;
+				else if (colortype==PNG_COLOR_TYPE_RGB_ALPHA) rowformat=RGBFormat::A8B8G8R8;
+				PixelConverter conv(srcformat,rowformat);
 				png_write_info(png_ptr, info_ptr);
-				for (int y=0;y<height;y++) {
-					for (int x=0;x<width;x++) {
-						farbe=surface.getPixel(x,y);
-						buffer[x*bpp]=(uint8_t)farbe.brightness();
+				passes=png_set_interlace_handling(png_ptr);
+				for (int pass=0;pass<passes;pass++) {
+					for (int y=0;y<height;y++) {
+						conv.readRow(surface,y,buffer,width);
+						png_write_row(png_ptr, buffer);
 					}
-					png_write_row(png_ptr, buffer);
 				}
-
 				break;
+			}
 			case PNG_COLOR_TYPE_GRAY_ALPHA:
-				bpp=2;
+			{
+				// Erst nach A8R8G8B8, dann Grauwert und Alpha zusammenfügen
+				PixelConverter toRGBA(srcformat,RGBFormat::A8R8G8B8);
+				PixelConverter toGrey(RGBFormat::A8R8G8B8,RGBFormat::GREY8);
+				uint8_t *rgba=(uint8_t*)png_malloc(png_ptr,width*5);
+				uint8_t *grey=rgba+width*4;
 				png_write_info(png_ptr, info_ptr);
-				for (int y=0;y<height;y++) {
-					for (int x=0;x<width;x++) {
-						farbe=surface.getPixel(x,y);
-						buffer[x*bpp]=(uint8_t)farbe.brightness();
-						buffer[x*bpp+1]=(uint8_t)farbe.alpha();
+				passes=png_set_interlace_handling(png_ptr);
+				for (int pass=0;pass<passes;pass++) {
+					for (int y=0;y<height;y++) {
+						toRGBA.readRow(surface,y,rgba,width);
+						toGrey.convertRow(rgba,grey,width);
+						for (int x=0;x<width;x++) {
+							buffer[x*2]=grey[x];
+							buffer[x*2+1]=rgba[x*4+3];
+						}
+						png_write_row(png_ptr, buffer);
 					}
-					png_write_row(png_ptr, buffer);
 				}
+				png_free(png_ptr,rgba);
 				break;
+			}
 		}
 		png_free(png_ptr,buffer);
 	}
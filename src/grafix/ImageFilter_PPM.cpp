@@ -114,25 +114,18 @@ void ImageFilter_PPM::load(FileObject &file, Drawable &surface, IMAGE &img)
 	//int farbtiefe;
 	//farbtiefe=line.toInt();
 
-	int x,y;
-	uint8_t r,g,b;
+	PixelConverter conv(RGBFormat::B8G8R8,surface.rgbformat());
 	uint64_t pp=file.tell();
 	const char *adresse;
-	for (y=0;y<surface.height();y++) {
+	for (int y=0;y<img.height;y++) {
 		adresse=file.map(pp,img.pitch);	// Zeile fuer Zeile einlesen
 		pp+=img.pitch;
-		for (x=0;x<surface.width();x++) {
-			r=adresse[x*3];
-			g=adresse[x*3+1];
-			b=adresse[x*3+2];
-			surface.putPixel(x,y,Color(r,g,b));
-		}
+		conv.writeRow(surface,y,adresse,img.width);
 	}
 }
 
 void ImageFilter_PPM::save (const Drawable &surface, FileObject &file, const AssocArray &param)
 {
-	Color farbe;
     //int haupt,unter,build;
 	bool SaveAsASCII=false;
 	if (param.exists("ascii")) SaveAsASCII=param.getString("ascii").toBool();
@@ -146,23 +139,22 @@ void ImageFilter_PPM::save (const Drawable &surface, FileObject &file, const Ass
 		file.putsf("%d %d\n",surface.width(),surface.height());
 		file.putsf("%d\n",255);
 		int c=0;
+		int width=surface.width();
+		PixelConverter conv(surface.rgbformat(),RGBFormat::B8G8R8);
+		ByteArray row(width*3);
+		uint8_t *buffer=(uint8_t*)row.ptr();
 		for (int y=0;y<surface.height();y++) {
-			for (int x=0;x<surface.width();x++) {
-				farbe=surface.getPixel(x,y);
-				uint8_t r=(uint8_t)farbe.red();
-				uint8_t g=(uint8_t)farbe.green();
-				uint8_t b=(uint8_t)farbe.blue();
-				if (SaveAsASCII==false) {
-					file.write((char*)&r,1);
-					file.write((char*)&g,1);
-					file.write((char*)&b,1);
-				} else {
-					file.putsf("%u %u %u ",r,g,b);
-					c++;
-					if (c>7) {
-						file.puts("\n");
-						c=0;
-					}
+			conv.readRow(surface,y,buffer,width);
+			if (SaveAsASCII==false) {
+				file.write((char*)buffer,width*3);
+				continue;
+			}
+			for (int x=0;x<width;x++) {
+				file.putsf("%u %u %u ",buffer[x*3],buffer[x*3+1],buffer[x*3+2]);
+				c++;
+				if (c>7) {
+					file.puts("\n");
+					c=0;
 				}
 			}
 		}
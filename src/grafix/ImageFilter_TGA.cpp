@@ -144,7 +144,6 @@ void ImageFilter_TGA::load(FileObject &file, Drawable &surface, IMAGE &img)
 {
 	TGAHEAD tgafield, *tga=&tgafield;
 	uint8_t 	* b1;
-	Color	farbwert;
     uint8_t *address=(uint8_t*)file.map();
 
 	PeekHeader((char*)address,tga);
@@ -159,73 +158,64 @@ void ImageFilter_TGA::load(FileObject &file, Drawable &surface, IMAGE &img)
 
 	b1=address+18+tga->IDLength;
 	uint32_t mpl=3;
+	if (tga->PixelDepth==32) mpl=4;
 
 	switch (tga->ImageType) {
 		case 2:					// Unkomprimierte Daten
+		{
 			//printf ("Lese unkomprimierte Bilddaten...\n");
-			if (tga->PixelDepth==32) mpl=4;
+			// Der Alphakanal wird bei unkomprimierten Daten ignoriert
+			PixelConverter conv(mpl==4 ? RGBFormat::X8R8G8B8 : RGBFormat::R8G8B8, surface.rgbformat());
 			if (tga->ImageDescriptor==0) {
-				for (int y=(img.height-1);y>=0;y++) {
-                	for (int x=0;x<img.width;x++) {
-                    	farbwert=Color(b1[x*mpl+2], b1[x*mpl+1], b1[x*mpl] );
-                    	surface.putPixel (x,y,farbwert);
-                	}
-                	b1+=img.pitch;
-            	}
+				for (int y=(img.height-1);y>=0;y--) {
+					conv.writeRow(surface,y,b1,img.width);
+					b1+=img.pitch;
+				}
 
 			} else {
 				for (int y=0;y<img.height;y++) {
-                	for (int x=0;x<img.width;x++) {
-                    	farbwert=Color(b1[x*mpl+2], b1[x*mpl+1], b1[x*mpl] );
-                    	surface.putPixel (x,y,farbwert);
-                	}
-                	b1+=img.pitch;
-            	}
+					conv.writeRow(surface,y,b1,img.width);
+					b1+=img.pitch;
+				}
 			}
-            return;
+			return;
+		}
 
 		case 10:				// Komprimierte Daten
+		{
+			PixelConverter conv(mpl==4 ? RGBFormat::A8R8G8B8 : RGBFormat::R8G8B8, surface.rgbformat());
+			ByteArray rowbuffer(img.width*mpl);
+			uint8_t *row=(uint8_t*)rowbuffer.ptr();
 			int y=0,x=0;
 			int zeilen=0;
 			int ym=1;
 
 			if (tga->ImageDescriptor==0) {ym=-1; y=img.height-1; }
 
-
+			// Die Pakete werden in einen Zeilenpuffer entpackt, der bei jedem
+			// Zeilenwechsel in die Zeichenfläche übertragen wird. Pakete dürfen
+			// über das Zeilenende hinausgehen.
 			while (zeilen<img.height) {
 				int byte1=Peek8((char*)b1++);
 				int repeat=(byte1&127)+1;
+				const uint8_t *pixel=b1;
 				if (byte1&128) {	// Bit 7 gesetzt, es folgt daher ein Farbwert zur Wiederholung
-					if (tga->PixelDepth==24) {
-						//printf ("Addiere 3 Byte dazu\n");
-						farbwert=Color(b1[2], b1[1], b1[0] );
-						b1+=3;
-					} else {
-						farbwert=Color(b1[2], b1[1], b1[0],b1[3]);
-						b1+=4;
-					}
-					//printf ("%u mal gleiche Farbe: %u\n",repeat,farbwert);
-					for (int i=0;i<repeat;i++) {
-						surface.putPixel(x++,y,farbwert);
-						if (x>=img.width) { x=0;y+=ym; zeilen++;}
-
-					}
+					b1+=mpl;
 				} else {			// Bit 7 geloescht, es folgen unkomprimierte Daten
-					//printf ("%u mal verschiedene Farben\n",repeat);
-					for (int i=0;i<repeat;i++) {
-						if (tga->PixelDepth==24) {
-							farbwert=Color(b1[2], b1[1], b1[0] );
-							b1+=3;
-						} else {
-							farbwert=Color(b1[2], b1[1], b1[0],b1[3]);
-							b1+=4;
-						}
-						surface.putPixel(x++,y,farbwert);
-						if (x>=img.width) { x=0;y+=ym; zeilen++;}
+					b1+=repeat*mpl;
+				}
+				for (int i=0;i<repeat && zeilen<img.height;i++) {
+					memcpy(row+x*mpl,pixel,mpl);
+					if ((byte1&128)==0) pixel+=mpl;
+					x++;
+					if (x>=img.width) {
+						conv.writeRow(surface,y,row,img.width);
+						x=0;y+=ym; zeilen++;
 					}
 				}
 			}
 			return;
+		}
 
 	} // end switch
 	throw UnknownImageFormatException();
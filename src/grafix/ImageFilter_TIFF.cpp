@@ -186,14 +186,16 @@ void ImageFilter_TIFF::load(FileObject &file, Drawable &surface, IMAGE &img)
 		throw OutOfMemoryException();
 	}
 	if (TIFFReadRGBAImage(tif, w, h, raster, 0)) {
-		uint32_t p=0, abgr;
-		Color c;
-		for (uint32 y=0;y<h;y++) {
-			for (uint32 x=0;x<w;x++) {
-				abgr=raster[p++];
-				c.setColor(abgr&255,(abgr>>8)&255,(abgr>>16)&255,(abgr>>24)&255);
-				surface.putPixel(x,h-y-1,c);
+		// Die Zeilen liegen von unten nach oben im Speicher, jeder Pixel als ABGR
+		PixelConverter conv(RGBFormat::A8B8G8R8,surface.rgbformat());
+		try {
+			for (uint32 y=0;y<h;y++) {
+				conv.writeRow(surface,h-y-1,raster+(size_t)y*w,w);
 			}
+		} catch (...) {
+			_TIFFfree(raster);
+			TIFFClose(tif);
+			throw;
 		}
 		_TIFFfree(raster);
 		TIFFClose(tif);
@@ -0,0 +1,678 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "ppl7.h"
+#include "ppl7-grafix.h"
+#include "simd_ppl7.h"
+
+namespace ppl7 {
+namespace grafix {
+
+/*!\class PixelConverter
+ * \ingroup PPLGroupGrafik
+ * \brief Umwandlung ganzer Pixelzeilen zwischen zwei Farbformaten
+ *
+ * \desc
+ * Mit dieser Klasse werden Pixelzeilen von einem Farbformat in ein anderes umgewandelt,
+ * ohne für jeden Pixel eine Color-Klasse zu erzeugen und Drawable::putPixel aufzurufen.
+ * Sie wird von den Image-Filtern verwendet, um die Zeilen der Grafikbibliotheken direkt in
+ * die Zeichenfläche zu schreiben oder beim Speichern aus ihr zu lesen.
+ * \par
+ * Unterstützt werden als Quellformat RGBFormat::Palette, RGBFormat::GREY8, RGBFormat::A8,
+ * RGBFormat::R8G8B8, RGBFormat::B8G8R8 sowie die vier 32-Bit-Formate, als Zielformat
+ * RGBFormat::GREY8, RGBFormat::A8, die beiden 24-Bit- und die 32-Bit-Formate.
+ * Das Ergebnis ist identisch mit dem von Drawable::putPixel und Drawable::getPixel:
+ * - Bei Quellformaten ohne Alphakanal (auch X8R8G8B8 und X8B8G8R8) wird Alpha auf 255 gesetzt
+ * - Bei Zielformaten mit X8 wird der Alphawert trotzdem übernommen
+ * - Graustufen werden mit der gleichen Gewichtung wie in Color::brightness berechnet
+ *
+ * Reine Umsortierungen der Bytes und die Umwandlung nach Graustufen werden mit SSE4.1
+ * bzw. AVX2 durchgeführt, sofern die CPU das unterstützt (siehe PixelConverter::setCaps).
+ * Alle anderen Kombinationen laufen über eine Zwischenstufe im Format A8R8G8B8.
+ *
+ * \example
+ * \code
+ * PixelConverter conv(RGBFormat::B8G8R8, surface.rgbformat());
+ * for (int y=0;y<height;y++) {
+ *     readScanline(buffer);
+ *     conv.writeRow(surface,y,buffer,width);
+ * }
+ * \endcode
+ */
+
+namespace {
+
+enum {
+	MethodNone=0,
+	MethodCopy,
+	MethodShuffle,
+	MethodGrey,
+	MethodPalette,
+	MethodTwoStep
+};
+
+enum {
+	DecodeNone=0,
+	DecodeShuffle,
+	DecodePalette
+};
+
+enum {
+	EncodeNone=0,
+	EncodeShuffle,
+	EncodeGrey
+};
+
+// Markiert ein Zielbyte, das mit 0xff gefüllt wird
+const uint8_t FILL=0xff;
+
+// Byteposition von Blau, Grün, Rot und Alpha innerhalb eines Pixels, -1=nicht vorhanden
+typedef struct {
+	int bpp;
+	int pos[4];
+} BYTE_LAYOUT;
+
+bool byteLayout(int format, bool target, BYTE_LAYOUT& l)
+{
+	switch (format) {
+		case RGBFormat::GREY8:
+		case RGBFormat::A8:
+			if (target) return false;
+			l.bpp=1; l.pos[0]=0; l.pos[1]=0; l.pos[2]=0; l.pos[3]=-1;
+			return true;
+		case RGBFormat::R8G8B8:
+			l.bpp=3; l.pos[0]=0; l.pos[1]=1; l.pos[2]=2; l.pos[3]=-1;
+			return true;
+		case RGBFormat::B8G8R8:
+			l.bpp=3; l.pos[0]=2; l.pos[1]=1; l.pos[2]=0; l.pos[3]=-1;
+			return true;
+		case RGBFormat::A8R8G8B8:
+		case RGBFormat::X8R8G8B8:
+			l.bpp=4; l.pos[0]=0; l.pos[1]=1; l.pos[2]=2;
+			l.pos[3]=(target || format == RGBFormat::A8R8G8B8) ? 3 : -1;
+			return true;
+		case RGBFormat::A8B8G8R8:
+		case RGBFormat::X8B8G8R8:
+			l.bpp=4; l.pos[0]=2; l.pos[1]=1; l.pos[2]=0;
+			l.pos[3]=(target || format == RGBFormat::A8B8G8R8) ? 3 : -1;
+			return true;
+	}
+	return false;
+}
+
+bool isGrey(int format)
+{
+	return (format == RGBFormat::GREY8 || format == RGBFormat::A8);
+}
+
+// Für jedes Byte des Zielpixels das Quellbyte bestimmen
+void buildShuffle(const BYTE_LAYOUT& s, const BYTE_LAYOUT& t, uint8_t* index)
+{
+	for (int c=0;c < 4;c++) {
+		if (t.pos[c] < 0) continue;
+		index[t.pos[c]]=(s.pos[c] < 0 ? FILL : (uint8_t)s.pos[c]);
+	}
+}
+
+// Gewichtung der Quellbytes für die Graustufen, siehe Color::brightness
+void buildGreyWeights(const BYTE_LAYOUT& s, uint8_t* weights)
+{
+	memset(weights, 0, 4);
+	weights[s.pos[0]]=5;
+	weights[s.pos[1]]=16;
+	weights[s.pos[2]]=11;
+}
+
+SimdCaps& converterCaps()
+{
+	static SimdCaps caps;
+	return caps;
+}
+
+void ShuffleRow_Scalar(const uint8_t* index, int sbpp, int tbpp, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	for (int x=0;x < pixels;x++) {
+		for (int k=0;k < tbpp;k++) tgt[k]=(index[k] == FILL ? 0xff : src[index[k]]);
+		src+=sbpp;
+		tgt+=tbpp;
+	}
+}
+
+void GreyRow_Scalar(const uint8_t* weights, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	for (int x=0;x < pixels;x++) {
+		tgt[x]=(uint8_t)((src[0] * weights[0] + src[1] * weights[1] + src[2] * weights[2] + src[3] * weights[3]) >> 5);
+		src+=4;
+	}
+}
+
+#ifdef PPL7_SIMD_X86
+/*
+ * Die Vektor-Kernel verarbeiten jeweils 4 (SSE4.1) bzw. 8 (AVX2) Pixel pro Schritt mit
+ * einem pshufb, dessen Maske aus der Bytetabelle erzeugt wird. Bei 24-Bit-Quellen wird
+ * über die 12 bzw. 24 benötigten Bytes hinaus gelesen, daher werden am Zeilenende ein paar
+ * Pixel mehr übrig gelassen. Geschrieben wird nie über das Zeilenende hinaus. Den Rest
+ * erledigt ShuffleRow_Scalar.
+ */
+void buildShuffleMask(const uint8_t* index, int sbpp, int tbpp, uint8_t* mask, uint8_t* fill)
+{
+	memset(mask, 0x80, 16);
+	memset(fill, 0, 16);
+	for (int p=0;p < 4;p++) {
+		for (int k=0;k < tbpp;k++) {
+			if (index[k] == FILL) fill[p * tbpp + k]=0xff;
+			else mask[p * tbpp + k]=(uint8_t)(p * sbpp + index[k]);
+		}
+	}
+}
+
+template<int SBPP> PPL7_TARGET_SSE41 inline __m128i Load4_SSE41(const uint8_t* p)
+{
+	if (SBPP == 1) {
+		uint32_t v;
+		memcpy(&v, p, 4);
+		return _mm_cvtsi32_si128((int)v);
+	}
+	return _mm_loadu_si128((const __m128i*)p);
+}
+
+template<int TBPP> PPL7_TARGET_SSE41 inline void Store4_SSE41(uint8_t* p, __m128i v)
+{
+	if (TBPP == 4) {
+		_mm_storeu_si128((__m128i*)p, v);
+	} else {
+		_mm_storel_epi64((__m128i*)p, v);
+		uint32_t w=(uint32_t)_mm_extract_epi32(v, 2);
+		memcpy(p + 8, &w, 4);
+	}
+}
+
+template<int SBPP, int TBPP> PPL7_TARGET_SSE41 int ShuffleRow_SSE41(const uint8_t* m, const uint8_t* f, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	const __m128i mask=_mm_loadu_si128((const __m128i*)m);
+	const __m128i fill=_mm_loadu_si128((const __m128i*)f);
+	const int reserve=(SBPP == 3 ? 6 : 4);
+	int x=0;
+	for (;x + reserve <= pixels;x+=4) {
+		__m128i v=_mm_shuffle_epi8(Load4_SSE41<SBPP>(src + x * SBPP), mask);
+		Store4_SSE41<TBPP>(tgt + x * TBPP, _mm_or_si128(v, fill));
+	}
+	return x;
+}
+
+template<int SBPP> PPL7_TARGET_AVX2 inline __m256i Load8_AVX2(const uint8_t* p)
+{
+	if (SBPP == 4) return _mm256_loadu_si256((const __m256i*)p);
+	if (SBPP == 3) return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+		_mm_loadu_si128((const __m128i*)(p + 12)), 1);
+	return _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_loadl_epi64((const __m128i*)p)),
+		_mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1));
+}
+
+template<int TBPP> PPL7_TARGET_AVX2 inline void Store8_AVX2(uint8_t* p, __m256i v)
+{
+	if (TBPP == 4) {
+		_mm256_storeu_si256((__m256i*)p, v);
+	} else {
+		v=_mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+		_mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+		_mm_storel_epi64((__m128i*)(p + 16), _mm256_extracti128_si256(v, 1));
+	}
+}
+
+template<int SBPP, int TBPP> PPL7_TARGET_AVX2 int ShuffleRow_AVX2(const uint8_t* m, const uint8_t* f, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	const __m256i mask=_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)m));
+	const __m256i fill=_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)f));
+	const int reserve=(SBPP == 3 ? 10 : 8);
+	int x=0;
+	for (;x + reserve <= pixels;x+=8) {
+		__m256i v=_mm256_shuffle_epi8(Load8_AVX2<SBPP>(src + x * SBPP), mask);
+		Store8_AVX2<TBPP>(tgt + x * TBPP, _mm256_or_si256(v, fill));
+	}
+	return x;
+}
+
+PPL7_TARGET_SSE41 int GreyRow_SSE41(const uint8_t* weights, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	uint32_t w;
+	memcpy(&w, weights, 4);
+	const __m128i mul=_mm_set1_epi32((int)w);
+	int x=0;
+	for (;x + 16 <= pixels;x+=16) {
+		const __m128i* s=(const __m128i*)(src + x * 4);
+		__m128i m0=_mm_maddubs_epi16(_mm_loadu_si128(s), mul);
+		__m128i m1=_mm_maddubs_epi16(_mm_loadu_si128(s + 1), mul);
+		__m128i m2=_mm_maddubs_epi16(_mm_loadu_si128(s + 2), mul);
+		__m128i m3=_mm_maddubs_epi16(_mm_loadu_si128(s + 3), mul);
+		__m128i lo=_mm_srli_epi16(_mm_hadd_epi16(m0, m1), 5);
+		__m128i hi=_mm_srli_epi16(_mm_hadd_epi16(m2, m3), 5);
+		_mm_storeu_si128((__m128i*)(tgt + x), _mm_packus_epi16(lo, hi));
+	}
+	return x;
+}
+
+PPL7_TARGET_AVX2 int GreyRow_AVX2(const uint8_t* weights, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	uint32_t w;
+	memcpy(&w, weights, 4);
+	const __m256i mul=_mm256_set1_epi32((int)w);
+	const __m256i order=_mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	int x=0;
+	for (;x + 32 <= pixels;x+=32) {
+		const __m256i* s=(const __m256i*)(src + x * 4);
+		__m256i m0=_mm256_maddubs_epi16(_mm256_loadu_si256(s), mul);
+		__m256i m1=_mm256_maddubs_epi16(_mm256_loadu_si256(s + 1), mul);
+		__m256i m2=_mm256_maddubs_epi16(_mm256_loadu_si256(s + 2), mul);
+		__m256i m3=_mm256_maddubs_epi16(_mm256_loadu_si256(s + 3), mul);
+		__m256i lo=_mm256_srli_epi16(_mm256_hadd_epi16(m0, m1), 5);
+		__m256i hi=_mm256_srli_epi16(_mm256_hadd_epi16(m2, m3), 5);
+		__m256i v=_mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order);
+		_mm256_storeu_si256((__m256i*)(tgt + x), v);
+	}
+	return x;
+}
+
+template<int SBPP, int TBPP> int ShuffleRow_Vector(uint32_t caps, const uint8_t* m, const uint8_t* f, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	if (caps & CPUCAPS::CPU_HAVE_AVX2) return ShuffleRow_AVX2<SBPP, TBPP>(m, f, src, tgt, pixels);
+	return ShuffleRow_SSE41<SBPP, TBPP>(m, f, src, tgt, pixels);
+}
+#endif
+
+void ShuffleRow(const uint8_t* index, int sbpp, int tbpp, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	int done=0;
+#ifdef PPL7_SIMD_X86
+	uint32_t caps=converterCaps().get();
+	if (caps) {
+		uint8_t mask[16], fill[16];
+		buildShuffleMask(index, sbpp, tbpp, mask, fill);
+		switch (sbpp * 10 + tbpp) {
+			case 13: done=ShuffleRow_Vector<1, 3>(caps, mask, fill, src, tgt, pixels); break;
+			case 14: done=ShuffleRow_Vector<1, 4>(caps, mask, fill, src, tgt, pixels); break;
+			case 33: done=ShuffleRow_Vector<3, 3>(caps, mask, fill, src, tgt, pixels); break;
+			case 34: done=ShuffleRow_Vector<3, 4>(caps, mask, fill, src, tgt, pixels); break;
+			case 43: done=ShuffleRow_Vector<4, 3>(caps, mask, fill, src, tgt, pixels); break;
+			case 44: done=ShuffleRow_Vector<4, 4>(caps, mask, fill, src, tgt, pixels); break;
+		}
+	}
+#endif
+	ShuffleRow_Scalar(index, sbpp, tbpp, src + done * sbpp, tgt + done * tbpp, pixels - done);
+}
+
+void GreyRow(const uint8_t* weights, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	int done=0;
+#ifdef PPL7_SIMD_X86
+	uint32_t caps=converterCaps().get();
+	if (caps & CPUCAPS::CPU_HAVE_AVX2) done=GreyRow_AVX2(weights, src, tgt, pixels);
+	else if (caps & CPUCAPS::CPU_HAVE_SSE41) done=GreyRow_SSE41(weights, src, tgt, pixels);
+#endif
+	GreyRow_Scalar(weights, src + done * 4, tgt + done, pixels - done);
+}
+
+void PaletteRow(const uint32_t* palette, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	for (int x=0;x < pixels;x++) memcpy(tgt + x * 4, &palette[src[x]], 4);
+}
+
+} // EOF anonymous namespace
+
+
+/*!\brief Konstruktor ohne Farbformate
+ *
+ * \desc
+ * Die Farbformate müssen vor der ersten Umwandlung mit PixelConverter::setFormat
+ * festgelegt werden.
+ */
+PixelConverter::PixelConverter()
+{
+	setFormat(RGBFormat::unknown, RGBFormat::unknown);
+}
+
+/*!\brief Konstruktor mit Quell- und Zielformat
+ *
+ * \desc
+ * Siehe PixelConverter::setFormat
+ *
+ * @param source Farbformat der Quelldaten
+ * @param target Farbformat der Zieldaten
+ */
+PixelConverter::PixelConverter(const RGBFormat& source, const RGBFormat& target)
+{
+	setFormat(source, target);
+}
+
+/*!\brief Quell- und Zielformat festlegen
+ *
+ * \desc
+ * Legt fest, von welchem Farbformat in welches umgewandelt werden soll, und wählt die
+ * passende Umwandlungsroutine aus. Die Farbpalette wird dabei auf Schwarz zurückgesetzt.
+ * Ob die Kombination unterstützt wird, kann mit PixelConverter::isSupported geprüft
+ * werden. Wird sie nicht unterstützt, wirft PixelConverter::convertRow eine Exception.
+ *
+ * @param source Farbformat der Quelldaten
+ * @param target Farbformat der Zieldaten
+ */
+void PixelConverter::setFormat(const RGBFormat& source, const RGBFormat& target)
+{
+	sformat=source;
+	tformat=target;
+	method=MethodNone;
+	decodemethod=DecodeNone;
+	encodemethod=EncodeNone;
+	sbpp=source.bytesPerPixel();
+	tbpp=target.bytesPerPixel();
+	memset(shuffle, FILL, sizeof(shuffle));
+	memset(decodeshuffle, FILL, sizeof(decodeshuffle));
+	memset(encodeshuffle, FILL, sizeof(encodeshuffle));
+	memset(greyweights, 0, sizeof(greyweights));
+
+	BYTE_LAYOUT sl, tl, bgra;
+	byteLayout(RGBFormat::A8R8G8B8, true, bgra);
+	bool hasSource=byteLayout(source, false, sl);
+	bool hasTarget=byteLayout(target, true, tl);
+
+	// Zwischenstufe A8R8G8B8
+	if (hasSource) {
+		decodemethod=DecodeShuffle;
+		buildShuffle(sl, bgra, decodeshuffle);
+	} else if (source == RGBFormat::Palette) {
+		decodemethod=DecodePalette;
+	}
+	if (hasTarget) {
+		encodemethod=EncodeShuffle;
+		buildShuffle(bgra, tl, encodeshuffle);
+	} else if (isGrey(target)) {
+		encodemethod=EncodeGrey;
+		buildGreyWeights(bgra, greyweights);
+	}
+
+	// Direkter Weg
+	if (isGrey(source) && isGrey(target)) {
+		method=MethodCopy;
+	} else if (hasSource && hasTarget) {
+		buildShuffle(sl, tl, shuffle);
+		method=MethodShuffle;
+		if (sbpp == tbpp) {
+			bool identity=true;
+			for (int k=0;k < tbpp;k++) if (shuffle[k] != k) identity=false;
+			if (identity) method=MethodCopy;
+		}
+	} else if (hasSource && sl.bpp == 4 && isGrey(target)) {
+		buildGreyWeights(sl, greyweights);
+		method=MethodGrey;
+	} else if (decodemethod == DecodePalette && hasTarget && tbpp == 4) {
+		method=MethodPalette;
+	} else if (decodemethod != DecodeNone && encodemethod != EncodeNone) {
+		method=MethodTwoStep;
+	}
+	for (int i=0;i < 256;i++) setPaletteColor(i, Color(0, 0, 0, 255));
+}
+
+/*!\brief Quellformat
+ *
+ * @return Liefert das Farbformat der Quelldaten zurück
+ */
+RGBFormat PixelConverter::sourceFormat() const
+{
+	return sformat;
+}
+
+/*!\brief Zielformat
+ *
+ * @return Liefert das Farbformat der Zieldaten zurück
+ */
+RGBFormat PixelConverter::targetFormat() const
+{
+	return tformat;
+}
+
+/*!\brief Prüfen, ob die Umwandlung unterstützt wird
+ *
+ * @return Liefert \c true zurück, wenn PixelConverter::convertRow für die eingestellten
+ * Farbformate verwendet werden kann, sonst \c false.
+ */
+bool PixelConverter::isSupported() const
+{
+	return method != MethodNone;
+}
+
+/*!\brief Prüfen, ob eine Umwandlung unterstützt wird
+ *
+ * @param source Farbformat der Quelldaten
+ * @param target Farbformat der Zieldaten
+ * @return Liefert \c true zurück, wenn die Umwandlung von \p source nach \p target
+ * unterstützt wird, sonst \c false.
+ */
+bool PixelConverter::isSupported(const RGBFormat& source, const RGBFormat& target)
+{
+	return PixelConverter(source, target).isSupported();
+}
+
+/*!\brief Farbe in der Palette setzen
+ *
+ * \desc
+ * Setzt die Farbe für den Index \p index der Farbpalette, die bei Quelldaten im Format
+ * RGBFormat::Palette verwendet wird.
+ *
+ * @param index Index der Farbe, 0 bis 255
+ * @param color Farbe einschließlich Alphawert
+ * @exception IllegalArgumentException Wird geworfen, wenn \p index außerhalb des gültigen
+ * Bereichs liegt.
+ */
+void PixelConverter::setPaletteColor(int index, const Color& color)
+{
+	if (index < 0 || index > 255) throw IllegalArgumentException("PixelConverter::setPaletteColor: index=%d", index);
+	uint8_t bgra[4]={ (uint8_t)color.blue(), (uint8_t)color.green(), (uint8_t)color.red(), (uint8_t)color.alpha() };
+	memcpy(&palette[index], bgra, 4);
+	if (encodemethod == EncodeShuffle && tbpp == 4) {
+		ShuffleRow_Scalar(encodeshuffle, 4, 4, bgra, (uint8_t*)&tpalette[index], 1);
+	} else {
+		tpalette[index]=palette[index];
+	}
+}
+
+void PixelConverter::decodeRow(const uint8_t* src, uint32_t* tgt, int pixels) const
+{
+	if (decodemethod == DecodePalette) PaletteRow(palette, src, (uint8_t*)tgt, pixels);
+	else ShuffleRow(decodeshuffle, sbpp, 4, src, (uint8_t*)tgt, pixels);
+}
+
+void PixelConverter::encodeRow(const uint32_t* src, uint8_t* tgt, int pixels) const
+{
+	if (encodemethod == EncodeGrey) GreyRow(greyweights, (const uint8_t*)src, tgt, pixels);
+	else ShuffleRow(encodeshuffle, 4, tbpp, (const uint8_t*)src, tgt, pixels);
+}
+
+/*!\brief Pixelzeile umwandeln
+ *
+ * \desc
+ * Wandelt \p pixels Pixel ab \p src vom Quellformat in das Zielformat um und schreibt sie
+ * nach \p tgt. Quelle und Ziel dürfen sich nicht überlappen.
+ *
+ * @param src Pointer auf die Quelldaten
+ * @param tgt Pointer auf den Zielspeicher, der groß genug für \p pixels Pixel im
+ * Zielformat sein muss
+ * @param pixels Anzahl Pixel
+ * @exception UnsupportedColorFormatException Die Umwandlung wird nicht unterstützt
+ */
+void PixelConverter::convertRow(const void* src, void* tgt, int pixels) const
+{
+	if (pixels <= 0) return;
+	const uint8_t* s=(const uint8_t*)src;
+	uint8_t* t=(uint8_t*)tgt;
+	switch (method) {
+		case MethodCopy:
+			memcpy(t, s, (size_t)pixels * tbpp);
+			return;
+		case MethodShuffle:
+			ShuffleRow(shuffle, sbpp, tbpp, s, t, pixels);
+			return;
+		case MethodGrey:
+			GreyRow(greyweights, s, t, pixels);
+			return;
+		case MethodPalette:
+			PaletteRow(tpalette, s, t, pixels);
+			return;
+		case MethodTwoStep:
+		{
+			uint32_t buffer[256];
+			while (pixels > 0) {
+				int n=(pixels > 256 ? 256 : pixels);
+				decodeRow(s, buffer, n);
+				encodeRow(buffer, t, n);
+				s+=n * sbpp;
+				t+=n * tbpp;
+				pixels-=n;
+			}
+			return;
+		}
+	}
+	throw UnsupportedColorFormatException("%s => %s", (const char*)sformat.name(), (const char*)tformat.name());
+}
+
+/*!\brief Pixelzeile in eine Zeichenfläche schreiben
+ *
+ * \desc
+ * Wandelt \p pixels Pixel ab \p src vom Quellformat um und schreibt sie in die Zeile \p y
+ * der Zeichenfläche \p surface, beginnend bei x=0. Pixel außerhalb der Zeichenfläche
+ * werden ignoriert. Entspricht das Farbformat der Zeichenfläche dem Zielformat, wird
+ * direkt in deren Speicher geschrieben, andernfalls wird jeder Pixel mit
+ * Drawable::putPixel gesetzt.
+ *
+ * @param surface Zeichenfläche
+ * @param y Zeile
+ * @param src Pointer auf die Quelldaten
+ * @param pixels Anzahl Pixel
+ * @exception UnsupportedColorFormatException Das Quellformat wird nicht unterstützt
+ */
+void PixelConverter::writeRow(Drawable& surface, int y, const void* src, int pixels) const
+{
+	if (y < 0 || y >= surface.height()) return;
+	if (pixels > surface.width()) pixels=surface.width();
+	if (pixels <= 0) return;
+	if (method != MethodNone && surface.rgbformat() == tformat) {
+		convertRow(src, surface.adr(0, y), pixels);
+		return;
+	}
+	if (decodemethod == DecodeNone)
+		throw UnsupportedColorFormatException("%s => %s", (const char*)sformat.name(), (const char*)surface.rgbformat().name());
+	const uint8_t* s=(const uint8_t*)src;
+	uint32_t buffer[256];
+	for (int x=0;x < pixels;x+=256) {
+		int n=(pixels - x > 256 ? 256 : pixels - x);
+		decodeRow(s + x * sbpp, buffer, n);
+		for (int i=0;i < n;i++) {
+			const uint8_t* p=(const uint8_t*)(buffer + i);
+			surface.putPixel(x + i, y, Color(p[2], p[1], p[0], p[3]));
+		}
+	}
+}
+
+/*!\brief Pixelzeile aus einer Zeichenfläche lesen
+ *
+ * \desc
+ * Liest \p pixels Pixel aus der Zeile \p y der Zeichenfläche \p surface, beginnend bei x=0,
+ * und schreibt sie im Zielformat nach \p tgt. Entspricht das Farbformat der Zeichenfläche
+ * dem Quellformat, wird direkt aus deren Speicher gelesen, andernfalls wird jeder Pixel
+ * mit Drawable::getPixel gelesen.
+ *
+ * @param surface Zeichenfläche
+ * @param y Zeile
+ * @param tgt Pointer auf den Zielspeicher
+ * @param pixels Anzahl Pixel, darf nicht größer als die Breite der Zeichenfläche sein
+ * @exception UnsupportedColorFormatException Das Zielformat wird nicht unterstützt
+ * @exception IllegalArgumentException \p y oder \p pixels liegen außerhalb der Zeichenfläche
+ */
+void PixelConverter::readRow(const Drawable& surface, int y, void* tgt, int pixels) const
+{
+	if (y < 0 || y >= surface.height() || pixels > surface.width())
+		throw IllegalArgumentException("PixelConverter::readRow: y=%d, pixels=%d", y, pixels);
+	if (pixels <= 0) return;
+	if (method != MethodNone && surface.rgbformat() == sformat) {
+		convertRow(surface.adr(0, y), tgt, pixels);
+		return;
+	}
+	if (encodemethod == EncodeNone)
+		throw UnsupportedColorFormatException("%s => %s", (const char*)surface.rgbformat().name(), (const char*)tformat.name());
+	uint8_t* t=(uint8_t*)tgt;
+	uint32_t buffer[256];
+	for (int x=0;x < pixels;x+=256) {
+		int n=(pixels - x > 256 ? 256 : pixels - x);
+		for (int i=0;i < n;i++) {
+			Color c=surface.getPixel(x + i, y);
+			uint8_t* p=(uint8_t*)(buffer + i);
+			p[0]=(uint8_t)c.blue();
+			p[1]=(uint8_t)c.green();
+			p[2]=(uint8_t)c.red();
+			p[3]=(uint8_t)c.alpha();
+		}
+		encodeRow(buffer, t + x * tbpp, n);
+	}
+}
+
+/*!\brief Auswahl der Vektor-Kernel einschränken
+ *
+ * \desc
+ * Legt fest, welche Varianten der Umwandlungsroutinen verwendet werden. Die Werte und
+ * Einschränkungen sind die gleichen wie bei Grafix::setBlitCaps.
+ *
+ * \param caps Gewünschte Features
+ * \return Liefert die vorher aktiven Features zurück
+ */
+uint32_t PixelConverter::setCaps(uint32_t caps)
+{
+	return converterCaps().set(caps);
+}
+
+/*!\brief Aktive Vektor-Kernel abfragen
+ *
+ * \return Liefert die Features zurück, die für die Umwandlung verwendet werden. Ist kein
+ * Bit gesetzt, werden die skalaren Implementierungen verwendet.
+ */
+uint32_t PixelConverter::caps()
+{
+	return converterCaps().get();
+}
+
+} // EOF namespace grafix
+} // EOF namespace ppl7
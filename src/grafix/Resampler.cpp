@@ -0,0 +1,780 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <math.h>
+#include <vector>
+
+#include "ppl7.h"
+#include "ppl7-grafix.h"
+#include "ppl7/core/taskexecutor.h"
+#include "simd_ppl7.h"
+
+namespace ppl7 {
+namespace grafix {
+
+/*!\class Resampler
+ * \ingroup PPLGroupGrafik
+ * \brief Hochwertiges Skalieren von Grafiken mit separierbaren Filtern
+ *
+ * \desc
+ * Diese Klasse skaliert eine Grafik in zwei Durchgängen, zuerst horizontal, dann vertikal.
+ * Die Filtergewichte werden für jede Zielspalte und -zeile einmal vorberechnet und als
+ * 14-Bit-Festkommazahlen gespeichert. Die inneren Schleifen arbeiten ausschließlich mit
+ * Ganzzahlen und verwenden SSE4.1 bzw. AVX2, sofern die CPU das unterstützt (siehe
+ * Resampler::setCaps). Das Ergebnis ist bei allen Varianten Bit für Bit identisch.
+ * \par
+ * Zur Auswahl stehen die Filter Resampler::Box, Resampler::Bilinear, Resampler::Bicubic
+ * (Catmull-Rom) und Resampler::Lanczos3. Beim Verkleinern wird der Filter entsprechend
+ * verbreitert, so dass alle Quellpixel in das Ergebnis eingehen.
+ * \par
+ * Unterstützt werden die vier 32-Bit-Formate sowie RGBFormat::GREY8 und RGBFormat::A8.
+ * Bei RGBFormat::A8R8G8B8 und RGBFormat::A8B8G8R8 wird mit vormultipliziertem Alpha
+ * gerechnet, damit die Farbe transparenter Pixel nicht in die Kanten blutet.
+ * \par
+ * Das Zielbild wird in horizontale Bänder aufgeteilt, die parallel auf einem
+ * TaskExecutor berechnet werden. Jedes Band skaliert die benötigten Quellzeilen selbst,
+ * so dass die Threads keine Daten austauschen müssen.
+ *
+ * \example
+ * \code
+ * Resampler resampler(Resampler::Lanczos3);
+ * Image thumb=resampler.resampled(photo, 256, 192);
+ * \endcode
+ */
+
+namespace {
+
+// Anzahl Nachkommabits der Filtergewichte
+const int PRECISION=14;
+const int ROUNDING=1 << (PRECISION - 1);
+
+// Unterhalb dieser Anzahl Pixel lohnt sich keine Aufteilung auf mehrere Threads
+const size_t MinParallelPixels=256 * 256;
+// Minimale Anzahl Zielzeilen je Band
+const int MinBandRows=16;
+
+typedef struct {
+	int taps;						// Anzahl Gewichte je Zielpixel (Schrittweite in weights)
+	std::vector<int> start;			// Erster Quellpixel je Zielpixel
+	std::vector<int> count;			// Anzahl verwendeter Quellpixel je Zielpixel
+	std::vector<int16_t> weights;	// Gewichte, Summe je Zielpixel ist 1 << PRECISION
+} COEFFICIENTS;
+
+typedef struct {
+	const Drawable* src;
+	Drawable* tgt;
+	COEFFICIENTS h, v;
+	int channels;
+	bool premultiply;
+	uint32_t caps;
+} RESAMPLE_JOB;
+
+SimdCaps& resamplerCaps()
+{
+	static SimdCaps caps;
+	return caps;
+}
+
+TaskExecutor& sharedExecutor()
+{
+	// Wird absichtlich nicht freigegeben, da er bis zum Programmende benötigt werden kann
+	static TaskExecutor* executor=new TaskExecutor(0, "Resampler");
+	return *executor;
+}
+
+double filterSupport(int filter)
+{
+	switch (filter) {
+		case Resampler::Box: return 0.5;
+		case Resampler::Bilinear: return 1.0;
+		case Resampler::Bicubic: return 2.0;
+		case Resampler::Lanczos3: return 3.0;
+	}
+	return 1.0;
+}
+
+double sinc(double x)
+{
+	if (x == 0.0) return 1.0;
+	x*=M_PI;
+	return sin(x) / x;
+}
+
+double filterWeight(int filter, double x)
+{
+	switch (filter) {
+		case Resampler::Box:
+			return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+		case Resampler::Bilinear:
+			x=fabs(x);
+			return x < 1.0 ? 1.0 - x : 0.0;
+		case Resampler::Bicubic:
+		{
+			// Keys mit a=-0.5 (Catmull-Rom)
+			const double a=-0.5;
+			x=fabs(x);
+			if (x < 1.0) return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+			if (x < 2.0) return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+			return 0.0;
+		}
+		case Resampler::Lanczos3:
+			if (x > -3.0 && x < 3.0) return sinc(x) * sinc(x / 3.0);
+			return 0.0;
+	}
+	return 0.0;
+}
+
+void computeCoefficients(int filter, int insize, int outsize, COEFFICIENTS& c)
+{
+	double scale=(double)insize / (double)outsize;
+	double fscale=scale < 1.0 ? 1.0 : scale;
+	double support=filterSupport(filter) * fscale;
+	c.taps=(int)ceil(support) * 2 + 1;
+	c.start.resize(outsize);
+	c.count.resize(outsize);
+	c.weights.assign((size_t)outsize * c.taps, 0);
+	std::vector<double> w(c.taps);
+	for (int i=0;i < outsize;i++) {
+		double center=((double)i + 0.5) * scale;
+		int xmin=(int)floor(center - support + 0.5);
+		int xmax=(int)floor(center + support + 0.5);
+		if (xmin < 0) xmin=0;
+		if (xmax > insize) xmax=insize;
+		int n=xmax - xmin;
+		double sum=0.0;
+		for (int k=0;k < n;k++) {
+			w[k]=filterWeight(filter, ((double)(xmin + k) + 0.5 - center) / fscale);
+			sum+=w[k];
+		}
+		// Gewichte mit 0 am Anfang und Ende müssen nicht gerechnet werden
+		int first=0, last=n;
+		while (first < last && w[first] == 0.0) first++;
+		while (last > first && w[last - 1] == 0.0) last--;
+		int16_t* iw=&c.weights[(size_t)i * c.taps];
+		if (first == last || sum == 0.0) {
+			int x=(int)center;
+			if (x >= insize) x=insize - 1;
+			c.start[i]=x;
+			c.count[i]=1;
+			iw[0]=1 << PRECISION;
+			continue;
+		}
+		// Rundungsfehler werden dem größten Gewicht zugeschlagen, damit die Summe exakt stimmt
+		int isum=0, maxk=0;
+		for (int k=first;k < last;k++) {
+			int v=(int)lround(w[k] / sum * (double)(1 << PRECISION));
+			iw[k - first]=(int16_t)v;
+			isum+=v;
+			if (v > iw[maxk]) maxk=k - first;
+		}
+		iw[maxk]=(int16_t)(iw[maxk] + (1 << PRECISION) - isum);
+		c.start[i]=xmin + first;
+		c.count[i]=last - first;
+	}
+}
+
+inline uint8_t clamp8(int v)
+{
+	if (v < 0) return 0;
+	if (v > 255) return 255;
+	return (uint8_t)v;
+}
+
+inline uint8_t mul8(int c, int a)
+{
+	int t=c * a + 128;
+	return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+// Kehrwerte für das Zurückrechnen von vormultipliziertem Alpha, 16 Nachkommabits
+typedef struct RECIPROCALS {
+	uint32_t value[256];
+	RECIPROCALS() {
+		value[0]=0;
+		for (uint32_t a=1;a < 256;a++) value[a]=((255u << 16) + a / 2) / a;
+	}
+} RECIPROCALS;
+
+const RECIPROCALS& reciprocals()
+{
+	static RECIPROCALS table;
+	return table;
+}
+
+inline int pairWeights(int16_t w0, int16_t w1)
+{
+	return (int)((uint32_t)(uint16_t)w0 | ((uint32_t)(uint16_t)w1 << 16));
+}
+
+void HorizontalRow4_Scalar(const COEFFICIENTS& c, const uint8_t* src, uint8_t* tgt)
+{
+	int width=(int)c.start.size();
+	for (int i=0;i < width;i++) {
+		const uint8_t* p=src + c.start[i] * 4;
+		const int16_t* w=&c.weights[(size_t)i * c.taps];
+		int n=c.count[i];
+		int s0=ROUNDING, s1=ROUNDING, s2=ROUNDING, s3=ROUNDING;
+		for (int k=0;k < n;k++) {
+			s0+=p[0] * w[k];
+			s1+=p[1] * w[k];
+			s2+=p[2] * w[k];
+			s3+=p[3] * w[k];
+			p+=4;
+		}
+		tgt[0]=clamp8(s0 >> PRECISION);
+		tgt[1]=clamp8(s1 >> PRECISION);
+		tgt[2]=clamp8(s2 >> PRECISION);
+		tgt[3]=clamp8(s3 >> PRECISION);
+		tgt+=4;
+	}
+}
+
+inline int HorizontalPixel1_Scalar(const uint8_t* p, const int16_t* w, int k, int n, int sum)
+{
+	for (;k < n;k++) sum+=p[k] * w[k];
+	return sum;
+}
+
+void HorizontalRow1_Scalar(const COEFFICIENTS& c, const uint8_t* src, uint8_t* tgt)
+{
+	int width=(int)c.start.size();
+	for (int i=0;i < width;i++) {
+		int sum=HorizontalPixel1_Scalar(src + c.start[i], &c.weights[(size_t)i * c.taps], 0, c.count[i], ROUNDING);
+		tgt[i]=clamp8(sum >> PRECISION);
+	}
+}
+
+void VerticalRow_Scalar(const int16_t* w, int n, const uint8_t* const* rows, uint8_t* tgt, int x, int bytes)
+{
+	for (;x < bytes;x++) {
+		int sum=ROUNDING;
+		for (int k=0;k < n;k++) sum+=rows[k][x] * w[k];
+		tgt[x]=clamp8(sum >> PRECISION);
+	}
+}
+
+void PremultiplyRow_Scalar(const uint8_t* src, uint8_t* tgt, int x, int pixels)
+{
+	src+=x * 4;
+	tgt+=x * 4;
+	for (;x < pixels;x++) {
+		int a=src[3];
+		tgt[0]=mul8(src[0], a);
+		tgt[1]=mul8(src[1], a);
+		tgt[2]=mul8(src[2], a);
+		tgt[3]=(uint8_t)a;
+		src+=4;
+		tgt+=4;
+	}
+}
+
+void UnpremultiplyRow(uint8_t* p, int pixels)
+{
+	const uint32_t* recip=reciprocals().value;
+	for (int x=0;x < pixels;x++) {
+		uint32_t a=p[3];
+		if (a == 0) {
+			p[0]=p[1]=p[2]=0;
+		} else if (a < 255) {
+			uint32_t r=recip[a];
+			uint32_t v;
+			v=(p[0] * r + 32768) >> 16; p[0]=(uint8_t)(v > 255 ? 255 : v);
+			v=(p[1] * r + 32768) >> 16; p[1]=(uint8_t)(v > 255 ? 255 : v);
+			v=(p[2] * r + 32768) >> 16; p[2]=(uint8_t)(v > 255 ? 255 : v);
+		}
+		p+=4;
+	}
+}
+
+#ifdef PPL7_SIMD_X86
+PPL7_TARGET_SSE41 inline __m128i HorizontalPixel4_SSE41(const uint8_t* p, const int16_t* w, int k, int n, __m128i acc)
+{
+	const __m128i mask=_mm_setr_epi8(0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6, -1, 3, -1, 7, -1);
+	for (;k + 1 < n;k+=2) {
+		__m128i px=_mm_shuffle_epi8(_mm_loadl_epi64((const __m128i*)(p + k * 4)), mask);
+		acc=_mm_add_epi32(acc, _mm_madd_epi16(px, _mm_set1_epi32(pairWeights(w[k], w[k + 1]))));
+	}
+	if (k < n) {
+		int v;
+		memcpy(&v, p + k * 4, 4);
+		__m128i px=_mm_shuffle_epi8(_mm_cvtsi32_si128(v), mask);
+		acc=_mm_add_epi32(acc, _mm_madd_epi16(px, _mm_set1_epi32(pairWeights(w[k], 0))));
+	}
+	return acc;
+}
+
+PPL7_TARGET_SSE41 inline void StorePixel4_SSE41(__m128i acc, uint8_t* tgt)
+{
+	acc=_mm_srai_epi32(acc, PRECISION);
+	acc=_mm_packus_epi16(_mm_packs_epi32(acc, acc), acc);
+	int v=_mm_cvtsi128_si32(acc);
+	memcpy(tgt, &v, 4);
+}
+
+PPL7_TARGET_SSE41 void HorizontalRow4_SSE41(const COEFFICIENTS& c, const uint8_t* src, uint8_t* tgt)
+{
+	int width=(int)c.start.size();
+	for (int i=0;i < width;i++) {
+		__m128i acc=HorizontalPixel4_SSE41(src + c.start[i] * 4, &c.weights[(size_t)i * c.taps], 0, c.count[i], _mm_set1_epi32(ROUNDING));
+		StorePixel4_SSE41(acc, tgt + i * 4);
+	}
+}
+
+PPL7_TARGET_SSE41 inline int HorizontalSum_SSE41(__m128i acc)
+{
+	acc=_mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+	acc=_mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+	return _mm_cvtsi128_si32(acc);
+}
+
+PPL7_TARGET_SSE41 void HorizontalRow1_SSE41(const COEFFICIENTS& c, const uint8_t* src, uint8_t* tgt)
+{
+	int width=(int)c.start.size();
+	for (int i=0;i < width;i++) {
+		const uint8_t* p=src + c.start[i];
+		const int16_t* w=&c.weights[(size_t)i * c.taps];
+		int n=c.count[i];
+		int k=0;
+		__m128i acc=_mm_setzero_si128();
+		for (;k + 7 < n;k+=8) {
+			__m128i px=_mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(p + k)));
+			acc=_mm_add_epi32(acc, _mm_madd_epi16(px, _mm_loadu_si128((const __m128i*)(w + k))));
+		}
+		int sum=HorizontalPixel1_Scalar(p, w, k, n, ROUNDING + HorizontalSum_SSE41(acc));
+		tgt[i]=clamp8(sum >> PRECISION);
+	}
+}
+
+PPL7_TARGET_SSE41 int VerticalRow_SSE41(const int16_t* w, int n, const uint8_t* const* rows, uint8_t* tgt, int x, int bytes)
+{
+	const __m128i zero=_mm_setzero_si128();
+	for (;x + 16 <= bytes;x+=16) {
+		__m128i a0=_mm_set1_epi32(ROUNDING), a1=a0, a2=a0, a3=a0;
+		for (int k=0;k < n;k+=2) {
+			__m128i r0=_mm_loadu_si128((const __m128i*)(rows[k] + x));
+			__m128i r1, ww;
+			if (k + 1 < n) {
+				r1=_mm_loadu_si128((const __m128i*)(rows[k + 1] + x));
+				ww=_mm_set1_epi32(pairWeights(w[k], w[k + 1]));
+			} else {
+				r1=zero;
+				ww=_mm_set1_epi32(pairWeights(w[k], 0));
+			}
+			__m128i lo0=_mm_unpacklo_epi8(r0, zero), lo1=_mm_unpacklo_epi8(r1, zero);
+			__m128i hi0=_mm_unpackhi_epi8(r0, zero), hi1=_mm_unpackhi_epi8(r1, zero);
+			a0=_mm_add_epi32(a0, _mm_madd_epi16(_mm_unpacklo_epi16(lo0, lo1), ww));
+			a1=_mm_add_epi32(a1, _mm_madd_epi16(_mm_unpackhi_epi16(lo0, lo1), ww));
+			a2=_mm_add_epi32(a2, _mm_madd_epi16(_mm_unpacklo_epi16(hi0, hi1), ww));
+			a3=_mm_add_epi32(a3, _mm_madd_epi16(_mm_unpackhi_epi16(hi0, hi1), ww));
+		}
+		a0=_mm_srai_epi32(a0, PRECISION);
+		a1=_mm_srai_epi32(a1, PRECISION);
+		a2=_mm_srai_epi32(a2, PRECISION);
+		a3=_mm_srai_epi32(a3, PRECISION);
+		_mm_storeu_si128((__m128i*)(tgt + x), _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3)));
+	}
+	return x;
+}
+
+PPL7_TARGET_SSE41 int PremultiplyRow_SSE41(const uint8_t* src, uint8_t* tgt, int x, int pixels)
+{
+	const __m128i zero=_mm_setzero_si128();
+	const __m128i bias=_mm_set1_epi16(128);
+	const __m128i alpha=_mm_set1_epi32((int)0xff000000);
+	const __m128i amask=_mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+	for (;x + 4 <= pixels;x+=4) {
+		__m128i v=_mm_loadu_si128((const __m128i*)(src + x * 4));
+		__m128i lo=_mm_unpacklo_epi8(v, zero);
+		__m128i hi=_mm_unpackhi_epi8(v, zero);
+		lo=_mm_add_epi16(_mm_mullo_epi16(lo, _mm_shuffle_epi8(lo, amask)), bias);
+		hi=_mm_add_epi16(_mm_mullo_epi16(hi, _mm_shuffle_epi8(hi, amask)), bias);
+		lo=_mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi=_mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+		__m128i r=_mm_blendv_epi8(_mm_packus_epi16(lo, hi), v, alpha);
+		_mm_storeu_si128((__m128i*)(tgt + x * 4), r);
+	}
+	return x;
+}
+
+PPL7_TARGET_AVX2 void HorizontalRow4_AVX2(const COEFFICIENTS& c, const uint8_t* src, uint8_t* tgt)
+{
+	const __m256i mask=_mm256_setr_epi8(0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6, -1, 3, -1, 7, -1,
+		8, -1, 12, -1, 9, -1, 13, -1, 10, -1, 14, -1, 11, -1, 15, -1);
+	int width=(int)c.start.size();
+	for (int i=0;i < width;i++) {
+		const uint8_t* p=src + c.start[i] * 4;
+		const int16_t* w=&c.weights[(size_t)i * c.taps];
+		int n=c.count[i];
+		int k=0;
+		__m256i acc2=_mm256_setzero_si256();
+		for (;k + 3 < n;k+=4) {
+			__m256i px=_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(p + k * 4)));
+			int w01=pairWeights(w[k], w[k + 1]), w23=pairWeights(w[k + 2], w[k + 3]);
+			__m256i ww=_mm256_setr_epi32(w01, w01, w01, w01, w23, w23, w23, w23);
+			acc2=_mm256_add_epi32(acc2, _mm256_madd_epi16(_mm256_shuffle_epi8(px, mask), ww));
+		}
+		__m128i acc=_mm_add_epi32(_mm256_castsi256_si128(acc2), _mm256_extracti128_si256(acc2, 1));
+		acc=HorizontalPixel4_SSE41(p, w, k, n, _mm_add_epi32(acc, _mm_set1_epi32(ROUNDING)));
+		StorePixel4_SSE41(acc, tgt + i * 4);
+	}
+}
+
+PPL7_TARGET_AVX2 void HorizontalRow1_AVX2(const COEFFICIENTS& c, const uint8_t* src, uint8_t* tgt)
+{
+	int width=(int)c.start.size();
+	for (int i=0;i < width;i++) {
+		const uint8_t* p=src + c.start[i];
+		const int16_t* w=&c.weights[(size_t)i * c.taps];
+		int n=c.count[i];
+		int k=0;
+		__m256i acc2=_mm256_setzero_si256();
+		for (;k + 15 < n;k+=16) {
+			__m256i px=_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(p + k)));
+			acc2=_mm256_add_epi32(acc2, _mm256_madd_epi16(px, _mm256_loadu_si256((const __m256i*)(w + k))));
+		}
+		__m128i acc=_mm_add_epi32(_mm256_castsi256_si128(acc2), _mm256_extracti128_si256(acc2, 1));
+		for (;k + 7 < n;k+=8) {
+			__m128i px=_mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(p + k)));
+			acc=_mm_add_epi32(acc, _mm_madd_epi16(px, _mm_loadu_si128((const __m128i*)(w + k))));
+		}
+		int sum=HorizontalPixel1_Scalar(p, w, k, n, ROUNDING + HorizontalSum_SSE41(acc));
+		tgt[i]=clamp8(sum >> PRECISION);
+	}
+}
+
+PPL7_TARGET_AVX2 int VerticalRow_AVX2(const int16_t* w, int n, const uint8_t* const* rows, uint8_t* tgt, int x, int bytes)
+{
+	// Die Entpack- und Pack-Befehle arbeiten je 128-Bit-Hälfte, die Reihenfolge bleibt dadurch erhalten
+	const __m256i zero=_mm256_setzero_si256();
+	for (;x + 32 <= bytes;x+=32) {
+		__m256i a0=_mm256_set1_epi32(ROUNDING), a1=a0, a2=a0, a3=a0;
+		for (int k=0;k < n;k+=2) {
+			__m256i r0=_mm256_loadu_si256((const __m256i*)(rows[k] + x));
+			__m256i r1, ww;
+			if (k + 1 < n) {
+				r1=_mm256_loadu_si256((const __m256i*)(rows[k + 1] + x));
+				ww=_mm256_set1_epi32(pairWeights(w[k], w[k + 1]));
+			} else {
+				r1=zero;
+				ww=_mm256_set1_epi32(pairWeights(w[k], 0));
+			}
+			__m256i lo0=_mm256_unpacklo_epi8(r0, zero), lo1=_mm256_unpacklo_epi8(r1, zero);
+			__m256i hi0=_mm256_unpackhi_epi8(r0, zero), hi1=_mm256_unpackhi_epi8(r1, zero);
+			a0=_mm256_add_epi32(a0, _mm256_madd_epi16(_mm256_unpacklo_epi16(lo0, lo1), ww));
+			a1=_mm256_add_epi32(a1, _mm256_madd_epi16(_mm256_unpackhi_epi16(lo0, lo1), ww));
+			a2=_mm256_add_epi32(a2, _mm256_madd_epi16(_mm256_unpacklo_epi16(hi0, hi1), ww));
+			a3=_mm256_add_epi32(a3, _mm256_madd_epi16(_mm256_unpackhi_epi16(hi0, hi1), ww));
+		}
+		a0=_mm256_srai_epi32(a0, PRECISION);
+		a1=_mm256_srai_epi32(a1, PRECISION);
+		a2=_mm256_srai_epi32(a2, PRECISION);
+		a3=_mm256_srai_epi32(a3, PRECISION);
+		_mm256_storeu_si256((__m256i*)(tgt + x), _mm256_packus_epi16(_mm256_packs_epi32(a0, a1), _mm256_packs_epi32(a2, a3)));
+	}
+	return VerticalRow_SSE41(w, n, rows, tgt, x, bytes);
+}
+
+PPL7_TARGET_AVX2 int PremultiplyRow_AVX2(const uint8_t* src, uint8_t* tgt, int x, int pixels)
+{
+	const __m256i zero=_mm256_setzero_si256();
+	const __m256i bias=_mm256_set1_epi16(128);
+	const __m256i alpha=_mm256_set1_epi32((int)0xff000000);
+	const __m256i amask=_mm256_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15,
+		6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+	for (;x + 8 <= pixels;x+=8) {
+		__m256i v=_mm256_loadu_si256((const __m256i*)(src + x * 4));
+		__m256i lo=_mm256_unpacklo_epi8(v, zero);
+		__m256i hi=_mm256_unpackhi_epi8(v, zero);
+		lo=_mm256_add_epi16(_mm256_mullo_epi16(lo, _mm256_shuffle_epi8(lo, amask)), bias);
+		hi=_mm256_add_epi16(_mm256_mullo_epi16(hi, _mm256_shuffle_epi8(hi, amask)), bias);
+		lo=_mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+		hi=_mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+		__m256i r=_mm256_blendv_epi8(_mm256_packus_epi16(lo, hi), v, alpha);
+		_mm256_storeu_si256((__m256i*)(tgt + x * 4), r);
+	}
+	return PremultiplyRow_SSE41(src, tgt, x, pixels);
+}
+#endif
+
+void HorizontalRow(const RESAMPLE_JOB& job, const uint8_t* src, uint8_t* tgt)
+{
+#ifdef PPL7_SIMD_X86
+	if (job.caps & CPUCAPS::CPU_HAVE_AVX2) {
+		if (job.channels == 4) HorizontalRow4_AVX2(job.h, src, tgt);
+		else HorizontalRow1_AVX2(job.h, src, tgt);
+		return;
+	}
+	if (job.caps & CPUCAPS::CPU_HAVE_SSE41) {
+		if (job.channels == 4) HorizontalRow4_SSE41(job.h, src, tgt);
+		else HorizontalRow1_SSE41(job.h, src, tgt);
+		return;
+	}
+#endif
+	if (job.channels == 4) HorizontalRow4_Scalar(job.h, src, tgt);
+	else HorizontalRow1_Scalar(job.h, src, tgt);
+}
+
+void VerticalRow(uint32_t caps, const int16_t* w, int n, const uint8_t* const* rows, uint8_t* tgt, int bytes)
+{
+	int x=0;
+#ifdef PPL7_SIMD_X86
+	if (caps & CPUCAPS::CPU_HAVE_AVX2) x=VerticalRow_AVX2(w, n, rows, tgt, x, bytes);
+	else if (caps & CPUCAPS::CPU_HAVE_SSE41) x=VerticalRow_SSE41(w, n, rows, tgt, x, bytes);
+#endif
+	VerticalRow_Scalar(w, n, rows, tgt, x, bytes);
+}
+
+void PremultiplyRow(uint32_t caps, const uint8_t* src, uint8_t* tgt, int pixels)
+{
+	int x=0;
+#ifdef PPL7_SIMD_X86
+	if (caps & CPUCAPS::CPU_HAVE_AVX2) x=PremultiplyRow_AVX2(src, tgt, x, pixels);
+	else if (caps & CPUCAPS::CPU_HAVE_SSE41) x=PremultiplyRow_SSE41(src, tgt, x, pixels);
+#endif
+	PremultiplyRow_Scalar(src, tgt, x, pixels);
+}
+
+void processBand(const RESAMPLE_JOB& job, int y0, int y1)
+{
+	int ymin=job.v.start[y0], ymax=0;
+	for (int j=y0;j < y1;j++) {
+		if (job.v.start[j] < ymin) ymin=job.v.start[j];
+		if (job.v.start[j] + job.v.count[j] > ymax) ymax=job.v.start[j] + job.v.count[j];
+	}
+	int sw=job.src->width();
+	int dw=job.tgt->width();
+	size_t rowbytes=(size_t)dw * job.channels;
+	std::vector<uint8_t> tmp((size_t)(ymax - ymin) * rowbytes);
+	std::vector<uint8_t> pre(job.premultiply ? (size_t)sw * 4 : 0);
+	for (int sy=ymin;sy < ymax;sy++) {
+		const uint8_t* s=(const uint8_t*)job.src->adr(0, sy);
+		if (job.premultiply) {
+			PremultiplyRow(job.caps, s, &pre[0], sw);
+			s=&pre[0];
+		}
+		HorizontalRow(job, s, &tmp[(size_t)(sy - ymin) * rowbytes]);
+	}
+	std::vector<const uint8_t*> rows(job.v.taps);
+	for (int j=y0;j < y1;j++) {
+		int n=job.v.count[j];
+		for (int k=0;k < n;k++) rows[k]=&tmp[(size_t)(job.v.start[j] + k - ymin) * rowbytes];
+		uint8_t* t=(uint8_t*)job.tgt->adr(0, j);
+		VerticalRow(job.caps, &job.v.weights[(size_t)j * job.v.taps], n, &rows[0], t, (int)rowbytes);
+		if (job.premultiply) UnpremultiplyRow(t, dw);
+	}
+}
+
+}	// EOF anonymous namespace
+
+/*!\brief Konstruktor
+ *
+ * \desc
+ * Erzeugt einen neuen Resampler mit dem angegebenen Filter.
+ *
+ * \param filter Zu verwendender Filter, siehe Resampler::Filter
+ * \param threads Anzahl Threads. Bei 0 wird ein gemeinsamer Thread-Pool mit einem Thread
+ * pro CPU-Kern verwendet, bei 1 wird ausschließlich im aufrufenden Thread gerechnet.
+ */
+Resampler::Resampler(Filter filter, size_t threads)
+{
+	myfilter=filter;
+	numthreads=threads;
+	executor=NULL;
+}
+
+Resampler::~Resampler()
+{
+	delete executor;
+}
+
+/*!\brief Filter festlegen
+ *
+ * \param filter Zu verwendender Filter, siehe Resampler::Filter
+ */
+void Resampler::setFilter(Filter filter)
+{
+	myfilter=filter;
+}
+
+/*!\brief Verwendeten Filter abfragen
+ *
+ * \return Liefert den Filter zurück
+ */
+Resampler::Filter Resampler::filter() const
+{
+	return myfilter;
+}
+
+/*!\brief Anzahl Threads festlegen
+ *
+ * \param threads Anzahl Threads. Bei 0 wird ein gemeinsamer Thread-Pool mit einem Thread
+ * pro CPU-Kern verwendet, bei 1 wird ausschließlich im aufrufenden Thread gerechnet.
+ */
+void Resampler::setThreads(size_t threads)
+{
+	if (threads == numthreads) return;
+	delete executor;
+	executor=NULL;
+	numthreads=threads;
+}
+
+/*!\brief Eingestellte Anzahl Threads abfragen
+ *
+ * \return Liefert den mit dem Konstruktor oder Resampler::setThreads gesetzten Wert zurück
+ */
+size_t Resampler::threads() const
+{
+	return numthreads;
+}
+
+TaskExecutor* Resampler::workers()
+{
+	if (numthreads == 1) return NULL;
+	if (numthreads == 0) return &sharedExecutor();
+	if (!executor) executor=new TaskExecutor(numthreads, "Resampler");
+	return executor;
+}
+
+/*!\brief Grafik in ein Drawable skalieren
+ *
+ * \desc
+ * Skaliert die Grafik \p src auf die Größe von \p tgt. Beide müssen das gleiche Farbformat
+ * haben. Quelle und Ziel dürfen sich nicht überlappen.
+ *
+ * \param src Quellgrafik
+ * \param tgt Ziel, dessen Größe die Größe des Ergebnisses bestimmt
+ * \exception UnsupportedColorFormatException Das Farbformat wird nicht unterstützt oder
+ * Quelle und Ziel haben unterschiedliche Farbformate
+ */
+void Resampler::resample(const Drawable& src, Drawable& tgt)
+{
+	RGBFormat format=src.rgbformat();
+	if (!isSupported(format) || tgt.rgbformat() != format) {
+		throw UnsupportedColorFormatException("%s => %s", (const char*)format.name(), (const char*)tgt.rgbformat().name());
+	}
+	if (src.isEmpty() || tgt.isEmpty()) return;
+	RESAMPLE_JOB job;
+	job.src=&src;
+	job.tgt=&tgt;
+	job.channels=format.bytesPerPixel();
+	job.premultiply=(format == RGBFormat::A8R8G8B8 || format == RGBFormat::A8B8G8R8);
+	job.caps=resamplerCaps().get();
+	computeCoefficients(myfilter, src.width(), tgt.width(), job.h);
+	computeCoefficients(myfilter, src.height(), tgt.height(), job.v);
+
+	int dh=tgt.height();
+	size_t bands=1;
+	TaskExecutor* ex=NULL;
+	if ((size_t)src.width() * src.height() + (size_t)tgt.width() * dh >= MinParallelPixels) {
+		ex=workers();
+		if (ex) {
+			bands=ex->threads() * 2;
+			if (bands > (size_t)(dh / MinBandRows)) bands=dh / MinBandRows;
+		}
+	}
+	if (bands <= 1) {
+		processBand(job, 0, dh);
+		return;
+	}
+	ex->parallelFor((size_t)0, bands, [&](size_t b) {
+		processBand(job, (int)(b * dh / bands), (int)((b + 1) * dh / bands));
+	}, (size_t)1);
+}
+
+/*!\brief Skalierte Kopie einer Grafik erzeugen
+ *
+ * \param src Quellgrafik
+ * \param width Breite der neuen Grafik
+ * \param height Höhe der neuen Grafik
+ * \return Neue Grafik im Farbformat von \p src
+ * \exception UnsupportedColorFormatException Das Farbformat wird nicht unterstützt
+ */
+Image Resampler::resampled(const Drawable& src, int width, int height)
+{
+	Image img(width, height, src.rgbformat());
+	resample(src, img);
+	return img;
+}
+
+/*!\brief Prüfen, ob ein Farbformat unterstützt wird
+ *
+ * \param format Farbformat
+ * \return Liefert \c true zurück, wenn Grafiken in diesem Format skaliert werden können
+ */
+bool Resampler::isSupported(const RGBFormat& format)
+{
+	switch (format) {
+		case RGBFormat::A8R8G8B8:
+		case RGBFormat::X8R8G8B8:
+		case RGBFormat::A8B8G8R8:
+		case RGBFormat::X8B8G8R8:
+		case RGBFormat::GREY8:
+		case RGBFormat::A8:
+			return true;
+	}
+	return false;
+}
+
+/*!\brief Auswahl der Vektor-Kernel einschränken
+ *
+ * \desc
+ * Legt fest, welche Varianten der Filterroutinen verwendet werden. Die Werte und
+ * Einschränkungen sind die gleichen wie bei Grafix::setBlitCaps. Laufende Skalierungen
+ * behalten die Auswahl bei, mit der sie gestartet wurden.
+ *
+ * \param caps Gewünschte Features
+ * \return Liefert die vorher aktiven Features zurück
+ */
+uint32_t Resampler::setCaps(uint32_t caps)
+{
+	return resamplerCaps().set(caps);
+}
+
+/*!\brief Aktive Vektor-Kernel abfragen
+ *
+ * \return Liefert die Features zurück, die für das Skalieren verwendet werden. Ist kein
+ * Bit gesetzt, werden die skalaren Implementierungen verwendet.
+ */
+uint32_t Resampler::caps()
+{
+	return resamplerCaps().get();
+}
+
+}	// EOF namespace grafix
+}	// EOF namespace ppl7
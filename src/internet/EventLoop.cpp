@@ -0,0 +1,505 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
+#include "ppl7.h"
+#include "ppl7-inet.h"
+
+namespace ppl7 {
+
+/*!\class EventLoop
+ * \ingroup PPLGroupInternet
+ *
+ * \brief Ereignisschleife zum Überwachen vieler Sockets
+ *
+ * \header \#include <ppl7-inet.h>
+ *
+ * \desc
+ * Die EventLoop überwacht beliebig viele Datei- oder Socket-Deskriptoren mit epoll und ruft
+ * für jeden Deskriptor, der lesbar oder beschreibbar wird, die Funktion
+ * EventLoop::Handler::eventReady des registrierten Handlers auf. Im Gegensatz zu select
+ * steigt der Aufwand dabei nicht mit der Anzahl der Deskriptoren, so dass auch viele tausend
+ * Verbindungen gleichzeitig bedient werden können.
+ * \par
+ * Die Handler werden von einer festen Anzahl Worker-Threads aufgerufen (siehe
+ * EventLoop::setWorkerThreads). Ein Deskriptor wird dabei immer nur von einem Thread
+ * gleichzeitig bearbeitet: nach einem Ereignis wird er erst dann wieder überwacht, wenn
+ * eventReady zurückgekehrt ist. Der Rückgabewert von eventReady legt fest, auf welche
+ * Ereignisse als nächstes gewartet werden soll. Gibt die Funktion 0 zurück, wird der
+ * Deskriptor aus der Schleife entfernt und EventLoop::Handler::eventRemoved aufgerufen.
+ * \par
+ * Die Schleife selbst läuft in EventLoop::run, bis sie mit EventLoop::stop beendet wird.
+ *
+ * \note Die Klasse steht nur auf Systemen zur Verfügung, die epoll unterstützen. Auf
+ * anderen Systemen wirft der Konstruktor eine UnsupportedFeatureException.
+ */
+
+/*!\class EventLoop::Handler
+ * \ingroup PPLGroupInternet
+ *
+ * \brief Empfänger der Ereignisse einer EventLoop
+ *
+ * \desc
+ * Von dieser Klasse muss abgeleitet werden, um Deskriptoren mit EventLoop::add zu
+ * registrieren. Die Funktion eventReady wird innerhalb eines Worker-Threads aufgerufen und
+ * muss daher threadsicher sein, wenn ein Handler für mehrere Deskriptoren verwendet wird.
+ */
+
+/*!\fn int EventLoop::Handler::eventReady(int fd, int events)
+ * \brief Ereignis auf einem Deskriptor verarbeiten
+ *
+ * @param fd Der Deskriptor
+ * @param events Kombination aus EventLoop::Events
+ * @return Ereignisse, auf die als nächstes gewartet werden soll, oder 0, wenn der
+ * Deskriptor entfernt werden soll
+ */
+
+EventLoop::Handler::~Handler()
+{
+
+}
+
+/*!\brief Deskriptor wurde entfernt
+ *
+ * \desc
+ * Wird aufgerufen, nachdem der Deskriptor \p fd aus der EventLoop entfernt wurde, weil
+ * eventReady 0 zurückgegeben hat. Der Handler kann den Deskriptor hier schließen.
+ */
+void EventLoop::Handler::eventRemoved(int)
+{
+
+}
+
+class EventLoop::Registration
+{
+public:
+    int fd;
+    int events;
+    int pending;
+    bool inflight;
+    bool removed;
+    Handler* handler;
+};
+
+class EventLoop::Worker : public Thread
+{
+private:
+    EventLoop* loop;
+
+public:
+    Worker(EventLoop* loop)
+    {
+        this->loop = loop;
+    }
+    void run()
+    {
+        while (!threadShouldStop()) {
+            if (!loop->processQueue(this)) break;
+        }
+    }
+};
+
+#ifdef HAVE_SYS_EPOLL_H
+static uint32_t toEpollEvents(int events)
+{
+    uint32_t e = EPOLLONESHOT | EPOLLRDHUP;
+    if (events & EventLoop::EVENT_READ) e |= EPOLLIN;
+    if (events & EventLoop::EVENT_WRITE) e |= EPOLLOUT;
+    return e;
+}
+
+static int fromEpollEvents(uint32_t e)
+{
+    int events = 0;
+    // Hat die Gegenstelle nur ihre Senderichtung geschlossen (EPOLLRDHUP), kann noch
+    // geschrieben werden, das Ende wird daher wie lesbare Daten gemeldet (read liefert 0).
+    if (e & (EPOLLIN | EPOLLPRI | EPOLLRDHUP)) events |= EventLoop::EVENT_READ;
+    if (e & EPOLLOUT) events |= EventLoop::EVENT_WRITE;
+    if (e & EPOLLHUP) events |= EventLoop::EVENT_HANGUP;
+    if (e & EPOLLERR) events |= EventLoop::EVENT_ERROR;
+    return events;
+}
+#endif
+
+/*!\brief Konstruktor
+ *
+ * \exception UnsupportedFeatureException epoll wird vom System nicht unterstützt
+ */
+EventLoop::EventLoop()
+{
+    numWorkers = 4;
+    stopflag = false;
+    running = false;
+#ifdef HAVE_SYS_EPOLL_H
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd < 0) throwExceptionFromErrno(errno, "EventLoop: epoll_create1");
+#else
+    epollfd = -1;
+    throw UnsupportedFeatureException("epoll");
+#endif
+}
+
+/*!\brief Destruktor
+ *
+ * \desc
+ * Beendet die Schleife und die Worker-Threads. Die registrierten Deskriptoren werden nicht
+ * geschlossen.
+ */
+EventLoop::~EventLoop()
+{
+    stop();
+    while (isRunning()) MSleep(1);
+    mutex.lock();
+    std::map<int, Registration*>::iterator it;
+    for (it = registrations.begin(); it != registrations.end(); ++it) delete it->second;
+    registrations.clear();
+    mutex.unlock();
+#ifdef HAVE_SYS_EPOLL_H
+    if (epollfd >= 0) close(epollfd);
+#endif
+}
+
+/*!\brief Anzahl Worker-Threads festlegen
+ *
+ * \desc
+ * Legt fest, wie viele Threads die Ereignisse verarbeiten. Der Default ist 4. Bei 0 werden die
+ * Handler direkt in dem Thread aufgerufen, der EventLoop::run ausführt. Die Einstellung wird
+ * beim nächsten Aufruf von EventLoop::run wirksam.
+ */
+void EventLoop::setWorkerThreads(size_t num)
+{
+    mutex.lock();
+    numWorkers = num;
+    mutex.unlock();
+}
+
+size_t EventLoop::workerThreads() const
+{
+    return numWorkers;
+}
+
+/*!\brief Deskriptor überwachen
+ *
+ * \desc
+ * Nimmt den Deskriptor \p fd in die Schleife auf. Sobald eines der Ereignisse \p events
+ * eintritt, wird \p handler aufgerufen. Der Deskriptor sollte auf non-blocking gestellt
+ * sein.
+ *
+ * @param fd Deskriptor
+ * @param events Kombination aus EventLoop::EVENT_READ und EventLoop::EVENT_WRITE
+ * @param handler Pointer auf den Handler
+ * @exception IllegalArgumentException Ungültiger Deskriptor oder Handler
+ * @exception DuplicateInstanceException Der Deskriptor wird bereits überwacht
+ */
+void EventLoop::add(int fd, int events, Handler* handler)
+{
+    if (fd < 0 || handler == NULL) throw IllegalArgumentException("EventLoop::add");
+#ifdef HAVE_SYS_EPOLL_H
+    Registration* r = new Registration;
+    r->fd = fd;
+    r->events = events;
+    r->pending = 0;
+    r->inflight = false;
+    r->removed = false;
+    r->handler = handler;
+    mutex.lock();
+    if (registrations.find(fd) != registrations.end()) {
+        mutex.unlock();
+        delete r;
+        throw DuplicateInstanceException("EventLoop::add: %d", fd);
+    }
+    registrations.insert(std::pair<int, Registration*>(fd, r));
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = toEpollEvents(events);
+    ev.data.fd = fd;
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        int e = errno;
+        registrations.erase(fd);
+        mutex.unlock();
+        delete r;
+        throwExceptionFromErrno(e, "EventLoop::add");
+    }
+    mutex.unlock();
+#endif
+}
+
+/*!\brief Deskriptor nicht mehr überwachen
+ *
+ * \desc
+ * Entfernt \p fd aus der Schleife, ohne EventLoop::Handler::eventRemoved aufzurufen. Wird der
+ * Deskriptor gerade von einem Worker bearbeitet, wird er entfernt, sobald der Handler
+ * zurückkehrt.
+ */
+void EventLoop::remove(int fd)
+{
+#ifdef HAVE_SYS_EPOLL_H
+    mutex.lock();
+    std::map<int, Registration*>::iterator it = registrations.find(fd);
+    if (it == registrations.end()) {
+        mutex.unlock();
+        return;
+    }
+    Registration* r = it->second;
+    registrations.erase(it);
+    epoll_ctl(epollfd, EPOLL_CTL_DEL, fd, NULL);
+    if (r->inflight) r->removed = true;
+    else delete r;
+    mutex.unlock();
+#endif
+}
+
+/*!\brief Prüfen, ob ein Deskriptor überwacht wird
+ */
+bool EventLoop::contains(int fd) const
+{
+    mutex.lock();
+    bool ret = (registrations.find(fd) != registrations.end());
+    mutex.unlock();
+    return ret;
+}
+
+/*!\brief Anzahl überwachter Deskriptoren
+ */
+size_t EventLoop::size() const
+{
+    mutex.lock();
+    size_t ret = registrations.size();
+    mutex.unlock();
+    return ret;
+}
+
+/*!\brief Überwachung eines Deskriptors erneuern
+ *
+ * \desc
+ * Wegen EPOLLONESHOT wird ein Deskriptor nach jedem Ereignis deaktiviert. Diese Funktion
+ * aktiviert ihn wieder mit den Ereignissen aus \p r->events. Der Mutex muss gesperrt sein.
+ */
+void EventLoop::rearm(Registration* r)
+{
+#ifdef HAVE_SYS_EPOLL_H
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = toEpollEvents(r->events);
+    ev.data.fd = r->fd;
+    epoll_ctl(epollfd, EPOLL_CTL_MOD, r->fd, &ev);
+#endif
+}
+
+/*!\brief Ereignis an den Handler weitergeben
+ *
+ * \desc
+ * Ruft den Handler auf und aktiviert den Deskriptor anschließend mit den zurückgegebenen
+ * Ereignissen wieder. Liefert der Handler 0 zurück oder wirft er eine Exception, wird der
+ * Deskriptor entfernt und EventLoop::Handler::eventRemoved aufgerufen.
+ */
+void EventLoop::dispatch(Registration* r)
+{
+    int next = 0;
+    try {
+        next = r->handler->eventReady(r->fd, r->pending);
+    } catch (...) {
+        next = 0;
+    }
+    mutex.lock();
+    r->inflight = false;
+    if (r->removed) {
+        mutex.unlock();
+        delete r;
+        return;
+    }
+    if (next != 0) {
+        r->events = next;
+        rearm(r);
+        mutex.unlock();
+        return;
+    }
+    registrations.erase(r->fd);
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_ctl(epollfd, EPOLL_CTL_DEL, r->fd, NULL);
+#endif
+    mutex.unlock();
+    try {
+        r->handler->eventRemoved(r->fd);
+    } catch (...) {
+    }
+    delete r;
+}
+
+/*!\brief Warteschlange der Worker abarbeiten
+ *
+ * \desc
+ * Wird von den Worker-Threads aufgerufen. Wartet auf das nächste Ereignis in der
+ * Warteschlange und verarbeitet es.
+ *
+ * @return Liefert \c false zurück, wenn die Schleife beendet wird.
+ */
+bool EventLoop::processQueue(Worker* worker)
+{
+    queuemutex.lock();
+    while (queue.empty()) {
+        if (stopflag || worker->threadShouldStop()) {
+            queuemutex.unlock();
+            return false;
+        }
+        queuemutex.wait(100);
+    }
+    Registration* r = queue.front();
+    queue.pop_front();
+    queuemutex.unlock();
+    dispatch(r);
+    return true;
+}
+
+/*!\brief Schleife ausführen
+ *
+ * \desc
+ * Startet die Worker-Threads und wartet auf Ereignisse, bis EventLoop::stop aufgerufen wird.
+ * Die Funktion kehrt erst zurück, wenn alle Worker beendet sind.
+ *
+ * @param timeout_ms Intervall in Millisekunden, in dem geprüft wird, ob die Schleife beendet
+ * werden soll.
+ */
+void EventLoop::run(int timeout_ms)
+{
+#ifdef HAVE_SYS_EPOLL_H
+    mutex.lock();
+    if (running) {
+        mutex.unlock();
+        throw OperationFailedException("EventLoop::run: already running");
+    }
+    running = true;
+    size_t num = numWorkers;
+    mutex.unlock();
+
+    for (size_t i = 0; i < num; i++) {
+        Worker* w = new Worker(this);
+        workers.addThread(w);
+        w->threadStart();
+    }
+    struct epoll_event events[256];
+    while (!stopflag) {
+        int n = epoll_wait(epollfd, events, 256, timeout_ms);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            mutex.lock();
+            std::map<int, Registration*>::iterator it = registrations.find(events[i].data.fd);
+            if (it == registrations.end() || it->second->inflight) {
+                mutex.unlock();
+                continue;
+            }
+            Registration* r = it->second;
+            r->inflight = true;
+            r->pending = fromEpollEvents(events[i].events);
+            mutex.unlock();
+            if (num == 0) {
+                dispatch(r);
+            } else {
+                queuemutex.lock();
+                queue.push_back(r);
+                queuemutex.unlock();
+                queuemutex.signal();
+            }
+        }
+    }
+    workers.signalStopThreads();
+    queuemutex.lock();
+    stopflag = true;
+    queuemutex.unlock();
+    for (size_t i = 0; i < num; i++) queuemutex.signal();
+    workers.stopThreads();
+    workers.destroyAllThreads();
+
+    // Nicht mehr bearbeitete Ereignisse wieder aktivieren, damit sie beim nächsten Aufruf
+    // von run erneut gemeldet werden
+    mutex.lock();
+    queuemutex.lock();
+    while (!queue.empty()) {
+        Registration* r = queue.front();
+        queue.pop_front();
+        r->inflight = false;
+        if (r->removed) delete r;
+        else rearm(r);
+    }
+    stopflag = false;
+    queuemutex.unlock();
+    running = false;
+    mutex.unlock();
+#else
+    throw UnsupportedFeatureException("epoll");
+#endif
+}
+
+/*!\brief Schleife beenden
+ *
+ * \desc
+ * Signalisiert EventLoop::run, dass die Schleife beendet werden soll. Die Funktion wartet
+ * nicht darauf, dass run zurückkehrt (siehe EventLoop::isRunning). Wird sie aufgerufen,
+ * bevor run gestartet wurde, kehrt run sofort wieder zurück.
+ */
+void EventLoop::stop()
+{
+    queuemutex.lock();
+    stopflag = true;
+    queuemutex.unlock();
+}
+
+/*!\brief Prüfen, ob die Schleife läuft
+ */
+bool EventLoop::isRunning() const
+{
+    mutex.lock();
+    bool ret = running;
+    mutex.unlock();
+    return ret;
+}
+
+}	// EOF namespace ppl7
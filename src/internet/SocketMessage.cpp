@@ -199,6 +199,24 @@ void SocketMessage::getPayload(AssocArray &msg) const
 	msg.importBinary(payload,payload_size);
 }
 
+/*!\brief Payload ohne Import lesen
+ *
+ * \desc
+ * Lässt \p msg direkt auf den Payload der Nachricht zeigen, ohne ihn in ein AssocArray zu
+ * importieren. Die View ist nur so lange gültig, wie die Nachricht existiert und ihr Payload
+ * nicht verändert wird.
+ */
+void SocketMessage::getPayload(AssocArrayView &msg) const
+{
+	if (!payload) {
+		throw NoDataAvailableException();
+	}
+	if (payload_type!=Variant::TYPE_ASSOCARRAY) {
+		throw DataInOtherFormatException();
+	}
+	msg.set(payload,payload_size);
+}
+
 void SocketMessage::getPayload(ByteArray &msg) const
 {
 	if (!payload) {
@@ -0,0 +1,512 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#ifdef HAVE_NETDB_H
+#include <netdb.h>
+#endif
+
+#include "ppl7.h"
+#include "ppl7-inet.h"
+#include "socket_ppl7.h"
+
+#ifdef HAVE_OPENSSL
+#include <openssl/ssl.h>
+#endif
+
+namespace ppl7 {
+
+/*!\class TCPServer
+ * \ingroup PPLGroupInternet
+ *
+ * \brief Ereignisgesteuerter TCP-Server für viele gleichzeitige Verbindungen
+ *
+ * \header \#include <ppl7-inet.h>
+ *
+ * \desc
+ * Im Gegensatz zu TCPSocket::listen, bei dem jede eingehende Verbindung an
+ * TCPSocket::receiveConnect übergeben und dort in der Regel in einem eigenen Thread
+ * bearbeitet wird, verwaltet der TCPServer alle Verbindungen in einer EventLoop. Eine feste
+ * Anzahl Worker-Threads (siehe TCPServer::setWorkerThreads) ruft die virtuellen Funktionen
+ * TCPServer::onReadable und TCPServer::onWritable auf, sobald auf einer Verbindung Daten
+ * gelesen oder geschrieben werden können. Dadurch können viele tausend Clients gleichzeitig
+ * verbunden sein, ohne dass für jeden ein eigener Thread benötigt wird.
+ * \par
+ * Alle Verbindungen sind non-blocking. Liefert TCPSocket::read keine Daten mehr, wirft es eine
+ * OperationBlockedException, die vom Server abgefangen wird; die Verbindung wird dann bis zum
+ * Eintreffen weiterer Daten nicht mehr aufgerufen. Eine Verbindung wird immer nur von einem
+ * Worker gleichzeitig bearbeitet.
+ * \par
+ * Mit TCPServer::enableSSL werden alle Verbindungen verschlüsselt. Der TLS-Handshake wird dabei
+ * ebenfalls in der EventLoop durchgeführt (siehe TCPSocket::sslTryAccept), onReadable wird erst
+ * nach erfolgreichem Handshake aufgerufen.
+ *
+ * \example
+ * Ein einfacher Echo-Server:
+ * \code
+class EchoServer : public ppl7::TCPServer
+{
+	public:
+		void onReadable(Connection &conn) {
+			char buffer[4096];
+			size_t bytes=conn.read(buffer,sizeof(buffer));
+			if (bytes==0) conn.close();
+			else conn.write(buffer,bytes);
+		}
+};
+
+EchoServer server;
+server.bind("127.0.0.1",8000);
+server.setWorkerThreads(8);
+server.run();
+\endcode
+ */
+
+/*!\class TCPServer::Connection
+ * \ingroup PPLGroupInternet
+ *
+ * \brief Verbindung eines Clients mit dem TCPServer
+ *
+ * \desc
+ * Die Klasse wird vom TCPServer für jede angenommene Verbindung erzeugt und nach
+ * TCPServer::onDisconnect wieder gelöscht. Mit TCPServer::Connection::setUserData kann die
+ * Anwendung eigene Daten an die Verbindung hängen.
+ */
+
+TCPServer::Connection::Connection()
+{
+    peerport = 0;
+    handshake = false;
+    wantwrite = false;
+    closerequest = false;
+    userdata = NULL;
+}
+
+/*!\brief Hostname oder IP-Adresse der Gegenstelle
+ */
+const String& TCPServer::Connection::peerHost() const
+{
+    return peerhost;
+}
+
+/*!\brief Port der Gegenstelle
+ */
+int TCPServer::Connection::peerPort() const
+{
+    return peerport;
+}
+
+/*!\brief Auf Beschreibbarkeit warten
+ *
+ * \desc
+ * Ist \p enable \c true, wird TCPServer::onWritable aufgerufen, sobald Daten auf die Verbindung
+ * geschrieben werden können, beispielsweise um eine Antwort zu senden, die nicht auf einmal in den
+ * Sendepuffer gepasst hat. Die Einstellung wird wirksam, sobald der aktuelle Aufruf von onReadable
+ * oder onWritable zurückkehrt.
+ */
+void TCPServer::Connection::watchWritable(bool enable)
+{
+    wantwrite = enable;
+}
+
+/*!\brief Verbindung schließen
+ *
+ * \desc
+ * Die Verbindung wird geschlossen, sobald der aktuelle Aufruf von onReadable oder onWritable
+ * zurückkehrt. Wird noch mit TCPServer::Connection::watchWritable auf Beschreibbarkeit
+ * gewartet, wird onWritable weiter aufgerufen, bis das Warten beendet wird, und die
+ * Verbindung erst danach geschlossen. Anschließend wird TCPServer::onDisconnect aufgerufen.
+ */
+void TCPServer::Connection::close()
+{
+    closerequest = true;
+}
+
+/*!\brief Anwendungsdaten an die Verbindung hängen
+ */
+void TCPServer::Connection::setUserData(void* data)
+{
+    userdata = data;
+}
+
+/*!\brief Anwendungsdaten der Verbindung
+ */
+void* TCPServer::Connection::userData() const
+{
+    return userdata;
+}
+
+/*!\brief Konstruktor
+ */
+TCPServer::TCPServer()
+{
+    sslcontext = NULL;
+    listenfd = -1;
+}
+
+/*!\brief Destruktor
+ *
+ * \desc
+ * Beendet den Server und schließt alle noch offenen Verbindungen.
+ */
+TCPServer::~TCPServer()
+{
+    stop();
+    while (isRunning()) MSleep(1);
+    mutex.lock();
+    std::map<int, Connection*>::iterator it;
+    for (it = connections.begin(); it != connections.end(); ++it) delete it->second;
+    connections.clear();
+    mutex.unlock();
+}
+
+/*!\brief Server an eine Adresse binden
+ *
+ * \desc
+ * Legt fest, auf welcher IP-Adresse und welchem Port der Server auf Verbindungen wartet
+ * (siehe TCPSocket::bind).
+ */
+void TCPServer::bind(const String& host, int port)
+{
+    listener.bind(host, port);
+}
+
+/*!\brief Anzahl Worker-Threads festlegen
+ *
+ * \desc
+ * Legt fest, wie viele Threads die Verbindungen bearbeiten (siehe EventLoop::setWorkerThreads).
+ * Muss vor TCPServer::run aufgerufen werden.
+ */
+void TCPServer::setWorkerThreads(size_t num)
+{
+    loop.setWorkerThreads(num);
+}
+
+/*!\brief Verschlüsselung aktivieren
+ *
+ * \desc
+ * Alle ab jetzt angenommenen Verbindungen führen zunächst einen TLS-Handshake mit dem Kontext
+ * \p context durch. Der Kontext muss gültig bleiben, solange der Server läuft.
+ */
+void TCPServer::enableSSL(SSLContext& context)
+{
+    mutex.lock();
+    sslcontext = &context;
+    mutex.unlock();
+}
+
+/*!\brief Verschlüsselung deaktivieren
+ */
+void TCPServer::disableSSL()
+{
+    mutex.lock();
+    sslcontext = NULL;
+    mutex.unlock();
+}
+
+/*!\brief Server starten
+ *
+ * \desc
+ * Wartet auf eingehende Verbindungen und bearbeitet sie, bis TCPServer::stop aufgerufen wird.
+ * Beim Beenden werden alle noch offenen Verbindungen geschlossen.
+ *
+ * @param backlog Maximale Anzahl noch nicht angenommener Verbindungen (siehe TCPSocket::listen)
+ * @param timeout_ms Intervall in Millisekunden, in dem geprüft wird, ob der Server beendet
+ * werden soll
+ * @exception NotConnectedException TCPServer::bind wurde nicht aufgerufen
+ */
+void TCPServer::run(int backlog, int timeout_ms)
+{
+    PPLSOCKET* s = (PPLSOCKET*)listener.socket;
+    if ((!s) || (!s->sd)) throw NotConnectedException();
+    if (::listen(s->sd, backlog) != 0) throwSocketException(errno, "TCPServer::run");
+    listener.setBlocking(false);
+    listenfd = s->sd;
+    loop.add(listenfd, EventLoop::EVENT_READ, this);
+    try {
+        loop.run(timeout_ms);
+    } catch (...) {
+        loop.remove(listenfd);
+        throw;
+    }
+    loop.remove(listenfd);
+
+    mutex.lock();
+    std::map<int, Connection*> open;
+    open.swap(connections);
+    mutex.unlock();
+    std::map<int, Connection*>::iterator it;
+    for (it = open.begin(); it != open.end(); ++it) {
+        loop.remove(it->first);
+        try {
+            onDisconnect(*it->second);
+        } catch (...) {
+        }
+        delete it->second;
+    }
+}
+
+/*!\brief Server beenden
+ *
+ * \desc
+ * Signalisiert TCPServer::run, dass der Server beendet werden soll. Die Funktion wartet nicht
+ * darauf (siehe TCPServer::isRunning).
+ */
+void TCPServer::stop()
+{
+    loop.stop();
+}
+
+/*!\brief Prüfen, ob der Server läuft
+ */
+bool TCPServer::isRunning() const
+{
+    return loop.isRunning();
+}
+
+/*!\brief Anzahl offener Verbindungen
+ */
+size_t TCPServer::connectionCount() const
+{
+    mutex.lock();
+    size_t ret = connections.size();
+    mutex.unlock();
+    return ret;
+}
+
+/*!\brief Neue Verbindung annehmen
+ *
+ * \desc
+ * Wird aufgerufen, bevor eine neue Verbindung in die EventLoop aufgenommen wird. Die
+ * Standardimplementierung nimmt alle Verbindungen an.
+ *
+ * @return \c true, wenn die Verbindung angenommen werden soll, \c false, wenn sie
+ * geschlossen werden soll.
+ */
+bool TCPServer::onConnect(Connection&)
+{
+    return true;
+}
+
+/*!\fn void TCPServer::onReadable(Connection& conn)
+ * \brief Daten lesen
+ *
+ * \desc
+ * Wird aufgerufen, sobald auf der Verbindung \p conn Daten gelesen werden können, und muss von
+ * der abgeleiteten Klasse implementiert werden. Liefert TCPSocket::read 0 Bytes, hat die
+ * Gegenstelle ihre Senderichtung beendet und die Verbindung sollte mit
+ * TCPServer::Connection::close geschlossen werden. Noch nicht gesendete Antworten können
+ * dabei weiterhin über TCPServer::onWritable geschrieben werden.
+ */
+
+/*!\brief Daten schreiben
+ *
+ * \desc
+ * Wird aufgerufen, wenn mit TCPServer::Connection::watchWritable auf Beschreibbarkeit gewartet
+ * wird und Daten geschrieben werden können. Die Standardimplementierung beendet das Warten.
+ */
+void TCPServer::onWritable(Connection& conn)
+{
+    conn.watchWritable(false);
+}
+
+/*!\brief Verbindung wurde beendet
+ *
+ * \desc
+ * Wird aufgerufen, bevor eine Verbindung geschlossen und gelöscht wird. Hier können
+ * beispielsweise die mit TCPServer::Connection::setUserData angehängten Daten freigegeben
+ * werden.
+ */
+void TCPServer::onDisconnect(Connection&)
+{
+
+}
+
+/*!\brief Alle wartenden Verbindungen annehmen
+ */
+void TCPServer::acceptConnections()
+{
+    struct sockaddr_storage cliAddr;
+    while (1) {
+        socklen_t cliLen = sizeof(cliAddr);
+        int newSd = ::accept(listenfd, (struct sockaddr*)&cliAddr, &cliLen);
+        if (newSd < 0) {
+            if (errno == EINTR) continue;
+            return; // EAGAIN: keine weiteren Verbindungen
+        }
+        char hostname[1024];
+        char servname[32];
+        if (getnameinfo((const sockaddr*)&cliAddr, cliLen, hostname, 1023, servname, 31, NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+            close(newSd);
+            continue;
+        }
+        Connection* conn = new Connection();
+        conn->socket = malloc(sizeof(PPLSOCKET));
+        if (conn->socket == NULL) {
+            close(newSd);
+            delete conn;
+            throw OutOfMemoryException();
+        }
+        conn->connected = true;
+        PPLSOCKET* ns = (PPLSOCKET*)conn->socket;
+        ns->proto = 6;
+        ns->sd = newSd;
+        ns->ipname = strdup(hostname);
+        ns->port = atoi(servname);
+        conn->peerhost.set(hostname);
+        conn->peerport = ns->port;
+        try {
+            conn->setBlocking(false);
+            if (!onConnect(*conn)) {
+                delete conn;
+                continue;
+            }
+        } catch (...) {
+            delete conn;
+            continue;
+        }
+        mutex.lock();
+        if (sslcontext) conn->handshake = true;
+        connections.insert(std::pair<int, Connection*>(newSd, conn));
+        mutex.unlock();
+        try {
+            loop.add(newSd, EventLoop::EVENT_READ, this);
+        } catch (...) {
+            mutex.lock();
+            connections.erase(newSd);
+            mutex.unlock();
+            delete conn;
+        }
+    }
+}
+
+/*!\brief Ereignis auf einer Verbindung bearbeiten
+ *
+ * @return Ereignisse, auf die als nächstes gewartet werden soll, oder 0, wenn die Verbindung
+ * geschlossen werden soll
+ */
+int TCPServer::handleConnection(Connection* conn, int events)
+{
+    if (conn->handshake && (events & (EventLoop::EVENT_HANGUP | EventLoop::EVENT_ERROR))) return 0;
+    try {
+        if (conn->handshake) {
+            if (!conn->sslTryAccept(*sslcontext)) {
+#ifdef HAVE_OPENSSL
+                // OpenSSL muss je nach Stand des Handshakes lesen oder schreiben
+                if (conn->ssl != NULL && SSL_want_write((SSL*)conn->ssl)) return EventLoop::EVENT_WRITE;
+#endif
+                return EventLoop::EVENT_READ;
+            }
+            conn->handshake = false;
+            return EventLoop::EVENT_READ;
+        }
+        if ((events & (EventLoop::EVENT_READ | EventLoop::EVENT_HANGUP | EventLoop::EVENT_ERROR)) && !conn->closerequest) {
+            while (1) {
+                onReadable(*conn);
+                if (conn->closerequest || !conn->connected) break;
+#ifdef HAVE_OPENSSL
+                // Bereits entschlüsselte Daten meldet epoll nicht mehr
+                if (conn->ssl != NULL && SSL_pending((SSL*)conn->ssl) > 0) continue;
+#endif
+                break;
+            }
+        }
+        if ((events & EventLoop::EVENT_WRITE) && conn->connected && (conn->wantwrite || !conn->closerequest)) {
+            onWritable(*conn);
+        }
+    } catch (const OperationBlockedException&) {
+        // Keine weiteren Daten vorhanden
+    } catch (...) {
+        return 0;
+    }
+    if (events & (EventLoop::EVENT_HANGUP | EventLoop::EVENT_ERROR)) return 0;
+    if (!conn->connected) return 0;
+    if (conn->closerequest) {
+        // Ausstehende Daten werden vor dem Schließen noch gesendet
+        if (conn->wantwrite) return EventLoop::EVENT_WRITE;
+        return 0;
+    }
+    if (conn->wantwrite) return EventLoop::EVENT_READ | EventLoop::EVENT_WRITE;
+    return EventLoop::EVENT_READ;
+}
+
+int TCPServer::eventReady(int fd, int events)
+{
+    if (fd == listenfd) {
+        acceptConnections();
+        return EventLoop::EVENT_READ;
+    }
+    mutex.lock();
+    std::map<int, Connection*>::iterator it = connections.find(fd);
+    if (it == connections.end()) {
+        mutex.unlock();
+        return 0;
+    }
+    Connection* conn = it->second;
+    mutex.unlock();
+    return handleConnection(conn, events);
+}
+
+void TCPServer::eventRemoved(int fd)
+{
+    mutex.lock();
+    std::map<int, Connection*>::iterator it = connections.find(fd);
+    if (it == connections.end()) {
+        mutex.unlock();
+        return;
+    }
+    Connection* conn = it->second;
+    connections.erase(it);
+    mutex.unlock();
+    try {
+        onDisconnect(*conn);
+    } catch (...) {
+    }
+    delete conn;
+}
+
+}	// EOF namespace ppl7
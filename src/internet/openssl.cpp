@@ -1071,6 +1071,55 @@ void TCPSocket::sslWaitForAccept(SSLContext &context, int timeout_ms)
 
 
 
+/*!\brief TLS/SSL-Handshake ohne Blockieren fortsetzen
+ *
+ * \desc
+ * Im Gegensatz zu TCPSocket::sslAccept wird der Zustand des Handshakes bei einem non-blocking
+ * Socket nicht verworfen, wenn noch Daten der Gegenstelle fehlen. Die Funktion kann daher
+ * wiederholt aufgerufen werden, sobald der Socket wieder lesbar ist, bis der Handshake
+ * abgeschlossen ist. Sie wird vom TCPServer verwendet, um viele Handshakes gleichzeitig in
+ * einer EventLoop durchzuführen.
+ *
+ * @param context Der SSL-Kontext, der beim ersten Aufruf verwendet wird
+ * @return Liefert \c true zurück, wenn der Handshake abgeschlossen ist, \c false, wenn
+ * weitere Daten benötigt werden.
+ * @exception SSLException Der Handshake ist fehlgeschlagen
+ */
+bool TCPSocket::sslTryAccept(SSLContext &context)
+{
+#ifdef HAVE_OPENSSL
+	if (!isConnected()) throw NotConnectedException();
+	if (!ssl) {
+		ssl=context.newSSL();
+		sslcontext=&context;
+		PPLSOCKET* s=(PPLSOCKET*)socket;
+		if (1 != SSL_set_fd((SSL*)ssl,s->sd)) {
+			String sslerrorstack;
+			GetSSLErrors(sslerrorstack);
+			context.releaseSSL(ssl);
+			ssl=NULL;
+			throw SSLException("SSL_set_fd failed [%s]", (const char*)sslerrorstack);
+		}
+		SSL_set_accept_state((SSL*)ssl);
+	}
+	int res=SSL_accept((SSL*)ssl);
+	if (res==1) return true;
+	int e=SSL_get_error((SSL*)ssl,res);
+	if (e==SSL_ERROR_WANT_READ || e==SSL_ERROR_WANT_WRITE) return false;
+	String sslerrorstack;
+	GetSSLErrors(sslerrorstack);
+	const char *errortext=ssl_geterror((SSL*)ssl,res);
+	context.releaseSSL(ssl);
+	ssl=NULL;
+	sslcontext=NULL;
+	throw SSLException("%s, %s [%s]",errortext,
+			ERR_error_string(e,NULL),
+			(const char*)sslerrorstack);
+#else
+	throw UnsupportedFeatureException("OpenSSL");
+#endif
+}
+
 /*!\brief SSL-Zertifikat der Gegenstelle prüfen
  *
  * \desc
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "prolog_ppl7.h"
+#include "ppl7.h"
+
+namespace ppl7 {
+
+#define ADLER32_BASE 65521
+// Größte Anzahl Bytes, nach der s2 noch nicht überlaufen kann
+#define ADLER32_NMAX 5552
+
+uint32_t Adler32(uint32_t adler, const void* buffer, size_t size)
+/*!\ingroup PPLGroupMath
+ * \brief Adler-32 fortlaufend über mehrere Blöcke berechnen
+ *
+ * \desc
+ * Berechnet die Adler-32-Prüfsumme über \p size Bytes ab \p buffer und setzt dabei die
+ * Prüfsumme \p adler eines vorhergehenden Blocks fort. Beim ersten Block wird 1 übergeben.
+ * Die Modulo-Operation wird nur alle 5552 Bytes durchgeführt, dazwischen können die Summen
+ * nicht überlaufen. Das Ergebnis ist identisch mit \c adler32 aus der zlib.
+ *
+ * \param adler Prüfsumme der vorhergehenden Daten oder 1
+ * \param buffer Pointer auf den Beginn der Daten
+ * \param size Länge der Daten in Byte
+ * \return Prüfsumme über alle bisherigen Daten
+ */
+{
+	if (!buffer) return adler;
+	const unsigned char* b=(const unsigned char*)buffer;
+	uint32_t s1=adler & 0xffff;
+	uint32_t s2=(adler >> 16) & 0xffff;
+	while (size) {
+		size_t n=size < ADLER32_NMAX ? size : ADLER32_NMAX;
+		size-=n;
+		while (n >= 16) {
+			s1+=b[0]; s2+=s1; s1+=b[1]; s2+=s1; s1+=b[2]; s2+=s1; s1+=b[3]; s2+=s1;
+			s1+=b[4]; s2+=s1; s1+=b[5]; s2+=s1; s1+=b[6]; s2+=s1; s1+=b[7]; s2+=s1;
+			s1+=b[8]; s2+=s1; s1+=b[9]; s2+=s1; s1+=b[10]; s2+=s1; s1+=b[11]; s2+=s1;
+			s1+=b[12]; s2+=s1; s1+=b[13]; s2+=s1; s1+=b[14]; s2+=s1; s1+=b[15]; s2+=s1;
+			b+=16;
+			n-=16;
+		}
+		while (n--) {
+			s1+=*b++;
+			s2+=s1;
+		}
+		s1%=ADLER32_BASE;
+		s2%=ADLER32_BASE;
+	}
+	return (s2 << 16) | s1;
+}
+
+uint32_t Adler32(const void* buffer, size_t size)
+/*!\ingroup PPLGroupMath
+ * \brief Berechnet die Adler-32-Prüfsumme
+ *
+ * \param buffer Pointer auf den Beginn der Daten
+ * \param size Länge der Daten in Byte
+ * \return Prüfsumme
+ */
+{
+	return Adler32(1, buffer, size);
+}
+
+uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, uint64_t size2)
+/*!\ingroup PPLGroupMath
+ * \brief Prüfsummen zweier aufeinanderfolgender Blöcke zusammenfügen
+ *
+ * \desc
+ * Liefert die Adler-32-Prüfsumme über zwei aufeinanderfolgende Blöcke, ohne die Daten
+ * erneut lesen zu müssen.
+ *
+ * \param adler1 Prüfsumme des ersten Blocks
+ * \param adler2 Prüfsumme des zweiten Blocks
+ * \param size2 Länge des zweiten Blocks in Byte
+ * \return Prüfsumme über beide Blöcke
+ */
+{
+	uint32_t rem=(uint32_t)(size2 % ADLER32_BASE);
+	uint32_t sum1=adler1 & 0xffff;
+	uint32_t sum2=(uint32_t)(((uint64_t)rem * sum1) % ADLER32_BASE);
+	sum1+=(adler2 & 0xffff) + ADLER32_BASE - 1;
+	sum2+=((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + ADLER32_BASE - rem;
+	if (sum1 >= ADLER32_BASE) sum1-=ADLER32_BASE;
+	if (sum1 >= ADLER32_BASE) sum1-=ADLER32_BASE;
+	if (sum2 >= ((uint32_t)ADLER32_BASE << 1)) sum2-=((uint32_t)ADLER32_BASE << 1);
+	if (sum2 >= ADLER32_BASE) sum2-=ADLER32_BASE;
+	return sum1 | (sum2 << 16);
+}
+
+
+}	// EOF namespace ppl7
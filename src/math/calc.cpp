@@ -64,27 +64,28 @@ class CalcToken
 		}
 };
 
-double GetValue(const char **ptr, char *buffer)
+static double GetValue(const char **ptr, const char *end, char *buffer)
 {
 	int bptr=0;
 	const char *start=*ptr;
-	int c=*ptr[0];
+	int c=(*ptr<end) ? *ptr[0] : 0;
 	if(c=='-' || c=='+') {
 		buffer[bptr]=c;
 		(*ptr)++;
 		bptr++;
-		c=*ptr[0];
+		c=(*ptr<end) ? *ptr[0] : 0;
 	}
 	if((c<'0' || c>'9') && c!='.') {
-		throw SyntaxException("Illegal Value: %s", start);
+		throw SyntaxException("Illegal Value: %.*s", (int)(end-start), start);
 	}
 	int dotts=0;
 
-	while ((c=*ptr[0])!=0) {
+	while (*ptr<end) {
+		c=*ptr[0];
 		if (c<'0' || c>'9') {
 			if (c=='.') {
 				dotts++;
-				if (dotts>1) throw SyntaxException("Illegal Value: %s", start);
+				if (dotts>1) throw SyntaxException("Illegal Value: %.*s", (int)(end-start), start);
 			} else {
 				break;
 			}
@@ -92,7 +93,7 @@ double GetValue(const char **ptr, char *buffer)
 		buffer[bptr]=c;
 		(*ptr)++;
 		bptr++;
-		if (bptr>=CALC_BUFFERSIZE) throw SyntaxException("Value too big: %s", start);
+		if (bptr>=CALC_BUFFERSIZE) throw SyntaxException("Value too big: %.*s", (int)(end-start), start);
 	}
 	buffer[bptr]=0;
 	return atof(buffer);
@@ -152,12 +153,13 @@ static void ResolveType(std::list<CalcToken> &tokenlist, int type)
 }
 
 
-static int findClosingBracket(const char *ptr)
+static int findClosingBracket(const char *ptr, const char *end)
 {
 	int p=0;
 	int count=1;
 	int c;
-	while ((c=ptr[p])!=0) {
+	while (ptr+p<end) {
+		c=ptr[p];
 		if (c=='(') count++;
 		else if (c==')') {
 			count--;
@@ -167,31 +169,38 @@ static int findClosingBracket(const char *ptr)
 	}
 	printf ("Ups\n");
 	return p;
-	throw SyntaxException("Closing Bracket not found: %s", ptr);
+	throw SyntaxException("Closing Bracket not found: %.*s", (int)(end-ptr), ptr);
 }
 
-double Tokenize(const String &expression, char *buffer)
+/*
+ * Der Ausdruck wird nur als StringView durchlaufen, Klammerausdrücke werden als
+ * Teilbereich rekursiv ausgewertet, ohne dafür einen neuen String anzulegen.
+ */
+static double Tokenize(const StringView &expression, char *buffer)
 {
-	const char *ptr=expression.c_str();
+	const char *ptr=expression.data();
+	const char *end=ptr+expression.size();
 	std::list<CalcToken> tokenlist;
 	int c;
-	while ((c=ptr[0])!=0) {
+	while (ptr<end) {
+		c=ptr[0];
 		if (c=='(') {
-			int lastbracket=findClosingBracket(ptr+1);
-			String s=String(ptr+1,lastbracket);
+			int lastbracket=findClosingBracket(ptr+1, end);
+			StringView s(ptr+1,lastbracket);
 #ifdef DEBUG
 			printf ("DEBUG: %d\n",lastbracket);
-			printf ("s=%s\n",(const char*)s);
+			printf ("s=%.*s\n",(int)s.size(),s.data());
 #endif
 			tokenlist.push_back(CalcToken(CalcToken::TYPE_VALUE,Tokenize(s,buffer)));
 			ptr+=lastbracket+2;
 #ifdef DEBUG
-			printf ("New ptr=%s\n",ptr);
+			printf ("New ptr=%.*s\n",(int)(end-ptr),ptr);
 #endif
 		} else {
-			double v=GetValue(&ptr, buffer);
+			double v=GetValue(&ptr, end, buffer);
 			tokenlist.push_back(CalcToken(CalcToken::TYPE_VALUE,v));
 		}
+		if (ptr>=end) break;
 		c=ptr[0];
 		if (c=='+') {
 			tokenlist.push_back(CalcToken(CalcToken::TYPE_PLUS,0));
@@ -203,21 +212,21 @@ double Tokenize(const String &expression, char *buffer)
 			tokenlist.push_back(CalcToken(CalcToken::TYPE_DIVIDE,0));
 		} else if (c=='^') {
 			tokenlist.push_back(CalcToken(CalcToken::TYPE_POWER,0));
-		} else if (c=='<' && ptr[1]=='<') {
+		} else if (c=='<' && ptr+1<end && ptr[1]=='<') {
 			tokenlist.push_back(CalcToken(CalcToken::TYPE_SHIFT_LEFT,0));
 			ptr++;
-		} else if (c=='>' && ptr[1]=='>') {
+		} else if (c=='>' && ptr+1<end && ptr[1]=='>') {
 			tokenlist.push_back(CalcToken(CalcToken::TYPE_SHIFT_RIGHT,0));
 			ptr++;
 		} else if (c==0) {
 			break;
 		} else {
-			throw SyntaxException("Illegal Argument: %s", ptr);
+			throw SyntaxException("Illegal Argument: %.*s", (int)(end-ptr), ptr);
 		}
 		ptr++;
 	}
 #ifdef DEBUG
-	printf ("Expression: %s\n",(const char*)expression);
+	printf ("Expression: %.*s\n",(int)expression.size(),expression.data());
 	PrintTokenList(tokenlist);
 #endif
 	ResolveType(tokenlist,CalcToken::TYPE_SHIFT_LEFT);
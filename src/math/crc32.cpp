@@ -33,6 +33,11 @@
 #include "prolog_ppl7.h"
 #include "ppl7.h"
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PPL7_CRC32_PCLMUL
+#include <immintrin.h>
+#endif
+
 namespace ppl7 {
 
 static uint32_t crc32_table[256] = {
@@ -82,6 +87,227 @@ static uint32_t crc32_table[256] = {
 };
 
 
+#define CRC32_POLY 0xedb88320
+
+/*!\brief Tabellen für Slicing-by-16 und das Zusammenfügen von Prüfsummen
+ *
+ * \desc
+ * Tabelle 0 entspricht crc32_table, Tabelle k liefert den CRC eines Bytes, auf das noch k
+ * Null-Bytes folgen. Damit können 16 Bytes pro Schleifendurchlauf verarbeitet werden.
+ * \c x2n enthält x^(2^n) modulo Polynom für Crc32Combine.
+ */
+class Crc32Tables
+{
+public:
+	uint32_t slice[16][256];
+	uint32_t x2n[32];
+
+	Crc32Tables();
+};
+
+static uint32_t multModP(uint32_t a, uint32_t b)
+{
+	uint32_t m=(uint32_t)1 << 31;
+	uint32_t p=0;
+	while (1) {
+		if (a & m) {
+			p^=b;
+			if ((a & (m - 1)) == 0) break;
+		}
+		m>>=1;
+		b=(b & 1) ? (b >> 1) ^ CRC32_POLY : b >> 1;
+	}
+	return p;
+}
+
+Crc32Tables::Crc32Tables()
+{
+	for (int i=0;i < 256;i++) slice[0][i]=crc32_table[i];
+	for (int k=1;k < 16;k++) {
+		for (int i=0;i < 256;i++) {
+			uint32_t c=slice[k - 1][i];
+			slice[k][i]=(c >> 8) ^ slice[0][c & 0xff];
+		}
+	}
+	uint32_t p=(uint32_t)1 << 30;		// x^1
+	x2n[0]=p;
+	for (int n=1;n < 32;n++) x2n[n]=p=multModP(p, p);
+}
+
+static const Crc32Tables& crc32Tables()
+{
+	static Crc32Tables tables;
+	return tables;
+}
+
+static inline uint32_t crc32Bytewise(uint32_t crc, const unsigned char* b, size_t len)
+{
+	while (len--) crc=(crc >> 8) ^ crc32_table[(crc & 0xff) ^ *b++];
+	return crc;
+}
+
+/*!\brief CRC32 mit Slicing-by-16 berechnen
+ *
+ * \desc
+ * Verarbeitet 16 Bytes pro Durchlauf, den Rest mit Slicing-by-8 und einzeln. Die Bytes
+ * werden einzeln zusammengesetzt, daher ist die Funktion unabhängig von Endianess und
+ * Alignment. \p crc ist der interne, nicht invertierte Zustand.
+ */
+static uint32_t crc32Slicing(uint32_t crc, const unsigned char* b, size_t len)
+{
+	const Crc32Tables& t=crc32Tables();
+	while (len >= 16) {
+		uint32_t a=crc ^ ((uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24));
+		crc=t.slice[15][a & 0xff] ^ t.slice[14][(a >> 8) & 0xff]
+			^ t.slice[13][(a >> 16) & 0xff] ^ t.slice[12][a >> 24]
+			^ t.slice[11][b[4]] ^ t.slice[10][b[5]] ^ t.slice[9][b[6]] ^ t.slice[8][b[7]]
+			^ t.slice[7][b[8]] ^ t.slice[6][b[9]] ^ t.slice[5][b[10]] ^ t.slice[4][b[11]]
+			^ t.slice[3][b[12]] ^ t.slice[2][b[13]] ^ t.slice[1][b[14]] ^ t.slice[0][b[15]];
+		b+=16;
+		len-=16;
+	}
+	if (len >= 8) {
+		uint32_t a=crc ^ ((uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24));
+		crc=t.slice[7][a & 0xff] ^ t.slice[6][(a >> 8) & 0xff]
+			^ t.slice[5][(a >> 16) & 0xff] ^ t.slice[4][a >> 24]
+			^ t.slice[3][b[4]] ^ t.slice[2][b[5]] ^ t.slice[1][b[6]] ^ t.slice[0][b[7]];
+		b+=8;
+		len-=8;
+	}
+	return crc32Bytewise(crc, b, len);
+}
+
+#ifdef PPL7_CRC32_PCLMUL
+/*!\brief CRC32 mit PCLMULQDQ berechnen
+ *
+ * \desc
+ * Faltet jeweils 64 Bytes mit carry-less Multiplikation und reduziert das Ergebnis am Ende
+ * nach Barrett, wie in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+ * Instruction" von Intel beschrieben. \p len muss mindestens 64 und ein Vielfaches von 16 sein,
+ * \p crc ist der interne, nicht invertierte Zustand.
+ */
+__attribute__((target("pclmul,sse2")))
+static uint32_t crc32Pclmul(uint32_t crc, const unsigned char* buf, size_t len)
+{
+	// Konstanten für das bitweise gespiegelte Polynom
+	const __m128i k1k2=_mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+	const __m128i k3k4=_mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+	const __m128i k5k0=_mm_set_epi64x(0, 0x0163cd6124);
+	const __m128i poly=_mm_set_epi64x(0x01f7011641, 0x01db710641);
+	const __m128i mask32=_mm_setr_epi32(~0, 0, ~0, 0);
+	__m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+	x1=_mm_loadu_si128((const __m128i*)(buf + 0x00));
+	x2=_mm_loadu_si128((const __m128i*)(buf + 0x10));
+	x3=_mm_loadu_si128((const __m128i*)(buf + 0x20));
+	x4=_mm_loadu_si128((const __m128i*)(buf + 0x30));
+	x1=_mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+	buf+=64;
+	len-=64;
+
+	// Vier 128-Bit-Blöcke parallel falten
+	while (len >= 64) {
+		x5=_mm_clmulepi64_si128(x1, k1k2, 0x00);
+		x6=_mm_clmulepi64_si128(x2, k1k2, 0x00);
+		x7=_mm_clmulepi64_si128(x3, k1k2, 0x00);
+		x8=_mm_clmulepi64_si128(x4, k1k2, 0x00);
+		x1=_mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2=_mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3=_mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4=_mm_clmulepi64_si128(x4, k1k2, 0x11);
+		x1=_mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(buf + 0x00)));
+		x2=_mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(buf + 0x10)));
+		x3=_mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(buf + 0x20)));
+		x4=_mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(buf + 0x30)));
+		buf+=64;
+		len-=64;
+	}
+
+	// Auf 128 Bit zusammenfalten
+	x5=_mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1=_mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1=_mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5=_mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1=_mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1=_mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5=_mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1=_mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1=_mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	// Restliche 16-Byte-Blöcke einzeln falten
+	while (len >= 16) {
+		x2=_mm_loadu_si128((const __m128i*)buf);
+		x5=_mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1=_mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1=_mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		buf+=16;
+		len-=16;
+	}
+
+	// 128 auf 64 Bit
+	x2=_mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1=_mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x2=_mm_srli_si128(x1, 4);
+	x1=_mm_and_si128(x1, mask32);
+	x1=_mm_clmulepi64_si128(x1, k5k0, 0x00);
+	x1=_mm_xor_si128(x1, x2);
+
+	// Barrett-Reduktion auf 32 Bit
+	x2=_mm_and_si128(x1, mask32);
+	x2=_mm_clmulepi64_si128(x2, poly, 0x10);
+	x2=_mm_and_si128(x2, mask32);
+	x2=_mm_clmulepi64_si128(x2, poly, 0x00);
+	x1=_mm_xor_si128(x1, x2);
+	return (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+static uint32_t crc32Accelerated(uint32_t crc, const unsigned char* b, size_t len)
+{
+	if (len >= 64) {
+		size_t blocks=len & ~(size_t)15;
+		crc=crc32Pclmul(crc, b, blocks);
+		b+=blocks;
+		len-=blocks;
+	}
+	return crc32Slicing(crc, b, len);
+}
+#endif
+
+typedef uint32_t(*Crc32Function)(uint32_t crc, const unsigned char* buffer, size_t size);
+
+static Crc32Function selectCrc32Function()
+{
+#ifdef PPL7_CRC32_PCLMUL
+	uint32_t caps=GetCPUCaps();
+	if ((caps & CPUCAPS::CPU_HAVE_PCLMUL) && (caps & CPUCAPS::CPU_HAVE_SSE2)) return crc32Accelerated;
+#endif
+	return crc32Slicing;
+}
+
+uint32_t Crc32(uint32_t crc, const void* buffer, size_t size)
+/*!\ingroup PPLGroupMath
+ * \brief CRC32 fortlaufend über mehrere Blöcke berechnen
+ *
+ * \desc
+ * Berechnet die CRC32-Prüfsumme über \p size Bytes ab \p buffer und setzt dabei die
+ * Prüfsumme \p crc eines vorhergehenden Blocks fort. Beim ersten Block wird 0 übergeben.
+ * Damit lassen sich auch sehr große Dateien in Teilen prüfen, ohne sie vollständig in den
+ * Speicher zu laden. Das Ergebnis ist identisch mit \c crc32 aus der zlib.
+ * \par
+ * Je nach CPU wird die Prüfsumme mit PCLMULQDQ oder per Slicing-by-16 berechnet, die Auswahl
+ * erfolgt einmalig anhand von GetCPUCaps.
+ *
+ * \param crc Prüfsumme der vorhergehenden Daten oder 0
+ * \param buffer Pointer auf den Beginn der Daten
+ * \param size Länge der Daten in Byte
+ * \return Prüfsumme über alle bisherigen Daten
+ */
+{
+	static const Crc32Function crc32Function=selectCrc32Function();
+	if (!buffer || !size) return crc;
+	return crc32Function(crc ^ 0xffffffff, (const unsigned char*)buffer, size) ^ 0xffffffff;
+}
+
 uint32_t Crc32(const void* buffer, size_t size)
 /*!\ingroup PPLGroupMath
  * \brief Berechnet den polynomischen CRC32-Wert eines Strings
@@ -95,12 +321,34 @@ uint32_t Crc32(const void* buffer, size_t size)
  * \return Integer mit der Prüfsumme
  */
 {
-      uint32_t  ulCRC(0xffffffff);
-      unsigned char* b=(unsigned char*)buffer;
-	  size_t len=size;
-      while(len--)
-            ulCRC = (ulCRC >> 8) ^ crc32_table[(ulCRC & 0xFF) ^ *b++];
-      return ulCRC ^ 0xffffffff;
+	return Crc32(0, buffer, size);
+}
+
+uint32_t Crc32Combine(uint32_t crc1, uint32_t crc2, uint64_t size2)
+/*!\ingroup PPLGroupMath
+ * \brief Prüfsummen zweier aufeinanderfolgender Blöcke zusammenfügen
+ *
+ * \desc
+ * Liefert die CRC32-Prüfsumme über zwei aufeinanderfolgende Blöcke, ohne die Daten erneut
+ * lesen zu müssen. So können Teile einer Datei parallel geprüft und die Ergebnisse
+ * anschließend zusammengefasst werden.
+ *
+ * \param crc1 Prüfsumme des ersten Blocks
+ * \param crc2 Prüfsumme des zweiten Blocks
+ * \param size2 Länge des zweiten Blocks in Byte
+ * \return Prüfsumme über beide Blöcke
+ */
+{
+	const Crc32Tables& t=crc32Tables();
+	// crc1 * x^(8*size2) modulo Polynom
+	uint32_t p=(uint32_t)1 << 31;
+	unsigned int k=3;
+	while (size2) {
+		if (size2 & 1) p=multModP(t.x2n[k & 31], p);
+		size2>>=1;
+		k++;
+	}
+	return multModP(p, crc1) ^ crc2;
 }
 
 
@@ -883,7 +883,8 @@ String Array::pop()
  * Der String \p text wird anhand des Trennzeichens \p delimiter in einzelne Elemente zerlegt, die
  * wiederum an das Array angefügt werden
  *
- * @param text Zu parsender String
+ * @param text Zu parsender String. Da ein StringView übergeben wird, kann auch ein Teilstück
+ * eines größeren Puffers zerlegt werden, ohne es vorher zu kopieren.
  * @param delimiter Trennzeichen oder Trennstring
  * @param limit Maximale Anzahl Elemente, normalerweise unbegrenzt
  * @param skipemptylines Leere Elemente überspringen. Folgen zwei Trennzeichen hintereinander, würde
@@ -899,19 +900,20 @@ String Array::pop()
  * \see
  * Array::implode ist die Umkehrfunktion zu dieser
  */
-Array& Array::explode(const String& text, const String& delimiter, size_t limit, bool skipemptylines)
+Array& Array::explode(const StringView& text, const StringView& delimiter, size_t limit, bool skipemptylines)
 {
     if (text.isEmpty()) return *this;
     if (delimiter.isEmpty()) return *this;
     ssize_t p;
-    size_t t = delimiter.len();
+    size_t t = delimiter.size();
     size_t count = 0;
-    const char* del = (const char*)delimiter;
-    char* etext = (char*)text.getPtr();
-    char* _t;
+    const char* del = delimiter.data();
+    const char* etext = text.data();
+    const char* end = etext + text.size();
+    const char* _t;
     String str;
     while (1) {
-        _t = strstr(etext, del);
+        _t = MemFind(etext, end - etext, del, t);
         if (_t) {
             p = _t - etext;
             if (p == 0 && skipemptylines == true) {
@@ -927,10 +929,10 @@ Array& Array::explode(const String& text, const String& delimiter, size_t limit,
             etext = etext + p + t;
             count++;
         } else {
-            if (skipemptylines == false || strlen(etext) > 0) {
+            if (skipemptylines == false || etext < end) {
                 count++;
                 if (limit == 0 || count <= limit) {
-                    add(etext);
+                    add(etext, end - etext);
                 }
             }
             return *this;
@@ -939,6 +941,22 @@ Array& Array::explode(const String& text, const String& delimiter, size_t limit,
     return *this;
 }
 
+/*!\brief Array aus String erzeugen
+ *
+ * \desc
+ * Varianten von Array::explode mit String und C-String, die aus Kompatibilitätsgründen bzw. zur
+ * Vermeidung mehrdeutiger Aufrufe mit String-Literalen vorhanden sind.
+ */
+Array& Array::explode(const String& text, const String& delimiter, size_t limit, bool skipemptylines)
+{
+    return explode(StringView(text), StringView(delimiter), limit, skipemptylines);
+}
+
+Array& Array::explode(const char* text, const String& delimiter, size_t limit, bool skipemptylines)
+{
+    return explode(StringView(text), StringView(delimiter), limit, skipemptylines);
+}
+
 /*!\brief Array zu einem String zusammenfügen
  *
  * \desc
@@ -155,14 +155,29 @@ AssocArray::ArrayKey::ArrayKey(const String& other)
  */
 int AssocArray::ArrayKey::compare(const ArrayKey& str) const
 {
-    if (isNumeric() == true && str.isNumeric() == true) {
-        int64_t v1 = toInt64();
-        int64_t v2 = str.toInt64();
+    return compareKeys(*this, str);
+}
+
+/*!\brief Vergleich zweier Schlüssel
+ *
+ * \desc
+ * Sind beide Schlüssel nummerisch, wird ein nummerischer Vergleich durchgeführt, andernfalls
+ * ein Stringvergleich ohne Berücksichtigung der Gross-/Kleinschreibung. Die Funktion wird
+ * von ArrayKey::compare und dem transparenten Vergleich des Baums verwendet.
+ *
+ * @return Liefert -1 zurück, wenn \p a kleiner ist als \p b, 1, wenn er größer ist und 0,
+ * wenn beide identisch sind.
+ */
+int AssocArray::compareKeys(const StringView& a, const StringView& b)
+{
+    if (a.isNumeric() == true && b.isNumeric() == true) {
+        int64_t v1 = a.toInt64();
+        int64_t v2 = b.toInt64();
         if (v2 < v1) return 1;
         if (v2 > v1) return -1;
         return 0;
     }
-    int cmp = strCaseCmp(str);
+    int cmp = a.strCaseCmp(b);
     if (cmp == 0) return 0;
     if (cmp < 0) return -1;
     return 1;
@@ -223,6 +238,7 @@ bool AssocArray::ArrayKey::operator>(const ArrayKey& str) const
 AssocArray::AssocArray()
 {
     maxint = 0;
+    arena = NULL;
 }
 
 /*!\brief Copy-Konstruktor des Assoziativen Arrays
@@ -239,9 +255,41 @@ AssocArray::AssocArray()
 AssocArray::AssocArray(const AssocArray& other)
 {
     maxint = 0;
+    arena = NULL;
     add(other);
 }
 
+/*!\brief Konstruktor mit MemoryArena
+ *
+ * \desc
+ * Erzeugt ein leeres Array, dessen gesamter Inhalt aus der MemoryArena \p arena alloziert wird.
+ * Das betrifft die Knoten des Baums, die Variant-Objekte und die darin gespeicherten
+ * Werte, sowie alle verschachtelten Arrays, die über AssocArray::set oder einen
+ * verschachtelten Schlüssel angelegt werden. Der Aufbau eines großen Baums, beispielsweise
+ * durch Json::loads oder AssocArray::importBinary, besteht damit überwiegend aus
+ * Bump-Allokationen in der Arena statt aus einzelnen malloc-Aufrufen.
+ * \par
+ * Die Arena muss länger leben als das Array. Beim Löschen von Elementen werden nur die
+ * Destruktoren aufgerufen, der Speicher selbst wird erst mit MemoryArena::clear oder
+ * dem Destruktor der Arena auf einmal freigegeben. Kopien des Arrays (Copy-Konstruktor)
+ * verwenden wieder den normalen Heap.
+ *
+ * \param[in] arena Referenz auf die MemoryArena
+ *
+ * \par Beispiel:
+ * \code
+ppl7::MemoryArena arena;
+ppl7::AssocArray a(arena);
+ppl7::Json::loads(a, json);
+\endcode
+ */
+AssocArray::AssocArray(MemoryArena& arena)
+    : Tree(KeyCompare(), TreeType::allocator_type(&arena))
+{
+    maxint = 0;
+    this->arena = &arena;
+}
+
 /*!\brief Destruktor der Klasse
  *
  * \desc
@@ -265,48 +313,124 @@ void AssocArray::clear()
 {
     iterator it;
     for (it = Tree.begin(); it != Tree.end(); ++it) {
-        delete (*it).second;
+        deleteVariant((*it).second);
     }
     Tree.clear();
     maxint = 0;
 }
 
+/*!\brief Interne Funktion zum Anlegen eines Elements
+ *
+ * \desc
+ * Erzeugt einen neuen Variant mit einer Kopie von \p value. Ist dem Array eine MemoryArena
+ * zugeordnet, werden sowohl der Variant als auch sein Inhalt in der Arena angelegt,
+ * andernfalls auf dem Heap.
+ */
+template<class T> Variant* AssocArray::newVariant(const T& value, Variant::DataType type)
+{
+    if (!arena) return new Variant(value);
+    Variant* var = new (arena->malloc(sizeof(Variant))) Variant();
+    var->adopt(type, new (arena->malloc(sizeof(T))) T(value), true);
+    return var;
+}
+
+Variant* AssocArray::newVariant(const Variant& value)
+{
+    if (!arena) return new Variant(value);
+    if (value.isAssocArray()) return newAssocArray(&value.toAssocArray());
+    if (value.isString()) return newVariant(value.toString(), Variant::TYPE_STRING);
+    return new (arena->malloc(sizeof(Variant))) Variant(value);
+}
+
+/*!\brief Interne Funktion zum Anlegen eines verschachtelten Arrays
+ *
+ * \desc
+ * Erzeugt einen Variant mit einem neuen AssocArray, das die gleiche MemoryArena verwendet
+ * wie dieses Array. Ist \p value angegeben, wird dessen Inhalt hineinkopiert.
+ */
+Variant* AssocArray::newAssocArray(const AssocArray* value)
+{
+    Variant* var;
+    if (arena) {
+        var = new (arena->malloc(sizeof(Variant))) Variant();
+        var->adopt(Variant::TYPE_ASSOCARRAY, new (arena->malloc(sizeof(AssocArray))) AssocArray(*arena), true);
+    } else {
+        var = new Variant();
+        try {
+            var->adopt(Variant::TYPE_ASSOCARRAY, new AssocArray(), false);
+        }
+        catch (...) {
+            delete var;
+            throw;
+        }
+    }
+    if (value) {
+        try {
+            var->toAssocArray().add(*value);
+        }
+        catch (...) {
+            deleteVariant(var);
+            throw;
+        }
+    }
+    return var;
+}
+
+void AssocArray::deleteVariant(Variant* var) const
+{
+    if (arena)
+        var->~Variant();
+    else
+        delete var;
+}
+
+/*!\brief Zugeordnete MemoryArena
+ *
+ * \return Pointer auf die MemoryArena, aus der das Array seinen Speicher bezieht, oder NULL,
+ * wenn der normale Heap verwendet wird.
+ */
+MemoryArena* AssocArray::memoryArena() const
+{
+    return arena;
+}
+
 /*!\brief Interne Funktion zum Suchen eines Elements
  *
  * \desc
  * Diese Funktion zerlegt den angegebenen Schlüssel (\p key) in seine einzelnen Elemente.
  * Als Trennzeichen wird wie bei einer Unix-Pfadangabe der Slash (/) verwendet. Die Funktion
  * sucht zunächst nach dem erste Element des Schlüssels im eigenen Baum. Ist dies vorhanden
- * und handelt es sich bei dessen Datentyp wieder um ein AssocArray, wird deren
- * findInternal-Funktion mit dem restlichen Schlüssel rekursiv aufgerufen. Dies geschieht
- * solange, bis das letzte Element des Keys gefunden wurde.
+ * und handelt es sich bei dessen Datentyp wieder um ein AssocArray, wird die
+ * Suche mit dem nächsten Element des Schlüssels dort fortgesetzt. Dies geschieht
+ * solange, bis das letzte Element des Keys gefunden wurde. Der Schlüssel wird dabei nur
+ * als StringView durchlaufen, es werden keine temporären Strings angelegt.
  *
- * \param[in] key String mit dem gesuchten Schlüssel
+ * \param[in] key StringView mit dem gesuchten Schlüssel
  * \return Konnte der Schlüssel gefunden werden, wir der Pointer auf das Element (Variant)
  * zurückgegeben. Wurde der Schlüssel nicht gefunden, wird NULL zurückgegeben
  * \exception InvalidKeyException: Wird geworfen, wenn der Schlüssel ungültig oder leer ist
  * \note
  * Die Funktion wird von allen Get...- und Concat-Funktionen verwendet.
  */
-Variant* AssocArray::findInternal(const ArrayKey& key) const
-{
-    // printf ("AssocArray::findInternal (key=%ls)\n",(const wchar_t*)key);
-    Array tok(key, "/", 0, true);
-    if (tok.count() == 0) throw InvalidKeyException(key);
-    ArrayKey firstkey = tok.shift();
-    ArrayKey rest = tok.implode("/");
-
-    const_iterator it = Tree.find(firstkey);
-    if (it == Tree.end()) return NULL;
-    // Ist noch was im Pfad rest?
-    if (tok.count() > 0) { // Ja, koennen wir iterieren?
-        if (it->second != NULL && it->second->isAssocArray()) {
-            return it->second->toAssocArray().findInternal(rest);
-        } else {
-            return NULL;
+Variant* AssocArray::findInternal(const StringView& key) const
+{
+    StringView rest(key), segment;
+    const AssocArray* current = this;
+    Variant* node = NULL;
+    bool found = false;
+    while (rest.getToken("/", segment)) {
+        if (segment.isEmpty()) continue;
+        if (found) { // Ist noch was im Pfad rest, koennen wir iterieren?
+            if (node == NULL || !node->isAssocArray()) return NULL;
+            current = &node->toAssocArray();
         }
+        const_iterator it = current->Tree.find(segment);
+        if (it == current->Tree.end()) return NULL;
+        node = it->second;
+        found = true;
     }
-    return it->second;
+    if (!found) throw InvalidKeyException("%.*s", (int)key.size(), key.data());
+    return node;
 }
 
 /*!\brief Interne Funktion, die ein Element im Baum sucht oder anlegt
@@ -354,14 +478,15 @@ void AssocArray::createTree(const ArrayKey& key, Variant* var)
         // Ist noch was im Pfad rest?
         if (tok.count() > 0) { // Ja, koennen wir iterieren?
             if (it->second->isAssocArray() == false) {
-                delete (it->second); // Nein, wir loeschen daher diesen Zweig und machen ein Array draus
-                it->second = new Variant(ppl7::AssocArray());
+                Variant* newnode = newAssocArray();
+                deleteVariant(it->second); // Nein, wir loeschen daher diesen Zweig und machen ein Array draus
+                it->second = newnode;
             }
             it->second->toAssocArray().createTree(rest, var);
             return;
         }
         // Nein, wir haben die Zielposition gefunden
-        delete it->second;
+        deleteVariant(it->second);
         it->second = var;
         return;
     }
@@ -371,8 +496,14 @@ void AssocArray::createTree(const ArrayKey& key, Variant* var)
     // Ist noch was im Pfad rest?
     if (tok.count() > 0) { // Ja, wir erstellen ein Array und iterieren
         // printf ("Iteration\n");
-        Variant* newnode = new Variant(ppl7::AssocArray());
-        Tree.insert(std::pair<ArrayKey, Variant*>(firstkey, newnode));
+        Variant* newnode = newAssocArray();
+        try {
+            Tree.insert(std::pair<ArrayKey, Variant*>(firstkey, newnode));
+        }
+        catch (...) {
+            deleteVariant(newnode);
+            throw;
+        }
         newnode->toAssocArray().createTree(rest, var);
     } else {
         Tree.insert(std::pair<ArrayKey, Variant*>(firstkey, var));
@@ -520,24 +651,24 @@ void AssocArray::list(const String& prefix) const
  */
 void AssocArray::set(const String& key, const String& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value, Variant::TYPE_STRING);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
 
 void AssocArray::set(const String& key, const WideString& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value, Variant::TYPE_WIDESTRING);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -557,12 +688,12 @@ void AssocArray::set(const String& key, const WideString& value)
  */
 void AssocArray::set(const String& key, const String& value, size_t size)
 {
-    Variant* var = new Variant(String(value, size));
+    Variant* var = newVariant(String(value, size), Variant::TYPE_STRING);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -581,12 +712,12 @@ void AssocArray::set(const String& key, const String& value, size_t size)
  */
 void AssocArray::set(const String& key, const DateTime& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value, Variant::TYPE_DATETIME);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -605,12 +736,12 @@ void AssocArray::set(const String& key, const DateTime& value)
  */
 void AssocArray::set(const String& key, const ByteArray& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value, Variant::TYPE_BYTEARRAY);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -629,12 +760,12 @@ void AssocArray::set(const String& key, const ByteArray& value)
  */
 void AssocArray::set(const String& key, const ByteArrayPtr& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value, Variant::TYPE_BYTEARRAYPTR);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -653,12 +784,12 @@ void AssocArray::set(const String& key, const ByteArrayPtr& value)
  */
 void AssocArray::set(const String& key, const Array& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value, Variant::TYPE_ARRAY);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -677,12 +808,12 @@ void AssocArray::set(const String& key, const Array& value)
  */
 void AssocArray::set(const String& key, const AssocArray& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newAssocArray(&value);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -701,12 +832,12 @@ void AssocArray::set(const String& key, const AssocArray& value)
  */
 void AssocArray::set(const String& key, const Pointer& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(Variant(value));
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -727,12 +858,12 @@ void AssocArray::set(const String& key, const Pointer& value)
  */
 void AssocArray::set(const String& key, const Variant& value)
 {
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -756,12 +887,12 @@ void AssocArray::setf(const String& key, const char* fmt, ...)
     va_start(args, fmt);
     value.vasprintf(fmt, args);
     va_end(args);
-    Variant* var = new Variant(value);
+    Variant* var = newVariant(value, Variant::TYPE_STRING);
     try {
         createTree(key, var);
     }
     catch (...) {
-        delete var;
+        deleteVariant(var);
         throw;
     }
 }
@@ -864,10 +995,10 @@ void AssocArray::add(const AssocArray& other)
 ppl7::String &str=a.get(L"key1").toString();
 \endcode
  */
-Variant& AssocArray::get(const String& key) const
+Variant& AssocArray::get(const StringView& key) const
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
     return (*node);
 }
 
@@ -880,7 +1011,7 @@ Variant& AssocArray::get(const String& key) const
  * @return Liefert \c true zurück, wenn der Schlüssel vorhanden ist, sonst \c false
  * \exception InvalidKeyException: Ungültiger Schlüssel
  */
-bool AssocArray::exists(const String& key) const
+bool AssocArray::exists(const StringView& key) const
 {
     if (findInternal(key)) return true;
     return false;
@@ -897,15 +1028,15 @@ bool AssocArray::exists(const String& key) const
  * \exception InvalidKeyException: Ungültiger Schlüssel
  * \exception KeyNotFoundException: Schlüssel wurde nicht gefunden
  */
-String& AssocArray::getString(const String& key) const
+String& AssocArray::getString(const StringView& key) const
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
-    if (!node->isString()) throw TypeConversionException("%s is not a String", (const char*)key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (!node->isString()) throw TypeConversionException("%.*s is not a String", (int)key.size(), key.data());
     return node->toString();
 }
 
-String& AssocArray::getString(const String& key, String& default_value) const
+String& AssocArray::getString(const StringView& key, String& default_value) const
 {
     Variant* node = findInternal(key);
     if (!node) return default_value;
@@ -913,7 +1044,7 @@ String& AssocArray::getString(const String& key, String& default_value) const
     return default_value;
 }
 
-const String& AssocArray::getString(const String& key, const String& default_value) const
+const String& AssocArray::getString(const StringView& key, const String& default_value) const
 {
     Variant* node = findInternal(key);
     if (!node) return default_value;
@@ -921,7 +1052,7 @@ const String& AssocArray::getString(const String& key, const String& default_val
     return default_value;
 }
 
-bool AssocArray::getBoolean(const String& key, bool default_value) const
+bool AssocArray::getBoolean(const StringView& key, bool default_value) const
 {
     Variant* node = findInternal(key);
     if (!node) return default_value;
@@ -930,16 +1061,16 @@ bool AssocArray::getBoolean(const String& key, bool default_value) const
     return default_value;
 }
 
-int AssocArray::getInt(const String& key) const
+int AssocArray::getInt(const StringView& key) const
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
     if (node->isString()) return node->toString().toInt();
     if (node->isWideString()) return node->toWideString().toInt();
-    throw TypeConversionException("%s cannot be converted to Int", (const char*)key);
+    throw TypeConversionException("%.*s cannot be converted to Int", (int)key.size(), key.data());
 }
 
-int AssocArray::getInt(const String& key, int default_value) const
+int AssocArray::getInt(const StringView& key, int default_value) const
 {
     Variant* node = findInternal(key);
     if (!node) return default_value;
@@ -948,16 +1079,16 @@ int AssocArray::getInt(const String& key, int default_value) const
     return default_value;
 }
 
-long long AssocArray::getLongLong(const String& key) const
+long long AssocArray::getLongLong(const StringView& key) const
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
     if (node->isString()) return node->toString().toLongLong();
     if (node->isWideString()) return node->toWideString().toLongLong();
-    throw TypeConversionException("%s cannot be converted to long long int", (const char*)key);
+    throw TypeConversionException("%.*s cannot be converted to long long int", (int)key.size(), key.data());
 }
 
-long long AssocArray::getLongLong(const String& key, long long default_value) const
+long long AssocArray::getLongLong(const StringView& key, long long default_value) const
 {
     Variant* node = findInternal(key);
     if (!node) return default_value;
@@ -976,7 +1107,7 @@ long long AssocArray::getLongLong(const String& key, long long default_value) co
  * @param key Name des Schlüssels
  * @return True oder False
  */
-bool AssocArray::isTrue(const String& key) const
+bool AssocArray::isTrue(const StringView& key) const
 {
     Variant* node = findInternal(key);
     if (!node) return false;
@@ -994,15 +1125,15 @@ bool AssocArray::isTrue(const String& key) const
  * \exception InvalidKeyException: Ungültiger Schlüssel
  * \exception KeyNotFoundException: Schlüssel wurde nicht gefunden
  */
-AssocArray& AssocArray::getAssocArray(const String& key) const
+AssocArray& AssocArray::getAssocArray(const StringView& key) const
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
-    if (!node->isAssocArray()) throw TypeConversionException("%s is not an AssocArray", (const char*)key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (!node->isAssocArray()) throw TypeConversionException("%.*s is not an AssocArray", (int)key.size(), key.data());
     return node->toAssocArray();
 }
 
-AssocArray& AssocArray::getAssocArray(const String& key, AssocArray& default_value) const
+AssocArray& AssocArray::getAssocArray(const StringView& key, AssocArray& default_value) const
 {
     Variant* node = findInternal(key);
     if (!node) return default_value;
@@ -1010,15 +1141,15 @@ AssocArray& AssocArray::getAssocArray(const String& key, AssocArray& default_val
     return default_value;
 }
 
-Array& AssocArray::getArray(const String& key) const
+Array& AssocArray::getArray(const StringView& key) const
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
-    if (!node->isArray()) throw TypeConversionException("%s is not an Array", (const char*)key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (!node->isArray()) throw TypeConversionException("%.*s is not an Array", (int)key.size(), key.data());
     return node->toArray();
 }
 
-Array& AssocArray::getArray(const String& key, Array& default_value) const
+Array& AssocArray::getArray(const StringView& key, Array& default_value) const
 {
     Variant* node = findInternal(key);
     if (!node) return default_value;
@@ -1026,6 +1157,164 @@ Array& AssocArray::getArray(const String& key, Array& default_value) const
     return default_value;
 }
 
+/*!\brief Lesefunktionen mit String oder C-String als Schlüssel
+ *
+ * \desc
+ * Die Lesefunktionen gibt es jeweils auch mit einem String und einem C-String als Schlüssel.
+ * Die String-Varianten bleiben aus Kompatibilitätsgründen erhalten, die C-String-Varianten
+ * vermeiden, dass ein Aufruf mit einem String-Literal mehrdeutig ist. Beide rufen die
+ * jeweilige Funktion mit StringView auf.
+ */
+Variant& AssocArray::get(const String& key) const
+{
+    return get(StringView(key));
+}
+
+Variant& AssocArray::get(const char* key) const
+{
+    return get(StringView(key));
+}
+
+String& AssocArray::getString(const String& key) const
+{
+    return getString(StringView(key));
+}
+
+String& AssocArray::getString(const char* key) const
+{
+    return getString(StringView(key));
+}
+
+String& AssocArray::getString(const String& key, String& default_value) const
+{
+    return getString(StringView(key), default_value);
+}
+
+String& AssocArray::getString(const char* key, String& default_value) const
+{
+    return getString(StringView(key), default_value);
+}
+
+const String& AssocArray::getString(const String& key, const String& default_value) const
+{
+    return getString(StringView(key), default_value);
+}
+
+const String& AssocArray::getString(const char* key, const String& default_value) const
+{
+    return getString(StringView(key), default_value);
+}
+
+int AssocArray::getInt(const String& key) const
+{
+    return getInt(StringView(key));
+}
+
+int AssocArray::getInt(const char* key) const
+{
+    return getInt(StringView(key));
+}
+
+int AssocArray::getInt(const String& key, int default_value) const
+{
+    return getInt(StringView(key), default_value);
+}
+
+int AssocArray::getInt(const char* key, int default_value) const
+{
+    return getInt(StringView(key), default_value);
+}
+
+long long AssocArray::getLongLong(const String& key) const
+{
+    return getLongLong(StringView(key));
+}
+
+long long AssocArray::getLongLong(const char* key) const
+{
+    return getLongLong(StringView(key));
+}
+
+long long AssocArray::getLongLong(const String& key, long long default_value) const
+{
+    return getLongLong(StringView(key), default_value);
+}
+
+long long AssocArray::getLongLong(const char* key, long long default_value) const
+{
+    return getLongLong(StringView(key), default_value);
+}
+
+AssocArray& AssocArray::getAssocArray(const String& key) const
+{
+    return getAssocArray(StringView(key));
+}
+
+AssocArray& AssocArray::getAssocArray(const char* key) const
+{
+    return getAssocArray(StringView(key));
+}
+
+AssocArray& AssocArray::getAssocArray(const String& key, AssocArray& default_value) const
+{
+    return getAssocArray(StringView(key), default_value);
+}
+
+AssocArray& AssocArray::getAssocArray(const char* key, AssocArray& default_value) const
+{
+    return getAssocArray(StringView(key), default_value);
+}
+
+Array& AssocArray::getArray(const String& key) const
+{
+    return getArray(StringView(key));
+}
+
+Array& AssocArray::getArray(const char* key) const
+{
+    return getArray(StringView(key));
+}
+
+Array& AssocArray::getArray(const String& key, Array& default_value) const
+{
+    return getArray(StringView(key), default_value);
+}
+
+Array& AssocArray::getArray(const char* key, Array& default_value) const
+{
+    return getArray(StringView(key), default_value);
+}
+
+bool AssocArray::getBoolean(const String& key, bool default_value) const
+{
+    return getBoolean(StringView(key), default_value);
+}
+
+bool AssocArray::getBoolean(const char* key, bool default_value) const
+{
+    return getBoolean(StringView(key), default_value);
+}
+
+bool AssocArray::exists(const String& key) const
+{
+    return exists(StringView(key));
+}
+
+bool AssocArray::exists(const char* key) const
+{
+    return exists(StringView(key));
+}
+
+bool AssocArray::isTrue(const String& key) const
+{
+    return isTrue(StringView(key));
+}
+
+bool AssocArray::isTrue(const char* key) const
+{
+    return isTrue(StringView(key));
+}
+
 /*!\brief Einzelnen Schlüssel löschen
  *
  * \desc
@@ -1051,7 +1340,9 @@ void AssocArray::erase(const String& key)
             return;
         }
     }
+    Variant* var = it->second;
     Tree.erase(it);
+    deleteVariant(var);
 }
 
 /*!\brief Einzelnen Schlüssel löschen
@@ -1639,6 +1930,8 @@ void AssocArray::exportBinary(void* buffer, size_t buffersize, size_t* realsize)
         if (p < buffersize) {
             if (a->isByteArrayPtr())
                 PokeN8(ptr + p, Variant::TYPE_BYTEARRAY);
+            else if (a->isHashAssocArray())
+                PokeN8(ptr + p, Variant::TYPE_ASSOCARRAY);
             else
                 PokeN8(ptr + p, a->type());
         }
@@ -1680,6 +1973,13 @@ void AssocArray::exportBinary(void* buffer, size_t buffersize, size_t* realsize)
             else
                 a->toAssocArray().exportBinary(ptr + p, buffersize - p, &asize);
             p += asize;
+        } else if (a->isHashAssocArray()) {
+            size_t asize = 0;
+            if (!buffer)
+                a->toHashAssocArray().exportBinary(NULL, 0, &asize);
+            else
+                a->toHashAssocArray().exportBinary(ptr + p, buffersize - p, &asize);
+            p += asize;
         } else if (a->isArray()) {
             ppl7::Array aaa(a->toArray());
             if (p + 4 < buffersize) PokeN32(ptr + p, (int)aaa.size());
@@ -1699,7 +1999,7 @@ void AssocArray::exportBinary(void* buffer, size_t buffersize, size_t* realsize)
             if (p + vallen < buffersize) PokeN64(ptr + p, a->toDateTime().longInt());
             p += vallen;
         } else if (a->isByteArray() == true || a->isByteArrayPtr() == true) {
-            vallen = a->toByteArray().size();
+            vallen = a->toByteArrayPtr().size();
             if (p + 4 < buffersize) PokeN32(ptr + p, (int)vallen);
             p += 4;
             if (p + vallen < buffersize) memcpy(ptr + p, a->toByteArrayPtr().adr(), vallen);
@@ -1794,10 +2094,9 @@ size_t AssocArray::importBinary(const void* buffer, size_t buffersize)
     }
     p += 7;
     int type;
-    size_t vallen, bytes;
+    size_t vallen;
     String key, str;
     DateTime dt;
-    AssocArray na;
     ByteArray nb;
     WideString ws;
 #ifdef HAVE_ICONV
@@ -1813,7 +2112,7 @@ size_t AssocArray::importBinary(const void* buffer, size_t buffersize)
         case Variant::TYPE_STRING:
             vallen = PeekN32(ptr + p);
             p += 4;
-            set(key, (const char*)ptr + p, vallen);
+            set(key, String((const char*)ptr + p, vallen));
             p += vallen;
             break;
         case Variant::TYPE_WIDESTRING:
@@ -1828,12 +2127,18 @@ size_t AssocArray::importBinary(const void* buffer, size_t buffersize)
             set(key, ws);
             p += vallen;
             break;
-        case Variant::TYPE_ASSOCARRAY:
-            na.clear();
-            bytes = na.importBinary(ptr + p, buffersize - p);
-            p += bytes;
-            set(key, na);
-            break;
+        case Variant::TYPE_ASSOCARRAY: {
+            // Direkt in das neue Unterarray importieren, statt es anschließend zu kopieren
+            Variant* var = newAssocArray();
+            try {
+                p += var->toAssocArray().importBinary(ptr + p, buffersize - p);
+                createTree(key, var);
+            }
+            catch (...) {
+                deleteVariant(var);
+                throw;
+            }
+        } break;
         case Variant::TYPE_ARRAY: {
             size_t elements = PeekN32(ptr + p);
             p += 4;
@@ -1881,20 +2186,40 @@ size_t AssocArray::importBinary(const void* buffer, size_t buffersize)
  * \exception InvalidKeyException: Ungültiger Schlüssel
  * \exception KeyNotFoundException: Schlüssel wurde nicht gefunden
  */
-const Variant& AssocArray::operator[](const String& key) const
+const Variant& AssocArray::operator[](const StringView& key) const
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
     return *node;
 }
 
-Variant& AssocArray::operator[](const String& key)
+Variant& AssocArray::operator[](const StringView& key)
 {
     Variant* node = findInternal(key);
-    if (!node) throw KeyNotFoundException(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
     return *node;
 }
 
+const Variant& AssocArray::operator[](const String& key) const
+{
+    return (*this)[StringView(key)];
+}
+
+const Variant& AssocArray::operator[](const char* key) const
+{
+    return (*this)[StringView(key)];
+}
+
+Variant& AssocArray::operator[](const String& key)
+{
+    return (*this)[StringView(key)];
+}
+
+Variant& AssocArray::operator[](const char* key)
+{
+    return (*this)[StringView(key)];
+}
+
 /*!\brief Assoziatives Array kopieren
  *
  * \desc
@@ -0,0 +1,707 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "ppl7.h"
+
+
+namespace ppl7
+{
+
+/*!\class AssocArrayView
+ * \ingroup PPLGroupDataTypes
+ * \brief Lesender Zugriff auf ein exportiertes AssocArray ohne Import
+ *
+ * \desc
+ * Die Klasse AssocArrayView arbeitet direkt auf einem Puffer, der mit AssocArray::exportBinary
+ * oder HashAssocArray::exportBinary erzeugt wurde, beispielsweise der Payload einer SocketMessage.
+ * Im Gegensatz zu AssocArray::importBinary werden dabei keine Schlüssel, Variants oder Unterarrays
+ * angelegt. Erst beim Zugriff auf einen Schlüssel wird der Puffer an der betreffenden Stelle
+ * durchsucht, Unterarrays werden nur betreten, wenn der Pfad des Schlüssels dies verlangt.
+ * Anwendungen, die von tausenden Schlüsseln nur wenige benötigen, bezahlen daher nur für diese.
+ * \par
+ * Die Semantik der Schlüssel ist identisch mit AssocArray: Gross-/Kleinschreibung wird ignoriert,
+ * rein nummerische Schlüssel werden nummerisch verglichen und der Slash (/) trennt die Ebenen.
+ * Die Suche innerhalb einer Ebene erfolgt linear.
+ * \par
+ * AssocArrayView::Element::keyPtr, AssocArrayView::Element::value und AssocArrayView::getByteArrayPtr
+ * liefern Zeiger in den Puffer, ohne die Daten zu kopieren. Alle übrigen Funktionen liefern Kopien.
+ *
+ * \attention
+ * Die Klasse kopiert den Puffer nicht. Er muss so lange gültig und unverändert bleiben, wie
+ * die AssocArrayView, davon abgeleitete Views oder Elemente verwendet werden.
+ * \par
+ * Alle Längenangaben im Puffer werden gegen das Ende des Puffers geprüft. Ist der Puffer
+ * beschädigt, wird beim Zugriff eine AssocArrayView::ImportFailedException geworfen.
+ *
+ * \par Beispiel:
+ * \code
+ppl7::SocketMessage msg;
+...
+ppl7::AssocArrayView view;
+msg.getPayload(view);
+ppl7::String method=view.getString("request/method");
+int port=view.getInt("server/port",80);
+\endcode
+ */
+
+static inline bool isNumericKey(const char* key, size_t len)
+{
+    if (!len) return false;
+    size_t dotcount = 0;
+    for (size_t i = 0; i < len; i++) {
+        int c = key[i];
+        if (c < '0' || c > '9') {
+            if (c != '.' && c != ',' && c != '-') return false;
+            if (c == '-' && i > 0) return false;
+            if (c == '.' || c == ',') {
+                dotcount++;
+                if (dotcount > 1) return false;
+            }
+        }
+    }
+    if (key[len - 1] == '.') return false;
+    return true;
+}
+
+/*!\brief Ganzzahl aus einem nicht terminierten Speicherbereich lesen
+ *
+ * \desc
+ * Verhält sich wie strtoll, liest aber höchstens \p len Bytes.
+ */
+static long long parseInteger(const char* str, size_t len)
+{
+    char buffer[64];
+    if (!len) return 0;
+    if (len >= sizeof(buffer)) return String(str, len).toLongLong();
+    memcpy(buffer, str, len);
+    buffer[len] = 0;
+    return strtoll(buffer, NULL, 10);
+}
+
+static inline char lowerAscii(char c)
+{
+    if (c >= 'A' && c <= 'Z') return (char)(c + 32);
+    return c;
+}
+
+static inline bool equalsIgnoreCase(const char* s1, const char* s2, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (lowerAscii(s1[i]) != lowerAscii(s2[i])) return false;
+    }
+    return true;
+}
+
+static inline bool nextSegment(const char* key, size_t len, size_t& start, size_t& end)
+{
+    while (start < len && key[start] == '/') start++;
+    if (start >= len) return false;
+    end = start;
+    while (end < len && key[end] != '/') end++;
+    return true;
+}
+
+
+AssocArrayView::Element::Element()
+{
+    keyptr = NULL;
+    keylen = 0;
+    valueptr = NULL;
+    valuesize = 0;
+    limit = NULL;
+    datatype = Variant::TYPE_UNKNOWN;
+}
+
+/*!\brief Datentyp des Elements
+ *
+ * \return Datentyp gemäß Variant::DataType. Nicht exportierbare Datentypen werden mit ihrem
+ * ursprünglichen Typ, aber ohne Daten geliefert.
+ */
+int AssocArrayView::Element::type() const
+{
+    return datatype;
+}
+
+bool AssocArrayView::Element::isString() const
+{
+    return datatype == Variant::TYPE_STRING;
+}
+
+bool AssocArrayView::Element::isWideString() const
+{
+    return datatype == Variant::TYPE_WIDESTRING;
+}
+
+bool AssocArrayView::Element::isArray() const
+{
+    return datatype == Variant::TYPE_ARRAY;
+}
+
+bool AssocArrayView::Element::isAssocArray() const
+{
+    return datatype == Variant::TYPE_ASSOCARRAY;
+}
+
+bool AssocArrayView::Element::isByteArray() const
+{
+    return datatype == Variant::TYPE_BYTEARRAY;
+}
+
+bool AssocArrayView::Element::isDateTime() const
+{
+    return datatype == Variant::TYPE_DATETIME;
+}
+
+/*!\brief Kopie des Schlüssels
+ */
+String AssocArrayView::Element::key() const
+{
+    return String(keyptr, keylen);
+}
+
+/*!\brief Schlüssel ohne Kopie
+ *
+ * \return ByteArrayPtr, der direkt in den Puffer zeigt. Der Schlüssel ist nicht nullterminiert.
+ */
+ByteArrayPtr AssocArrayView::Element::keyPtr() const
+{
+    return ByteArrayPtr(keyptr, keylen);
+}
+
+/*!\brief Rohdaten des Elements ohne Kopie
+ *
+ * \desc
+ * Liefert einen ByteArrayPtr auf die Daten des Elements im Puffer. Bei Strings und ByteArrays
+ * sind das die eigentlichen Nutzdaten (Strings und WideStrings in UTF-8, ohne abschließendes
+ * 0-Byte), bei verschachtelten Arrays der komplette Export des Unterarrays und bei
+ * Arrays die Anzahl Elemente gefolgt von den einzelnen Strings.
+ */
+ByteArrayPtr AssocArrayView::Element::value() const
+{
+    return ByteArrayPtr(valueptr, valuesize);
+}
+
+/*!\brief Wert als String
+ *
+ * \exception TypeConversionException: Das Element ist kein String oder WideString
+ */
+String AssocArrayView::Element::toString() const
+{
+    if (datatype != Variant::TYPE_STRING && datatype != Variant::TYPE_WIDESTRING)
+        throw TypeConversionException("%s is not a String", (const char*)key());
+    return String(valueptr, valuesize);
+}
+
+/*!\brief Wert als Integer
+ *
+ * \desc
+ * Wandelt einen String oder WideString ohne temporäre Kopie auf dem Heap in einen Integer um.
+ * \exception TypeConversionException: Das Element ist kein String oder WideString
+ */
+int AssocArrayView::Element::toInt() const
+{
+    return (int)toLongLong();
+}
+
+long long AssocArrayView::Element::toLongLong() const
+{
+    if (datatype != Variant::TYPE_STRING && datatype != Variant::TYPE_WIDESTRING)
+        throw TypeConversionException("%s cannot be converted to long long int", (const char*)key());
+    return parseInteger(valueptr, valuesize);
+}
+
+/*!\brief Kopie eines Arrays
+ *
+ * \exception TypeConversionException: Das Element ist kein Array
+ */
+Array AssocArrayView::Element::toArray() const
+{
+    if (datatype != Variant::TYPE_ARRAY) throw TypeConversionException("%s is not an Array", (const char*)key());
+    Array a;
+    size_t elements = PeekN32(valueptr);
+    const char* p = valueptr + 4;
+    a.reserve(elements);
+    for (size_t i = 0; i < elements; i++) {
+        size_t len = PeekN32(p);
+        a.add(p + 4, len);
+        p += len + 4;
+    }
+    return a;
+}
+
+/*!\brief Wert als DateTime
+ *
+ * \exception TypeConversionException: Das Element ist kein DateTime
+ */
+DateTime AssocArrayView::Element::toDateTime() const
+{
+    if (datatype != Variant::TYPE_DATETIME || valuesize != 8)
+        throw TypeConversionException("%s is not a DateTime", (const char*)key());
+    DateTime dt;
+    dt.setLongInt(PeekN64(valueptr));
+    return dt;
+}
+
+/*!\brief View auf ein verschachteltes Array
+ *
+ * \exception TypeConversionException: Das Element ist kein AssocArray
+ */
+AssocArrayView AssocArrayView::Element::toAssocArrayView() const
+{
+    if (datatype != Variant::TYPE_ASSOCARRAY) throw TypeConversionException("%s is not an AssocArray", (const char*)key());
+    return AssocArrayView(valueptr, valuesize);
+}
+
+
+AssocArrayView::const_iterator::const_iterator()
+{
+    next = NULL;
+    limit = NULL;
+}
+
+AssocArrayView::const_iterator::const_iterator(const char* ptr, const char* limit)
+{
+    this->limit = limit;
+    next = parseElement(ptr, limit, e);
+}
+
+AssocArrayView::const_iterator& AssocArrayView::const_iterator::operator++()
+{
+    if (next) next = parseElement(next, limit, e);
+    if (!next) e = Element();
+    return *this;
+}
+
+
+/*!\brief Interne Funktion zum Einlesen eines Elements
+ *
+ * \desc
+ * Liest das Element an Position \p ptr aus und prüft dabei alle Längenangaben gegen \p limit.
+ *
+ * \return Position des nachfolgenden Elements oder NULL, wenn das Ende der Ebene erreicht ist.
+ * In diesem Fall bleibt \p e unverändert.
+ * \exception ImportFailedException: Der Puffer ist beschädigt oder unvollständig
+ */
+const char* AssocArrayView::parseElement(const char* ptr, const char* limit, Element& e)
+{
+    if (ptr >= limit) return NULL;
+    int type = PeekN8(ptr);
+    if (type == 0) return NULL;
+    if (limit - ptr < 3) throw ImportFailedException("AssocArray binary truncated");
+    size_t keylen = PeekN16(ptr + 1);
+    const char* key = ptr + 3;
+    if ((size_t)(limit - key) < keylen) throw ImportFailedException("AssocArray binary truncated");
+    const char* v = key + keylen;
+    const char* next;
+    if (type == Variant::TYPE_ASSOCARRAY) {
+        next = skipAssocArray(v, limit);
+    } else if (type == Variant::TYPE_ARRAY) {
+        if (limit - v < 4) throw ImportFailedException("AssocArray binary truncated");
+        size_t elements = PeekN32(v);
+        next = v + 4;
+        for (size_t i = 0; i < elements; i++) {
+            if (limit - next < 4) throw ImportFailedException("AssocArray binary truncated");
+            size_t len = PeekN32(next);
+            next += 4;
+            if ((size_t)(limit - next) < len) throw ImportFailedException("AssocArray binary truncated");
+            next += len;
+        }
+    } else {
+        if (limit - v < 4) throw ImportFailedException("AssocArray binary truncated");
+        size_t len = PeekN32(v);
+        v += 4;
+        if ((size_t)(limit - v) < len) throw ImportFailedException("AssocArray binary truncated");
+        next = v + len;
+    }
+    e.keyptr = key;
+    e.keylen = keylen;
+    e.valueptr = v;
+    e.valuesize = next - v;
+    e.limit = limit;
+    e.datatype = type;
+    return next;
+}
+
+/*!\brief Interne Funktion zum Überspringen eines verschachtelten Arrays
+ *
+ * \return Position direkt hinter dem Export des Arrays, der bei \p ptr beginnt
+ * \exception ImportFailedException: Der Puffer ist beschädigt oder unvollständig
+ */
+const char* AssocArrayView::skipAssocArray(const char* ptr, const char* limit)
+{
+    if (limit - ptr < 7 || strncmp(ptr, "PPLASOC", 7) != 0) {
+        throw ImportFailedException("Not an AssocArray binary export");
+    }
+    const char* p = ptr + 7;
+    const char* next;
+    Element e;
+    while ((next = parseElement(p, limit, e))) p = next;
+    if (p < limit) p++;
+    return p;
+}
+
+/*!\brief Konstruktor
+ *
+ * \desc
+ * Erzeugt eine leere View.
+ */
+AssocArrayView::AssocArrayView()
+{
+    buffer = NULL;
+    limit = NULL;
+}
+
+/*!\brief Konstruktor mit Puffer
+ *
+ * \param[in] buffer Pointer auf den Beginn eines Exports von AssocArray::exportBinary
+ * \param[in] buffersize Größe des Puffers
+ * \exception IllegalArgumentException: \p buffer ist NULL oder \p buffersize 0
+ * \exception ImportFailedException: Der Puffer enthält keinen Export eines AssocArrays
+ */
+AssocArrayView::AssocArrayView(const void* buffer, size_t buffersize)
+{
+    set(buffer, buffersize);
+}
+
+AssocArrayView::AssocArrayView(const ByteArrayPtr& bin)
+{
+    set(bin.adr(), bin.size());
+}
+
+/*!\brief Puffer setzen
+ *
+ * \desc
+ * Lässt die View auf einen neuen Puffer zeigen. Geprüft wird dabei nur die Kennung am Anfang
+ * des Puffers, der Inhalt wird erst bei Zugriffen gelesen.
+ *
+ * \param[in] buffer Pointer auf den Beginn eines Exports von AssocArray::exportBinary
+ * \param[in] buffersize Größe des Puffers
+ * \exception IllegalArgumentException: \p buffer ist NULL oder \p buffersize 0
+ * \exception ImportFailedException: Der Puffer enthält keinen Export eines AssocArrays
+ */
+void AssocArrayView::set(const void* buffer, size_t buffersize)
+{
+    if (!buffer) throw IllegalArgumentException();
+    if (buffersize == 0) throw IllegalArgumentException();
+    if (buffersize < 8 || strncmp((const char*)buffer, "PPLASOC", 7) != 0) {
+        throw ImportFailedException("Not an AssocArray binary export");
+    }
+    this->buffer = (const char*)buffer;
+    limit = this->buffer + buffersize;
+}
+
+void AssocArrayView::set(const ByteArrayPtr& bin)
+{
+    set(bin.adr(), bin.size());
+}
+
+/*!\brief View zurücksetzen
+ */
+void AssocArrayView::clear()
+{
+    buffer = NULL;
+    limit = NULL;
+}
+
+/*!\brief Prüfen, ob die View Elemente enthält
+ */
+bool AssocArrayView::empty() const
+{
+    Element e;
+    if (!buffer) return true;
+    return parseElement(buffer + 7, limit, e) == NULL;
+}
+
+/*!\brief Anzahl Schlüssel auf der obersten Ebene
+ *
+ * \desc
+ * Die Elemente werden dafür einmal durchlaufen.
+ */
+size_t AssocArrayView::count() const
+{
+    size_t c = 0;
+    for (const_iterator it = begin(); it != end(); ++it) c++;
+    return c;
+}
+
+/*!\brief Größe des Exports
+ *
+ * \return Anzahl Bytes, die der Export im Puffer belegt. Das kann weniger sein, als beim
+ * Konstruktor angegeben wurde.
+ */
+size_t AssocArrayView::binarySize() const
+{
+    if (!buffer) return 0;
+    return skipAssocArray(buffer, limit) - buffer;
+}
+
+/*!\brief Export ohne Kopie
+ *
+ * \return ByteArrayPtr auf den Teil des Puffers, der zu diesem Array gehört
+ */
+ByteArrayPtr AssocArrayView::binary() const
+{
+    return ByteArrayPtr(buffer, binarySize());
+}
+
+/*!\brief Interne Funktion zum Suchen eines Schlüssels
+ *
+ * \desc
+ * Sucht den Schlüssel \p key Ebene für Ebene im Puffer, ohne temporäre Strings anzulegen.
+ *
+ * \return Liefert \c true und das gefundene Element in \p e zurück, oder \c false, wenn
+ * der Schlüssel nicht vorhanden ist
+ * \exception InvalidKeyException: Der Schlüssel ist leer
+ */
+bool AssocArrayView::findInternal(const StringView& key, Element& e) const
+{
+    const char* k = key.data();
+    size_t len = key.size();
+    size_t start = 0, end = 0;
+    if (!nextSegment(k, len, start, end)) throw InvalidKeyException("%.*s", (int)key.size(), key.data());
+    if (!buffer) return false;
+    const char* level = buffer + 7;
+    const char* levellimit = limit;
+    while (true) {
+        const char* seg = k + start;
+        size_t seglen = end - start;
+        bool numeric = isNumericKey(seg, seglen);
+        long long intkey = numeric ? parseInteger(seg, seglen) : 0;
+        Element candidate;
+        bool found = false;
+        const char* p = level;
+        while ((p = parseElement(p, levellimit, candidate))) {
+            if (numeric && isNumericKey(candidate.keyptr, candidate.keylen)) {
+                if (parseInteger(candidate.keyptr, candidate.keylen) == intkey) {
+                    found = true;
+                    break;
+                }
+            } else if (candidate.keylen == seglen && equalsIgnoreCase(candidate.keyptr, seg, seglen)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) return false;
+        start = end;
+        if (!nextSegment(k, len, start, end)) {
+            e = candidate;
+            return true;
+        }
+        if (candidate.datatype != Variant::TYPE_ASSOCARRAY) return false;
+        level = candidate.valueptr + 7;
+        levellimit = candidate.valueptr + candidate.valuesize;
+    }
+}
+
+/*!\brief Element auslesen
+ *
+ * \param[in] key Name des Schlüssels
+ * \return Element
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ * \exception KeyNotFoundException: Schlüssel wurde nicht gefunden
+ */
+AssocArrayView::Element AssocArrayView::get(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return e;
+}
+
+/*!\brief Element suchen
+ *
+ * \param[in] key Name des Schlüssels
+ * \param[out] e Gefundenes Element
+ * \return Liefert \c true zurück, wenn der Schlüssel vorhanden ist, sonst \c false
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ */
+bool AssocArrayView::get(const StringView& key, Element& e) const
+{
+    return findInternal(key, e);
+}
+
+/*!\brief Schlüssel vorhanden
+ *
+ * @param key Name des Schlüssels
+ * @return Liefert \c true zurück, wenn der Schlüssel vorhanden ist, sonst \c false
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ */
+bool AssocArrayView::exists(const StringView& key) const
+{
+    Element e;
+    return findInternal(key, e);
+}
+
+/*!\brief String auslesen
+ *
+ * @param key Name des Schlüssels
+ * @return Kopie des Strings
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ * \exception KeyNotFoundException: Schlüssel wurde nicht gefunden
+ * \exception TypeConversionException: Der Schlüssel enthält keinen String
+ */
+String AssocArrayView::getString(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return e.toString();
+}
+
+String AssocArrayView::getString(const StringView& key, const String& default_value) const
+{
+    Element e;
+    if (!findInternal(key, e)) return default_value;
+    if (e.isString() || e.isWideString()) return String(e.valueptr, e.valuesize);
+    return default_value;
+}
+
+int AssocArrayView::getInt(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (e.isString() || e.isWideString()) return (int)parseInteger(e.valueptr, e.valuesize);
+    throw TypeConversionException("%.*s cannot be converted to Int", (int)key.size(), key.data());
+}
+
+int AssocArrayView::getInt(const StringView& key, int default_value) const
+{
+    Element e;
+    if (!findInternal(key, e)) return default_value;
+    if (e.isString() || e.isWideString()) return (int)parseInteger(e.valueptr, e.valuesize);
+    return default_value;
+}
+
+long long AssocArrayView::getLongLong(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (e.isString() || e.isWideString()) return parseInteger(e.valueptr, e.valuesize);
+    throw TypeConversionException("%.*s cannot be converted to long long int", (int)key.size(), key.data());
+}
+
+long long AssocArrayView::getLongLong(const StringView& key, long long default_value) const
+{
+    Element e;
+    if (!findInternal(key, e)) return default_value;
+    if (e.isString() || e.isWideString()) return parseInteger(e.valueptr, e.valuesize);
+    return default_value;
+}
+
+bool AssocArrayView::getBoolean(const StringView& key, bool default_value) const
+{
+    Element e;
+    if (!findInternal(key, e)) return default_value;
+    if (e.isString() || e.isWideString()) return String(e.valueptr, e.valuesize).isTrue();
+    return default_value;
+}
+
+/*!\brief Daten ohne Kopie auslesen
+ *
+ * @param key Name des Schlüssels
+ * @return ByteArrayPtr auf die Daten eines Strings, WideStrings (UTF-8) oder ByteArrays im Puffer
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ * \exception KeyNotFoundException: Schlüssel wurde nicht gefunden
+ * \exception TypeConversionException: Der Schlüssel enthält keinen String oder ByteArray
+ */
+ByteArrayPtr AssocArrayView::getByteArrayPtr(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (e.isString() || e.isWideString() || e.isByteArray()) return e.value();
+    throw TypeConversionException("%.*s cannot be converted to ByteArrayPtr", (int)key.size(), key.data());
+}
+
+Array AssocArrayView::getArray(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return e.toArray();
+}
+
+DateTime AssocArrayView::getDateTime(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return e.toDateTime();
+}
+
+/*!\brief View auf ein verschachteltes Array
+ *
+ * @param key Name des Schlüssels
+ * @return AssocArrayView, die auf den gleichen Puffer zeigt
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ * \exception KeyNotFoundException: Schlüssel wurde nicht gefunden
+ * \exception TypeConversionException: Der Schlüssel enthält kein AssocArray
+ */
+AssocArrayView AssocArrayView::getAssocArray(const StringView& key) const
+{
+    Element e;
+    if (!findInternal(key, e)) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return e.toAssocArrayView();
+}
+
+/*!\brief Vollständig in ein AssocArray importieren
+ *
+ * \param[out] target AssocArray, in das die Daten importiert werden. Vorhandene Daten bleiben
+ * erhalten, gleichnamige Schlüssel werden überschrieben.
+ */
+void AssocArrayView::toAssocArray(AssocArray& target) const
+{
+    if (!buffer) return;
+    target.importBinary(buffer, limit - buffer);
+}
+
+/*!\brief Iterator auf das erste Element
+ *
+ * \desc
+ * Die Elemente werden in der Reihenfolge des Exports geliefert, also in der Sortierung
+ * des exportierenden AssocArray.
+ */
+AssocArrayView::const_iterator AssocArrayView::begin() const
+{
+    if (!buffer) return const_iterator();
+    return const_iterator(buffer + 7, limit);
+}
+
+AssocArrayView::const_iterator AssocArrayView::end() const
+{
+    return const_iterator();
+}
+
+
+} // EOF namespace ppl7
@@ -0,0 +1,1338 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2024, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDARG_H
+#include <stdarg.h>
+#endif
+#ifdef HAVE_TYPES_H
+#include <types.h>
+#endif
+
+#include <ostream>
+
+#include "ppl7.h"
+
+
+namespace ppl7
+{
+
+/*!\class HashAssocArray
+ * \ingroup PPLGroupDataTypes
+ * \brief Assoziatives %Array mit Hash-Index und Einfüge-Reihenfolge
+ *
+ * \desc
+ * Die Klasse HashAssocArray bietet die gleiche Schnittstelle wie AssocArray, verwaltet
+ * die Schlüssel jedoch nicht in einer sortierten std::map, sondern in einer Hashtabelle.
+ * Das Suchen, Einfügen und Löschen eines Schlüssels erfolgt dadurch in konstanter Zeit,
+ * unabhängig von der Anzahl Elemente im %Array. Ausserdem werden bei verschachtelten
+ * Schlüsseln (<tt>"ebene1/ebene2/key"</tt>) die einzelnen Pfadelemente direkt im Schlüssel
+ * gesucht, ohne dass dafür temporäre Strings angelegt werden müssen.
+ * \par
+ * Die Semantik der Schlüssel ist identisch mit AssocArray: Gross-/Kleinschreibung wird ignoriert,
+ * rein nummerische Schlüssel werden nummerisch verglichen ("1" ist identisch mit "01"),
+ * der Slash (/) trennt die Ebenen eines mehrdimensionalen Arrays und der Schlüssel "[]"
+ * hängt ein Element mit dem nächsten freien nummerischen Index an.
+ * \par
+ * Im Gegensatz zu AssocArray werden die Elemente beim Durchwandern nicht sortiert, sondern
+ * in der Reihenfolge zurückgeliefert, in der sie eingefügt wurden. Das Überschreiben eines
+ * vorhandenen Schlüssels ändert seine Position nicht.
+ * \par
+ * Verschachtelte Arrays werden als HashAssocArray (Variant::TYPE_HASHASSOCARRAY) gespeichert.
+ * Wird ein AssocArray als Wert gesetzt, wird es dabei automatisch umgewandelt. Das Format von
+ * HashAssocArray::exportBinary ist identisch mit dem von AssocArray::exportBinary, so dass
+ * die Daten zwischen beiden Klassen ausgetauscht werden können.
+ *
+ * \par Beispiel:
+ * \code
+ppl7::HashAssocArray a;
+a.set("request/method","GET");
+a.set("request/uri","/index.html");
+a.set("header/Host","www.example.com");
+int port=a.getInt("server/port",80);
+for (ppl7::HashAssocArray::const_iterator it=a.begin();it!=a.end();++it) {
+    printf ("%s\n",(const char*)it->first);
+}
+\endcode
+ */
+
+/*!\brief Prüft, ob ein Schlüssel nummerisch ist
+ *
+ * \desc
+ * Entspricht String::isNumeric, arbeitet aber direkt auf einem Teilstück des Schlüssels.
+ */
+static inline bool isNumericKey(const char* key, size_t len)
+{
+    if (!len) return false;
+    size_t dotcount = 0;
+    for (size_t i = 0; i < len; i++) {
+        int c = key[i];
+        if (c < '0' || c > '9') {
+            if (c != '.' && c != ',' && c != '-') return false;
+            if (c == '-' && i > 0) return false;
+            if (c == '.' || c == ',') {
+                dotcount++;
+                if (dotcount > 1) return false;
+            }
+        }
+    }
+    if (key[len - 1] == '.') return false;
+    return true;
+}
+
+static inline char lowerAscii(char c)
+{
+    if (c >= 'A' && c <= 'Z') return (char)(c + 32);
+    return c;
+}
+
+static inline uint64_t hashString(const char* key, size_t len)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)lowerAscii(key[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static inline uint64_t hashInteger(int64_t value)
+{
+    uint64_t h = (uint64_t)value;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline bool equalsIgnoreCase(const char* s1, const char* s2, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (lowerAscii(s1[i]) != lowerAscii(s2[i])) return false;
+    }
+    return true;
+}
+
+/*!\brief Nächstes Element eines Pfades suchen
+ *
+ * \desc
+ * Überspringt ab Position \p start alle Slashes und liefert in \p start und \p end
+ * Anfang und Ende des nächsten Pfadelements zurück.
+ *
+ * \return Liefert \c false zurück, wenn der Pfad keine weiteren Elemente enthält
+ */
+static inline bool nextSegment(const char* key, size_t len, size_t& start, size_t& end)
+{
+    while (start < len && key[start] == '/') start++;
+    if (start >= len) return false;
+    end = start;
+    while (end < len && key[end] != '/') end++;
+    return true;
+}
+
+HashAssocArray::Key::Key(const char* key, size_t keylen)
+{
+    ptr = key;
+    len = keylen;
+    numeric = isNumericKey(key, keylen);
+    if (numeric) {
+        // Der Schlüssel ist entweder nullterminiert oder endet mit einem Slash
+        intkey = (int64_t)strtoll(key, NULL, 10);
+        hash = hashInteger(intkey);
+    } else {
+        intkey = 0;
+        hash = hashString(key, keylen);
+    }
+}
+
+HashAssocArray::Element::Element(const char* key, size_t keylen, uint64_t hash, Variant* value)
+    : data(String(key, keylen), value)
+{
+    this->hash = hash;
+    intkey = 0;
+    numeric = false;
+    bucketnext = NULL;
+    prev = NULL;
+    next = NULL;
+}
+
+/*!\brief Konstruktor
+ *
+ * \desc
+ * Erzeugt ein leeres %Array. Die Hashtabelle wird erst beim Einfügen des ersten Elements angelegt.
+ */
+HashAssocArray::HashAssocArray()
+{
+    buckets = NULL;
+    numbuckets = 0;
+    elements = 0;
+    first = last = NULL;
+    maxint = 0;
+}
+
+/*!\brief Copy-Konstruktor
+ *
+ * \desc
+ * Macht eine Kopie des Arrays \p other. Die Reihenfolge der Elemente bleibt erhalten.
+ *
+ * \param[in] other Referenz auf zu kopierendes %Array
+ */
+HashAssocArray::HashAssocArray(const HashAssocArray& other)
+{
+    buckets = NULL;
+    numbuckets = 0;
+    elements = 0;
+    first = last = NULL;
+    maxint = 0;
+    reserve(other.elements);
+    add(other);
+}
+
+/*!\brief Move-Konstruktor
+ *
+ * \desc
+ * Übernimmt den Inhalt von \p other, das anschließend leer ist.
+ */
+HashAssocArray::HashAssocArray(HashAssocArray&& other)
+{
+    buckets = other.buckets;
+    numbuckets = other.numbuckets;
+    elements = other.elements;
+    first = other.first;
+    last = other.last;
+    maxint = other.maxint;
+    other.buckets = NULL;
+    other.numbuckets = 0;
+    other.elements = 0;
+    other.first = other.last = NULL;
+    other.maxint = 0;
+}
+
+/*!\brief Konstruktor aus einem AssocArray
+ *
+ * \desc
+ * Übernimmt den Inhalt des AssocArray \p other. Verschachtelte AssocArrays werden dabei
+ * ebenfalls in HashAssocArrays umgewandelt.
+ */
+HashAssocArray::HashAssocArray(const AssocArray& other)
+{
+    buckets = NULL;
+    numbuckets = 0;
+    elements = 0;
+    first = last = NULL;
+    maxint = 0;
+    reserve(other.size());
+    add(other);
+}
+
+HashAssocArray::~HashAssocArray()
+{
+    clear();
+}
+
+/*!\brief Inhalt des Arrays löschen
+ *
+ * \desc
+ * Löscht alle Elemente und gibt die Hashtabelle frei.
+ */
+void HashAssocArray::clear()
+{
+    Element* e = first;
+    while (e) {
+        Element* next = e->next;
+        delete e->data.second;
+        delete e;
+        e = next;
+    }
+    delete[] buckets;
+    buckets = NULL;
+    numbuckets = 0;
+    elements = 0;
+    first = last = NULL;
+    maxint = 0;
+}
+
+/*!\brief Platz für eine bestimmte Anzahl Elemente reservieren
+ *
+ * \desc
+ * Vergrößert die Hashtabelle so, dass mindestens \p size Elemente aufgenommen werden können,
+ * ohne dass die Tabelle neu aufgebaut werden muss.
+ *
+ * \param[in] size Anzahl erwarteter Elemente
+ */
+void HashAssocArray::reserve(size_t size)
+{
+    size_t newsize = 8;
+    while (newsize < size) newsize <<= 1;
+    if (newsize > numbuckets) rehash(newsize);
+}
+
+void HashAssocArray::rehash(size_t newsize)
+{
+    Element** newbuckets = new Element*[newsize]();
+    size_t mask = newsize - 1;
+    for (Element* e = first; e != NULL; e = e->next) {
+        size_t b = (size_t)(e->hash & mask);
+        e->bucketnext = newbuckets[b];
+        newbuckets[b] = e;
+    }
+    delete[] buckets;
+    buckets = newbuckets;
+    numbuckets = newsize;
+}
+
+HashAssocArray::Element* HashAssocArray::findElement(const Key& key) const
+{
+    if (!elements) return NULL;
+    Element* e = buckets[key.hash & (numbuckets - 1)];
+    while (e) {
+        if (e->hash == key.hash) {
+            if (e->numeric && key.numeric) {
+                if (e->intkey == key.intkey) return e;
+            } else if (e->data.first.size() == key.len && equalsIgnoreCase(e->data.first.getPtr(), key.ptr, key.len)) {
+                return e;
+            }
+        }
+        e = e->bucketnext;
+    }
+    return NULL;
+}
+
+HashAssocArray::Element* HashAssocArray::insertElement(const Key& key, Variant* value)
+{
+    if (elements >= numbuckets) rehash(numbuckets ? numbuckets << 1 : 8);
+    Element* e = new Element(key.ptr, key.len, key.hash, value);
+    e->numeric = key.numeric;
+    e->intkey = key.intkey;
+    size_t b = (size_t)(key.hash & (numbuckets - 1));
+    e->bucketnext = buckets[b];
+    buckets[b] = e;
+    e->prev = last;
+    if (last)
+        last->next = e;
+    else
+        first = e;
+    last = e;
+    elements++;
+    return e;
+}
+
+void HashAssocArray::removeElement(Element* e)
+{
+    Element** pp = &buckets[e->hash & (numbuckets - 1)];
+    while (*pp != e) pp = &(*pp)->bucketnext;
+    *pp = e->bucketnext;
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        first = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        last = e->prev;
+    elements--;
+    delete e->data.second;
+    delete e;
+}
+
+/*!\brief Interne Funktion zum Suchen eines Elements
+ *
+ * \desc
+ * Zerlegt den Schlüssel \p key anhand des Slash (/) in seine Elemente und sucht diese
+ * nacheinander in den verschachtelten Arrays.
+ *
+ * \param[in] key StringView mit dem gesuchten Schlüssel
+ * \return Pointer auf das gefundene Element oder NULL, wenn der Schlüssel nicht vorhanden ist.
+ * \exception InvalidKeyException: Wird geworfen, wenn der Schlüssel ungültig oder leer ist
+ */
+Variant* HashAssocArray::findInternal(const StringView& key) const
+{
+    const char* k = key.data();
+    size_t len = key.size();
+    size_t start = 0, end = 0;
+    if (!nextSegment(k, len, start, end)) throw InvalidKeyException("%.*s", (int)key.size(), key.data());
+    const HashAssocArray* node = this;
+    while (1) {
+        Element* e = node->findElement(Key(k + start, end - start));
+        if (!e) return NULL;
+        start = end;
+        if (!nextSegment(k, len, start, end)) return e->data.second;
+        if (e->data.second == NULL || !e->data.second->isHashAssocArray()) return NULL;
+        node = &e->data.second->toHashAssocArray();
+    }
+}
+
+/*!\brief Interne Funktion, die ein Element sucht oder anlegt
+ *
+ * \desc
+ * Legt das Element \p var unter dem Schlüssel \p key ab. Fehlende Zwischenebenen werden als
+ * HashAssocArray angelegt, vorhandene Werte, die keine Arrays sind, werden dabei ersetzt
+ * (siehe AssocArray::createTree). Im Erfolgsfall geht \p var in den Besitz des Arrays über.
+ *
+ * \exception InvalidKeyException: Wird geworfen, wenn der Schlüssel ungültig oder leer ist
+ */
+void HashAssocArray::createTree(const String& key, Variant* var)
+{
+    const char* k = key.getPtr();
+    size_t len = key.size();
+    size_t start = 0, end = 0;
+    if (!nextSegment(k, len, start, end)) throw InvalidKeyException(key);
+    HashAssocArray* node = this;
+    char index[24];
+    while (1) {
+        const char* seg = k + start;
+        size_t seglen = end - start;
+        if (seglen == 2 && seg[0] == '[' && seg[1] == ']') {
+            seglen = (size_t)snprintf(index, sizeof(index), "%llu", (unsigned long long)node->maxint);
+            seg = index;
+            node->maxint++;
+        }
+        Key segkey(seg, seglen);
+        if (segkey.numeric && (uint64_t)segkey.intkey >= node->maxint) node->maxint = (uint64_t)segkey.intkey + 1;
+        start = end;
+        bool more = nextSegment(k, len, start, end);
+        Element* e = node->findElement(segkey);
+        if (!more) {
+            if (e) {
+                delete e->data.second;
+                e->data.second = var;
+            } else {
+                node->insertElement(segkey, var);
+            }
+            return;
+        }
+        if (!e) {
+            Variant* newnode = new Variant(HashAssocArray());
+            try {
+                e = node->insertElement(segkey, newnode);
+            }
+            catch (...) {
+                delete newnode;
+                throw;
+            }
+        } else if (e->data.second == NULL || !e->data.second->isHashAssocArray()) {
+            Variant* newnode = new Variant(HashAssocArray());
+            delete e->data.second;
+            e->data.second = newnode;
+        }
+        node = &e->data.second->toHashAssocArray();
+    }
+}
+
+/*!\brief Anzahl Schlüssel zählen
+ *
+ * \param[in] recursive Falls \c true, werden die Elemente verschachtelter Arrays mitgezählt
+ * \returns Anzahl Schlüssel
+ */
+size_t HashAssocArray::count(bool recursive) const
+{
+    if (!recursive) return elements;
+    size_t num = elements;
+    for (const Element* e = first; e != NULL; e = e->next) {
+        if (e->data.second->isHashAssocArray()) num += e->data.second->toHashAssocArray().count(recursive);
+    }
+    return num;
+}
+
+/*!\brief Anzahl Schlüssel für ein bestimmtes Element zählen
+ *
+ * \param[in] key Schlüssel-Name eines Arrays innerhalb dieses Arrays
+ * \param[in] recursive Falls \c true, werden die Elemente verschachtelter Arrays mitgezählt
+ * \returns Anzahl Schlüssel
+ */
+size_t HashAssocArray::count(const String& key, bool recursive) const
+{
+    const Variant* p = findInternal(key);
+    if (!p) return (size_t)0;
+    if (p->isHashAssocArray()) return p->toHashAssocArray().count(recursive);
+    return 1;
+}
+
+/*!\brief Anzahl Elemente auf dieser Ebene des Arrays
+ */
+size_t HashAssocArray::size() const
+{
+    return elements;
+}
+
+/*!\brief Inhalt des Arrays ausgeben
+ *
+ * \desc
+ * Diese Funktion dient Debugging-Zwecken und gibt den Inhalt des Arrays in Einfüge-Reihenfolge
+ * aus (siehe AssocArray::list).
+ *
+ * \param[in] prefix Optionaler Text, der bei der Ausgabe jedem Element vorangestellt wird
+ */
+void HashAssocArray::list(const String& prefix) const
+{
+    String key;
+    String pre;
+    if (prefix.notEmpty()) key = prefix + "/";
+    for (const Element* e = first; e != NULL; e = e->next) {
+        const Variant* p = e->data.second;
+        const char* k = (const char*)e->data.first;
+        if (p->isString()) {
+            PrintDebug("%s%s=%s\n", (const char*)key, k, (const char*)p->toString().getPtr());
+        } else if (p->isWideString()) {
+            PrintDebug("%s%s=%ls\n", (const char*)key, k, (const wchar_t*)p->toWideString().getPtr());
+        } else if (p->isByteArray()) {
+            PrintDebug("%s%s=ByteArray, %zu Bytes\n", (const char*)key, k, p->toByteArray().size());
+        } else if (p->isByteArrayPtr()) {
+            PrintDebug("%s%s=ByteArrayPtr, %zu Bytes\n", (const char*)key, k, p->toByteArrayPtr().size());
+        } else if (p->isHashAssocArray()) {
+            pre.setf("%s%s", (const char*)key, k);
+            p->toHashAssocArray().list(pre);
+        } else if (p->isAssocArray()) {
+            pre.setf("%s%s", (const char*)key, k);
+            p->toAssocArray().list(pre);
+        } else if (p->isArray()) {
+            const Array& a = p->toArray();
+            for (size_t i = 0; i < a.size(); i++) {
+                PrintDebug("%s%s/Array(%zu)=%s\n", (const char*)key, k, i, (const char*)a[i]);
+            }
+        } else if (p->isDateTime()) {
+            PrintDebug("%s%s=DateTime %s\n", (const char*)key, k, (const char*)p->toDateTime().getISO8601withMsec());
+        } else {
+            PrintDebug("%s%s=UnknownDataType Id=%i\n", (const char*)key, k, p->type());
+        }
+    }
+}
+
+/*!\brief %String hinzufügen
+ *
+ * \param[in] key Name des Schlüssels
+ * \param[in] value Wert
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ */
+void HashAssocArray::set(const String& key, const String& value)
+{
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+/*!\brief %String mit bestimmter Länge hinzufügen
+ *
+ * \param[in] key Name des Schlüssels
+ * \param[in] value Wert
+ * \param[in] size Anzahl Zeichen, die aus dem String \p value übernommen werden sollen
+ * \exception InvalidKeyException: Ungültiger Schlüssel
+ */
+void HashAssocArray::set(const String& key, const String& value, size_t size)
+{
+    Variant* var = new Variant(String(value, size));
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+void HashAssocArray::set(const String& key, const WideString& value)
+{
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+void HashAssocArray::set(const String& key, const Array& value)
+{
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+void HashAssocArray::set(const String& key, const DateTime& value)
+{
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+void HashAssocArray::set(const String& key, const ByteArray& value)
+{
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+void HashAssocArray::set(const String& key, const ByteArrayPtr& value)
+{
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+/*!\brief %AssocArray hinzufügen
+ *
+ * \desc
+ * Der Inhalt des AssocArray \p value wird in ein HashAssocArray umgewandelt und unter dem
+ * Schlüssel \p key gespeichert.
+ */
+void HashAssocArray::set(const String& key, const AssocArray& value)
+{
+    Variant* var = new Variant(HashAssocArray(value));
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+void HashAssocArray::set(const String& key, const HashAssocArray& value)
+{
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+/*!\brief %Variant hinzufügen
+ *
+ * \desc
+ * Der Wert von \p value wird kopiert. Enthält der Variant ein AssocArray, wird dieses in
+ * ein HashAssocArray umgewandelt.
+ */
+void HashAssocArray::set(const String& key, const Variant& value)
+{
+    Variant* var;
+    if (value.isAssocArray())
+        var = new Variant(HashAssocArray(value.toAssocArray()));
+    else
+        var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+/*!\brief Formatierten String hinzufügen
+ *
+ * \param[in] key Name des Schlüssels
+ * \param[in] fmt Formatstring
+ * \param[in] ... Optionale Parameter
+ */
+void HashAssocArray::setf(const String& key, const char* fmt, ...)
+{
+    String value;
+    va_list args;
+    va_start(args, fmt);
+    value.vasprintf(fmt, args);
+    va_end(args);
+    Variant* var = new Variant(value);
+    try {
+        createTree(key, var);
+    }
+    catch (...) {
+        delete var;
+        throw;
+    }
+}
+
+/*!\brief %String verlängern
+ *
+ * \desc
+ * Ist der Schlüssel \p key bereits vorhanden, wird \p value an den vorhandenen %String
+ * angehängt, bei Bedarf getrennt durch \p concat. Andernfalls wird der Schlüssel neu angelegt.
+ */
+void HashAssocArray::append(const String& key, const String& value, const String& concat)
+{
+    Variant* node = findInternal(key);
+    if (!node) {
+        set(key, value);
+        return;
+    }
+    if (concat.notEmpty()) node->toString().append(concat);
+    node->toString().append(value);
+}
+
+void HashAssocArray::appendf(const String& key, const String& concat, const char* fmt, ...)
+{
+    String var;
+    va_list args;
+    va_start(args, fmt);
+    var.vasprintf(fmt, args);
+    va_end(args);
+    append(key, var, concat);
+}
+
+/*!\brief %Array hinzufügen
+ *
+ * \desc
+ * Kopiert alle Elemente aus \p other in dieses %Array. Vorhandene Schlüssel werden
+ * überschrieben, verschachtelte Arrays werden zusammengeführt.
+ */
+void HashAssocArray::add(const HashAssocArray& other)
+{
+    for (const Element* e = other.first; e != NULL; e = e->next) {
+        Variant* existing = findInternal(e->data.first);
+        if (existing && existing->isHashAssocArray() && e->data.second->isHashAssocArray()) {
+            existing->toHashAssocArray().add(e->data.second->toHashAssocArray());
+        } else
+            set(e->data.first, *e->data.second);
+    }
+}
+
+void HashAssocArray::add(const AssocArray& other)
+{
+    AssocArray::const_iterator it;
+    for (it = other.begin(); it != other.end(); ++it) {
+        Variant* existing = findInternal(it->first);
+        if (existing && existing->isHashAssocArray() && it->second->isAssocArray()) {
+            existing->toHashAssocArray().add(it->second->toAssocArray());
+        } else
+            set(it->first, *it->second);
+    }
+}
+
+/*!\brief In ein AssocArray umwandeln
+ *
+ * \desc
+ * Kopiert den Inhalt dieses Arrays in das AssocArray \p target, verschachtelte Arrays
+ * werden dabei ebenfalls umgewandelt.
+ */
+void HashAssocArray::toAssocArray(AssocArray& target) const
+{
+    for (const Element* e = first; e != NULL; e = e->next) {
+        if (e->data.second->isHashAssocArray()) {
+            AssocArray sub;
+            e->data.second->toHashAssocArray().toAssocArray(sub);
+            target.set(e->data.first, sub);
+        } else {
+            target.set(e->data.first, *e->data.second);
+        }
+    }
+}
+
+/*!\brief Schlüssel auslesen
+ *
+ * \exception KeyNotFoundException: Der Schlüssel ist nicht vorhanden
+ */
+Variant& HashAssocArray::get(const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return (*node);
+}
+
+bool HashAssocArray::exists(const StringView& key) const
+{
+    if (findInternal(key)) return true;
+    return false;
+}
+
+String& HashAssocArray::getString(const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (!node->isString()) throw TypeConversionException("%.*s is not a String", (int)key.size(), key.data());
+    return node->toString();
+}
+
+String& HashAssocArray::getString(const StringView& key, String& default_value) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return default_value;
+    if (node->isString()) return node->toString();
+    return default_value;
+}
+
+const String& HashAssocArray::getString(const StringView& key, const String& default_value) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return default_value;
+    if (node->isString()) return node->toString();
+    return default_value;
+}
+
+bool HashAssocArray::getBoolean(const StringView& key, bool default_value) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return default_value;
+    if (node->isString()) return node->toString().isTrue();
+    if (node->isWideString()) return node->toWideString().isTrue();
+    return default_value;
+}
+
+int HashAssocArray::getInt(const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (node->isString()) return node->toString().toInt();
+    if (node->isWideString()) return node->toWideString().toInt();
+    throw TypeConversionException("%.*s cannot be converted to Int", (int)key.size(), key.data());
+}
+
+int HashAssocArray::getInt(const StringView& key, int default_value) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return default_value;
+    if (node->isString()) return node->toString().toInt();
+    if (node->isWideString()) return node->toWideString().toInt();
+    return default_value;
+}
+
+long long HashAssocArray::getLongLong(const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (node->isString()) return node->toString().toLongLong();
+    if (node->isWideString()) return node->toWideString().toLongLong();
+    throw TypeConversionException("%.*s cannot be converted to long long int", (int)key.size(), key.data());
+}
+
+long long HashAssocArray::getLongLong(const StringView& key, long long default_value) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return default_value;
+    if (node->isString()) return node->toString().toLongLong();
+    if (node->isWideString()) return node->toWideString().toLongLong();
+    return default_value;
+}
+
+bool HashAssocArray::isTrue(const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return false;
+    if (node->isString()) return node->toString().isTrue();
+    if (node->isWideString()) return node->toWideString().isTrue();
+    return false;
+}
+
+/*!\brief Verschachteltes %Array auslesen
+ *
+ * \exception KeyNotFoundException: Der Schlüssel ist nicht vorhanden
+ * \exception TypeConversionException: Der Wert ist kein %Array
+ */
+HashAssocArray& HashAssocArray::getAssocArray(const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (!node->isHashAssocArray()) throw TypeConversionException("%.*s is not an AssocArray", (int)key.size(), key.data());
+    return node->toHashAssocArray();
+}
+
+HashAssocArray& HashAssocArray::getAssocArray(const StringView& key, HashAssocArray& default_value) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return default_value;
+    if (node->isHashAssocArray()) return node->toHashAssocArray();
+    return default_value;
+}
+
+Array& HashAssocArray::getArray(const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    if (!node->isArray()) throw TypeConversionException("%.*s is not an Array", (int)key.size(), key.data());
+    return node->toArray();
+}
+
+Array& HashAssocArray::getArray(const StringView& key, Array& default_value) const
+{
+    Variant* node = findInternal(key);
+    if (!node) return default_value;
+    if (node->isArray()) return node->toArray();
+    return default_value;
+}
+
+/*!\brief Einzelnen Schlüssel löschen
+ *
+ * \desc
+ * Löscht den Schlüssel \p key samt Inhalt. Ist der Schlüssel nicht vorhanden, passiert nichts.
+ *
+ * \exception InvalidKeyException: Der Schlüssel ist ungültig oder leer
+ */
+void HashAssocArray::erase(const String& key)
+{
+    const char* k = key.getPtr();
+    size_t len = key.size();
+    size_t start = 0, end = 0;
+    if (!nextSegment(k, len, start, end)) throw InvalidKeyException(key);
+    HashAssocArray* node = this;
+    while (1) {
+        Element* e = node->findElement(Key(k + start, end - start));
+        if (!e) return; // nothing to do
+        start = end;
+        if (!nextSegment(k, len, start, end)) {
+            node->removeElement(e);
+            return;
+        }
+        if (e->data.second == NULL || !e->data.second->isHashAssocArray()) return;
+        node = &e->data.second->toHashAssocArray();
+    }
+}
+
+void HashAssocArray::remove(const String& key)
+{
+    erase(key);
+}
+
+HashAssocArray::iterator HashAssocArray::begin()
+{
+    return iterator(first);
+}
+
+HashAssocArray::const_iterator HashAssocArray::begin() const
+{
+    return const_iterator(first);
+}
+
+HashAssocArray::iterator HashAssocArray::end()
+{
+    return iterator(NULL);
+}
+
+HashAssocArray::const_iterator HashAssocArray::end() const
+{
+    return const_iterator(NULL);
+}
+
+/*!\brief Zeiger für das Durchwandern des Arrays zurücksetzen
+ */
+void HashAssocArray::reset(Iterator& it) const
+{
+    it.reset = true;
+}
+
+/*!\brief Erstes Element zurückgeben
+ *
+ * \param[in,out] it Iterator
+ * \param[in] type Optionaler Datentyp. Ist er angegeben, werden nur Elemente dieses Typs berücksichtigt.
+ * \return Liefert \c true zurück, wenn ein Element gefunden wurde
+ */
+bool HashAssocArray::getFirst(Iterator& it, Variant::DataType type) const
+{
+    it.e = first;
+    it.reset = false;
+    while (1) {
+        if (it.e == NULL) return false;
+        if (type == Variant::TYPE_UNKNOWN) break;
+        if (type == it.e->data.second->type()) break;
+        it.e = it.e->next;
+    }
+    return true;
+}
+
+bool HashAssocArray::getNext(Iterator& it, Variant::DataType type) const
+{
+    if (it.reset) return getFirst(it, type);
+    if (it.e == NULL) return false;
+    while (1) {
+        it.e = it.e->next;
+        if (it.e == NULL) return false;
+        if (type == Variant::TYPE_UNKNOWN) break;
+        if (type == it.e->data.second->type()) break;
+    }
+    return true;
+}
+
+bool HashAssocArray::getFirst(Iterator& it, String& key, String& value) const
+{
+    if (!getFirst(it, Variant::TYPE_STRING)) return false;
+    key.set(it.e->data.first);
+    value.set(it.e->data.second->toString());
+    return true;
+}
+
+bool HashAssocArray::getNext(Iterator& it, String& key, String& value) const
+{
+    if (!getNext(it, Variant::TYPE_STRING)) return false;
+    key.set(it.e->data.first);
+    value.set(it.e->data.second->toString());
+    return true;
+}
+
+/*!\brief Liefert Anzahl Bytes, die für exportBinary erforderlich sind
+ */
+size_t HashAssocArray::binarySize() const
+{
+    size_t size;
+    exportBinary(NULL, 0, &size);
+    return size;
+}
+
+/*!\brief Inhalt des Arrays in einem plattform-unabhängigen Binären-Format exportieren
+ *
+ * \desc
+ * Das Format ist identisch mit AssocArray::exportBinary, verschachtelte Arrays werden als
+ * Variant::TYPE_ASSOCARRAY gespeichert. Die Elemente werden in Einfüge-Reihenfolge geschrieben.
+ *
+ * \param[in] buffer Pointer auf den Speicherbereich, in den die Daten geschrieben werden sollen.
+ * Ist er NULL, wird nur die benötigte Größe berechnet.
+ * \param[in] buffersize Größe des Speicherbereichs
+ * \param[out] realsize Anzahl tatsächlich benötigter Bytes
+ * \exception ExportBufferToSmallException: Der Speicherbereich ist zu klein
+ */
+void HashAssocArray::exportBinary(void* buffer, size_t buffersize, size_t* realsize) const
+{
+    char* ptr = (char*)buffer;
+    if (realsize) *realsize = 0;
+    size_t p = 0;
+    size_t vallen = 0;
+    ByteArray ba;
+#ifdef HAVE_ICONV
+    Iconv iconv(ICONV_UNICODE, "UTF-8");
+#endif
+    if (!buffer) buffersize = 0;
+    if (p + 7 < buffersize) memcpy(ptr, "PPLASOC", 7);
+    p += 7;
+    for (const Element* e = first; e != NULL; e = e->next) {
+        const Variant* a = e->data.second;
+        if (p < buffersize) {
+            if (a->isByteArrayPtr())
+                PokeN8(ptr + p, Variant::TYPE_BYTEARRAY);
+            else if (a->isHashAssocArray())
+                PokeN8(ptr + p, Variant::TYPE_ASSOCARRAY);
+            else
+                PokeN8(ptr + p, a->type());
+        }
+        p++;
+        const String& key = e->data.first;
+        size_t keylen = key.size();
+        if (p + 4 < buffersize) PokeN16(ptr + p, (int)keylen);
+        p += 2;
+        if (p + keylen < buffersize) memcpy(ptr + p, key.getPtr(), keylen);
+        p += keylen;
+        if (a->isString()) {
+            const String& string = a->toString();
+            vallen = string.size();
+            if (p + 4 < buffersize) PokeN32(ptr + p, (int)vallen);
+            p += 4;
+            if (p + vallen < buffersize) memcpy(ptr + p, string.getPtr(), vallen);
+            p += vallen;
+        } else if (a->isWideString()) {
+#ifdef HAVE_ICONV
+            const WideString& widestring = a->toWideString();
+            iconv.transcode(ByteArrayPtr(widestring.getPtr(), widestring.byteLength()), ba);
+            vallen = ba.size();
+            if (p + 4 < buffersize) PokeN32(ptr + p, (int)vallen);
+            p += 4;
+            if (p + vallen < buffersize) memcpy(ptr + p, ba.adr(), vallen);
+            p += vallen;
+#else
+            String string(a->toWideString());
+            vallen = string.size();
+            if (p + 4 < buffersize) PokeN32(ptr + p, (int)vallen);
+            p += 4;
+            if (p + vallen < buffersize) memcpy(ptr + p, string.getPtr(), vallen);
+            p += vallen;
+#endif
+        } else if (a->isHashAssocArray() || a->isAssocArray()) {
+            size_t asize = 0;
+            if (a->isHashAssocArray()) {
+                if (!buffer)
+                    a->toHashAssocArray().exportBinary(NULL, 0, &asize);
+                else
+                    a->toHashAssocArray().exportBinary(ptr + p, buffersize - p, &asize);
+            } else {
+                if (!buffer)
+                    a->toAssocArray().exportBinary(NULL, 0, &asize);
+                else
+                    a->toAssocArray().exportBinary(ptr + p, buffersize - p, &asize);
+            }
+            p += asize;
+        } else if (a->isArray()) {
+            const Array& aaa = a->toArray();
+            if (p + 4 < buffersize) PokeN32(ptr + p, (int)aaa.size());
+            p += 4;
+            for (size_t i = 0; i < aaa.size(); i++) {
+                const String& s = aaa.get(i);
+                vallen = s.size();
+                if (p + 4 < buffersize) PokeN32(ptr + p, (int)vallen);
+                p += 4;
+                if (p + vallen < buffersize) memcpy(ptr + p, s.getPtr(), vallen);
+                p += vallen;
+            }
+        } else if (a->isDateTime()) {
+            vallen = 8;
+            if (p + 4 < buffersize) PokeN32(ptr + p, (int)vallen);
+            p += 4;
+            if (p + vallen < buffersize) PokeN64(ptr + p, a->toDateTime().longInt());
+            p += vallen;
+        } else if (a->isByteArrayPtr()) {
+            const ByteArrayPtr& bin = a->toByteArrayPtr();
+            vallen = bin.size();
+            if (p + 4 < buffersize) PokeN32(ptr + p, (int)vallen);
+            p += 4;
+            if (p + vallen < buffersize) memcpy(ptr + p, bin.adr(), vallen);
+            p += vallen;
+        } else {
+            if (p + 4 < buffersize) PokeN32(ptr + p, 0);
+            p += 4;
+        }
+    }
+    if (p < buffersize) PokeN8(ptr + p, 0);
+    p++;
+    if (realsize) *realsize = p;
+    if (buffersize == 0 || p <= buffersize) return;
+    throw ExportBufferToSmallException("%zd < %zd", buffersize, p);
+}
+
+void HashAssocArray::exportBinary(ByteArray& buffer) const
+{
+    buffer.free();
+    size_t size;
+    exportBinary(NULL, 0, &size);
+    buffer.malloc(size);
+    exportBinary((void*)buffer.adr(), buffer.size(), NULL);
+}
+
+void HashAssocArray::importBinary(const ByteArrayPtr& bin)
+{
+    importBinary(bin.adr(), bin.size());
+}
+
+/*!\brief Daten aus einem vorherigen Export wieder importieren
+ *
+ * \desc
+ * Importiert Daten, die mit HashAssocArray::exportBinary oder AssocArray::exportBinary
+ * erstellt wurden. Die Elemente werden zu den bereits vorhandenen hinzugefügt.
+ *
+ * \return Anzahl gelesener Bytes
+ * \exception ImportFailedException: Die Daten sind ungültig
+ */
+size_t HashAssocArray::importBinary(const void* buffer, size_t buffersize)
+{
+    if (!buffer) throw IllegalArgumentException();
+    if (buffersize == 0) throw IllegalArgumentException();
+    const char* ptr = (const char*)buffer;
+    size_t p = 0;
+    if (buffersize < 8 || strncmp((const char*)ptr, "PPLASOC", 7) != 0) {
+        throw ImportFailedException("Not an AssocArray binary export");
+    }
+    p += 7;
+    int type;
+    size_t vallen;
+    String key, str;
+    DateTime dt;
+    ByteArray nb;
+    WideString ws;
+#ifdef HAVE_ICONV
+    Iconv iconv("UTF-8", ICONV_UNICODE);
+#endif
+    while (p < buffersize && (type = PeekN8(ptr + p)) != 0) {
+        p++;
+        size_t keylen = PeekN16(ptr + p);
+        p += 2;
+        key.set(ptr + p, keylen);
+        p += keylen;
+        switch (type) {
+        case Variant::TYPE_STRING:
+            vallen = PeekN32(ptr + p);
+            p += 4;
+            set(key, String(ptr + p, vallen));
+            p += vallen;
+            break;
+        case Variant::TYPE_WIDESTRING:
+            vallen = PeekN32(ptr + p);
+            p += 4;
+#ifdef HAVE_ICONV
+            iconv.transcode(ByteArrayPtr((const char*)ptr + p, vallen), nb);
+            ws.set((const wchar_t*)nb.ptr(), nb.size() / sizeof(wchar_t));
+#else
+            ws.set((const char*)ptr + p, vallen);
+#endif
+            set(key, ws);
+            p += vallen;
+            break;
+        case Variant::TYPE_ASSOCARRAY: {
+            Variant* var = new Variant(HashAssocArray());
+            try {
+                p += var->toHashAssocArray().importBinary(ptr + p, buffersize - p);
+                createTree(key, var);
+            }
+            catch (...) {
+                delete var;
+                throw;
+            }
+        } break;
+        case Variant::TYPE_ARRAY: {
+            size_t elements = PeekN32(ptr + p);
+            p += 4;
+            Array stringarray;
+            stringarray.reserve(elements);
+            for (size_t i = 0; i < elements; i++) {
+                str.set(ptr + p + 4, PeekN32(ptr + p));
+                p += PeekN32(ptr + p) + 4;
+                stringarray.add(str);
+            }
+            set(key, stringarray);
+        } break;
+        case Variant::TYPE_BYTEARRAY:
+            vallen = PeekN32(ptr + p);
+            p += 4;
+            nb.free();
+            nb.copy(ptr + p, vallen);
+            p += vallen;
+            set(key, nb);
+            break;
+        case Variant::TYPE_DATETIME:
+            vallen = PeekN32(ptr + p);
+            p += 4;
+            dt.setLongInt(PeekN64(ptr + p));
+            p += vallen;
+            set(key, dt);
+            break;
+        default:
+            vallen = PeekN32(ptr + p);
+            throw ImportFailedException("unknown datatype in AssocArray binary export [type=%d, size=%zu]", type, vallen);
+        };
+    }
+    p++;
+    return p;
+}
+
+/*!\brief Schlüssel auslesen
+ *
+ * \exception KeyNotFoundException: Der Schlüssel ist nicht vorhanden
+ */
+const Variant& HashAssocArray::operator[](const StringView& key) const
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return *node;
+}
+
+Variant& HashAssocArray::operator[](const StringView& key)
+{
+    Variant* node = findInternal(key);
+    if (!node) throw KeyNotFoundException("%.*s", (int)key.size(), key.data());
+    return *node;
+}
+
+HashAssocArray& HashAssocArray::operator=(const HashAssocArray& other)
+{
+    if (&other == this) return *this;
+    clear();
+    reserve(other.elements);
+    add(other);
+    return *this;
+}
+
+HashAssocArray& HashAssocArray::operator=(HashAssocArray&& other)
+{
+    if (&other == this) return *this;
+    clear();
+    buckets = other.buckets;
+    numbuckets = other.numbuckets;
+    elements = other.elements;
+    first = other.first;
+    last = other.last;
+    maxint = other.maxint;
+    other.buckets = NULL;
+    other.numbuckets = 0;
+    other.elements = 0;
+    other.first = other.last = NULL;
+    other.maxint = 0;
+    return *this;
+}
+
+HashAssocArray& HashAssocArray::operator+=(const HashAssocArray& other)
+{
+    add(other);
+    return *this;
+}
+
+/*!\brief Arrays vergleichen
+ *
+ * \desc
+ * Zwei Arrays sind identisch, wenn sie die gleichen Schlüssel mit den gleichen Werten enthalten.
+ * Die Reihenfolge der Elemente spielt dabei keine Rolle.
+ */
+bool HashAssocArray::operator==(const HashAssocArray& other) const
+{
+    if (elements != other.elements) return false;
+    for (const Element* e = first; e != NULL; e = e->next) {
+        const Element* o = other.findElement(Key(e->data.first.getPtr(), e->data.first.size()));
+        if (!o) return false;
+        if (*e->data.second != *o->data.second) return false;
+    }
+    return true;
+}
+
+bool HashAssocArray::operator!=(const HashAssocArray& other) const
+{
+    if (*this == other) return false;
+    return true;
+}
+
+} // namespace ppl7
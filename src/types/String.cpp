@@ -62,13 +62,22 @@ namespace ppl7
  *
  */
 
-static size_t InitialBuffersize = 128;
 #ifdef WIN32
 static String __GlobalStringEncoding("UTF-8");
 #endif
 
 static char* empty_string = (char*)"";
 
+/*
+ * Reine ASCII-Strings werden ohne Umweg über Unicode umgewandelt. Das ist nur zulässig, wenn
+ * die aktive Lokalisierung die Buchstaben A-Z genauso abbildet wie ASCII, was z.B. bei
+ * "tr_TR" nicht der Fall ist.
+ */
+static inline bool localeMapsAsciiCase()
+{
+    return towlower(L'I') == L'i' && towupper(L'i') == L'I';
+}
+
 void String::setGlobalEncoding(const char* encoding)
 {
     if (!encoding) throw NullPointerException();
@@ -123,12 +132,7 @@ String::String(const String& str)
 
 String::String(String&& other) noexcept
 {
-    ptr = other.ptr;
-    stringlen = other.stringlen;
-    s = other.s;
-    other.ptr = empty_string;
-    other.stringlen = 0;
-    other.s = 0;
+    moveFrom(other);
 }
 
 String::String(const ByteArrayPtr& str)
@@ -155,6 +159,14 @@ String::String(const std::wstring& str)
     set(str.data(), str.size());
 }
 
+String::String(const StringView& str)
+{
+    ptr = empty_string;
+    stringlen = 0;
+    s = 0;
+    set(str.data(), str.size());
+}
+
 String::String(const WideString& str)
 {
     ptr = empty_string;
@@ -165,12 +177,111 @@ String::String(const WideString& str)
 
 String::~String() noexcept
 {
-    if (ptr != empty_string) free(ptr);
+    releaseBuffer();
+}
+
+/*!\brief Speicher auf dem Heap freigeben
+ *
+ * \desc
+ * Gibt den Speicherbereich des Strings frei, sofern er auf dem Heap liegt. Die Member-Variablen
+ * werden dabei nicht zurückgesetzt.
+ */
+void String::releaseBuffer() noexcept
+{
+    if (ptr != empty_string && ptr != inlinebuffer) free(ptr);
+}
+
+/*!\brief Größe eines neuen Speicherblocks berechnen
+ *
+ * \desc
+ * Rundet den benötigten Speicher \p bytes auf 32 Byte auf. Ist \p current angegeben, wächst
+ * der Speicher mindestens um die Hälfte, damit wiederholtes Anhängen nicht jedesmal
+ * zu einem realloc führt.
+ */
+static inline size_t newBuffersize(size_t bytes, size_t current)
+{
+    size_t size = (bytes + 31) & ~((size_t)31);
+    if (current > 0 && size < current + (current >> 1)) size = current + (current >> 1);
+    return size;
+}
+
+/*!\brief Speicher für den String anfordern
+ *
+ * \desc
+ * Stellt sicher, dass der String mindestens \p bytes Bytes aufnehmen kann. Der bisherige
+ * Inhalt geht dabei verloren. Passt der String in den internen Puffer, wird kein
+ * Speicher auf dem Heap angefordert.
+ */
+void String::allocate(size_t bytes)
+{
+    releaseBuffer();
+    stringlen = 0;
+    if (bytes <= InlineBufferSize) {
+        ptr = inlinebuffer;
+        ptr[0] = 0;
+        return;
+    }
+    s = newBuffersize(bytes, 0);
+    ptr = (char*)malloc(s);
+    if (!ptr) {
+        ptr = empty_string;
+        s = 0;
+        throw OutOfMemoryException();
+    }
+}
+
+/*!\brief Speicher für den String vergrößern
+ *
+ * \desc
+ * Vergrößert den Speicher des Strings auf mindestens \p bytes Bytes. Der bisherige Inhalt
+ * bleibt dabei erhalten.
+ */
+void String::grow(size_t bytes)
+{
+    if (bytes <= bufsize()) return;
+    if (bytes <= InlineBufferSize && ptr == empty_string) {
+        ptr = inlinebuffer;
+        ptr[0] = 0;
+        return;
+    }
+    size_t newsize = newBuffersize(bytes, bufsize());
+    char* p;
+    if (ptr == empty_string || ptr == inlinebuffer) {
+        p = (char*)malloc(newsize);
+        if (!p) throw OutOfMemoryException();
+        memcpy(p, ptr, stringlen + 1);
+    } else {
+        p = (char*)realloc(ptr, newsize);
+        if (!p) throw OutOfMemoryException();
+    }
+    ptr = p;
+    s = newsize;
+}
+
+/*!\brief Inhalt eines anderen Strings übernehmen
+ *
+ * \desc
+ * Übernimmt den Speicher von \p other, ohne den eigenen Speicher vorher freizugeben.
+ * Liegt \p other im internen Puffer, wird der Inhalt kopiert. \p other ist anschließend leer.
+ */
+void String::moveFrom(String& other) noexcept
+{
+    stringlen = other.stringlen;
+    if (other.ptr == other.inlinebuffer) {
+        memcpy(inlinebuffer, other.inlinebuffer, stringlen + 1);
+        ptr = inlinebuffer;
+    } else {
+        ptr = other.ptr;
+        s = other.s;
+    }
+    other.ptr = empty_string;
+    other.stringlen = 0;
+    other.s = 0;
 }
 
 void String::clear() noexcept
 {
-    if (ptr != empty_string) free(ptr);
+    releaseBuffer();
     ptr = empty_string;
     stringlen = 0;
     s = 0;
@@ -178,19 +289,49 @@ void String::clear() noexcept
 
 size_t String::capacity() const
 {
-    if (s == 0) return 0;
-    return s - 1;
+    size_t size = bufsize();
+    if (size == 0) return 0;
+    return size - 1;
 }
 
 void String::reserve(size_t size)
 {
     size_t bytes = size + 1;
-    if (s >= bytes) return; // Nothing to do
+    if (size == 0 || bufsize() >= bytes) return; // Nothing to do
+    if (bytes <= InlineBufferSize) {
+        grow(bytes);
+        return;
+    }
     char* p;
-    if (ptr == empty_string)
+    if (ptr == empty_string || ptr == inlinebuffer) {
         p = (char*)malloc(bytes);
-    else
+        if (!p) throw OutOfMemoryException();
+        memcpy(p, ptr, stringlen + 1);
+    } else {
         p = (char*)realloc(ptr, bytes);
+        if (!p) throw OutOfMemoryException();
+    }
+    ptr = p;
+    s = bytes;
+}
+
+void String::shrink_to_fit()
+{
+    if (ptr == empty_string || ptr == inlinebuffer) return;
+    if (stringlen == 0) {
+        clear();
+        return;
+    }
+    size_t bytes = stringlen + 1;
+    if (bytes <= InlineBufferSize) {
+        char* p = ptr;
+        memcpy(inlinebuffer, p, bytes);
+        free(p);
+        ptr = inlinebuffer;
+        return;
+    }
+    if (bytes == s) return;
+    char* p = (char*)realloc(ptr, bytes);
     if (!p) throw OutOfMemoryException();
     ptr = p;
     s = bytes;
@@ -262,17 +403,7 @@ String& String::set(const char* str, size_t size)
         return *this;
     }
     size_t outbytes = inbytes + 1;
-    if (outbytes >= s) {
-        if (ptr != empty_string) free(ptr);
-        stringlen = 0;
-        s = InitialBuffersize;
-        if (s <= outbytes) s = ((outbytes / InitialBuffersize) + 1) * InitialBuffersize + 1;
-        ptr = (char*)malloc(s);
-        if (!ptr) {
-            s = 0;
-            throw OutOfMemoryException();
-        }
-    }
+    if (outbytes > bufsize()) allocate(outbytes);
     memmove((char*)ptr, str, inbytes);
     stringlen = inbytes;
     ((char*)ptr)[stringlen] = 0;
@@ -317,23 +448,20 @@ String& String::set(const wchar_t* str, size_t size)
         inbytes = wcslen(str);
     }
     size_t outbytes = inbytes * sizeof(wchar_t) + 4;
-    if (outbytes >= s) {
-        if (ptr != empty_string) free(ptr);
-        stringlen = 0;
-        s = InitialBuffersize;
-        if (s <= outbytes) s = ((outbytes / InitialBuffersize) + 1) * InitialBuffersize + 4;
-        ptr = (char*)malloc(s);
-        if (!ptr) {
-            s = 0;
+    if (outbytes > bufsize()) {
+        try {
+            allocate(outbytes);
+        }
+        catch (...) {
             free(tmpbuffer);
-            throw OutOfMemoryException();
+            throw;
         }
     }
 #ifdef HAVE_WCSTOMBS_S
-    wcstombs_s(&stringlen, ptr, s, str, s);
+    wcstombs_s(&stringlen, ptr, bufsize(), str, bufsize());
 
 #else
-    stringlen = wcstombs(ptr, str, s);
+    stringlen = wcstombs(ptr, str, bufsize());
 #endif
     free(tmpbuffer);
     if (stringlen == (size_t)-1) {
@@ -364,6 +492,11 @@ String& String::set(const String& str, size_t size)
     return set(str.ptr, inbytes);
 }
 
+String& String::set(const StringView& str)
+{
+    return set(str.data(), str.size());
+}
+
 String& String::set(const ByteArrayPtr& str, size_t size)
 {
     size_t inbytes;
@@ -496,18 +629,13 @@ String& String::append(const char* str, size_t size)
     }
     size_t inchars;
     if (size != (size_t)-1) {
-        inchars = size;
-        if (inchars > strlen(str)) inchars = strlen(str);
+        // str doesn't need to be terminated, so we must not use strlen here
+        const char* end = (const char*)memchr(str, 0, size);
+        inchars = (end != NULL) ? (size_t)(end - str) : size;
     } else
         inchars = strlen(str);
     size_t outbytes = (inchars + stringlen) + 1;
-    if (outbytes >= s) {
-        size_t newbuffersize = ((outbytes / InitialBuffersize) + 1) * InitialBuffersize + 16;
-        char* t = (char*)realloc(ptr, newbuffersize);
-        if (!t) throw OutOfMemoryException();
-        ptr = t;
-        s = newbuffersize;
-    }
+    if (outbytes > bufsize()) grow(outbytes);
     memcpy(((char*)ptr) + stringlen, str, inchars);
     stringlen += inchars;
     ptr[stringlen] = 0;
@@ -519,6 +647,16 @@ String& String::append(const String& str, size_t size)
     return append(str.ptr, size);
 }
 
+String& String::append(const StringView& str)
+{
+    if (str.data() >= ptr && str.data() < ptr + stringlen) {
+        // Der View zeigt in diesen String und würde beim Vergrößern ungültig
+        String copy(str);
+        return append(copy.ptr, copy.stringlen);
+    }
+    return append(str.data(), str.size());
+}
+
 String& String::append(const std::string& str, size_t size)
 {
     if (size == (size_t)-1) return append(str.data(), str.size());
@@ -617,18 +755,12 @@ String& String::prepend(const char* str, size_t size)
     }
     size_t inchars;
     if (size != (size_t)-1) {
-        inchars = size;
-        if (inchars > strlen(str)) inchars = strlen(str);
+        const char* end = (const char*)memchr(str, 0, size);
+        inchars = (end != NULL) ? (size_t)(end - str) : size;
     } else
         inchars = strlen(str);
     size_t outbytes = inchars + stringlen + 1;
-    if (outbytes >= s) {
-        size_t newbuffersize = ((outbytes / InitialBuffersize) + 1) * InitialBuffersize + 16;
-        char* t = (char*)realloc(ptr, newbuffersize);
-        if (!t) throw OutOfMemoryException();
-        ptr = t;
-        s = newbuffersize;
-    }
+    if (outbytes > bufsize()) grow(outbytes);
     // Bestehenden Speicherblock nach hinten moven
     memmove(((char*)ptr) + inchars, ptr, stringlen);
     // Neuen Speicherblock davor kopieren
@@ -947,13 +1079,8 @@ String& String::operator=(const String& str)
 String& String::operator=(String&& other) noexcept
 {
     if (this != &other) {
-        if (ptr != empty_string) free(ptr);
-        ptr = other.ptr;
-        s = other.s;
-        stringlen = other.stringlen;
-        other.ptr = empty_string;
-        other.s = 0;
-        other.stringlen = 0;
+        releaseBuffer();
+        moveFrom(other);
     }
     return *this;
 }
@@ -991,6 +1118,20 @@ String& String::operator=(const std::wstring& str)
     return set(str);
 }
 
+/*!\brief StringView übernehmen
+ *
+ * \desc
+ * Mit diesem Operator wird der von \p str referenzierte Speicherbereich kopiert. Der Operator
+ * ist identisch mit der Funktion String::set
+ *
+ * @param[in] str Zu kopierender StringView
+ * @return Referenz auf diese Instanz der Klasse
+ */
+String& String::operator=(const StringView& str)
+{
+    return set(str);
+}
+
 /*!\brief Zeichen übernehmen
  *
  * \desc
@@ -1074,6 +1215,20 @@ String& String::operator+=(const std::wstring& str)
     return append(str);
 }
 
+/*!\brief StringView anhängen
+ *
+ * \desc
+ * Mit diesem Operator wird der von \p str referenzierte Speicherbereich an den bisher
+ * vorhandenen String angehangen. Der Operator ist identisch mit der Funktion String::append.
+ *
+ * @param[in] str Anzuhängender StringView
+ * @return Referenz auf diese Instanz der Klasse
+ */
+String& String::operator+=(const StringView& str)
+{
+    return append(str);
+}
+
 /*!\brief Zeichen anhängen
  *
  * \desc
@@ -1247,6 +1402,7 @@ String String::substr(size_t start, size_t len) const
 void String::lowerCase()
 {
     if (stringlen == 0) return;
+    if (localeMapsAsciiCase() && AsciiLowerCase(ptr, stringlen) == stringlen) return;
     // Wir wandeln den String zunächst nach Unicode um
     wchar_t* buffer = (wchar_t*)malloc((stringlen + 1) * sizeof(wchar_t));
     if (!buffer) throw OutOfMemoryException();
@@ -1294,6 +1450,7 @@ void String::lowerCase()
 void String::upperCase()
 {
     if (stringlen == 0) return;
+    if (localeMapsAsciiCase() && AsciiUpperCase(ptr, stringlen) == stringlen) return;
     // Wir wandeln den String zunächst nach Unicode um
     wchar_t* buffer = (wchar_t*)malloc((stringlen + 1) * sizeof(wchar_t));
     if (!buffer) throw OutOfMemoryException();
@@ -1366,21 +1523,11 @@ void String::upperCaseWords()
 void String::trim()
 {
     if (stringlen > 0) {
-        size_t i, start, ende, s;
-        start = 0;
-        s = 0;
-        ende = stringlen;
-        for (i = 0; i < stringlen; i++) {
-            if (ptr[i] == 13 || ptr[i] == 10 || ptr[i] == 32 || ptr[i] == '\t') {
-                if (s == 0) start = i + 1;
-            } else {
-                s = 1;
-                ende = i;
-            }
-        }
-        ptr[ende + 1] = 0;
-        if (start > 0) memmove(ptr, ptr + start, (ende - start + 2));
-        stringlen = strlen(ptr);
+        size_t start = SpanWhitespace(ptr, stringlen);
+        size_t ende = stringlen;
+        if (start < ende) ende -= SpanWhitespaceReverse(ptr + start, stringlen - start);
+        if (start > 0) memmove(ptr, ptr + start, ende - start);
+        stringlen = ende - start;
         ptr[stringlen] = 0;
     }
 }
@@ -1424,20 +1571,11 @@ String String::toUpperCaseWords() const
 void String::trimLeft()
 {
     if (stringlen > 0) {
-        size_t i, start, s;
-        start = 0;
-        s = 0;
-        // ende=stringlen;
-        for (i = 0; i < stringlen; i++) {
-            if (ptr[i] == 13 || ptr[i] == 10 || ptr[i] == 32 || ptr[i] == '\t') {
-                if (s == 0) start = i + 1;
-            } else {
-                s = 1; // ende=i;
-            }
+        size_t start = SpanWhitespace(ptr, stringlen);
+        if (start > 0) {
+            memmove(ptr, ptr + start, (stringlen - start + 1));
+            stringlen -= start;
         }
-        if (start > 0) memmove(ptr, ptr + start, (stringlen - start + 1));
-        stringlen = strlen(ptr);
-        ptr[stringlen] = 0;
     }
 }
 
@@ -1445,17 +1583,7 @@ void String::trimLeft()
 void String::trimRight()
 {
     if (stringlen > 0) {
-        size_t i, ende;
-        ende = 0;
-        for (i = stringlen; i > 0; i--) {
-            char w = ptr[i - 1];
-            if (w != 13 && w != 10 && w != 32 && w != '\t') {
-                ende = i;
-                break;
-            }
-        }
-        ptr[ende] = 0;
-        stringlen = strlen(ptr);
+        stringlen -= SpanWhitespaceReverse(ptr, stringlen);
         ptr[stringlen] = 0;
     }
 }
@@ -1621,8 +1749,8 @@ String String::strchr(char c) const
 {
     String ret;
     if (stringlen > 0) {
-        char* p = ::strchr(ptr, c);
-        if (p) ret.set(p);
+        const char* p = (const char*)memchr(ptr, c, stringlen);
+        if (p) ret.set(p, stringlen - (p - ptr));
     }
     return ret;
 }
@@ -1659,8 +1787,8 @@ String String::strstr(const String& needle) const
     String ret;
     if (stringlen > 0) {
         if (needle.len() == 0) return *this;
-        char* p = ::strstr(ptr, needle.ptr);
-        if (p) ret.set(p);
+        const char* p = MemFind(ptr, stringlen, needle.ptr, needle.stringlen);
+        if (p) ret.set(p, stringlen - (p - ptr));
     }
     return ret;
 }
@@ -1690,12 +1818,12 @@ ssize_t String::find(const String& needle, ssize_t start) const
     // Length of the string to search for
     size_t lstr = needle.stringlen;
     // Current position to search from and position of found string
-    char *found = NULL, *tmp = NULL;
+    const char *found = NULL, *tmp = NULL;
 
     // Search forward
     if (start >= 0) {
         // Search first occurence, starting at the given position...
-        found = ::strstr(ptr + start, needle.ptr);
+        found = MemFind(ptr + start, stringlen - start, needle.ptr, lstr);
         //...and calculate the position to return if str was found
         if (found != NULL) {
             p = found - ptr;
@@ -1708,8 +1836,11 @@ ssize_t String::find(const String& needle, ssize_t start) const
         /* Beginning at the start of the contained string, start searching for
                every occurence of the str and make it the position last found as long
                as the found string doesn't exceed the defined end of the search */
-        while ((found = ::strstr((tmp == NULL ? ptr : tmp + 1), needle.ptr)) != NULL && found - ptr + lstr <= stringlen + start)
+        const char* from = ptr;
+        while ((found = MemFind(from, stringlen - (from - ptr), needle.ptr, lstr)) != NULL && found - ptr + lstr <= stringlen + start) {
             tmp = found;
+            from = found + 1;
+        }
 
         // Calculate the position to return if str was found
         if (tmp != NULL) {
@@ -1762,7 +1893,7 @@ ssize_t String::instr(const String& needle, size_t start) const
     if (needle.stringlen == 0) return 0;
     if (start >= stringlen) return -1;
     const char* p;
-    p = ::strstr((ptr + start), needle.ptr);
+    p = MemFind(ptr + start, stringlen - start, needle.ptr, needle.stringlen);
     if (p != NULL) {
         return ((ssize_t)(p - ptr));
     }
@@ -1861,7 +1992,7 @@ String& String::repeat(size_t num)
 #endif
         tmp += stringlen;
     }
-    free(ptr);
+    releaseBuffer();
     ptr = buf;
     stringlen = stringlen * num;
     ptr[stringlen] = 0;
@@ -1890,7 +2021,7 @@ String& String::repeat(char code, size_t num)
     if (!buf) throw OutOfMemoryException();
     for (size_t i = 0; i < num; i++)
         buf[i] = code;
-    if (ptr != empty_string) free(ptr);
+    releaseBuffer();
     ptr = buf;
     stringlen = num;
     ptr[stringlen] = 0;
@@ -1930,7 +2061,7 @@ String& String::repeat(const String& str, size_t num)
 #endif
         tmp += str.stringlen;
     }
-    if (ptr != empty_string) free(ptr);
+    releaseBuffer();
     ptr = buf;
     stringlen = num * str.stringlen;
     ptr[stringlen] = 0;
@@ -1960,22 +2091,26 @@ String& String::replace(const String& search, const String& replacement)
 //! \brief Ersetzt einen Teilstring durch einen anderen
 {
     if (stringlen == 0 || search.stringlen == 0) return *this;
-    size_t start = 0, slen = search.stringlen;
-    ssize_t end;
+    const char* start = ptr;
+    const char* end = ptr + stringlen;
+    const char* found;
     // collect the result
     String ms;
     // Do while str is found in the contained string
-    while ((end = find(search, start)) >= 0) {
+    while ((found = MemFind(start, end - start, search.ptr, search.stringlen)) != NULL) {
         // The result is built from the parts that don't match str and the replacement string
-        ms += mid(start, end - start);
-        ms += replacement;
+        ms.append(start, found - start);
+        ms.append(replacement.ptr, replacement.stringlen);
         // New start for search is behind the replaced part
-        start = end + slen;
+        start = found + search.stringlen;
     }
+    // Nothing found, string remains unchanged
+    if (start == ptr) return *this;
     // Add the remaining part of the contained string to the result
-    ms += mid(start);
+    ms.append(start, end - start);
     // The result is assigned to this mstring
-    return set(ms);
+    *this = std::move(ms);
+    return *this;
 }
 
 /*! \brief Schiebt den String nach links
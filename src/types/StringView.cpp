@@ -0,0 +1,436 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: https://github.com/pfedick/pplib
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include "prolog_ppl7.h"
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <ctype.h>
+#include <limits.h>
+
+#include "ppl7.h"
+
+
+namespace ppl7
+{
+
+/*!\class StringView
+ * \ingroup PPLGroupDataTypes
+ * \ingroup PPLGroupStrings
+ * \brief Nicht besitzende Referenz auf einen Teil eines Strings
+ *
+ * \desc
+ * Ein StringView besteht nur aus einem Pointer und einer Länge. Er verweist auf Zeichen, die
+ * einem anderen Objekt gehören, beispielsweise einem String, einem ByteArrayPtr oder einem
+ * Puffer, der gerade geparsed wird. Funktionen wie StringView::mid, StringView::left,
+ * StringView::trimmed oder StringView::getToken liefern daher wieder einen StringView zurück,
+ * ohne Speicher zu allokieren oder Zeichen zu kopieren. Erst StringView::toString oder der
+ * explizite Konstruktor String::String(const StringView&) legen eine Kopie an.
+ * \par
+ * Ein String lässt sich implizit in einen StringView umwandeln, ebenso ein C-String oder ein
+ * std::string. Funktionen, die Schlüssel oder Trennzeichen nur lesen, wie AssocArray::get,
+ * HashAssocArray::get, AssocArrayView::get oder Array::explode, akzeptieren daher einen
+ * StringView und können direkt mit Teilstücken aufgerufen werden.
+ *
+ * \attention Der StringView ist nur so lange gültig, wie der referenzierte Speicher. Wird der
+ * zugrundeliegende String verändert oder gelöscht, zeigt der StringView ins Leere. Der
+ * referenzierte Bereich ist in der Regel nicht mit einem 0-Byte abgeschlossen, StringView::data
+ * darf daher nicht an Funktionen übergeben werden, die einen C-String erwarten.
+ */
+
+/*!\brief Prüft, ob der StringView eine Zahl enthält
+ *
+ * \desc
+ * Liefert \c true zurück, wenn der StringView nur aus Ziffern, einem optionalen Minus am Anfang
+ * und höchstens einem Punkt oder Komma besteht. Das Verhalten ist identisch mit
+ * String::isNumeric.
+ */
+bool StringView::isNumeric() const
+{
+    if (!stringlen) return false;
+    size_t dotcount = 0;
+    for (size_t i = 0; i < stringlen; i++) {
+        int c = ptr[i];
+        if (c < '0' || c > '9') {
+            if (c != '.' && c != ',' && c != '-') return false;
+            if (c == '-' && i > 0) return false;
+            if (c == '.' || c == ',') {
+                dotcount++;
+                if (dotcount > 1) return false;
+            }
+        }
+    }
+    if (ptr[stringlen - 1] == '.') return false;
+    return true;
+}
+
+/*!\brief Prüft, ob der StringView eine Ganzzahl enthält
+ *
+ * \desc
+ * Liefert \c true zurück, wenn der StringView nur aus Ziffern und einem optionalen Minus
+ * am Anfang besteht.
+ */
+bool StringView::isInteger() const
+{
+    if (!stringlen) return false;
+    for (size_t i = 0; i < stringlen; i++) {
+        int c = ptr[i];
+        if (c < '0' || c > '9') {
+            if (c == '-' && i == 0) continue;
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!\brief Zeichen am Anfang entfernen
+ *
+ * \desc
+ * Verschiebt den Anfang des StringView um \p num Zeichen nach rechts. Ist \p num größer als
+ * der StringView, ist er anschließend leer.
+ */
+void StringView::chopLeft(size_t num) noexcept
+{
+    if (num > stringlen) num = stringlen;
+    ptr += num;
+    stringlen -= num;
+}
+
+/*!\brief Zeichen am Ende entfernen
+ *
+ * \desc
+ * Verkürzt den StringView um \p num Zeichen. Ist \p num größer als der StringView, ist er
+ * anschließend leer.
+ */
+void StringView::chopRight(size_t num) noexcept
+{
+    if (num > stringlen) num = stringlen;
+    stringlen -= num;
+}
+
+/*!\brief Leerzeichen am Anfang und Ende ignorieren
+ *
+ * \desc
+ * Liefert einen StringView zurück, bei dem Leerzeichen, Tabs, Returns und Linefeeds am Anfang
+ * und Ende nicht enthalten sind.
+ */
+StringView StringView::trimmed() const
+{
+    size_t start = SpanWhitespace(ptr, stringlen);
+    if (start == stringlen) return StringView(ptr + stringlen, 0);
+    return StringView(ptr + start, stringlen - start - SpanWhitespaceReverse(ptr + start, stringlen - start));
+}
+
+/*!\brief Leerzeichen am Anfang ignorieren
+ *
+ * \desc
+ * Liefert einen StringView zurück, bei dem Leerzeichen, Tabs, Returns und Linefeeds am Anfang
+ * nicht enthalten sind.
+ */
+StringView StringView::trimmedLeft() const
+{
+    size_t start = SpanWhitespace(ptr, stringlen);
+    return StringView(ptr + start, stringlen - start);
+}
+
+/*!\brief Leerzeichen am Ende ignorieren
+ *
+ * \desc
+ * Liefert einen StringView zurück, bei dem Leerzeichen, Tabs, Returns und Linefeeds am Ende
+ * nicht enthalten sind.
+ */
+StringView StringView::trimmedRight() const
+{
+    return StringView(ptr, stringlen - SpanWhitespaceReverse(ptr, stringlen));
+}
+
+/*! \brief Sucht nach einem String
+ *
+ * \desc
+ * Diese Funktion sucht nach \p needle ab der Position \p start.
+ *
+ * \return Liefert die Position innerhalb des StringView, an der \p needle gefunden wurde
+ * oder -1, wenn er nicht enthalten ist. Ist \p needle leer, liefert die Funktion 0 zurück.
+ */
+ssize_t StringView::instr(const StringView& needle, size_t start) const
+{
+    if (stringlen == 0) return -1;
+    if (needle.stringlen == 0) return 0;
+    if (start >= stringlen) return -1;
+    const char* p = MemFind(ptr + start, stringlen - start, needle.ptr, needle.stringlen);
+    if (p) return (ssize_t)(p - ptr);
+    return -1;
+}
+
+/*! \brief Sucht nach einem Zeichen
+ *
+ * \desc
+ * Diese Funktion sucht nach dem Zeichen \p c ab der Position \p start.
+ *
+ * \return Liefert die Position des Zeichens oder -1, wenn es nicht enthalten ist.
+ */
+ssize_t StringView::instr(char c, size_t start) const
+{
+    if (start >= stringlen) return -1;
+    const char* p = (const char*)memchr(ptr + start, c, stringlen - start);
+    if (p) return (ssize_t)(p - ptr);
+    return -1;
+}
+
+/*!\brief Prüft, ob \p needle enthalten ist
+ */
+bool StringView::has(const StringView& needle) const
+{
+    if (stringlen == 0 || needle.stringlen == 0) return false;
+    return MemFind(ptr, stringlen, needle.ptr, needle.stringlen) != NULL;
+}
+
+/*!\brief Prüft, ob der StringView mit \p prefix beginnt
+ */
+bool StringView::startsWith(const StringView& prefix) const noexcept
+{
+    if (prefix.stringlen > stringlen) return false;
+    return memcmp(ptr, prefix.ptr, prefix.stringlen) == 0;
+}
+
+/*!\brief Prüft, ob der StringView mit \p suffix endet
+ */
+bool StringView::endsWith(const StringView& suffix) const noexcept
+{
+    if (suffix.stringlen > stringlen) return false;
+    return memcmp(ptr + stringlen - suffix.stringlen, suffix.ptr, suffix.stringlen) == 0;
+}
+
+/*!\brief Vergleich mit einem anderen StringView
+ *
+ * \return Ist dieser StringView kleiner als \p other, wird ein negativer Wert zurückgegeben,
+ * ist er größer, ein positiver, sind beide identisch, wird 0 zurückgegeben.
+ */
+int StringView::strcmp(const StringView& other) const noexcept
+{
+    size_t l = stringlen < other.stringlen ? stringlen : other.stringlen;
+    int cmp = memcmp(ptr, other.ptr, l);
+    if (cmp != 0) return cmp;
+    if (stringlen < other.stringlen) return -1;
+    if (stringlen > other.stringlen) return 1;
+    return 0;
+}
+
+/*!\brief Vergleich mit einem anderen StringView ohne Berücksichtigung der Gross-/Kleinschreibung
+ *
+ * \desc
+ * Die Zeichen werden wie bei der C-Funktion strcasecmp einzeln mit tolower umgewandelt.
+ *
+ * \return Ist dieser StringView kleiner als \p other, wird ein negativer Wert zurückgegeben,
+ * ist er größer, ein positiver, sind beide identisch, wird 0 zurückgegeben.
+ */
+int StringView::strCaseCmp(const StringView& other) const noexcept
+{
+    size_t l = stringlen < other.stringlen ? stringlen : other.stringlen;
+    for (size_t i = 0; i < l; i++) {
+        int c1 = tolower((unsigned char)ptr[i]);
+        int c2 = tolower((unsigned char)other.ptr[i]);
+        if (c1 != c2) return c1 - c2;
+    }
+    if (stringlen < other.stringlen) return -1;
+    if (stringlen > other.stringlen) return 1;
+    return 0;
+}
+
+/*!\brief Nächstes Token abtrennen
+ *
+ * \desc
+ * Liefert in \p token den Teil bis zum nächsten Vorkommen von \p delimiter zurück und
+ * entfernt ihn zusammen mit dem Trennzeichen vom Anfang des StringView. Ist \p delimiter
+ * nicht mehr enthalten, wird der komplette Rest als Token zurückgegeben. Damit lässt sich
+ * ein Text ohne jede Allokation zerlegen:
+ * \code
+ * ppl7::StringView rest(text), line;
+ * while (rest.getToken("\n", line)) {
+ *     ...
+ * }
+ * \endcode
+ *
+ * \return Liefert \c false zurück, wenn der StringView bereits leer war. Endet der Text mit
+ * dem Trennzeichen, wird daher kein abschließendes leeres Token geliefert.
+ */
+bool StringView::getToken(const StringView& delimiter, StringView& token)
+{
+    if (stringlen == 0) return false;
+    const char* p = NULL;
+    if (delimiter.stringlen > 0) p = MemFind(ptr, stringlen, delimiter.ptr, delimiter.stringlen);
+    if (!p) {
+        token = *this;
+        ptr += stringlen;
+        stringlen = 0;
+        return true;
+    }
+    token = StringView(ptr, p - ptr);
+    chopLeft((p - ptr) + delimiter.stringlen);
+    return true;
+}
+
+/*!\brief StringView anhand eines Trennzeichens zerlegen
+ *
+ * \desc
+ * Arbeitet wie Array::explode, die einzelnen Teile werden jedoch als StringView an den Vektor
+ * \p result angehangen. Wird derselbe Vektor wiederverwendet, erfolgt nach kurzer Zeit keine
+ * Allokation mehr.
+ *
+ * @param result Vektor, an den die Teile angehangen werden
+ * @param delimiter Trennzeichen oder -string
+ * @param limit Maximale Anzahl Teile, 0=unbegrenzt
+ * @param skipemptylines Leere Teile werden übersprungen, wenn \c true
+ * @return Anzahl hinzugefügter Teile
+ */
+size_t StringView::explode(std::vector<StringView>& result, const StringView& delimiter, size_t limit, bool skipemptylines) const
+{
+    if (stringlen == 0 || delimiter.stringlen == 0) return 0;
+    size_t count = 0;
+    const char* etext = ptr;
+    const char* end = ptr + stringlen;
+    while (1) {
+        const char* p = MemFind(etext, end - etext, delimiter.ptr, delimiter.stringlen);
+        if (p) {
+            if (p == etext && skipemptylines == true) {
+                etext += delimiter.stringlen;
+                continue;
+            }
+            if (limit > 0 && count >= limit) return count;
+            result.push_back(StringView(etext, p - etext));
+            etext = p + delimiter.stringlen;
+            count++;
+        } else {
+            if (skipemptylines == false || etext < end) {
+                if (limit == 0 || count < limit) {
+                    result.push_back(StringView(etext, end - etext));
+                    count++;
+                }
+            }
+            return count;
+        }
+    }
+}
+
+/*!\brief Kopie als String
+ */
+String StringView::toString() const
+{
+    return String(ptr, stringlen);
+}
+
+/*!\brief Kopie als std::string
+ */
+std::string StringView::toStdString() const
+{
+    return std::string(ptr, stringlen);
+}
+
+/*!\brief In eine Ganzzahl umwandeln
+ *
+ * \desc
+ * Die Umwandlung entspricht der C-Funktion strtoll mit Basis 10: führende Leerzeichen werden
+ * übersprungen, die Umwandlung endet am ersten Zeichen, das keine Ziffer ist, und Werte
+ * ausserhalb des Wertebereichs werden auf den kleinsten oder größten Wert begrenzt.
+ */
+int64_t StringView::toInt64() const
+{
+    size_t i = 0;
+    while (i < stringlen && isspace((unsigned char)ptr[i])) i++;
+    bool negative = false;
+    if (i < stringlen && (ptr[i] == '-' || ptr[i] == '+')) {
+        negative = (ptr[i] == '-');
+        i++;
+    }
+    uint64_t value = 0;
+    const uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    for (; i < stringlen && ptr[i] >= '0' && ptr[i] <= '9'; i++) {
+        unsigned int digit = ptr[i] - '0';
+        if (value > (limit - digit) / 10) return negative ? INT64_MIN : INT64_MAX;
+        value = value * 10 + digit;
+    }
+    if (negative) return (int64_t)(0 - value);
+    return (int64_t)value;
+}
+
+int StringView::toInt() const
+{
+    return (int)toInt64();
+}
+
+long long StringView::toLongLong() const
+{
+    return (long long)toInt64();
+}
+
+/*!\brief In eine Fliesskommazahl umwandeln
+ *
+ * \desc
+ * Da der StringView nicht mit einem 0-Byte abgeschlossen ist, wird er für die Umwandlung
+ * mit atof in einen Puffer auf dem Stack kopiert. Nur sehr lange Zahlen erfordern eine Kopie
+ * auf dem Heap.
+ */
+double StringView::toDouble() const
+{
+    if (!stringlen) return 0.0;
+    char buffer[64];
+    if (stringlen < sizeof(buffer)) {
+        memcpy(buffer, ptr, stringlen);
+        buffer[stringlen] = 0;
+        return atof(buffer);
+    }
+    return toString().toDouble();
+}
+
+/*!\brief Prüft, ob der StringView "wahr" ist
+ *
+ * \desc
+ * Liefert wie String::isTrue \c true zurück, wenn der StringView eine Zahl ungleich 0 oder
+ * eines der Worte "true", "wahr", "ja", "yes" oder "t" enthält.
+ */
+bool StringView::toBool() const
+{
+    if (!stringlen) return false;
+    if (toInt64() != 0) return true;
+    if (strCaseCmp("true") == 0) return true;
+    if (strCaseCmp("wahr") == 0) return true;
+    if (strCaseCmp("ja") == 0) return true;
+    if (strCaseCmp("yes") == 0) return true;
+    if (strCaseCmp("t") == 0) return true;
+    return false;
+}
+
+
+}	// EOF namespace ppl7
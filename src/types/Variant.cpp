@@ -36,16 +36,26 @@
 #include <ppl7/types/widestring.h>
 #include <ppl7/types/array.h>
 #include <ppl7/types/assocarray.h>
+#include <ppl7/types/hashassocarray.h>
 #include <ppl7/types/datetime.h>
 #include <ppl7/exceptions.h>
 
 namespace ppl7
 {
 
+template<class T> static inline void destroy(void* value, bool arena)
+{
+    if (arena)
+        static_cast<T*>(value)->~T();
+    else
+        delete static_cast<T*>(value);
+}
+
 Variant::Variant()
 {
     value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
 }
 
 Variant::~Variant()
@@ -57,6 +67,7 @@ Variant::Variant(const Variant& other)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(other);
 }
 
@@ -64,14 +75,17 @@ Variant::Variant(Variant&& other)
 {
     value = other.value;
     t = other.t;
+    arena = other.arena;
     other.value = nullptr;
     other.t = TYPE_UNKNOWN;
+    other.arena = false;
 }
 
 Variant::Variant(const String& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 
@@ -79,6 +93,7 @@ Variant::Variant(const WideString& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 
@@ -86,6 +101,7 @@ Variant::Variant(const Array& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 
@@ -93,6 +109,15 @@ Variant::Variant(const AssocArray& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
+    set(value);
+}
+
+Variant::Variant(const HashAssocArray& value)
+{
+    this->value = nullptr;
+    t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 
@@ -100,6 +125,7 @@ Variant::Variant(const ByteArray& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 
@@ -107,6 +133,7 @@ Variant::Variant(const ByteArrayPtr& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 
@@ -114,6 +141,7 @@ Variant::Variant(const DateTime& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 
@@ -122,37 +150,56 @@ void Variant::clear()
     if (!value) return;
     switch (t) {
     case TYPE_STRING:
-        delete (static_cast<String*>(value));
+        destroy<String>(value, arena);
         break;
     case TYPE_ASSOCARRAY:
-        delete (static_cast<AssocArray*>(value));
+        destroy<AssocArray>(value, arena);
         break;
     case TYPE_BYTEARRAY:
-        delete (static_cast<ByteArray*>(value));
+        destroy<ByteArray>(value, arena);
         break;
     case TYPE_POINTER:
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-        delete (static_cast<Pointer*>(value));
+        destroy<Pointer>(value, arena);
 #pragma GCC diagnostic pop
         break;
     case TYPE_WIDESTRING:
-        delete (static_cast<WideString*>(value));
+        destroy<WideString>(value, arena);
         break;
     case TYPE_ARRAY:
-        delete (static_cast<Array*>(value));
+        destroy<Array>(value, arena);
         break;
     case TYPE_DATETIME:
-        delete (static_cast<DateTime*>(value));
+        destroy<DateTime>(value, arena);
         break;
     case TYPE_BYTEARRAYPTR:
-        delete (static_cast<ByteArrayPtr*>(value));
+        destroy<ByteArrayPtr>(value, arena);
+        break;
+    case TYPE_HASHASSOCARRAY:
+        destroy<HashAssocArray>(value, arena);
         break;
     default:
         break;
     }
     value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
+}
+
+/*!\brief Inhalt übernehmen
+ *
+ * \desc
+ * Übernimmt das bereits konstruierte Objekt \p value vom Typ \p type, ohne es zu kopieren.
+ * Ist \p arena \c true, liegt das Objekt in einer MemoryArena und es wird beim Löschen nur
+ * der Destruktor aufgerufen. Wird von AssocArray verwendet.
+ */
+void Variant::adopt(DataType type, void* value, bool arena)
+{
+    clear();
+    this->value = value;
+    t = type;
+    this->arena = arena;
 }
 
 void Variant::set(const Variant& value)
@@ -195,6 +242,10 @@ void Variant::set(const Variant& value)
         this->value = new ByteArrayPtr(*static_cast<ByteArrayPtr*>(value.value));
         t = TYPE_BYTEARRAYPTR;
         break;
+    case TYPE_HASHASSOCARRAY:
+        this->value = new HashAssocArray(*static_cast<HashAssocArray*>(value.value));
+        t = TYPE_HASHASSOCARRAY;
+        break;
     default:
         break;
     }
@@ -228,6 +279,13 @@ void Variant::set(const AssocArray& value)
     t = TYPE_ASSOCARRAY;
 }
 
+void Variant::set(const HashAssocArray& value)
+{
+    clear();
+    this->value = new HashAssocArray(value);
+    t = TYPE_HASHASSOCARRAY;
+}
+
 void Variant::set(const ByteArray& value)
 {
     clear();
@@ -279,6 +337,12 @@ bool Variant::isAssocArray() const
     return false;
 }
 
+bool Variant::isHashAssocArray() const
+{
+    if (t == TYPE_HASHASSOCARRAY) return true;
+    return false;
+}
+
 bool Variant::isByteArray() const
 {
     if (t == TYPE_BYTEARRAY) return true;
@@ -354,6 +418,20 @@ AssocArray& Variant::toAssocArray()
     return *static_cast<AssocArray*>(value);
 }
 
+const HashAssocArray& Variant::toHashAssocArray() const
+{
+    if (!value) throw EmptyDataException();
+    if (t != TYPE_HASHASSOCARRAY) throw TypeConversionException();
+    return *static_cast<HashAssocArray*>(value);
+}
+
+HashAssocArray& Variant::toHashAssocArray()
+{
+    if (!value) throw EmptyDataException();
+    if (t != TYPE_HASHASSOCARRAY) throw TypeConversionException();
+    return *static_cast<HashAssocArray*>(value);
+}
+
 const ByteArray& Variant::toByteArray() const
 {
     if (!value) throw EmptyDataException();
@@ -461,6 +539,12 @@ Variant& Variant::operator=(const AssocArray& other)
     return *this;
 }
 
+Variant& Variant::operator=(const HashAssocArray& other)
+{
+    set(other);
+    return *this;
+}
+
 Variant& Variant::operator=(const ByteArray& other)
 {
     set(other);
@@ -502,6 +586,8 @@ bool Variant::operator==(const Variant& other) const
         return (*static_cast<DateTime*>(value) == *static_cast<DateTime*>(other.value));
     case TYPE_BYTEARRAYPTR:
         return (*static_cast<ByteArrayPtr*>(value) == *static_cast<ByteArrayPtr*>(other.value));
+    case TYPE_HASHASSOCARRAY:
+        return (*static_cast<HashAssocArray*>(value) == *static_cast<HashAssocArray*>(other.value));
     default:
         break;
     }
@@ -522,6 +608,7 @@ Variant::Variant(const Pointer& value)
 {
     this->value = nullptr;
     t = TYPE_UNKNOWN;
+    arena = false;
     set(value);
 }
 void Variant::set(const Pointer& value)
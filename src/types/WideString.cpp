@@ -76,6 +76,16 @@ namespace ppl7
 
 static size_t InitialBuffersize = 128;
 
+/*
+ * ASCII-Zeichen werden ohne Aufruf von towlower/towupper umgewandelt. Das ist nur zulässig,
+ * wenn die aktive Lokalisierung die Buchstaben A-Z genauso abbildet wie ASCII, was z.B. bei
+ * "tr_TR" nicht der Fall ist.
+ */
+static inline bool localeMapsAsciiCase()
+{
+    return towlower(L'I') == L'i' && towupper(L'i') == L'I';
+}
+
 /*!\class WideString
  * \ingroup PPLGroupDataTypes
  * \ingroup PPLGroupStrings
@@ -828,8 +838,9 @@ WideString& WideString::append(const wchar_t* str, size_t size)
     }
     size_t inchars;
     if (size != (size_t)-1) {
-        inchars = size;
-        if (inchars > wcslen(str)) inchars = wcslen(str);
+        // str doesn't need to be terminated, so we must not use wcslen here
+        const wchar_t* end = wmemchr(str, 0, size);
+        inchars = (end != NULL) ? (size_t)(end - str) : size;
     } else
         inchars = wcslen(str);
     size_t outbytes = (inchars + stringlen) * sizeof(wchar_t) + 4;
@@ -1793,7 +1804,9 @@ WideString WideString::substr(size_t start, size_t len) const
 void WideString::lowerCase()
 {
     if (ptr != NULL && stringlen > 0) {
-        for (size_t i = 0; i < stringlen; i++) {
+        size_t i = 0;
+        if (localeMapsAsciiCase()) i = AsciiLowerCase(ptr, stringlen);
+        for (; i < stringlen; i++) {
             wchar_t wc = ptr[i];
             wchar_t c = towlower(wc);
             if (c != (wchar_t)WEOF) {
@@ -1824,7 +1837,9 @@ void WideString::lowerCase()
 void WideString::upperCase()
 {
     if (ptr != NULL && stringlen > 0) {
-        for (size_t i = 0; i < stringlen; i++) {
+        size_t i = 0;
+        if (localeMapsAsciiCase()) i = AsciiUpperCase(ptr, stringlen);
+        for (; i < stringlen; i++) {
             wchar_t wc = ptr[i];
             wchar_t c = towupper(wc);
             if (c != (wchar_t)WEOF) {
@@ -1865,21 +1880,11 @@ void WideString::upperCaseWords()
 void WideString::trim()
 {
     if (ptr != NULL && stringlen > 0) {
-        size_t i, start, ende, s;
-        start = 0;
-        s = 0;
-        ende = stringlen;
-        for (i = 0; i < stringlen; i++) {
-            if (ptr[i] == 13 || ptr[i] == 10 || ptr[i] == 32 || ptr[i] == '\t') {
-                if (s == 0) start = i + 1;
-            } else {
-                s = 1;
-                ende = i;
-            }
-        }
-        ptr[ende + 1] = 0;
-        if (start > 0) memmove(ptr, ptr + start, (ende - start + 2) * sizeof(wchar_t));
-        stringlen = wcslen(ptr);
+        size_t start = SpanWhitespace(ptr, stringlen);
+        size_t ende = stringlen;
+        if (start < ende) ende -= SpanWhitespaceReverse(ptr + start, stringlen - start);
+        if (start > 0) wmemmove(ptr, ptr + start, ende - start);
+        stringlen = ende - start;
         ptr[stringlen] = 0;
     }
 }
@@ -1888,20 +1893,11 @@ void WideString::trim()
 void WideString::trimLeft()
 {
     if (ptr != NULL && stringlen > 0) {
-        size_t i, start, s;
-        start = 0;
-        s = 0;
-        // ende=stringlen;
-        for (i = 0; i < stringlen; i++) {
-            if (ptr[i] == 13 || ptr[i] == 10 || ptr[i] == 32 || ptr[i] == '\t') {
-                if (s == 0) start = i + 1;
-            } else {
-                s = 1; // ende=i;
-            }
+        size_t start = SpanWhitespace(ptr, stringlen);
+        if (start > 0) {
+            wmemmove(ptr, ptr + start, stringlen - start + 1);
+            stringlen -= start;
         }
-        if (start > 0) memmove(ptr, ptr + start, (stringlen - start + 1) * sizeof(wchar_t));
-        stringlen = wcslen(ptr);
-        ptr[stringlen] = 0;
     }
 }
 
@@ -1909,17 +1905,7 @@ void WideString::trimLeft()
 void WideString::trimRight()
 {
     if (ptr != NULL && stringlen > 0) {
-        size_t i, ende;
-        ende = 0;
-        for (i = stringlen; i > 0; i--) {
-            wchar_t w = ptr[i - 1];
-            if (w != 13 && w != 10 && w != 32 && w != '\t') {
-                ende = i;
-                break;
-            }
-        }
-        ptr[ende] = 0;
-        stringlen = wcslen(ptr);
+        stringlen -= SpanWhitespaceReverse(ptr, stringlen);
         ptr[stringlen] = 0;
     }
 }
@@ -2085,8 +2071,8 @@ WideString WideString::strchr(wchar_t c) const
 {
     WideString ret;
     if (ptr != NULL && stringlen > 0) {
-        wchar_t* p = wcschr(ptr, c);
-        if (p) ret.set(p);
+        const wchar_t* p = wmemchr(ptr, c, stringlen);
+        if (p) ret.set(p, stringlen - (p - ptr));
     }
     return ret;
 }
@@ -2123,8 +2109,8 @@ WideString WideString::strstr(const WideString& needle) const
     WideString ret;
     if (ptr != NULL && stringlen > 0) {
         if (needle.len() == 0) return *this;
-        wchar_t* p = wcsstr(ptr, needle.ptr);
-        if (p) ret.set(p);
+        const wchar_t* p = MemFind(ptr, stringlen, needle.ptr, needle.stringlen);
+        if (p) ret.set(p, stringlen - (p - ptr));
     }
     return ret;
 }
@@ -2154,12 +2140,12 @@ ssize_t WideString::find(const WideString& needle, ssize_t start) const
     // Length of the string to search for
     size_t lstr = needle.stringlen;
     // Current position to search from and position of found string
-    wchar_t *found = NULL, *tmp = NULL;
+    const wchar_t *found = NULL, *tmp = NULL;
 
     // Search forward
     if (start >= 0) {
         // Search first occurence, starting at the given position...
-        found = wcsstr(ptr + start, needle.ptr);
+        found = MemFind(ptr + start, stringlen - start, needle.ptr, lstr);
         //...and calculate the position to return if str was found
         if (found != NULL) {
             p = found - ptr;
@@ -2172,8 +2158,11 @@ ssize_t WideString::find(const WideString& needle, ssize_t start) const
         /* Beginning at the start of the contained string, start searching for
                every occurence of the str and make it the position last found as long
                as the found string doesn't exceed the defined end of the search */
-        while ((found = wcsstr((tmp == NULL ? ptr : tmp + 1), needle.ptr)) != NULL && found - ptr + lstr <= stringlen + start)
+        const wchar_t* from = ptr;
+        while ((found = MemFind(from, stringlen - (from - ptr), needle.ptr, lstr)) != NULL && found - ptr + lstr <= stringlen + start) {
             tmp = found;
+            from = found + 1;
+        }
 
         // Calculate the position to return if str was found
         if (tmp != NULL) {
@@ -2226,7 +2215,7 @@ ssize_t WideString::instr(const WideString& needle, size_t start) const
     if (needle.stringlen == 0) return 0;
     if (start >= stringlen) return -1;
     const wchar_t* p;
-    p = wcsstr((ptr + start), needle.ptr);
+    p = MemFind(ptr + start, stringlen - start, needle.ptr, needle.stringlen);
     if (p != NULL) {
         return ((ssize_t)(p - ptr));
     }
@@ -2395,22 +2384,26 @@ WideString& WideString::replace(const WideString& search, const WideString& repl
 //! \brief Ersetzt einen Teilstring durch einen anderen
 {
     if (ptr == NULL || stringlen == 0 || search.ptr == NULL || search.stringlen == 0) return *this;
-    size_t start = 0, slen = search.stringlen;
-    ssize_t end;
+    const wchar_t* start = ptr;
+    const wchar_t* end = ptr + stringlen;
+    const wchar_t* found;
     // collect the result
     WideString ms;
     // Do while str is found in the contained string
-    while ((end = find(search, start)) >= 0) {
+    while ((found = MemFind(start, end - start, search.ptr, search.stringlen)) != NULL) {
         // The result is built from the parts that don't match str and the replacement string
-        ms += mid(start, end - start);
-        ms += replacement;
+        ms.append(start, found - start);
+        if (replacement.stringlen > 0) ms.append(replacement.ptr, replacement.stringlen);
         // New start for search is behind the replaced part
-        start = end + slen;
+        start = found + search.stringlen;
     }
+    // Nothing found, string remains unchanged
+    if (start == ptr) return *this;
     // Add the remaining part of the contained string to the result
-    ms += mid(start);
+    ms.append(start, end - start);
     // The result is assigned to this mstring
-    return set(ms);
+    *this = std::move(ms);
+    return *this;
 }
 
 /*!\brief Kleiner als
@@ -0,0 +1,276 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <ppl7.h>
+#include "ppl7-tests.h"
+
+extern const char *wordlist;
+
+ppl7::Array Wordlist;
+ppl7::ConfigParser PPL7TestConfig;
+ppl7::AssocArray TestAssocArray;
+
+static ppl7::AssocArray MapArray;
+static ppl7::HashAssocArray HashArray;
+static ppl7::AssocArray MapRequest;
+static ppl7::HashAssocArray HashRequest;
+
+static const char *request_keys[]={
+	"method", "uri", "protocol", "header/host", "header/user-agent",
+	"header/accept", "header/content-length", "header/connection",
+	"query/page", "query/limit", "session/id", "session/user/id", NULL
+};
+
+template<class T>
+static void fill_wordlist(T &a)
+{
+	a.clear();
+	size_t wlist_size=Wordlist.size();
+	for (size_t i=0;i<wlist_size;i++) {
+		a.set(Wordlist[i], Wordlist[i]);
+	}
+}
+
+template<class T>
+static void fill_request(T &a)
+{
+	a.clear();
+	for (int i=0;request_keys[i]!=NULL;i++) {
+		a.setf(request_keys[i], "%d", i);
+	}
+}
+
+template<class T>
+static void lookup_wordlist(const T &a)
+{
+	size_t wlist_size=Wordlist.size();
+	size_t found=0;
+	for (int iter=0;iter<5;iter++) {
+		for (size_t i=0;i<wlist_size;i++) {
+			if (a.getString(Wordlist[i]).size()) found++;
+		}
+	}
+	if (found != wlist_size * 5) printf("unexpected result: %zu\n", found);
+}
+
+template<class T>
+static void lookup_request(const T &a)
+{
+	ppl7::Array keys;
+	for (int i=0;request_keys[i]!=NULL;i++) keys.add(request_keys[i]);
+	size_t num=keys.size();
+	long long sum=0;
+	for (int iter=0;iter<200000;iter++) {
+		for (size_t i=0;i<num;i++) {
+			sum+=a.getInt(keys[i]);
+		}
+	}
+	if (sum != 200000LL * (long long)(num * (num - 1) / 2)) printf("unexpected result: %lld\n", sum);
+}
+
+template<class T>
+static void iterate(const T &a)
+{
+	size_t bytes=0;
+	for (int iter=0;iter<20;iter++) {
+		typename T::const_iterator it;
+		for (it=a.begin();it!=a.end();++it) {
+			bytes+=it->second->toString().size();
+		}
+	}
+	if (!bytes) printf("unexpected result\n");
+}
+
+template<class T>
+static void export_binary(const T &a)
+{
+	ppl7::ByteArray bin;
+	for (int iter=0;iter<10;iter++) {
+		a.exportBinary(bin);
+	}
+}
+
+static void map_insert() { fill_wordlist(MapArray); }
+static void hash_insert() { fill_wordlist(HashArray); }
+static void map_lookup() { lookup_wordlist(MapArray); }
+static void hash_lookup() { lookup_wordlist(HashArray); }
+static void map_request() { lookup_request(MapRequest); }
+static void hash_request() { lookup_request(HashRequest); }
+static void map_iterate() { iterate(MapArray); }
+static void hash_iterate() { iterate(HashArray); }
+static void map_export() { export_binary(MapArray); }
+static void hash_export() { export_binary(HashArray); }
+static void map_erase()
+{
+	size_t wlist_size=Wordlist.size();
+	for (size_t i=0;i<wlist_size;i++) MapArray.erase(Wordlist[i]);
+}
+static void hash_erase()
+{
+	size_t wlist_size=Wordlist.size();
+	for (size_t i=0;i<wlist_size;i++) HashArray.erase(Wordlist[i]);
+}
+
+static void build_request_tree(ppl7::AssocArray &a)
+{
+	for (int i=0;i<200;i++) {
+		ppl7::String prefix;
+		prefix.setf("requests/%d/", i);
+		for (int k=0;request_keys[k]!=NULL;k++) {
+			a.setf(prefix+request_keys[k], "%d", k);
+		}
+	}
+}
+
+static void heap_tree()
+{
+	for (int iter=0;iter<20;iter++) {
+		ppl7::AssocArray a;
+		build_request_tree(a);
+	}
+}
+
+static void arena_tree()
+{
+	ppl7::MemoryArena arena;
+	for (int iter=0;iter<20;iter++) {
+		{
+			ppl7::AssocArray a(arena);
+			build_request_tree(a);
+		}
+		arena.clear();
+	}
+}
+
+static ppl7::ByteArray TreeBinary;
+
+static void heap_import()
+{
+	for (int iter=0;iter<20;iter++) {
+		ppl7::AssocArray a;
+		a.importBinary(TreeBinary);
+	}
+}
+
+static ppl7::ByteArray WordlistBinary;
+
+static void import_few_keys()
+{
+	size_t found=0;
+	for (int iter=0;iter<10;iter++) {
+		ppl7::AssocArray a;
+		a.importBinary(WordlistBinary);
+		for (int i=0;i<3;i++) found+=a.getString(Wordlist[i*(Wordlist.size()/3)]).size();
+	}
+	if (!found) printf("unexpected result\n");
+}
+
+static void view_few_keys()
+{
+	size_t found=0;
+	for (int iter=0;iter<10;iter++) {
+		ppl7::AssocArrayView v(WordlistBinary);
+		for (int i=0;i<3;i++) found+=v.getByteArrayPtr(Wordlist[i*(Wordlist.size()/3)]).size();
+	}
+	if (!found) printf("unexpected result\n");
+}
+
+static void arena_import()
+{
+	ppl7::MemoryArena arena;
+	for (int iter=0;iter<20;iter++) {
+		{
+			ppl7::AssocArray a(arena);
+			a.importBinary(TreeBinary);
+		}
+		arena.clear();
+	}
+}
+
+
+double timer(const char *descr, void (*fn)())
+{
+	double start=ppl7::GetMicrotime();
+	fn();
+	double duration=ppl7::GetMicrotime()-start;
+	printf ("%-40s: %0.3f\n",descr, duration);
+	fflush(NULL);
+	return duration;
+}
+
+
+int main (int argc, char**argv)
+{
+	double start=ppl7::GetMicrotime();
+	ppl7::String w(wordlist);
+	Wordlist.reserve(130000);
+	Wordlist.explode(w,"\n");
+	printf ("Wordlist: %zu words\n", Wordlist.size());
+	fill_request(MapRequest);
+	fill_request(HashRequest);
+
+	timer ("AssocArray insert wordlist", map_insert);
+	timer ("HashAssocArray insert wordlist", hash_insert);
+	timer ("AssocArray lookup wordlist x5", map_lookup);
+	timer ("HashAssocArray lookup wordlist x5", hash_lookup);
+	timer ("AssocArray request getInt x200000", map_request);
+	timer ("HashAssocArray request getInt x200000", hash_request);
+	timer ("AssocArray iterate x20", map_iterate);
+	timer ("HashAssocArray iterate x20", hash_iterate);
+	timer ("AssocArray exportBinary x10", map_export);
+	timer ("HashAssocArray exportBinary x10", hash_export);
+	timer ("AssocArray erase wordlist", map_erase);
+	timer ("HashAssocArray erase wordlist", hash_erase);
+
+	ppl7::AssocArray tree;
+	build_request_tree(tree);
+	tree.exportBinary(TreeBinary);
+	timer ("AssocArray build+destroy tree x20", heap_tree);
+	timer ("AssocArray(MemoryArena) tree x20", arena_tree);
+	timer ("AssocArray importBinary x20", heap_import);
+	timer ("AssocArray(MemoryArena) importBinary x20", arena_import);
+
+	fill_wordlist(MapArray);
+	MapArray.exportBinary(WordlistBinary);
+	timer ("AssocArray importBinary+3 keys x10", import_few_keys);
+	timer ("AssocArrayView 3 keys x10", view_few_keys);
+	double duration=ppl7::GetMicrotime()-start;
+	printf ("%-40s: %0.3f\n","Totaltime",duration);
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <math.h>
+#include <ppl7.h>
+#include <ppl7-grafix.h>
+#include "ppl7-tests.h"
+
+/*
+ * Benchmark für die Blitting-Funktionen der 32-Bit-Farbformate. Jede Blit-Art wird
+ * nacheinander mit den skalaren, den SSE4.1- und den AVX2-Implementierungen ausgeführt
+ * (siehe Grafix::setBlitCaps), das Ergebnis wird in Megapixel pro Sekunde ausgegeben.
+ * Varianten, die von der CPU nicht unterstützt werden, werden übersprungen.
+ *
+ * Optionen:
+ *   -w Breite   Breite der Quellgrafik (Default 1021, also keine Vielfache von 8)
+ *   -h Höhe     Höhe der Quellgrafik (Default 767)
+ *   -r Runden   Anzahl Wiederholungen je Messung (Default 20)
+ */
+
+ppl7::ConfigParser PPL7TestConfig;
+
+using ppl7::grafix::Image;
+using ppl7::grafix::Color;
+using ppl7::grafix::RGBFormat;
+
+static int Width=1021;
+static int Height=767;
+static int Rounds=20;
+
+static Image Target, Source, Sprite, Mask, Background;
+
+static void fillRandom(Image& img, uint64_t seed)
+{
+	int bpp=img.rgbformat().bytesPerPixel();
+	for (int y=0;y < img.height();y++) {
+		uint8_t* p=(uint8_t*)img.adr(0, y);
+		for (int x=0;x < img.width() * bpp;x++) {
+			seed=seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			p[x]=(uint8_t)(seed >> 56);
+		}
+	}
+}
+
+// Typische Sprite-Grafik: transparenter Rand, deckendes Inneres und ein weicher Übergang
+static void makeSprite(Image& img)
+{
+	fillRandom(img, 3);
+	int cx=img.width() / 2, cy=img.height() / 2;
+	double rmax=(cx < cy ? cx : cy);
+	for (int y=0;y < img.height();y++) {
+		uint8_t* p=(uint8_t*)img.adr(0, y);
+		for (int x=0;x < img.width();x++) {
+			double d=sqrt((double)(x - cx) * (x - cx) + (double)(y - cy) * (y - cy)) / rmax;
+			int a=(int)((1.2 - d) * 5.0 * 255.0);
+			if (a < 0) a=0;
+			if (a > 255) a=255;
+			if (img.rgbformat() == RGBFormat::A8) p[x]=(uint8_t)a;
+			else p[x * 4 + 3]=(uint8_t)a;
+		}
+	}
+}
+
+static void blt() { Target.blt(Source, 0, 0); }
+static void bltAlpha() { Target.bltAlpha(Sprite, 0, 0); }
+static void bltAlphaRandom() { Target.bltAlpha(Source, 0, 0); }
+static void bltColorKey() { Target.bltColorKey(Source, 0, 0, Color(255, 0, 255, 255)); }
+static void bltDiffuse() { Target.bltDiffuse(Mask, 0, 0, Color(200, 100, 30, 255)); }
+static void bltBlend() { Target.bltBlend(Source, 0.4f, 0, 0); }
+static void bltChromaKey() { Target.bltChromaKey(Source, Color(0, 255, 0, 255), 40, 120, 0, 0); }
+static void bltBackgroundOnChromaKey() { Target.bltBackgroundOnChromaKey(Background, Color(0, 255, 0, 255), 40, 120, 0, 0); }
+
+static void run(ppl7::grafix::Grafix& gfx, const char* descr, void (*fn)())
+{
+	static const uint32_t levels[]={ 0, ppl7::CPUCAPS::CPU_HAVE_SSE41,
+		ppl7::CPUCAPS::CPU_HAVE_SSE41 | ppl7::CPUCAPS::CPU_HAVE_AVX2 };
+	printf("%-28s:", descr);
+	for (auto level : levels) {
+		gfx.setBlitCaps(level);
+		if (gfx.blitCaps() != level) {
+			printf(" %10s", "-");
+			continue;
+		}
+		fillRandom(Target, 1);
+		fn();	// Aufwärmen
+		double start=ppl7::GetMicrotime();
+		for (int i=0;i < Rounds;i++) fn();
+		double duration=ppl7::GetMicrotime() - start;
+		printf(" %10.1f", (double)Width * Height * Rounds / duration / 1000000.0);
+	}
+	printf("\n");
+	fflush(NULL);
+}
+
+int main(int argc, char** argv)
+{
+	if (ppl7::HaveArgv(argc, argv, "-w")) Width=ppl7::GetArgv(argc, argv, "-w").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-h")) Height=ppl7::GetArgv(argc, argv, "-h").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-r")) Rounds=ppl7::GetArgv(argc, argv, "-r").toInt();
+	if (Width < 1 || Height < 1 || Rounds < 1) {
+		printf("Ungültige Parameter\n");
+		return 1;
+	}
+	try {
+		ppl7::grafix::Grafix gfx;
+		uint32_t caps=gfx.blitCaps();
+		Target.create(Width, Height, RGBFormat::A8R8G8B8);
+		Source.create(Width, Height, RGBFormat::A8R8G8B8);
+		Sprite.create(Width, Height, RGBFormat::A8R8G8B8);
+		Mask.create(Width, Height, RGBFormat::A8);
+		Background.create(Width, Height, RGBFormat::A8R8G8B8);
+		fillRandom(Source, 2);
+		makeSprite(Sprite);
+		makeSprite(Mask);
+		fillRandom(Background, 4);
+
+		printf("%d x %d Pixel, %d Runden, CPU-Caps: 0x%08x\n\n", Width, Height, Rounds, ppl7::GetCPUCaps());
+		printf("%-28s  %10s %10s %10s\n", "Megapixel/s", "Skalar", "SSE4.1", "AVX2");
+		run(gfx, "blt", blt);
+		run(gfx, "bltAlpha (Sprite)", bltAlpha);
+		run(gfx, "bltAlpha (Zufall)", bltAlphaRandom);
+		run(gfx, "bltColorKey", bltColorKey);
+		run(gfx, "bltDiffuse", bltDiffuse);
+		run(gfx, "bltBlend", bltBlend);
+		run(gfx, "bltChromaKey", bltChromaKey);
+		run(gfx, "bltBackgroundOnChromaKey", bltBackgroundOnChromaKey);
+		gfx.setBlitCaps(caps);
+	} catch (const ppl7::Exception& exp) {
+		exp.print();
+		return 1;
+	}
+	return 0;
+}
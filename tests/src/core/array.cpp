@@ -547,6 +547,20 @@ TEST_F(ArrayTest, explode) {
 	);
 }
 
+TEST_F(ArrayTest, explodeStringStringViewAndCString) {
+	ppl7::String text("red green blue");
+	ppl7::String delimiter(" ");
+	ppl7::Array a1, a2, a3, a4;
+	a1.explode(text,delimiter);
+	a2.explode(ppl7::StringView(text),ppl7::StringView(delimiter));
+	a3.explode((const char*)text," ");
+	a4.explode(text," ");
+	ASSERT_EQ((size_t)3,a1.count());
+	ASSERT_TRUE(a1 == a2);
+	ASSERT_TRUE(a1 == a3);
+	ASSERT_TRUE(a1 == a4);
+}
+
 TEST_F(ArrayTest, explodeWithEmptyElements) {
 	ASSERT_NO_THROW({
 			ppl7::Array a1;
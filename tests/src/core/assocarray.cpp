@@ -894,6 +894,83 @@ TEST_F(AssocArrayTest, ToTemplate)
 	), out);
 }
 
+TEST_F(AssocArrayTest, WithMemoryArena)
+{
+	ppl7::MemoryArena arena;
+	{
+		ppl7::AssocArray a(arena);
+		ASSERT_EQ(&arena, a.memoryArena());
+		a.set("key1", "value1");
+		a.set("array1/unterkey1", "value2");
+		a.set("array1/noch ein array/unterkey1", "value4");
+		a.set("list/[]", "zero");
+		a.set("list/[]", "one");
+		ppl7::DateTime dt;
+		dt.set(2024, 1, 2, 3, 4, 5);
+		a.set("time", dt);
+		ppl7::AssocArray other;
+		other.set("x/y", "z");
+		a.set("other", other);
+		ASSERT_LT((size_t)0, arena.memoryUsed());
+		ASSERT_EQ(&arena, a.getAssocArray("array1").memoryArena());
+		ASSERT_EQ(&arena, a.getAssocArray("other/x").memoryArena());
+		ASSERT_EQ(ppl7::String("value4"), a.getString("array1/noch ein array/unterkey1"));
+		ASSERT_EQ(ppl7::String("one"), a.getString("list/1"));
+		ASSERT_EQ(ppl7::String("z"), a.getString("other/x/y"));
+		a.set("key1", "replaced");
+		a.erase("array1/unterkey1");
+		ASSERT_EQ(ppl7::String("replaced"), a.getString("key1"));
+		ASSERT_FALSE(a.exists("array1/unterkey1"));
+
+		// Kopien liegen wieder auf dem Heap
+		ppl7::AssocArray copy(a);
+		ASSERT_EQ(NULL, copy.memoryArena());
+		ASSERT_EQ(NULL, copy.getAssocArray("array1").memoryArena());
+		ASSERT_TRUE(copy == a);
+	}
+	arena.clear();
+	ASSERT_EQ((size_t)0, arena.memoryUsed());
+}
+
+TEST_F(AssocArrayTest, ImportBinaryIntoMemoryArena)
+{
+	ppl7::AssocArray a;
+	a.set("key1", "value1");
+	a.set("array1/unterkey1", "value2");
+	a.set("array1/noch ein array/unterkey1", "value4");
+	a.set("array2", ppl7::Array("red green blue", " "));
+	ppl7::ByteArray bin;
+	a.exportBinary(bin);
+
+	ppl7::MemoryArena arena;
+	ppl7::AssocArray b(arena);
+	b.importBinary(bin);
+	ASSERT_TRUE(a == b);
+	ASSERT_EQ(&arena, b.getAssocArray("array1/noch ein array").memoryArena());
+}
+
+TEST_F(AssocArrayTest, GetWithStringStringViewAndCString)
+{
+	ppl7::AssocArray a;
+	a.set("key1", "value1");
+	a.set("number", "42");
+	a.set("array1/unterkey1", "value2");
+	ppl7::String key("key1");
+	ppl7::StringView view("key1");
+	ASSERT_EQ(ppl7::String("value1"), a.getString(key));
+	ASSERT_EQ(ppl7::String("value1"), a.getString(view));
+	ASSERT_EQ(ppl7::String("value1"), a.getString("key1"));
+	ASSERT_EQ(ppl7::String("value1"), a[key].toString());
+	ASSERT_EQ(ppl7::String("value1"), a[view].toString());
+	ASSERT_EQ(ppl7::String("value1"), a["key1"].toString());
+	ASSERT_EQ(42, a.getInt(ppl7::String("number")));
+	ASSERT_EQ(7, a.getInt("missing", 7));
+	ASSERT_TRUE(a.exists(ppl7::String("array1/unterkey1")));
+	ASSERT_FALSE(a.exists("array1/unterkey2"));
+	ASSERT_EQ(ppl7::String("default"), a.getString(ppl7::String("missing"), ppl7::String("default")));
+	ASSERT_THROW(a.get(ppl7::String("missing")), ppl7::KeyNotFoundException);
+}
+
 
 
 
@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <ppl7.h>
+#include <ppl7-inet.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+class AssocArrayViewTest : public ::testing::Test {
+protected:
+	ppl7::AssocArray source;
+	ppl7::ByteArray bin;
+
+	AssocArrayViewTest() {
+		if (setlocale(LC_CTYPE, DEFAULT_LOCALE) == NULL) {
+			printf("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		source.set("key1", "value1");
+		source.set("Number", "12345");
+		source.set("array1/unterkey1", "value2");
+		source.set("array1/unterkey2", "value3");
+		source.set("array1/noch ein array/unterkey1", "value4");
+		source.set("list/[]", "zero");
+		source.set("list/[]", "one");
+		source.set("list/[]", "two");
+		source.set("words", ppl7::Array("red green blue", " "));
+		source.set("binary", ppl7::ByteArrayPtr("\0\1\2\3", 4));
+		ppl7::DateTime dt;
+		dt.set(2024, 1, 2, 3, 4, 5);
+		source.set("time", dt);
+		source.exportBinary(bin);
+	}
+	virtual ~AssocArrayViewTest() {
+
+	}
+};
+
+TEST_F(AssocArrayViewTest, ConstructorSimple) {
+	ppl7::AssocArrayView v;
+	ASSERT_TRUE(v.empty());
+	ASSERT_EQ((size_t)0, v.count());
+	ASSERT_FALSE(v.exists("key1"));
+	ASSERT_TRUE(v.begin() == v.end());
+}
+
+TEST_F(AssocArrayViewTest, ConstructorInvalidBuffer) {
+	ASSERT_THROW(ppl7::AssocArrayView(NULL, 10), ppl7::IllegalArgumentException);
+	ASSERT_THROW(ppl7::AssocArrayView("kein export", 11), ppl7::AssocArrayView::ImportFailedException);
+}
+
+TEST_F(AssocArrayViewTest, GetValues) {
+	ppl7::AssocArrayView v(bin);
+	ASSERT_FALSE(v.empty());
+	ASSERT_EQ(source.count(), v.count());
+	ASSERT_EQ(bin.size(), v.binarySize());
+	ASSERT_EQ(ppl7::String("value1"), v.getString("key1"));
+	ASSERT_EQ(ppl7::String("value1"), v.getString("KEY1"));
+	ASSERT_EQ(ppl7::String("value4"), v.getString("array1/noch ein array/unterkey1"));
+	ASSERT_EQ(ppl7::String("one"), v.getString("list/1"));
+	ASSERT_EQ(ppl7::String("two"), v.getString("list/02"));
+	ASSERT_EQ(12345, v.getInt("number"));
+	ASSERT_EQ(12345LL, v.getLongLong("number"));
+	ASSERT_EQ(7, v.getInt("missing", 7));
+	ASSERT_EQ(ppl7::String("default"), v.getString("array1/missing", "default"));
+	ASSERT_EQ(ppl7::Array("red green blue", " "), v.getArray("words"));
+	ASSERT_EQ(source.get("time").toDateTime(), v.getDateTime("time"));
+	ppl7::ByteArrayPtr ptr=v.getByteArrayPtr("binary");
+	ASSERT_EQ((size_t)4, ptr.size());
+	ASSERT_EQ(0, memcmp(ptr.adr(), "\0\1\2\3", 4));
+}
+
+TEST_F(AssocArrayViewTest, ValuesPointIntoBuffer) {
+	ppl7::AssocArrayView v(bin);
+	ppl7::ByteArrayPtr ptr=v.getByteArrayPtr("array1/unterkey2");
+	ASSERT_TRUE(ptr.adr() >= bin.adr() && (const char*)ptr.adr() < (const char*)bin.adr() + bin.size());
+	ASSERT_EQ(0, memcmp(ptr.adr(), "value3", 6));
+}
+
+TEST_F(AssocArrayViewTest, MissingKeysAndTypes) {
+	ppl7::AssocArrayView v(bin);
+	ASSERT_FALSE(v.exists("nothing"));
+	ASSERT_FALSE(v.exists("key1/sub"));
+	ASSERT_TRUE(v.exists("array1/noch ein array"));
+	ASSERT_THROW(v.getString("nothing"), ppl7::KeyNotFoundException);
+	ASSERT_THROW(v.getString("array1"), ppl7::TypeConversionException);
+	ASSERT_THROW(v.getAssocArray("key1"), ppl7::TypeConversionException);
+	ASSERT_THROW(v.exists(""), ppl7::AssocArrayView::InvalidKeyException);
+}
+
+TEST_F(AssocArrayViewTest, NestedView) {
+	ppl7::AssocArrayView v(bin);
+	ppl7::AssocArrayView sub=v.getAssocArray("array1");
+	ASSERT_EQ((size_t)3, sub.count());
+	ASSERT_EQ(ppl7::String("value2"), sub.getString("unterkey1"));
+	ASSERT_EQ(ppl7::String("value4"), sub.getAssocArray("noch ein array").getString("unterkey1"));
+	ppl7::AssocArray a;
+	a.importBinary(sub.binary());
+	ASSERT_TRUE(a == source.getAssocArray("array1"));
+}
+
+TEST_F(AssocArrayViewTest, Iterate) {
+	ppl7::AssocArrayView v(bin);
+	ppl7::AssocArray::const_iterator sit=source.begin();
+	ppl7::AssocArrayView::const_iterator it;
+	for (it=v.begin();it!=v.end();++it) {
+		ASSERT_TRUE(sit != source.end());
+		ASSERT_EQ(ppl7::String(sit->first), it->key());
+		if (sit->second->isString()) {
+			ASSERT_EQ(sit->second->toString(), it->toString());
+		}
+		++sit;
+	}
+	ASSERT_TRUE(sit == source.end());
+}
+
+TEST_F(AssocArrayViewTest, ToAssocArray) {
+	ppl7::AssocArrayView v(bin);
+	ppl7::AssocArray a;
+	v.toAssocArray(a);
+	ASSERT_TRUE(a == source);
+}
+
+TEST_F(AssocArrayViewTest, TruncatedBuffer) {
+	ppl7::AssocArrayView v(bin.adr(), bin.size() / 2);
+	ASSERT_THROW(v.count(), ppl7::AssocArrayView::ImportFailedException);
+}
+
+TEST_F(AssocArrayViewTest, SocketMessagePayload) {
+	ppl7::SocketMessage msg;
+	msg.setPayload(source);
+	ppl7::AssocArrayView v;
+	msg.getPayload(v);
+	ASSERT_EQ(ppl7::String("value4"), v.getString("array1/noch ein array/unterkey1"));
+}
+
+}	// EOF namespace
@@ -538,6 +538,17 @@ TEST_F(ConfigParserTest, addAndGetString) {
 	});
 }
 
+TEST_F(ConfigParserTest, addAndGetStringView) {
+	ppl7::ConfigParser conf;
+	ASSERT_NO_THROW({
+			conf.load("testdata/example.conf");
+	});
+	ASSERT_THROW({conf.add(ppl7::StringView("key9"),ppl7::StringView("value9"));},ppl7::NoSectionSelectedException);
+	conf.selectSection("section1");
+	ppl7::String line="key9=value9";
+	conf.add(ppl7::StringView(line).left(4),ppl7::StringView(line).mid(5));
+	ASSERT_EQ(ppl7::String("value9"),conf.get("key9"));
+}
 TEST_F(ConfigParserTest, addAndGetStringOtherSection) {
 	ppl7::ConfigParser conf;
 	ASSERT_NO_THROW({
@@ -0,0 +1,160 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <ppl7.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+
+namespace {
+
+class Crc32Test : public ::testing::Test {
+	protected:
+		ppl7::ByteArray data;
+
+		Crc32Test() {
+		if (setlocale(LC_ALL,"C")==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		data.malloc(100000);
+		unsigned char *p=(unsigned char*)data.ptr();
+		uint32_t seed=12345;
+		for (size_t i=0;i<data.size();i++) {
+			seed=seed*1103515245+12345;
+			p[i]=(unsigned char)(seed>>16);
+		}
+	}
+	virtual ~Crc32Test() {
+
+	}
+};
+
+// Bitweise Referenzimplementierungen
+static uint32_t referenceCrc32(const unsigned char *buffer, size_t size)
+{
+	uint32_t crc=0xffffffff;
+	for (size_t i=0;i<size;i++) {
+		crc^=buffer[i];
+		for (int k=0;k<8;k++) crc=(crc&1) ? (crc>>1)^0xedb88320 : crc>>1;
+	}
+	return crc^0xffffffff;
+}
+
+static uint32_t referenceAdler32(const unsigned char *buffer, size_t size)
+{
+	uint32_t s1=1, s2=0;
+	for (size_t i=0;i<size;i++) {
+		s1=(s1+buffer[i])%65521;
+		s2=(s2+s1)%65521;
+	}
+	return (s2<<16)|s1;
+}
+
+TEST_F(Crc32Test, KnownValues) {
+	ASSERT_EQ((uint32_t)0,ppl7::Crc32("",0));
+	ASSERT_EQ((uint32_t)0xcbf43926,ppl7::Crc32("123456789",9));
+	ASSERT_EQ((uint32_t)0x414fa339,ppl7::Crc32("The quick brown fox jumps over the lazy dog",43));
+	ASSERT_EQ((uint32_t)1,ppl7::Adler32("",0));
+	ASSERT_EQ((uint32_t)0x11e60398,ppl7::Adler32("Wikipedia",9));
+}
+
+TEST_F(Crc32Test, AllLengthsAndAlignments) {
+	const unsigned char *p=(const unsigned char*)data.ptr();
+	for (size_t offset=0;offset<16;offset++) {
+		for (size_t size=0;size<=300;size++) {
+			ASSERT_EQ(referenceCrc32(p+offset,size),ppl7::Crc32(p+offset,size)) << "offset=" << offset << ", size=" << size;
+			ASSERT_EQ(referenceAdler32(p+offset,size),ppl7::Adler32(p+offset,size)) << "offset=" << offset << ", size=" << size;
+		}
+	}
+}
+
+TEST_F(Crc32Test, LargeBuffer) {
+	const unsigned char *p=(const unsigned char*)data.ptr();
+	ASSERT_EQ(referenceCrc32(p,data.size()),ppl7::Crc32(p,data.size()));
+	ASSERT_EQ(referenceAdler32(p,data.size()),ppl7::Adler32(p,data.size()));
+	ASSERT_EQ(referenceCrc32(p+3,data.size()-7),ppl7::Crc32(p+3,data.size()-7));
+	ASSERT_EQ(referenceCrc32(p,data.size()),data.crc32());
+}
+
+TEST_F(Crc32Test, Streaming) {
+	const unsigned char *p=(const unsigned char*)data.ptr();
+	uint32_t expected_crc=ppl7::Crc32(p,data.size());
+	uint32_t expected_adler=ppl7::Adler32(p,data.size());
+	size_t chunks[]={1, 7, 63, 64, 65, 4096, 9999};
+	for (size_t c=0;c<sizeof(chunks)/sizeof(size_t);c++) {
+		uint32_t crc=0;
+		uint32_t adler=1;
+		for (size_t pos=0;pos<data.size();pos+=chunks[c]) {
+			size_t size=data.size()-pos;
+			if (size>chunks[c]) size=chunks[c];
+			crc=ppl7::Crc32(crc,p+pos,size);
+			adler=ppl7::Adler32(adler,p+pos,size);
+		}
+		ASSERT_EQ(expected_crc,crc) << "chunk=" << chunks[c];
+		ASSERT_EQ(expected_adler,adler) << "chunk=" << chunks[c];
+	}
+	ASSERT_EQ(expected_crc,ppl7::Crc32(expected_crc,NULL,100));
+}
+
+TEST_F(Crc32Test, Combine) {
+	const unsigned char *p=(const unsigned char*)data.ptr();
+	uint32_t expected_crc=ppl7::Crc32(p,data.size());
+	uint32_t expected_adler=ppl7::Adler32(p,data.size());
+	size_t splits[]={0, 1, 100, 65521, 65522, 99999, 100000};
+	for (size_t s=0;s<sizeof(splits)/sizeof(size_t);s++) {
+		size_t size1=splits[s];
+		size_t size2=data.size()-size1;
+		uint32_t crc=ppl7::Crc32Combine(ppl7::Crc32(p,size1),ppl7::Crc32(p+size1,size2),size2);
+		ASSERT_EQ(expected_crc,crc) << "split=" << size1;
+		uint32_t adler=ppl7::Adler32Combine(ppl7::Adler32(p,size1),ppl7::Adler32(p+size1,size2),size2);
+		ASSERT_EQ(expected_adler,adler) << "split=" << size1;
+	}
+	// Segmente unterschiedlicher Größe nacheinander zusammenfügen
+	uint32_t crc=0;
+	size_t pos=0, size=1;
+	while (pos<data.size()) {
+		if (size>data.size()-pos) size=data.size()-pos;
+		crc=ppl7::Crc32Combine(crc,ppl7::Crc32(p+pos,size),size);
+		pos+=size;
+		size*=3;
+	}
+	ASSERT_EQ(expected_crc,crc);
+}
+
+}	// EOF namespace
@@ -0,0 +1,282 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <ppl7.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+
+extern ppl7::Array Wordlist;
+
+namespace {
+
+class HashAssocArrayTest : public ::testing::Test {
+protected:
+
+	HashAssocArrayTest() {
+		if (setlocale(LC_CTYPE, DEFAULT_LOCALE) == NULL) {
+			printf("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+	}
+	virtual ~HashAssocArrayTest() {
+
+	}
+};
+
+TEST_F(HashAssocArrayTest, ConstructorSimple) {
+	ASSERT_NO_THROW({
+		ppl7::HashAssocArray a;
+		ASSERT_EQ((size_t)0, a.size());
+		});
+}
+
+TEST_F(HashAssocArrayTest, addStringsMultiLevels) {
+	ppl7::HashAssocArray a;
+	ASSERT_NO_THROW({
+		a.set("key1","Dieser Wert geht über\nmehrere Zeilen");
+		a.set("key2","value6");
+		a.set("array1/unterkey1","value2");
+		a.set("array1/unterkey2","value3");
+		a.set("array1/noch ein array/unterkey1","value4");
+		a.set("array1/unterkey2","value5");
+		a.set("key2","value7");
+		a.set("array2/unterkey1","value7");
+		a.set("array2/unterkey2","value8");
+		a.set("array2/unterkey1","value9");
+		});
+	ASSERT_EQ((size_t)4, a.count()) << "Unexpected size of HashAssocArray";
+	ASSERT_EQ((size_t)10, a.count(true)) << "Unexpected size of HashAssocArray";
+	ASSERT_EQ((size_t)3, a.count(ppl7::String("array1")));
+	ASSERT_EQ(ppl7::String("Dieser Wert geht über\nmehrere Zeilen"), a.getString("key1")) << "unexpected value";
+	ASSERT_EQ(ppl7::String("value7"), a.getString("key2")) << "unexpected value";
+	ASSERT_EQ(ppl7::String("value5"), a.getString("array1/unterkey2")) << "unexpected value";
+	ASSERT_EQ(ppl7::String("value4"), a.getString("/array1//noch ein array/unterkey1/")) << "unexpected value";
+	ASSERT_TRUE(a.get("array1").isHashAssocArray());
+	ASSERT_EQ(ppl7::String("value9"), a.getAssocArray("array2").getString("unterkey1"));
+}
+
+TEST_F(HashAssocArrayTest, KeysAreCaseInsensitiveAndNumeric) {
+	ppl7::HashAssocArray a;
+	a.set("Content-Type","text/html");
+	a.set("007","bond");
+	ASSERT_EQ(ppl7::String("text/html"), a.getString("content-type"));
+	ASSERT_EQ(ppl7::String("text/html"), a.getString("CONTENT-TYPE"));
+	ASSERT_EQ(ppl7::String("bond"), a.getString("7"));
+	a.set("content-type","text/plain");
+	ASSERT_EQ((size_t)2, a.size());
+	ASSERT_EQ(ppl7::String("text/plain"), a.getString("Content-Type"));
+	ASSERT_FALSE(a.exists("Content-Typ"));
+	ASSERT_FALSE(a.exists("key/not/there"));
+}
+
+TEST_F(HashAssocArrayTest, InvalidKey) {
+	ppl7::HashAssocArray a;
+	ASSERT_THROW(a.set("","value"), ppl7::HashAssocArray::InvalidKeyException);
+	ASSERT_THROW(a.set("///","value"), ppl7::HashAssocArray::InvalidKeyException);
+	ASSERT_THROW(a.get(""), ppl7::HashAssocArray::InvalidKeyException);
+	ASSERT_THROW(a.get("missing"), ppl7::KeyNotFoundException);
+}
+
+TEST_F(HashAssocArrayTest, AppendWithBrackets) {
+	ppl7::HashAssocArray a;
+	a.set("list/[]","zero");
+	a.set("list/[]","one");
+	a.set("list/5","five");
+	a.set("list/[]","six");
+	ASSERT_EQ((size_t)4, a.count(ppl7::String("list")));
+	ASSERT_EQ(ppl7::String("zero"), a.getString("list/0"));
+	ASSERT_EQ(ppl7::String("one"), a.getString("list/1"));
+	ASSERT_EQ(ppl7::String("six"), a.getString("list/6"));
+}
+
+TEST_F(HashAssocArrayTest, InsertionOrder) {
+	ppl7::HashAssocArray a;
+	a.set("zebra","1");
+	a.set("apple","2");
+	a.set("mango","3");
+	a.set("apple","4");
+	ppl7::HashAssocArray::const_iterator it=a.begin();
+	ASSERT_EQ(ppl7::String("zebra"), it->first);
+	++it;
+	ASSERT_EQ(ppl7::String("apple"), it->first);
+	ASSERT_EQ(ppl7::String("4"), it->second->toString());
+	++it;
+	ASSERT_EQ(ppl7::String("mango"), it->first);
+	++it;
+	ASSERT_TRUE(it == a.end());
+
+	ppl7::HashAssocArray::Iterator it2;
+	ppl7::String key, value, keys;
+	a.reset(it2);
+	while (a.getNext(it2, key, value)) keys+=key;
+	ASSERT_EQ(ppl7::String("zebraapplemango"), keys);
+}
+
+TEST_F(HashAssocArrayTest, EraseKeepsOrder) {
+	ppl7::HashAssocArray a;
+	a.set("a","1");
+	a.set("b","2");
+	a.set("c","3");
+	a.set("sub/x","4");
+	a.set("sub/y","5");
+	a.erase("b");
+	a.erase("sub/x");
+	a.erase("does/not/exist");
+	ASSERT_EQ((size_t)3, a.size());
+	ASSERT_FALSE(a.exists("b"));
+	ASSERT_FALSE(a.exists("sub/x"));
+	ASSERT_TRUE(a.exists("sub/y"));
+	ppl7::String keys;
+	for (ppl7::HashAssocArray::iterator it=a.begin();it!=a.end();++it) keys+=it->first;
+	ASSERT_EQ(ppl7::String("acsub"), keys);
+	a.set("b","6");
+	keys.clear();
+	for (ppl7::HashAssocArray::iterator it=a.begin();it!=a.end();++it) keys+=it->first;
+	ASSERT_EQ(ppl7::String("acsubb"), keys);
+}
+
+TEST_F(HashAssocArrayTest, addAndDeleteWordlist) {
+	ppl7::HashAssocArray a;
+	size_t total=Wordlist.size();
+	if (total > 20000) total=20000;
+	for (size_t i=0;i<total;i++) {
+		a.setf(Wordlist[i], "%zu", i);
+	}
+	ppl7::AssocArray ref;
+	for (size_t i=0;i<total;i++) {
+		ref.setf(Wordlist[i], "%zu", i);
+	}
+	ASSERT_EQ(ref.size(), a.size());
+	ppl7::AssocArray::const_iterator it;
+	for (it=ref.begin();it!=ref.end();++it) {
+		ASSERT_EQ(it->second->toString(), a.getString(it->first)) << "Key: " << (const char*)it->first;
+	}
+	for (size_t i=0;i<total;i++) {
+		a.erase(Wordlist[i]);
+	}
+	ASSERT_EQ((size_t)0, a.size());
+}
+
+TEST_F(HashAssocArrayTest, ConvertFromAndToAssocArray) {
+	ppl7::AssocArray a;
+	a.set("key1","value1");
+	a.set("array1/unterkey1","value2");
+	a.set("array1/noch ein array/unterkey1","value4");
+	ppl7::HashAssocArray h(a);
+	ASSERT_EQ((size_t)5, h.count(true));
+	ASSERT_TRUE(h.get("array1/noch ein array").isHashAssocArray());
+	ASSERT_EQ(ppl7::String("value4"), h.getString("array1/noch ein array/unterkey1"));
+	ppl7::HashAssocArray h2;
+	h2.set("nested",a);
+	ASSERT_EQ(ppl7::String("value2"), h2.getString("nested/array1/unterkey1"));
+	ppl7::AssocArray back;
+	h.toAssocArray(back);
+	ASSERT_TRUE(back == a);
+}
+
+TEST_F(HashAssocArrayTest, exportAndImportBinary) {
+	ppl7::HashAssocArray a;
+	ppl7::DateTime now=ppl7::DateTime::currentTime();
+	ppl7::ByteArray ba(1234);
+	ppl7::Random(ba, 1234);
+	a.set("key1","Dieser Wert geht über\nmehrere Zeilen");
+	a.set("array1/unterkey1","value2");
+	a.set("array1/noch ein array/unterkey1","value4");
+	a.set("time",now);
+	a.set("bytearray",ba);
+	a.set("array",ppl7::Array("red green blue"," "));
+	a.set("widestring",ppl7::WideString(L"Hällo"));
+
+	ppl7::ByteArray bin;
+	a.exportBinary(bin);
+	ASSERT_EQ(a.binarySize(), bin.size());
+
+	ppl7::HashAssocArray b;
+	b.importBinary(bin);
+	ASSERT_TRUE(a == b);
+	ASSERT_EQ(now, b.get("time").toDateTime());
+	ASSERT_EQ(ba, b.get("bytearray").toByteArray());
+
+	// The format is shared with AssocArray
+	ppl7::AssocArray c;
+	c.importBinary(bin);
+	ASSERT_EQ(ppl7::String("value4"), c.getString("array1/noch ein array/unterkey1"));
+	ASSERT_EQ(ppl7::String("blue"), c.getArray("array").get(2));
+	ppl7::ByteArray bin2;
+	c.exportBinary(bin2);
+	ppl7::HashAssocArray d;
+	d.importBinary(bin2);
+	ASSERT_TRUE(a == d);
+}
+
+TEST_F(HashAssocArrayTest, CopyAndMove) {
+	ppl7::HashAssocArray a;
+	a.set("key1","value1");
+	a.set("sub/key2","value2");
+	ppl7::HashAssocArray b(a);
+	ASSERT_TRUE(a == b);
+	b.set("sub/key2","changed");
+	ASSERT_EQ(ppl7::String("value2"), a.getString("sub/key2"));
+	ppl7::HashAssocArray c(std::move(b));
+	ASSERT_EQ((size_t)0, b.size());
+	ASSERT_EQ(ppl7::String("changed"), c.getString("sub/key2"));
+	c=a;
+	ASSERT_TRUE(a == c);
+	ASSERT_FALSE(a != c);
+	c.set("key3","value3");
+	ASSERT_TRUE(a != c);
+}
+
+TEST_F(HashAssocArrayTest, GetWithDefaults) {
+	ppl7::HashAssocArray a;
+	a.set("port","8080");
+	a.set("enabled","true");
+	ASSERT_EQ(8080, a.getInt("port"));
+	ASSERT_EQ(80, a.getInt("missing", 80));
+	ASSERT_EQ(8080LL, a.getLongLong("port"));
+	ASSERT_TRUE(a.isTrue("enabled"));
+	ASSERT_TRUE(a.getBoolean("enabled", false));
+	ASSERT_FALSE(a.getBoolean("missing", false));
+	ASSERT_EQ(ppl7::String("default"), a.getString("missing", ppl7::String("default")));
+	a.append("port", "1", ",");
+	ASSERT_EQ(ppl7::String("8080,1"), a["port"].toString());
+}
+
+}	// EOF namespace
+
@@ -152,6 +152,147 @@ TEST_F(JsonTest, NegativTest_MissingValue) {
 }
 
 
+TEST_F(JsonTest, ParseFromByteArrayPtr) {
+	ppl7::ByteArray text;
+	ppl7::File::load(text,"testdata/jsontest1.json");
+	ppl7::AssocArray data;
+	ASSERT_NO_THROW({
+		ppl7::Json::loads(data,(const ppl7::ByteArrayPtr&)text);
+	});
+	EXPECT_EQ((size_t)15,data.size());
+	EXPECT_EQ(ppl7::String("newline\n, tab\ttab, backs\\ash"),data["EscapeSecences"]);
+	EXPECT_EQ(ppl7::String("schachtel2"),data["array_multiline/3/1"]);
+	EXPECT_EQ(ppl7::String("value2"),data["array_multiline/4/schachteldict2"]);
+}
+
+TEST_F(JsonTest, ParseFromFile) {
+	ppl7::File ff("testdata/jsontest1.json");
+	ppl7::AssocArray data;
+	ASSERT_NO_THROW({
+		ppl7::Json::load(data,ff);
+	});
+	EXPECT_EQ((size_t)15,data.size());
+	EXPECT_EQ(ppl7::String("Dieser String geht über\nmehrere Zeilen."),data["Zeilenumbruch"]);
+	EXPECT_EQ(ppl7::String("12345"),data["array_multiline/5"]);
+}
+
+TEST_F(JsonTest, ParseUnicodeEscapes) {
+	ppl7::String text("{\"umlaut\": \"\\u00e4\\u00f6\\u00fc\", \"euro\": \"\\u20ac\", "
+		"\"surrogate\": \"\\ud83d\\ude00\", \"mixed\": \"a\\u0041\\\"b\\/c\"}");
+	ppl7::AssocArray data;
+	ASSERT_NO_THROW({
+		ppl7::Json::loads(data,text);
+	});
+	EXPECT_EQ(ppl7::String("äöü"),data["umlaut"]);
+	EXPECT_EQ(ppl7::String("€"),data["euro"]);
+	EXPECT_EQ(ppl7::String("\xf0\x9f\x98\x80"),data["surrogate"]);
+	EXPECT_EQ(ppl7::String("aA\"b/c"),data["mixed"]);
+}
+
+TEST_F(JsonTest, ParseLargeDocumentFromFile) {
+	// The document is larger than the block size of the reader, so strings,
+	// numbers and escape sequences are split between blocks
+	ppl7::String json("{\"list\": [");
+	ppl7::String longstring;
+	for (int i=0;i<5000;i++) longstring.appendf("%d\\n\\u00e4",i);
+	for (int i=0;i<20000;i++) {
+		if (i>0) json.append(",");
+		json.appendf("{\"id\": %d, \"value\": \"string %d with \\\"quotes\\\"\", \"float\": -%d.5e3}",i,i,i);
+	}
+	json.append("], \"long\": \""+longstring+"\"}");
+	ppl7::MemFile file((void*)json.getPtr(),json.size());
+	ppl7::AssocArray data;
+	ASSERT_NO_THROW({
+		ppl7::Json::load(data,file);
+	});
+	ASSERT_EQ((size_t)20000,data.getAssocArray("list").size());
+	EXPECT_EQ(ppl7::String("0"),data["list/0/id"]);
+	EXPECT_EQ(ppl7::String("string 12345 with \"quotes\""),data["list/12345/value"]);
+	EXPECT_EQ(ppl7::String("-19999.5e3"),data["list/19999/float"]);
+	ppl7::String expected;
+	for (int i=0;i<5000;i++) expected.appendf("%d\nä",i);
+	EXPECT_EQ(expected,data["long"]);
+}
+
+TEST_F(JsonTest, NegativTest_UnterminatedString) {
+	ppl7::String text("{ \"key1\": \"value1");
+	ppl7::AssocArray data;
+	ASSERT_THROW(ppl7::Json::loads(data,text),ppl7::UnexpectedEndOfDataException);
+}
+
+TEST_F(JsonTest, NegativTest_InvalidEscapeSequence) {
+	ppl7::String text("{ \"key1\": \"value\\x1\"}");
+	ppl7::AssocArray data;
+	ASSERT_THROW(ppl7::Json::loads(data,text),ppl7::InvalidEscapeSequenceException);
+}
+
+
+class JsonEventRecorder : public ppl7::JsonEventHandler
+{
+	public:
+	ppl7::String events;
+	virtual void startObject() { events+="{"; }
+	virtual void endObject() { events+="}"; }
+	virtual void startArray() { events+="["; }
+	virtual void endArray() { events+="]"; }
+	virtual void key(const ppl7::String &name) { events+="K("+name+")"; }
+	virtual void value(const ppl7::String &value, ValueType type) {
+		events.appendf("V%d(%s)",(int)type,(const char*)value);
+	}
+};
+
+TEST_F(JsonTest, ParseWithEventHandler) {
+	ppl7::String text("{\"a\": \"x\\ty\", \"b\": [1, -2.5e3, true, false, null], \"c\": {}, \"\": []}");
+	JsonEventRecorder rec;
+	ASSERT_NO_THROW({
+		ppl7::Json::parse(rec,text);
+	});
+	EXPECT_EQ(ppl7::String("{K(a)V1(x\ty)K(b)[V2(1)V2(-2.5e3)V3(true)V3(false)V4(null)]K(c){}K()[]}"),rec.events);
+}
+
+TEST_F(JsonTest, ParseFileWithEventHandler) {
+	ppl7::File ff("testdata/jsontest2.json");
+	JsonEventRecorder rec;
+	ASSERT_NO_THROW({
+		ppl7::Json::parse(rec,ff);
+	});
+	EXPECT_EQ(ppl7::String("[V1(value1){K(key1)V1(inner_value1)K(key2)V1(inner_value2)}V1(value3)]"),rec.events);
+}
+
+TEST_F(JsonTest, JsonLineReader) {
+	ppl7::String text("{\"id\": 1, \"name\": \"first\"}\n"
+		"\n"
+		"  {\"id\": 2, \"tags\": [\"a\", \"b\"]}  \r\n"
+		"[\"list\", 3]\n"
+		"{\"id\": 4}");
+	ppl7::MemFile file((void*)text.getPtr(),text.size());
+	ppl7::JsonLineReader reader(file);
+	ppl7::AssocArray record;
+	ASSERT_TRUE(reader.next(record));
+	EXPECT_EQ((size_t)2,record.size());
+	EXPECT_EQ(ppl7::String("first"),record["name"]);
+	ASSERT_TRUE(reader.next(record));
+	EXPECT_EQ((size_t)2,record.size());
+	EXPECT_EQ(ppl7::String("2"),record["id"]);
+	EXPECT_EQ(ppl7::String("b"),record["tags/1"]);
+	ASSERT_TRUE(reader.next(record));
+	EXPECT_EQ(ppl7::String("list"),record["0"]);
+	EXPECT_EQ(ppl7::String("3"),record["1"]);
+	JsonEventRecorder rec;
+	ASSERT_TRUE(reader.next(rec));
+	EXPECT_EQ(ppl7::String("{K(id)V2(4)}"),rec.events);
+	ASSERT_FALSE(reader.next(record));
+	EXPECT_EQ((uint64_t)4,reader.count());
+}
+
+TEST_F(JsonTest, JsonLineReader_NegativTest_TwoRecordsInOneLine) {
+	ppl7::String text("{\"id\": 1} {\"id\": 2}\n");
+	ppl7::MemFile file((void*)text.getPtr(),text.size());
+	ppl7::JsonLineReader reader(file);
+	ppl7::AssocArray record;
+	ASSERT_THROW(reader.next(record),ppl7::UnexpectedCharacterException);
+}
+
 TEST_F(JsonTest, DumpsEmptyArrayToString) {
 	ppl7::AssocArray data;
 	ppl7::String str;
@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <locale.h>
+#include <set>
 #include <ppl7.h>
 #include <gtest/gtest.h>
 #include "../../../include/config_ppl7.h"
@@ -78,9 +79,337 @@ TEST_F(LoggerTest, openSyslog) {
 }
 #endif
 
+class CollectingLogHandler : public ppl7::LogHandler
+{
+	public:
+		ppl7::Mutex mutex;
+		ppl7::Array messages;
+		std::set<uint64_t> threads;
 
+		void logMessage(ppl7::Logger::PRIORITY, int, const ppl7::String &msg) {
+			mutex.lock();
+			messages.add(msg);
+			threads.insert(ppl7::ThreadID());
+			mutex.unlock();
+		}
+		size_t count(const ppl7::String &pattern) {
+			size_t c=0;
+			mutex.lock();
+			for (size_t i=0;i<messages.size();i++) {
+				if (messages[i].instr(pattern)>=0) c++;
+			}
+			mutex.unlock();
+			return c;
+		}
+};
+
+class AsyncLogThread : public ppl7::Thread
+{
+	public:
+		ppl7::Logger *log;
+		int id;
+		void run() {
+			for (int i=0;i<1000;i++) {
+				log->printf(ppl7::Logger::DEBUG,1,"thread %d message %d",id,i);
+			}
+		}
+};
+
+TEST_F(LoggerTest, asyncWritesToLogHandler) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.addLogHandler(&handler);
+	ASSERT_FALSE(log.isAsync());
+	log.enableAsync(1024);
+	ASSERT_TRUE(log.isAsync());
+	for (int i=0;i<5000;i++) log.printf(ppl7::Logger::DEBUG,1,"async message %d",i);
+	log.flush();
+	ASSERT_EQ((size_t)5000,handler.count("async message"));
+	ASSERT_EQ((uint64_t)0,log.droppedMessages());
+	ASSERT_TRUE(handler.messages[handler.messages.size()-1].instr("async message 4999")>0);
+	ASSERT_TRUE(handler.threads.find(ppl7::ThreadID())==handler.threads.end());
+	log.disableAsync();
+	ASSERT_FALSE(log.isAsync());
+	log.deleteLogHandler(&handler);
+}
+
+TEST_F(LoggerTest, asyncKeepsOrderPerThread) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.addLogHandler(&handler);
+	log.enableAsync(256);
+	AsyncLogThread threads[4];
+	for (int t=0;t<4;t++) {
+		threads[t].log=&log;
+		threads[t].id=t;
+		threads[t].threadStart();
+	}
+	for (int t=0;t<4;t++) {
+		while (threads[t].threadIsRunning()==0 && handler.count(ppl7::ToString("thread %d message",t))==0) ppl7::MSleep(1);
+		threads[t].threadStop();
+	}
+	log.disableAsync();
+	log.deleteLogHandler(&handler);
+	int next[4]={0,0,0,0};
+	for (size_t i=0;i<handler.messages.size();i++) {
+		int t, m;
+		const ppl7::String &msg=handler.messages[i];
+		ssize_t p=msg.instr("thread ");
+		if (p<0) continue;
+		ASSERT_EQ(2,sscanf((const char*)msg+p,"thread %d message %d",&t,&m));
+		ASSERT_EQ(next[t],m);
+		next[t]++;
+	}
+	for (int t=0;t<4;t++) ASSERT_EQ(1000,next[t]);
+}
+
+TEST_F(LoggerTest, asyncOverflowDrop) {
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.enableAsync(16,ppl7::Logger::OVERFLOW_DROP);
+	// Ohne Logdatei und Handler ist der Schreib-Thread sehr schnell, daher wird der Puffer
+	// über einen langsamen Handler künstlich gebremst
+	class SlowHandler : public ppl7::LogHandler {
+		public:
+			void logMessage(ppl7::Logger::PRIORITY, int, const ppl7::String &) {
+				ppl7::MSleep(1);
+			}
+	} slow;
+	log.addLogHandler(&slow);
+	for (int i=0;i<200;i++) log.printf(ppl7::Logger::DEBUG,1,"message %d",i);
+	log.flush();
+	ASSERT_GT(log.droppedMessages(),(uint64_t)0);
+	log.disableAsync();
+	log.deleteLogHandler(&slow);
+}
 
+TEST_F(LoggerTest, asyncOverflowCountReportsDropped) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.setLogLevel(ppl7::Logger::WARNING,5);
+	log.enableAsync(16,ppl7::Logger::OVERFLOW_COUNT);
+	class SlowHandler : public ppl7::LogHandler {
+		public:
+			void logMessage(ppl7::Logger::PRIORITY, int, const ppl7::String &) {
+				ppl7::MSleep(1);
+			}
+	} slow;
+	log.addLogHandler(&slow);
+	log.addLogHandler(&handler);
+	for (int i=0;i<200;i++) log.printf(ppl7::Logger::DEBUG,1,"message %d",i);
+	log.flush();
+	uint64_t dropped=log.droppedMessages();
+	ASSERT_GT(dropped,(uint64_t)0);
+	ASSERT_GE(handler.count("messages dropped"),(size_t)1);
+	ASSERT_EQ((size_t)200-dropped,handler.count("message "));
+	log.disableAsync();
+	log.deleteLogHandler(&slow);
+	log.deleteLogHandler(&handler);
+}
 
+TEST_F(LoggerTest, asyncOverflowBlockLosesNothing) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.enableAsync(16,ppl7::Logger::OVERFLOW_BLOCK);
+	log.addLogHandler(&handler);
+	for (int i=0;i<2000;i++) log.printf(ppl7::Logger::DEBUG,1,"message %d",i);
+	log.flush();
+	ASSERT_EQ((uint64_t)0,log.droppedMessages());
+	ASSERT_EQ((size_t)2000,handler.count("message "));
+	log.disableAsync();
+	log.deleteLogHandler(&handler);
+}
+
+TEST_F(LoggerTest, asyncMultiLineMessagesStayTogether) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.addLogHandler(&handler);
+	log.enableAsync(256);
+	AsyncLogThread thread;
+	thread.log=&log;
+	thread.id=0;
+	thread.threadStart();
+	ppl7::AssocArray a;
+	a.set("key","value");
+	a.set("other","data");
+	for (int i=0;i<50;i++) {
+		log.printArray(ppl7::Logger::DEBUG,1,a,"array");
+		log.hexDump(ppl7::Logger::DEBUG,1,"0123456789abcdef0123",20);
+	}
+	thread.threadStop();
+	log.disableAsync();
+	log.deleteLogHandler(&handler);
+	size_t arrays=0, dumps=0;
+	for (size_t i=0;i<handler.messages.size();i++) {
+		const ppl7::String &msg=handler.messages[i];
+		if (msg.instr("array")>=0) {
+			ASSERT_TRUE(msg.instr("key=value")>0);
+			ASSERT_TRUE(msg.instr("other=data")>0);
+			arrays++;
+		}
+		if (msg.instr("HEXDUMP")>=0) {
+			ASSERT_TRUE(msg.instr(": 0123456789abcdef")>0);
+			dumps++;
+		}
+	}
+	ASSERT_EQ((size_t)50,arrays);
+	ASSERT_EQ((size_t)50,dumps);
+}
+
+TEST_F(LoggerTest, syncMultiLineMessagesKeepLineFormat) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.addLogHandler(&handler);
+	log.hexDump(ppl7::Logger::DEBUG,1,"0123456789abcdef0123",20);
+	// Kopfzeile, zwei Zeilen mit Daten und eine Leerzeile
+	ASSERT_EQ((size_t)4,handler.messages.size());
+	ASSERT_TRUE(handler.messages[0].instr("HEXDUMP")>=0);
+	ASSERT_TRUE(handler.messages[1].instr(": 0123456789abcdef")>0);
+	ASSERT_TRUE(handler.messages[2].instr(": 0123")>0);
+	handler.messages.clear();
+	ppl7::AssocArray a;
+	a.set("key","value");
+	log.printArray(ppl7::Logger::DEBUG,1,a,"array");
+	ASSERT_EQ((size_t)2,handler.messages.size());
+	ASSERT_TRUE(handler.messages[0].instr("array")>=0);
+	ASSERT_TRUE(handler.messages[1].instr("key=value")>=0);
+	log.deleteLogHandler(&handler);
+}
+
+TEST_F(LoggerTest, asyncSwitchWhileOtherThreadsLog) {
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	AsyncLogThread threads[4];
+	for (int t=0;t<4;t++) {
+		threads[t].log=&log;
+		threads[t].id=t;
+		threads[t].threadStart();
+	}
+	for (int i=0;i<50;i++) {
+		log.enableAsync(64);
+		ppl7::MSleep(1);
+		log.flush();
+		log.droppedMessages();
+		log.disableAsync();
+	}
+	for (int t=0;t<4;t++) threads[t].threadStop();
+	ASSERT_FALSE(log.isAsync());
+}
+
+TEST_F(LoggerTest, asyncWritesLogfile) {
+	ppl7::String filename="tmp/logger_async.log";
+	ppl7::Dir::mkDir("tmp",true);
+	if (ppl7::File::exists(filename)) ppl7::File::unlink(filename);
+	{
+		ppl7::Logger log;
+		log.setLogfile(ppl7::Logger::DEBUG,filename,5);
+		log.enableAsync();
+		for (int i=0;i<100;i++) log.printf(ppl7::Logger::DEBUG,1,__FILE__,__LINE__,"line %d",i);
+		ppl7::AssocArray a;
+		a.set("key","value");
+		log.printArray(ppl7::Logger::DEBUG,1,a,"array");
+		log.hexDump(ppl7::Logger::DEBUG,1,"0123456789abcdef0123",20);
+	}
+	ppl7::String content;
+	ppl7::File::load(content,filename);
+	ASSERT_TRUE(content.instr("line 0\n")>0);
+	ASSERT_TRUE(content.instr("line 99\n")>0);
+	ASSERT_TRUE(content.instr("     key=value")>0);
+	ASSERT_TRUE(content.instr("HEXDUMP: 20 Bytes")>0);
+	ppl7::File::unlink(filename);
+}
+
+static void logFilterSites(ppl7::Logger &log, int level)
+{
+	log.print(ppl7::Logger::DEBUG,level,"net","connect","net.cpp",10,"site net::connect");
+	log.print(ppl7::Logger::DEBUG,level,"net","close","net.cpp",20,"site net::close");
+	log.print(ppl7::Logger::DEBUG,level,"db","query","db.cpp",30,"site db::query");
+}
+
+TEST_F(LoggerTest, filterByModule) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.addLogHandler(&handler);
+	log.setFilter("net",(const char*)NULL,3);
+	logFilterSites(log,2);
+	logFilterSites(log,3);
+	ASSERT_EQ((size_t)1,handler.count("site net::connect"));
+	ASSERT_EQ((size_t)1,handler.count("site net::close"));
+	ASSERT_EQ((size_t)2,handler.count("site db::query"));
+	log.setFilter("db","query",1);
+	logFilterSites(log,1);
+	ASSERT_EQ((size_t)2,handler.count("site net::connect"));
+	ASSERT_EQ((size_t)2,handler.count("site db::query"));
+	log.deleteLogHandler(&handler);
+}
+
+TEST_F(LoggerTest, filterByFileAndLine) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.addLogHandler(&handler);
+	log.setFilter("net.cpp",20,1);
+	log.setFilter("db.cpp",0,4);
+	logFilterSites(log,1);
+	logFilterSites(log,4);
+	ASSERT_EQ((size_t)2,handler.count("site net::connect"));
+	ASSERT_EQ((size_t)0,handler.count("site net::close"));
+	ASSERT_EQ((size_t)1,handler.count("site db::query"));
+	log.deleteLogHandler(&handler);
+}
+
+TEST_F(LoggerTest, filterChangesInvalidateCachedDecisions) {
+	CollectingLogHandler handler;
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	log.addLogHandler(&handler);
+	logFilterSites(log,1);
+	ASSERT_EQ((size_t)1,handler.count("site net::connect"));
+	log.setFilter("net","connect",1);
+	logFilterSites(log,1);
+	ASSERT_EQ((size_t)1,handler.count("site net::connect"));
+	ASSERT_EQ((size_t)2,handler.count("site net::close"));
+	log.setFilter("net","connect",2);
+	logFilterSites(log,1);
+	ASSERT_EQ((size_t)2,handler.count("site net::connect"));
+	log.deleteFilter("net","connect");
+	logFilterSites(log,2);
+	ASSERT_EQ((size_t)3,handler.count("site net::connect"));
+	log.setFilter("net.cpp",10,1);
+	logFilterSites(log,1);
+	ASSERT_EQ((size_t)3,handler.count("site net::connect"));
+	log.deleteFilter("net.cpp",10);
+	logFilterSites(log,1);
+	ASSERT_EQ((size_t)4,handler.count("site net::connect"));
+	log.deleteLogHandler(&handler);
+}
+
+TEST_F(LoggerTest, filterIsPerLogger) {
+	CollectingLogHandler handler1, handler2;
+	ppl7::Logger log1, log2;
+	log1.setLogLevel(ppl7::Logger::DEBUG,5);
+	log2.setLogLevel(ppl7::Logger::DEBUG,5);
+	log1.addLogHandler(&handler1);
+	log2.addLogHandler(&handler2);
+	log1.setFilter("net",(const char*)NULL,1);
+	log2.setFilter("db",(const char*)NULL,1);
+	logFilterSites(log1,1);
+	logFilterSites(log2,1);
+	logFilterSites(log1,1);
+	ASSERT_EQ((size_t)0,handler1.count("site net::"));
+	ASSERT_EQ((size_t)2,handler1.count("site db::query"));
+	ASSERT_EQ((size_t)2,handler2.count("site net::"));
+	ASSERT_EQ((size_t)0,handler2.count("site db::query"));
+	log1.deleteLogHandler(&handler1);
+	log2.deleteLogHandler(&handler2);
+}
 
 }
 
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <locale.h>
+#include <ppl7.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+class MemoryArenaTest : public ::testing::Test {
+	protected:
+	MemoryArenaTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+	}
+	virtual ~MemoryArenaTest() {
+
+	}
+};
+
+TEST_F(MemoryArenaTest, ConstructorSimple) {
+	ppl7::MemoryArena a;
+	ASSERT_EQ((size_t)0,a.memoryUsed());
+	ASSERT_EQ((size_t)65536,a.blockSize());
+	ASSERT_THROW(ppl7::MemoryArena b(100), ppl7::IllegalArgumentException);
+}
+
+TEST_F(MemoryArenaTest, MallocIsAligned) {
+	ppl7::MemoryArena a(4096);
+	char *p1=(char*)a.malloc(1);
+	char *p2=(char*)a.malloc(3);
+	char *p3=(char*)a.malloc(17);
+	ASSERT_EQ((uintptr_t)0,((uintptr_t)p1)&15);
+	ASSERT_EQ((uintptr_t)0,((uintptr_t)p2)&15);
+	ASSERT_EQ((uintptr_t)0,((uintptr_t)p3)&15);
+	ASSERT_EQ(p1+16,p2);
+	ASSERT_EQ(p2+16,p3);
+	ASSERT_EQ((size_t)64,a.memoryUsed());
+	ASSERT_THROW(a.malloc(0), ppl7::IllegalArgumentException);
+}
+
+TEST_F(MemoryArenaTest, ManyBlocksAndClear) {
+	ppl7::MemoryArena a(4096);
+	for (int i=0;i<10000;i++) {
+		char *p=(char*)a.calloc(40);
+		ASSERT_EQ(0,p[0]);
+		memset(p,i&255,40);
+	}
+	ASSERT_EQ((size_t)480000,a.memoryUsed());
+	ASSERT_LE((size_t)480000,a.memoryAllocated());
+	// Große Anforderungen bekommen einen eigenen Block
+	char *big=(char*)a.malloc(100000);
+	memset(big,1,100000);
+	a.clear();
+	ASSERT_EQ((size_t)0,a.memoryUsed());
+}
+
+TEST_F(MemoryArenaTest, Strndup) {
+	ppl7::MemoryArena a;
+	char *s=a.strndup("Hello World",5);
+	ASSERT_STREQ("Hello",s);
+}
+
+
+}	// EOF namespace
+
@@ -37,6 +37,7 @@
 #include <string.h>
 #include <pthread.h>
 #include <locale.h>
+#include <atomic>
 #include <ppl7.h>
 #include <gtest/gtest.h>
 #include "ppl7-tests.h"
@@ -205,6 +206,128 @@ TEST_F(MemoryHeapTest, clear) {
 }
 
 
+TEST_F(MemoryHeapTest, freeReusesElements) {
+	ppl7::MemoryHeap h1(24,100,100,30);
+	void *ptr[100];
+	for (int i=0;i<100;i++) {
+		ptr[i]=h1.malloc();
+		ASSERT_EQ((size_t)0,((uintptr_t)ptr[i])&7) << "element is not aligned";
+		memset(ptr[i],i,24);
+	}
+	ASSERT_EQ(h1.capacity(),(size_t)100);
+	for (int i=0;i<100;i+=2) h1.free(ptr[i]);
+	ASSERT_EQ(h1.count(),(size_t)50);
+	for (int i=1;i<100;i+=2) {
+		for (int j=0;j<24;j++) ASSERT_EQ(i,((uint8_t*)ptr[i])[j]) << "element was overwritten";
+	}
+	for (int i=0;i<100;i+=2) ptr[i]=h1.malloc();
+	ASSERT_EQ(h1.count(),(size_t)100);
+	ASSERT_EQ(h1.capacity(),(size_t)100) << "heap grew although free elements were available";
+	for (int i=0;i<100;i++) h1.free(ptr[i]);
+	ASSERT_EQ(h1.count(),(size_t)0);
+}
+
+TEST_F(MemoryHeapTest, freeDetectsInvalidPointers) {
+	ppl7::MemoryHeap h1(32,10,10,30);
+	ppl7::MemoryHeap h2(32,10,10,30);
+	void *ptr=h1.malloc();
+	void *other=h2.malloc();
+	ASSERT_THROW(h2.free(ptr),ppl7::MemoryHeap::ElementNotInHeapException);
+	ASSERT_THROW(h1.free(other),ppl7::MemoryHeap::ElementNotInHeapException);
+	ASSERT_THROW(h1.free(NULL),ppl7::MemoryHeap::ElementNotInHeapException);
+	h1.free(ptr);
+	ASSERT_THROW(h1.free(ptr),ppl7::MemoryHeap::HeapCorruptedException);
+	h2.free(other);
+	ASSERT_EQ(h1.count(),(size_t)0);
+	ASSERT_EQ(h2.count(),(size_t)0);
+}
+
+TEST_F(MemoryHeapTest, smallElements) {
+	ppl7::MemoryHeap h1(1,0,100,30);
+	ASSERT_EQ(h1.elementSize(),(size_t)4);
+	void *ptr[1000];
+	for (int i=0;i<1000;i++) {
+		ptr[i]=h1.malloc();
+		*(uint32_t*)ptr[i]=i;
+	}
+	for (int i=999;i>=0;i--) {
+		ASSERT_EQ((uint32_t)i,*(uint32_t*)ptr[i]);
+		h1.free(ptr[i]);
+	}
+	ASSERT_EQ(h1.count(),(size_t)0);
+}
+
+class MemoryHeapThread : public ppl7::Thread
+{
+	public:
+		ppl7::MemoryHeap *heap;
+		std::atomic<void*> *shared;
+		int id;
+		std::atomic<bool> done;
+		bool failed;
+
+		MemoryHeapThread() {
+			heap=NULL;
+			shared=NULL;
+			id=0;
+			done=false;
+			failed=false;
+		}
+		void run() {
+			void *ptr[64];
+			try {
+				for (int round=0;round<500;round++) {
+					for (int i=0;i<64;i++) {
+						ptr[i]=heap->malloc();
+						*(int*)ptr[i]=id*1000+i;
+					}
+					for (int i=0;i<64;i++) {
+						if (*(int*)ptr[i]!=id*1000+i) failed=true;
+					}
+					// Ein Element wird jeweils von einem anderen Thread freigegeben
+					void *foreign=shared->exchange(ptr[0]);
+					if (foreign) heap->free(foreign);
+					for (int i=1;i<64;i++) heap->free(ptr[i]);
+				}
+			} catch (...) {
+				failed=true;
+			}
+			done=true;
+		}
+};
+
+TEST_F(MemoryHeapTest, threadCache) {
+	ppl7::MemoryHeap h1(32,0,100,30);
+	ASSERT_FALSE(h1.isThreadSafe());
+	h1.enableThreadCache(16);
+	ASSERT_TRUE(h1.isThreadSafe());
+	std::atomic<void*> shared(NULL);
+	MemoryHeapThread threads[4];
+	for (int i=0;i<4;i++) {
+		threads[i].heap=&h1;
+		threads[i].shared=&shared;
+		threads[i].id=i;
+		threads[i].threadStart();
+	}
+	for (int i=0;i<4;i++) {
+		while (!threads[i].done) ppl7::MSleep(1);
+		threads[i].threadStop();
+		ASSERT_FALSE(threads[i].failed) << "thread " << i << " failed";
+	}
+	if (shared.load()) h1.free(shared.load());
+	ASSERT_EQ(h1.count(),(size_t)0);
+	void *ptr=h1.malloc();
+	ASSERT_EQ(h1.count(),(size_t)1);
+	h1.disableThreadCache();
+	ASSERT_FALSE(h1.isThreadSafe());
+	ASSERT_EQ(h1.count(),(size_t)1);
+	h1.free(ptr);
+	ASSERT_EQ(h1.count(),(size_t)0);
+	h1.cleanup();
+	ASSERT_LE(h1.capacity(),(size_t)(4*(64+16)+100));
+}
+
+
 }	// EOF namespace
 
 
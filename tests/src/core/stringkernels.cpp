@@ -0,0 +1,249 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <locale.h>
+#include <ppl7.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+// Alle Varianten der Kernel, die getestet werden. Wird ein Feature von der CPU nicht
+// unterstützt, fällt SetStringKernelCaps automatisch auf die nächst kleinere Variante zurück.
+static const uint32_t KernelLevels[]={
+	0,
+	ppl7::CPUCAPS::CPU_HAVE_SSE2,
+	ppl7::CPUCAPS::CPU_HAVE_SSE2 | ppl7::CPUCAPS::CPU_HAVE_AVX2
+};
+
+class StringKernelTest : public ::testing::Test {
+	protected:
+	uint32_t savedCaps;
+	StringKernelTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		savedCaps=ppl7::GetStringKernelCaps();
+	}
+	virtual ~StringKernelTest() {
+		ppl7::SetStringKernelCaps(savedCaps);
+	}
+};
+
+static const char* referenceFind(const char* haystack, size_t hlen, const char* needle, size_t nlen)
+{
+	if (nlen>hlen) return NULL;
+	for (size_t i=0;i<=hlen-nlen;i++) {
+		if (memcmp(haystack+i,needle,nlen)==0) return haystack+i;
+	}
+	return NULL;
+}
+
+TEST_F(StringKernelTest, SetStringKernelCaps) {
+	ppl7::SetStringKernelCaps(0);
+	ASSERT_EQ((uint32_t)0,ppl7::GetStringKernelCaps());
+	ppl7::SetStringKernelCaps(0xffffffff);
+	uint32_t caps=ppl7::GetStringKernelCaps();
+	ASSERT_EQ((uint32_t)0,caps&~(ppl7::CPUCAPS::CPU_HAVE_SSE2|ppl7::CPUCAPS::CPU_HAVE_AVX2));
+	ASSERT_EQ(caps,caps&ppl7::GetCPUCaps());
+}
+
+TEST_F(StringKernelTest, MemFind) {
+	char haystack[200];
+	for (size_t i=0;i<sizeof(haystack);i++) haystack[i]='a'+(i%7);
+	haystack[150]=0;	// 0-Bytes haben keine besondere Bedeutung
+	for (auto level : KernelLevels) {
+		ppl7::SetStringKernelCaps(level);
+		for (size_t hlen=0;hlen<=sizeof(haystack);hlen+=7) {
+			for (size_t nlen=0;nlen<20 && nlen<=hlen;nlen++) {
+				for (size_t pos=0;pos+nlen<=hlen;pos+=5) {
+					const char* needle=haystack+pos;
+					ASSERT_EQ(referenceFind(haystack,hlen,needle,nlen),ppl7::MemFind(haystack,hlen,needle,nlen))
+						<< "level=" << level << ", hlen=" << hlen << ", nlen=" << nlen << ", pos=" << pos;
+				}
+			}
+			ASSERT_EQ(NULL,ppl7::MemFind(haystack,hlen,"xyz",3));
+			ASSERT_EQ(NULL,ppl7::MemFind(haystack,hlen,"ax",2));
+		}
+	}
+}
+
+TEST_F(StringKernelTest, MemFindWide) {
+	wchar_t haystack[100];
+	for (size_t i=0;i<100;i++) haystack[i]=L'a'+(i%5);
+	haystack[57]=0x20ac;
+	for (auto level : KernelLevels) {
+		ppl7::SetStringKernelCaps(level);
+		for (size_t hlen=0;hlen<=100;hlen+=3) {
+			for (size_t nlen=1;nlen<12 && nlen<=hlen;nlen++) {
+				for (size_t pos=0;pos+nlen<=hlen;pos+=3) {
+					const wchar_t* needle=haystack+pos;
+					const wchar_t* expected=NULL;
+					for (size_t i=0;i+nlen<=hlen;i++) {
+						if (wmemcmp(haystack+i,needle,nlen)==0) {
+							expected=haystack+i;
+							break;
+						}
+					}
+					ASSERT_EQ(expected,ppl7::MemFind(haystack,hlen,needle,nlen))
+						<< "level=" << level << ", hlen=" << hlen << ", nlen=" << nlen << ", pos=" << pos;
+				}
+			}
+			ASSERT_EQ(NULL,ppl7::MemFind(haystack,hlen,L"xyz",3));
+		}
+	}
+}
+
+TEST_F(StringKernelTest, SpanWhitespace) {
+	const char ws[]=" \t\r\n";
+	for (auto level : KernelLevels) {
+		ppl7::SetStringKernelCaps(level);
+		for (size_t len=0;len<80;len++) {
+			for (size_t lead=0;lead<=len;lead+=3) {
+				char buffer[80];
+				wchar_t wbuffer[80];
+				for (size_t i=0;i<len;i++) {
+					buffer[i]=(i<lead || i>=len-lead/2) ? ws[i&3] : 'x';
+					wbuffer[i]=(wchar_t)(unsigned char)buffer[i];
+				}
+				size_t front=0, back=0;
+				while (front<len && strchr(ws,buffer[front])) front++;
+				while (back<len && strchr(ws,buffer[len-1-back])) back++;
+				ASSERT_EQ(front,ppl7::SpanWhitespace(buffer,len)) << "level=" << level << ", len=" << len << ", lead=" << lead;
+				ASSERT_EQ(back,ppl7::SpanWhitespaceReverse(buffer,len)) << "level=" << level << ", len=" << len << ", lead=" << lead;
+				ASSERT_EQ(front,ppl7::SpanWhitespace(wbuffer,len)) << "level=" << level << ", len=" << len << ", lead=" << lead;
+				ASSERT_EQ(back,ppl7::SpanWhitespaceReverse(wbuffer,len)) << "level=" << level << ", len=" << len << ", lead=" << lead;
+			}
+		}
+	}
+}
+
+TEST_F(StringKernelTest, AsciiCase) {
+	char source[128];
+	for (size_t i=0;i<sizeof(source);i++) source[i]=(char)(32+i%95);
+	for (auto level : KernelLevels) {
+		ppl7::SetStringKernelCaps(level);
+		for (size_t len=0;len<=sizeof(source);len+=5) {
+			char lower[128], upper[128];
+			wchar_t wlower[128], wupper[128];
+			for (size_t i=0;i<len;i++) wlower[i]=wupper[i]=(wchar_t)(lower[i]=upper[i]=source[i]);
+			ASSERT_EQ(len,ppl7::AsciiLowerCase(lower,len));
+			ASSERT_EQ(len,ppl7::AsciiUpperCase(upper,len));
+			ASSERT_EQ(len,ppl7::AsciiLowerCase(wlower,len));
+			ASSERT_EQ(len,ppl7::AsciiUpperCase(wupper,len));
+			for (size_t i=0;i<len;i++) {
+				ASSERT_EQ((char)tolower(source[i]),lower[i]) << "level=" << level << ", pos=" << i;
+				ASSERT_EQ((char)toupper(source[i]),upper[i]) << "level=" << level << ", pos=" << i;
+				ASSERT_EQ((wchar_t)tolower(source[i]),wlower[i]) << "level=" << level << ", pos=" << i;
+				ASSERT_EQ((wchar_t)toupper(source[i]),wupper[i]) << "level=" << level << ", pos=" << i;
+			}
+		}
+	}
+}
+
+TEST_F(StringKernelTest, AsciiCaseStopsAtNonAscii) {
+	for (auto level : KernelLevels) {
+		ppl7::SetStringKernelCaps(level);
+		for (size_t pos=0;pos<70;pos+=3) {
+			char buffer[80];
+			wchar_t wbuffer[80];
+			for (size_t i=0;i<80;i++) wbuffer[i]=buffer[i]='A';
+			buffer[pos]=(char)0xc3;
+			wbuffer[pos]=0xc4;
+			ASSERT_EQ(pos,ppl7::AsciiLowerCase(buffer,80)) << "level=" << level;
+			ASSERT_EQ(pos,ppl7::AsciiLowerCase(wbuffer,80)) << "level=" << level;
+			for (size_t i=0;i<pos;i++) {
+				ASSERT_EQ('a',buffer[i]);
+				ASSERT_EQ(L'a',wbuffer[i]);
+			}
+			ASSERT_EQ('A',buffer[pos+1]);
+			ASSERT_EQ(L'A',wbuffer[pos+1]);
+		}
+	}
+}
+
+TEST_F(StringKernelTest, StringFunctions) {
+	for (auto level : KernelLevels) {
+		ppl7::SetStringKernelCaps(level);
+		ppl7::String s("   \t\r\n   \n\t  ");
+		s.trim();
+		ASSERT_EQ(ppl7::String(""),s);
+		s.set("\t  Ein langer Text, der laenger als ein AVX2-Register ist   \n");
+		s.trim();
+		ASSERT_EQ(ppl7::String("Ein langer Text, der laenger als ein AVX2-Register ist"),s);
+		ASSERT_EQ((ssize_t)37,s.instr("AVX2"));
+		ASSERT_EQ((ssize_t)37,s.find("AVX2"));
+		ASSERT_EQ((ssize_t)-1,s.instr("AVX3"));
+		ASSERT_EQ((ssize_t)21,s.find("la",-1));
+		ASSERT_EQ(ppl7::String("register ist"),s.strchr('R').toLowerCase());
+		s.replace("e","E");
+		ASSERT_EQ(ppl7::String("Ein langEr TExt, dEr laEngEr als Ein AVX2-REgistEr ist"),s);
+		s.upperCase();
+		ASSERT_EQ(ppl7::String("EIN LANGER TEXT, DER LAENGER ALS EIN AVX2-REGISTER IST"),s);
+		s.lowerCase();
+		ASSERT_EQ(ppl7::String("ein langer text, der laenger als ein avx2-register ist"),s);
+		ppl7::Array a;
+		a.explode(s," ");
+		ASSERT_EQ((size_t)9,a.size());
+		ASSERT_EQ(ppl7::String("avx2-register"),a[7]);
+		ASSERT_EQ(ppl7::String("ist"),a[8]);
+	}
+}
+
+TEST_F(StringKernelTest, WideStringFunctions) {
+	for (auto level : KernelLevels) {
+		ppl7::SetStringKernelCaps(level);
+		ppl7::WideString s(L"   \t\r\n   \n\t  ");
+		s.trim();
+		ASSERT_EQ(ppl7::WideString(L""),s);
+		s.set(L"\t  Ein langer Text mit Ümläuten, der länger als ein Register ist   \n");
+		s.trim();
+		ASSERT_EQ(ppl7::WideString(L"Ein langer Text mit Ümläuten, der länger als ein Register ist"),s);
+		ASSERT_EQ((ssize_t)49,s.instr(L"Register"));
+		ASSERT_EQ((ssize_t)49,s.find(L"Register"));
+		ASSERT_EQ((ssize_t)-1,s.instr(L"register"));
+		s.replace(L"e",L"E");
+		ASSERT_EQ(ppl7::WideString(L"Ein langEr TExt mit ÜmläutEn, dEr längEr als Ein REgistEr ist"),s);
+		s.upperCase();
+		ASSERT_EQ(ppl7::WideString(L"EIN LANGER TEXT MIT ÜMLÄUTEN, DER LÄNGER ALS EIN REGISTER IST"),s);
+		s.lowerCase();
+		ASSERT_EQ(ppl7::WideString(L"ein langer text mit ümläuten, der länger als ein register ist"),s);
+	}
+}
+
+}	// EOF namespace
@@ -161,6 +161,59 @@ TEST_F(StringTest, CapacityAndReserve)
     ASSERT_EQ((size_t)128, s1.capacity()) << "capacity did not return expected value";
 }
 
+TEST_F(StringTest, ShortStringsInline)
+{
+    ASSERT_EQ(3 * sizeof(size_t), sizeof(ppl7::String)) << "String layout has changed";
+    ppl7::String s1("key");
+    ASSERT_EQ((size_t)3, s1.size());
+    ASSERT_EQ(sizeof(size_t) - 1, s1.capacity()) << "short string is not stored inline";
+    ASSERT_EQ(0, strcmp("key", s1.c_str()));
+    s1.append(" with a longer suffix");
+    ASSERT_EQ(ppl7::String("key with a longer suffix"), s1);
+    ASSERT_LT(sizeof(size_t) - 1, s1.capacity());
+    s1.set("abc");
+    ASSERT_EQ(ppl7::String("abc"), s1);
+    s1.prepend("x");
+    ASSERT_EQ(ppl7::String("xabc"), s1);
+}
+
+TEST_F(StringTest, MoveConstructorAndAssignment)
+{
+    ppl7::String shortstr("token");
+    ppl7::String longstr("The big brown fox jumps over the lazy dog");
+    const char* longptr=longstr.getPtr();
+    ppl7::String s1(std::move(shortstr));
+    ASSERT_EQ(ppl7::String("token"), s1);
+    ASSERT_TRUE(shortstr.isEmpty());
+    ppl7::String s2(std::move(longstr));
+    ASSERT_EQ(longptr, s2.getPtr()) << "long string was copied instead of moved";
+    ASSERT_TRUE(longstr.isEmpty());
+    s2=std::move(s1);
+    ASSERT_EQ(ppl7::String("token"), s2);
+    ASSERT_TRUE(s1.isEmpty());
+    s1=std::move(s2);
+    s1.append("s");
+    ASSERT_EQ(ppl7::String("tokens"), s1);
+}
+
+TEST_F(StringTest, ShrinkToFit)
+{
+    ppl7::String s1;
+    s1.shrink_to_fit();
+    ASSERT_EQ((size_t)0, s1.capacity());
+    s1.reserve(1000);
+    s1.set("The big brown fox jumps over the lazy dog");
+    ASSERT_EQ((size_t)1000, s1.capacity());
+    s1.shrink_to_fit();
+    ASSERT_EQ(s1.size(), s1.capacity());
+    ASSERT_EQ(ppl7::String("The big brown fox jumps over the lazy dog"), s1);
+    s1.reserve(1000);
+    s1.set("fox");
+    s1.shrink_to_fit();
+    ASSERT_EQ(sizeof(size_t) - 1, s1.capacity());
+    ASSERT_EQ(ppl7::String("fox"), s1);
+}
+
 TEST_F(StringTest, len)
 {
     ppl7::String s1("A test string with unicode characters: äöü");
@@ -0,0 +1,299 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <locale.h>
+#include <vector>
+#include <ppl7.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+class StringViewTest : public ::testing::Test {
+	protected:
+	StringViewTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+	}
+	virtual ~StringViewTest() {
+
+	}
+};
+
+TEST_F(StringViewTest, ConstructorDefault) {
+	ppl7::StringView v;
+	ASSERT_TRUE(v.isEmpty());
+	ASSERT_EQ((size_t)0,v.size());
+	ASSERT_TRUE(v.data()!=NULL);
+}
+
+TEST_F(StringViewTest, ConstructorFromCString) {
+	ppl7::StringView v("A test string");
+	ASSERT_EQ((size_t)13,v.size());
+	ASSERT_TRUE(v.notEmpty());
+	ASSERT_EQ('A',v[0]);
+	ASSERT_EQ('g',v[12]);
+	ppl7::StringView n((const char*)NULL);
+	ASSERT_TRUE(n.isEmpty());
+}
+
+TEST_F(StringViewTest, ConstructorFromString) {
+	ppl7::String s("A test string with more than the inline capacity");
+	ppl7::StringView v=s;
+	ASSERT_EQ(s.size(),v.size());
+	ASSERT_EQ((const void*)s.getPtr(),(const void*)v.data());
+}
+
+TEST_F(StringViewTest, ConstructorFromByteArrayPtr) {
+	const char* text="binary data";
+	ppl7::ByteArrayPtr p(text,6);
+	ppl7::StringView v(p);
+	ASSERT_EQ((size_t)6,v.size());
+	ASSERT_TRUE(v=="binary");
+	ppl7::ByteArrayPtr back=v.toByteArrayPtr();
+	ASSERT_EQ((const void*)text,back.ptr());
+	ASSERT_EQ((size_t)6,back.size());
+}
+
+TEST_F(StringViewTest, Slicing) {
+	ppl7::StringView v("Hello wonderful world");
+	ASSERT_TRUE(v.left(5)=="Hello");
+	ASSERT_TRUE(v.right(5)=="world");
+	ASSERT_TRUE(v.mid(6,9)=="wonderful");
+	ASSERT_TRUE(v.mid(16)=="world");
+	ASSERT_TRUE(v.mid(100).isEmpty());
+	ASSERT_TRUE(v.left(100)==v);
+	ASSERT_TRUE(v.right(100)==v);
+	ASSERT_EQ(v.data()+6,v.mid(6).data());
+}
+
+TEST_F(StringViewTest, Chop) {
+	ppl7::StringView v("Hello world");
+	v.chopLeft(6);
+	ASSERT_TRUE(v=="world");
+	v.chopRight(2);
+	ASSERT_TRUE(v=="wor");
+	v.chopRight(10);
+	ASSERT_TRUE(v.isEmpty());
+}
+
+TEST_F(StringViewTest, Trimmed) {
+	ppl7::StringView v(" \t\r\n  Hello world \n\t ");
+	ASSERT_TRUE(v.trimmed()=="Hello world");
+	ASSERT_TRUE(v.trimmedLeft()=="Hello world \n\t ");
+	ASSERT_TRUE(v.trimmedRight()==" \t\r\n  Hello world");
+	ASSERT_TRUE(ppl7::StringView("   ").trimmed().isEmpty());
+	ASSERT_TRUE(ppl7::StringView("").trimmed().isEmpty());
+}
+
+TEST_F(StringViewTest, Instr) {
+	ppl7::StringView v("The quick brown fox jumps over the lazy dog");
+	ASSERT_EQ((ssize_t)4,v.instr("quick"));
+	ASSERT_EQ((ssize_t)31,v.instr("the"));
+	ASSERT_EQ((ssize_t)-1,v.instr("cat"));
+	ASSERT_EQ((ssize_t)0,v.instr(""));
+	ASSERT_EQ((ssize_t)-1,v.instr("The",1));
+	ASSERT_EQ((ssize_t)10,v.instr('b'));
+	ASSERT_EQ((ssize_t)-1,v.instr('x',100));
+	// Der Bereich des Views darf nicht verlassen werden
+	ASSERT_EQ((ssize_t)-1,v.left(10).instr("brown"));
+	ASSERT_TRUE(v.has("fox"));
+	ASSERT_FALSE(v.left(10).has("fox"));
+	ASSERT_TRUE(v.startsWith("The quick"));
+	ASSERT_FALSE(v.startsWith("the quick"));
+	ASSERT_TRUE(v.endsWith("lazy dog"));
+	ASSERT_FALSE(v.left(5).endsWith("lazy dog"));
+}
+
+TEST_F(StringViewTest, Compare) {
+	ppl7::StringView a("abc"), b("abd"), c("ab");
+	ASSERT_TRUE(a==ppl7::StringView("abc"));
+	ASSERT_TRUE(a!=b);
+	ASSERT_TRUE(a<b);
+	ASSERT_TRUE(c<a);
+	ASSERT_LT(a.strcmp(b),0);
+	ASSERT_GT(a.strcmp(c),0);
+	ASSERT_EQ(0,a.strcmp("abc"));
+	ASSERT_EQ(0,a.strCaseCmp("ABC"));
+	ASSERT_LT(c.strCaseCmp("ABC"),0);
+	ppl7::String s("abc");
+	ASSERT_TRUE(a==s);
+}
+
+TEST_F(StringViewTest, GetToken) {
+	ppl7::StringView rest("key=value;;other=1;"), token;
+	ASSERT_TRUE(rest.getToken(";",token));
+	ASSERT_TRUE(token=="key=value");
+	ASSERT_TRUE(rest.getToken(";",token));
+	ASSERT_TRUE(token.isEmpty());
+	ASSERT_TRUE(rest.getToken(";",token));
+	ASSERT_TRUE(token=="other=1");
+	ASSERT_FALSE(rest.getToken(";",token));
+	ppl7::StringView single("no delimiter");
+	ASSERT_TRUE(single.getToken(",",token));
+	ASSERT_TRUE(token=="no delimiter");
+	ASSERT_TRUE(single.isEmpty());
+}
+
+TEST_F(StringViewTest, Explode) {
+	ppl7::StringView v("a,b,,c");
+	std::vector<ppl7::StringView> parts;
+	ASSERT_EQ((size_t)4,v.explode(parts,","));
+	ASSERT_EQ((size_t)4,parts.size());
+	ASSERT_TRUE(parts[0]=="a");
+	ASSERT_TRUE(parts[2].isEmpty());
+	ASSERT_TRUE(parts[3]=="c");
+	parts.clear();
+	ASSERT_EQ((size_t)3,v.explode(parts,",",0,true));
+	ASSERT_TRUE(parts[2]=="c");
+	parts.clear();
+	ASSERT_EQ((size_t)2,v.explode(parts,",",2));
+	ASSERT_TRUE(parts[1]=="b");
+}
+
+TEST_F(StringViewTest, ExplodeMatchesArray) {
+	const char* text="line1\n\nline3\nline4\n";
+	for (int skip=0;skip<2;skip++) {
+		for (size_t limit=0;limit<5;limit++) {
+			ppl7::Array a;
+			a.explode(text,"\n",limit,skip!=0);
+			std::vector<ppl7::StringView> parts;
+			ppl7::StringView(text).explode(parts,"\n",limit,skip!=0);
+			ASSERT_EQ(a.size(),parts.size()) << "limit=" << limit << ", skip=" << skip;
+			for (size_t i=0;i<parts.size();i++) {
+				ASSERT_TRUE(parts[i]==a[i]);
+			}
+		}
+	}
+}
+
+TEST_F(StringViewTest, ArrayExplodeFromView) {
+	ppl7::String s("ignored|a;b;c|ignored");
+	ppl7::Array a;
+	a.explode(ppl7::StringView(s).mid(8,5),";");
+	ASSERT_EQ((size_t)3,a.size());
+	ASSERT_EQ(ppl7::String("a"),a[0]);
+	ASSERT_EQ(ppl7::String("c"),a[2]);
+}
+
+TEST_F(StringViewTest, NumericConversion) {
+	ASSERT_EQ(1234,ppl7::StringView("1234abc").toInt());
+	ASSERT_EQ(-42,ppl7::StringView("  -42").toInt());
+	ASSERT_EQ((int64_t)9223372036854775807LL,ppl7::StringView("99999999999999999999").toInt64());
+	ASSERT_EQ((int64_t)(-9223372036854775807LL-1),ppl7::StringView("-9223372036854775808").toInt64());
+	ASSERT_EQ(123456789012LL,ppl7::StringView("123456789012").toLongLong());
+	ASSERT_EQ(12,ppl7::StringView("1234").left(2).toInt());
+	ASSERT_DOUBLE_EQ(3.25,ppl7::StringView("3.25xyz").toDouble());
+	ASSERT_DOUBLE_EQ(3.0,ppl7::StringView("3.25").left(1).toDouble());
+	ASSERT_TRUE(ppl7::StringView("123").isNumeric());
+	ASSERT_TRUE(ppl7::StringView("-1.5").isNumeric());
+	ASSERT_FALSE(ppl7::StringView("1.").isNumeric());
+	ASSERT_FALSE(ppl7::StringView("1-2").isNumeric());
+	ASSERT_TRUE(ppl7::StringView("-12").isInteger());
+	ASSERT_FALSE(ppl7::StringView("1.2").isInteger());
+}
+
+TEST_F(StringViewTest, ToBool) {
+	ASSERT_TRUE(ppl7::StringView("1").toBool());
+	ASSERT_TRUE(ppl7::StringView("yes").toBool());
+	ASSERT_TRUE(ppl7::StringView("TRUE").toBool());
+	ASSERT_TRUE(ppl7::StringView("Ja").toBool());
+	ASSERT_FALSE(ppl7::StringView("0").toBool());
+	ASSERT_FALSE(ppl7::StringView("no").toBool());
+	ASSERT_FALSE(ppl7::StringView("").toBool());
+	ASSERT_FALSE(ppl7::StringView("yes please").left(2).toBool());
+}
+
+TEST_F(StringViewTest, StringInterop) {
+	ppl7::String s("prefix");
+	ppl7::StringView v("Hello world");
+	s+=v.left(5);
+	ASSERT_EQ(ppl7::String("prefixHello"),s);
+	s=v.right(5);
+	ASSERT_EQ(ppl7::String("world"),s);
+	ppl7::String c(v.mid(2,3));
+	ASSERT_EQ(ppl7::String("llo"),c);
+	ASSERT_EQ(ppl7::String("world"),v.right(5).toString());
+	ASSERT_EQ(std::string("Hello"),v.left(5).toStdString());
+	// Anhängen eines Teils des eigenen Strings
+	ppl7::String self("abcdef");
+	self.append(ppl7::StringView(self).mid(1,3));
+	ASSERT_EQ(ppl7::String("abcdefbcd"),self);
+}
+
+TEST_F(StringViewTest, AssocArrayLookup) {
+	ppl7::AssocArray a;
+	a.set("section/key","value");
+	a.set("section/Number","42");
+	a.set("section/5","five");
+	a.set("other","1");
+	ppl7::StringView path("xxsection/keyxx");
+	ASSERT_TRUE(a.exists(path.mid(2,11)));
+	ASSERT_EQ(ppl7::String("value"),a.getString(path.mid(2,11)));
+	ASSERT_EQ(42,a.getInt(ppl7::StringView("section/number")));
+	ASSERT_EQ(ppl7::String("five"),a.getString(ppl7::StringView("section/05")));
+	ASSERT_EQ(ppl7::String("five"),a.getString("//section//5/"));
+	ASSERT_TRUE(a.isTrue(ppl7::StringView("other")));
+	ASSERT_FALSE(a.exists(path.left(9)));
+	ASSERT_FALSE(a.exists("section/key/sub"));
+	ASSERT_THROW(a.get(ppl7::StringView("section/missing")),ppl7::KeyNotFoundException);
+	ASSERT_THROW(a.get(ppl7::StringView("//")),ppl7::AssocArray::InvalidKeyException);
+}
+
+TEST_F(StringViewTest, HashAssocArrayLookup) {
+	ppl7::HashAssocArray a;
+	a.set("section/key","value");
+	ppl7::StringView path("section/key/more");
+	ASSERT_TRUE(a.exists(path.left(11)));
+	ASSERT_EQ(ppl7::String("value"),a.getString(path.left(11)));
+	ASSERT_FALSE(a.exists(path));
+}
+
+TEST_F(StringViewTest, AssocArrayViewLookup) {
+	ppl7::AssocArray a;
+	a.set("section/key","value");
+	ppl7::ByteArray bin;
+	a.exportBinary(bin);
+	ppl7::AssocArrayView view(bin.ptr(),bin.size());
+	ppl7::StringView path("section/key/more");
+	ASSERT_TRUE(view.exists(path.left(11)));
+	ASSERT_EQ(ppl7::String("value"),view.getString(path.left(11)));
+}
+
+}	// EOF namespace
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <locale.h>
+#include <atomic>
+#include <ppl7.h>
+#include <ppl7/core/taskexecutor.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+class TaskExecutorTest : public ::testing::Test {
+	protected:
+	TaskExecutorTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+	}
+	virtual ~TaskExecutorTest() {
+
+	}
+};
+
+TEST_F(TaskExecutorTest, Constructor) {
+	ppl7::TaskExecutor e1(3);
+	ASSERT_EQ((size_t)3,e1.threads());
+	ppl7::TaskExecutor e2;
+	ASSERT_GE(e2.threads(),(size_t)1);
+	ASSERT_EQ((size_t)0,e2.pendingTasks());
+}
+
+TEST_F(TaskExecutorTest, PostAndWait) {
+	ppl7::TaskExecutor e(4);
+	std::atomic<int> counter(0);
+	for (int i=0;i<10000;i++) {
+		e.post([&counter]() { counter++; });
+	}
+	e.wait();
+	ASSERT_EQ(10000,(int)counter);
+	ASSERT_EQ((size_t)0,e.pendingTasks());
+}
+
+TEST_F(TaskExecutorTest, DestructorRunsPendingTasks) {
+	std::atomic<int> counter(0);
+	{
+		ppl7::TaskExecutor e(2);
+		for (int i=0;i<1000;i++) {
+			e.post([&counter]() { counter++; });
+		}
+	}
+	ASSERT_EQ(1000,(int)counter);
+}
+
+TEST_F(TaskExecutorTest, SubmitReturnsResult) {
+	ppl7::TaskExecutor e(2);
+	std::future<int> f1=e.submit([]() { return 42; });
+	std::future<ppl7::String> f2=e.submit([]() { return ppl7::String("Hello World"); });
+	ASSERT_EQ(42,f1.get());
+	ASSERT_EQ(ppl7::String("Hello World"),f2.get());
+}
+
+TEST_F(TaskExecutorTest, SubmitTransportsException) {
+	ppl7::TaskExecutor e(2);
+	std::future<int> f=e.submit([]() -> int { throw ppl7::IllegalArgumentException(); });
+	ASSERT_THROW(f.get(),ppl7::IllegalArgumentException);
+	std::future<void> v=e.submit([]() { });
+	ASSERT_NO_THROW(v.get());
+}
+
+TEST_F(TaskExecutorTest, WaitRethrowsPostException) {
+	ppl7::TaskExecutor e(1);
+	std::atomic<int> counter(0);
+	e.post([]() { throw ppl7::IllegalArgumentException(); });
+	e.post([&counter]() { counter++; });
+	ASSERT_THROW(e.wait(),ppl7::IllegalArgumentException);
+	ASSERT_EQ(1,(int)counter);
+	e.post([&counter]() { counter++; });
+	ASSERT_NO_THROW(e.wait());
+	ASSERT_EQ(2,(int)counter);
+}
+
+TEST_F(TaskExecutorTest, TasksSpawnTasks) {
+	ppl7::TaskExecutor e(4);
+	std::atomic<int> counter(0);
+	for (int i=0;i<100;i++) {
+		e.post([&e, &counter]() {
+			for (int j=0;j<100;j++) e.post([&counter]() { counter++; });
+		});
+	}
+	e.wait();
+	ASSERT_EQ(10000,(int)counter);
+}
+
+TEST_F(TaskExecutorTest, ParallelFor) {
+	ppl7::TaskExecutor e(4);
+	std::vector<int> values(100000,0);
+	e.parallelFor((size_t)0,values.size(),[&values](size_t i) {
+		values[i]=(int)i*2;
+	});
+	for (size_t i=0;i<values.size();i++) ASSERT_EQ((int)i*2,values[i]);
+}
+
+TEST_F(TaskExecutorTest, ParallelForGrainAndEmptyRange) {
+	ppl7::TaskExecutor e(3);
+	std::atomic<int> counter(0);
+	e.parallelFor(10,10,[&counter](int) { counter++; });
+	e.parallelFor(10,5,[&counter](int) { counter++; });
+	ASSERT_EQ(0,(int)counter);
+	e.parallelFor(-50,51,[&counter](int) { counter++; },7);
+	ASSERT_EQ(101,(int)counter);
+	e.parallelFor(0,1,[&counter](int) { counter++; });
+	ASSERT_EQ(102,(int)counter);
+}
+
+TEST_F(TaskExecutorTest, ParallelForRethrowsException) {
+	ppl7::TaskExecutor e(4);
+	std::atomic<int> counter(0);
+	ASSERT_THROW({
+		e.parallelFor(0,1000,[&counter](int i) {
+			counter++;
+			if (i==500) throw ppl7::IllegalArgumentException();
+		},10);
+	},ppl7::IllegalArgumentException);
+	ASSERT_EQ((size_t)0,e.pendingTasks());
+}
+
+TEST_F(TaskExecutorTest, NestedParallelFor) {
+	ppl7::TaskExecutor e(2);
+	std::atomic<int> counter(0);
+	e.parallelFor(0,20,[&e, &counter](int) {
+		e.parallelFor(0,100,[&counter](int) { counter++; },10);
+	},1);
+	ASSERT_EQ(2000,(int)counter);
+}
+
+TEST_F(TaskExecutorTest, ParallelReduce) {
+	ppl7::TaskExecutor e(4);
+	uint64_t sum=e.parallelReduce((uint64_t)1,(uint64_t)100001,(uint64_t)0,
+		[](uint64_t i) { return i; },
+		[](uint64_t a, uint64_t b) { return a+b; });
+	ASSERT_EQ((uint64_t)5000050000ULL,sum);
+	ASSERT_EQ(7,e.parallelReduce(0,0,7,
+		[](int i) { return i; },
+		[](int a, int b) { return a+b; }));
+}
+
+TEST_F(TaskExecutorTest, ParallelReduceKeepsOrder) {
+	ppl7::TaskExecutor e(4);
+	ppl7::String result=e.parallelReduce(0,26,ppl7::String(),
+		[](int i) { ppl7::String s; s.setf("%c",'a'+i); return s; },
+		[](const ppl7::String &a, const ppl7::String &b) { return a+b; },2);
+	ASSERT_EQ(ppl7::String("abcdefghijklmnopqrstuvwxyz"),result);
+}
+
+}	// EOF namespace
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ppl7.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static size_t BufferSize=64;
+static int Rounds=10;
+
+static void printResult(const char *descr, double duration, uint32_t result)
+{
+	double bytes=(double)BufferSize*1024.0*1024.0*(double)Rounds;
+	printf ("%-40s %10.3f %10.2f   %08x\n",descr,duration,bytes/duration/1000000000.0,result);
+	fflush(NULL);
+}
+
+// Bisherige Implementierungen zum Vergleich
+static uint32_t crc32Bytewise(const unsigned char *buffer, size_t size)
+{
+	static uint32_t table[256];
+	if (!table[1]) {
+		for (uint32_t i=0;i<256;i++) {
+			uint32_t c=i;
+			for (int k=0;k<8;k++) c=(c&1) ? (c>>1)^0xedb88320 : c>>1;
+			table[i]=c;
+		}
+	}
+	uint32_t crc=0xffffffff;
+	while (size--) crc=(crc>>8)^table[(crc&0xff)^*buffer++];
+	return crc^0xffffffff;
+}
+
+static uint32_t adler32Modulo(const unsigned char *buffer, size_t size)
+{
+	uint32_t s1=1, s2=0;
+	for (size_t n=0;n<size;n++) {
+		s1=(s1+buffer[n])%65521;
+		s2=(s2+s1)%65521;
+	}
+	return (s2<<16)|s1;
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-s")) BufferSize=ppl7::GetArgv(argc,argv,"-s").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-r")) Rounds=ppl7::GetArgv(argc,argv,"-r").toInt();
+	if (BufferSize<1) BufferSize=1;
+	if (Rounds<1) Rounds=1;
+	ppl7::ByteArray data;
+	data.malloc(BufferSize*1024*1024);
+	unsigned char *p=(unsigned char*)data.ptr();
+	for (size_t i=0;i<data.size();i++) p[i]=(unsigned char)(i*7+(i>>8));
+	uint32_t caps=ppl7::GetCPUCaps();
+	printf ("Buffer: %d MB, %d rounds, PCLMULQDQ: %s\n\n",(int)BufferSize,Rounds,
+		(caps&ppl7::CPUCAPS::CPU_HAVE_PCLMUL) ? "yes" : "no");
+	printf ("%-40s %10s %10s   %s\n","Test","seconds","GB/s","result");
+
+	uint32_t result=0;
+	double start=ppl7::GetMicrotime();
+	for (int r=0;r<Rounds;r++) result=crc32Bytewise(p,data.size());
+	printResult("crc32, bytewise table",ppl7::GetMicrotime()-start,result);
+
+	start=ppl7::GetMicrotime();
+	for (int r=0;r<Rounds;r++) result=ppl7::Crc32(p,data.size());
+	printResult("ppl7::Crc32",ppl7::GetMicrotime()-start,result);
+
+	start=ppl7::GetMicrotime();
+	for (int r=0;r<Rounds;r++) {
+		result=0;
+		for (size_t pos=0;pos<data.size();pos+=65536) result=ppl7::Crc32(result,p+pos,65536);
+	}
+	printResult("ppl7::Crc32, 64 KB chunks",ppl7::GetMicrotime()-start,result);
+
+	start=ppl7::GetMicrotime();
+	for (int r=0;r<Rounds;r++) result=adler32Modulo(p,data.size());
+	printResult("adler32, modulo per byte",ppl7::GetMicrotime()-start,result);
+
+	start=ppl7::GetMicrotime();
+	for (int r=0;r<Rounds;r++) result=ppl7::Adler32(p,data.size());
+	printResult("ppl7::Adler32",ppl7::GetMicrotime()-start,result);
+	return 0;
+}
@@ -0,0 +1,227 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <map>
+#include <ppl7.h>
+#include <ppl7-crypto.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+
+namespace {
+
+static const char* basedir="tmp/digestbatch";
+
+class DigestBatchTest : public ::testing::Test {
+	protected:
+		std::map<ppl7::String, ppl7::ByteArray> content;
+
+	DigestBatchTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		ppl7::Dir::mkDir(ppl7::String(basedir)+"/sub/deeper",true);
+		createFile("empty.bin",0);
+		createFile("one.bin",1);
+		createFile("small.bin",1000);
+		createFile("chunk.bin",65536);
+		createFile("large.bin",300000);
+		createFile("sub/medium.bin",70001);
+		createFile("sub/deeper/big.bin",1024*1024+17);
+	}
+	virtual ~DigestBatchTest() {
+
+	}
+
+	void createFile(const char* name, size_t size) {
+		ppl7::String filename=ppl7::String(basedir)+"/"+name;
+		ppl7::ByteArray data;
+		unsigned char *p=(unsigned char*)data.calloc(size+1);
+		uint32_t seed=(uint32_t)size;
+		for (size_t i=0;i<size;i++) {
+			seed=seed*1103515245+12345;
+			p[i]=(unsigned char)(seed>>16);
+		}
+		data.truncate(size);
+		ppl7::File::save(data,filename);
+		content[filename]=ppl7::ByteArrayPtr(data);
+	}
+
+	std::vector<ppl7::String> fileList() const {
+		std::vector<ppl7::String> files;
+		std::map<ppl7::String, ppl7::ByteArray>::const_iterator it;
+		for (it=content.begin();it!=content.end();++it) files.push_back(it->first);
+		return files;
+	}
+};
+
+// Referenzimplementierung des Baum-Hashes mit einem Thread
+static ppl7::ByteArray referenceTree(const ppl7::ByteArrayPtr &data, size_t chunksize, ppl7::Digest::Algorithm algo)
+{
+	ppl7::Digest d(algo);
+	std::vector<ppl7::ByteArray> level;
+	size_t pos=0;
+	do {
+		size_t bytes=data.size()-pos;
+		if (bytes>chunksize) bytes=chunksize;
+		d.addData("\0",1);
+		if (bytes) d.addData((const char*)data.ptr()+pos,bytes);
+		level.push_back(d.getDigest());
+		pos+=bytes;
+	} while (pos<data.size());
+	while (level.size()>1) {
+		std::vector<ppl7::ByteArray> next;
+		for (size_t i=0;i<level.size();i+=2) {
+			if (i+1<level.size()) {
+				d.addData("\1",1);
+				d.addData(level[i]);
+				d.addData(level[i+1]);
+				next.push_back(d.getDigest());
+			} else {
+				next.push_back(level[i]);
+			}
+		}
+		level.swap(next);
+	}
+	return level[0];
+}
+
+TEST_F(DigestBatchTest, HashFilesMatchesDigest) {
+	std::vector<ppl7::String> files=fileList();
+	std::vector<ppl7::DigestBatch::Result> results;
+	uint64_t total=0;
+	for (size_t i=0;i<files.size();i++) total+=content[files[i]].size();
+	for (int mmap=0;mmap<2;mmap++) {
+		ppl7::DigestBatch batch(ppl7::Digest::Algo_SHA256,4);
+		batch.setBufferSize(65536);
+		batch.setUseMmap(mmap==1);
+		ASSERT_NO_THROW(batch.hashFiles(files,results));
+		ASSERT_EQ(files.size(),results.size());
+		for (size_t i=0;i<files.size();i++) {
+			ASSERT_TRUE(results[i].ok()) << results[i].Error;
+			ASSERT_EQ(files[i],results[i].Filename);
+			ASSERT_EQ((uint64_t)content[files[i]].size(),results[i].Size);
+			ASSERT_EQ(ppl7::Digest::sha256(content[files[i]]),results[i].Hash) << files[i];
+		}
+		ASSERT_EQ(total,batch.bytesHashed());
+		ASSERT_GE(batch.elapsed(),0.0);
+	}
+}
+
+TEST_F(DigestBatchTest, OtherAlgorithms) {
+	std::vector<ppl7::String> files=fileList();
+	std::vector<ppl7::DigestBatch::Result> results;
+	ppl7::DigestBatch batch(ppl7::Digest::Algo_MD5);
+	ASSERT_NO_THROW(batch.hashFiles(files,results));
+	for (size_t i=0;i<files.size();i++) {
+		ASSERT_EQ(ppl7::Digest::md5(content[files[i]]),results[i].Hash);
+	}
+	batch.setAlgorithm(ppl7::Digest::Algo_SHA512);
+	batch.setThreads(1);
+	ASSERT_NO_THROW(batch.hashFiles(files,results));
+	for (size_t i=0;i<files.size();i++) {
+		ASSERT_EQ(ppl7::Digest::sha512(content[files[i]]),results[i].Hash);
+	}
+}
+
+TEST_F(DigestBatchTest, MissingFileReportsError) {
+	std::vector<ppl7::String> files=fileList();
+	files.insert(files.begin()+1,ppl7::String(basedir)+"/does_not_exist.bin");
+	std::vector<ppl7::DigestBatch::Result> results;
+	ppl7::DigestBatch batch;
+	ASSERT_NO_THROW(batch.hashFiles(files,results));
+	ASSERT_EQ(files.size(),results.size());
+	ASSERT_FALSE(results[1].ok());
+	ASSERT_TRUE(results[1].Hash.isEmpty());
+	for (size_t i=0;i<files.size();i++) {
+		if (i==1) continue;
+		ASSERT_TRUE(results[i].ok());
+		ASSERT_EQ(ppl7::Digest::sha256(content[files[i]]),results[i].Hash);
+	}
+	std::vector<ppl7::String> none;
+	ASSERT_NO_THROW(batch.hashFiles(none,results));
+	ASSERT_EQ((size_t)0,results.size());
+}
+
+TEST_F(DigestBatchTest, HashDirectory) {
+	std::vector<ppl7::DigestBatch::Result> results;
+	ppl7::DigestBatch batch(ppl7::Digest::Algo_SHA1);
+	ASSERT_NO_THROW(batch.hashDirectory(basedir,results,false));
+	ASSERT_EQ((size_t)5,results.size());
+	ASSERT_NO_THROW(batch.hashDirectory(basedir,results,true));
+	ASSERT_EQ(content.size(),results.size());
+	for (size_t i=0;i<results.size();i++) {
+		ASSERT_TRUE(results[i].ok());
+		ASSERT_TRUE(content.find(results[i].Filename)!=content.end()) << results[i].Filename;
+		ASSERT_EQ(ppl7::Digest::sha1(content[results[i].Filename]),results[i].Hash);
+	}
+	ASSERT_THROW(batch.hashDirectory(ppl7::String(basedir)+"/nonexisting",results),ppl7::Exception);
+}
+
+TEST_F(DigestBatchTest, TreeHash) {
+	ppl7::DigestBatch batch(ppl7::Digest::Algo_SHA256,4);
+	batch.setChunkSize(65536);
+	std::map<ppl7::String, ppl7::ByteArray>::const_iterator it;
+	for (it=content.begin();it!=content.end();++it) {
+		ppl7::ByteArray expected=referenceTree(it->second,65536,ppl7::Digest::Algo_SHA256);
+		ASSERT_EQ(expected,batch.treeHash(it->second)) << it->first;
+		batch.setUseMmap(true);
+		ASSERT_EQ(expected,batch.treeHash(it->first)) << it->first;
+		ASSERT_EQ((uint64_t)it->second.size(),batch.bytesHashed());
+		batch.setUseMmap(false);
+		ASSERT_EQ(expected,batch.treeHash(it->first)) << it->first;
+	}
+	// Ein einzelner Block ist H(0x00 | Daten)
+	ppl7::ByteArray small=content[ppl7::String(basedir)+"/small.bin"];
+	ppl7::ByteArray prefixed;
+	prefixed.copy("\0",1);
+	prefixed.append(small);
+	ASSERT_EQ(ppl7::Digest::sha256(prefixed),batch.treeHash(small));
+	// Die Blockgröße geht in das Ergebnis ein
+	ppl7::ByteArray large=content[ppl7::String(basedir)+"/large.bin"];
+	ppl7::ByteArray root=batch.treeHash(large);
+	batch.setChunkSize(4096);
+	ASSERT_NE(root,batch.treeHash(large));
+	ASSERT_EQ(referenceTree(large,4096,ppl7::Digest::Algo_SHA256),batch.treeHash(large));
+	ASSERT_THROW(batch.setChunkSize(0),ppl7::IllegalArgumentException);
+	ASSERT_THROW(batch.treeHash(ppl7::String(basedir)+"/does_not_exist.bin"),ppl7::Exception);
+}
+
+}	// EOF namespace
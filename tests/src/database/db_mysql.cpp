@@ -361,6 +361,36 @@ TEST_F(DBMySQLTest, queryFetchFields) {
 	});
 }
 
+TEST_F(DBMySQLTest, streamQuery) {
+	ppl7::AssocArray params;
+	PPL7TestConfig.copySection(params, "mysql");
+	ppl7::db::MySQL db;
+	ASSERT_NO_THROW({
+		db.connect(params);
+	});
+	ppl7::db::ResultSet *res;
+	ASSERT_NO_THROW({
+		res=db.streamQuery("select userid,name,surename,age from user order by userid");
+	});
+	ASSERT_TRUE(res!=NULL);
+	ASSERT_EQ(4,res->fields());
+	ASSERT_EQ(ppl7::String("1"),res->getString("userid"));
+	ASSERT_EQ(ppl7::String("Fedick"),res->getString("name"));
+	size_t rows=0;
+	ASSERT_NO_THROW({
+		while (!res->eof()) {
+			res->nextRow();
+			rows++;
+		}
+	});
+	ASSERT_EQ((size_t)4,rows);
+	delete res;
+	// Nach dem Löschen des ResultSets ist die Verbindung wieder frei
+	ASSERT_NO_THROW({
+		ASSERT_EQ((uint64_t)4, db.count("user"));
+	});
+}
+
 TEST_F(DBMySQLTest, count) {
 	ppl7::AssocArray params;
 	PPL7TestConfig.copySection(params, "mysql");
@@ -37,6 +37,35 @@
 #include <gtest/gtest.h>
 #include "ppl7-tests.h"
 #include <list>
+#include <vector>
+#include <new>
+
+/*
+ * Zählt die Heap-Allokationen des aktuellen Threads, solange count_allocations gesetzt ist.
+ * Damit lässt sich prüfen, dass beim Streamen eines Ergebnisses nicht pro Zeile Speicher
+ * angefordert wird.
+ */
+static thread_local bool count_allocations=false;
+static thread_local size_t allocations=0;
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+	if (count_allocations) allocations++;
+	void* p=malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+// noinline, sonst bemängelt der Compiler ein free() auf mit new angeforderten Speicher
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
 
 namespace {
 
@@ -504,6 +533,384 @@ TEST_F(DBSQLiteTest, execInsertAndCount) {
 	});
 }
 
+TEST_F(DBSQLiteTest, prepareExecAndQuery) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	ASSERT_NO_THROW({
+		db.connect(params);
+		db.exec("drop table if exists test_prepared");
+		db.exec("create table test_prepared (id integer not null, name text, value real, data blob)");
+	});
+	std::shared_ptr<ppl7::db::Statement> stmt=db.prepare("insert into test_prepared (id,name,value,data) values (?,?,?,?)");
+	ASSERT_TRUE(stmt!=NULL);
+	ASSERT_EQ(4,stmt->params());
+	ASSERT_EQ(stmt,db.prepare("insert into test_prepared (id,name,value,data) values (?,?,?,?)"));
+	ASSERT_EQ((size_t)1,db.cachedStatements());
+	ppl7::ByteArray bin("a\0b",3);
+	ASSERT_NO_THROW({
+		for (int i=1;i<=3;i++) {
+			stmt->bind(1,i);
+			stmt->bind(2,ppl7::ToString("O'Name %d",i));
+			stmt->bind(3,1.5*i);
+			stmt->bind(4,bin);
+			stmt->exec();
+			ASSERT_EQ((uint64_t)1,stmt->affected());
+		}
+		stmt->clearBindings();
+		stmt->bind(1,(int64_t)4);
+		stmt->exec();
+	});
+	ASSERT_THROW(stmt->bind(5,1), ppl7::IllegalArgumentException);
+	ASSERT_EQ((uint64_t)4, db.count("test_prepared"));
+
+	std::shared_ptr<ppl7::db::Statement> select=db.prepare("select id,name,value,length(data) as len from test_prepared where id>=? order by id");
+	select->bind(1,2);
+	ppl7::db::ResultSet *res=select->query();
+	ASSERT_TRUE(res!=NULL);
+	ASSERT_EQ(4,res->fields());
+	ASSERT_EQ(ppl7::String("2"),res->getString("id"));
+	ASSERT_EQ(ppl7::String("O'Name 2"),res->getString("name"));
+	ASSERT_EQ(ppl7::String("3.0"),res->getString("value"));
+	ASSERT_EQ(ppl7::String("3"),res->getString("len"));
+	res->nextRow();
+	res->nextRow();
+	ASSERT_EQ(ppl7::String("4"),res->getString("id"));
+	ASSERT_EQ(ppl7::String(""),res->getString("name"));
+	res->nextRow();
+	ASSERT_TRUE(res->eof());
+	delete res;
+
+	// Ein offenes Ergebnis wird bei erneuter Ausführung ungültig
+	select->bind(1,1);
+	res=select->query();
+	ASSERT_FALSE(res->eof());
+	ppl7::db::ResultSet *res2=select->query();
+	ASSERT_TRUE(res->eof());
+	ASSERT_EQ(ppl7::String("1"),res2->getString("id"));
+	delete res;
+	delete res2;
+}
+
+TEST_F(DBSQLiteTest, prepareStatementCache) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	db.setStatementCacheSize(2);
+	ASSERT_EQ((size_t)2,db.statementCacheSize());
+	std::shared_ptr<ppl7::db::Statement> s1=db.prepare("select 1");
+	std::shared_ptr<ppl7::db::Statement> s2=db.prepare("select 2");
+	// "select 1" wird zuletzt verwendet, daher wird "select 2" verdrängt
+	ASSERT_EQ(s1,db.prepare("select 1"));
+	db.prepare("select 3");
+	ASSERT_EQ((size_t)2,db.cachedStatements());
+	ASSERT_EQ(s1,db.prepare("select 1"));
+	// Das verdrängte Statement wird noch gehalten und bleibt benutzbar
+	ppl7::db::ResultSet *res=s2->query();
+	ASSERT_EQ(ppl7::String("2"),res->getString(0));
+	delete res;
+	ASSERT_NE(s2,db.prepare("select 2"));
+	res=s1->query();
+	db.setStatementCacheSize(0);
+	ASSERT_EQ((size_t)2,db.cachedStatements());
+	db.close();
+	ASSERT_EQ((size_t)0,db.cachedStatements());
+	// Das Statement wurde von der Verbindung getrennt, das ResultSet ist noch gültig, aber leer
+	ASSERT_TRUE(res->eof());
+	delete res;
+	ASSERT_THROW(s1->query(), ppl7::NoConnectionException);
+	ASSERT_THROW(s2->bind(1,1), ppl7::NoConnectionException);
+	ASSERT_THROW(db.prepare("select 1"), ppl7::NoConnectionException);
+	db.connect(params);
+	ASSERT_THROW(db.prepare("select from"), ppl7::QueryFailedException);
+	ASSERT_EQ((size_t)0,db.cachedStatements());
+}
+
+static void createBulkTable(ppl7::db::Database &db)
+{
+	db.exec("drop table if exists test_bulk");
+	db.exec("create table test_bulk (id integer primary key, name text)");
+}
+
+static std::list<ppl7::Array> bulkRows(int from, int num)
+{
+	std::list<ppl7::Array> rows;
+	for (int i=from;i<from+num;i++) {
+		ppl7::Array row;
+		row.add(ppl7::ToString("%d",i));
+		row.add(ppl7::ToString("Name's %d",i));
+		rows.push_back(row);
+	}
+	return rows;
+}
+
+TEST_F(DBSQLiteTest, bulkInsert) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	createBulkTable(db);
+	ppl7::Array columns("id name"," ");
+	ASSERT_NO_THROW({
+		db.bulkInsert("test_bulk",columns,bulkRows(1,250),100);
+	});
+	ASSERT_EQ((uint64_t)250, db.count("test_bulk"));
+	// Generische Implementierung mit mehrzeiligen INSERTs
+	ASSERT_NO_THROW({
+		db.Database::bulkInsert("test_bulk",columns,bulkRows(251,250),100);
+	});
+	ASSERT_EQ((uint64_t)500, db.count("test_bulk"));
+	ppl7::AssocArray row;
+	db.execArray(row,"select * from test_bulk where id=300");
+	ASSERT_EQ(ppl7::String("Name's 300"),row.getString("name"));
+
+	// Eine fehlerhafte Zeile im letzten Block, es darf kein vorheriger Block eingefügt werden
+	std::list<ppl7::Array> rows=bulkRows(501,250);
+	rows.back().add("too much");
+	ASSERT_THROW(db.bulkInsert("test_bulk",columns,rows,100), ppl7::IllegalArgumentException);
+	ASSERT_EQ((uint64_t)500, db.count("test_bulk"));
+	ASSERT_THROW(db.Database::bulkInsert("test_bulk",columns,rows,100), ppl7::IllegalArgumentException);
+	ASSERT_EQ((uint64_t)500, db.count("test_bulk"));
+	// Doppelter Primärschlüssel, der ganze Block wird zurückgerollt
+	ASSERT_THROW(db.bulkInsert("test_bulk",columns,bulkRows(495,10),100), ppl7::QueryFailedException);
+	ASSERT_EQ((uint64_t)500, db.count("test_bulk"));
+	// Der Fehler in der ersten Zeile darf keine offene Transaktion hinterlassen
+	ASSERT_NO_THROW(db.exec("BEGIN"));
+	ASSERT_NO_THROW(db.exec("ROLLBACK"));
+}
+
+TEST_F(DBSQLiteTest, bulkInsertInsideTransaction) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	createBulkTable(db);
+	ppl7::Array columns("id name"," ");
+	// Die Transaktion des Aufrufers bleibt offen und kann zurückgerollt werden
+	db.startTransaction();
+	ASSERT_NO_THROW({
+		db.bulkInsert("test_bulk",columns,bulkRows(1,250),100);
+	});
+	ASSERT_EQ((uint64_t)250, db.count("test_bulk"));
+	db.cancelTransaction();
+	ASSERT_EQ((uint64_t)0, db.count("test_bulk"));
+
+	// Ein fehlerhafter Block verwirft nur den eigenen Savepoint
+	db.exec("BEGIN");
+	db.bulkInsert("test_bulk",columns,bulkRows(1,10),100);
+	ASSERT_THROW(db.bulkInsert("test_bulk",columns,bulkRows(5,10),100), ppl7::QueryFailedException);
+	ASSERT_EQ((uint64_t)10, db.count("test_bulk"));
+	db.exec("COMMIT");
+	ASSERT_EQ((uint64_t)10, db.count("test_bulk"));
+}
+
+TEST_F(DBSQLiteTest, BulkWriter) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	createBulkTable(db);
+	ppl7::db::BulkWriter writer(db,"test_bulk",ppl7::Array("id name"," "),100);
+	ASSERT_EQ((size_t)100,writer.batchSize());
+	std::list<ppl7::Array> rows=bulkRows(1,150);
+	std::list<ppl7::Array>::const_iterator it;
+	for (it=rows.begin();it!=rows.end();++it) writer.add(*it);
+	ASSERT_EQ((uint64_t)100,writer.written());
+	ASSERT_EQ((size_t)50,writer.pending());
+	ASSERT_EQ((uint64_t)100, db.count("test_bulk"));
+	ppl7::AssocArray a;
+	a.set("name","Assoc");
+	a.set("id","1000");
+	a.set("ignored","x");
+	writer.add(a);
+	a.remove("name");
+	ASSERT_THROW(writer.add(a), ppl7::KeyNotFoundException);
+	ASSERT_THROW(writer.add(ppl7::Array("1"," ")), ppl7::IllegalArgumentException);
+	writer.flush();
+	ASSERT_EQ((uint64_t)151,writer.written());
+	ASSERT_EQ((size_t)0,writer.pending());
+	ASSERT_EQ((uint64_t)151, db.count("test_bulk"));
+}
+
+
+static void createStreamTable(ppl7::db::Database& db, int num)
+{
+	db.exec("drop table if exists test_stream");
+	db.exec("create table test_stream (id integer primary key, value real, name text)");
+	ppl7::db::BulkWriter writer(db,"test_stream",ppl7::Array("id value name"," "),1000);
+	for (int i=1;i<=num;i++) {
+		ppl7::Array row;
+		row.add(ppl7::ToString("%d",i));
+		row.add(ppl7::ToString("%d.5",i));
+		row.add(ppl7::ToString("Name %06d",i));
+		writer.add(row);
+	}
+	writer.flush();
+}
+
+TEST_F(DBSQLiteTest, queryTypedGetters) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	createStreamTable(db,2);
+	db.exec("insert into test_stream (id,value,name) values (3,NULL,NULL)");
+	ppl7::db::ResultSet* res=db.query("select id, value, name from test_stream order by id");
+	ASSERT_TRUE(res != NULL);
+	ASSERT_EQ((int64_t)1,res->getInt64(0));
+	ASSERT_EQ(1.5,res->getDouble(1));
+	ASSERT_EQ(ppl7::StringView("Name 000001"),res->getView(2));
+	ASSERT_FALSE(res->isNull(2));
+	ASSERT_THROW(res->getInt64(3), ppl7::FieldNotInResultSetException);
+	ASSERT_THROW(res->getView(-1), ppl7::FieldNotInResultSetException);
+	res->nextRow();
+	ASSERT_EQ((int64_t)2,res->getInt64(0));
+	ASSERT_EQ((int64_t)2,res->getInt64(1));
+	ASSERT_EQ(2.0,res->getDouble(0));
+	res->nextRow();
+	ASSERT_EQ((int64_t)3,res->getInt64(0));
+	ASSERT_TRUE(res->isNull(1));
+	ASSERT_TRUE(res->isNull(2));
+	ASSERT_EQ((size_t)0,res->getView(2).size());
+	res->nextRow();
+	ASSERT_TRUE(res->eof());
+	ASSERT_THROW(res->getInt64(0), ppl7::NoResultException);
+	ASSERT_THROW(res->getView(0), ppl7::NoResultException);
+	delete res;
+}
+
+/*
+ * ResultSet, das nur die rein virtuellen Funktionen implementiert, wie ein Treiber, der die
+ * typisierten Funktionen noch nicht kennt
+ */
+class ForwardingResult : public ppl7::db::ResultSet
+{
+	public:
+		ppl7::db::ResultSet* res;
+		ForwardingResult(ppl7::db::ResultSet* r) { res=r; }
+		~ForwardingResult() { delete res; }
+		void clear() { res->clear(); }
+		uint64_t affected() const { return res->affected(); }
+		int fields() const { return res->fields(); }
+		ppl7::String getString(const ppl7::String& fieldname) { return res->getString(fieldname); }
+		ppl7::String getString(int field) { return res->getString(field); }
+		int fieldNum(const ppl7::String& fieldname) { return res->fieldNum(fieldname); }
+		ppl7::String fieldName(int field) { return res->fieldName(field); }
+		FieldType fieldType(int field) { return res->fieldType(field); }
+		FieldType fieldType(const ppl7::String& fieldname) { return res->fieldType(fieldname); }
+		ppl7::AssocArray fetchArray() { return res->fetchArray(); }
+		void fetchArray(ppl7::AssocArray& array) { res->fetchArray(array); }
+		ppl7::Array fetchFields() { return res->fetchFields(); }
+		void fetchFields(ppl7::Array& array) { res->fetchFields(array); }
+		void nextRow() { res->nextRow(); }
+		bool eof() { return res->eof(); }
+};
+
+TEST_F(DBSQLiteTest, queryTypedGettersDefaultImplementation) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	createStreamTable(db,2);
+	ForwardingResult res(db.query("select id, value, name from test_stream order by id"));
+	ASSERT_EQ((int64_t)1,res.getInt64(0));
+	ASSERT_EQ(1.5,res.getDouble(1));
+	ASSERT_EQ(ppl7::StringView("Name 000001"),res.getView(2));
+	ASSERT_FALSE(res.isNull(2));
+	std::vector<ppl7::db::ResultColumn> columns;
+	ASSERT_EQ((size_t)2,res.fetchColumns(columns,10));
+	ASSERT_EQ((int64_t)2,columns[0].integers[1]);
+	ASSERT_EQ(ppl7::StringView("Name 000002"),columns[2].getView(1));
+}
+
+TEST_F(DBSQLiteTest, queryFetchColumns) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	createStreamTable(db,1000);
+	ppl7::db::ResultSet* res=db.streamQuery("select id, value, name from test_stream order by id");
+	ASSERT_TRUE(res != NULL);
+	std::vector<ppl7::db::ResultColumn> columns;
+	ASSERT_EQ((size_t)300,res->fetchColumns(columns,300));
+	ASSERT_EQ((size_t)3,columns.size());
+	ASSERT_EQ(ppl7::db::ResultSet::TYPE_INTEGER,columns[0].type);
+	ASSERT_EQ(ppl7::db::ResultSet::TYPE_FLOAT,columns[1].type);
+	ASSERT_EQ(ppl7::db::ResultSet::TYPE_STRING,columns[2].type);
+	ASSERT_EQ((size_t)300,columns[0].rows());
+	ASSERT_EQ((size_t)300,columns[0].integers.size());
+	ASSERT_EQ((size_t)300,columns[1].doubles.size());
+	ASSERT_EQ((int64_t)1,columns[0].integers[0]);
+	ASSERT_EQ(300.5,columns[1].doubles[299]);
+	ASSERT_EQ(ppl7::StringView("Name 000017"),columns[2].getView(16));
+	ASSERT_FALSE(columns[2].isNull(16));
+	ASSERT_THROW(columns[2].getView(300), ppl7::OutOfBoundsException);
+	size_t total=300;
+	int64_t expected=301;
+	size_t num;
+	while ((num=res->fetchColumns(columns,300)) > 0) {
+		ASSERT_EQ(expected,columns[0].integers[0]);
+		ASSERT_EQ(ppl7::ToString("Name %06d",(int)expected),columns[2].getView(0).toString());
+		total+=num;
+		expected+=num;
+	}
+	ASSERT_EQ((size_t)1000,total);
+	ASSERT_EQ((size_t)0,columns[0].rows());
+	ASSERT_TRUE(res->eof());
+	delete res;
+}
+
+TEST_F(DBSQLiteTest, streamQueryMemoryUsage) {
+	ppl7::AssocArray params;
+	params.set("filename","tmp/sqlite_test.db");
+	ppl7::db::SQLite db;
+	db.connect(params);
+	createStreamTable(db,20000);
+
+	// Typisierte Getter erzeugen keine Objekte pro Zeile
+	ppl7::db::ResultSet* res=db.streamQuery("select id, value, name from test_stream");
+	int64_t sum=0;
+	size_t bytes=0;
+	allocations=0;
+	count_allocations=true;
+	while (!res->eof()) {
+		sum+=res->getInt64(0);
+		bytes+=res->getView(2).size();
+		res->nextRow();
+	}
+	count_allocations=false;
+	delete res;
+	ASSERT_EQ((int64_t)20000 * 20001 / 2,sum);
+	ASSERT_EQ((size_t)20000 * 11,bytes);
+	ASSERT_EQ((size_t)0,allocations);
+
+	// Spaltenweises Lesen verwendet den Speicher der Spalten wieder
+	res=db.streamQuery("select id, value, name from test_stream");
+	std::vector<ppl7::db::ResultColumn> columns;
+	res->fetchColumns(columns,1000);
+	size_t capacity=columns[2].data.capacity();
+	size_t rows=1000;
+	allocations=0;
+	count_allocations=true;
+	size_t num;
+	while ((num=res->fetchColumns(columns,1000)) > 0) rows+=num;
+	count_allocations=false;
+	delete res;
+	ASSERT_EQ((size_t)20000,rows);
+	ASSERT_EQ((size_t)0,allocations);
+	ASSERT_EQ(capacity,columns[2].data.capacity());
+
+	// Zum Vergleich: fetchArray allokiert für jede Zeile
+	res=db.streamQuery("select id, value, name from test_stream");
+	ppl7::AssocArray row;
+	allocations=0;
+	count_allocations=true;
+	while (!res->eof()) res->fetchArray(row);
+	count_allocations=false;
+	delete res;
+	ASSERT_GT(allocations,(size_t)20000);
+}
 
 
 }	// EOF namespace
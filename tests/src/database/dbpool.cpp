@@ -0,0 +1,247 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2016, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "prolog_ppl7.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <ppl7.h>
+#include <ppl7-db.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+static ppl7::AssocArray sqliteParams(const char* filename="tmp/dbpool_test.db")
+{
+	ppl7::AssocArray params;
+	params.set("type","sqlite");
+	params.set("filename",filename);
+	return params;
+}
+
+class DBPoolTest : public ::testing::Test {
+	protected:
+	DBPoolTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+	}
+	virtual ~DBPoolTest() {
+
+	}
+};
+
+class ReleaseThread : public ppl7::Thread
+{
+	public:
+		ppl7::db::DBPool *pool;
+		ppl7::db::Database *db;
+		int delay;
+
+		void run() {
+			ppl7::MSleep(delay);
+			pool->release(db);
+		}
+};
+
+TEST_F(DBPoolTest, notInitialized) {
+	ppl7::db::DBPool pool;
+	ASSERT_THROW(pool.get(), ppl7::db::DBPool::PoolNotInitializedException);
+}
+
+TEST_F(DBPoolTest, getAndRelease) {
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(sqliteParams());
+	ppl7::db::Database *db=pool.get();
+	ASSERT_TRUE(db!=NULL);
+	ASSERT_EQ(1,pool.size());
+	ASSERT_EQ(1,pool.used());
+	ASSERT_EQ(0,pool.idle());
+	ASSERT_TRUE(db->ping());
+	pool.release(db);
+	ASSERT_EQ(1,pool.size());
+	ASSERT_EQ(0,pool.used());
+	ASSERT_EQ(1,pool.idle());
+	ppl7::db::Database *db2=pool.get();
+	ASSERT_EQ(db,db2);
+	ASSERT_EQ(1,pool.size());
+	pool.destroy(db2);
+	ASSERT_EQ(0,pool.size());
+	ASSERT_EQ(0,pool.idle());
+}
+
+TEST_F(DBPoolTest, foreignConnection) {
+	ppl7::db::DBPool pool1, pool2;
+	pool1.setConnectParams(sqliteParams());
+	pool2.setConnectParams(sqliteParams());
+	ppl7::db::Database *db=pool1.get();
+	ASSERT_THROW(pool2.release(db), ppl7::db::DBPool::ForeignConnectionException);
+	ASSERT_THROW(pool2.release(NULL), ppl7::NullPointerException);
+	pool1.release(db);
+}
+
+TEST_F(DBPoolTest, maximumSize) {
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(sqliteParams());
+	pool.setMaximumSize(2);
+	ppl7::db::Database *db1=pool.get();
+	ppl7::db::Database *db2=pool.get();
+	ASSERT_TRUE(db1!=db2);
+	ASSERT_THROW(pool.get(), ppl7::db::DBPool::PoolExhaustedException);
+	ASSERT_THROW(pool.get(true,50), ppl7::TimeoutException);
+	ASSERT_EQ(2,pool.size());
+	pool.release(db1);
+	ppl7::db::Database *db3=pool.get(true,50);
+	ASSERT_EQ(db1,db3);
+	pool.release(db2);
+	pool.release(db3);
+	ppl7::AssocArray status;
+	pool.getStatus(status);
+	ASSERT_EQ(ppl7::String("2"),status.getString("stats/created"));
+	ASSERT_EQ(ppl7::String("1"),status.getString("stats/timeout"));
+}
+
+TEST_F(DBPoolTest, waitForRelease) {
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(sqliteParams());
+	pool.setMaximumSize(1);
+	ReleaseThread t;
+	t.pool=&pool;
+	t.db=pool.get();
+	t.delay=100;
+	t.threadStart();
+	ppl7::db::Database *db=pool.get(true,5000);
+	ASSERT_EQ(t.db,db);
+	pool.release(db);
+	while (t.threadIsRunning()) ppl7::MSleep(1);
+	ppl7::AssocArray status;
+	pool.getStatus(status);
+	ASSERT_EQ(ppl7::String("1"),status.getString("stats/wait"));
+	ASSERT_EQ(ppl7::String("0"),status.getString("waiting"));
+}
+
+TEST_F(DBPoolTest, changedConnectParams) {
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(sqliteParams());
+	ppl7::db::Database *db1=pool.get();
+	ppl7::db::Database *db2=pool.get();
+	pool.release(db1);
+	pool.setConnectParams(sqliteParams("tmp/dbpool_test2.db"));
+	ASSERT_EQ(1,pool.size());
+	pool.release(db2);
+	ASSERT_EQ(0,pool.size());
+}
+
+TEST_F(DBPoolTest, checkPoolMinSpare) {
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(sqliteParams());
+	pool.setMinimumSize(2);
+	pool.setMinSpare(3);
+	pool.setMaxSpare(4);
+	pool.checkPool();
+	ASSERT_EQ(3,pool.size());
+	ASSERT_EQ(3,pool.idle());
+}
+
+TEST_F(DBPoolTest, checkPoolIdleTimeout) {
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(sqliteParams());
+	pool.setMinimumSize(1);
+	pool.setIdleTimeout(1);
+	ppl7::db::Database *db1=pool.get();
+	ppl7::db::Database *db2=pool.get();
+	ppl7::db::Database *db3=pool.get();
+	pool.release(db1);
+	pool.release(db2);
+	pool.release(db3);
+	pool.checkPool();
+	ASSERT_EQ(3,pool.size());
+	ppl7::MSleep(2100);
+	pool.checkPool();
+	ASSERT_EQ(1,pool.size());
+	ASSERT_EQ(1,pool.idle());
+}
+
+TEST_F(DBPoolTest, setOption) {
+	ppl7::db::DBPool pool;
+	pool.setOption("Max","5");
+	pool.setOption("keepalive","10");
+	ASSERT_THROW(pool.setOption("unknown","1"), ppl7::IllegalArgumentException);
+	ppl7::AssocArray status;
+	pool.getStatus(status);
+	ASSERT_EQ(ppl7::String("5"),status.getString("max"));
+	ASSERT_EQ(ppl7::String("10"),status.getString("keepalive"));
+}
+
+TEST_F(DBPoolTest, checkThread) {
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(sqliteParams());
+	pool.setMinimumSize(2);
+	pool.startCheckThread(10);
+	for (int i=0;i<500 && pool.size()<2;i++) ppl7::MSleep(10);
+	pool.stopCheckThread();
+	ASSERT_EQ(2,pool.size());
+}
+
+TEST_F(DBPoolTest, PoolOfPools) {
+	ppl7::db::DBPoolOfPools pools;
+	pools.createPool(5,"first",sqliteParams());
+	ASSERT_THROW(pools.createPool(5,"other",sqliteParams("tmp/dbpool_test2.db")),
+		ppl7::db::DBPoolOfPools::PoolAlreadyExistsException);
+	ASSERT_THROW(pools.getPool(6), ppl7::db::DBPoolOfPools::PoolNotFoundException);
+	ASSERT_THROW(pools.getPool("second"), ppl7::db::DBPoolOfPools::PoolNotFoundException);
+	ppl7::db::Database *db1=pools.get("first");
+	ASSERT_EQ(pools.getPool(5).get(),pools.getPool("first").get());
+	ASSERT_EQ(pools.getPool(5).get(),pools.getPool(sqliteParams()).get());
+	ASSERT_EQ((size_t)1,pools.count());
+	ppl7::db::Database *db2=pools.get(sqliteParams("tmp/dbpool_test2.db"));
+	ASSERT_EQ((size_t)2,pools.count());
+	std::shared_ptr<ppl7::db::DBPool> second=pools.getPool(sqliteParams("tmp/dbpool_test2.db"));
+	ASSERT_EQ(1,second->used());
+	pools.release(db1);
+	pools.release(db2);
+	ASSERT_EQ(0,second->used());
+	ppl7::AssocArray status;
+	pools.getStatus(status);
+	ASSERT_EQ(ppl7::String("first"),status.getString("5/name"));
+	pools.deletePool("first");
+	ASSERT_EQ((size_t)1,pools.count());
+	ASSERT_THROW(pools.getPool(5), ppl7::db::DBPoolOfPools::PoolNotFoundException);
+	pools.deletePool(6);
+	ASSERT_EQ((size_t)0,pools.count());
+	ASSERT_EQ(0,second->used());
+}
+
+}	// EOF namespace
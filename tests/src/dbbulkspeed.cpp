@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <list>
+#include <ppl7.h>
+#include <ppl7-db.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumRows=200000;
+
+static void printResult(const char *descr, double duration, size_t rows)
+{
+	printf ("%-45s %10.3f %10.1f %12.0f\n",descr,duration,duration/(double)rows*1000000000.0,
+		(double)rows/duration);
+	fflush(NULL);
+}
+
+static void createTable(ppl7::db::Database &db)
+{
+	db.exec("drop table if exists bulk_speed");
+	db.exec("create table bulk_speed (id integer primary key, name text, value real)");
+}
+
+static void makeRow(ppl7::Array &row, int i)
+{
+	row.clear();
+	row.add(ppl7::ToString("%d",i));
+	row.add(ppl7::ToString("Name's %d",i));
+	row.add(ppl7::ToString("%0.3f",(double)i*0.5));
+}
+
+static void benchSingleInserts(ppl7::db::Database &db, int rows, bool transaction)
+{
+	createTable(db);
+	double start=ppl7::GetMicrotime();
+	if (transaction) db.startTransaction();
+	for (int i=0;i<rows;i++) {
+		db.execf("insert into bulk_speed (id,name,value) values (%d,'%s',%0.3f)",
+			i,(const char*)db.escape(ppl7::ToString("Name's %d",i)),(double)i*0.5);
+	}
+	if (transaction) db.endTransaction();
+	printResult(transaction ? "single inserts, one transaction" : "single inserts, autocommit",
+		ppl7::GetMicrotime()-start,rows);
+}
+
+static void benchBulkInsert(ppl7::db::Database &db, const char *descr, bool generic, size_t batchsize)
+{
+	createTable(db);
+	ppl7::Array columns("id name value"," ");
+	double start=ppl7::GetMicrotime();
+	std::list<ppl7::Array> rows;
+	ppl7::Array row;
+	for (int i=0;i<NumRows;i++) {
+		makeRow(row,i);
+		rows.push_back(row);
+		if (rows.size()>=batchsize) {
+			if (generic) db.Database::bulkInsert("bulk_speed",columns,rows,batchsize);
+			else db.bulkInsert("bulk_speed",columns,rows,batchsize);
+			rows.clear();
+		}
+	}
+	if (generic) db.Database::bulkInsert("bulk_speed",columns,rows,batchsize);
+	else db.bulkInsert("bulk_speed",columns,rows,batchsize);
+	printResult(descr,ppl7::GetMicrotime()-start,NumRows);
+}
+
+static void benchBulkWriter(ppl7::db::Database &db, size_t batchsize)
+{
+	createTable(db);
+	double start=ppl7::GetMicrotime();
+	ppl7::db::BulkWriter writer(db,"bulk_speed",ppl7::Array("id name value"," "),batchsize);
+	ppl7::Array row;
+	for (int i=0;i<NumRows;i++) {
+		makeRow(row,i);
+		writer.add(row);
+	}
+	writer.flush();
+	printResult(ppl7::ToString("BulkWriter, batch size %zu",batchsize),ppl7::GetMicrotime()-start,NumRows);
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumRows=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (NumRows<1) NumRows=1;
+	ppl7::Dir::mkDir("tmp",true);
+	try {
+		ppl7::db::SQLite db;
+		ppl7::AssocArray params;
+		params.set("filename","tmp/dbbulkspeed.db");
+		db.connect(params);
+		printf ("SQLite, %d rows\n\n",NumRows);
+		printf ("%-45s %10s %10s %12s\n","Test","seconds","ns/row","rows/s");
+		// Ohne Transaktion wird nach jeder Zeile die Datei synchronisiert, daher weniger Zeilen
+		benchSingleInserts(db,NumRows/100,false);
+		benchSingleInserts(db,NumRows,true);
+		benchBulkInsert(db,"multi-row VALUES, 1000 rows per query",true,1000);
+		benchBulkInsert(db,"SQLite bulkInsert, 1000 rows per transaction",false,1000);
+		benchBulkWriter(db,100);
+		benchBulkWriter(db,1000);
+		benchBulkWriter(db,10000);
+	} catch (const ppl7::Exception &e) {
+		e.print();
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+#include <ppl7.h>
+#include <ppl7-db.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumOperations=100000;
+static int NumThreads=4;
+static int PoolSize=2;
+
+static ppl7::AssocArray ConnectParams;
+
+static void printResult(const char *descr, double duration, size_t operations)
+{
+	printf ("%-45s %10.3f %10.1f\n",descr,duration,duration/(double)operations*1000000000.0);
+	fflush(NULL);
+}
+
+class PoolThread : public ppl7::Thread
+{
+	public:
+		ppl7::db::DBPool *pool;
+		int operations;
+		bool query;
+		volatile bool done;
+
+		PoolThread() {
+			pool=NULL;
+			operations=0;
+			query=false;
+			done=false;
+		}
+		void run() {
+			for (int i=0;i<operations;i++) {
+				ppl7::db::Database *db=pool->get(true);
+				if (query) db->exec("select 1");
+				pool->release(db);
+			}
+			done=true;
+		}
+};
+
+static void benchConnect(const char *descr, int operations)
+{
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<operations;i++) {
+		ppl7::db::Database *db=ppl7::db::Connect(ConnectParams);
+		db->exec("select 1");
+		delete db;
+	}
+	printResult(descr,ppl7::GetMicrotime()-start,operations);
+}
+
+static void benchPool(const char *descr, int threads, int poolsize, bool query)
+{
+	ppl7::db::DBPool pool;
+	pool.setConnectParams(ConnectParams);
+	pool.setMaximumSize(poolsize);
+	std::vector<PoolThread> t(threads);
+	int operations=NumOperations/threads;
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<threads;i++) {
+		t[i].pool=&pool;
+		t[i].operations=operations;
+		t[i].query=query;
+		t[i].threadStart();
+	}
+	for (int i=0;i<threads;i++) {
+		while (!t[i].done) ppl7::MSleep(1);
+		t[i].threadStop();
+	}
+	printResult(descr,ppl7::GetMicrotime()-start,(size_t)operations*threads);
+	ppl7::AssocArray status;
+	pool.getStatus(status);
+	printf ("    connections: %s, fastpath: %s of %s, waited: %s\n",
+		(const char*)status.getString("stats/created"),
+		(const char*)status.getString("stats/fastpath"),
+		(const char*)status.getString("stats/get"),
+		(const char*)status.getString("stats/wait"));
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumOperations=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-t")) NumThreads=ppl7::GetArgv(argc,argv,"-t").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-p")) PoolSize=ppl7::GetArgv(argc,argv,"-p").toInt();
+	if (NumOperations<1) NumOperations=1;
+	if (NumThreads<1) NumThreads=1;
+	if (PoolSize<1) PoolSize=1;
+	ConnectParams.set("type","sqlite");
+	ConnectParams.set("filename","tmp/dbpoolspeed.db");
+	ppl7::Dir::mkDir("tmp",true);
+	try {
+		printf ("%d operations, %d threads, pool size %d\n\n",NumOperations,NumThreads,PoolSize);
+		printf ("%-45s %10s %10s\n","Test","seconds","ns/op");
+		benchConnect("connect, select 1, close",NumOperations/10);
+		benchPool("pool, get/release, 1 thread",1,1,false);
+		benchPool("pool, get/select 1/release, 1 thread",1,1,true);
+		benchPool("pool, get/release, threads",NumThreads,NumThreads,false);
+		benchPool("pool, get/release, threads > pool size",NumThreads,PoolSize,false);
+		benchPool("pool, get/select 1/release, threads > pool size",NumThreads,PoolSize,true);
+	} catch (const ppl7::Exception &e) {
+		e.print();
+		return 1;
+	}
+	return 0;
+}
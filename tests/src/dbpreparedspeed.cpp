@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <ppl7.h>
+#include <ppl7-db.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumRows=100000;
+
+static void printResult(const char *descr, double duration, size_t operations)
+{
+	printf ("%-45s %10.3f %10.1f\n",descr,duration,duration/(double)operations*1000000000.0);
+	fflush(NULL);
+}
+
+static void createTable(ppl7::db::Database &db)
+{
+	db.exec("drop table if exists speed_test");
+	db.exec("create table speed_test (id integer primary key, name text, value real)");
+}
+
+static void benchInsertEscaped(ppl7::db::Database &db)
+{
+	createTable(db);
+	double start=ppl7::GetMicrotime();
+	db.startTransaction();
+	for (int i=0;i<NumRows;i++) {
+		db.execf("insert into speed_test (id,name,value) values (%d,'%s',%0.3f)",
+			i,(const char*)db.escape(ppl7::ToString("Name's %d",i)),(double)i*0.5);
+	}
+	db.endTransaction();
+	printResult("insert, execf + escape",ppl7::GetMicrotime()-start,NumRows);
+}
+
+static void benchInsertPrepared(ppl7::db::Database &db)
+{
+	createTable(db);
+	double start=ppl7::GetMicrotime();
+	db.startTransaction();
+	for (int i=0;i<NumRows;i++) {
+		std::shared_ptr<ppl7::db::Statement> stmt=db.prepare("insert into speed_test (id,name,value) values (?,?,?)");
+		stmt->bind(1,i);
+		stmt->bind(2,ppl7::ToString("Name's %d",i));
+		stmt->bind(3,(double)i*0.5);
+		stmt->exec();
+	}
+	db.endTransaction();
+	printResult("insert, prepared statement",ppl7::GetMicrotime()-start,NumRows);
+}
+
+static void benchSelectQuery(ppl7::db::Database &db)
+{
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<NumRows;i++) {
+		ppl7::db::ResultSet *res=db.queryf("select name from speed_test where id=%d",i);
+		res->getString(0);
+		delete res;
+	}
+	printResult("select by id, queryf",ppl7::GetMicrotime()-start,NumRows);
+}
+
+static void benchSelectPrepared(ppl7::db::Database &db)
+{
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<NumRows;i++) {
+		std::shared_ptr<ppl7::db::Statement> stmt=db.prepare("select name from speed_test where id=?");
+		stmt->bind(1,i);
+		ppl7::db::ResultSet *res=stmt->query();
+		res->getString(0);
+		delete res;
+	}
+	printResult("select by id, prepared statement",ppl7::GetMicrotime()-start,NumRows);
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumRows=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (NumRows<1) NumRows=1;
+	ppl7::Dir::mkDir("tmp",true);
+	try {
+		ppl7::db::SQLite db;
+		ppl7::AssocArray params;
+		params.set("filename","tmp/dbpreparedspeed.db");
+		db.connect(params);
+		db.exec("PRAGMA synchronous=OFF");
+		printf ("SQLite, %d rows\n\n",NumRows);
+		printf ("%-45s %10s %10s\n","Test","seconds","ns/row");
+		benchInsertEscaped(db);
+		benchInsertPrepared(db);
+		// Innerhalb einer Transaktion entfällt das Sperren der Datei bei jedem Select
+		db.startTransaction();
+		benchSelectQuery(db);
+		benchSelectPrepared(db);
+		db.endTransaction();
+	} catch (const ppl7::Exception &e) {
+		e.print();
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+#include <ppl7.h>
+#include <ppl7-db.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumRows=1000000;
+
+static void printResult(const char *descr, double duration, size_t operations)
+{
+	printf ("%-45s %10.3f %10.1f\n",descr,duration,duration/(double)operations*1000000000.0);
+	fflush(NULL);
+}
+
+static void createTable(ppl7::db::Database &db)
+{
+	db.exec("drop table if exists speed_test");
+	db.exec("create table speed_test (id integer primary key, name text, value real)");
+	ppl7::db::BulkWriter writer(db,"speed_test",ppl7::Array("id name value"," "),1000);
+	for (int i=0;i<NumRows;i++) {
+		ppl7::Array row;
+		row.add(ppl7::ToString("%d",i));
+		row.add(ppl7::ToString("Name %d",i));
+		row.add(ppl7::ToString("%0.1f",(double)i*0.5));
+		writer.add(row);
+	}
+	writer.flush();
+}
+
+static void benchFetchArray(ppl7::db::Database &db)
+{
+	double start=ppl7::GetMicrotime();
+	ppl7::db::ResultSet *res=db.query("select id, name, value from speed_test");
+	ppl7::AssocArray row;
+	int64_t sum=0;
+	while (!res->eof()) {
+		res->fetchArray(row);
+		sum+=row.getString("id").toInt64();
+	}
+	delete res;
+	printResult("fetchArray",ppl7::GetMicrotime()-start,NumRows);
+}
+
+static void benchGetString(ppl7::db::Database &db)
+{
+	double start=ppl7::GetMicrotime();
+	ppl7::db::ResultSet *res=db.query("select id, name, value from speed_test");
+	int64_t sum=0;
+	size_t bytes=0;
+	while (!res->eof()) {
+		sum+=res->getString(0).toInt64();
+		bytes+=res->getString(1).size();
+		res->getString(2).toDouble();
+		res->nextRow();
+	}
+	delete res;
+	printResult("getString",ppl7::GetMicrotime()-start,NumRows);
+}
+
+static void benchTypedGetters(ppl7::db::Database &db)
+{
+	double start=ppl7::GetMicrotime();
+	ppl7::db::ResultSet *res=db.streamQuery("select id, name, value from speed_test");
+	int64_t sum=0;
+	size_t bytes=0;
+	double total=0.0;
+	while (!res->eof()) {
+		sum+=res->getInt64(0);
+		bytes+=res->getView(1).size();
+		total+=res->getDouble(2);
+		res->nextRow();
+	}
+	delete res;
+	printResult("streamQuery, getInt64/getView/getDouble",ppl7::GetMicrotime()-start,NumRows);
+}
+
+static void benchFetchColumns(ppl7::db::Database &db)
+{
+	double start=ppl7::GetMicrotime();
+	ppl7::db::ResultSet *res=db.streamQuery("select id, name, value from speed_test");
+	std::vector<ppl7::db::ResultColumn> columns;
+	int64_t sum=0;
+	size_t num;
+	while ((num=res->fetchColumns(columns,1000)) > 0) {
+		for (size_t i=0;i<num;i++) sum+=columns[0].integers[i];
+	}
+	delete res;
+	printResult("streamQuery, fetchColumns (1000 rows)",ppl7::GetMicrotime()-start,NumRows);
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumRows=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (NumRows<1) NumRows=1;
+	ppl7::Dir::mkDir("tmp",true);
+	try {
+		ppl7::db::SQLite db;
+		ppl7::AssocArray params;
+		params.set("filename","tmp/dbstreamspeed.db");
+		db.connect(params);
+		db.exec("PRAGMA synchronous=OFF");
+		createTable(db);
+		printf ("SQLite, %d rows\n\n",NumRows);
+		printf ("%-45s %10s %10s\n","Test","seconds","ns/row");
+		benchFetchArray(db);
+		benchGetString(db);
+		benchTypedGetters(db);
+		benchFetchColumns(db);
+	} catch (const ppl7::Exception &e) {
+		e.print();
+		return 1;
+	}
+	return 0;
+}
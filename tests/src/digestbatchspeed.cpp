@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <ppl7.h>
+#include <ppl7-crypto.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumFiles=2000;
+static int FileSize=256;
+static int BigFile=512;
+static int Threads=0;
+
+static void printResult(const char *descr, double duration, uint64_t bytes)
+{
+	printf ("%-44s %10.3f %10.1f\n",descr,duration,(double)bytes/duration/1000000.0);
+	fflush(NULL);
+}
+
+static void createFile(const ppl7::String &filename, size_t size)
+{
+	ppl7::DirEntry de;
+	if (ppl7::File::tryStatFile(filename,de) && de.Size==size) return;
+	ppl7::ByteArray data;
+	unsigned char *p=(unsigned char*)data.malloc(size);
+	uint32_t seed=(uint32_t)size;
+	for (size_t i=0;i<size;i++) {
+		seed=seed*1103515245+12345;
+		p[i]=(unsigned char)(seed>>16);
+	}
+	ppl7::File::save(data,filename);
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumFiles=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-s")) FileSize=ppl7::GetArgv(argc,argv,"-s").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-b")) BigFile=ppl7::GetArgv(argc,argv,"-b").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-t")) Threads=ppl7::GetArgv(argc,argv,"-t").toInt();
+	if (NumFiles<1) NumFiles=1;
+	if (FileSize<1) FileSize=1;
+	if (BigFile<1) BigFile=1;
+	ppl7::String dir="tmp/digestbatchspeed";
+	ppl7::Dir::mkDir(dir,true);
+	std::vector<ppl7::String> files;
+	uint64_t total=0;
+	for (int i=0;i<NumFiles;i++) {
+		ppl7::String filename;
+		filename.setf("%s/file%05d.bin",(const char*)dir,i);
+		// Unterschiedliche Größen zwischen 1/2 und 3/2 der Vorgabe
+		size_t size=(size_t)FileSize*1024/2+(size_t)(i*7919)%((size_t)FileSize*1024);
+		createFile(filename,size);
+		files.push_back(filename);
+		total+=size;
+	}
+	ppl7::String bigfile=dir+"/big.bin";
+	uint64_t bigsize=(uint64_t)BigFile*1024*1024;
+	createFile(bigfile,(size_t)bigsize);
+
+	std::vector<ppl7::DigestBatch::Result> results;
+	ppl7::DigestBatch batch(ppl7::Digest::Algo_SHA256,(size_t)Threads);
+	batch.hashFiles(files,results);	// Cache anwärmen
+	printf ("%d files, %0.1f MB total, big file %d MB, %d threads (0=auto)\n\n",
+		NumFiles,(double)total/1048576.0,BigFile,Threads);
+	printf ("%-44s %10s %10s\n","Test","seconds","MB/s");
+
+	const struct {
+		ppl7::Digest::Algorithm algo;
+		const char *name;
+	} algos[]={
+		{ppl7::Digest::Algo_MD5, "MD5"},
+		{ppl7::Digest::Algo_SHA1, "SHA1"},
+		{ppl7::Digest::Algo_SHA256, "SHA256"},
+		{ppl7::Digest::Algo_SHA512, "SHA512"},
+	};
+	for (size_t a=0;a<sizeof(algos)/sizeof(algos[0]);a++) {
+		ppl7::String descr;
+		ppl7::Digest digest(algos[a].algo);
+		double start=ppl7::GetMicrotime();
+		for (size_t i=0;i<files.size();i++) {
+			digest.addFile(files[i]);
+			digest.getDigest();
+		}
+		descr.setf("%s files, Digest::addFile",algos[a].name);
+		printResult(descr,ppl7::GetMicrotime()-start,total);
+
+		batch.setAlgorithm(algos[a].algo);
+		batch.hashFiles(files,results);
+		descr.setf("%s files, DigestBatch::hashFiles",algos[a].name);
+		printResult(descr,batch.elapsed(),batch.bytesHashed());
+
+		start=ppl7::GetMicrotime();
+		digest.addFile(bigfile);
+		digest.getDigest();
+		descr.setf("%s big file, Digest::addFile",algos[a].name);
+		printResult(descr,ppl7::GetMicrotime()-start,bigsize);
+
+		batch.treeHash(bigfile);
+		descr.setf("%s big file, DigestBatch::treeHash",algos[a].name);
+		printResult(descr,batch.elapsed(),batch.bytesHashed());
+	}
+	return 0;
+}
@@ -0,0 +1,303 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <random>
+#include "../include/ppl7.h"
+#include "../include/ppl7-grafix.h"
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+/*
+ * Die SSE4.1- und AVX2-Varianten der Blitting-Funktionen müssen bitgenau die gleichen
+ * Ergebnisse liefern wie die skalaren Funktionen. Jeder Test führt die gleichen Operationen
+ * mit allen von der CPU unterstützten Varianten aus und vergleicht das Ergebnis mit der
+ * skalaren Version. Dabei werden ungerade Breiten, Ausschnitte und Clipping an allen Rändern
+ * verwendet, damit auch die Restpixel am Zeilenende geprüft werden.
+ */
+
+namespace {
+
+using ppl7::grafix::Image;
+using ppl7::grafix::Rect;
+using ppl7::grafix::Color;
+using ppl7::grafix::RGBFormat;
+
+typedef void (*BlitOperation)(Image& target, const Image& source, int x, int y, const Rect& srect);
+
+class GrafixBlitTest : public ::testing::Test {
+	protected:
+	ppl7::grafix::Grafix* gfx;
+	uint32_t caps;
+	std::mt19937 rng;
+
+	GrafixBlitTest() {
+		if (setlocale(LC_CTYPE, DEFAULT_LOCALE) == NULL) {
+			printf("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		gfx=NULL;
+		caps=0;
+	}
+	virtual ~GrafixBlitTest() {
+
+	}
+	virtual void SetUp() {
+		gfx=new ppl7::grafix::Grafix();
+		caps=gfx->blitCaps();
+		rng.seed(4711);
+	}
+	virtual void TearDown() {
+		gfx->setBlitCaps(caps);
+		delete gfx;
+	}
+
+	// Füllt das Bild mit Zufallswerten. Damit die Abkürzungen für ganze Pixelgruppen
+	// verwendet werden, gibt es längere Abschnitte mit Alpha 0 und Alpha 255.
+	void fillRandom(Image& img, bool alpharuns) {
+		int bpp=img.rgbformat().bytesPerPixel();
+		for (int y=0;y < img.height();y++) {
+			uint8_t* p=(uint8_t*)img.adr(0, y);
+			int mode=0, run=0;
+			for (int x=0;x < img.width();x++) {
+				if (run == 0) {
+					mode=rng() % 3;
+					run=1 + rng() % 20;
+				}
+				run--;
+				for (int b=0;b < bpp;b++) p[x * bpp + b]=(uint8_t)rng();
+				if (alpharuns && mode < 2) {
+					uint8_t a=(mode == 0 ? 0 : 255);
+					if (bpp == 1) p[x]=a;
+					else p[x * bpp + 3]=a;
+				}
+			}
+		}
+	}
+
+	void sprinkle(Image& img, const Color& c, int every) {
+		for (int y=0;y < img.height();y++) {
+			for (int x=0;x < img.width();x++) {
+				if ((rng() % every) == 0) img.putPixel(x, y, c);
+			}
+		}
+	}
+
+	static bool sameImage(const Image& a, const Image& b) {
+		if (a.width() != b.width() || a.height() != b.height()) return false;
+		for (int y=0;y < a.height();y++) {
+			if (memcmp(a.adr(0, y), b.adr(0, y), a.width() * 4) != 0) return false;
+		}
+		return true;
+	}
+
+	// Führt die Operation mit allen unterstützten Varianten an verschiedenen Positionen
+	// aus und vergleicht das Ergebnis mit der skalaren Implementierung
+	void compare(BlitOperation op, const Image& background, const Image& source) {
+		const int positions[][2]={ {0, 0}, {3, 1}, {-5, -3}, {-17, 4},
+			{background.width() - 9, background.height() - 4},
+			{background.width() - 1, 2}, {7, background.height() - 1} };
+		// Ausschnitte, die nicht in die Quelle passen, werden übersprungen
+		const Rect rects[]={ Rect(), Rect(1, 1, 13, 5), Rect(3, 0, 1, 3), Rect(5, 2, 31, 7),
+			Rect(1, 3, source.width() - 1, source.height() - 3) };
+		const uint32_t levels[]={ ppl7::CPUCAPS::CPU_HAVE_SSE41,
+			ppl7::CPUCAPS::CPU_HAVE_SSE41 | ppl7::CPUCAPS::CPU_HAVE_AVX2 };
+		for (auto pos : positions) {
+			for (auto r : rects) {
+				if (r.right() >= source.width() || r.bottom() >= source.height()) continue;
+				gfx->setBlitCaps(0);
+				Image expected(background);
+				op(expected, source, pos[0], pos[1], r);
+				for (auto level : levels) {
+					gfx->setBlitCaps(level);
+					if (gfx->blitCaps() != level) continue;
+					Image result(background);
+					op(result, source, pos[0], pos[1], r);
+					ASSERT_TRUE(sameImage(expected, result)) << "caps=" << level << ", x=" << pos[0]
+						<< ", y=" << pos[1] << ", source width=" << source.width()
+						<< ", rect=" << r.left() << "/" << r.top() << " " << r.width() << "x" << r.height();
+				}
+			}
+		}
+	}
+};
+
+static const int Widths[]={ 1, 2, 3, 5, 8, 9, 15, 16, 17, 31, 33, 70 };
+
+static void opAlpha(Image& target, const Image& source, int x, int y, const Rect& srect)
+{
+	target.bltAlpha(source, srect, x, y);
+}
+
+static void opColorKey(Image& target, const Image& source, int x, int y, const Rect& srect)
+{
+	target.bltColorKey(source, srect, x, y, Color(255, 0, 255, 255));
+}
+
+static void opDiffuse(Image& target, const Image& source, int x, int y, const Rect& srect)
+{
+	target.bltDiffuse(source, srect, x, y, Color(200, 100, 30, 180));
+}
+
+static void opBlend(Image& target, const Image& source, int x, int y, const Rect& srect)
+{
+	target.bltBlend(source, 0.37f, srect, x, y);
+	target.bltBlend(source, 0.0f, srect, x, y);
+	target.bltBlend(source, 1.0f, srect, x, y);
+}
+
+static void opChromaKey(Image& target, const Image& source, int x, int y, const Rect& srect)
+{
+	target.bltChromaKey(source, srect, Color(0, 255, 0, 255), 30, 90, x, y);
+	target.bltChromaKey(source, srect, Color(40, 40, 200, 255), 50, 50, x, y);
+}
+
+static void opBackgroundOnChromaKey(Image& target, const Image& source, int x, int y, const Rect& srect)
+{
+	target.bltBackgroundOnChromaKey(source, srect, Color(0, 255, 0, 255), 30, 90, x, y);
+}
+
+TEST_F(GrafixBlitTest, setBlitCaps) {
+	uint32_t old=gfx->setBlitCaps(0);
+	EXPECT_EQ(caps, old);
+	EXPECT_EQ((uint32_t)0, gfx->blitCaps());
+	EXPECT_EQ((uint32_t)0, gfx->setBlitCaps(0xffffffff));
+	EXPECT_EQ(ppl7::GetCPUCaps() & (ppl7::CPUCAPS::CPU_HAVE_SSE41 | ppl7::CPUCAPS::CPU_HAVE_AVX2), gfx->blitCaps());
+}
+
+TEST_F(GrafixBlitTest, bltAlpha) {
+	Image background(97, 41, RGBFormat::A8R8G8B8);
+	fillRandom(background, false);
+	for (int w : Widths) {
+		Image source(w, 23, RGBFormat::A8R8G8B8);
+		fillRandom(source, true);
+		compare(opAlpha, background, source);
+	}
+}
+
+TEST_F(GrafixBlitTest, bltColorKey) {
+	Image background(97, 41, RGBFormat::A8R8G8B8);
+	fillRandom(background, false);
+	for (int w : Widths) {
+		Image source(w, 23, RGBFormat::A8R8G8B8);
+		fillRandom(source, false);
+		sprinkle(source, Color(255, 0, 255, 255), 2);
+		compare(opColorKey, background, source);
+	}
+}
+
+TEST_F(GrafixBlitTest, bltDiffuse) {
+	Image background(97, 41, RGBFormat::A8R8G8B8);
+	fillRandom(background, false);
+	for (int w : Widths) {
+		Image source(w, 23, RGBFormat::A8);
+		fillRandom(source, true);
+		compare(opDiffuse, background, source);
+	}
+}
+
+TEST_F(GrafixBlitTest, bltBlend) {
+	Image background(97, 41, RGBFormat::X8R8G8B8);
+	fillRandom(background, false);
+	for (int w : Widths) {
+		Image source(w, 23, RGBFormat::X8R8G8B8);
+		fillRandom(source, false);
+		compare(opBlend, background, source);
+	}
+}
+
+TEST_F(GrafixBlitTest, bltChromaKey) {
+	Image background(97, 41, RGBFormat::A8R8G8B8);
+	fillRandom(background, false);
+	for (int w : Widths) {
+		Image source(w, 23, RGBFormat::A8R8G8B8);
+		fillRandom(source, false);
+		// Farben in der Nähe des Schlüssels, damit alle drei Bereiche der Toleranz vorkommen
+		for (int g=255;g > 120;g-=15) sprinkle(source, Color(g / 4, g, 255 - g, 255), 8);
+		compare(opChromaKey, background, source);
+	}
+}
+
+TEST_F(GrafixBlitTest, bltBackgroundOnChromaKey) {
+	// Hier wird der Ausschnitt aus dem Ziel genommen und der Hintergrund an der Zielposition
+	// gelesen, daher müssen beide Grafiken gleich groß sein. Die unterschiedlichen Breiten
+	// ergeben sich durch das Clipping und die Ausschnitte.
+	Image target(97, 41, RGBFormat::A8R8G8B8);
+	fillRandom(target, false);
+	for (int g=255;g > 120;g-=15) sprinkle(target, Color(g / 4, g, 255 - g, 255), 8);
+	Image background(97, 41, RGBFormat::A8R8G8B8);
+	fillRandom(background, false);
+	compare(opBackgroundOnChromaKey, target, background);
+}
+
+TEST_F(GrafixBlitTest, overlappingSelfBlit) {
+	// Quelle und Ziel sind die gleiche Grafik, das Ziel liegt wenige Pixel rechts
+	// von der Quelle
+	Image base(97, 41, RGBFormat::A8R8G8B8);
+	fillRandom(base, true);
+	for (int g=255;g > 120;g-=15) sprinkle(base, Color(g / 4, g, 255 - g, 255), 8);
+	const uint32_t levels[]={ ppl7::CPUCAPS::CPU_HAVE_SSE41,
+		ppl7::CPUCAPS::CPU_HAVE_SSE41 | ppl7::CPUCAPS::CPU_HAVE_AVX2 };
+	for (int shift=-9;shift <= 9;shift++) {
+		Rect r(10, 2, 61, 30);
+		int x=10 + shift, y=2 + (shift & 1);
+		gfx->setBlitCaps(0);
+		Image a(base), b(base), c(base), d(base);
+		a.bltAlpha(a, r, x, y);
+		b.bltColorKey(b, r, x, y, Color(255, 0, 255, 255));
+		c.bltBlend(c, 0.4f, r, x, y);
+		d.bltChromaKey(d, r, Color(0, 255, 0, 255), 30, 90, x, y);
+		for (auto level : levels) {
+			gfx->setBlitCaps(level);
+			if (gfx->blitCaps() != level) continue;
+			Image a2(base), b2(base), c2(base), d2(base);
+			a2.bltAlpha(a2, r, x, y);
+			b2.bltColorKey(b2, r, x, y, Color(255, 0, 255, 255));
+			c2.bltBlend(c2, 0.4f, r, x, y);
+			d2.bltChromaKey(d2, r, Color(0, 255, 0, 255), 30, 90, x, y);
+			EXPECT_TRUE(sameImage(a, a2)) << "bltAlpha, caps=" << level << ", shift=" << shift;
+			EXPECT_TRUE(sameImage(b, b2)) << "bltColorKey, caps=" << level << ", shift=" << shift;
+			EXPECT_TRUE(sameImage(c, c2)) << "bltBlend, caps=" << level << ", shift=" << shift;
+			EXPECT_TRUE(sameImage(d, d2)) << "bltChromaKey, caps=" << level << ", shift=" << shift;
+		}
+	}
+}
+
+}	// EOF namespace
+
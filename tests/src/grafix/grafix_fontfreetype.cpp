@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include "../include/ppl7.h"
+#include "../include/ppl7-grafix.h"
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+/*
+ * Der Glyph-Cache von FontEngineFreeType darf das Ergebnis nicht verändern: mit und ohne
+ * Cache muss bitgenau dasselbe gezeichnet werden, und der Blitter für 32-Bit-Zeichenflächen
+ * muss dieselben Farben liefern wie das pixelweise Mischen mit putPixel.
+ */
+
+namespace {
+
+using ppl7::grafix::Image;
+using ppl7::grafix::Color;
+using ppl7::grafix::Font;
+using ppl7::grafix::RGBFormat;
+using ppl7::grafix::FontEngineFreeType;
+
+const wchar_t* Text=L"AVWAToYo Kerning, äöü\nZweite Zeile: Hallo Welt!";
+
+class GrafixFontFreeTypeTest : public ::testing::Test {
+	protected:
+	ppl7::grafix::Grafix* gfx;
+	FontEngineFreeType* engine;
+	size_t cachesize;
+
+	GrafixFontFreeTypeTest() {
+		if (setlocale(LC_CTYPE, DEFAULT_LOCALE) == NULL) {
+			printf("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		gfx=NULL;
+		engine=NULL;
+		cachesize=0;
+	}
+	virtual ~GrafixFontFreeTypeTest() {
+
+	}
+	virtual void SetUp() {
+		gfx=new ppl7::grafix::Grafix();
+		gfx->loadFont("testdata/fonts/LiberationSans-Bold.ttf", "Liberation Sans Bold TTF");
+		engine=dynamic_cast<FontEngineFreeType*>(gfx->findFont("Liberation Sans Bold TTF")->engine);
+		ASSERT_TRUE(engine != NULL);
+		cachesize=engine->cacheSize();
+	}
+	virtual void TearDown() {
+		engine->setCacheSize(cachesize);
+		delete gfx;
+	}
+
+	static void fillBackground(Image& img) {
+		for (int y=0;y < img.height();y++) {
+			for (int x=0;x < img.width();x++) {
+				img.putPixel(x, y, Color((x * 7) & 255, (y * 5) & 255, (x + y) & 255, (x * 3 + y) & 255));
+			}
+		}
+	}
+
+	static Font font(int size, bool antialias, double rotation, const Color& color) {
+		Font f;
+		f.setName("Liberation Sans Bold TTF");
+		f.setSize(size);
+		f.setAntialias(antialias);
+		f.setRotation(rotation);
+		f.setColor(color);
+		return f;
+	}
+
+	// Zeichnet den Text mehrfach, auch teilweise außerhalb der Zeichenfläche
+	static Image render(const RGBFormat& format, const Font& f) {
+		Image img(300, 120, format);
+		fillBackground(img);
+		img.print(f, -5, 20, Text);
+		img.print(f, 20, 60, Text);
+		img.print(f, 150, 110, Text);
+		img.print(f, 20, 60, Text);
+		return img;
+	}
+
+	static int countDifferentPixels(const Image& a, const Image& b) {
+		int diff=0;
+		for (int y=0;y < a.height();y++) {
+			for (int x=0;x < a.width();x++) {
+				if (a.getPixel(x, y) != b.getPixel(x, y)) diff++;
+			}
+		}
+		return diff;
+	}
+};
+
+TEST_F(GrafixFontFreeTypeTest, cachedEqualsUncached) {
+	const RGBFormat::Identifier formats[]={ RGBFormat::A8R8G8B8, RGBFormat::X8B8G8R8, RGBFormat::GREY8 };
+	const double rotations[]={ 0.0, 10.0, 90.0 };
+	for (auto format : formats) {
+		for (int antialias=0;antialias < 2;antialias++) {
+			for (auto rotation : rotations) {
+				Font f=font(12, antialias, rotation, Color(250, 40, 90, 160));
+				engine->setCacheSize(0);
+				Image uncached=render(format, f);
+				ppl7::grafix::Size s1=f.measure(Text);
+				EXPECT_EQ((size_t)0, engine->cacheUsage());
+				engine->setCacheSize(4 * 1024 * 1024);
+				Image first=render(format, f);
+				Image second=render(format, f);
+				ppl7::grafix::Size s2=f.measure(Text);
+				EXPECT_EQ(0, countDifferentPixels(uncached, first)) << "format " << format << ", rotation " << rotation;
+				EXPECT_EQ(0, countDifferentPixels(uncached, second)) << "format " << format << ", rotation " << rotation;
+				EXPECT_EQ(s1, s2);
+			}
+		}
+	}
+}
+
+TEST_F(GrafixFontFreeTypeTest, blendMatchesPutPixel) {
+	const Color colors[]={ Color(250, 40, 90, 255), Color(250, 40, 90, 128), Color(0, 200, 255, 17) };
+	for (auto color : colors) {
+		// Weiß auf transparentem Schwarz ergibt die Deckung der Glyphen im Alphakanal. Die
+		// Zeichen werden einzeln gezeichnet, damit sich keine Glyphen überlappen.
+		Image coverage(300, 120, RGBFormat::A8R8G8B8);
+		coverage.cls(Color(0, 0, 0, 0));
+		Image img(300, 120, RGBFormat::A8R8G8B8);
+		fillBackground(img);
+		Image expected=img;
+		ppl7::WideString chars=L"AVWgjäöü@&%Qy";
+		for (size_t i=0;i < chars.size();i++) {
+			coverage.print(font(14, true, 0.0, Color(255, 255, 255, 255)), (int)i * 22, 40, chars.mid(i, 1));
+			img.print(font(14, true, 0.0, color), (int)i * 22, 40, chars.mid(i, 1));
+		}
+		int covered=0;
+		for (int y=0;y < expected.height();y++) {
+			for (int x=0;x < expected.width();x++) {
+				int v=coverage.getPixel(x, y).alpha();
+				int a=color.alpha() * v / 255;
+				if (a == 0) continue;
+				covered++;
+				Color bg=expected.getPixel(x, y);
+				if (a == 255) {
+					expected.putPixel(x, y, Color(color.red(), color.green(), color.blue(), 255));
+					continue;
+				}
+				int reva=255 - a;
+				expected.putPixel(x, y, Color((bg.red() * reva + color.red() * a) / 255,
+					(bg.green() * reva + color.green() * a) / 255,
+					(bg.blue() * reva + color.blue() * a) / 255,
+					bg.alpha() + (255 - bg.alpha()) * a / 255));
+			}
+		}
+		EXPECT_GT(covered, 500);
+		EXPECT_EQ(0, countDifferentPixels(expected, img)) << "alpha " << color.alpha();
+	}
+}
+
+TEST_F(GrafixFontFreeTypeTest, cacheSize) {
+	engine->clearCache();
+	EXPECT_EQ((size_t)0, engine->cacheUsage());
+	Image img(300, 120, RGBFormat::A8R8G8B8);
+	img.print(font(12, true, 0.0, Color(255, 255, 255)), 10, 40, Text);
+	size_t usage=engine->cacheUsage();
+	EXPECT_GT(usage, (size_t)0);
+	img.print(font(12, true, 0.0, Color(0, 0, 255)), 10, 60, Text);
+	EXPECT_EQ(usage, engine->cacheUsage());
+	img.print(font(30, true, 0.0, Color(255, 255, 255)), 10, 60, Text);
+	size_t bothsizes=engine->cacheUsage();
+	EXPECT_GT(bothsizes, usage);
+	// Wird der Cache zu klein, wird zuerst die am längsten nicht benutzte Größe verworfen
+	engine->setCacheSize(bothsizes - 1);
+	EXPECT_LT(engine->cacheUsage(), bothsizes);
+	EXPECT_GT(engine->cacheUsage(), usage);
+	engine->clearCache();
+	EXPECT_EQ((size_t)0, engine->cacheUsage());
+	engine->setCacheSize(cachesize);
+	img.print(font(12, true, 0.0, Color(255, 255, 255)), 10, 40, Text);
+	EXPECT_GT(engine->cacheUsage(), (size_t)0);
+	gfx->unloadFont("Liberation Sans Bold TTF");
+	EXPECT_EQ((size_t)0, engine->cacheUsage());
+}
+
+}	// EOF namespace
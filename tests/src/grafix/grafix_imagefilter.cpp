@@ -85,5 +85,125 @@ TEST_F(GrafixImageFilterTest, loadpng) {
 
 }
 
+
+/*
+ * Erwartetes Ergebnis beim verkleinerten Laden einer PNG-Grafik ohne Interlacing:
+ * Mittelwert über denominator x denominator Pixel, Farben mit Alpha gewichtet.
+ */
+static ppl7::grafix::Image boxReduced(const ppl7::grafix::Image &full, int denominator)
+{
+	int w=(full.width()+denominator-1)/denominator;
+	int h=(full.height()+denominator-1)/denominator;
+	ppl7::grafix::Image tgt(w,h,ppl7::grafix::RGBFormat::A8R8G8B8);
+	for (int ty=0;ty<h;ty++) {
+		for (int tx=0;tx<w;tx++) {
+			uint32_t r=0, g=0, b=0, a=0, n=0;
+			for (int y=ty*denominator;y<(ty+1)*denominator && y<full.height();y++) {
+				for (int x=tx*denominator;x<(tx+1)*denominator && x<full.width();x++) {
+					ppl7::grafix::Color c=full.getPixel(x,y);
+					r+=c.red()*c.alpha();
+					g+=c.green()*c.alpha();
+					b+=c.blue()*c.alpha();
+					a+=c.alpha();
+					n++;
+				}
+			}
+			if (a) tgt.putPixel(tx,ty,ppl7::grafix::Color((r+a/2)/a,(g+a/2)/a,(b+a/2)/a,(a+n/2)/n));
+			else tgt.putPixel(tx,ty,ppl7::grafix::Color(0,0,0,(a+n/2)/n));
+		}
+	}
+	return tgt;
+}
+
+static int countDifferentPixels(const ppl7::grafix::Image &a, const ppl7::grafix::Image &b)
+{
+	int diff=0;
+	for (int y=0;y<a.height();y++) {
+		for (int x=0;x<a.width();x++) {
+			if (a.getPixel(x,y)!=b.getPixel(x,y)) diff++;
+		}
+	}
+	return diff;
+}
+
+TEST_F(GrafixImageFilterTest, loadScaledMinsize) {
+	ppl7::grafix::Image img;
+	img.load("testdata/reference.png",ppl7::grafix::Size(800,480));
+	EXPECT_EQ(800,img.width());
+	EXPECT_EQ(480,img.height());
+	img.load("testdata/reference.png",ppl7::grafix::Size(401,100));
+	EXPECT_EQ(800,img.width());
+	img.load("testdata/reference.png",ppl7::grafix::Size(400,240));
+	EXPECT_EQ(400,img.width());
+	EXPECT_EQ(240,img.height());
+	img.load("testdata/reference.png",ppl7::grafix::Size(1,1));
+	EXPECT_EQ(100,img.width());
+	EXPECT_EQ(60,img.height());
+	img.load("testdata/reference.png",ppl7::grafix::Size());
+	EXPECT_EQ(800,img.width());
+	// Formate ohne Verkleinerung beim Dekodieren werden in Originalgröße geladen
+	img.load("testdata/test.bmp",ppl7::grafix::Size(10,10));
+	EXPECT_EQ(120,img.width());
+	EXPECT_EQ(95,img.height());
+}
+
+TEST_F(GrafixImageFilterTest, loadScaledJpeg) {
+	ppl7::grafix::Image full, scaled;
+	ASSERT_NO_THROW(full.load("testdata/test.jpg",ppl7::grafix::RGBFormat::A8R8G8B8));
+	ASSERT_NO_THROW(scaled.load("testdata/test.jpg",ppl7::grafix::Size(30,20),ppl7::grafix::RGBFormat::A8R8G8B8));
+	ASSERT_EQ(30,scaled.width());
+	ASSERT_EQ(24,scaled.height());
+	ppl7::grafix::Image reference=boxReduced(full,4);
+	uint64_t sum=0;
+	for (int y=0;y<scaled.height();y++) {
+		for (int x=0;x<scaled.width();x++) {
+			ppl7::grafix::Color c1=scaled.getPixel(x,y), c2=reference.getPixel(x,y);
+			sum+=abs(c1.red()-c2.red())+abs(c1.green()-c2.green())+abs(c1.blue()-c2.blue());
+		}
+	}
+	EXPECT_LT(sum/(scaled.width()*scaled.height()*3),8u);
+}
+
+TEST_F(GrafixImageFilterTest, loadScaledPngBoxReduced) {
+	const char *files[]={ "testdata/reference.png", "testdata/test.png", "testdata/test-pal-trans.png", NULL };
+	for (int i=0;files[i]!=NULL;i++) {
+		ppl7::grafix::Image full, scaled;
+		ASSERT_NO_THROW(full.load(files[i],ppl7::grafix::RGBFormat::A8R8G8B8));
+		for (int denominator=2;denominator<=8;denominator*=2) {
+			ppl7::grafix::Size minsize((full.width()+denominator-1)/denominator,(full.height()+denominator-1)/denominator);
+			ASSERT_NO_THROW(scaled.load(files[i],minsize,ppl7::grafix::RGBFormat::A8R8G8B8));
+			ASSERT_EQ(minsize,scaled.size()) << files[i];
+			EXPECT_EQ(0,countDifferentPixels(boxReduced(full,denominator),scaled)) << files[i] << ", denominator " << denominator;
+		}
+	}
+}
+
+TEST_F(GrafixImageFilterTest, loadScaledPngInterlaced) {
+	const char *files[]={ "testdata/unittest.png", "testdata/test.png", NULL };
+	for (int i=0;files[i]!=NULL;i++) {
+		ppl7::grafix::Image full, reloaded, scaled;
+		ASSERT_NO_THROW(full.load(files[i],ppl7::grafix::RGBFormat::A8R8G8B8));
+		ppl7::grafix::ImageFilter_PNG png;
+		ppl7::AssocArray param;
+		param.set("interlace","1");
+		ASSERT_NO_THROW(png.saveFile("tmp/interlaced.png",full,param));
+		ASSERT_NO_THROW(reloaded.load("tmp/interlaced.png",ppl7::grafix::RGBFormat::A8R8G8B8));
+		ASSERT_EQ(full.size(),reloaded.size());
+		EXPECT_EQ(0,countDifferentPixels(full,reloaded)) << files[i];
+		for (int denominator=2;denominator<=8;denominator*=2) {
+			ppl7::grafix::Size minsize((full.width()+denominator-1)/denominator,(full.height()+denominator-1)/denominator);
+			ASSERT_NO_THROW(scaled.load("tmp/interlaced.png",minsize,ppl7::grafix::RGBFormat::A8R8G8B8));
+			ASSERT_EQ(minsize,scaled.size()) << files[i];
+			int diff=0;
+			for (int y=0;y<scaled.height();y++) {
+				for (int x=0;x<scaled.width();x++) {
+					if (scaled.getPixel(x,y)!=full.getPixel(x*denominator,y*denominator)) diff++;
+				}
+			}
+			EXPECT_EQ(0,diff) << files[i] << ", denominator " << denominator;
+		}
+	}
+}
+
 }	// EOF namespace
 
@@ -0,0 +1,302 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <random>
+#include <vector>
+#include "../include/ppl7.h"
+#include "../include/ppl7-grafix.h"
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+/*
+ * Die Ergebnisse von PixelConverter werden mit einer einfachen Referenz verglichen,
+ * die jeden Pixel einzeln über eine Color-Klasse umwandelt. Jede Kombination wird mit
+ * allen von der CPU unterstützten Vektor-Varianten und ungeraden Breiten geprüft.
+ */
+
+namespace {
+
+using ppl7::grafix::Image;
+using ppl7::grafix::Color;
+using ppl7::grafix::RGBFormat;
+using ppl7::grafix::PixelConverter;
+
+const RGBFormat::Identifier SourceFormats[]={ RGBFormat::Palette, RGBFormat::GREY8, RGBFormat::A8,
+	RGBFormat::R8G8B8, RGBFormat::B8G8R8, RGBFormat::A8R8G8B8, RGBFormat::X8R8G8B8,
+	RGBFormat::A8B8G8R8, RGBFormat::X8B8G8R8 };
+const RGBFormat::Identifier TargetFormats[]={ RGBFormat::GREY8, RGBFormat::A8,
+	RGBFormat::R8G8B8, RGBFormat::B8G8R8, RGBFormat::A8R8G8B8, RGBFormat::X8R8G8B8,
+	RGBFormat::A8B8G8R8, RGBFormat::X8B8G8R8 };
+const RGBFormat::Identifier SurfaceFormats[]={ RGBFormat::GREY8, RGBFormat::A8,
+	RGBFormat::A8R8G8B8, RGBFormat::X8R8G8B8, RGBFormat::A8B8G8R8, RGBFormat::X8B8G8R8 };
+const int Widths[]={ 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 65, 300 };
+
+Color decodeRef(RGBFormat format, const uint8_t* p, const Color* palette)
+{
+	switch (format) {
+		case RGBFormat::Palette: return palette[p[0]];
+		case RGBFormat::GREY8:
+		case RGBFormat::A8: return Color(p[0], p[0], p[0], 255);
+		case RGBFormat::R8G8B8: return Color(p[2], p[1], p[0], 255);
+		case RGBFormat::B8G8R8: return Color(p[0], p[1], p[2], 255);
+		case RGBFormat::A8R8G8B8: return Color(p[2], p[1], p[0], p[3]);
+		case RGBFormat::X8R8G8B8: return Color(p[2], p[1], p[0], 255);
+		case RGBFormat::A8B8G8R8: return Color(p[0], p[1], p[2], p[3]);
+		case RGBFormat::X8B8G8R8: return Color(p[0], p[1], p[2], 255);
+	}
+	return Color();
+}
+
+void encodeRef(RGBFormat format, const Color& c, uint8_t* p)
+{
+	switch (format) {
+		case RGBFormat::GREY8:
+		case RGBFormat::A8: p[0]=(uint8_t)c.brightness(); return;
+		case RGBFormat::R8G8B8: p[0]=c.blue(); p[1]=c.green(); p[2]=c.red(); return;
+		case RGBFormat::B8G8R8: p[0]=c.red(); p[1]=c.green(); p[2]=c.blue(); return;
+		case RGBFormat::A8R8G8B8:
+		case RGBFormat::X8R8G8B8: p[0]=c.blue(); p[1]=c.green(); p[2]=c.red(); p[3]=c.alpha(); return;
+		case RGBFormat::A8B8G8R8:
+		case RGBFormat::X8B8G8R8: p[0]=c.red(); p[1]=c.green(); p[2]=c.blue(); p[3]=c.alpha(); return;
+	}
+}
+
+class GrafixPixelConverterTest : public ::testing::Test {
+	protected:
+	ppl7::grafix::Grafix* gfx;
+	uint32_t caps;
+	std::mt19937 rng;
+	std::vector<uint32_t> variants;
+	Color palette[256];
+
+	GrafixPixelConverterTest() {
+		if (setlocale(LC_CTYPE, DEFAULT_LOCALE) == NULL) {
+			printf("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		gfx=NULL;
+		caps=0;
+	}
+	virtual ~GrafixPixelConverterTest() {
+
+	}
+	virtual void SetUp() {
+		gfx=new ppl7::grafix::Grafix();
+		caps=PixelConverter::caps();
+		rng.seed(4711);
+		variants.clear();
+		variants.push_back(0);
+		uint32_t cpu=ppl7::GetCPUCaps();
+		if (cpu & ppl7::CPUCAPS::CPU_HAVE_SSE41) variants.push_back(ppl7::CPUCAPS::CPU_HAVE_SSE41);
+		if (cpu & ppl7::CPUCAPS::CPU_HAVE_AVX2) variants.push_back(ppl7::CPUCAPS::CPU_HAVE_AVX2);
+		for (int i=0;i < 256;i++) palette[i]=Color(rng() & 255, rng() & 255, rng() & 255, rng() & 255);
+	}
+	virtual void TearDown() {
+		PixelConverter::setCaps(caps);
+		delete gfx;
+	}
+
+	std::vector<uint8_t> randomRow(int bytes) {
+		std::vector<uint8_t> row(bytes);
+		for (int i=0;i < bytes;i++) row[i]=(uint8_t)rng();
+		return row;
+	}
+
+	void setPalette(PixelConverter& conv) {
+		for (int i=0;i < 256;i++) conv.setPaletteColor(i, palette[i]);
+	}
+};
+
+TEST_F(GrafixPixelConverterTest, isSupported) {
+	for (size_t s=0;s < sizeof(SourceFormats) / sizeof(SourceFormats[0]);s++) {
+		for (size_t t=0;t < sizeof(TargetFormats) / sizeof(TargetFormats[0]);t++) {
+			EXPECT_TRUE(PixelConverter::isSupported(SourceFormats[s], TargetFormats[t]))
+				<< RGBFormat(SourceFormats[s]).name() << " => " << RGBFormat(TargetFormats[t]).name();
+		}
+	}
+	EXPECT_FALSE(PixelConverter::isSupported(RGBFormat::A8R8G8B8, RGBFormat::Palette));
+	EXPECT_FALSE(PixelConverter::isSupported(RGBFormat::R5G6B5, RGBFormat::A8R8G8B8));
+	EXPECT_FALSE(PixelConverter::isSupported(RGBFormat::unknown, RGBFormat::A8R8G8B8));
+
+	PixelConverter conv(RGBFormat::A8R8G8B8, RGBFormat::Palette);
+	uint8_t src[4]={ 1, 2, 3, 4 }, tgt[4];
+	EXPECT_THROW(conv.convertRow(src, tgt, 1), ppl7::grafix::UnsupportedColorFormatException);
+	EXPECT_THROW(conv.setPaletteColor(256, Color()), ppl7::IllegalArgumentException);
+	EXPECT_EQ(RGBFormat::A8R8G8B8, conv.sourceFormat());
+	EXPECT_EQ(RGBFormat::Palette, conv.targetFormat());
+}
+
+TEST_F(GrafixPixelConverterTest, setCaps) {
+	uint32_t old=PixelConverter::setCaps(0);
+	EXPECT_EQ(caps, old);
+	EXPECT_EQ(0u, PixelConverter::caps());
+	PixelConverter::setCaps(0xffffffff);
+	EXPECT_EQ(ppl7::GetCPUCaps() & (ppl7::CPUCAPS::CPU_HAVE_SSE41 | ppl7::CPUCAPS::CPU_HAVE_AVX2), PixelConverter::caps());
+}
+
+TEST_F(GrafixPixelConverterTest, convertRow) {
+	for (size_t s=0;s < sizeof(SourceFormats) / sizeof(SourceFormats[0]);s++) {
+		RGBFormat sf(SourceFormats[s]);
+		for (size_t t=0;t < sizeof(TargetFormats) / sizeof(TargetFormats[0]);t++) {
+			RGBFormat tf(TargetFormats[t]);
+			PixelConverter conv(sf, tf);
+			setPalette(conv);
+			for (size_t w=0;w < sizeof(Widths) / sizeof(Widths[0]);w++) {
+				int width=Widths[w];
+				std::vector<uint8_t> src=randomRow(width * sf.bytesPerPixel());
+				std::vector<uint8_t> expected(width * tf.bytesPerPixel() + 8, 0xcd);
+				for (int x=0;x < width;x++) {
+					encodeRef(tf, decodeRef(sf, &src[x * sf.bytesPerPixel()], palette), &expected[x * tf.bytesPerPixel()]);
+				}
+				for (size_t v=0;v < variants.size();v++) {
+					PixelConverter::setCaps(variants[v]);
+					std::vector<uint8_t> tgt(expected.size(), 0xcd);
+					conv.convertRow(&src[0], &tgt[0], width);
+					ASSERT_TRUE(tgt == expected) << sf.name() << " => " << tf.name()
+						<< ", width=" << width << ", caps=" << variants[v];
+				}
+			}
+		}
+	}
+}
+
+TEST_F(GrafixPixelConverterTest, writeRow) {
+	for (size_t s=0;s < sizeof(SourceFormats) / sizeof(SourceFormats[0]);s++) {
+		RGBFormat sf(SourceFormats[s]);
+		for (size_t t=0;t < sizeof(SurfaceFormats) / sizeof(SurfaceFormats[0]);t++) {
+			RGBFormat tf(SurfaceFormats[t]);
+			for (size_t v=0;v < variants.size();v++) {
+				PixelConverter::setCaps(variants[v]);
+				// Zielformat des Konverters passt zur Zeichenfläche oder nicht
+				for (int direct=0;direct < 2;direct++) {
+					PixelConverter conv(sf, direct ? tf : RGBFormat(RGBFormat::A8R8G8B8));
+					setPalette(conv);
+					Image expected(37, 3, tf), img(37, 3, tf);
+					expected.cls(Color(1, 2, 3, 4));
+					img.cls(Color(1, 2, 3, 4));
+					std::vector<uint8_t> src=randomRow(40 * sf.bytesPerPixel());
+					for (int x=0;x < 37;x++) {
+						expected.putPixel(x, 1, decodeRef(sf, &src[x * sf.bytesPerPixel()], palette));
+					}
+					// Zu lange Zeilen und Zeilen außerhalb werden abgeschnitten
+					conv.writeRow(img, 1, &src[0], 40);
+					conv.writeRow(img, -1, &src[0], 40);
+					conv.writeRow(img, 3, &src[0], 40);
+					for (int y=0;y < 3;y++) {
+						ASSERT_EQ(0, memcmp(expected.adr(0, y), img.adr(0, y), 37 * tf.bytesPerPixel()))
+							<< sf.name() << " => " << tf.name() << ", y=" << y << ", direct=" << direct;
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_F(GrafixPixelConverterTest, readRow) {
+	for (size_t s=0;s < sizeof(SurfaceFormats) / sizeof(SurfaceFormats[0]);s++) {
+		RGBFormat sf(SurfaceFormats[s]);
+		for (size_t t=0;t < sizeof(TargetFormats) / sizeof(TargetFormats[0]);t++) {
+			RGBFormat tf(TargetFormats[t]);
+			Image img(45, 2, sf);
+			for (int y=0;y < 2;y++) {
+				for (int x=0;x < 45;x++) img.putPixel(x, y, Color(rng() & 255, rng() & 255, rng() & 255, 255));
+			}
+			std::vector<uint8_t> expected(45 * tf.bytesPerPixel());
+			for (int x=0;x < 45;x++) encodeRef(tf, img.getPixel(x, 1), &expected[x * tf.bytesPerPixel()]);
+			for (size_t v=0;v < variants.size();v++) {
+				PixelConverter::setCaps(variants[v]);
+				for (int direct=0;direct < 2;direct++) {
+					PixelConverter conv(direct ? sf : RGBFormat(RGBFormat::B8G8R8), tf);
+					std::vector<uint8_t> tgt(expected.size());
+					conv.readRow(img, 1, &tgt[0], 45);
+					ASSERT_TRUE(tgt == expected) << sf.name() << " => " << tf.name() << ", direct=" << direct;
+				}
+			}
+			PixelConverter conv(sf, tf);
+			std::vector<uint8_t> tgt(expected.size() + 8);
+			EXPECT_THROW(conv.readRow(img, 2, &tgt[0], 45), ppl7::IllegalArgumentException);
+			EXPECT_THROW(conv.readRow(img, 0, &tgt[0], 46), ppl7::IllegalArgumentException);
+		}
+	}
+}
+
+TEST_F(GrafixPixelConverterTest, loadedImagesMatch) {
+	// Alle Zielformate müssen die gleichen Farben liefern wie das 32-Bit-Format
+	const char* files[]={ "testdata/unittest.png", "testdata/test.png", "testdata/test-pal-trans.png",
+		"testdata/test.jpg", "testdata/test.bmp", "testdata/unittest.bmp", "testdata/test.ppm",
+		"testdata/test.gif", NULL };
+	for (int f=0;files[f] != NULL;f++) {
+		Image reference;
+		ASSERT_NO_THROW(reference.load(files[f], RGBFormat::A8R8G8B8)) << files[f];
+		for (size_t t=0;t < sizeof(SurfaceFormats) / sizeof(SurfaceFormats[0]);t++) {
+			Image img;
+			ASSERT_NO_THROW(img.load(files[f], SurfaceFormats[t])) << files[f];
+			ASSERT_EQ(reference.size(), img.size());
+			bool grey=(SurfaceFormats[t] == RGBFormat::GREY8 || SurfaceFormats[t] == RGBFormat::A8);
+			for (int y=0;y < img.height();y++) {
+				for (int x=0;x < img.width();x++) {
+					Color c=reference.getPixel(x, y);
+					Color e=grey ? Color(c.brightness(), c.brightness(), c.brightness(), 255) : c;
+					ASSERT_EQ(e, img.getPixel(x, y)) << files[f] << ", " << RGBFormat(SurfaceFormats[t]).name()
+						<< ", x=" << x << ", y=" << y;
+				}
+			}
+		}
+	}
+}
+
+TEST_F(GrafixPixelConverterTest, saveAndLoad) {
+	Image img;
+	ASSERT_NO_THROW(img.load("testdata/unittest.png", RGBFormat::A8R8G8B8));
+	ppl7::Dir::mkDir("tmp");
+	ppl7::grafix::ImageFilter_PNG png;
+	ppl7::grafix::ImageFilter_BMP bmp;
+	ppl7::grafix::ImageFilter_PPM ppm;
+	ASSERT_NO_THROW(png.saveFile("tmp/pixelconverter.png", img));
+	ASSERT_NO_THROW(bmp.saveFile("tmp/pixelconverter.bmp", img));
+	ASSERT_NO_THROW(ppm.saveFile("tmp/pixelconverter.ppm", img));
+	Image p(Image("tmp/pixelconverter.png", RGBFormat::A8R8G8B8));
+	Image b(Image("tmp/pixelconverter.bmp", RGBFormat::A8R8G8B8));
+	Image m(Image("tmp/pixelconverter.ppm", RGBFormat::A8R8G8B8));
+	for (int y=0;y < img.height();y++) {
+		for (int x=0;x < img.width();x++) {
+			Color c=img.getPixel(x, y);
+			ASSERT_EQ(c, p.getPixel(x, y)) << "png x=" << x << ", y=" << y;
+			ASSERT_EQ(c, b.getPixel(x, y)) << "bmp x=" << x << ", y=" << y;
+			c.setAlpha(255);
+			ASSERT_EQ(c, m.getPixel(x, y)) << "ppm x=" << x << ", y=" << y;
+		}
+	}
+}
+
+}	// EOF namespace
@@ -0,0 +1,260 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <random>
+#include <vector>
+#include "../include/ppl7.h"
+#include "../include/ppl7-grafix.h"
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+/*
+ * Die Vektor-Varianten und die Aufteilung auf mehrere Threads müssen bitgenau die
+ * gleichen Ergebnisse liefern wie die skalare Berechnung in einem Thread. Zusätzlich
+ * werden einige Eigenschaften der Filter geprüft, die sich exakt vorhersagen lassen.
+ */
+
+namespace {
+
+using ppl7::grafix::Image;
+using ppl7::grafix::Color;
+using ppl7::grafix::RGBFormat;
+using ppl7::grafix::Resampler;
+
+const RGBFormat::Identifier Formats[]={ RGBFormat::A8R8G8B8, RGBFormat::X8R8G8B8,
+	RGBFormat::A8B8G8R8, RGBFormat::X8B8G8R8, RGBFormat::GREY8, RGBFormat::A8 };
+const Resampler::Filter Filters[]={ Resampler::Box, Resampler::Bilinear, Resampler::Bicubic, Resampler::Lanczos3 };
+const int Sizes[][4]={
+	{ 97, 61, 13, 7 }, { 97, 61, 96, 60 }, { 33, 17, 101, 55 }, { 5, 3, 64, 48 },
+	{ 300, 200, 37, 250 }, { 1, 1, 9, 5 }, { 64, 64, 1, 1 }, { 71, 45, 71, 45 }
+};
+
+class GrafixResamplerTest : public ::testing::Test {
+	protected:
+	ppl7::grafix::Grafix* gfx;
+	uint32_t caps;
+	std::mt19937 rng;
+	std::vector<uint32_t> variants;
+
+	GrafixResamplerTest() {
+		if (setlocale(LC_CTYPE, DEFAULT_LOCALE) == NULL) {
+			printf("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		gfx=NULL;
+		caps=0;
+	}
+	virtual ~GrafixResamplerTest() {
+
+	}
+	virtual void SetUp() {
+		gfx=new ppl7::grafix::Grafix();
+		caps=Resampler::caps();
+		rng.seed(4711);
+		variants.clear();
+		uint32_t cpu=ppl7::GetCPUCaps();
+		if (cpu & ppl7::CPUCAPS::CPU_HAVE_SSE41) variants.push_back(ppl7::CPUCAPS::CPU_HAVE_SSE41);
+		if (cpu & ppl7::CPUCAPS::CPU_HAVE_AVX2) variants.push_back(ppl7::CPUCAPS::CPU_HAVE_AVX2);
+	}
+	virtual void TearDown() {
+		Resampler::setCaps(caps);
+		delete gfx;
+	}
+
+	void fillRandom(Image& img) {
+		for (int y=0;y < img.height();y++) {
+			uint8_t* p=(uint8_t*)img.adr(0, y);
+			for (int x=0;x < img.width() * img.bytesPerPixel();x++) p[x]=(uint8_t)rng();
+		}
+	}
+
+	bool equal(const Image& a, const Image& b) {
+		if (a.size() != b.size()) return false;
+		for (int y=0;y < a.height();y++) {
+			if (memcmp(a.adr(0, y), b.adr(0, y), a.width() * a.bytesPerPixel()) != 0) return false;
+		}
+		return true;
+	}
+};
+
+TEST_F(GrafixResamplerTest, properties) {
+	Resampler r;
+	EXPECT_EQ(Resampler::Lanczos3, r.filter());
+	EXPECT_EQ((size_t)0, r.threads());
+	r.setFilter(Resampler::Box);
+	r.setThreads(3);
+	EXPECT_EQ(Resampler::Box, r.filter());
+	EXPECT_EQ((size_t)3, r.threads());
+	EXPECT_TRUE(Resampler::isSupported(RGBFormat::A8R8G8B8));
+	EXPECT_TRUE(Resampler::isSupported(RGBFormat::GREY8));
+	EXPECT_FALSE(Resampler::isSupported(RGBFormat::R5G6B5));
+	EXPECT_FALSE(Resampler::isSupported(RGBFormat::Palette));
+
+	Image src(10, 10, RGBFormat::A8R8G8B8), grey(5, 5, RGBFormat::GREY8), rgb565(10, 10, RGBFormat::R5G6B5);
+	EXPECT_THROW(r.resample(src, grey), ppl7::grafix::UnsupportedColorFormatException);
+	EXPECT_THROW(r.resampled(rgb565, 5, 5), ppl7::grafix::UnsupportedColorFormatException);
+	EXPECT_THROW(rgb565.scaled(5, 5, Resampler::Bilinear), ppl7::grafix::UnsupportedColorFormatException);
+}
+
+TEST_F(GrafixResamplerTest, vectorAndThreadsMatchScalar) {
+	for (size_t f=0;f < sizeof(Formats) / sizeof(Formats[0]);f++) {
+		for (size_t s=0;s < sizeof(Sizes) / sizeof(Sizes[0]);s++) {
+			Image src(Sizes[s][0], Sizes[s][1], Formats[f]);
+			fillRandom(src);
+			for (size_t i=0;i < sizeof(Filters) / sizeof(Filters[0]);i++) {
+				Resampler single(Filters[i], 1);
+				Resampler::setCaps(0);
+				Image expected=single.resampled(src, Sizes[s][2], Sizes[s][3]);
+				for (size_t v=0;v < variants.size();v++) {
+					Resampler::setCaps(variants[v]);
+					ASSERT_TRUE(equal(expected, single.resampled(src, Sizes[s][2], Sizes[s][3])))
+						<< RGBFormat(Formats[f]).name() << ", size " << s << ", filter " << Filters[i] << ", caps " << variants[v];
+				}
+			}
+		}
+	}
+	// Groß genug, damit in Bänder aufgeteilt wird
+	Image big(700, 500, RGBFormat::A8R8G8B8);
+	fillRandom(big);
+	for (size_t i=0;i < sizeof(Filters) / sizeof(Filters[0]);i++) {
+		Resampler single(Filters[i], 1), multi(Filters[i], 4), shared(Filters[i]);
+		Image expected=single.resampled(big, 333, 411);
+		ASSERT_TRUE(equal(expected, multi.resampled(big, 333, 411))) << "filter " << Filters[i];
+		ASSERT_TRUE(equal(expected, shared.resampled(big, 333, 411))) << "filter " << Filters[i];
+	}
+}
+
+TEST_F(GrafixResamplerTest, uniformColorStaysUniform) {
+	for (size_t f=0;f < sizeof(Formats) / sizeof(Formats[0]);f++) {
+		Image src(53, 29, Formats[f]);
+		Color c(200, 17, 99, 128);
+		src.cls(c);
+		for (size_t i=0;i < sizeof(Filters) / sizeof(Filters[0]);i++) {
+			Resampler r(Filters[i], 1);
+			for (size_t s=0;s < sizeof(Sizes) / sizeof(Sizes[0]);s++) {
+				Image tgt=r.resampled(src, Sizes[s][2], Sizes[s][3]);
+				// Durch das vormultiplizierte Alpha kann ein Kanal um 1 abweichen
+				Color expected=tgt.getPixel(0, 0), orig=src.getPixel(0, 0);
+				ASSERT_LE(abs(expected.red() - orig.red()), 1);
+				ASSERT_LE(abs(expected.green() - orig.green()), 1);
+				ASSERT_LE(abs(expected.blue() - orig.blue()), 1);
+				ASSERT_EQ(expected.alpha(), orig.alpha());
+				for (int y=0;y < tgt.height();y++) {
+					for (int x=0;x < tgt.width();x++) {
+						ASSERT_EQ(expected, tgt.getPixel(x, y)) << RGBFormat(Formats[f]).name()
+							<< ", filter " << Filters[i] << ", x=" << x << ", y=" << y;
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_F(GrafixResamplerTest, identity) {
+	for (size_t f=0;f < sizeof(Formats) / sizeof(Formats[0]);f++) {
+		Image src(41, 23, Formats[f]);
+		fillRandom(src);
+		if (Formats[f] == RGBFormat::A8R8G8B8 || Formats[f] == RGBFormat::A8B8G8R8) {
+			// Vormultipliziertes Alpha ist nur bei deckenden Pixeln verlustfrei
+			for (int y=0;y < src.height();y++) {
+				for (int x=0;x < src.width();x++) ((uint8_t*)src.adr(x, y))[3]=255;
+			}
+		}
+		for (size_t i=0;i < sizeof(Filters) / sizeof(Filters[0]);i++) {
+			Resampler r(Filters[i], 1);
+			ASSERT_TRUE(equal(src, r.resampled(src, 41, 23))) << RGBFormat(Formats[f]).name() << ", filter " << Filters[i];
+		}
+	}
+}
+
+TEST_F(GrafixResamplerTest, boxHalvesExactly) {
+	Image src(64, 38, RGBFormat::GREY8);
+	fillRandom(src);
+	Resampler r(Resampler::Box, 1);
+	Image tgt=r.resampled(src, 32, 19);
+	for (int y=0;y < 19;y++) {
+		const uint8_t* s0=(const uint8_t*)src.adr(0, y * 2);
+		const uint8_t* s1=(const uint8_t*)src.adr(0, y * 2 + 1);
+		const uint8_t* t=(const uint8_t*)tgt.adr(0, y);
+		for (int x=0;x < 32;x++) {
+			// Horizontal und vertikal wird jeweils kaufmännisch gerundet
+			int top=(s0[x * 2] + s0[x * 2 + 1] + 1) / 2;
+			int bottom=(s1[x * 2] + s1[x * 2 + 1] + 1) / 2;
+			ASSERT_EQ((top + bottom + 1) / 2, (int)t[x]) << "x=" << x << ", y=" << y;
+		}
+	}
+}
+
+TEST_F(GrafixResamplerTest, transparentColorDoesNotBleed) {
+	// Linke Hälfte vollständig transparentes Rot, rechte Hälfte deckendes Blau
+	Image src(40, 20, RGBFormat::A8R8G8B8);
+	for (int y=0;y < 20;y++) {
+		for (int x=0;x < 40;x++) src.putPixel(x, y, x < 20 ? Color(255, 0, 0, 0) : Color(0, 0, 255, 255));
+	}
+	for (size_t i=0;i < sizeof(Filters) / sizeof(Filters[0]);i++) {
+		Resampler r(Filters[i], 1);
+		Image tgt=r.resampled(src, 13, 7);
+		for (int y=0;y < tgt.height();y++) {
+			for (int x=0;x < tgt.width();x++) {
+				Color c=tgt.getPixel(x, y);
+				ASSERT_EQ(0, c.red()) << "filter " << Filters[i] << ", x=" << x << ", y=" << y;
+				if (c.alpha() > 0) {
+					ASSERT_EQ(255, c.blue()) << "filter " << Filters[i] << ", x=" << x << ", y=" << y;
+				}
+			}
+		}
+		EXPECT_EQ(0, tgt.getPixel(0, 3).alpha());
+		EXPECT_EQ(255, tgt.getPixel(12, 3).alpha());
+	}
+}
+
+TEST_F(GrafixResamplerTest, drawableScale) {
+	Image src(200, 100, RGBFormat::X8R8G8B8);
+	src.cls(Color(10, 20, 30, 255));
+	Image tgt=src.scaled(50, 50, Resampler::Lanczos3);
+	ASSERT_EQ(50, tgt.width());
+	ASSERT_EQ(50, tgt.height());
+	// Seitenverhältnis bleibt erhalten, die Grafik wird vertikal zentriert
+	EXPECT_EQ(Color(0, 0, 0, 0), tgt.getPixel(25, 11));
+	EXPECT_EQ(Color(10, 20, 30, 255), tgt.getPixel(0, 12));
+	EXPECT_EQ(Color(10, 20, 30, 255), tgt.getPixel(49, 36));
+	EXPECT_EQ(Color(0, 0, 0, 0), tgt.getPixel(25, 37));
+
+	src.scale(tgt, 30, 40, Resampler::Bicubic, false);
+	ASSERT_EQ(30, tgt.width());
+	ASSERT_EQ(40, tgt.height());
+	EXPECT_EQ(Color(10, 20, 30, 255), tgt.getPixel(0, 0));
+	EXPECT_EQ(Color(10, 20, 30, 255), tgt.getPixel(29, 39));
+}
+
+}	// EOF namespace
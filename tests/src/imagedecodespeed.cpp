@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <ppl7.h>
+#include <ppl7-grafix.h>
+#include "ppl7-tests.h"
+
+/*
+ * Benchmark für das Laden von Grafiken und die zeilenweise Farbumwandlung mit
+ * PixelConverter. Jede Messung wird nacheinander mit den skalaren, den SSE4.1- und
+ * den AVX2-Implementierungen ausgeführt (siehe PixelConverter::setCaps), das Ergebnis
+ * wird in Megapixel pro Sekunde ausgegeben. Die Grafiken werden vorher komplett in den
+ * Speicher geladen, so dass nur die Dekodierung gemessen wird.
+ *
+ * Optionen:
+ *   -r Runden   Anzahl Wiederholungen je Messung (Default 20)
+ *   -w Breite   Breite der Zeilen für die reine Farbumwandlung (Default 4093)
+ */
+
+ppl7::ConfigParser PPL7TestConfig;
+
+using ppl7::grafix::Image;
+using ppl7::grafix::RGBFormat;
+using ppl7::grafix::PixelConverter;
+
+static int Rounds=20;
+static int Width=4093;
+
+static const uint32_t Levels[]={ 0, ppl7::CPUCAPS::CPU_HAVE_SSE41,
+	ppl7::CPUCAPS::CPU_HAVE_SSE41 | ppl7::CPUCAPS::CPU_HAVE_AVX2 };
+
+static void decode(const char* filename, const RGBFormat& format)
+{
+	ppl7::ByteArray data;
+	ppl7::File::load(data, filename);
+	Image img;
+	img.load(data, format);
+	ppl7::String descr;
+	descr.setf("%s => %s", ppl7::File::getFilename(filename).toChar(), (const char*)format.name());
+	printf("%-36s:", (const char*)descr);
+	for (auto level : Levels) {
+		PixelConverter::setCaps(level);
+		if (PixelConverter::caps() != level) {
+			printf(" %10s", "-");
+			continue;
+		}
+		double start=ppl7::GetMicrotime();
+		for (int i=0;i < Rounds;i++) img.load(data, format);
+		double duration=ppl7::GetMicrotime() - start;
+		printf(" %10.1f", (double)img.width() * img.height() * Rounds / duration / 1000000.0);
+	}
+	printf("\n");
+	fflush(NULL);
+}
+
+static void convert(const RGBFormat& source, const RGBFormat& target)
+{
+	ppl7::ByteArray src, tgt;
+	src.malloc(Width * source.bytesPerPixel());
+	tgt.malloc(Width * target.bytesPerPixel());
+	uint8_t* p=(uint8_t*)src.ptr();
+	for (size_t i=0;i < src.size();i++) p[i]=(uint8_t)(i * 131 + 7);
+	PixelConverter conv(source, target);
+	ppl7::String descr;
+	descr.setf("%s => %s", (const char*)source.name(), (const char*)target.name());
+	printf("%-36s:", (const char*)descr);
+	int rows=Rounds * 100;
+	for (auto level : Levels) {
+		PixelConverter::setCaps(level);
+		if (PixelConverter::caps() != level) {
+			printf(" %10s", "-");
+			continue;
+		}
+		double start=ppl7::GetMicrotime();
+		for (int i=0;i < rows;i++) conv.convertRow(src.ptr(), (void*)tgt.ptr(), Width);
+		double duration=ppl7::GetMicrotime() - start;
+		printf(" %10.1f", (double)Width * rows / duration / 1000000.0);
+	}
+	printf("\n");
+	fflush(NULL);
+}
+
+int main(int argc, char** argv)
+{
+	if (ppl7::HaveArgv(argc, argv, "-r")) Rounds=ppl7::GetArgv(argc, argv, "-r").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-w")) Width=ppl7::GetArgv(argc, argv, "-w").toInt();
+	if (Rounds < 1 || Width < 1) {
+		printf("Ungültige Parameter\n");
+		return 1;
+	}
+	try {
+		ppl7::grafix::Grafix gfx;
+		uint32_t caps=PixelConverter::caps();
+		printf("%d Runden, CPU-Caps: 0x%08x\n\n", Rounds, ppl7::GetCPUCaps());
+		printf("%-36s  %10s %10s %10s\n", "Megapixel/s", "Skalar", "SSE4.1", "AVX2");
+		decode("testdata/reference.png", RGBFormat::A8R8G8B8);
+		decode("testdata/reference.png", RGBFormat::A8B8G8R8);
+		decode("testdata/screenshot1.png", RGBFormat::A8R8G8B8);
+		decode("testdata/screenshot1.png", RGBFormat::GREY8);
+		decode("testdata/test.jpg", RGBFormat::A8R8G8B8);
+		decode("testdata/test.jpg", RGBFormat::X8B8G8R8);
+		decode("testdata/test.bmp", RGBFormat::A8R8G8B8);
+		decode("testdata/test.ppm", RGBFormat::A8R8G8B8);
+		decode("testdata/test.gif", RGBFormat::A8R8G8B8);
+		printf("\n");
+		convert(RGBFormat::B8G8R8, RGBFormat::A8R8G8B8);
+		convert(RGBFormat::R8G8B8, RGBFormat::A8R8G8B8);
+		convert(RGBFormat::A8B8G8R8, RGBFormat::A8R8G8B8);
+		convert(RGBFormat::A8R8G8B8, RGBFormat::B8G8R8);
+		convert(RGBFormat::A8R8G8B8, RGBFormat::GREY8);
+		convert(RGBFormat::GREY8, RGBFormat::A8R8G8B8);
+		convert(RGBFormat::Palette, RGBFormat::A8R8G8B8);
+		PixelConverter::setCaps(caps);
+	} catch (const ppl7::Exception& exp) {
+		exp.print();
+		return 1;
+	}
+	return 0;
+}
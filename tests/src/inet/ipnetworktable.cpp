@@ -0,0 +1,238 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author: pafe $
+ * $Revision: 600 $
+ * $Date: 2013-04-26 21:37:49 +0200 (Fr, 26. Apr 2013) $
+ * $Id: resolver.cpp 600 2013-04-26 19:37:49Z pafe $
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <vector>
+#include <ppl7.h>
+#include <ppl7-inet.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+class InetIPNetworkTableTest : public ::testing::Test {
+	protected:
+		InetIPNetworkTableTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+	}
+	virtual ~InetIPNetworkTableTest() {
+
+	}
+};
+
+static uint32_t nextRandom(uint32_t &seed)
+{
+	seed=seed*1103515245+12345;
+	return seed;
+}
+
+static ppl7::IPAddress randomAddress(uint32_t &seed, bool v6)
+{
+	unsigned char a[16];
+	// Wenige unterschiedliche Anfangsbytes, damit sich Netze überlappen
+	for (int i=0;i<16;i++) a[i]=(unsigned char)(nextRandom(seed)>>16);
+	a[0]&=0x3;
+	if (v6) return ppl7::IPAddress(ppl7::IPAddress::IPv6,a,16);
+	return ppl7::IPAddress(ppl7::IPAddress::IPv4,a,4);
+}
+
+TEST_F(InetIPNetworkTableTest, Empty) {
+	ppl7::IPNetworkTable<int> table;
+	ASSERT_EQ((size_t)0,table.count());
+	ASSERT_TRUE(table.empty());
+	ASSERT_TRUE(table.lookup(ppl7::IPAddress("192.168.1.1"))==NULL);
+	ASSERT_FALSE(table.contains(ppl7::IPAddress("::1")));
+	ASSERT_THROW(table.get(ppl7::IPAddress("10.0.0.1")),ppl7::ItemNotFoundException);
+	ASSERT_FALSE(table.remove(ppl7::IPNetwork("10.0.0.0/8")));
+	ASSERT_THROW(table.lookup(ppl7::IPAddress()),ppl7::InvalidIpAddressException);
+}
+
+TEST_F(InetIPNetworkTableTest, LongestPrefixMatchIPv4) {
+	ppl7::IPNetworkTable<int> table;
+	table.insert(ppl7::IPNetwork("10.0.0.0/8"),8);
+	table.insert(ppl7::IPNetwork("10.1.0.0/16"),16);
+	table.insert(ppl7::IPNetwork("10.1.2.0/24"),24);
+	table.insert(ppl7::IPNetwork("10.1.2.3/32"),32);
+	table.insert(ppl7::IPNetwork("192.168.0.0/16"),1);
+	ASSERT_EQ((size_t)5,table.count());
+	ASSERT_EQ(8,table.get(ppl7::IPAddress("10.200.0.1")));
+	ASSERT_EQ(16,table.get(ppl7::IPAddress("10.1.200.1")));
+	ASSERT_EQ(24,table.get(ppl7::IPAddress("10.1.2.4")));
+	ASSERT_EQ(32,table.get(ppl7::IPAddress("10.1.2.3")));
+	ASSERT_EQ(1,table.get(ppl7::IPAddress("192.168.255.255")));
+	ASSERT_TRUE(table.lookup(ppl7::IPAddress("11.0.0.1"))==NULL);
+	ASSERT_TRUE(table.lookup(ppl7::IPAddress("192.169.0.0"))==NULL);
+	ppl7::IPNetwork match;
+	ASSERT_EQ(16,*table.lookup(ppl7::IPAddress("10.1.3.4"),match));
+	ASSERT_EQ(ppl7::IPNetwork("10.1.0.0/16"),match);
+
+	// Ersetzen eines vorhandenen Werts
+	table.insert(ppl7::IPNetwork("10.1.0.0/16"),17);
+	ASSERT_EQ((size_t)5,table.count());
+	ASSERT_EQ(17,table.get(ppl7::IPAddress("10.1.200.1")));
+	ASSERT_TRUE(table.exists(ppl7::IPNetwork("10.1.0.0/16")));
+	ASSERT_FALSE(table.exists(ppl7::IPNetwork("10.1.0.0/17")));
+	ASSERT_EQ(17,*table.find(ppl7::IPNetwork("10.1.0.0/16")));
+	ASSERT_TRUE(table.find(ppl7::IPNetwork("10.0.0.0/9"))==NULL);
+
+	// Default-Route
+	table.insert(ppl7::IPNetwork("0.0.0.0/0"),0);
+	ASSERT_EQ(0,table.get(ppl7::IPAddress("11.0.0.1")));
+	ASSERT_FALSE(table.contains(ppl7::IPAddress("::1")));
+}
+
+TEST_F(InetIPNetworkTableTest, LongestPrefixMatchIPv6) {
+	ppl7::IPNetworkTable<ppl7::String> table;
+	table.insert(ppl7::IPNetwork("2001:db8::/32"),"doc");
+	table.insert(ppl7::IPNetwork("2001:db8:1234::/48"),"site");
+	table.insert(ppl7::IPNetwork("2001:db8:1234:5678::/64"),"lan");
+	table.insert(ppl7::IPNetwork("2001:db8:1234:5678::1/128"),"host");
+	table.insert(ppl7::IPNetwork("10.0.0.0/8"),"v4");
+	ASSERT_EQ(ppl7::String("doc"),table.get(ppl7::IPAddress("2001:db8:ffff::1")));
+	ASSERT_EQ(ppl7::String("site"),table.get(ppl7::IPAddress("2001:db8:1234:1::1")));
+	ASSERT_EQ(ppl7::String("lan"),table.get(ppl7::IPAddress("2001:db8:1234:5678::2")));
+	ASSERT_EQ(ppl7::String("host"),table.get(ppl7::IPAddress("2001:db8:1234:5678::1")));
+	ASSERT_TRUE(table.lookup(ppl7::IPAddress("2001:db9::1"))==NULL);
+	// IPv4 und IPv6 werden getrennt verwaltet
+	ASSERT_TRUE(table.lookup(ppl7::IPAddress("::a00:1"))==NULL);
+	ASSERT_EQ(ppl7::String("v4"),table.get(ppl7::IPAddress("10.0.0.1")));
+	ppl7::IPNetwork match;
+	table.lookup(ppl7::IPAddress("2001:db8:1234:5678::1"),match);
+	ASSERT_EQ(ppl7::IPNetwork("2001:db8:1234:5678::1/128"),match);
+}
+
+TEST_F(InetIPNetworkTableTest, Remove) {
+	ppl7::IPNetworkTable<int> table;
+	table.insert(ppl7::IPNetwork("10.0.0.0/8"),8);
+	table.insert(ppl7::IPNetwork("10.1.0.0/16"),16);
+	table.insert(ppl7::IPNetwork("10.2.0.0/16"),162);
+	table.insert(ppl7::IPNetwork("10.1.2.0/24"),24);
+	size_t nodes=table.nodeCount();
+	ASSERT_FALSE(table.remove(ppl7::IPNetwork("10.1.2.0/23")));
+	ASSERT_FALSE(table.remove(ppl7::IPNetwork("10.3.0.0/16")));
+	ASSERT_TRUE(table.remove(ppl7::IPNetwork("10.1.0.0/16")));
+	ASSERT_FALSE(table.remove(ppl7::IPNetwork("10.1.0.0/16")));
+	ASSERT_EQ((size_t)3,table.count());
+	ASSERT_EQ(8,table.get(ppl7::IPAddress("10.1.200.1")));
+	ASSERT_EQ(24,table.get(ppl7::IPAddress("10.1.2.1")));
+	ASSERT_LT(table.nodeCount(),nodes);
+	ASSERT_TRUE(table.remove(ppl7::IPNetwork("10.0.0.0/8")));
+	ASSERT_TRUE(table.lookup(ppl7::IPAddress("10.1.200.1"))==NULL);
+	ASSERT_EQ(162,table.get(ppl7::IPAddress("10.2.0.1")));
+	ASSERT_TRUE(table.remove(ppl7::IPNetwork("10.1.2.0/24")));
+	ASSERT_TRUE(table.remove(ppl7::IPNetwork("10.2.0.0/16")));
+	ASSERT_EQ((size_t)0,table.count());
+	ASSERT_EQ((size_t)0,table.nodeCount());
+	// Freigegebene Knoten werden wiederverwendet
+	size_t mem=table.memoryUsage();
+	table.insert(ppl7::IPNetwork("10.0.0.0/8"),8);
+	ASSERT_EQ(mem,table.memoryUsage());
+	table.clear();
+	ASSERT_TRUE(table.empty());
+}
+
+TEST_F(InetIPNetworkTableTest, CompareWithLinearScan) {
+	uint32_t seed=4711;
+	std::vector<ppl7::IPNetwork> networks;
+	std::vector<int> values;
+	ppl7::IPNetworkTable<int> table;
+	for (int i=0;i<3000;i++) {
+		bool v6=(i&1)!=0;
+		int prefixlen=(int)(nextRandom(seed)>>16)%(v6 ? 129 : 33);
+		ppl7::IPNetwork net;
+		net.set(randomAddress(seed,v6),prefixlen);
+		size_t k;
+		for (k=0;k<networks.size();k++) if (networks[k]==net) break;
+		if (k<networks.size()) values[k]=i;
+		else {
+			networks.push_back(net);
+			values.push_back(i);
+		}
+		table.insert(net,i);
+	}
+	ASSERT_EQ(networks.size(),table.count());
+	// Jedes dritte Netz wieder entfernen
+	for (size_t k=0;k<networks.size();k+=3) {
+		ASSERT_TRUE(table.remove(networks[k]));
+		values[k]=-1;
+	}
+	std::vector<ppl7::IPAddress> addresses;
+	for (int i=0;i<4000;i++) {
+		bool v6=(i&1)!=0;
+		if (i%4==0) {
+			// Adresse innerhalb eines vorhandenen Netzes
+			const ppl7::IPNetwork &net=networks[(nextRandom(seed)>>8)%networks.size()];
+			addresses.push_back(net.first());
+		} else {
+			addresses.push_back(randomAddress(seed,v6));
+		}
+	}
+	std::vector<const int*> results;
+	size_t hits=table.lookup(addresses,results);
+	ASSERT_EQ(addresses.size(),results.size());
+	size_t expectedhits=0;
+	for (size_t i=0;i<addresses.size();i++) {
+		int best=-1, bestlen=-1;
+		for (size_t k=0;k<networks.size();k++) {
+			if (values[k]<0) continue;
+			if (networks[k].family()!=addresses[i].family()) continue;
+			if (networks[k].prefixlen()>bestlen && networks[k].contains(addresses[i])) {
+				best=values[k];
+				bestlen=networks[k].prefixlen();
+			}
+		}
+		const int *single=table.lookup(addresses[i]);
+		if (best<0) {
+			ASSERT_TRUE(single==NULL) << addresses[i].toString();
+			ASSERT_TRUE(results[i]==NULL);
+		} else {
+			expectedhits++;
+			ASSERT_TRUE(single!=NULL) << addresses[i].toString();
+			ASSERT_EQ(best,*single) << addresses[i].toString();
+			ASSERT_EQ(single,results[i]);
+		}
+	}
+	ASSERT_EQ(expectedhits,hits);
+	ASSERT_GT(hits,(size_t)0);
+	ASSERT_GT(table.memoryUsage(),table.nodeCount()*sizeof(int));
+}
+
+}	// EOF namespace
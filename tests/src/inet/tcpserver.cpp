@@ -0,0 +1,381 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author: pafe $
+ * $Revision: 600 $
+ * $Date: 2013-04-26 21:37:49 +0200 (Fr, 26 Apr 2013) $
+ * $Id: tcpserver.cpp 600 2013-04-26 19:37:49Z pafe $
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <map>
+#include <locale.h>
+#include <ppl7.h>
+#include <ppl7-inet.h>
+#include <gtest/gtest.h>
+#include "ppl7-tests.h"
+
+namespace {
+
+class EchoServer : public ppl7::TCPServer
+{
+	public:
+		ppl7::Mutex mutex;
+		int connects;
+		int disconnects;
+		bool reject;
+
+		EchoServer() {
+			connects=0;
+			disconnects=0;
+			reject=false;
+		}
+
+		bool onConnect(Connection &) {
+			mutex.lock();
+			connects++;
+			mutex.unlock();
+			return !reject;
+		}
+
+		void onReadable(Connection &conn) {
+			char buffer[4096];
+			size_t bytes=conn.read(buffer,sizeof(buffer));
+			if (bytes==0) conn.close();
+			else conn.write(buffer,bytes);
+		}
+
+		void onDisconnect(Connection &) {
+			mutex.lock();
+			disconnects++;
+			mutex.unlock();
+		}
+
+		int getDisconnects() {
+			mutex.lock();
+			int ret=disconnects;
+			mutex.unlock();
+			return ret;
+		}
+};
+
+class ServerThread : public ppl7::Thread
+{
+	private:
+		ppl7::TCPServer &server;
+	public:
+		ServerThread(ppl7::TCPServer &s) : server(s) {}
+		void run() {
+			server.run();
+		}
+};
+
+static int bindServer(ppl7::TCPServer &server)
+{
+	for (int port=47100;port<47200;port++) {
+		try {
+			server.bind("127.0.0.1",port);
+			return port;
+		} catch (const ppl7::Exception &) {
+		}
+	}
+	throw ppl7::OperationFailedException("no free port");
+}
+
+static void startServer(ppl7::TCPServer &server, ServerThread &thread)
+{
+	thread.threadStart();
+	for (int i=0;i<2000 && !server.isRunning();i++) ppl7::MSleep(1);
+}
+
+static void stopServer(ppl7::TCPServer &server, ServerThread &thread)
+{
+	server.stop();
+	thread.threadStop();
+}
+
+static ppl7::String echo(ppl7::TCPSocket &socket, const ppl7::String &msg)
+{
+	socket.write(msg);
+	ppl7::String result, part;
+	while (result.size()<msg.size()) {
+		if (socket.read(part,msg.size()-result.size())==0) break;
+		result+=part;
+	}
+	return result;
+}
+
+class TcpServerTest : public ::testing::Test {
+	protected:
+		TcpServerTest() {
+		if (setlocale(LC_CTYPE,DEFAULT_LOCALE)==NULL) {
+			printf ("setlocale fehlgeschlagen\n");
+			throw std::exception();
+		}
+		ppl7::InitSockets();
+	}
+	virtual ~TcpServerTest() {
+
+	}
+};
+
+TEST_F(TcpServerTest, runWithoutBind) {
+	EchoServer server;
+	ASSERT_THROW({
+		server.run();
+	},ppl7::NotConnectedException);
+}
+
+TEST_F(TcpServerTest, echoSingleClient) {
+	EchoServer server;
+	ServerThread thread(server);
+	int port=bindServer(server);
+	startServer(server,thread);
+	ASSERT_TRUE(server.isRunning());
+	ppl7::TCPSocket socket;
+	socket.connect("127.0.0.1",port);
+	ASSERT_EQ(ppl7::String("Hello World"),echo(socket,"Hello World"));
+	ASSERT_EQ(ppl7::String("second message"),echo(socket,"second message"));
+	socket.disconnect();
+	for (int i=0;i<2000 && server.getDisconnects()<1;i++) ppl7::MSleep(1);
+	ASSERT_EQ(1,server.getDisconnects());
+	ASSERT_EQ((size_t)0,server.connectionCount());
+	stopServer(server,thread);
+	ASSERT_FALSE(server.isRunning());
+}
+
+TEST_F(TcpServerTest, echoManyClients) {
+	EchoServer server;
+	ServerThread thread(server);
+	server.setWorkerThreads(4);
+	int port=bindServer(server);
+	startServer(server,thread);
+	const int num=64;
+	ppl7::TCPSocket *clients=new ppl7::TCPSocket[num];
+	for (int i=0;i<num;i++) clients[i].connect("127.0.0.1",port);
+	for (int round=0;round<10;round++) {
+		for (int i=0;i<num;i++) {
+			ppl7::String msg;
+			msg.setf("client %d, round %d",i,round);
+			ASSERT_EQ(msg,echo(clients[i],msg));
+		}
+	}
+	ASSERT_EQ((size_t)num,server.connectionCount());
+	delete [] clients;
+	for (int i=0;i<2000 && server.getDisconnects()<num;i++) ppl7::MSleep(1);
+	ASSERT_EQ(num,server.getDisconnects());
+	stopServer(server,thread);
+}
+
+TEST_F(TcpServerTest, echoLargeMessage) {
+	EchoServer server;
+	ServerThread thread(server);
+	int port=bindServer(server);
+	startServer(server,thread);
+	ppl7::TCPSocket socket;
+	socket.connect("127.0.0.1",port);
+	ppl7::String msg;
+	for (int i=0;i<2000;i++) msg.appendf("%08d",i);
+	ASSERT_EQ(msg,echo(socket,msg));
+	stopServer(server,thread);
+}
+
+TEST_F(TcpServerTest, rejectConnection) {
+	EchoServer server;
+	ServerThread thread(server);
+	server.reject=true;
+	int port=bindServer(server);
+	startServer(server,thread);
+	ppl7::TCPSocket socket;
+	socket.connect("127.0.0.1",port);
+	ppl7::String buffer;
+	ASSERT_EQ((size_t)0,socket.read(buffer,100));
+	ASSERT_EQ((size_t)0,server.connectionCount());
+	ASSERT_EQ(0,server.getDisconnects());
+	stopServer(server,thread);
+}
+
+TEST_F(TcpServerTest, stopClosesConnections) {
+	EchoServer server;
+	ServerThread thread(server);
+	int port=bindServer(server);
+	startServer(server,thread);
+	ppl7::TCPSocket socket1, socket2;
+	socket1.connect("127.0.0.1",port);
+	socket2.connect("127.0.0.1",port);
+	ASSERT_EQ(ppl7::String("ping"),echo(socket1,"ping"));
+	ASSERT_EQ(ppl7::String("ping"),echo(socket2,"ping"));
+	stopServer(server,thread);
+	ASSERT_EQ(2,server.getDisconnects());
+	ASSERT_EQ((size_t)0,server.connectionCount());
+	ppl7::String buffer;
+	ASSERT_EQ((size_t)0,socket1.read(buffer,100));
+}
+
+/*
+ * Sendet die Antwort nicht direkt, sondern erst aus onWritable heraus
+ */
+class DeferredEchoServer : public ppl7::TCPServer
+{
+	public:
+		ppl7::Mutex mutex;
+		std::map<Connection*,ppl7::String> pending;
+
+		void onReadable(Connection &conn) {
+			char buffer[4096];
+			size_t bytes=conn.read(buffer,sizeof(buffer));
+			if (bytes==0) {
+				conn.close();
+				return;
+			}
+			mutex.lock();
+			pending[&conn].append(buffer,bytes);
+			mutex.unlock();
+			conn.watchWritable(true);
+		}
+
+		void onWritable(Connection &conn) {
+			mutex.lock();
+			ppl7::String data=pending[&conn];
+			pending.erase(&conn);
+			mutex.unlock();
+			if (data.notEmpty()) conn.write(data);
+			conn.watchWritable(false);
+		}
+};
+
+TEST_F(TcpServerTest, halfClosedClientGetsResponse) {
+	DeferredEchoServer server;
+	ServerThread thread(server);
+	int port=bindServer(server);
+	startServer(server,thread);
+	ppl7::TCPSocket socket;
+	socket.connect("127.0.0.1",port);
+	socket.write("request");
+	ASSERT_EQ(0,::shutdown(socket.getDescriptor(),SHUT_WR));
+	ppl7::String result, part;
+	while (result.size()<7) {
+		if (socket.read(part,7-result.size())==0) break;
+		result+=part;
+	}
+	ASSERT_EQ(ppl7::String("request"),result);
+	ASSERT_EQ((size_t)0,socket.read(part,100));
+	stopServer(server,thread);
+}
+
+class PipeHandler : public ppl7::EventLoop::Handler
+{
+	public:
+		ppl7::Mutex mutex;
+		ppl7::String data;
+		bool removed;
+
+		PipeHandler() {
+			removed=false;
+		}
+
+		int eventReady(int fd, int events) {
+			char buffer[64];
+			ssize_t bytes=::read(fd,buffer,sizeof(buffer));
+			if (bytes<=0) return 0;
+			mutex.lock();
+			data.append(buffer,bytes);
+			mutex.unlock();
+			return ppl7::EventLoop::EVENT_READ;
+		}
+
+		void eventRemoved(int) {
+			mutex.lock();
+			removed=true;
+			mutex.unlock();
+		}
+
+		ppl7::String getData() {
+			mutex.lock();
+			ppl7::String ret=data;
+			mutex.unlock();
+			return ret;
+		}
+};
+
+class LoopThread : public ppl7::Thread
+{
+	private:
+		ppl7::EventLoop &loop;
+	public:
+		LoopThread(ppl7::EventLoop &l) : loop(l) {}
+		void run() {
+			loop.run(10);
+		}
+};
+
+TEST_F(TcpServerTest, eventLoopPipe) {
+	int fds[2];
+	ASSERT_EQ(0,pipe(fds));
+	PipeHandler handler;
+	ppl7::EventLoop loop;
+	loop.setWorkerThreads(2);
+	ASSERT_EQ((size_t)2,loop.workerThreads());
+	loop.add(fds[0],ppl7::EventLoop::EVENT_READ,&handler);
+	ASSERT_TRUE(loop.contains(fds[0]));
+	ASSERT_EQ((size_t)1,loop.size());
+	ASSERT_THROW({
+		loop.add(fds[0],ppl7::EventLoop::EVENT_READ,&handler);
+	},ppl7::DuplicateInstanceException);
+	LoopThread thread(loop);
+	thread.threadStart();
+	ASSERT_EQ(5,(int)::write(fds[1],"Hello",5));
+	for (int i=0;i<2000 && handler.getData().size()<5;i++) ppl7::MSleep(1);
+	ASSERT_EQ(6,(int)::write(fds[1]," World",6));
+	for (int i=0;i<2000 && handler.getData().size()<11;i++) ppl7::MSleep(1);
+	ASSERT_EQ(ppl7::String("Hello World"),handler.getData());
+	::close(fds[1]);
+	for (int i=0;i<2000 && loop.contains(fds[0]);i++) ppl7::MSleep(1);
+	ASSERT_FALSE(loop.contains(fds[0]));
+	ASSERT_TRUE(handler.removed);
+	loop.stop();
+	thread.threadStop();
+	ASSERT_FALSE(loop.isRunning());
+	::close(fds[0]);
+}
+
+TEST_F(TcpServerTest, eventLoopStopBeforeRun) {
+	ppl7::EventLoop loop;
+	loop.stop();
+	LoopThread thread(loop);
+	thread.threadStart();
+	for (int i=0;i<2000 && thread.threadIsRunning();i++) ppl7::MSleep(1);
+	ASSERT_FALSE(thread.threadIsRunning());
+	ASSERT_FALSE(loop.isRunning());
+}
+
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <vector>
+#include <ppl7.h>
+#include <ppl7-inet.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumNetworks=500000;
+static int NumLookups=2000000;
+static int LinearLookups=200;
+
+static uint32_t nextRandom(uint64_t &seed)
+{
+	seed=seed*6364136223846793005ULL+1442695040888963407ULL;
+	return (uint32_t)(seed>>32);
+}
+
+static ppl7::IPAddress randomAddress(uint64_t &seed, bool v6)
+{
+	unsigned char a[16];
+	for (int i=0;i<16;i+=4) {
+		uint32_t r=nextRandom(seed);
+		memcpy(a+i,&r,4);
+	}
+	if (v6) {
+		a[0]=0x20;
+		a[1]&=0x0f;
+		return ppl7::IPAddress(ppl7::IPAddress::IPv6,a,16);
+	}
+	return ppl7::IPAddress(ppl7::IPAddress::IPv4,a,4);
+}
+
+static int randomPrefixlen(uint64_t &seed, bool v6)
+{
+	// Verteilung ähnlich einer Routing-Tabelle: überwiegend /24 bzw. /48
+	static const int v4len[]={8,12,16,19,20,21,22,22,23,23,24,24,24,24,24,24,24,24,28,32};
+	static const int v6len[]={28,29,32,32,36,40,44,48,48,48,48,48,48,48,56,64,64,64,96,128};
+	uint32_t r=nextRandom(seed)%20;
+	return v6 ? v6len[r] : v4len[r];
+}
+
+static void printResult(const char *descr, double duration, size_t num)
+{
+	printf ("%-44s %10.3f %12.0f\n",descr,duration,(double)num/duration);
+	fflush(NULL);
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumNetworks=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-l")) NumLookups=ppl7::GetArgv(argc,argv,"-l").toInt();
+	if (NumNetworks<1) NumNetworks=1;
+	if (NumLookups<1) NumLookups=1;
+	uint64_t seed=1234567;
+	std::vector<ppl7::IPNetwork> networks;
+	networks.reserve(NumNetworks);
+	for (int i=0;i<NumNetworks;i++) {
+		bool v6=(i%5==4);
+		ppl7::IPNetwork net;
+		net.set(randomAddress(seed,v6),randomPrefixlen(seed,v6));
+		networks.push_back(net);
+	}
+	std::vector<ppl7::IPAddress> addresses;
+	addresses.reserve(NumLookups);
+	for (int i=0;i<NumLookups;i++) {
+		if (i&1) addresses.push_back(networks[nextRandom(seed)%networks.size()].first());
+		else addresses.push_back(randomAddress(seed,i%10==4));
+	}
+	printf ("%d networks, %d lookups\n\n",NumNetworks,NumLookups);
+	printf ("%-44s %10s %12s\n","Test","seconds","ops/s");
+
+	ppl7::IPNetworkTable<uint32_t> table;
+	double start=ppl7::GetMicrotime();
+	for (size_t i=0;i<networks.size();i++) table.insert(networks[i],(uint32_t)i);
+	printResult("IPNetworkTable::insert",ppl7::GetMicrotime()-start,networks.size());
+	printf ("  %zu networks, %zu nodes, %0.1f MB, %0.1f bytes/network\n",table.count(),table.nodeCount(),
+		(double)table.memoryUsage()/1048576.0,(double)table.memoryUsage()/(double)table.count());
+
+	size_t hits=0;
+	start=ppl7::GetMicrotime();
+	for (int i=0;i<LinearLookups;i++) {
+		for (size_t k=0;k<networks.size();k++) {
+			if (networks[k].contains(addresses[i])) {
+				hits++;
+				break;
+			}
+		}
+	}
+	printResult("linear scan with IPNetwork::contains",ppl7::GetMicrotime()-start,LinearLookups);
+
+	hits=0;
+	start=ppl7::GetMicrotime();
+	for (size_t i=0;i<addresses.size();i++) {
+		if (table.lookup(addresses[i])) hits++;
+	}
+	printResult("IPNetworkTable::lookup",ppl7::GetMicrotime()-start,addresses.size());
+	printf ("  %zu hits\n",hits);
+
+	std::vector<const uint32_t*> results;
+	start=ppl7::GetMicrotime();
+	hits=table.lookup(addresses,results);
+	printResult("IPNetworkTable::lookup, batch",ppl7::GetMicrotime()-start,addresses.size());
+	printf ("  %zu hits\n",hits);
+
+	start=ppl7::GetMicrotime();
+	for (size_t i=0;i<networks.size();i+=2) table.remove(networks[i]);
+	printResult("IPNetworkTable::remove",ppl7::GetMicrotime()-start,(networks.size()+1)/2);
+	return 0;
+}
@@ -0,0 +1,168 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <ppl7.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumThreads=4;
+static int NumMessages=20000;
+
+class LogThread : public ppl7::Thread
+{
+	public:
+		ppl7::Logger *log;
+		std::vector<double> latency;
+		volatile bool done;
+
+		LogThread() {
+			log=NULL;
+			done=false;
+		}
+		void run() {
+			latency.reserve(NumMessages);
+			for (int i=0;i<NumMessages;i++) {
+				double start=ppl7::GetMicrotime();
+				log->printf(ppl7::Logger::DEBUG,1,__FILE__,__LINE__,"message %d from thread %llu with some payload",
+					i,(unsigned long long)threadGetID());
+				latency.push_back(ppl7::GetMicrotime()-start);
+			}
+			done=true;
+		}
+};
+
+static void bench(const char *descr, ppl7::Logger &log)
+{
+	std::vector<LogThread> threads(NumThreads);
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<NumThreads;i++) {
+		threads[i].log=&log;
+		threads[i].threadStart();
+	}
+	for (int i=0;i<NumThreads;i++) {
+		while (!threads[i].done) ppl7::MSleep(1);
+		threads[i].threadStop();
+	}
+	double callers=ppl7::GetMicrotime()-start;
+	log.flush();
+	double total=ppl7::GetMicrotime()-start;
+	std::vector<double> all;
+	for (int i=0;i<NumThreads;i++) all.insert(all.end(),threads[i].latency.begin(),threads[i].latency.end());
+	std::sort(all.begin(),all.end());
+	double sum=0.0;
+	for (size_t i=0;i<all.size();i++) sum+=all[i];
+	size_t n=all.size();
+	printf ("%-28s %8.2f %8.2f %8.2f %10.2f %9.3f %9.3f %9llu\n",descr,
+		sum/(double)n*1000000.0,all[n/2]*1000000.0,all[n*99/100]*1000000.0,all[n-1]*1000000.0,
+		callers,total,(unsigned long long)log.droppedMessages());
+	fflush(NULL);
+}
+
+static void benchFilter(const char *descr, ppl7::Logger &log, int level, int calls)
+{
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<calls;i++) {
+		log.print(ppl7::Logger::DEBUG,level,"loggerspeed","benchFilter",__FILE__,__LINE__,"filtered message");
+	}
+	double duration=ppl7::GetMicrotime()-start;
+	printf ("%-36s %10.2f\n",descr,duration/(double)calls*1000000000.0);
+	fflush(NULL);
+}
+
+static void benchFilters(int calls)
+{
+	ppl7::Logger log;
+	log.setLogLevel(ppl7::Logger::DEBUG,5);
+	printf ("\n%d calls per mode, cost per call in nanoseconds\n\n",calls);
+	printf ("%-36s %10s\n","Filter","ns/call");
+	benchFilter("debuglevel too low",log,6,calls);
+	log.setFilter("loggerspeed","benchFilter",2);
+	benchFilter("filtered by module::function",log,3,calls);
+	log.deleteFilter("loggerspeed","benchFilter");
+	log.setFilter(__FILE__,0,2);
+	benchFilter("filtered by file",log,3,calls);
+	log.deleteFilter(__FILE__,0);
+	log.setFilter("othermodule",(const char*)NULL,1);
+	log.setFilter("otherfile.cpp",0,1);
+	// Die Meldung passiert die Filter und wird vollständig verarbeitet
+	benchFilter("not filtered, other filters active",log,3,calls);
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-t")) NumThreads=ppl7::GetArgv(argc,argv,"-t").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumMessages=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (NumThreads<1) NumThreads=1;
+	if (NumMessages<1) NumMessages=1;
+	ppl7::Dir::mkDir("tmp",true);
+	ppl7::String filename="tmp/loggerspeed.log";
+	printf ("%d threads, %d messages per thread, latency in microseconds\n\n",NumThreads,NumMessages);
+	printf ("%-28s %8s %8s %8s %10s %9s %9s %9s\n","Mode","avg","p50","p99","max","callers","total","dropped");
+	{
+		ppl7::Logger log;
+		log.setLogfile(ppl7::Logger::DEBUG,filename,5);
+		bench("synchronous",log);
+	}
+	ppl7::File::unlink(filename);
+	{
+		ppl7::Logger log;
+		log.setLogfile(ppl7::Logger::DEBUG,filename,5);
+		log.enableAsync(65536,ppl7::Logger::OVERFLOW_BLOCK);
+		bench("async, block",log);
+	}
+	ppl7::File::unlink(filename);
+	{
+		ppl7::Logger log;
+		log.setLogfile(ppl7::Logger::DEBUG,filename,5);
+		log.enableAsync(1024,ppl7::Logger::OVERFLOW_BLOCK);
+		bench("async, block, 1024 records",log);
+	}
+	ppl7::File::unlink(filename);
+	{
+		ppl7::Logger log;
+		log.setLogfile(ppl7::Logger::DEBUG,filename,5);
+		log.enableAsync(1024,ppl7::Logger::OVERFLOW_COUNT);
+		bench("async, count, 1024 records",log);
+	}
+	ppl7::File::unlink(filename);
+	benchFilters(NumMessages*100);
+	return 0;
+}
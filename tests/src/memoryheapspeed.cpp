@@ -0,0 +1,206 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <ppl7.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumElements=200000;
+static int NumThreads=4;
+static int ElementSize=48;
+
+class Allocator
+{
+	public:
+		virtual ~Allocator() {}
+		virtual void *malloc()=0;
+		virtual void free(void *ptr)=0;
+};
+
+class SystemAllocator : public Allocator
+{
+	public:
+		void *malloc() {
+			return ::malloc(ElementSize);
+		}
+		void free(void *ptr) {
+			::free(ptr);
+		}
+};
+
+class HeapAllocator : public Allocator
+{
+	public:
+		ppl7::MemoryHeap heap;
+		HeapAllocator(size_t increase=1000, size_t growpercent=30) {
+			heap.init(ElementSize,0,increase,growpercent);
+		}
+		void *malloc() {
+			return heap.malloc();
+		}
+		void free(void *ptr) {
+			heap.free(ptr);
+		}
+};
+
+static void printResult(const char *descr, double duration, size_t operations)
+{
+	printf ("%-40s %10.3f %10.1f\n",descr,duration,duration/(double)operations*1000000000.0);
+	fflush(NULL);
+}
+
+static void benchSequence(const char *descr, Allocator &alloc, const std::vector<size_t> &order)
+{
+	std::vector<void*> ptr(NumElements);
+	double start=ppl7::GetMicrotime();
+	for (int round=0;round<5;round++) {
+		for (int i=0;i<NumElements;i++) {
+			ptr[i]=alloc.malloc();
+			memset(ptr[i],0,ElementSize);
+		}
+		for (int i=0;i<NumElements;i++) alloc.free(ptr[order[i]]);
+	}
+	printResult(descr,ppl7::GetMicrotime()-start,(size_t)NumElements*5*2);
+}
+
+static void benchList(const char *descr)
+{
+	double start=ppl7::GetMicrotime();
+	ppl7::List<int> list;
+	for (int i=0;i<NumElements;i++) list.add(i);
+	// Von vorne löschen, damit die lineare Suche in List::erase nicht ins Gewicht fällt
+	for (int i=0;i<NumElements;i++) list.erase(i);
+	list.clear();
+	printResult(descr,ppl7::GetMicrotime()-start,(size_t)NumElements*2);
+}
+
+class HeapThread : public ppl7::Thread
+{
+	public:
+		Allocator *alloc;
+		volatile bool done;
+
+		HeapThread() {
+			alloc=NULL;
+			done=false;
+		}
+		void run() {
+			std::vector<void*> ptr(256);
+			for (int round=0;round<NumElements/256;round++) {
+				for (size_t i=0;i<ptr.size();i++) {
+					ptr[i]=alloc->malloc();
+					memset(ptr[i],0,ElementSize);
+				}
+				for (size_t i=0;i<ptr.size();i++) alloc->free(ptr[i]);
+			}
+			done=true;
+		}
+};
+
+static void benchThreads(const char *descr, Allocator &alloc)
+{
+	std::vector<HeapThread> threads(NumThreads);
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<NumThreads;i++) {
+		threads[i].alloc=&alloc;
+		threads[i].threadStart();
+	}
+	for (int i=0;i<NumThreads;i++) {
+		while (!threads[i].done) ppl7::MSleep(1);
+		threads[i].threadStop();
+	}
+	printResult(descr,ppl7::GetMicrotime()-start,(size_t)(NumElements/256)*256*2*NumThreads);
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-n")) NumElements=ppl7::GetArgv(argc,argv,"-n").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-t")) NumThreads=ppl7::GetArgv(argc,argv,"-t").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-s")) ElementSize=ppl7::GetArgv(argc,argv,"-s").toInt();
+	if (NumElements<256) NumElements=256;
+	if (NumThreads<1) NumThreads=1;
+	if (ElementSize<1) ElementSize=1;
+	std::vector<size_t> fifo(NumElements), lifo(NumElements), random(NumElements);
+	for (int i=0;i<NumElements;i++) {
+		fifo[i]=i;
+		lifo[i]=NumElements-1-i;
+		random[i]=i;
+	}
+	std::mt19937 rng(42);
+	std::shuffle(random.begin(),random.end(),rng);
+
+	printf ("%d elements of %d bytes, %d threads\n\n",NumElements,ElementSize,NumThreads);
+	printf ("%-40s %10s %10s\n","Test","seconds","ns/op");
+	{
+		SystemAllocator a;
+		benchSequence("malloc, free in allocation order",a,fifo);
+		benchSequence("malloc, free in reverse order",a,lifo);
+		benchSequence("malloc, free in random order",a,random);
+	}
+	{
+		HeapAllocator a;
+		benchSequence("MemoryHeap, free in allocation order",a,fifo);
+		benchSequence("MemoryHeap, free in reverse order",a,lifo);
+		benchSequence("MemoryHeap, free in random order",a,random);
+	}
+	{
+		// Viele kleine Blöcke ohne Wachstum
+		HeapAllocator a(100,0);
+		benchSequence("MemoryHeap, 100 per block, random order",a,random);
+	}
+	benchList("List<int>, add and erase");
+	{
+		SystemAllocator a;
+		benchThreads("malloc, threads",a);
+	}
+	{
+		HeapAllocator a;
+		a.heap.enableThreadCache(0);
+		benchThreads("MemoryHeap, threads, mutex only",a);
+	}
+	{
+		HeapAllocator a;
+		a.heap.enableThreadCache(64);
+		benchThreads("MemoryHeap, threads, magazines",a);
+	}
+	return 0;
+}
@@ -0,0 +1,157 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <ppl7.h>
+#include <ppl7-grafix.h>
+#include "ppl7-tests.h"
+
+/*
+ * Benchmark für das Skalieren von Grafiken. Gemessen wird das Verkleinern eines großen
+ * Fotos auf Thumbnail-Größe und das Vergrößern auf die doppelte Größe. Jeder Filter von
+ * Resampler wird mit den skalaren, den SSE4.1- und den AVX2-Implementierungen in einem
+ * Thread ausgeführt (siehe Resampler::setCaps), die letzte Spalte verwendet AVX2 und
+ * alle Threads. Zum Vergleich wird auch Drawable::scale ohne Resampler gemessen. Das
+ * Ergebnis wird in Megapixel der Quellgrafik pro Sekunde ausgegeben.
+ *
+ * Optionen:
+ *   -w Breite   Breite der Quellgrafik (Default 4000)
+ *   -h Höhe     Höhe der Quellgrafik (Default 3000)
+ *   -r Runden   Anzahl Wiederholungen je Messung (Default 5)
+ *   -t Threads  Anzahl Threads für die letzte Spalte (Default 0 = alle CPU-Kerne)
+ */
+
+ppl7::ConfigParser PPL7TestConfig;
+
+using ppl7::grafix::Image;
+using ppl7::grafix::RGBFormat;
+using ppl7::grafix::Resampler;
+
+static int Width=4000;
+static int Height=3000;
+static int Rounds=5;
+static int Threads=0;
+
+static void fillPhoto(Image& img)
+{
+	uint64_t seed=1;
+	for (int y=0;y < img.height();y++) {
+		uint8_t* p=(uint8_t*)img.adr(0, y);
+		for (int x=0;x < img.width();x++) {
+			seed=seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			int noise=(int)(seed >> 60);
+			p[x * 4]=(uint8_t)((x * 255 / img.width() + noise) & 255);
+			p[x * 4 + 1]=(uint8_t)((y * 255 / img.height() + noise) & 255);
+			p[x * 4 + 2]=(uint8_t)(((x + y) & 255) ^ noise);
+			p[x * 4 + 3]=(uint8_t)(x < 16 ? x * 16 : 255);
+		}
+	}
+}
+
+static double measure(const Image& src, int tw, int th, Resampler& resampler, uint32_t level)
+{
+	Image tgt(tw, th, src.rgbformat());
+	Resampler::setCaps(level);
+	resampler.resample(src, tgt);	// Aufwärmen
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i < Rounds;i++) resampler.resample(src, tgt);
+	double duration=ppl7::GetMicrotime() - start;
+	return (double)src.width() * src.height() * Rounds / duration / 1000000.0;
+}
+
+static void run(const char* descr, const Image& src, int tw, int th, Resampler::Filter filter)
+{
+	static const uint32_t levels[]={ 0, ppl7::CPUCAPS::CPU_HAVE_SSE41,
+		ppl7::CPUCAPS::CPU_HAVE_SSE41 | ppl7::CPUCAPS::CPU_HAVE_AVX2 };
+	Resampler single(filter, 1), multi(filter, Threads);
+	printf("%-28s:", descr);
+	uint32_t best=0;
+	for (auto level : levels) {
+		Resampler::setCaps(level);
+		if (Resampler::caps() != level) {
+			printf(" %10s", "-");
+			continue;
+		}
+		best=level;
+		printf(" %10.1f", measure(src, tw, th, single, level));
+		fflush(NULL);
+	}
+	printf(" %10.1f\n", measure(src, tw, th, multi, best));
+	fflush(NULL);
+}
+
+static void runLegacy(const char* descr, const Image& src, int tw, int th, bool smooth)
+{
+	Image tgt;
+	src.scale(tgt, tw, th, false, smooth);
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i < Rounds;i++) src.scale(tgt, tw, th, false, smooth);
+	double duration=ppl7::GetMicrotime() - start;
+	printf("%-28s: %10.1f\n", descr, (double)src.width() * src.height() * Rounds / duration / 1000000.0);
+	fflush(NULL);
+}
+
+int main(int argc, char** argv)
+{
+	if (ppl7::HaveArgv(argc, argv, "-w")) Width=ppl7::GetArgv(argc, argv, "-w").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-h")) Height=ppl7::GetArgv(argc, argv, "-h").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-r")) Rounds=ppl7::GetArgv(argc, argv, "-r").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-t")) Threads=ppl7::GetArgv(argc, argv, "-t").toInt();
+	if (Width < 16 || Height < 16 || Rounds < 1 || Threads < 0) {
+		printf("Ungültige Parameter\n");
+		return 1;
+	}
+	try {
+		ppl7::grafix::Grafix gfx;
+		uint32_t caps=Resampler::caps();
+		Image photo(Width, Height, RGBFormat::A8R8G8B8);
+		fillPhoto(photo);
+		Image small(Width / 4, Height / 4, RGBFormat::A8R8G8B8);
+		fillPhoto(small);
+		int tw=256, th=Height * 256 / Width;
+
+		printf("%d x %d Pixel => %d x %d, %d Runden, CPU-Caps: 0x%08x\n\n", Width, Height, tw, th, Rounds, ppl7::GetCPUCaps());
+		printf("%-28s  %10s %10s %10s %10s\n", "Megapixel/s (Quelle)", "Skalar", "SSE4.1", "AVX2", "Threads");
+		run("Thumbnail Box", photo, tw, th, Resampler::Box);
+		run("Thumbnail Bilinear", photo, tw, th, Resampler::Bilinear);
+		run("Thumbnail Bicubic", photo, tw, th, Resampler::Bicubic);
+		run("Thumbnail Lanczos3", photo, tw, th, Resampler::Lanczos3);
+		run("Zoom 2x Bilinear", small, small.width() * 2, small.height() * 2, Resampler::Bilinear);
+		run("Zoom 2x Lanczos3", small, small.width() * 2, small.height() * 2, Resampler::Lanczos3);
+		printf("\nDrawable::scale ohne Resampler\n");
+		runLegacy("Thumbnail nearest", photo, tw, th, false);
+		runLegacy("Thumbnail smoothTransform", photo, tw, th, true);
+		runLegacy("Zoom 2x smoothTransform", small, small.width() * 2, small.height() * 2, true);
+		Resampler::setCaps(caps);
+	} catch (const ppl7::Exception& exp) {
+		exp.print();
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <ppl7.h>
+#include "ppl7-tests.h"
+
+/*
+ * Micro-Benchmark für die String-Kernel (siehe PPLGroupStringKernels). Jede Operation
+ * wird nacheinander mit den skalaren, den SSE2- und den AVX2-Implementierungen
+ * ausgeführt. Varianten, die von der CPU nicht unterstützt werden, werden übersprungen.
+ */
+
+extern const char *wordlist;
+
+static ppl7::String Text;
+static ppl7::WideString WideText;
+static ppl7::String Padded;
+static ppl7::WideString WidePadded;
+static ppl7::String Needle;
+static ppl7::WideString WideNeedle;
+
+static const int Rounds=2000;
+
+void find_string()
+{
+	for (int i=0;i<Rounds;i++) {
+		if (Text.instr(Needle)<0) throw ppl7::Exception();
+	}
+}
+
+void find_widestring()
+{
+	for (int i=0;i<Rounds;i++) {
+		if (WideText.instr(WideNeedle)<0) throw ppl7::Exception();
+	}
+}
+
+void replace_string()
+{
+	for (int i=0;i<Rounds/20;i++) {
+		ppl7::String s(Text);
+		s.replace(" ","_");
+	}
+}
+
+void replace_widestring()
+{
+	for (int i=0;i<Rounds/20;i++) {
+		ppl7::WideString s(WideText);
+		s.replace(L" ",L"_");
+	}
+}
+
+void split_string()
+{
+	for (int i=0;i<Rounds/20;i++) {
+		ppl7::Array a;
+		a.explode(Text," :: ");
+	}
+}
+
+void lowercase_string()
+{
+	for (int i=0;i<Rounds;i++) {
+		ppl7::String s(Text);
+		s.lowerCase();
+	}
+}
+
+void uppercase_widestring()
+{
+	for (int i=0;i<Rounds;i++) {
+		ppl7::WideString s(WideText);
+		s.upperCase();
+	}
+}
+
+void trim_string()
+{
+	for (int i=0;i<Rounds*10;i++) {
+		ppl7::String s(Padded);
+		s.trim();
+	}
+}
+
+void trim_widestring()
+{
+	for (int i=0;i<Rounds*10;i++) {
+		ppl7::WideString s(WidePadded);
+		s.trim();
+	}
+}
+
+static void run(const char *descr, void (*fn)())
+{
+	static const uint32_t levels[]={0, ppl7::CPUCAPS::CPU_HAVE_SSE2,
+		ppl7::CPUCAPS::CPU_HAVE_SSE2|ppl7::CPUCAPS::CPU_HAVE_AVX2};
+	printf ("%-25s:",descr);
+	for (auto level : levels) {
+		ppl7::SetStringKernelCaps(level);
+		if (ppl7::GetStringKernelCaps()!=level) {
+			printf (" %10s","-");
+			continue;
+		}
+		double start=ppl7::GetMicrotime();
+		fn();
+		printf (" %10.3f",ppl7::GetMicrotime()-start);
+	}
+	printf ("\n");
+	fflush(NULL);
+}
+
+int main (int argc, char**argv)
+{
+	if (setlocale(LC_CTYPE,"")==NULL) {
+		printf ("setlocale fehlgeschlagen\n");
+		return 1;
+	}
+	uint32_t caps=ppl7::GetStringKernelCaps();
+	// Ein langer Text aus ASCII-Wörtern, wie er z.B. in Logzeilen vorkommt
+	ppl7::Array words;
+	words.explode(ppl7::String(wordlist),"\n");
+	for (size_t i=0;i<words.size() && Text.size()<64000;i+=7) {
+		Text.append(words[i]);
+		Text.append((i%5)==0 ? " :: " : " ");
+	}
+	Needle="end of text marker";
+	Text.append(Needle);
+	WideText=Text;
+	WideNeedle=Needle;
+	Padded.set(" \t",1).repeat(200);
+	Padded=Padded+"payload"+Padded;
+	WidePadded=Padded;
+
+	printf ("Textlänge: %zu Bytes, CPU-Caps: 0x%08x\n\n",Text.size(),ppl7::GetCPUCaps());
+	printf ("%-25s  %10s %10s %10s\n","Sekunden","Skalar","SSE2","AVX2");
+	run ("String::instr", find_string);
+	run ("WideString::instr", find_widestring);
+	run ("String::replace", replace_string);
+	run ("WideString::replace", replace_widestring);
+	run ("Array::explode", split_string);
+	run ("String::lowerCase", lowercase_string);
+	run ("WideString::upperCase", uppercase_widestring);
+	run ("String::trim", trim_string);
+	run ("WideString::trim", trim_widestring);
+	ppl7::SetStringKernelCaps(caps);
+	return 0;
+}
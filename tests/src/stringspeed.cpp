@@ -48,6 +48,35 @@ extern "C" {
 
 extern const char *wordlist;
 
+#ifdef __GLIBC__
+/*
+ * Alle Aufrufe von malloc, calloc und realloc werden gezählt, damit pro Test
+ * die Anzahl Allokationen pro Operation ausgegeben werden kann.
+ */
+static size_t alloc_count=0;
+extern "C" {
+	void *__libc_malloc(size_t size);
+	void *__libc_calloc(size_t nmemb, size_t size);
+	void *__libc_realloc(void *ptr, size_t size);
+
+	void *malloc(size_t size)
+	{
+		alloc_count++;
+		return __libc_malloc(size);
+	}
+	void *calloc(size_t nmemb, size_t size)
+	{
+		alloc_count++;
+		return __libc_calloc(nmemb, size);
+	}
+	void *realloc(void *ptr, size_t size)
+	{
+		alloc_count++;
+		return __libc_realloc(ptr, size);
+	}
+}
+#endif
+
 ppl7::Array Wordlist;
 ppl7::ConfigParser PPL7TestConfig;
 ppl7::AssocArray TestAssocArray;
@@ -76,6 +105,36 @@ void create_large_strings()
 	}
 }
 
+void copy_short_strings()
+{
+	ppl7::String source("Content-Length");
+	ppl7::String target;
+	for (int i=0;i<10000000;i++) {
+		target=source;
+	}
+}
+
+void move_strings()
+{
+	ppl7::String a("The big brown fox jumps over the lazy dog");
+	ppl7::String b;
+	for (int i=0;i<10000000;i++) {
+		b=std::move(a);
+		a=std::move(b);
+	}
+}
+
+void append_tokens()
+{
+	ppl7::String line;
+	for (int i=0;i<1000;i++) {
+		line.clear();
+		for (int t=0;t<10000;t++) {
+			line.append("token ");
+		}
+	}
+}
+
 void create_ordered_set_with_strings_from_wordlist()
 {
 	std::set<ppl7::String> sset;
@@ -90,12 +149,20 @@ void create_ordered_set_with_strings_from_wordlist()
 }
 
 
-double timer(const char *descr, void (*fn)())
+double timer(const char *descr, void (*fn)(), double operations)
 {
+#ifdef __GLIBC__
+	size_t allocs=alloc_count;
+#endif
 	double start=ppl7::GetMicrotime();
 	fn();
 	double duration=ppl7::GetMicrotime()-start;
+#ifdef __GLIBC__
+	allocs=alloc_count-allocs;
+	printf ("%-30s: %0.3f, %0.3f allocs/op\n",descr, duration, (double)allocs/operations);
+#else
 	printf ("%-30s: %0.3f\n",descr, duration);
+#endif
 	fflush(NULL);
 	return duration;
 }
@@ -111,10 +178,13 @@ int main (int argc, char**argv)
 	Wordlist.explode(w,"\n");
 	ppl7::PrintDebugTime ("done\n");
 
-	timer ("create empty strings", create_empty_strings);
-	timer ("create short strings", create_strings);
-	timer ("create large strings", create_large_strings);
-	timer ("ordered set with strings", create_ordered_set_with_strings_from_wordlist);
+	timer ("create empty strings", create_empty_strings, 10000000);
+	timer ("create short strings", create_strings, 10000000);
+	timer ("create large strings", create_large_strings, 10000000);
+	timer ("copy short strings", copy_short_strings, 10000000);
+	timer ("move strings", move_strings, 20000000);
+	timer ("append tokens", append_tokens, 10000000);
+	timer ("ordered set with strings", create_ordered_set_with_strings_from_wordlist, 10.0 * Wordlist.size());
 	double duration=ppl7::GetMicrotime()-start;
 	printf ("%-30s: %0.3f\n","Totaltime",duration);
 	return 1;
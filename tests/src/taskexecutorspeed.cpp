@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <ppl7.h>
+#include <ppl7/core/taskexecutor.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static std::vector<double> Values;
+
+static double compute(size_t i)
+{
+	double x=(double)i;
+	return sqrt(x)*sin(x)+cos(x*0.5);
+}
+
+static void sequential_for()
+{
+	size_t num=Values.size();
+	for (size_t i=0;i<num;i++) Values[i]=compute(i);
+}
+
+static void parallel_for(ppl7::TaskExecutor &e)
+{
+	e.parallelFor((size_t)0,Values.size(),[](size_t i) {
+		Values[i]=compute(i);
+	});
+}
+
+static void parallel_reduce(ppl7::TaskExecutor &e)
+{
+	double sum=e.parallelReduce((size_t)0,Values.size(),0.0,
+		[](size_t i) { return Values[i]; },
+		[](double a, double b) { return a+b; });
+	if (sum==0.0) printf("unexpected result\n");
+}
+
+static void many_tasks(ppl7::TaskExecutor &e)
+{
+	std::atomic<size_t> counter(0);
+	for (int i=0;i<200000;i++) {
+		e.post([&counter]() { counter++; });
+	}
+	e.wait();
+	if (counter!=200000) printf("unexpected result: %zu\n", (size_t)counter);
+}
+
+static void spawned_tasks(ppl7::TaskExecutor &e)
+{
+	std::atomic<size_t> counter(0);
+	for (int i=0;i<200;i++) {
+		e.post([&e, &counter]() {
+			for (int j=0;j<1000;j++) {
+				e.post([&counter]() {
+					double x=0.0;
+					for (int k=0;k<200;k++) x+=compute(k);
+					if (x!=0.0) counter++;
+				});
+			}
+		});
+	}
+	e.wait();
+	if (counter!=200000) printf("unexpected result: %zu\n", (size_t)counter);
+}
+
+static double timer(ppl7::TaskExecutor &e, void (*fn)(ppl7::TaskExecutor &e))
+{
+	double start=ppl7::GetMicrotime();
+	fn(e);
+	return ppl7::GetMicrotime()-start;
+}
+
+int main (int argc, char**argv)
+{
+	size_t maxthreads=std::thread::hardware_concurrency();
+	if (ppl7::HaveArgv(argc,argv,"-t")) maxthreads=ppl7::GetArgv(argc,argv,"-t").toInt();
+	if (maxthreads<1) maxthreads=1;
+	Values.resize(20000000);
+
+	double start=ppl7::GetMicrotime();
+	sequential_for();
+	double seq=ppl7::GetMicrotime()-start;
+	printf ("%-40s: %0.3f\n","sequential for, 20M elements",seq);
+	printf ("\n%8s %14s %8s %14s %14s %14s\n","Threads","parallelFor","Speedup",
+		"parallelReduce","200k post","200k spawned");
+	fflush(NULL);
+
+	for (size_t threads=1;threads<=maxthreads;threads*=2) {
+		ppl7::TaskExecutor e(threads);
+		double t_for=timer(e,parallel_for);
+		double t_reduce=timer(e,parallel_reduce);
+		double t_post=timer(e,many_tasks);
+		double t_spawn=timer(e,spawned_tasks);
+		printf ("%8zu %14.3f %7.2fx %14.3f %14.3f %14.3f\n",threads,
+			t_for,seq/t_for,t_reduce,t_post,t_spawn);
+		fflush(NULL);
+		if (threads<maxthreads && threads*2>maxthreads) threads=maxthreads/2;
+	}
+	return 0;
+}
@@ -0,0 +1,257 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ * $Author$
+ * $Revision$
+ * $Date$
+ * $Id$
+ *
+ *******************************************************************************
+ * Copyright (c) 2013, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <list>
+#include <ppl7.h>
+#include <ppl7-inet.h>
+#include "ppl7-tests.h"
+
+ppl7::ConfigParser PPL7TestConfig;
+
+static int NumClients=1000;
+static int NumClientThreads=8;
+static int NumWorkers=4;
+static int NumRounds=100;
+static int Port=47300;
+static ppl7::Mutex DoneMutex;
+static int ClientsDone=0;
+
+class EchoServer : public ppl7::TCPServer
+{
+	public:
+		void onReadable(Connection &conn) {
+			char buffer[4096];
+			size_t bytes=conn.read(buffer,sizeof(buffer));
+			if (bytes==0) conn.close();
+			else conn.write(buffer,bytes);
+		}
+};
+
+class EchoServerThread : public ppl7::Thread
+{
+	private:
+		ppl7::TCPServer &server;
+	public:
+		EchoServerThread(ppl7::TCPServer &s) : server(s) {}
+		void run() {
+			server.run();
+		}
+};
+
+/*
+ * Herkoemmliches Modell zum Vergleich: TCPSocket::listen mit einem Thread pro Verbindung
+ */
+class EchoConnectionThread : public ppl7::Thread
+{
+	private:
+		ppl7::TCPSocket *socket;
+	public:
+		EchoConnectionThread(ppl7::TCPSocket *s) : socket(s) {
+			threadDeleteOnExit(1);
+		}
+		~EchoConnectionThread() {
+			delete socket;
+		}
+		void run() {
+			char buffer[4096];
+			try {
+				while (1) {
+					size_t bytes=socket->read(buffer,sizeof(buffer));
+					if (bytes==0) break;
+					socket->write(buffer,bytes);
+				}
+			} catch (...) {
+			}
+		}
+};
+
+class ThreadedEchoServer : public ppl7::TCPSocket
+{
+	public:
+		int receiveConnect(ppl7::TCPSocket *socket, const ppl7::String &, int) {
+			EchoConnectionThread *t=new EchoConnectionThread(socket);
+			t->threadStart();
+			return 1;
+		}
+};
+
+class ThreadedEchoServerThread : public ppl7::Thread
+{
+	private:
+		ThreadedEchoServer &server;
+	public:
+		ThreadedEchoServerThread(ThreadedEchoServer &s) : server(s) {}
+		void run() {
+			server.listen(1024);
+		}
+};
+
+/*
+ * Jeder Client-Thread haelt NumClients/NumClientThreads Verbindungen und schickt pro Runde
+ * auf jeder Verbindung eine Nachricht, bevor er die Antworten einsammelt. Dadurch sind auf
+ * dem Server immer viele Verbindungen gleichzeitig aktiv.
+ */
+class ClientThread : public ppl7::Thread
+{
+	private:
+		int num;
+	public:
+		size_t messages;
+		size_t errors;
+
+		ClientThread(int connections) {
+			num=connections;
+			messages=0;
+			errors=0;
+		}
+
+		void run() {
+			ppl7::TCPSocket *sockets=new ppl7::TCPSocket[num];
+			const char *msg="0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+			size_t len=strlen(msg);
+			char buffer[128];
+			try {
+				for (int i=0;i<num;i++) sockets[i].connect("127.0.0.1",Port);
+				for (int round=0;round<NumRounds;round++) {
+					for (int i=0;i<num;i++) sockets[i].write(msg,len);
+					for (int i=0;i<num;i++) {
+						size_t got=0;
+						while (got<len) {
+							size_t bytes=sockets[i].read(buffer,len-got);
+							if (bytes==0) break;
+							got+=bytes;
+						}
+						if (got==len) messages++;
+						else errors++;
+					}
+				}
+			} catch (const ppl7::Exception &e) {
+				errors++;
+				e.print();
+			}
+			delete [] sockets;
+			DoneMutex.lock();
+			ClientsDone++;
+			DoneMutex.unlock();
+		}
+};
+
+static double run_clients()
+{
+	std::list<ClientThread*> clients;
+	std::list<ClientThread*>::iterator it;
+	int per_thread=NumClients/NumClientThreads;
+	ClientsDone=0;
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i<NumClientThreads;i++) {
+		ClientThread *t=new ClientThread(per_thread);
+		clients.push_back(t);
+		t->threadStart();
+	}
+	while (1) {
+		DoneMutex.lock();
+		int done=ClientsDone;
+		DoneMutex.unlock();
+		if (done==NumClientThreads) break;
+		ppl7::MSleep(1);
+	}
+	double duration=ppl7::GetMicrotime()-start;
+	size_t messages=0, errors=0;
+	for (it=clients.begin();it!=clients.end();++it) {
+		(*it)->threadStop();
+		messages+=(*it)->messages;
+		errors+=(*it)->errors;
+		delete (*it);
+	}
+	printf ("   %zu messages, %zu errors in %0.3f s = %0.0f messages/s\n",
+		messages, errors, duration, (double)messages/duration);
+	fflush(NULL);
+	return duration;
+}
+
+static void bench_tcpserver()
+{
+	EchoServer server;
+	EchoServerThread thread(server);
+	server.bind("127.0.0.1",Port);
+	server.setWorkerThreads(NumWorkers);
+	thread.threadStart();
+	while (!server.isRunning()) ppl7::MSleep(1);
+	printf ("TCPServer (EventLoop, %d worker):\n", NumWorkers);
+	run_clients();
+	server.stop();
+	thread.threadStop();
+}
+
+static void bench_threaded()
+{
+	ThreadedEchoServer server;
+	ThreadedEchoServerThread thread(server);
+	server.bind("127.0.0.1",Port);
+	thread.threadStart();
+	ppl7::MSleep(100);
+	printf ("TCPSocket::listen (Thread pro Verbindung):\n");
+	run_clients();
+	server.stopListen();
+	thread.threadStop();
+}
+
+static void help()
+{
+	printf ("tcpserverspeed [-c CLIENTS] [-t CLIENTTHREADS] [-w WORKERS] [-r ROUNDS] [-p PORT]\n");
+}
+
+int main (int argc, char**argv)
+{
+	if (ppl7::HaveArgv(argc,argv,"-h") || ppl7::HaveArgv(argc,argv,"--help")) {
+		help();
+		return 0;
+	}
+	if (ppl7::HaveArgv(argc,argv,"-c")) NumClients=ppl7::GetArgv(argc,argv,"-c").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-t")) NumClientThreads=ppl7::GetArgv(argc,argv,"-t").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-w")) NumWorkers=ppl7::GetArgv(argc,argv,"-w").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-r")) NumRounds=ppl7::GetArgv(argc,argv,"-r").toInt();
+	if (ppl7::HaveArgv(argc,argv,"-p")) Port=ppl7::GetArgv(argc,argv,"-p").toInt();
+	if (NumClientThreads<1) NumClientThreads=1;
+	ppl7::InitSockets();
+	printf ("%d connections, %d client threads, %d rounds\n", NumClients, NumClientThreads, NumRounds);
+	bench_tcpserver();
+	bench_threaded();
+	return 0;
+}
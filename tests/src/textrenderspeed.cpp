@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <ppl7.h>
+#include <ppl7-grafix.h>
+#include "ppl7-tests.h"
+
+/*
+ * Benchmark für das Zeichnen von Text mit FontEngineFreeType. Simuliert wird das
+ * Beschriften vieler Kacheln mit kurzen Texten, jede Messung wird ohne Glyph-Cache
+ * (FontEngineFreeType::setCacheSize(0), jede Glyphe wird pro Aufruf neu gerendert) und
+ * mit Cache ausgeführt. Ausgegeben werden Texte pro Sekunde.
+ *
+ * Optionen:
+ *   -n Anzahl   Anzahl Texte je Messung (Default 20000)
+ */
+
+ppl7::ConfigParser PPL7TestConfig;
+
+using ppl7::grafix::Image;
+using ppl7::grafix::Color;
+using ppl7::grafix::Font;
+using ppl7::grafix::RGBFormat;
+using ppl7::grafix::FontEngineFreeType;
+
+static int Labels=20000;
+
+static double measure(FontEngineFreeType* engine, size_t cachesize, Image& tile, const Font& font, bool measureonly)
+{
+	engine->setCacheSize(cachesize);
+	engine->clearCache();
+	ppl7::WideString label;
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i < Labels;i++) {
+		label.setf("Kachel %d/%d, Zoom %d", i % 1024, i / 1024, i % 18);
+		if (measureonly) font.measure(label);
+		else tile.print(font, 8 + (i % 16), 40 + (i % 64) * 3, label);
+	}
+	return Labels / (ppl7::GetMicrotime() - start);
+}
+
+static void run(const char* descr, FontEngineFreeType* engine, const RGBFormat& format, int size, bool antialias,
+	double rotation, bool measureonly=false)
+{
+	Font font;
+	font.setName("Liberation Sans Bold");
+	font.setSize(size);
+	font.setAntialias(antialias);
+	font.setRotation(rotation);
+	font.setColor(Color(255, 255, 255, 200));
+	Image tile(256, 256, format);
+	tile.cls(Color(20, 60, 20));
+	size_t cachesize=engine->cacheSize();
+	double uncached=measure(engine, 0, tile, font, measureonly);
+	double cached=measure(engine, cachesize, tile, font, measureonly);
+	printf("%-32s: %12.0f %12.0f %8.1fx\n", descr, uncached, cached, cached / uncached);
+	fflush(NULL);
+}
+
+int main(int argc, char** argv)
+{
+	if (ppl7::HaveArgv(argc, argv, "-n")) Labels=ppl7::GetArgv(argc, argv, "-n").toInt();
+	if (Labels < 1) {
+		printf("Ungültige Parameter\n");
+		return 1;
+	}
+	try {
+		ppl7::grafix::Grafix gfx;
+		gfx.loadFont("testdata/fonts/LiberationSans-Bold.ttf", "Liberation Sans Bold");
+		FontEngineFreeType* engine=dynamic_cast<FontEngineFreeType*>(gfx.findFont("Liberation Sans Bold")->engine);
+		if (!engine) throw ppl7::NullPointerException();
+
+		printf("%d Texte je Messung\n\n", Labels);
+		printf("%-32s  %12s %12s %9s\n", "Texte/s", "ohne Cache", "mit Cache", "Faktor");
+		run("A8R8G8B8, 12 Pixel, AA", engine, RGBFormat::A8R8G8B8, 12, true, 0.0);
+		run("A8R8G8B8, 24 Pixel, AA", engine, RGBFormat::A8R8G8B8, 24, true, 0.0);
+		run("A8R8G8B8, 12 Pixel, mono", engine, RGBFormat::A8R8G8B8, 12, false, 0.0);
+		run("A8R8G8B8, 12 Pixel, AA, 30 Grad", engine, RGBFormat::A8R8G8B8, 12, true, 30.0);
+		run("GREY8, 12 Pixel, AA", engine, RGBFormat::GREY8, 12, true, 0.0);
+		run("measure, 12 Pixel, AA", engine, RGBFormat::A8R8G8B8, 12, true, 0.0, true);
+	} catch (const ppl7::Exception& exp) {
+		exp.print();
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * This file is part of "Patrick's Programming Library", Version 7 (PPL7).
+ * Web: http://www.pfp.de/ppl/
+ *
+ *******************************************************************************
+ * Copyright (c) 2026, Patrick Fedick <patrick@pfp.de>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    1. Redistributions of source code must retain the above copyright notice, this
+ *       list of conditions and the following disclaimer.
+ *    2. Redistributions in binary form must reproduce the above copyright notice,
+ *       this list of conditions and the following disclaimer in the documentation
+ *       and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************/
+
+#define PPL7TESTSUITEMAIN
+#include <ppl7.h>
+#include <ppl7-grafix.h>
+#include "ppl7-tests.h"
+
+/*
+ * Benchmark für das Erstellen von Vorschaubildern. Ein großes Foto wird als JPEG, als PNG
+ * und als PNG mit Adam7-Interlacing gespeichert und anschließend auf Thumbnail-Größe
+ * gebracht. Verglichen wird das Laden in Originalgröße mit dem verkleinerten Laden über
+ * Image::load mit Mindestgröße, jeweils gefolgt von Resampler auf die exakte Zielgröße.
+ * Ausgegeben werden die Millisekunden pro Vorschaubild und der Speicherbedarf der
+ * dekodierten Grafik.
+ *
+ * Optionen:
+ *   -w Breite   Breite des Fotos (Default 4000)
+ *   -h Höhe     Höhe des Fotos (Default 3000)
+ *   -s Größe    Breite des Vorschaubilds (Default 256)
+ *   -r Runden   Anzahl Wiederholungen je Messung (Default 5)
+ */
+
+ppl7::ConfigParser PPL7TestConfig;
+
+using ppl7::grafix::Image;
+using ppl7::grafix::RGBFormat;
+using ppl7::grafix::Resampler;
+using ppl7::grafix::Size;
+
+static int Width=4000;
+static int Height=3000;
+static int ThumbWidth=256;
+static int Rounds=5;
+
+static void fillPhoto(Image& img)
+{
+	uint64_t seed=1;
+	for (int y=0;y < img.height();y++) {
+		uint8_t* p=(uint8_t*)img.adr(0, y);
+		for (int x=0;x < img.width();x++) {
+			seed=seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			int noise=(int)(seed >> 61);
+			p[x * 4]=(uint8_t)(x * 255 / img.width() + noise);
+			p[x * 4 + 1]=(uint8_t)(y * 255 / img.height() + noise);
+			p[x * 4 + 2]=(uint8_t)((((x / 64) + (y / 64)) & 1) * 128 + noise);
+			p[x * 4 + 3]=255;
+		}
+	}
+}
+
+static void measure(const char* descr, const ppl7::ByteArray& data, const Size& minsize)
+{
+	Resampler resampler(Resampler::Lanczos3);
+	int th=Height * ThumbWidth / Width;
+	Image img, thumb;
+	size_t bytes=0;
+	double start=ppl7::GetMicrotime();
+	for (int i=0;i < Rounds;i++) {
+		img.load(data, minsize);
+		bytes=img.numBytes();
+		thumb=resampler.resampled(img, ThumbWidth, th);
+	}
+	double duration=ppl7::GetMicrotime() - start;
+	ppl7::String size;
+	size.setf("%d x %d", img.width(), img.height());
+	printf("%-28s: %10.1f %14s %10.1f\n", descr, duration * 1000.0 / Rounds, (const char*)size,
+		(double)bytes / (1024.0 * 1024.0));
+	fflush(NULL);
+}
+
+static void run(const char* name, const ppl7::ByteArray& data)
+{
+	ppl7::String descr;
+	descr.setf("%s, original", name);
+	measure(descr, data, Size());
+	descr.setf("%s, verkleinert", name);
+	measure(descr, data, Size(ThumbWidth, Height * ThumbWidth / Width));
+}
+
+int main(int argc, char** argv)
+{
+	if (ppl7::HaveArgv(argc, argv, "-w")) Width=ppl7::GetArgv(argc, argv, "-w").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-h")) Height=ppl7::GetArgv(argc, argv, "-h").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-s")) ThumbWidth=ppl7::GetArgv(argc, argv, "-s").toInt();
+	if (ppl7::HaveArgv(argc, argv, "-r")) Rounds=ppl7::GetArgv(argc, argv, "-r").toInt();
+	if (Width < 16 || Height < 16 || ThumbWidth < 1 || ThumbWidth > Width || Rounds < 1) {
+		printf("Ungültige Parameter\n");
+		return 1;
+	}
+	try {
+		ppl7::grafix::Grafix gfx;
+		Image photo(Width, Height, RGBFormat::X8R8G8B8);
+		fillPhoto(photo);
+		ppl7::Dir::mkDir("tmp");
+		ppl7::grafix::ImageFilter_JPEG jpeg;
+		ppl7::grafix::ImageFilter_PNG png;
+		ppl7::AssocArray param;
+		jpeg.saveFile("tmp/thumbnailspeed.jpg", photo);
+		png.saveFile("tmp/thumbnailspeed.png", photo);
+		param.set("interlace", "1");
+		png.saveFile("tmp/thumbnailspeed-interlaced.png", photo, param);
+		ppl7::ByteArray jpgdata, pngdata, interlaceddata;
+		ppl7::File::load(jpgdata, "tmp/thumbnailspeed.jpg");
+		ppl7::File::load(pngdata, "tmp/thumbnailspeed.png");
+		ppl7::File::load(interlaceddata, "tmp/thumbnailspeed-interlaced.png");
+
+		printf("%d x %d Pixel => Thumbnail %d Pixel breit, %d Runden\n\n", Width, Height, ThumbWidth, Rounds);
+		printf("%-28s  %10s %14s %10s\n", "", "ms/Bild", "dekodiert", "MB");
+		run("JPEG", jpgdata);
+		run("PNG", pngdata);
+		run("PNG interlaced", interlaceddata);
+	} catch (const ppl7::Exception& exp) {
+		exp.print();
+		return 1;
+	}
+	return 0;
+}